@@ -45,6 +45,10 @@ void DoEdit(const ConfigParameters& config);
 template <typename ElemType>
 void DoBatchNormalizationStat(const ConfigParameters& config);
 
+// benchmarking (BenchmarkActions.cpp)
+template <typename ElemType>
+void DoBenchmark(const ConfigParameters& config);
+
 // evaluation (EvalActions.cpp)
 template <typename ElemType>
 void DoEval(const ConfigParameters& config);
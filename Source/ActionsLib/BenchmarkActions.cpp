@@ -0,0 +1,233 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// BenchmarkActions.cpp -- CNTK "benchmark" command: reproducible end-to-end throughput measurement
+//
+// The benchmark action runs a fixed number of training steps of a reference topology against
+// the synthetic zero-I/O reader (SyntheticDataDeserializer), so full-pipeline numbers
+// (reader -> packer -> forward/backward -> weight update) can be collected and compared
+// across machines and builds without any dataset plumbing. Per-phase times are emitted as
+// the standard profiler fixed events, so enabling the profiler yields the same breakdown
+// report that training produces.
+//
+
+#define _CRT_NONSTDC_NO_DEPRECATE // make VS accept POSIX functions without _
+
+#include "stdafx.h"
+#include "Basics.h"
+
+#include "Actions.h"
+#include "ComputationNetwork.h"
+#include "ComputationNode.h"
+#include "DataReader.h"
+#include "DataReaderHelpers.h"
+#include "ReaderShim.h"
+#include "SyntheticDataDeserializer.h"
+#include "Config.h"
+#include "BestGpu.h"
+#include "PerformanceProfiler.h"
+#include "ProgressTracing.h"
+#include "TimerUtility.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#ifndef let
+#define let const auto
+#endif
+
+using namespace std;
+using namespace Microsoft::MSR;
+using namespace Microsoft::MSR::CNTK;
+
+// ===========================================================================
+// DoBenchmark() - implements CNTK "benchmark" command
+// ===========================================================================
+
+// Peak working-set size of this process in bytes (host memory high-water mark).
+static size_t GetPeakWorkingSetBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = { sizeof(counters) };
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss * 1024; // ru_maxrss is in KB on Linux
+#endif
+}
+
+template <typename ElemType>
+void DoBenchmark(const ConfigParameters& config)
+{
+    size_t mbSize = config(L"minibatchSize", (size_t)256);
+    size_t numSteps = config(L"numSteps", (size_t)500);
+    size_t warmupSteps = config(L"warmupSteps", (size_t)10);
+    bool runBackprop = config(L"backprop", true);
+    bool updateWeights = config(L"updateWeights", runBackprop);
+    double learningRatePerSample = config(L"learningRatePerSample", 0.0001);
+    int traceLevel = config(L"traceLevel", 0);
+
+    if (numSteps == 0)
+        InvalidArgument("DoBenchmark: 'numSteps' must be greater than zero.");
+
+    // Reference topology, either built from a network builder section or loaded from 'modelPath'.
+    vector<wstring> evalNodeNamesVector;
+    let net = GetModelFromConfig<ConfigParameters, ElemType>(config, L"evalNodeNames", evalNodeNamesVector);
+
+    // Synthetic reader, run through the standard shim so minibatches take the exact
+    // production path including prefetch and async device transfers.
+    ConfigParameters readerConfig(config(L"reader"));
+    readerConfig.Insert("traceLevel", config(L"traceLevel", "0"));
+    if (!readerConfig.ExistsCurrent(L"precision"))
+        readerConfig.Insert("precision", config(L"precision", "float"));
+    // IDataReader lifetime convention: destruction goes through Destroy(), which drains
+    // any in-flight prefetch before deleting the shim.
+    shared_ptr<ReaderShim<ElemType>> reader(new ReaderShim<ElemType>(make_shared<SyntheticReader>(readerConfig)),
+                                            [](ReaderShim<ElemType>* r) { r->Destroy(); });
+    reader->Init(readerConfig);
+
+    // Roots to compute: the training criterion if we run backprop, otherwise the output nodes.
+    auto& criterionNodes = net->FinalCriterionNodes();
+    ComputationNodeBasePtr criterionNode = criterionNodes.empty() ? nullptr : criterionNodes[0];
+    if (runBackprop && criterionNode == nullptr)
+        InvalidArgument("DoBenchmark: 'backprop' requires a network with a training criterion node.");
+
+    vector<ComputationNodeBasePtr> forwardRoots;
+    if (criterionNode != nullptr)
+        forwardRoots.push_back(criterionNode);
+    else
+        forwardRoots = net->OutputNodes();
+    if (forwardRoots.empty())
+        InvalidArgument("DoBenchmark: network has neither criterion nor output nodes.");
+
+    net->AllocateAllMatrices(net->EvaluationNodes(), net->OutputNodes(), runBackprop ? criterionNode : nullptr);
+
+    list<ComputationNodeBasePtr> learnableNodes;
+    if (updateWeights && criterionNode != nullptr)
+        learnableNodes = net->LearnableParameterNodes(criterionNode);
+
+    // Bind the input nodes to the reader streams, same as SGD/SimpleEvaluator do.
+    auto& featureNodes = net->FeatureNodes();
+    auto& labelNodes = net->LabelNodes();
+    StreamMinibatchInputs inputMatrices;
+    for (auto& node : featureNodes)
+        inputMatrices.AddInput(node->NodeName(), node->ValuePtr(), node->GetMBLayout(), node->GetSampleLayout());
+    for (auto& node : labelNodes)
+        inputMatrices.AddInput(node->NodeName(), node->ValuePtr(), node->GetMBLayout(), node->GetSampleLayout());
+
+    // Request enough samples for all steps; the synthetic corpus wraps across sweeps as needed.
+    reader->StartMinibatchLoop(mbSize, 0, inputMatrices.GetStreamDescriptions(), numSteps * mbSize);
+    net->StartEvaluateMinibatchLoop(forwardRoots);
+
+    ProfilerEnable(true);
+
+    // Wall-clock accumulators for the always-on summary; the profiler events emitted below
+    // additionally capture GPU-synchronized per-phase times when the profiler is enabled.
+    double readSeconds = 0, fbSeconds = 0, updateSeconds = 0;
+    double criterionSum = 0;
+    size_t totalSamples = 0, measuredSamples = 0, step = 0;
+    Timer phaseTimer, benchmarkTimer;
+
+    for (; step < numSteps; ++step)
+    {
+        if (step == warmupSteps)
+            benchmarkTimer.Start();
+
+        auto profMinibatch = ProfilerTimeBegin();
+
+        auto profGetMinibatch = ProfilerTimeBegin();
+        phaseTimer.Restart();
+        size_t actualMBSize = 0;
+        bool wasDataRead = DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*reader, net, criterionNode,
+                                                                               false, false, inputMatrices, actualMBSize, nullptr);
+        phaseTimer.Stop();
+        ProfilerTimeEnd(profGetMinibatch, profilerEvtMainGetMinibatch);
+        if (!wasDataRead)
+            break;
+        if (step >= warmupSteps)
+            readSeconds += phaseTimer.ElapsedSeconds();
+
+        ComputationNetwork::BumpEvalTimeStamp(featureNodes);
+        ComputationNetwork::BumpEvalTimeStamp(labelNodes);
+
+        auto profForwardBackward = ProfilerTimeBegin();
+        phaseTimer.Restart();
+        net->ForwardProp(forwardRoots);
+        if (runBackprop)
+            net->Backprop(criterionNode);
+        if (criterionNode != nullptr)
+        {
+            // Reading the criterion forces completion of the async device work, so the
+            // phase time is honest; it also gives a sanity value for the summary.
+            criterionSum += (double)dynamic_pointer_cast<ComputationNode<ElemType>>(criterionNode)->Value().Get00Element();
+        }
+        phaseTimer.Stop();
+        ProfilerTimeEnd(profForwardBackward, profilerEvtMainFB);
+        if (step >= warmupSteps)
+            fbSeconds += phaseTimer.ElapsedSeconds();
+
+        auto profWeights = ProfilerTimeBegin();
+        phaseTimer.Restart();
+        if (!learnableNodes.empty())
+        {
+            // Plain SGD step; enough to charge the benchmark with the weight-update bandwidth
+            // without dragging in learner state (momentum buffers etc.).
+            for (auto& nodeBase : learnableNodes)
+            {
+                auto node = dynamic_pointer_cast<ComputationNode<ElemType>>(nodeBase);
+                if (node->IsParameterUpdateRequired())
+                    Matrix<ElemType>::ScaleAndAdd((ElemType)-learningRatePerSample, node->Gradient(), node->Value());
+            }
+        }
+        phaseTimer.Stop();
+        ProfilerTimeEnd(profWeights, profilerEvtMainWeights);
+        if (step >= warmupSteps)
+            updateSeconds += phaseTimer.ElapsedSeconds();
+
+        ProfilerTimeEnd(profMinibatch, profilerEvtMainMinibatch);
+
+        totalSamples += actualMBSize;
+        if (step >= warmupSteps)
+            measuredSamples += actualMBSize;
+
+        if (traceLevel > 0 && (step + 1) % 100 == 0)
+            LOGPRINTF(stderr, "Benchmark: finished step %d of %d, %d samples so far.\n",
+                      (int)(step + 1), (int)numSteps, (int)totalSamples);
+    }
+    benchmarkTimer.Stop();
+    ProfilerEnable(false);
+
+    if (step <= warmupSteps)
+        RuntimeError("DoBenchmark: the reader ran dry after %d steps, before any measured step; "
+                     "increase the synthetic corpus size or lower 'warmupSteps'.", (int)step);
+
+    size_t measuredSteps = step - warmupSteps;
+    double elapsed = benchmarkTimer.ElapsedSeconds();
+
+    LOGPRINTF(stderr, "Benchmark summary (%d measured steps after %d warm-up steps, minibatchSize=%d):\n",
+              (int)measuredSteps, (int)warmupSteps, (int)mbSize);
+    LOGPRINTF(stderr, "  throughput:       %.1f samples/sec (%d samples in %.3fs)\n",
+              measuredSamples / elapsed, (int)measuredSamples, elapsed);
+    LOGPRINTF(stderr, "  phase breakdown:  getMinibatch %.3fs (%.1f%%); forward/backward %.3fs (%.1f%%); weightUpdate %.3fs (%.1f%%)\n",
+              readSeconds, 100.0 * readSeconds / elapsed,
+              fbSeconds, 100.0 * fbSeconds / elapsed,
+              updateSeconds, 100.0 * updateSeconds / elapsed);
+    if (criterionNode != nullptr)
+        LOGPRINTF(stderr, "  criterion:        %.8f average per sample\n", criterionSum / totalSamples);
+    LOGPRINTF(stderr, "  peak host memory: %.1f MB\n", GetPeakWorkingSetBytes() / (1024.0 * 1024.0));
+}
+
+template void DoBenchmark<float>(const ConfigParameters& config);
+template void DoBenchmark<double>(const ConfigParameters& config);
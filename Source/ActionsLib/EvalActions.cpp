@@ -74,6 +74,11 @@ static void DoEvalBase(const ConfigParameters& config, IDataReader& reader)
 
     let net = GetModelFromConfig<ConfigParameters, ElemType>(config, L"evalNodeNames", evalNodeNamesVector);
 
+    // optionally serve with int16 fixed-point matrix products (CPU only); eligible Times nodes
+    // are swapped for QuantizedTimes before the network is compiled
+    if (config(L"quantizedEval", false))
+        net->ConvertTimesNodesToQuantizedTimes(config(L"quantizedEvalBitShiftA", (size_t) 1), config(L"quantizedEvalBitShiftB", (size_t) 1));
+
     // set tracing flags
     net->EnableNodeTracing(config(L"traceNodeNamesReal",     ConfigParameters::Array(stringargvector())),
                            config(L"traceNodeNamesCategory", ConfigParameters::Array(stringargvector())),
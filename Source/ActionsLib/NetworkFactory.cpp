@@ -13,6 +13,68 @@
 #include "BrainScriptEvaluator.h"
 #include "BrainScriptParser.h"
 
+// ===========================================================================
+// compiled-network disk cache
+// ===========================================================================
+
+// Rebuilding a large topology from BrainScript/NDL costs minutes of pure config
+// evaluation and graph construction before any data is touched. When the config
+// specifies 'networkCacheDir', the network a builder creates (structure plus
+// initialized parameter values) is saved there in regular model-file format,
+// keyed by a hash of the builder's resolved description text, and subsequent
+// job starts with an unchanged description load it directly.
+// Note that the key covers the description text only; descriptions that pull in
+// external files (NDL 'networkDescription' files, BS includes) must clear the
+// cache directory when those files change.
+
+static uint64_t HashNetworkDescription(const wstring& description)
+{
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a over the UTF-16 code units
+    for (wchar_t c : description)
+    {
+        hash ^= (uint64_t) c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// get the textual network description to key the cache on, or an empty string
+// if this config path has none (then caching is silently unavailable)
+static wstring GetBuilderTextForCache(const ConfigParameters& config, const wchar_t* builderName)
+{
+    return msra::strfun::utf16(config(builderName, ""));
+}
+static wstring GetBuilderTextForCache(const ScriptableObjects::IConfigRecord&, const wchar_t*)
+{
+    return L""; // BS config records have no stable textual form to hash
+}
+
+template <class ConfigRecordType, typename ElemType>
+static function<ComputationNetworkPtr(DEVICEID_TYPE)> WrapWithCompiledNetworkCache(const ConfigRecordType& config, const wstring& description, int traceLevel,
+                                                                                   function<ComputationNetworkPtr(DEVICEID_TYPE)> createNetworkFn)
+{
+    wstring cacheDir = config(L"networkCacheDir", L"");
+    if (cacheDir.empty() || description.empty())
+        return createNetworkFn;
+    // The precision is part of the cache name; the device is not, since model files are device-independent.
+    let cachePath = cacheDir + msra::strfun::wstrprintf(L"/network.%ls.%016llx.cn", ElemTypeName<ElemType>(), (unsigned long long) HashNetworkDescription(description));
+    return [cachePath, traceLevel, createNetworkFn](DEVICEID_TYPE deviceId)
+    {
+        if (fexists(cachePath))
+        {
+            // (always announced, since the cached parameter initialization replaces a fresh random one)
+            fprintf(stderr, "Loading compiled network from cache '%ls'\n", cachePath.c_str());
+            return ComputationNetwork::CreateFromFile<ElemType>(deviceId, cachePath);
+        }
+        auto net = createNetworkFn(deviceId);
+        msra::files::make_intermediate_dirs(cachePath);
+        net->Save(cachePath); // (atomic: saves under a temp name, then renames)
+        if (traceLevel > 0)
+            fprintf(stderr, "Cached compiled network as '%ls'\n", cachePath.c_str());
+        return net;
+    };
+}
+
 function<ComputationNetworkPtr(DEVICEID_TYPE)> GetCreateNetworkFn(const ScriptableObjects::IConfigRecord& config)
 {
     // createNetwork() is a BrainScript lambda that creates the model
@@ -43,6 +105,7 @@ bool TryGetNetworkFactory(const ConfigRecordType& config, function<ComputationNe
     if (config.Exists(L"createNetwork"))
     {
         createNetworkFn = GetCreateNetworkFn(config); // (we need a separate function needed due to template code)
+        // (no compiled-network caching here: a BS lambda has no textual form to key on)
         return true;
     }
     else if (config.Exists(L"SimpleNetworkBuilder"))
@@ -55,6 +118,7 @@ bool TryGetNetworkFactory(const ConfigRecordType& config, function<ComputationNe
             net->SetTraceLevel(traceLevel);
             return net;
         };
+        createNetworkFn = WrapWithCompiledNetworkCache<ConfigRecordType, ElemType>(config, GetBuilderTextForCache(config, L"SimpleNetworkBuilder"), traceLevel, createNetworkFn);
         return true;
     }
     // legacy NDL
@@ -68,6 +132,7 @@ bool TryGetNetworkFactory(const ConfigRecordType& config, function<ComputationNe
             net->SetTraceLevel(traceLevel);
             return net;
         };
+        createNetworkFn = WrapWithCompiledNetworkCache<ConfigRecordType, ElemType>(config, GetBuilderTextForCache(config, L"NDLNetworkBuilder"), traceLevel, createNetworkFn);
         return true;
     }
     // legacy test mode for BrainScript. Will go away once we fully integrate with BS.
@@ -110,6 +175,8 @@ bool TryGetNetworkFactory(const ConfigRecordType& config, function<ComputationNe
                 LogicError("BuildNetworkFromDescription: ComputationNetwork not what it was meant to be");
             return network;
         };
+        // key on the user's network expression (not sourceOfBS, whose injected deviceId line would needlessly split the cache per device)
+        createNetworkFn = WrapWithCompiledNetworkCache<ConfigRecordType, ElemType>(config, sourceOfNetwork, traceLevel, createNetworkFn);
         return true;
     }
     else
@@ -24,6 +24,7 @@
 #include "ModelEditLanguage.h"
 #include "CPUMatrix.h" // used for SetNumThreads()
 #include "CommonMatrix.h"
+#include "HotPathCounters.h"
 #include "SGD.h"
 #include "MPIWrapper.h"
 #include "Config.h"
@@ -56,6 +57,7 @@
 #include <queue>
 #include <set>
 #include <memory>
+#include <future>
 
 #ifndef let
 #define let const auto
@@ -80,7 +82,14 @@ void SetupProfiling(ProfilerContext& profilerContext, const ConfigParamType& con
                              config(L"profilerBufferSize", static_cast<uint64_t>(32 * 1024 * 1024)),
                              std::to_wstring(nodeRank),
                              config(L"profilerSyncGpu", true));
+        // production mode: fixed events only feed the lock-free summary statistics, keeping the
+        // overhead low enough to leave the profiler on for entire production runs
+        ProfilerEnableProductionMode(config(L"profilerProductionMode", false));
     }
+
+    // The hot-path counters are independent of the sampling profiler: cheap enough to stay on
+    // for a whole run, and the only way to see Matrix's hidden CPU<->GPU transfers (see HotPathCounters.h).
+    HotPathCounters::SetEnabled(config(L"hotPathCounters", false));
 }
 
 void RedirectStdErr(wstring logpath)
@@ -172,6 +181,33 @@ static void DisableLegacyUsage(const ConfigParameters& TopLevelConfig, const Con
     }
 }
 
+// ===========================================================================
+// startup phase timing -- cold start used to be a black box; these helpers time the
+// named phases of process startup (config parsing, GPU probe, log redirection, GPU
+// context creation) and print a one-shot report before the first action runs.
+// ===========================================================================
+
+static std::vector<std::pair<std::string, double>> s_startupPhases;
+static std::chrono::steady_clock::time_point s_startupPhaseStart = std::chrono::steady_clock::now();
+
+// Closes the currently running startup phase under the given name and starts the next one.
+static void RecordStartupPhase(const char* name)
+{
+    auto now = std::chrono::steady_clock::now();
+    s_startupPhases.emplace_back(name, std::chrono::duration<double>(now - s_startupPhaseStart).count());
+    s_startupPhaseStart = now;
+}
+
+static void PrintStartupProfile()
+{
+    double total = 0;
+    for (const auto& phase : s_startupPhases)
+        total += phase.second;
+    LOGPRINTF(stderr, "Startup profile (%.2fs before first action):\n", total);
+    for (const auto& phase : s_startupPhases)
+        LOGPRINTF(stderr, "    %-24s %8.2fs\n", phase.first.c_str(), phase.second);
+}
+
 // When running in parallel with MPI, only commands in 'commandstoRunOnAllRanks' should
 // be run in parallel across multiple ranks. Others should only run on rank 0
 const std::set<std::string> commandstoRunOnAllRanks = { "train", "trainRNN", "adapt", "test", "eval", "cv", "devtest", "bnstat" };
@@ -200,6 +236,40 @@ void DoCommands(const ConfigParameters& config, const shared_ptr<MPIWrapper>& mp
     // temporary hack to prevent users from failing due to a small breaking change related to the "truncated" flag (will be redone bigger and better some day)
     DisableLegacyUsage(config, command);
 
+    // Resolve the device once up front (this runs the NVML probe and locks the device, and
+    // caches the choice for the per-action DeviceFromConfig() calls), then bring up the CUDA
+    // context, allocator and cuBLAS on a background thread. Context creation takes seconds on
+    // some systems and does not depend on reader DLL loading or network construction, which
+    // proceed on the main thread meanwhile; the CUDA primary context is process-wide, so the
+    // first action finds it already warm.
+    std::future<void> gpuContextWarmup;
+    if (config.ExistsCurrent(L"deviceId") && !EqualCI(string(config(L"deviceId")), "cpu"))
+    {
+        DEVICEID_TYPE deviceId = DeviceFromConfig(config);
+        if (deviceId >= 0)
+        {
+            RecordStartupPhase("GPU selection");
+            auto warmupStart = std::chrono::steady_clock::now();
+            gpuContextWarmup = std::async(std::launch::async, [deviceId, warmupStart]()
+            {
+                try
+                {
+                    Matrix<ElemType> a(2, 2, deviceId);
+                    a.SetValue(0);
+                    Matrix<ElemType> c(2, 2, deviceId);
+                    c.AssignProductOf(a, false, a, false); // primes cuBLAS as well
+                    LOGPRINTF(stderr, "GPU %d context ready after %.2fs (overlapped with startup).\n", (int)deviceId,
+                              std::chrono::duration<double>(std::chrono::steady_clock::now() - warmupStart).count());
+                }
+                catch (...)
+                {
+                    // Errors are not fatal here; the first real use of the device on the
+                    // main thread will hit and report the same failure.
+                }
+            });
+        }
+    }
+
     // summarize command info upfront in the log and stdout
     size_t fullTotalMaxEpochs = 0;
     for (int i = 0; i < command.size(); i++)
@@ -238,6 +308,9 @@ void DoCommands(const ConfigParameters& config, const shared_ptr<MPIWrapper>& mp
 
     size_t fullEpochsOffset = 0;
 
+    RecordStartupPhase("command preparation");
+    PrintStartupProfile();
+
     // execute the commands
     for (int i = 0; i < command.size(); i++)
     {
@@ -297,6 +370,10 @@ void DoCommands(const ConfigParameters& config, const shared_ptr<MPIWrapper>& mp
                 {
                     DoEval<ElemType>(commandParams);
                 }
+                else if (thisAction == "benchmark")
+                {
+                    DoBenchmark<ElemType>(commandParams);
+                }
                 else if (thisAction == "edit")
                 {
                     DoEdit<ElemType>(commandParams);
@@ -586,6 +663,7 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
     Globals::SetHyperCompressMemory(config(L"hyperCompressMemory", false));
+    Globals::SetNodeProfiling(config(L"nodeProfiling", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -653,6 +731,9 @@ int wmainWithBS(int argc, wchar_t* argv[]) // called from wmain which is a wrapp
         fprintf(fp, "successfully finished at %s on %s\n", TimeDateStamp().c_str(), GetHostName().c_str());
         fcloseOrDie(fp);
     }
+    if (HotPathCounters::Enabled())
+        HotPathCounters::Dump(stderr);
+
     // TODO: change this back to COMPLETED, double underscores don't look good in output
     LOGPRINTF(stderr, "__COMPLETED__\n");
     fflush(stderr);
@@ -685,6 +766,7 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
 
     ConfigParameters config;
     std::string rawConfigString = ConfigParameters::ParseCommandLine(argc, argv, config);    // get the command param set they want
+    RecordStartupPhase("config parsing");
 
     int traceLevel = config(L"traceLevel", 0);
 
@@ -730,6 +812,7 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
     Globals::SetShareNodeValueMatrices(config(L"shareNodeValueMatrices", true));
     Globals::SetGradientAccumulationOptimization(config(L"optimizeGradientAccumulation", true));
     Globals::SetHyperCompressMemory(config(L"hyperCompressMemory", false));
+    Globals::SetNodeProfiling(config(L"nodeProfiling", false));
 
     TracingGPUMemoryAllocator::SetTraceLevel(config(L"traceGPUMemoryAllocations", 0));
 
@@ -763,9 +846,12 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
             PrintBanner(argc, argv, timestamp); // repeat simple banner into log file
     }
 
+    RecordStartupPhase("MPI and log setup");
+
     // full config info
     PrintBuiltInfo();
     PrintGpuInfo();
+    RecordStartupPhase("GPU probe");
 
 #ifdef _DEBUG
     if (traceLevel > 0)
@@ -800,6 +886,7 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
     // Setup profiling
     ProfilerContext profilerContext;
     SetupProfiling(profilerContext, config, paralleltrain ? (int)mpi->CurrentNodeRank() : 0);
+    RecordStartupPhase("profiler setup");
 
     // run commands
     std::string type = config(L"precision", "float");
@@ -826,6 +913,9 @@ int wmainOldCNTKConfig(int argc, wchar_t* argv[])
         fprintf(fp, "Successfully finished at %s on %s\n", TimeDateStamp().c_str(), GetHostName().c_str());
         fcloseOrDie(fp);
     }
+    if (HotPathCounters::Enabled())
+        HotPathCounters::Dump(stderr);
+
     if (ProgressTracing::GetTimestampingFlag())
     {
         LOGPRINTF(stderr, "__COMPLETED__\n"); // running in server environment which expects this string
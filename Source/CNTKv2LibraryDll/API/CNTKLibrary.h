@@ -400,6 +400,7 @@ namespace CNTK
         friend class CompositeFunction;
         friend class Utils;
         friend class LearnerBase;
+        friend class Trainer;
         friend class Variable;
         friend class Value;
         friend class PackedValue;
@@ -611,6 +612,14 @@ namespace CNTK
         ///
         CNTK_API NDArrayViewPtr Alias(bool readOnly = false) const;
 
+        ///
+        /// Detaches 'this' view from the external caller-owned buffer it was constructed over.
+        /// The view no longer references the buffer afterwards and any subsequent access to its
+        /// contents is an error; the caller can then safely release the buffer. Only valid for
+        /// views constructed over an external buffer.
+        ///
+        CNTK_API void Invalidate();
+
         ///
         /// Copies the contents of the 'source' NDArrayView to 'this' view.
         /// The shapes of the 'source' view and 'this' view must be identical.
@@ -634,6 +643,17 @@ namespace CNTK
         template <typename ElementType>
         CNTK_API static NDArrayViewPtr RandomUniform(const NDShape& shape, double rangeStart, double rangeEnd, unsigned long seed = SentinelValueForAutoSelectRandomSeed, const DeviceDescriptor& device = DeviceDescriptor::UseDefaultDevice());
 
+        ///
+        /// Static method to construct a new NDArrayView object on the specified device whose contents
+        /// are copied from the specified host 'dataBuffer'. Unlike the Value creation paths that first
+        /// copy user data into a CPU-side matrix, the contents are uploaded directly from the host
+        /// buffer to newly allocated storage on the target device; when the buffer resides in pinned
+        /// (page-locked) memory the upload runs on the device's DMA engine. The buffer is only read
+        /// during the call and can be reused as soon as it returns. For zero-copy feeding on the CPU
+        /// device, construct a NDArrayView over the buffer directly instead.
+        ///
+        CNTK_API static NDArrayViewPtr CreateFromPinnedHostBuffer(::CNTK::DataType dataType, const NDShape& viewShape, const void* dataBuffer, size_t bufferSizeInBytes, const DeviceDescriptor& device);
+
     private:
         // Disallow copy and move construction and assignment
         NDArrayView(const NDArrayView&) = delete; NDArrayView& operator=(const NDArrayView&) = delete; NDArrayView& operator=(NDArrayView&&) = delete; NDArrayView(NDArrayView&& other) = delete;
@@ -666,6 +686,10 @@ namespace CNTK
         NDShape m_viewShape;
         bool m_isReadOnly;
 
+        // Indicates that the view was constructed over an external caller-owned buffer and can be
+        // explicitly detached from it via Invalidate()
+        bool m_isBorrowed;
+
         std::shared_ptr<void> m_tensorView; // Microsoft::MSR::CNTK::TensorView<ElemType>*
     };
 
@@ -733,6 +757,12 @@ namespace CNTK
         ///
         CNTK_API size_t MaskedCount() const;
 
+        ///
+        /// Returns the packed (flat, column-major) indices of all entries of 'this' mask that are
+        /// not masked out, i.e. the frames a consumer should process when skipping gap frames.
+        ///
+        CNTK_API std::vector<size_t> ValidFrameIndices() const;
+
         ///
         /// Returns the descriptor of the device that 'this' mask resides on
         ///
@@ -787,6 +817,11 @@ namespace CNTK
         NDShape m_maskShape;
 
         std::shared_ptr<Microsoft::MSR::CNTK::Matrix<char>> m_matrixView;
+
+        // Staging buffer for batched section marking: between construction and the first access
+        // to the underlying matrix, sections are recorded CPU-side and then materialized with a
+        // single assignment, instead of one kernel launch per MaskSection call. Empty == inactive.
+        mutable std::vector<char> m_stagedMaskValues;
     };
 
     ///
@@ -2413,12 +2448,37 @@ namespace CNTK
                       std::unordered_map<Variable, ValuePtr>& outputs,
                       const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
 
+        ///
+        /// Asynchronously performs forward computation, i.e. evaluation, on the computation graph using the
+        /// provided 'arguments' values. The 'outputs' map is taken by value and seeds which output variables
+        /// to compute (and, optionally, the storage to compute them into); the returned future yields the
+        /// filled map once the evaluation has completed. The caller must keep the argument Values unchanged
+        /// until then. Evaluations queued on the same Function instance are serialized, since the underlying
+        /// computation network holds a single set of activation buffers; to pipeline concurrent inference
+        /// requests over one loaded model, give each in-flight request its own instance obtained via
+        /// Clone(ParameterCloningMethod::Share), which shares the parameter values.
+        ///
+        CNTK_API std::future<std::unordered_map<Variable, ValuePtr>> EvaluateAsync(const std::unordered_map<Variable, ValuePtr>& arguments,
+                                                                                   std::unordered_map<Variable, ValuePtr> outputs,
+                                                                                   const DeviceDescriptor& computeDevice = DeviceDescriptor::UseDefaultDevice());
+
         ///
         /// Clones 'this' Function. The parameters of the Function are either cloned, shared or frozen as specified by the parameterCloneMethod argument and
         /// any variable replacements requested are applied in the cloned Function instance.
         ///
         CNTK_API FunctionPtr Clone(ParameterCloningMethod parameterCloneMethod = ParameterCloningMethod::Clone, const std::unordered_map<Variable, Variable>& replacements = {}) const;
 
+        ///
+        /// Produces a specialized clone of 'this' Function for fixed-geometry workloads: each argument
+        /// whose shape contains one or more NDShape::InferredDimension axes is replaced with an Input
+        /// variable whose shape is frozen to the concrete dimensions of the Value bound to it in the
+        /// specified 'exampleBindings', and static shape validation is re-run once over the whole graph.
+        /// The returned Function shares the parameter values of 'this' Function; its downstream
+        /// ComputationNetwork compilation sees only fixed shapes. Feeding the specialized Function a
+        /// minibatch whose sample dimensions differ from the example bindings results in an error.
+        ///
+        CNTK_API FunctionPtr Specialize(const std::unordered_map<Variable, ValuePtr>& exampleBindings) const;
+
         ///
         /// Generates a dictionary that captures the state of the Function graph underlying this Function.
         ///
@@ -2665,6 +2725,9 @@ namespace CNTK
         std::wstring m_name;
         std::wstring m_uid;
         Dictionary m_attributes;
+
+        // Serializes evaluations queued through EvaluateAsync on 'this' Function instance.
+        std::mutex m_evaluationMutex;
     };
 
     ///
@@ -3649,6 +3712,17 @@ namespace CNTK
         ///
         CNTK_API Dictionary RestoreFromCheckpoint(const std::wstring& filePath);
 
+        ///
+        /// Sets the frequency of full checkpoints when incremental checkpointing is desired.
+        /// Every 'frequency'-th SaveCheckpoint call writes a complete checkpoint; the calls in
+        /// between write a compact delta file next to the trainer state file that only contains
+        /// the learner state entries changed since the last full checkpoint, with the smoothed
+        /// gradient payloads stored as 16-bit quantized differences against that snapshot.
+        /// The model itself is always saved in full. A frequency of 1 (the default) always
+        /// writes full checkpoints; deltas are not used for distributed training.
+        ///
+        CNTK_API void SetFullCheckpointFrequency(size_t frequency);
+
         ///
         /// Model being trained by 'this' Trainer.
         ///
@@ -3679,6 +3753,32 @@ namespace CNTK
         ///
         size_t PreviousMinibatchSampleCount() const { return m_prevMinibatchNumSamples; }
 
+        ///
+        /// Returns the average training loss per sample over all minibatches trained since the last
+        /// call to ResetAccumulatedMetrics (or since the start of training). Unlike
+        /// PreviousMinibatchLossAverage, the loss is accumulated in a small buffer on the compute
+        /// device and only transferred to the CPU when this method is called, so training loops that
+        /// report progress every N minibatches do not force a device synchronization on every step.
+        ///
+        CNTK_API double AccumulatedLossAverage() const;
+
+        ///
+        /// Returns the average evaluation criterion value per sample over all minibatches trained
+        /// since the last call to ResetAccumulatedMetrics (or since the start of training).
+        ///
+        CNTK_API double AccumulatedEvaluationAverage() const;
+
+        ///
+        /// Returns the number of samples the accumulated loss/metric values cover.
+        ///
+        size_t AccumulatedSampleCount() const { return m_accumulatedNumSamples; }
+
+        ///
+        /// Resets the accumulated loss/metric values and their sample count; typically called right
+        /// after reporting them.
+        ///
+        CNTK_API void ResetAccumulatedMetrics();
+
         ///
         /// Learners associated with this Trainer for updating the model's parameters using computed gradients.
         ///
@@ -3696,10 +3796,14 @@ namespace CNTK
             const DeviceDescriptor& computeDevice,
             std::unordered_map<Variable, ValuePtr>& parameterGradients);
 
+        void AccumulatePrevMinibatchMetrics();
+
         bool TrainLocalMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, const DeviceDescriptor& computeDevice);
         bool TrainDistributedMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, const DeviceDescriptor& computeDevice);
 
         void Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState);
+        bool SaveDeltaCheckpoint(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState);
+        bool TryApplyDeltaCheckpoint(const std::wstring& modelFilePath, std::vector<DictionaryValue>& learnerState, Dictionary& externalState, size_t baseCheckpointId);
 
         FunctionPtr m_combinedTrainingFunction;
         FunctionPtr m_model;
@@ -3716,6 +3820,20 @@ namespace CNTK
         size_t   m_prevMinibatchNumSamples;
         ValuePtr m_prevMinibatchAggregateTrainingLossValue;
         ValuePtr m_prevMinibatchAggregateEvalCriterionValue;
+
+        // Device-resident running sums of the aggregate loss/metric values; these are only read
+        // back to the CPU when one of the Accumulated* methods is called.
+        size_t         m_accumulatedNumSamples;
+        NDArrayViewPtr m_accumulatedTrainingLossValue;
+        NDArrayViewPtr m_accumulatedEvalCriterionValue;
+
+        // Incremental checkpointing state: the learner state captured at the last full
+        // checkpoint, the identifier written into that checkpoint (which ties delta files to
+        // their base), and the number of delta checkpoints written against it since.
+        size_t m_fullCheckpointFrequency;
+        size_t m_fullCheckpointId;
+        size_t m_deltaCheckpointsSinceFullCheckpoint;
+        std::vector<DictionaryValue> m_fullCheckpointLearnerState;
     };
 
     ///
@@ -3967,6 +4085,20 @@ namespace CNTK
             const std::vector<NDArrayViewPtr>& values,
             const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) = 0;
 
+        // Nonblocking variant of AggregateInPlace: returns once the aggregation has been initiated,
+        // so the caller can overlap it with other work. The values must not be read or written until
+        // WaitAggregateAsyncDone() returns, and at most one asynchronous aggregation may be in
+        // flight per communicator. The default implementation is synchronous, so callers may treat
+        // this purely as an optimization hint.
+        CNTK_API virtual void AggregateInPlaceAsync(
+            const std::vector<NDArrayViewPtr>& values,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+        {
+            AggregateInPlace(values, sendToWorkers);
+        }
+
+        CNTK_API virtual void WaitAggregateAsyncDone() {}
+
         CNTK_API virtual void Aggregate(
             const std::vector<NDArrayViewPtr>& values,
             std::vector<NDArrayViewPtr>& outputValues,
@@ -258,9 +258,27 @@ namespace CNTK
         CNTK_API void EnableHyperMemoryCompress();
         CNTK_API void DisableHyperMemoryCompress();
 
+        // Inference-only compilation: networks compiled without backprop roots keep
+        // parameter-induced node values sharable for aggressive pooled reuse, recomputing
+        // them on every forward pass instead. Must not be enabled for training processes.
+        CNTK_API void EnableInferenceOptimization();
+        CNTK_API void DisableInferenceOptimization();
+
         CNTK_API void EnableGradientAccumulationOptimization();
         CNTK_API void DisableGradientAccumulationOptimization();
 
+        // Activation recomputation (gradient checkpointing): trains with the values between
+        // checkpoint nodes released after forward and recomputed during backprop, trading
+        // roughly one extra forward pass for most of the activation memory.
+        CNTK_API void EnableActivationRecomputation();
+        CNTK_API void DisableActivationRecomputation();
+
+        // Per-node profiling: accumulates cumulative forward/backward time, invocation counts,
+        // and peak value/gradient matrix sizes on every computation node; the report is written
+        // by ComputationNetwork::DumpProfile() (e.g. to <modelPath>.profile after SGD training).
+        CNTK_API void EnableNodeProfiling();
+        CNTK_API void DisableNodeProfiling();
+
         CNTK_API bool AreEquivalent(const ::CNTK::FunctionPtr& f1, const ::CNTK::FunctionPtr& f2);
         CNTK_API bool AreEquivalent(const ::CNTK::Variable& v1, const ::CNTK::Variable& v2, bool allowParameterAndConstantsEquivalence = false);
 
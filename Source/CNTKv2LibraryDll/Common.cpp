@@ -91,6 +91,16 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetHyperCompressMemory(/* enable = */ false);
         }
 
+        void EnableInferenceOptimization()
+        {
+            Microsoft::MSR::CNTK::Globals::SetOptimizeForInference(/* enable = */ true);
+        }
+
+        void DisableInferenceOptimization()
+        {
+            Microsoft::MSR::CNTK::Globals::SetOptimizeForInference(/* enable = */ false);
+        }
+
         void EnableGradientAccumulationOptimization()
         {
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ true);
@@ -101,6 +111,26 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ false);
         }
 
+        void EnableActivationRecomputation()
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationRecomputation(/* enable = */ true);
+        }
+
+        void DisableActivationRecomputation()
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationRecomputation(/* enable = */ false);
+        }
+
+        void EnableNodeProfiling()
+        {
+            Microsoft::MSR::CNTK::Globals::SetNodeProfiling(/* enable = */ true);
+        }
+
+        void DisableNodeProfiling()
+        {
+            Microsoft::MSR::CNTK::Globals::SetNodeProfiling(/* enable = */ false);
+        }
+
         bool AreEquivalent(const Variable& var1, const Variable& var2, bool allowParameterAndConstantsEquivalence)
         {
             bool areDynamicAxesCompatible = (var1.DynamicAxes().size() == var2.DynamicAxes().size());
@@ -1068,36 +1068,6 @@ namespace CNTK
         computationNode->GetMBLayout()->CopyFrom(layout);
     }
 
-    void CompositeFunction::PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments)
-    {
-        std::vector<ComputationNodeBasePtr> inputNodes;
-        for (auto argumentValuePair : arguments)
-        {
-            auto argument = argumentValuePair.first;
-            auto argumentComputationNode = m_variableToNodeMap.at(argument);
-            assert(argumentComputationNode);
-            inputNodes.push_back(argumentComputationNode);
-
-            ValuePtr argumentValue = arguments.at(argument);
-
-            MBLayoutPtr layout;
-            switch (argumentValue->GetDataType())
-            {
-            case DataType::Float:
-                PopulateComputationNodeValue<float>({ argument, argumentValue }, argumentComputationNode);
-                break;
-            case DataType::Double:
-                PopulateComputationNodeValue<double>({ argument, argumentValue }, argumentComputationNode);
-                break;
-            default:
-                LogicError("Unsupported DataType %s", DataTypeName(argumentValue->GetDataType()));
-                break;
-            }
-        }
-
-        m_computationNetwork->BumpEvalTimeStamp(inputNodes);
-    }
-
     template <typename ElementType>
     /*static*/ void CompositeFunction::PopulateComputationNodeGradient(const std::pair<Variable, ValuePtr>& variableGradient, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode)
     {
@@ -1203,13 +1173,6 @@ namespace CNTK
             varValue->CopyFrom(*nodeValue);
     }
 
-    void CompositeFunction::GetNetworkOutputs(std::unordered_map<Variable, ValuePtr>& outputs)
-    {
-        // Now copy the Forward values of output nodes from the network to outputs' Value objects
-        for (auto outputVarValuePair : outputs)
-            GetNodeOutputOrGradient(outputVarValuePair.first, outputs[outputVarValuePair.first], m_variableToNodeMap.at(outputVarValuePair.first), false /*getGradient*/);
-    }
-
     void CompositeFunction::GetNetworkGradients(std::unordered_map<Variable, ValuePtr>& gradients)
     {
         auto networkInputs = this->Inputs();
@@ -1258,6 +1221,21 @@ namespace CNTK
         return currentBackpropRootsTimeStamps;
     }
 
+    template <typename ValueType>
+    static bool KeysMatch(const std::unordered_map<Variable, ValueType>& map, const std::unordered_set<Variable>& keys)
+    {
+        if (map.size() != keys.size())
+            return false;
+
+        for (const auto& pair : map)
+        {
+            if (keys.find(pair.first) == keys.end())
+                return false;
+        }
+
+        return true;
+    }
+
     /*virtual*/ BackPropStatePtr CompositeFunction::Forward(const std::unordered_map<Variable, ValuePtr>& arguments,
                                                             std::unordered_map<Variable, ValuePtr>& outputs,
                                                             const DeviceDescriptor& computeDevice,
@@ -1267,74 +1245,130 @@ namespace CNTK
         if (outputs.empty())
             InvalidArgument("CompositeFunction::Forward: At least one output has to be specified!");
 
-        // Make sure that the DataType of the variables and corresponding values match
-        // TODO: We need a better way to determine the ElementType for the network
-        auto dataType = DataType::Unknown;
-        for (auto variableValuePair : arguments)
-        {
-            if (dataType == DataType::Unknown)
-                dataType = variableValuePair.first.GetDataType();
-            else if (dataType != variableValuePair.first.GetDataType())
-                LogicError("CompositeFunction::Forward: The DataType of all arguments of the Function must be same");
-        }
+        // Steady-state evaluation and training loops call 'Forward' with the same argument, output
+        // and backprop root sets every time; the node bindings resolved by the previous call then
+        // still apply and the per-call dependency analysis and node map lookups can be skipped
+        bool reusePlan = (m_forwardPlan != nullptr) &&
+                         (m_computationNetwork != nullptr) &&
+                         KeysMatch(arguments, m_forwardPlan->m_arguments) &&
+                         KeysMatch(outputs, m_forwardPlan->m_outputs) &&
+                         (outputsToRetainBackwardStateFor == m_forwardPlan->m_backpropRoots);
 
-        if (dataType == DataType::Unknown)
+        if (!reusePlan)
         {
-            for (auto variableValuePair : outputs)
+            // Make sure that the DataType of the variables and corresponding values match
+            // TODO: We need a better way to determine the ElementType for the network
+            auto dataType = DataType::Unknown;
+            for (auto variableValuePair : arguments)
             {
                 if (dataType == DataType::Unknown)
                     dataType = variableValuePair.first.GetDataType();
+                else if (dataType != variableValuePair.first.GetDataType())
+                    LogicError("CompositeFunction::Forward: The DataType of all arguments of the Function must be same");
             }
-        }
 
-        std::unordered_set<Variable> requestedOutputVariables;
-        for (auto output : outputs)
-            requestedOutputVariables.insert(output.first);
+            if (dataType == DataType::Unknown)
+            {
+                for (auto variableValuePair : outputs)
+                {
+                    if (dataType == DataType::Unknown)
+                        dataType = variableValuePair.first.GetDataType();
+                }
+            }
 
-        if (dataType == DataType::Float)
-            GetComputationNetwork<float>(computeDevice, outputsToRetainBackwardStateFor, requestedOutputVariables, true);
-        else if (dataType == DataType::Double)
-            GetComputationNetwork<double>(computeDevice, outputsToRetainBackwardStateFor, requestedOutputVariables, true);
-        else
-            InvalidArgument("Unsupported DataType %s", DataTypeName(dataType));
+            std::unordered_set<Variable> requestedOutputVariables;
+            for (auto output : outputs)
+                requestedOutputVariables.insert(output.first);
 
-        std::unordered_set<Variable> functionOutputs(this->Outputs().begin(), this->Outputs().end());
-        std::vector<ComputationNodeBasePtr> outputsToEvaluate;
-        std::unordered_set<Variable> requiredArguments;
-        for (auto outputVarValuePair : outputs)
-        {
-            auto& requiredArgumentsForCurrentOutput = GetArgumentDependencies(outputVarValuePair.first);
-            requiredArguments.insert(requiredArgumentsForCurrentOutput.begin(), requiredArgumentsForCurrentOutput.end());
+            if (dataType == DataType::Float)
+                GetComputationNetwork<float>(computeDevice, outputsToRetainBackwardStateFor, requestedOutputVariables, true);
+            else if (dataType == DataType::Double)
+                GetComputationNetwork<double>(computeDevice, outputsToRetainBackwardStateFor, requestedOutputVariables, true);
+            else
+                InvalidArgument("Unsupported DataType %s", DataTypeName(dataType));
 
-            auto outputComputationNode = m_variableToNodeMap.at(outputVarValuePair.first);
-            outputsToEvaluate.push_back(outputComputationNode);
-        }
+            std::unique_ptr<ForwardPlan> plan(new ForwardPlan());
+            plan->m_backpropRoots = outputsToRetainBackwardStateFor;
 
-        // We should have argument values supplied for all required argument dependencies for the requested outputs
-        std::vector<Variable> missingRequiredArguments;
-        for (auto requiredArgument : requiredArguments)
-        {
-            if (arguments.find(requiredArgument) == arguments.end())
-                missingRequiredArguments.push_back(requiredArgument);
-        }
+            std::unordered_set<Variable> requiredArguments;
+            for (auto outputVarValuePair : outputs)
+            {
+                auto& requiredArgumentsForCurrentOutput = GetArgumentDependencies(outputVarValuePair.first);
+                requiredArguments.insert(requiredArgumentsForCurrentOutput.begin(), requiredArgumentsForCurrentOutput.end());
 
-        if (!missingRequiredArguments.empty())
-        {
-            std::wstring missingRequiredArgumentNames = NamedListString(missingRequiredArguments);
-            InvalidArgument("Function::Forward: Values for %d required arguments (%S), that the requested output(s) depend on, have not been provided", (int)missingRequiredArgumentNames.size(), missingRequiredArgumentNames.c_str());
+                auto outputComputationNode = m_variableToNodeMap.at(outputVarValuePair.first);
+                plan->m_outputs.insert(outputVarValuePair.first);
+                plan->m_outputNodes.push_back({ outputVarValuePair.first, outputComputationNode });
+                plan->m_outputsToEvaluate.push_back(outputComputationNode);
+            }
+
+            // We should have argument values supplied for all required argument dependencies for the requested outputs
+            std::vector<Variable> missingRequiredArguments;
+            for (auto requiredArgument : requiredArguments)
+            {
+                if (arguments.find(requiredArgument) == arguments.end())
+                    missingRequiredArguments.push_back(requiredArgument);
+            }
+
+            if (!missingRequiredArguments.empty())
+            {
+                std::wstring missingRequiredArgumentNames = NamedListString(missingRequiredArguments);
+                InvalidArgument("Function::Forward: Values for %d required arguments (%S), that the requested output(s) depend on, have not been provided", (int)missingRequiredArgumentNames.size(), missingRequiredArgumentNames.c_str());
+            }
+
+            for (auto argumentValuePair : arguments)
+            {
+                auto argumentComputationNode = m_variableToNodeMap.at(argumentValuePair.first);
+                assert(argumentComputationNode);
+                plan->m_arguments.insert(argumentValuePair.first);
+                plan->m_argumentNodes.push_back({ argumentValuePair.first, argumentComputationNode });
+                plan->m_inputNodes.push_back(argumentComputationNode);
+            }
+
+            // The 'outputsToRetainBackwardStateFor' nodes also need to be evaluated if not already specified in 'outputs'
+            for (auto rootVarForBackprop : outputsToRetainBackwardStateFor)
+            {
+                if (outputs.find(rootVarForBackprop) == outputs.end())
+                    plan->m_outputsToEvaluate.push_back(m_variableToNodeMap.at(rootVarForBackprop));
+            }
+
+            for (auto& backpropRoot : m_currentBackpropRoots)
+                plan->m_backpropRootResetNodes.push_back(m_variableToNodeMap.at(backpropRoot));
+
+            // Dropout nodes have an implicit input in the form of the random mask that is applied to its explicit input
+            // This mask is regerated every minibatch and hence dropout nodes with a non-zero dropout rate must me marked outdated
+            // w.r.t. inputs to force evaluation in each minibatch
+            plan->m_dropoutNodes = m_computationNetwork->GetNodesWithType(OperationNameOf(DropoutNode));
+
+            m_forwardPlan = std::move(plan);
         }
 
+        auto& plan = *m_forwardPlan;
+
         // Feed data into the arguments of the network
         // TODO: Avoid copying the data when possible
-        PopulateNetworkInputs(arguments);
+        for (auto& argumentNodePair : plan.m_argumentNodes)
+        {
+            ValuePtr argumentValue = arguments.at(argumentNodePair.first);
+            switch (argumentValue->GetDataType())
+            {
+            case DataType::Float:
+                PopulateComputationNodeValue<float>({ argumentNodePair.first, argumentValue }, argumentNodePair.second);
+                break;
+            case DataType::Double:
+                PopulateComputationNodeValue<double>({ argumentNodePair.first, argumentValue }, argumentNodePair.second);
+                break;
+            default:
+                LogicError("Unsupported DataType %s", DataTypeName(argumentValue->GetDataType()));
+                break;
+            }
+        }
+
+        m_computationNetwork->BumpEvalTimeStamp(plan.m_inputNodes);
 
-        // Dropout nodes have an implicit input in the form of the random mask that is applied to its explicit input
-        // This mask is regerated every minibatch and hence dropout nodes with a non-zero dropout rate must me marked outdated
-        // w.r.t. inputs to force evaluation in each minibatch
-        list<ComputationNodeBasePtr> dropoutNodes = m_computationNetwork->GetNodesWithType(OperationNameOf(DropoutNode));
-        for (auto& nodeIter : dropoutNodes)
+        for (auto& nodeIter : plan.m_dropoutNodes)
             nodeIter->SetEvalTimeStampOutdatedWrtAll();
-        
+
         // Bump the timestamp of the parameter nodes whose values have changed
         for (auto& paramTimeStampRecord : m_lastRecordedParameterValueTimeStamps)
         {
@@ -1348,24 +1382,19 @@ namespace CNTK
             }
         }
 
-        // The 'outputsToRetainBackwardStateFor' nodes also need to be evaluated if not already specified in 'outputs'
-        for (auto rootVarForBackprop : outputsToRetainBackwardStateFor)
-        {
-            if (outputs.find(rootVarForBackprop) == outputs.end())
-                outputsToEvaluate.push_back(m_variableToNodeMap.at(rootVarForBackprop));
-        }
-
         // Reset the timestamps of all backward roots to record an update in one or more inputs
-        for (auto& backpropRoot : m_currentBackpropRoots)
-            m_variableToNodeMap.at(backpropRoot)->SetEvalTimeStampOutdatedWrtAll();
+        for (auto& backpropRootNode : plan.m_backpropRootResetNodes)
+            backpropRootNode->SetEvalTimeStampOutdatedWrtAll();
 
         // TODO: Verify that values were supplied for all inputs that requested outputs depend on
 
         ScopedNetworkOperationMode modeGuard(m_computationNetwork, outputsToRetainBackwardStateFor.empty() ? NetworkOperationMode::inferring : NetworkOperationMode::training);
 
-        m_computationNetwork->ForwardProp(outputsToEvaluate);
+        m_computationNetwork->ForwardProp(plan.m_outputsToEvaluate);
 
-        GetNetworkOutputs(outputs);
+        // Now copy the Forward values of output nodes from the network to outputs' Value objects
+        for (auto& outputNodePair : plan.m_outputNodes)
+            GetNodeOutputOrGradient(outputNodePair.first, outputs[outputNodePair.first], outputNodePair.second, false /*getGradient*/);
 
         // TODO: How to deal with the specified 'computeDevice'
         Variable evalTimeStampVariable;
@@ -247,14 +247,12 @@ namespace CNTK
 
         template <typename ElementType>
         static void PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode);
-        void PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments);
 
         template <typename ElementType>
         static void PopulateComputationNodeGradient(const std::pair<Variable, ValuePtr>& variableGradient, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode);
         void PopulateNetworkGradients(const std::unordered_map<Variable, ValuePtr>& gradients);
 
         static void GetNodeOutputOrGradient(Variable var, ValuePtr& varValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, bool getGradient);
-        void GetNetworkOutputs(std::unordered_map<Variable, ValuePtr>& outputs);
         void GetNetworkGradients(std::unordered_map<Variable, ValuePtr>& gradients);
 
         const std::vector<Variable>& GetArgumentDependencies(const Variable& output);
@@ -290,6 +288,27 @@ namespace CNTK
 
         std::unordered_map<Variable, std::vector<Variable>> m_perOutputVarArgumentDependencies;
 
+        // Bindings resolved by the most recent 'Forward' call: the computation nodes backing
+        // the supplied argument and requested output variables, the set of nodes to evaluate
+        // and the nodes whose eval timestamps need resetting each call. Successive 'Forward'
+        // calls with the same argument, output and backprop root sets (the steady state of
+        // evaluation and training loops) reuse these bindings and skip the per-call dependency
+        // analysis and node map lookups.
+        struct ForwardPlan
+        {
+            std::unordered_set<Variable> m_arguments;
+            std::unordered_set<Variable> m_outputs;
+            std::unordered_set<Variable> m_backpropRoots;
+            std::vector<std::pair<Variable, Microsoft::MSR::CNTK::ComputationNodeBasePtr>> m_argumentNodes;
+            std::vector<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_inputNodes;
+            std::vector<std::pair<Variable, Microsoft::MSR::CNTK::ComputationNodeBasePtr>> m_outputNodes;
+            std::vector<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_outputsToEvaluate;
+            std::vector<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_backpropRootResetNodes;
+            std::list<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_dropoutNodes;
+        };
+
+        std::unique_ptr<ForwardPlan> m_forwardPlan;
+
         bool m_networkMatricesAllocated;
 
         std::unordered_map<Parameter, size_t> m_lastRecordedParameterValueTimeStamps;
@@ -284,13 +284,55 @@ namespace CNTK
         AggregateImpl(values, values, sendToWorkers);
     }
 
+    // State of one in-flight aggregation. The views keep the data (and the staging buffers, via
+    // the communicator) alive; the operation handles must not move once tracked, so the vector is
+    // sized once and never resized.
+    struct MPICommunicatorImpl::PendingAggregate
+    {
+        std::vector<NDArrayViewPtr> inputs;
+        std::vector<NDArrayViewPtr> outputs;
+        std::vector<MPIWrapper::AsyncOperation> ops;
+    };
+
     void  MPICommunicatorImpl::AggregateImpl(
         const std::vector<NDArrayViewPtr>& inputValues,
         const std::vector<NDArrayViewPtr>& outputValues,
         const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        AggregateBeginImpl(inputValues, outputValues, sendToWorkers);
+        AggregateCompleteImpl();
+    }
+
+    void MPICommunicatorImpl::AggregateInPlaceAsync(
+        const std::vector<NDArrayViewPtr>& values,
+        const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
+    {
+        auto device = GetNonCPUDevice(values);
+        if (device.Type() != DeviceKind::CPU)
+        {
+            // the staging copies run on a separate stream; make sure the gradients have actually
+            // been produced on the compute stream before they start (same as the blocking path)
+            std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(device.Id()));
+            mainStreamSyncEvent->SynchronizeDataTransferFetchStreamWithEvent<float>();
+        }
+        AggregateBeginImpl(values, values, sendToWorkers);
+    }
+
+    void MPICommunicatorImpl::WaitAggregateAsyncDone()
+    {
+        AggregateCompleteImpl();
+    }
+
+    void MPICommunicatorImpl::AggregateBeginImpl(
+        const std::vector<NDArrayViewPtr>& inputValues,
+        const std::vector<NDArrayViewPtr>& outputValues,
+        const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers)
     {
         CheckWorkers(sendToWorkers);
 
+        if (m_pendingAggregate != nullptr)
+            RuntimeError("AggregateBeginImpl: a previous asynchronous aggregation has not been awaited.");
+
         if (m_mpi->NumNodesInUse() == 1) // No need to aggregate anything.
             return;
 
@@ -314,71 +356,118 @@ namespace CNTK
             }
         }
 
-        std::vector<MPI_Request> allReduceRequests(numValues);
-        for (auto i = 0; i < numValues; ++i)
-        {
-            auto inputValue = inputValues[i];
+        auto pending = std::make_shared<PendingAggregate>();
+        pending->inputs = inputValues;
+        pending->outputs = outputValues;
+        pending->ops.resize(numValues);
 
-            if (inputValue->Device() != DeviceDescriptor::CPUDevice())
+        // Post the all-reduces: CPU-resident values first -- their data is ready immediately --
+        // then each GPU value once its staging copy has drained. Device placement is identical on
+        // every rank, so the posting order is too, as nonblocking collectives require.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (auto i = 0; i < numValues; ++i)
             {
-                // TODO: actually, we can start reducing all cpu values first, and then wait for the gpu->cpu transfer to finish.
-                m_gpuDataTransferers[i]->WaitForCopyGPUToCPUAsync();
-            }
+                auto inputValue = inputValues[i];
+                bool onGpu = inputValue->Device() != DeviceDescriptor::CPUDevice();
+                if (onGpu != (pass == 1))
+                    continue;
+
+                if (onGpu)
+                    m_gpuDataTransferers[i]->WaitForCopyGPUToCPUAsync();
+
+                auto numElements = inputValue->Shape().TotalSize();
+                auto dataType = inputValue->GetDataType();
+
+                auto& outputValue = outputValues[i];
+
+                assert(numElements == outputValue->Shape().TotalSize());
+                assert(dataType == outputValue->GetDataType());
+                assert(inputValue->Device() == outputValue->Device());
+
+                void* inputData = onGpu ? m_intermediateCPUBuffers[i].data.get() : GetDataBuffer(inputValue);
+                void* outputData = onGpu ? m_intermediateCPUBuffers[i].data.get() : GetDataBuffer(outputValue);
+
+                auto request = &pending->ops[i].request;
+                if (dataType == DataType::Float)
+                {
+                    if (inputData == outputData)
+                        m_mpi->AllReduceAsync<float>(static_cast<float*>(outputData), numElements, request);
+                    else
+                        m_mpi->AllReduceAsync<float>(static_cast<float*>(inputData), static_cast<float*>(outputData), numElements, request);
+                }
+                else if (dataType == DataType::Double)
+                {
+                    if (inputData == outputData)
+                        m_mpi->AllReduceAsync<double>(static_cast<double*>(outputData), numElements, request);
+                    else
+                        m_mpi->AllReduceAsync<double>(static_cast<double*>(inputData), static_cast<double*>(outputData), numElements, request);
+                }
+                else
+                    LogicError("Unknown DataType");
 
-            auto numElements = inputValue->Shape().TotalSize();
-            auto dataType = inputValue->GetDataType();
+                m_mpi->TrackAsync(&pending->ops[i]); // no-op unless the MPI progress thread is enabled
+            }
+        }
 
-            auto& outputValue = outputValues[i];
+        m_pendingAggregate = std::move(pending);
+    }
 
-            assert(numElements == outputValue->Shape().TotalSize());
-            assert(dataType == outputValue->GetDataType());
-            assert(inputValue->Device() == outputValue->Device());
+    void MPICommunicatorImpl::AggregateCompleteImpl()
+    {
+        auto pending = std::move(m_pendingAggregate);
+        if (pending == nullptr) // single worker or empty value list: nothing was posted
+            return;
 
-            void* inputData = (inputValue->Device() != DeviceDescriptor::CPUDevice()) ? m_intermediateCPUBuffers[i].data.get() : GetDataBuffer(inputValue);
-            void* outputData = (inputValue->Device() != DeviceDescriptor::CPUDevice()) ? m_intermediateCPUBuffers[i].data.get() : GetDataBuffer(outputValue);
+        auto& inputValues = pending->inputs;
+        auto& outputValues = pending->outputs;
+        auto numValues = inputValues.size();
 
-            if (dataType == DataType::Float)
+        // as soon as a value's reduction is finished, initiate its cpu-to-gpu transfer (if gpu bound)
+        auto startUpload = [&](size_t idx)
+        {
+            if (inputValues[idx]->Device() != DeviceDescriptor::CPUDevice())
             {
-                if (inputData == outputData)
-                    m_mpi->AllReduceAsync<float>(static_cast<float*>(outputData), numElements, &allReduceRequests[i]);
-                else
-                    m_mpi->AllReduceAsync<float>(static_cast<float*>(inputData), static_cast<float*>(outputData), numElements, &allReduceRequests[i]);
+                auto view = outputValues[idx];
+                auto size = GetBufferSize(view);
+                auto& transferer = m_gpuDataTransferers[idx];
+                auto& buffer = m_intermediateCPUBuffers[idx];
+                transferer->CopyCPUToGPUAsync(buffer.data.get(), size, GetDataBuffer(view));
             }
-            else if (dataType == DataType::Double)
+        };
+
+        if (m_mpi->AsyncProgressEnabled())
+        {
+            // the progress thread drives all requests concurrently; draining them in posting
+            // order loses nothing
+            for (size_t i = 0; i < numValues; ++i)
             {
-                if (inputData == outputData)
-                    m_mpi->AllReduceAsync<double>(static_cast<double*>(outputData), numElements, &allReduceRequests[i]);
-                else
-                    m_mpi->AllReduceAsync<double>(static_cast<double*>(inputData), static_cast<double*>(outputData), numElements, &allReduceRequests[i]);
+                m_mpi->WaitAsync(&pending->ops[i]);
+                startUpload(i);
             }
-            else
-                LogicError("Unknown DataType");
         }
-
-        // wait for async all reduce to complete. As soon as one of the requests is finished,
-        // check if corresponding value is gpu bound and, if it is the case, initiate a cpu-to-gpu transfer.
-        size_t numAllReduceRequestsCompleted = 0;
-        while (numAllReduceRequestsCompleted < numValues)
+        else
         {
-            int idx = MPI_UNDEFINED;
-            m_mpi->WaitAny(allReduceRequests.data(), (int)allReduceRequests.size(), &idx);
-            if (idx == MPI_UNDEFINED)
+            // no progress thread: wait with WaitAny so each upload starts as soon as its
+            // reduction finishes, regardless of completion order
+            std::vector<MPI_Request> allReduceRequests(numValues);
+            for (size_t i = 0; i < numValues; ++i)
+                allReduceRequests[i] = pending->ops[i].request;
+
+            size_t numAllReduceRequestsCompleted = 0;
+            while (numAllReduceRequestsCompleted < numValues)
             {
-                break;
-            }
-
-            numAllReduceRequestsCompleted++;
+                int idx = MPI_UNDEFINED;
+                m_mpi->WaitAny(allReduceRequests.data(), (int)allReduceRequests.size(), &idx);
+                if (idx == MPI_UNDEFINED)
+                {
+                    break;
+                }
 
-            assert(idx < inputValues.size());
-            auto value = inputValues[idx];
+                numAllReduceRequestsCompleted++;
 
-            if (value->Device() != DeviceDescriptor::CPUDevice())
-            {
-                auto view = outputValues[idx];
-                auto size = GetBufferSize(view);
-                auto& transferer = m_gpuDataTransferers[idx];
-                auto& buffer = m_intermediateCPUBuffers[idx];
-                transferer->CopyCPUToGPUAsync(buffer.data.get(), size, GetDataBuffer(view));
+                assert(idx < inputValues.size());
+                startUpload(idx);
             }
         }
 
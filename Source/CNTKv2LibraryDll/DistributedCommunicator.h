@@ -55,6 +55,14 @@ namespace CNTK
             std::vector<NDArrayViewPtr>& outValues,
             const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
 
+        // genuine nonblocking aggregation: GPU staging copies and MPI_Iallreduce are initiated
+        // here, and awaited in WaitAggregateAsyncDone()
+        virtual void AggregateInPlaceAsync(
+            const std::vector<NDArrayViewPtr>& values,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers) override;
+
+        virtual void WaitAggregateAsyncDone() override;
+
         virtual void Barrier() override;
 
         virtual ~MPICommunicatorImpl() {}
@@ -67,6 +75,20 @@ namespace CNTK
             const std::vector<NDArrayViewPtr>& outputValues,
             const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers);
 
+        // split of AggregateImpl into its initiation and completion halves, shared by the
+        // blocking and the nonblocking entry points
+        void AggregateBeginImpl(
+            const std::vector<NDArrayViewPtr>& inputValues,
+            const std::vector<NDArrayViewPtr>& outputValues,
+            const std::unordered_set<DistributedWorkerDescriptor>& sendToWorkers);
+        void AggregateCompleteImpl();
+
+        // state of an in-flight nonblocking aggregation (at most one per communicator); the
+        // views are retained so their buffers stay alive until completion. Defined in the
+        // translation unit to keep MPI types out of this header.
+        struct PendingAggregate;
+        std::shared_ptr<PendingAggregate> m_pendingAggregate;
+
         struct Buffer
         {
             std::shared_ptr<void> data = nullptr;
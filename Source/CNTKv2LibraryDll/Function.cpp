@@ -246,6 +246,19 @@ namespace CNTK
         Forward(arguments, outputs, computeDevice, {});
     }
 
+    std::future<std::unordered_map<Variable, ValuePtr>> Function::EvaluateAsync(const std::unordered_map<Variable, ValuePtr>& arguments,
+                                                                                std::unordered_map<Variable, ValuePtr> outputs,
+                                                                                const DeviceDescriptor& computeDevice /*= DeviceDescriptor::UseDefaultDevice()*/)
+    {
+        auto thisPtr = shared_from_this();
+        return std::async(std::launch::async, [thisPtr, arguments, outputs, computeDevice]() mutable
+        {
+            std::lock_guard<std::mutex> guard(thisPtr->m_evaluationMutex);
+            thisPtr->Forward(arguments, outputs, computeDevice, {});
+            return outputs;
+        });
+    }
+
     void Function::SaveModel(const std::wstring& modelFilePath)
     {
         Dictionary model = Serialize();
@@ -604,6 +617,38 @@ namespace CNTK
     }
 
 
+    FunctionPtr Function::Specialize(const std::unordered_map<Variable, ValuePtr>& exampleBindings) const
+    {
+        std::unordered_map<Variable, Variable> replacements;
+        for (const auto& argument : Arguments())
+        {
+            auto argumentShape = argument.Shape();
+            if (!argumentShape.HasInferredDimension())
+                continue;
+
+            if (exampleBindings.find(argument) == exampleBindings.end())
+                InvalidArgument("Function::Specialize: No example binding was specified for argument '%S' whose shape has one or more inferred dimensions", argument.Name().c_str());
+
+            const auto& exampleValue = exampleBindings.at(argument);
+            auto exampleValueShape = exampleValue->Shape();
+            if (exampleValueShape.Rank() < argumentShape.Rank())
+                InvalidArgument("Function::Specialize: The rank of the example Value bound to argument '%S' is less than the rank of the argument itself", argument.Name().c_str());
+
+            auto specializedShape = exampleValueShape.SubShape(0, argumentShape.Rank());
+            for (size_t i = 0; i < argumentShape.Rank(); ++i)
+            {
+                if ((argumentShape[i] != NDShape::InferredDimension) && (argumentShape[i] != specializedShape[i]))
+                    InvalidArgument("Function::Specialize: The shape of the example Value bound to argument '%S' does not match the argument's known dimensions", argument.Name().c_str());
+            }
+
+            replacements[argument] = InputVariable(specializedShape, argument.IsSparse(), argument.GetDataType(), argument.NeedsGradient(), argument.Name(), argument.DynamicAxes());
+        }
+
+        // Cloning with the frozen-shape replacements re-runs static shape validation over the
+        // entire graph, so all downstream output shapes are re-derived from the fixed dimensions.
+        return Clone(ParameterCloningMethod::Share, replacements);
+    }
+
     /*virtual*/ void Function::RestoreFromCheckpoint(const Dictionary& modelDictionary)
     {
         CompositeFunction* compositeFunction = dynamic_cast<CompositeFunction*>(this);
@@ -232,6 +232,13 @@ namespace CNTK
         // make sure trainingSampleCount is a valid value
         assert(trainingSampleCount > 0);
 
+        if (TryBatchedUpdate(gradientValues, trainingSampleCount))
+        {
+            m_sampleCount += trainingSampleCount;
+            m_minibatchCount++;
+            return true;
+        }
+
         for (const auto& parameter : Parameters())
         {
             const auto& smoothedGradientValue = m_smoothedGradientValues.at(parameter);
@@ -387,6 +394,82 @@ namespace CNTK
                                            learningRate, momentum, UseNesterovMomentum());
     }
 
+    /*virtual*/ bool LearnerSGD::TryBatchedUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const /*override*/
+    {
+#if defined(_DEBUG) || DUMPOUTPUT
+        // Keep the per-parameter path in debug builds, so that the per-parameter NaN checks
+        // (and the DUMPOUTPUT tracing) in LearnerBase::Update run for every update.
+        UNUSED(gradientValues);
+        UNUSED(trainingSampleCount);
+        return false;
+#else
+        // Any of the additional learning options requires the per-parameter pre/post-processing
+        // passes, which the batched update bypasses.
+        if ((m_additionalOptions.gradientClippingThresholdPerSample != numeric_limits<double>::infinity()) ||
+            (m_additionalOptions.l1RegularizationWeight > 0) ||
+            (m_additionalOptions.l2RegularizationWeight > 0) ||
+            (GetCurrentTrainingParameterValue(m_additionalOptions.gaussianNoiseInjectionStdDev) > 0))
+        {
+            return false;
+        }
+
+        // Sparse gradients take a different update path inside NormalGrad (they modify the
+        // gradient in place), so fall back to the per-parameter loop if any are present.
+        for (const auto& parameter : Parameters())
+        {
+            if ((gradientValues.at(parameter)->GetStorageFormat() != StorageFormat::Dense) ||
+                (parameter.Value()->GetStorageFormat() != StorageFormat::Dense))
+            {
+                return false;
+            }
+        }
+
+        BatchedUpdate<float>(gradientValues, trainingSampleCount);
+        BatchedUpdate<double>(gradientValues, trainingSampleCount);
+
+        for (const auto& parameter : Parameters())
+        {
+            auto paramRef = parameter;
+            paramRef.RecordValueUpdate();
+        }
+
+        return true;
+#endif
+    }
+
+    template <typename ElementType>
+    void LearnerSGD::BatchedUpdate(unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const
+    {
+        const auto learningRate = ElementType(LearningRate(trainingSampleCount));
+        const auto momentum = ElementType(MomentumValueForMB(trainingSampleCount));
+
+        std::vector<std::shared_ptr<Matrix<ElementType>>> referencedMatrices; // keeps the matrix views alive across the batched call
+        std::vector<Matrix<ElementType>*> smoothedGradientMatrices, gradientMatrices, parameterMatrices;
+        for (const auto& parameter : Parameters())
+        {
+            if (parameter.GetDataType() != AsDataType<ElementType>())
+                continue;
+
+            auto smoothedGradientMatrix = GetWritableMatrix<ElementType>(m_smoothedGradientValues.at(parameter));
+            auto gradientMatrix = GetWritableMatrix<ElementType>(gradientValues.at(parameter));
+            auto parameterMatrix = GetWritableMatrix<ElementType>(parameter.Value());
+
+            smoothedGradientMatrices.push_back(smoothedGradientMatrix.get());
+            gradientMatrices.push_back(gradientMatrix.get());
+            parameterMatrices.push_back(parameterMatrix.get());
+
+            referencedMatrices.push_back(smoothedGradientMatrix);
+            referencedMatrices.push_back(gradientMatrix);
+            referencedMatrices.push_back(parameterMatrix);
+        }
+
+        if (smoothedGradientMatrices.empty())
+            return;
+
+        Matrix<ElementType>::BatchedNormalGrad(smoothedGradientMatrices, gradientMatrices, parameterMatrices,
+                                               learningRate, momentum, UseNesterovMomentum());
+    }
+
     double LearnerMomentumSGD::MomentumValueForMB(const MomentumSchedule& schedule, size_t minibatchSize) const
     {
         double currentMomentum = GetCurrentTrainingParameterValue(schedule);
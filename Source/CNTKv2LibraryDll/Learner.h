@@ -39,6 +39,15 @@ namespace CNTK
 
         virtual void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const = 0;
 
+        // Gives subclasses a chance to update all parameters with a batched (multi-tensor) kernel
+        // instead of the per-parameter loop in the public Update method. A subclass that cannot
+        // batch the update (or cannot batch it for the current learning options) returns false,
+        // in which case the per-parameter path is taken.
+        virtual bool TryBatchedUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& /*gradientValues*/, size_t /*trainingSampleCount*/) const
+        {
+            return false;
+        }
+
         std::string LearnerType() const;
 
         // Returns current (per-sample) learning rate.
@@ -135,6 +144,14 @@ namespace CNTK
 
         template <typename ElementType>
         void Update(const Parameter& parameter, const NDArrayViewPtr& gradientValue, const NDArrayViewPtr& smoothedGradientValue, size_t trainingSampleCount) const;
+
+        // Updates all parameters of a data type with a single batched NormalGrad call, provided
+        // that none of the additional learning options (gradient clipping, regularization, noise
+        // injection) require the per-parameter pre/post-processing passes.
+        virtual bool TryBatchedUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const override;
+
+        template <typename ElementType>
+        void BatchedUpdate(std::unordered_map<Parameter, NDArrayViewPtr>& gradientValues, size_t trainingSampleCount) const;
     };
 
     // SGD optimization with momentum. 
@@ -125,6 +125,20 @@ namespace CNTK
             deserializerConfigDict[L"module"] = deserializerTypeNameToModuleNameMap.at(deserializerTypeName);
         }
 
+        // 'prefetchBufferCount' is the V2 name for the reader shim's pipeline depth: the shim
+        // keeps that many minibatch reads in flight, each with its own device-transfer slot, so
+        // a single slow read does not stall the training loop. Map it onto the shim's key; the
+        // native 'numPrefetchBuffers' spelling is passed through unchanged for parity with the
+        // V1 configuration.
+        const wchar_t* prefetchBufferCountConfigurationKey = L"prefetchBufferCount";
+        if (augmentedConfiguration.Contains(prefetchBufferCountConfigurationKey))
+        {
+            size_t prefetchBufferCount = augmentedConfiguration[prefetchBufferCountConfigurationKey].Value<size_t>();
+            if (prefetchBufferCount < 2)
+                InvalidArgument("prefetchBufferCount (%zu) must be at least 2", prefetchBufferCount);
+            augmentedConfiguration[L"numPrefetchBuffers"] = prefetchBufferCount;
+        }
+
         ConfigParameters config;
         std::wstringstream s;
         for (const auto& keyValuePair : *(augmentedConfiguration.m_dictionaryData))
@@ -305,7 +319,16 @@ namespace CNTK
                     if (!matrix)
                         LogicError("Invalid matrix type.");
 
-                    minibatchValuePtr = MakeSharedObject<PackedValue>(s.m_sampleLayout, matrix, input.pMBLayout, /*readOnly =*/ false);
+                    // Recycle the previous value object of the stream if all consumers have
+                    // dropped it (the pool holds the only reference) and it has not been
+                    // unpacked; this avoids the per-minibatch value and view churn, since the
+                    // reader-owned matrix and layout objects are stable across minibatches.
+                    auto& recycled = m_recycledMinibatchValues[s.m_name];
+                    auto recycledPackedValue = (recycled.use_count() == 1) ? dynamic_pointer_cast<PackedValue>(recycled) : nullptr;
+                    if (recycledPackedValue && recycledPackedValue->TryRebind<float>(matrix, input.pMBLayout))
+                        minibatchValuePtr = recycled;
+                    else
+                        recycled = minibatchValuePtr = MakeSharedObject<PackedValue>(s.m_sampleLayout, matrix, input.pMBLayout, /*readOnly =*/ false);
 
                     size_t numSamples = input.pMBLayout->GetActualNumSamples();
                     size_t numSequences = input.pMBLayout->GetNumSequences();
@@ -60,6 +60,11 @@ namespace CNTK
         std::unordered_map<StreamInformation, MinibatchData> m_minibatchData;
         std::vector<Microsoft::MSR::CNTK::StreamDescriptionPtr> m_compositeDataReaderStreamDescs;
 
+        // Per-stream pool of value objects recycled across GetNextMinibatch calls; each
+        // stream has a fixed shape, device and storage format, so the previous value can be
+        // rebound to the new minibatch contents when all consumers have dropped it.
+        std::unordered_map<std::wstring, ValuePtr> m_recycledMinibatchValues;
+
         // For now reusing the shim to allow prefetch.
         // Please only use a subset of the shim interface that includes
         // Init()/StartEpoch()/GetMinibatch()/IsEndOfEpoch()
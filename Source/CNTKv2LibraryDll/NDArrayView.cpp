@@ -8,7 +8,9 @@
 #include "Utils.h"
 #include "TensorView.h"
 #include "Matrix.h"
+#include "DataTransferer.h"
 #include <algorithm>
+#include <mutex>
 #include "TensorShape.h"
 
 using namespace Microsoft::MSR::CNTK;
@@ -84,6 +86,7 @@ namespace CNTK
     NDArrayView::NDArrayView(CNTK::DataType dataType, const NDShape& viewShape, void* dataBuffer, size_t bufferSizeInBytes, const DeviceDescriptor& device, bool readOnly/* = false*/)
         : NDArrayView(dataType, device, StorageFormat::Dense, viewShape, readOnly, AllocateTensorView(dataType, viewShape, device, dataBuffer, bufferSizeInBytes))
     {
+        m_isBorrowed = true;
     }
 
     template <typename ElementType>
@@ -99,16 +102,16 @@ namespace CNTK
     }
 
     NDArrayView::NDArrayView(CNTK::DataType dataType, const DeviceDescriptor& device, CNTK::StorageFormat storageType, const NDShape& viewShape, bool readOnly, void* tensorView)
-        : m_dataType(dataType), m_device(device), m_storageFormat(storageType), m_viewShape(viewShape), m_isReadOnly(readOnly)
+        : m_dataType(dataType), m_device(device), m_storageFormat(storageType), m_viewShape(viewShape), m_isReadOnly(readOnly), m_isBorrowed(false)
     {
-        m_tensorView = std::shared_ptr<void>(tensorView, [this](void*) {
+        m_tensorView = std::shared_ptr<void>(tensorView, [this](void* ptr) {
             switch (m_dataType)
             {
             case DataType::Float:
-                delete GetTensorView<float>();
+                delete (TensorView<float>*)ptr;
                 break;
             case DataType::Double:
-                delete GetTensorView<double>();
+                delete (TensorView<double>*)ptr;
                 break;
             default:
                 LogicError("Unsupported DataType %s", DataTypeName(m_dataType));
@@ -200,6 +203,9 @@ namespace CNTK
         if (AsDataType<ElementType>() != m_dataType)
             LogicError("NDArrayView::GetTensorView: The specified ElementType %s does not match the DataType %s", typeid(ElementType).name(), DataTypeName(m_dataType));
 
+        if (m_tensorView == nullptr)
+            LogicError("NDArrayView::GetTensorView: The external buffer underlying this view has been invalidated");
+
         return (const TensorView<ElementType>*)(m_tensorView.get());
     }
 
@@ -289,6 +295,14 @@ namespace CNTK
         return MakeSharedObject<NDArrayView>(GetDataType(), Device(), GetStorageFormat(), Shape(), IsReadOnly() || readOnly, tensorView);
     }
 
+    void NDArrayView::Invalidate()
+    {
+        if (!m_isBorrowed)
+            InvalidArgument("NDArrayView::Invalidate: Only a NDArrayView constructed over an external caller-owned buffer can be invalidated");
+
+        m_tensorView = nullptr;
+    }
+
     // TODO: This could actually be strided?
     template <typename ElementType>
     ElementType* NDArrayView::WritableDataBuffer()
@@ -344,6 +358,72 @@ namespace CNTK
         m_device = device;
     }
 
+    // One upload transferer per GPU device, created lazily and reused; creating a transferer
+    // spins up dedicated copy streams and events. The per-device lock serializes concurrent
+    // uploads, which would contend for the transferer's copy stream anyway.
+    struct UploadTransferer
+    {
+        std::mutex m_mutex;
+        DataTransfererPtr m_transferer;
+    };
+
+    static UploadTransferer& GetUploadTransferer(int deviceId)
+    {
+        static std::mutex s_mapMutex;
+        static std::unordered_map<int, std::unique_ptr<UploadTransferer>> s_uploadTransferers;
+
+        std::unique_lock<std::mutex> lock(s_mapMutex);
+        auto& entry = s_uploadTransferers[deviceId];
+        if (entry == nullptr)
+            entry.reset(new UploadTransferer());
+
+        return *entry;
+    }
+
+    template <typename ElementType>
+    static NDArrayViewPtr CreateViewFromHostBuffer(const NDShape& viewShape, const void* dataBuffer, size_t bufferSizeInBytes, const DeviceDescriptor& device)
+    {
+        if (dataBuffer == nullptr)
+            InvalidArgument("Cannot create a NDArrayView over a null data buffer");
+
+        if (bufferSizeInBytes < (viewShape.TotalSize() * sizeof(ElementType)))
+            InvalidArgument("Size of the specified buffer for creating the NDArrayView is smaller than the specified view shape");
+
+        auto deviceId = AsCNTKImplDeviceId(device);
+        auto matrixDims = GetMatrixDimensions(viewShape);
+        auto matrix = std::make_shared<Matrix<ElementType>>(matrixDims.first, matrixDims.second, deviceId, MatrixType::DENSE, matrixFormatDense);
+        if (device.Type() == DeviceKind::CPU)
+            matrix->SetValue(matrixDims.first, matrixDims.second, deviceId, (ElementType*)dataBuffer);
+        else
+        {
+            auto& upload = GetUploadTransferer(deviceId);
+            std::unique_lock<std::mutex> lock(upload.m_mutex);
+            if (upload.m_transferer == nullptr)
+                upload.m_transferer = CreatePrefetchDataTransferer(deviceId);
+
+            matrix->SetValue(matrixDims.first, matrixDims.second, deviceId, (ElementType*)dataBuffer, matrixFlagNormal, upload.m_transferer.get());
+            upload.m_transferer->RecordCPUToGPUCopy();
+            upload.m_transferer->WaitForCopyCPUToGPU();
+        }
+
+        auto tensorView = new TensorView<ElementType>(matrix, AsTensorViewShape(viewShape));
+        return MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), device, StorageFormat::Dense, viewShape, false, tensorView);
+    }
+
+    /*static*/ NDArrayViewPtr NDArrayView::CreateFromPinnedHostBuffer(CNTK::DataType dataType, const NDShape& viewShape, const void* dataBuffer, size_t bufferSizeInBytes, const DeviceDescriptor& device)
+    {
+        switch (dataType)
+        {
+        case DataType::Float:
+            return CreateViewFromHostBuffer<float>(viewShape, dataBuffer, bufferSizeInBytes, device);
+        case DataType::Double:
+            return CreateViewFromHostBuffer<double>(viewShape, dataBuffer, bufferSizeInBytes, device);
+        default:
+            LogicError("Unsupported DataType %s", DataTypeName(dataType));
+            break;
+        }
+    }
+
     template <typename ElementType>
     /*static*/ NDArrayViewPtr NDArrayView::RandomNormal(const NDShape& shape, double mean, double stdDev, unsigned long seed, const DeviceDescriptor& device /*= DeviceDescriptor::UseDefaultDevice()*/)
     {
@@ -32,7 +32,11 @@ namespace CNTK
         if (shape.Rank() > 2)
             LogicError("NDMask instances with more than 2 axes are currently unsupported");
 
-        Clear();
+        // Batch the initial section marking: sections are recorded into this CPU-side staging
+        // buffer and materialized with a single assignment on first access to the underlying
+        // matrix. Masks created from an externally supplied matrix (e.g. aliases) bypass the
+        // staging since their matrix contents are shared.
+        m_stagedMaskValues.assign(m_maskShape.TotalSize(), (char)MaskKind::Valid);
     }
 
     NDMask::~NDMask()
@@ -40,9 +44,6 @@ namespace CNTK
 
     void NDMask::MarkSectionAs(const std::vector<size_t>& sectionOffset, const NDShape& sectionShape, MaskKind maskKind)
     {
-        // TODO: Implement batching of masking operation for masks residing on GPUs to avoid making
-        // GPU invocations for each MaskSection call.
-
         if (sectionOffset.size() > m_maskShape.Rank())
             LogicError("NDMask::MaskSection: The sectionOffset cannot have dimensionality higher than the rank of 'this' mask");
 
@@ -55,6 +56,23 @@ namespace CNTK
 
         NDShape shape = sectionShape.AppendShape(NDShape(m_maskShape.Rank() - sectionShape.Rank(), NDShape::InferredDimension));
 
+        if (!m_stagedMaskValues.empty())
+        {
+            // Staged path: record the section with plain CPU writes; all staged sections are
+            // materialized together by the single assignment in GetMatrix()
+            auto matrixDims = GetMatrixDimensions(m_maskShape);
+            size_t numRows = matrixDims.first;
+            size_t numCols = matrixDims.second;
+            size_t rowOffset = offset[0];
+            size_t colOffset = offset[1];
+            size_t sliceRowLength = (shape[0] != NDShape::InferredDimension) ? shape[0] : (numRows - rowOffset);
+            size_t sliceColLength = (shape[1] != NDShape::InferredDimension) ? shape[1] : (numCols - colOffset);
+            for (size_t i = colOffset; i < (colOffset + sliceColLength); ++i)
+                std::fill_n(m_stagedMaskValues.data() + (i * numRows) + rowOffset, sliceRowLength, (char)maskKind);
+
+            return;
+        }
+
         auto maskMatrix = GetMatrix();
         size_t rowOffset = offset[0];
         size_t colOffset = offset[1];
@@ -77,11 +95,19 @@ namespace CNTK
     void NDMask::Clear()
     {
         // Clear the mask by marking all samples as Valid
-        GetMatrix()->SetValue((char)MaskKind::Valid);
+        if (!m_stagedMaskValues.empty())
+            std::fill(m_stagedMaskValues.begin(), m_stagedMaskValues.end(), (char)MaskKind::Valid);
+        else
+            GetMatrix()->SetValue((char)MaskKind::Valid);
     }
 
     size_t NDMask::MaskedCount() const
     {
+        if (!m_stagedMaskValues.empty())
+            return std::count_if(m_stagedMaskValues.begin(), m_stagedMaskValues.end(), [](const char& val) {
+                return val == (char)MaskKind::Invalid;
+            });
+
         auto maskMatrix = GetMatrix();
         std::unique_ptr<char[]> maskData(maskMatrix->CopyToArray());
         return std::count_if(maskData.get(), maskData.get() + maskMatrix->GetNumElements(), [](const char& val) {
@@ -89,6 +115,30 @@ namespace CNTK
         });
     }
 
+    std::vector<size_t> NDMask::ValidFrameIndices() const
+    {
+        std::vector<size_t> validIndices;
+        auto gatherFrom = [&validIndices](const char* maskData, size_t numElements) {
+            validIndices.reserve(numElements);
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                if (maskData[i] != (char)MaskKind::Invalid)
+                    validIndices.push_back(i);
+            }
+        };
+
+        if (!m_stagedMaskValues.empty())
+            gatherFrom(m_stagedMaskValues.data(), m_stagedMaskValues.size());
+        else
+        {
+            auto maskMatrix = GetMatrix();
+            std::unique_ptr<char[]> maskData(maskMatrix->CopyToArray());
+            gatherFrom(maskData.get(), maskMatrix->GetNumElements());
+        }
+
+        return validIndices;
+    }
+
     // TODO: This could actually be strided?
     const MaskKind* NDMask::DataBuffer() const
     {
@@ -100,6 +150,15 @@ namespace CNTK
 
     Matrix<char>* NDMask::GetMatrix() const
     {
+        if (!m_stagedMaskValues.empty())
+        {
+            // Materialize all staged sections with a single assignment (one transfer/kernel for
+            // GPU-resident masks); subsequent section marking writes to the matrix directly
+            auto matrix = m_matrixView.get();
+            matrix->SetValue(matrix->GetNumRows(), matrix->GetNumCols(), matrix->GetDeviceId(), m_stagedMaskValues.data());
+            std::vector<char>().swap(m_stagedMaskValues);
+        }
+
         return m_matrixView.get();
     }
 
@@ -6,6 +6,7 @@
 #include "stdafx.h"
 #include "CNTKLibrary.h"
 #include "Utils.h"
+#include "ExceptionCapture.h"
 #include <istream>
 #include <ostream>
 #include <string>
@@ -54,6 +55,7 @@ namespace CNTK
 
         static void Copy(const DictionaryValue& src, proto::DictionaryValue& dst, Arena* arena = nullptr);
         static void Copy(const proto::DictionaryValue& src, DictionaryValue& dst);
+        static void Copy(const proto::Dictionary& src, Dictionary& dst);
 
         static proto::NDArrayView::DataType ToProtoType(DataType type)
         {
@@ -245,24 +247,74 @@ namespace CNTK
 
     /*static*/ proto::Dictionary* Serializer::CreateProto(const Dictionary& src, Arena* arena)
     {
-        proto::Dictionary* dst = (arena != nullptr) ? 
+        proto::Dictionary* dst = (arena != nullptr) ?
             Arena::CreateMessage<proto::Dictionary>(arena) : new proto::Dictionary();
         dst->set_version(src.s_version);
+
+        std::vector<const DictionaryValue*> values;
+        std::vector<proto::DictionaryValue*> protoValues;
+        values.reserve(src.m_dictionaryData->size());
+        protoValues.reserve(src.m_dictionaryData->size());
         for (const auto& kv : src)
         {
-            Copy(kv.second, dst->mutable_data()->operator[](ToString(kv.first)), arena);
+            values.push_back(&kv.second);
+            protoValues.push_back(&dst->mutable_data()->operator[](ToString(kv.first)));
+        }
+
+        // Converting the values is dominated by the payload copies of large NDArrayViews
+        // (e.g. model parameters in a checkpoint). With all map entries in place the per-key
+        // conversions are independent - arena allocation is thread safe - so run them in parallel.
+        if (values.size() > 1)
+        {
+            Microsoft::MSR::CNTK::ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < (int)values.size(); ++i)
+                capture.SafeRun([&](int index) { Copy(*values[index], *protoValues[index], arena); }, i);
+            capture.RethrowIfHappened();
+        }
+        else if (!values.empty())
+        {
+            Copy(*values.front(), *protoValues.front(), arena);
         }
+
         return dst;
     }
 
     /*static*/ Dictionary* Serializer::CreateFromProto(const proto::Dictionary& src)
     {
         Dictionary* dst = new Dictionary();
+        Copy(src, *dst);
+        return dst;
+    }
+
+    /*static*/ void Serializer::Copy(const proto::Dictionary& src, Dictionary& dst)
+    {
+        dst.m_dictionaryData->reserve(src.data_size());
+
+        std::vector<const proto::DictionaryValue*> protoValues;
+        std::vector<DictionaryValue*> values;
+        protoValues.reserve(src.data_size());
+        values.reserve(src.data_size());
         for (const auto& kv : src.data())
         {
-            Copy(kv.second, dst->operator[](ToWString(kv.first)));
+            protoValues.push_back(&kv.second);
+            values.push_back(&dst[ToWString(kv.first)]);
+        }
+
+        // Mirror of CreateProto above: once all keys are inserted the per-key copies only
+        // touch their own value, so the payload copies out of the parsed proto run in parallel.
+        if (values.size() > 1)
+        {
+            Microsoft::MSR::CNTK::ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < (int)values.size(); ++i)
+                capture.SafeRun([&](int index) { Copy(*protoValues[index], *values[index]); }, i);
+            capture.RethrowIfHappened();
+        }
+        else if (!values.empty())
+        {
+            Copy(*protoValues.front(), *values.front());
         }
-        return dst;
     }
 
     /*static*/ proto::DictionaryValue* Serializer::CreateProto(const DictionaryValue& src, Arena* arena)
@@ -446,11 +498,7 @@ namespace CNTK
         UsingUTF8 locale;
         proto::Dictionary proto;
         stream >> proto;
-        dictionary.m_dictionaryData->reserve(proto.data_size());
-        for (const auto& kv : proto.data())
-        {
-            Serializer::Copy(kv.second, dictionary[ToWString(kv.first)]);
-        }
+        Serializer::Copy(proto, dictionary);
         return stream;
     }
 
@@ -494,11 +542,7 @@ namespace CNTK
         ReadFromFile(filename, *proto);
 
         Dictionary dictionary;
-        dictionary.m_dictionaryData->reserve(proto->data_size());
-        for (const auto& kv : proto->data())
-        {
-            Serializer::Copy(kv.second, dictionary[ToWString(kv.first)]);
-        }
+        Serializer::Copy(*proto, dictionary);
 
         return dictionary;
     }
@@ -7,10 +7,17 @@
 #include "CNTKLibrary.h"
 #include "Utils.h"
 #include "Learner.h"
+#include "Matrix.h"
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 namespace
 {
     const std::wstring learnersPropertyName = L"Learners";
     const std::wstring externalStatePropertyName = L"ExternalState";
+    const std::wstring checkpointIdPropertyName = L"CheckpointId";
 }
 
 namespace CNTK
@@ -25,7 +32,11 @@ namespace CNTK
           m_evaluationFunction(evaluationFunction),
           m_parameterLearners(std::make_shared<Learners>(parameterLearners)),
           m_prevMinibatchNumSamples(1),
-          m_distributed(false)
+          m_accumulatedNumSamples(0),
+          m_distributed(false),
+          m_fullCheckpointFrequency(1),
+          m_fullCheckpointId(0),
+          m_deltaCheckpointsSinceFullCheckpoint(0)
     {
         // By default we set the number of threads to hardware concurrency.
         if (!Internal::MaxNumCPUThreadsSet())
@@ -76,12 +87,8 @@ namespace CNTK
     }
 
 
-    static double GetScalarValue(const ValuePtr& value)
+    static double GetScalarValue(const NDArrayViewPtr& scalarData)
     {
-        if (value->Mask())
-            LogicError("Scalar Value object cannot have an associated mask");
-
-        auto scalarData = value->Data();
         if (scalarData->Shape().TotalSize() != 1)
             LogicError("Scalar Value object's has a size > 1");
 
@@ -105,6 +112,51 @@ namespace CNTK
         return scalar;
     }
 
+    static double GetScalarValue(const ValuePtr& value)
+    {
+        if (value->Mask())
+            LogicError("Scalar Value object cannot have an associated mask");
+
+        return GetScalarValue(value->Data());
+    }
+
+    // Adds the aggregate loss/metric scalars of the last trained minibatch to the device-resident
+    // accumulators, allocating (or reallocating) an accumulator when it does not match the value's
+    // type or device. The additions happen on the compute device; no data is transferred to the CPU.
+    void Trainer::AccumulatePrevMinibatchMetrics()
+    {
+        auto accumulate = [](NDArrayViewPtr& accumulator, const NDArrayViewPtr& value)
+        {
+            if (value->Shape().TotalSize() != 1)
+                LogicError("Scalar Value object's has a size > 1");
+
+            if ((accumulator == nullptr) ||
+                (accumulator->GetDataType() != value->GetDataType()) ||
+                (accumulator->Device() != value->Device()) ||
+                (accumulator->Shape() != value->Shape()))
+            {
+                if (value->GetDataType() == DataType::Float)
+                    accumulator = MakeSharedObject<NDArrayView>(0.0f, value->Shape(), value->Device());
+                else if (value->GetDataType() == DataType::Double)
+                    accumulator = MakeSharedObject<NDArrayView>(0.0, value->Shape(), value->Device());
+                else
+                    LogicError("Unsupported DataType of training loss value");
+            }
+
+            using Microsoft::MSR::CNTK::Matrix;
+            if (value->GetDataType() == DataType::Float)
+                Matrix<float>::ScaleAndAdd(1.0f, *value->GetMatrix<float>(), *accumulator->GetWritableMatrix<float>());
+            else
+                Matrix<double>::ScaleAndAdd(1.0, *value->GetMatrix<double>(), *accumulator->GetWritableMatrix<double>());
+        };
+
+        accumulate(m_accumulatedTrainingLossValue, m_prevMinibatchAggregateTrainingLossValue->Data());
+        if (m_aggregatedEvaluationFunction)
+            accumulate(m_accumulatedEvalCriterionValue, m_prevMinibatchAggregateEvalCriterionValue->Data());
+
+        m_accumulatedNumSamples += m_prevMinibatchNumSamples;
+    }
+
     static size_t GetSampleCount(const Variable& var, const ValuePtr& value)
     {
         auto valueDataShape = value->Shape();
@@ -150,6 +202,7 @@ namespace CNTK
 
         std::unordered_map<Variable, ValuePtr> parameterGradients;
         ExecuteForwardBackward(arguments, outputsToFetch, computeDevice, parameterGradients);
+        AccumulatePrevMinibatchMetrics();
 
         std::unordered_map<Parameter, NDArrayViewPtr> gradients;
         for (const auto& parameter : m_combinedTrainingFunction->Parameters())
@@ -178,6 +231,7 @@ namespace CNTK
             // Get gradients after forward/backward pass.
             std::unordered_map<Variable, ValuePtr> parameterGradients;
             ExecuteForwardBackward(arguments, outputsToFetch, computeDevice, parameterGradients);
+            AccumulatePrevMinibatchMetrics();
             for (const auto& parameter : modelParameters)
                 gradients[parameter] = parameterGradients[parameter]->Data();
             trainingLoss = m_prevMinibatchAggregateTrainingLossValue->Data();
@@ -248,11 +302,302 @@ namespace CNTK
         return modelFilePath + checkpointExt;
     }
 
+    static std::wstring GetTrainerDeltaCheckpointFilePath(const std::wstring& modelFilePath)
+    {
+        return GetTrainerStateCheckpointFilePath(modelFilePath) + L".delta";
+    }
+
+    static void RemoveDeltaCheckpointFile(const std::wstring& modelFilePath)
+    {
+        auto deltaFilePath = GetTrainerDeltaCheckpointFilePath(modelFilePath);
+#ifdef _MSC_VER
+        _wremove(deltaFilePath.c_str());
+#else
+        std::remove(ToString(deltaFilePath).c_str());
+#endif
+    }
+
+    // On-disk layout of a delta checkpoint: the header below, 'm_numPayloads' quantized payload
+    // records (learner index, UTF8 key, data type, element count, inverse quantization scale,
+    // 16-bit quantized difference against the base snapshot), followed by a protobuf-serialized
+    // overlay Dictionary holding the non-array learner state entries and the external state.
+    struct DeltaCheckpointHeader
+    {
+        unsigned long long m_magic;
+        unsigned int m_version;
+        unsigned long long m_baseCheckpointId;
+        unsigned long long m_numPayloads;
+    };
+
+    static const unsigned long long deltaCheckpointMagic = 0x544C44564B544E43ULL; // "CNTKVDLT"
+    static const unsigned int deltaCheckpointVersion = 1;
+
+    // Symmetric 16-bit quantization of the difference between the current and base payloads.
+    // This is the scheme of SymmetricQuantizer (Math/Quantizers.h), whose scale is an internal
+    // detail and not recoverable at restore time; the inverse scale is therefore computed here
+    // and persisted next to the payload. Returns the inverse scale.
+    template <typename ElementType>
+    static double QuantizeDeltaPayload(const ElementType* current, const ElementType* base, size_t count, std::vector<short>& quantized)
+    {
+        quantized.resize(count);
+        double absoluteMax = 0;
+        for (size_t i = 0; i < count; ++i)
+            absoluteMax = std::max(absoluteMax, std::abs((double)current[i] - (double)base[i]));
+
+        if (absoluteMax == 0)
+        {
+            std::fill(quantized.begin(), quantized.end(), (short)0);
+            return 0;
+        }
+
+        double quantizeFactor = SHRT_MAX / absoluteMax;
+        for (size_t i = 0; i < count; ++i)
+            quantized[i] = (short)std::round(((double)current[i] - (double)base[i]) * quantizeFactor);
+
+        return 1 / quantizeFactor;
+    }
+
+    template <typename ElementType>
+    static void ApplyDeltaPayload(ElementType* value, const std::vector<short>& quantized, double inverseScale)
+    {
+        for (size_t i = 0; i < quantized.size(); ++i)
+            value[i] += (ElementType)(quantized[i] * inverseScale);
+    }
+
+    template <typename T>
+    static void WritePod(std::fstream& stream, const T& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static bool ReadPod(std::fstream& stream, T& value)
+    {
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return !stream.fail();
+    }
+
+    bool Trainer::SaveDeltaCheckpoint(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState)
+    {
+        if (learnerState.size() != m_fullCheckpointLearnerState.size())
+            return false;
+
+        struct Payload
+        {
+            unsigned int m_learnerIndex;
+            std::string m_key;
+            unsigned int m_dataType;
+            double m_inverseScale;
+            std::vector<short> m_quantized;
+        };
+
+        std::vector<Payload> payloads;
+        Dictionary overlay;
+        std::vector<DictionaryValue> scalarStates(learnerState.size());
+
+        for (size_t i = 0; i < learnerState.size(); ++i)
+        {
+            if ((learnerState[i].ValueType() != DictionaryValue::Type::Dictionary) ||
+                (m_fullCheckpointLearnerState[i].ValueType() != DictionaryValue::Type::Dictionary))
+                return false;
+
+            const auto& current = learnerState[i].Value<Dictionary>();
+            const auto& base = m_fullCheckpointLearnerState[i].Value<Dictionary>();
+
+            Dictionary scalars;
+            for (const auto& kv : current)
+            {
+                if (kv.second.ValueType() != DictionaryValue::Type::NDArrayView)
+                {
+                    // Scalar entries (version, sample counts, schedules) are small and change
+                    // every checkpoint; carry them in the overlay in full.
+                    scalars[kv.first] = kv.second;
+                    continue;
+                }
+
+                const auto& currentView = kv.second.Value<NDArrayView>();
+                if (!base.Contains(kv.first) ||
+                    (base[kv.first].ValueType() != DictionaryValue::Type::NDArrayView))
+                    return false;
+
+                const auto& baseView = base[kv.first].Value<NDArrayView>();
+                if ((baseView.GetDataType() != currentView.GetDataType()) ||
+                    (baseView.Shape() != currentView.Shape()) ||
+                    currentView.IsSparse() ||
+                    (currentView.Device() != DeviceDescriptor::CPUDevice()))
+                    return false;
+
+                auto count = currentView.Shape().TotalSize();
+                Payload payload;
+                payload.m_learnerIndex = (unsigned int)i;
+                payload.m_key = ToString(kv.first);
+                payload.m_dataType = (unsigned int)currentView.GetDataType();
+
+                if (currentView.GetDataType() == DataType::Float)
+                {
+                    auto currentBuffer = currentView.DataBuffer<float>();
+                    auto baseBuffer = baseView.DataBuffer<float>();
+                    if (memcmp(currentBuffer, baseBuffer, count * sizeof(float)) == 0)
+                        continue; // unchanged since the last full checkpoint
+                    payload.m_inverseScale = QuantizeDeltaPayload(currentBuffer, baseBuffer, count, payload.m_quantized);
+                }
+                else if (currentView.GetDataType() == DataType::Double)
+                {
+                    auto currentBuffer = currentView.DataBuffer<double>();
+                    auto baseBuffer = baseView.DataBuffer<double>();
+                    if (memcmp(currentBuffer, baseBuffer, count * sizeof(double)) == 0)
+                        continue;
+                    payload.m_inverseScale = QuantizeDeltaPayload(currentBuffer, baseBuffer, count, payload.m_quantized);
+                }
+                else
+                    return false;
+
+                payloads.push_back(std::move(payload));
+            }
+
+            scalarStates[i] = scalars;
+        }
+
+        overlay[learnersPropertyName] = scalarStates;
+        overlay[externalStatePropertyName] = externalState;
+
+        // The model itself is always saved in full; only the trainer state is incremental.
+        m_combinedTrainingFunction->SaveModel(modelFilePath);
+
+        auto deltaStream = GetFstream(GetTrainerDeltaCheckpointFilePath(modelFilePath), false);
+        DeltaCheckpointHeader header = { deltaCheckpointMagic, deltaCheckpointVersion, m_fullCheckpointId, payloads.size() };
+        WritePod(*deltaStream, header);
+        for (const auto& payload : payloads)
+        {
+            WritePod(*deltaStream, payload.m_learnerIndex);
+            WritePod(*deltaStream, (unsigned int)payload.m_key.size());
+            deltaStream->write(payload.m_key.data(), payload.m_key.size());
+            WritePod(*deltaStream, payload.m_dataType);
+            WritePod(*deltaStream, (unsigned long long)payload.m_quantized.size());
+            WritePod(*deltaStream, payload.m_inverseScale);
+            deltaStream->write(reinterpret_cast<const char*>(payload.m_quantized.data()), payload.m_quantized.size() * sizeof(short));
+        }
+
+        *deltaStream << overlay;
+        deltaStream->flush();
+        return true;
+    }
+
+    bool Trainer::TryApplyDeltaCheckpoint(const std::wstring& modelFilePath, std::vector<DictionaryValue>& learnerState, Dictionary& externalState, size_t baseCheckpointId)
+    {
+        auto deltaFilePath = GetTrainerDeltaCheckpointFilePath(modelFilePath);
+#ifdef _MSC_VER
+        FILE* exists = _wfopen(deltaFilePath.c_str(), L"rb");
+#else
+        FILE* exists = fopen(ToString(deltaFilePath).c_str(), "rb");
+#endif
+        if (exists == nullptr)
+            return false;
+        fclose(exists);
+
+        auto deltaStream = GetFstream(deltaFilePath, true);
+        DeltaCheckpointHeader header;
+        if (!ReadPod(*deltaStream, header) ||
+            (header.m_magic != deltaCheckpointMagic) ||
+            (header.m_version != deltaCheckpointVersion) ||
+            (header.m_baseCheckpointId != baseCheckpointId))
+        {
+            fprintf(stderr, "WARNING: ignoring delta checkpoint '%ls' that does not match the base checkpoint.\n", deltaFilePath.c_str());
+            return false;
+        }
+
+        for (unsigned long long p = 0; p < header.m_numPayloads; ++p)
+        {
+            unsigned int learnerIndex, keySize, dataType;
+            unsigned long long count;
+            double inverseScale;
+            if (!ReadPod(*deltaStream, learnerIndex) || !ReadPod(*deltaStream, keySize))
+                RuntimeError("Failed to read a payload record from the delta checkpoint '%ls'.", deltaFilePath.c_str());
+
+            std::string key(keySize, '\0');
+            deltaStream->read(&key[0], keySize);
+            if (!ReadPod(*deltaStream, dataType) || !ReadPod(*deltaStream, count) || !ReadPod(*deltaStream, inverseScale))
+                RuntimeError("Failed to read a payload record from the delta checkpoint '%ls'.", deltaFilePath.c_str());
+
+            std::vector<short> quantized(count);
+            deltaStream->read(reinterpret_cast<char*>(quantized.data()), count * sizeof(short));
+            if (deltaStream->fail())
+                RuntimeError("Failed to read a payload record from the delta checkpoint '%ls'.", deltaFilePath.c_str());
+
+            if ((learnerIndex >= learnerState.size()) ||
+                (learnerState[learnerIndex].ValueType() != DictionaryValue::Type::Dictionary))
+                RuntimeError("The delta checkpoint '%ls' does not match the structure of the base checkpoint.", deltaFilePath.c_str());
+
+            auto& learnerDict = learnerState[learnerIndex].Value<Dictionary>();
+            auto wkey = ToWString(key);
+            if (!learnerDict.Contains(wkey) ||
+                (learnerDict[wkey].ValueType() != DictionaryValue::Type::NDArrayView))
+                RuntimeError("The delta checkpoint '%ls' does not match the structure of the base checkpoint.", deltaFilePath.c_str());
+
+            auto& view = learnerDict[wkey].Value<NDArrayView>();
+            if (((unsigned int)view.GetDataType() != dataType) || (view.Shape().TotalSize() != count))
+                RuntimeError("The delta checkpoint '%ls' does not match the structure of the base checkpoint.", deltaFilePath.c_str());
+
+            if (view.GetDataType() == DataType::Float)
+                ApplyDeltaPayload(view.WritableDataBuffer<float>(), quantized, inverseScale);
+            else
+                ApplyDeltaPayload(view.WritableDataBuffer<double>(), quantized, inverseScale);
+        }
+
+        Dictionary overlay;
+        *deltaStream >> overlay;
+        auto scalarStates = overlay[learnersPropertyName].Value<std::vector<DictionaryValue>>();
+        if (scalarStates.size() != learnerState.size())
+            RuntimeError("The delta checkpoint '%ls' does not match the structure of the base checkpoint.", deltaFilePath.c_str());
+
+        for (size_t i = 0; i < scalarStates.size(); ++i)
+        {
+            auto& learnerDict = learnerState[i].Value<Dictionary>();
+            for (const auto& kv : scalarStates[i].Value<Dictionary>())
+                learnerDict[kv.first] = kv.second;
+        }
+
+        externalState = overlay[externalStatePropertyName].Value<Dictionary>();
+        return true;
+    }
+
+    void Trainer::SetFullCheckpointFrequency(size_t frequency)
+    {
+        if (frequency == 0)
+            InvalidArgument("Trainer::SetFullCheckpointFrequency: the frequency must be at least 1.");
+
+        m_fullCheckpointFrequency = frequency;
+    }
+
     void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, Dictionary externalState)
     {
         auto learnersState = m_parameterLearners->CreateCheckpoint();
         if (!m_distributed)
-            return Save(modelFilePath, learnersState, externalState);
+        {
+            // Incremental mode: between full checkpoints write compact deltas against the
+            // learner state snapshot of the last full checkpoint. Fall back to a full
+            // checkpoint whenever the state no longer lines up with that snapshot.
+            if ((m_fullCheckpointFrequency > 1) &&
+                !m_fullCheckpointLearnerState.empty() &&
+                (m_deltaCheckpointsSinceFullCheckpoint + 1 < m_fullCheckpointFrequency) &&
+                SaveDeltaCheckpoint(modelFilePath, learnersState, externalState))
+            {
+                m_deltaCheckpointsSinceFullCheckpoint++;
+                return;
+            }
+
+            Save(modelFilePath, learnersState, externalState);
+
+            if (m_fullCheckpointFrequency > 1)
+            {
+                m_fullCheckpointLearnerState = std::move(learnersState);
+                m_deltaCheckpointsSinceFullCheckpoint = 0;
+
+                // A leftover delta from the previous cycle must not be applied against the new snapshot.
+                RemoveDeltaCheckpointFile(modelFilePath);
+            }
+            return;
+        }
 
         // Collect distrbuted external state.
         DistributedCommunicatorPtr communicator = MPICommunicator();
@@ -277,9 +622,13 @@ namespace CNTK
 
     void Trainer::Save(const std::wstring& modelFilePath, const std::vector<DictionaryValue>& learnerState, const Dictionary& externalState)
     {
+        // A fresh identifier per full checkpoint ties any subsequent delta file to this snapshot.
+        m_fullCheckpointId = (size_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
         Dictionary state;
         state[learnersPropertyName] = learnerState;
         state[externalStatePropertyName] = externalState;
+        state[checkpointIdPropertyName] = m_fullCheckpointId;
 
         m_combinedTrainingFunction->SaveModel(modelFilePath);
         std::wstring trainerStateCheckpointFilePath = GetTrainerStateCheckpointFilePath(modelFilePath);
@@ -303,6 +652,17 @@ namespace CNTK
 
         if (!m_distributed)
         {
+            size_t checkpointId = checkpoint.Contains(checkpointIdPropertyName) ? checkpoint[checkpointIdPropertyName].Value<size_t>() : 0;
+            if ((m_fullCheckpointFrequency > 1) && (checkpointId != 0))
+            {
+                // The on-disk state is the snapshot future deltas diff against; capture it
+                // before overlaying a delta checkpoint that may have been written on top of it.
+                m_fullCheckpointLearnerState = learnerState;
+                m_fullCheckpointId = checkpointId;
+                m_deltaCheckpointsSinceFullCheckpoint =
+                    TryApplyDeltaCheckpoint(modelFilePath, learnerState, externalState, checkpointId) ? 1 : 0;
+            }
+
             m_parameterLearners->RestoreFromCheckpoint(learnerState);
             return externalState;
         }
@@ -332,6 +692,32 @@ namespace CNTK
         return (GetScalarValue(m_prevMinibatchAggregateEvalCriterionValue) / m_prevMinibatchNumSamples);
     }
 
+    double Trainer::AccumulatedLossAverage() const
+    {
+        if (m_accumulatedNumSamples == 0)
+            return 0.0;
+
+        return (GetScalarValue(m_accumulatedTrainingLossValue) / m_accumulatedNumSamples);
+    }
+
+    double Trainer::AccumulatedEvaluationAverage() const
+    {
+        if (!m_evaluationFunction)
+            InvalidArgument("Trainer::AccumulatedEvaluationAverage: Cannot get evaluation criterion value when no evaluation function was specified during 'this' trainer's construction");
+
+        if (m_accumulatedNumSamples == 0)
+            return 0.0;
+
+        return (GetScalarValue(m_accumulatedEvalCriterionValue) / m_accumulatedNumSamples);
+    }
+
+    void Trainer::ResetAccumulatedMetrics()
+    {
+        m_accumulatedNumSamples = 0;
+        m_accumulatedTrainingLossValue = nullptr;
+        m_accumulatedEvalCriterionValue = nullptr;
+    }
+
     const std::vector<LearnerPtr>& Trainer::ParameterLearners() const
     {
         return m_parameterLearners->ParameterLearners();
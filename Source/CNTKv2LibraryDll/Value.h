@@ -97,6 +97,33 @@ namespace CNTK
             return { m_packedData->GetMatrix<ElementType>(), m_packedDataLayout };
         }
 
+        // Rebinds a still-packed value to the current contents of the packed matrix and layout
+        // it was created over. The minibatch source uses this to recycle value objects across
+        // GetNextMinibatch calls: the matrix and layout objects of the reader are stable, only
+        // their contents and geometry change between minibatches, so with a constant minibatch
+        // size the rebind is allocation free. Returns false when the value has been unpacked
+        // by a consumer and can no longer be reused.
+        template <typename ElementType>
+        bool TryRebind(const std::shared_ptr<Microsoft::MSR::CNTK::Matrix<ElementType>>& packedDataMatrix, const std::shared_ptr<Microsoft::MSR::CNTK::MBLayout>& packedDataLayout)
+        {
+            if (!m_isPacked)
+                return false;
+
+            NDShape packedMatrixShape({ packedDataMatrix->GetNumRows(), packedDataMatrix->GetNumCols() });
+            if ((m_packedData == nullptr) || (m_packedData->Shape() != packedMatrixShape))
+            {
+                auto tensorView = new Microsoft::MSR::CNTK::TensorView<ElementType>(packedDataMatrix, AsTensorViewShape(packedMatrixShape));
+                m_packedData = MakeSharedObject<NDArrayView>(AsDataType<ElementType>(), AsDeviceDescriptor(packedDataMatrix->GetDeviceId()), AsStorageFormat(packedDataMatrix->GetFormat()), packedMatrixShape, m_isReadOnly, tensorView);
+            }
+
+            m_packedDataLayout = packedDataLayout;
+            m_unpackedShape = m_sampleShape;
+            if (packedDataLayout)
+                m_unpackedShape = m_unpackedShape.AppendShape({ packedDataLayout->GetNumTimeSteps(), packedDataLayout->GetNumSequences() });
+
+            return true;
+        }
+
     private:
         PackedValue(const NDShape& sampleShape, const NDArrayViewPtr& packedData, const std::shared_ptr<Microsoft::MSR::CNTK::MBLayout>& packedDataLayout, bool isReadOnly)
             : Value(nullptr), m_isPacked(true), m_sampleShape(sampleShape), m_packedData(packedData), m_packedDataLayout(packedDataLayout), m_isReadOnly(isReadOnly)
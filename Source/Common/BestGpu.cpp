@@ -47,7 +47,9 @@ int bestGPUDummy = 42; // put something into this CPP, as to avoid a linker warn
 #include <algorithm>
 
 #include <memory>
+#include <time.h>
 #include "CrossProcessMutex.h"
+#include "MPIWrapper.h"
 
 // ---------------------------------------------------------------------------
 // BestGpu class
@@ -85,6 +87,7 @@ class BestGpu
 private:
     bool m_initialized;       // initialized
     bool m_nvmlData;          // nvml Data is valid
+    bool m_nvmlInitialized;   // nvmlInit() succeeded in this process (false if data came from the per-host cache)
     bool m_cudaData;          // cuda Data is valid
     int m_deviceCount;        // how many devices are available?
     int m_queryCount;         // how many times have we queried the usage counters?
@@ -96,10 +99,12 @@ private:
     void GetCudaProperties();
     void GetNvmlData();
     void QueryNvmlData();
+    bool TryReadNvmlProbeCache();
+    void WriteNvmlProbeCache() const;
 
 public:
     BestGpu()
-        : m_initialized(false), m_nvmlData(false), m_cudaData(false), m_deviceCount(0), m_queryCount(0), m_lastFlags(bestGpuNormal), m_lastCount(0), m_allowedDevices(-1), m_disallowCPUDevice(false)
+        : m_initialized(false), m_nvmlData(false), m_nvmlInitialized(false), m_cudaData(false), m_deviceCount(0), m_queryCount(0), m_lastFlags(bestGpuNormal), m_lastCount(0), m_allowedDevices(-1), m_disallowCPUDevice(false)
     {
         Init();
     }
@@ -173,6 +178,56 @@ DEVICEID_TYPE GetBestDevice()
      return SelectDevice(DEVICEID_AUTO, true, intargvector());
 }
 
+// determine this process' rank among the ranks running on this host
+// Launcher-provided environment variables are checked first, since they are set before (and
+// without) MPI initialization; as a last resort the global MPI rank is used, which still yields
+// a deterministic spread when every host runs the same number of ranks.
+static int GetMpiLocalRank()
+{
+    for (const char* name : {"OMPI_COMM_WORLD_LOCAL_RANK", "MV2_COMM_WORLD_LOCAL_RANK", "SLURM_LOCALID", "PMI_LOCAL_RANK", "MPI_LOCALRANKID"})
+    {
+        const char* val = getenv(name);
+        if (val != nullptr && *val != 0)
+            return atoi(val);
+    }
+    const auto& mpi = MPIWrapper::GetInstance();
+    if (mpi != nullptr)
+        return (int) mpi->CurrentNodeRank();
+    return 0;
+}
+
+// deviceId=rank: deterministic rank-based assignment, local MPI rank r gets the r-th GPU in
+// PCIe bus order. This never touches NVML and does no utilization scoring: when a job runs one
+// rank per GPU, contention-free startup matters more than picking the idlest device, and bus
+// order is stable across CUDA enumeration orders and matches the NUMA topology that launchers
+// place ranks by.
+static DEVICEID_TYPE SelectDeviceByMpiRank(const intargvector& excludedDevices)
+{
+    int deviceCount = 0;
+    if (cudaGetDeviceCount(&deviceCount) != cudaSuccess || deviceCount == 0)
+        return CPUDEVICE;
+    std::vector<std::pair<int, int>> busOrder; // (PCIe location key, cuda device id)
+    for (int i = 0; i < deviceCount; i++)
+    {
+        bool excluded = false;
+        for (int j = 0; j < excludedDevices.size(); j++)
+            excluded = excluded || (excludedDevices[j] == i);
+        if (excluded)
+            continue;
+        cudaDeviceProp prop;
+        if (cudaGetDeviceProperties(&prop, i) != cudaSuccess || prop.major < BestGpu::MininumCCMajorForGpu)
+            continue;
+        busOrder.push_back(std::make_pair((prop.pciDomainID << 16) | (prop.pciBusID << 8) | prop.pciDeviceID, i));
+    }
+    if (busOrder.empty())
+        return CPUDEVICE;
+    std::sort(busOrder.begin(), busOrder.end());
+    int localRank = GetMpiLocalRank();
+    auto deviceId = (DEVICEID_TYPE) busOrder[localRank % busOrder.size()].second;
+    fprintf(stderr, "SelectDeviceByMpiRank: local rank %d -> GPU %d (of %d eligible, in PCIe bus order)\n", localRank, (int) deviceId, (int) busOrder.size());
+    return deviceId;
+}
+
 void OnDeviceSelected(DEVICEID_TYPE deviceId)
 {
     if (s_bestDeviceId != DEVICEID_NOTYETDETERMINED && s_bestDeviceId != deviceId && s_bestDeviceId >= 0)
@@ -205,8 +260,10 @@ DEVICEID_TYPE DeviceFromConfig(const ScriptableObjects::IConfigRecord& config)
             return SelectDevice(CPUDEVICE, false, excludedDevices);
         else if (val == L"auto")
             return SelectDevice(DEVICEID_AUTO, bLockGPU, excludedDevices);
+        else if (val == L"rank")
+            return SelectDevice(SelectDeviceByMpiRank(excludedDevices), bLockGPU, excludedDevices);
         else
-            InvalidArgument("Invalid value '%ls' for deviceId parameter. Allowed are 'auto' and 'cpu' (case-sensitive).", val.c_str());
+            InvalidArgument("Invalid value '%ls' for deviceId parameter. Allowed are 'auto', 'cpu' and 'rank' (case-sensitive).", val.c_str());
     }
     else
         return SelectDevice(valp, bLockGPU, excludedDevices);
@@ -223,6 +280,7 @@ DEVICEID_TYPE DeviceFromConfig(const ConfigParameters& config)
 
     if (EqualCI(val, "cpu"))  return SelectDevice(CPUDEVICE, false, excludedDevices);
     else if (EqualCI(val, "auto")) return SelectDevice(DEVICEID_AUTO, bLockGPU, excludedDevices);
+    else if (EqualCI(val, "rank")) return SelectDevice(SelectDeviceByMpiRank(excludedDevices), bLockGPU, excludedDevices);
     else                           return SelectDevice((int)val, bLockGPU, excludedDevices);
 }
 
@@ -329,7 +387,7 @@ BestGpu::~BestGpu()
     }
     m_procData.clear();
 
-    if (m_nvmlData)
+    if (m_nvmlInitialized)
     {
         nvmlReturn_t r = nvmlShutdown();
         if ((r != NVML_SUCCESS) && !std::uncaught_exception())
@@ -339,6 +397,90 @@ BestGpu::~BestGpu()
     }
 }
 
+// ---------------------------------------------------------------------------
+// per-host NVML probe cache
+// When many ranks start on one box at once, their concurrent NVML probes contend inside the
+// driver (tens of seconds for 8 ranks). The probe is therefore serialized across processes
+// with a CrossProcessMutex, and its result is published to a small per-host file; ranks
+// starting within the freshness window read that file instead of probing at all, so only the
+// first rank of a concurrent job start pays for the probe.
+// ---------------------------------------------------------------------------
+
+static const long long nvmlProbeCacheFreshnessSeconds = 30;
+
+static std::string NvmlProbeCachePath()
+{
+#ifdef _WIN32
+    const char* dir = getenv("TEMP");
+    if (dir == nullptr || *dir == 0)
+        dir = ".";
+    return std::string(dir) + "\\cntk_bestgpu_probe.cache";
+#else
+    const char* dir = getenv("TMPDIR");
+    if (dir == nullptr || *dir == 0)
+        dir = "/tmp";
+    return std::string(dir) + "/cntk_bestgpu_probe.cache";
+#endif
+}
+
+// read the per-host probe cache; returns false (leaving all data untouched) if it is missing,
+// stale, or does not match this process' view of the devices
+bool BestGpu::TryReadNvmlProbeCache()
+{
+    FILE* f = fopen(NvmlProbeCachePath().c_str(), "r");
+    if (f == nullptr)
+        return false;
+    long long timestamp = 0;
+    int deviceCount = 0;
+    bool ok = fscanf(f, "cntkbestgpu1 %lld %d", &timestamp, &deviceCount) == 2 &&
+              deviceCount == m_deviceCount &&
+              (long long) time(NULL) - timestamp <= nvmlProbeCacheFreshnessSeconds;
+    for (int i = 0; ok && i < deviceCount; i++)
+    {
+        int busId, cntkFound;
+        unsigned long long memTotal, memFree;
+        unsigned int utilGpu, utilMem;
+        ok = fscanf(f, "%d %llu %llu %u %u %d", &busId, &memTotal, &memFree, &utilGpu, &utilMem, &cntkFound) == 6;
+        if (!ok)
+            break;
+        ProcessorData* curPd = NULL;
+        for (ProcessorData* pd : m_procData)
+            if (pd->deviceProp.pciBusID == busId)
+            {
+                curPd = pd;
+                break;
+            }
+        if (curPd == NULL) // device set changed since the cache was written
+        {
+            ok = false;
+            break;
+        }
+        curPd->memory.total = memTotal;
+        curPd->memory.free = memFree;
+        curPd->memory.used = memTotal - memFree;
+        curPd->utilization.gpu = utilGpu;
+        curPd->utilization.memory = utilMem;
+        curPd->cntkFound = cntkFound != 0;
+    }
+    fclose(f);
+    return ok;
+}
+
+// publish this process' probe results for other ranks starting on this host
+// Failures are ignored; the cache is purely an optimization.
+void BestGpu::WriteNvmlProbeCache() const
+{
+    FILE* f = fopen(NvmlProbeCachePath().c_str(), "w");
+    if (f == nullptr)
+        return;
+    fprintf(f, "cntkbestgpu1 %lld %d\n", (long long) time(NULL), m_deviceCount);
+    for (ProcessorData* pd : m_procData)
+        fprintf(f, "%d %llu %llu %u %u %d\n", pd->deviceProp.pciBusID,
+                (unsigned long long) pd->memory.total, (unsigned long long) pd->memory.free,
+                (unsigned) pd->utilization.gpu, (unsigned) pd->utilization.memory, pd->cntkFound ? 1 : 0);
+    fclose(f);
+}
+
 // GetNvmlData - Get data from the Nvidia Management Library
 void BestGpu::GetNvmlData()
 {
@@ -346,14 +488,28 @@ void BestGpu::GetNvmlData()
     if (m_nvmlData || !m_cudaData)
         return;
 
+    // serialize the probe across the ranks of this host, and share its result (see above)
+    CrossProcessMutex probeLock("CNTK BestGpu NVML probe lock");
+    if (!probeLock.Acquire(/*wait=*/true)) // failure  --this should not really happen
+        RuntimeError("GetNvmlData: Unexpected failure acquiring the NVML probe lock.");
+
+    if (TryReadNvmlProbeCache())
+    {
+        m_nvmlData = true; // (m_nvmlInitialized stays false: nothing to shut down, requeries are no-ops)
+        return;            // (mutex released by its destructor)
+    }
+
     // First initialize NVML library
     nvmlReturn_t result = nvmlInit();
     if (NVML_SUCCESS != result)
     {
         return;
     }
+    m_nvmlInitialized = true;
 
     QueryNvmlData();
+    if (m_nvmlData)
+        WriteNvmlProbeCache();
 }
 
 // GetDevice - Determine the best device ID to use
@@ -631,7 +787,9 @@ std::vector<ProcessorData*> BestGpu::GetProcessorData()
 // In case failure, this function simply backs out without filling in the data structure and without setting m_nvmlData.
 void BestGpu::QueryNvmlData()
 {
-    if (!m_cudaData)
+    // requeries need a live NVML session; when the data came from the per-host probe cache
+    // (m_nvmlInitialized is false), we keep the cached counters instead
+    if (!m_cudaData || (m_nvmlData && !m_nvmlInitialized))
         return;
 
     for (int i = 0; i < m_deviceCount; i++)
@@ -7,6 +7,7 @@
 #include "stdafx.h"
 #include "ExceptionWithCallStack.h"
 #include "Basics.h"
+#include "AsyncLogging.h"
 #ifdef _WIN32
 #pragma warning(push)
 #pragma warning(disable: 4091) // 'typedef ': ignored on left of '' when no variable is declared
@@ -47,6 +48,8 @@ string ExceptionWithCallStack<E>::GetCallStack(size_t skipLevels /*= 0*/, bool m
 template <class E>
 void ExceptionWithCallStack<E>::PrintCallStack(size_t skipLevels /*= 0*/, bool makeFunctionNamesStandOut /*= false*/)
 {
+    // push out any asynchronously queued log lines first, so the log up to the failure is complete
+    AsyncLogWriter::FlushSync();
     CollectCallStack(skipLevels + 1/*skip this function*/, makeFunctionNamesStandOut, [](string stack)
     {
         cerr << stack;
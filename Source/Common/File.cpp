@@ -21,9 +21,17 @@
 #include <Shlwapi.h>
 #pragma comment(lib, "Shlwapi.lib")
 #endif
+#ifdef _WIN32
+#include <io.h>    // for _pipe(), _get_osfhandle()
+#include <fcntl.h> // for _O_BINARY
+#endif
 #ifdef __unix__
 #include <unistd.h>
 #include <linux/limits.h> // for PATH_MAX
+#include <fcntl.h>        // for F_SETPIPE_SZ
+#include <sys/ioctl.h>    // for FIONREAD
+#include <sys/mman.h>     // for mmap()/madvise()
+#include <sys/stat.h>     // for fstat()
 #endif
 
 #define PCLOSE_ERROR -1
@@ -80,11 +88,31 @@ template<class String>
 //template /*static*/ void File::MakeIntermediateDirs<string> (const string&  filename); // implement this if needed
 template /*static*/ void File::MakeIntermediateDirs<wstring>(const wstring& filename);
 
+// number of bytes currently buffered in a pipe, or -1 on error
+static int PipeBytesAvailable(int fd)
+{
+#ifdef _WIN32
+    DWORD avail = 0;
+    if (!PeekNamedPipe((HANDLE)_get_osfhandle(fd), NULL, 0, NULL, &avail, NULL))
+        return -1;
+    return (int)avail;
+#else
+    int avail = 0;
+    if (ioctl(fd, FIONREAD, &avail) != 0)
+        return -1;
+    return avail;
+#endif
+}
+
 // all constructors call this
 void File::Init(const wchar_t* filename, int fileOptions)
 {
     m_filename = filename;
     m_options = fileOptions;
+    m_targetFile = nullptr;
+    m_pipeReadFd = -1;
+    m_writerFailed = false;
+    m_writerShutdown = false;
     if (m_filename.empty())
         RuntimeError("File: filename is empty");
     const auto outputPipe = (m_filename.front() == '|');
@@ -145,6 +173,119 @@ void File::Init(const wchar_t* filename, int fileOptions)
                     m_file = fopenOrDie(filename, options.c_str());
                     m_seekable = true;
                 });
+
+    if (fileOptions & fileOptionsUncached)
+    {
+        if (m_seekable) // a hint only; meaningless for pipes and std handles
+            fsetuncached(m_file);
+    }
+
+    if (fileOptions & fileOptionsAsyncWrite)
+    {
+        if (!writing || reading || !m_seekable)
+            RuntimeError("File: fileOptionsAsyncWrite requires a regular file opened for writing only");
+        StartAsyncWriter();
+    }
+}
+
+// redirect m_file into a staging pipe drained by a background thread into the actual output file
+void File::StartAsyncWriter()
+{
+    m_targetFile = m_file;
+
+    int fds[2];
+#ifdef _WIN32
+    if (_pipe(fds, WRITE_BUFFER_SIZE, _O_BINARY) != 0)
+        RuntimeError("File: cannot create the write-behind pipe for %S: %s", m_filename.c_str(), strerror(errno));
+#else
+    if (pipe(fds) != 0)
+        RuntimeError("File: cannot create the write-behind pipe for %S: %s", m_filename.c_str(), strerror(errno));
+#ifdef F_SETPIPE_SZ
+    fcntl(fds[1], F_SETPIPE_SZ, WRITE_BUFFER_SIZE); // enlarge from the 64k default; best effort
+#endif
+#endif
+    m_pipeReadFd = fds[0];
+
+#ifdef _WIN32
+    m_file = _fdopen(fds[1], "wb");
+#else
+    m_file = fdopen(fds[1], "wb");
+#endif
+    if (m_file == nullptr)
+        RuntimeError("File: cannot open the write-behind pipe for %S: %s", m_filename.c_str(), strerror(errno));
+
+    // the pipe is not seekable, so neither is this File anymore
+    m_seekable = false;
+
+    // give the output file a staging buffer of its own, so that the small reads coming
+    // out of the pipe are coalesced into large writes
+    setvbuf(m_targetFile, NULL, _IOFBF, WRITE_BUFFER_SIZE);
+
+    m_writerThread = std::thread([this]() { WriteBehindThread(); });
+}
+
+// the background thread: drains the staging pipe into the output file
+void File::WriteBehindThread()
+{
+    std::vector<char> buffer(WRITE_BUFFER_SIZE);
+    for (;;)
+    {
+        {
+            // drain everything currently in the pipe; Flush() synchronizes on this mutex
+            // to determine that the output file has fully caught up
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            int avail;
+            while ((avail = PipeBytesAvailable(m_pipeReadFd)) > 0)
+            {
+                size_t toRead = std::min((size_t)avail, buffer.size());
+#ifdef _WIN32
+                int n = _read(m_pipeReadFd, buffer.data(), (unsigned int)toRead);
+#else
+                ssize_t n = read(m_pipeReadFd, buffer.data(), toRead);
+#endif
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                {
+                    m_writerFailed = true;
+                    break;
+                }
+
+                // on a write error keep draining the pipe (and dropping the data), so that
+                // the producer does not block forever on a full pipe; the error is raised
+                // on Flush() or destruction
+                if (!m_writerFailed && fwrite(buffer.data(), 1, (size_t)n, m_targetFile) != (size_t)n)
+                    m_writerFailed = true;
+            }
+        }
+
+        if (m_writerShutdown && PipeBytesAvailable(m_pipeReadFd) <= 0)
+            break;
+
+        // pipe is empty, wait for more data
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// flush the staging pipe and wait until the writer thread has committed everything to the output file
+void File::StopAsyncWriter()
+{
+    // push all user-side buffered data into the pipe and close the write end
+    fflush(m_file);
+    m_writerShutdown = true;
+    fclose(m_file);
+    m_writerThread.join();
+
+#ifdef _WIN32
+    _close(m_pipeReadFd);
+#else
+    close(m_pipeReadFd);
+#endif
+    m_pipeReadFd = -1;
+
+    // from here on the File behaves like a plain file again (destructor closes it)
+    m_file = m_targetFile;
+    m_targetFile = nullptr;
 }
 
 // determine the directory for a given pathname
@@ -258,6 +399,9 @@ bool File::IsTextBased()
 // Note: this does not check for errors when the File corresponds to pipe stream. In this case, use Flush() before closing a file you are writing.
 File::~File(void)
 {
+    if (m_writerThread.joinable())
+        StopAsyncWriter();
+
     int rc = 0;
     if (m_pcloseNeeded)
     {
@@ -275,10 +419,46 @@ File::~File(void)
             RuntimeError("File: failed to close file at %S", m_filename.c_str());
         }
     }
+
+    if (m_writerFailed && !std::uncaught_exception())
+    {
+        RuntimeError("File: the write-behind thread failed writing to %S", m_filename.c_str());
+    }
 }
 
 void File::Flush()
 {
+    if (m_targetFile != nullptr)
+    {
+        // write-behind mode: push everything into the staging pipe, wait until the writer
+        // thread has drained it, then flush (and optionally fsync) the output file
+        fflushOrDie(m_file);
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_writerMutex);
+                if (m_writerFailed)
+                    RuntimeError("File: the write-behind thread failed writing to %S", m_filename.c_str());
+                if (PipeBytesAvailable(m_pipeReadFd) == 0)
+                {
+                    // the writer commits everything it drains before releasing the mutex,
+                    // so an empty pipe means the output file has fully caught up
+                    fflushOrDie(m_targetFile);
+                    if (m_options & fileOptionsSyncOnFlush)
+                    {
+#ifdef _WIN32
+                        _commit(_fileno(m_targetFile));
+#else
+                        fsync(fileno(m_targetFile));
+#endif
+                    }
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
     fflushOrDie(m_file);
 }
 
@@ -657,6 +837,11 @@ int File::Setvbuf()
     return setvbuf(this->m_file, NULL, _IOFBF, WRITE_BUFFER_SIZE);
 }
 
+int File::Setvbuf(size_t bufferSize)
+{
+    return setvbuf(this->m_file, NULL, _IOFBF, bufferSize);
+}
+
 // Get a marker from the file
 // some are ignored others are expecting characters
 // must use GetMarker methods for those that require parameters
@@ -963,4 +1148,106 @@ template vector<double> File::LoadMatrixFromTextFile<double>(const std::wstring&
 template vector<float>  File::LoadMatrixFromStringLiteral<float> (const std::string& literal, size_t& /*out*/ numRows, size_t& /*out*/ numCols);
 template vector<double> File::LoadMatrixFromStringLiteral<double>(const std::string& literal, size_t& /*out*/ numRows, size_t& /*out*/ numCols);
 
+// ===========================================================================
+// MappedFile -- read-only memory-mapped view of a file
+// ===========================================================================
+
+MappedFile::MappedFile(const std::wstring& filename)
+    : m_filename(filename), m_view(nullptr), m_size(0)
+{
+#ifdef _WIN32
+    m_mapping = NULL;
+    m_hndl = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_hndl == INVALID_HANDLE_VALUE)
+        RuntimeError("MappedFile: cannot open file %S", filename.c_str());
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_hndl, &size))
+    {
+        CloseHandle(m_hndl);
+        RuntimeError("MappedFile: cannot determine the size of file %S", filename.c_str());
+    }
+    m_size = (size_t) size.QuadPart;
+    if (m_size > 0) // (CreateFileMapping cannot map empty files; an empty mapping just has no view)
+    {
+        m_mapping = CreateFileMapping(m_hndl, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping == NULL)
+        {
+            CloseHandle(m_hndl);
+            RuntimeError("MappedFile: cannot create a file mapping for %S", filename.c_str());
+        }
+        m_view = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (m_view == NULL)
+        {
+            CloseHandle(m_mapping);
+            CloseHandle(m_hndl);
+            RuntimeError("MappedFile: cannot map a view of file %S", filename.c_str());
+        }
+    }
+#else
+    const auto fn = msra::strfun::utf8(filename);
+    m_fd = open(fn.c_str(), O_RDONLY);
+    if (m_fd < 0)
+        RuntimeError("MappedFile: cannot open file %S: %s", filename.c_str(), strerror(errno));
+    struct stat st;
+    if (fstat(m_fd, &st) != 0)
+    {
+        close(m_fd);
+        RuntimeError("MappedFile: cannot determine the size of file %S: %s", filename.c_str(), strerror(errno));
+    }
+    m_size = (size_t) st.st_size;
+    if (m_size > 0) // (mapping zero bytes is undefined; an empty mapping just has no view)
+    {
+        m_view = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (m_view == MAP_FAILED)
+        {
+            m_view = nullptr;
+            close(m_fd);
+            RuntimeError("MappedFile: cannot map file %S: %s", filename.c_str(), strerror(errno));
+        }
+    }
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (m_view != nullptr)
+        UnmapViewOfFile(m_view);
+    if (m_mapping != NULL)
+        CloseHandle(m_mapping);
+    if (m_hndl != INVALID_HANDLE_VALUE)
+        CloseHandle(m_hndl);
+#else
+    if (m_view != nullptr)
+        munmap(m_view, m_size);
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+void MappedFile::Advise(Advice advice, size_t offset, size_t size) const
+{
+    if (m_view == nullptr || offset >= m_size)
+        return;
+    if (size == SIZE_MAX || size > m_size - offset)
+        size = m_size - offset;
+#ifdef __unix__
+    int adv;
+    switch (advice)
+    {
+    case Advice::Sequential: adv = MADV_SEQUENTIAL; break;
+    case Advice::Random:     adv = MADV_RANDOM;     break;
+    case Advice::WillNeed:   adv = MADV_WILLNEED;   break;
+    default:                 adv = MADV_NORMAL;     break;
+    }
+    // madvise() requires a page-aligned start address; round the range outward
+    const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t beg = offset & ~(pageSize - 1);
+    madvise((char*) m_view + beg, (offset - beg) + size, adv); // advisory only; failures are ignored
+#else
+    // Windows exposes no per-view paging advice pre-Win8; treat as a no-op
+    advice; offset; size;
+#endif
+}
+
 }}}
@@ -16,5 +16,13 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     std::atomic<bool> Globals::m_enableShareNodeValueMatrices(true);
     std::atomic<bool> Globals::m_enableHyperCompressMemory(false);
     std::atomic<bool> Globals::m_optimizeGradientAccumulation(true);
+    std::atomic<bool> Globals::m_enableStreamParallelForward(false);
+    std::atomic<bool> Globals::m_enableParallelCpuForward(false);
+    std::atomic<bool> Globals::m_useAtomicTensorReduction(false);
+    std::atomic<bool> Globals::m_enableNodeFusion(false);
+    std::atomic<bool> Globals::m_enableLazyParameterLoad(false);
+    std::atomic<bool> Globals::m_optimizeForInference(false);
+    std::atomic<bool> Globals::m_recomputeActivations(false);
+    std::atomic<bool> Globals::m_enableNodeProfiling(false);
 
 }}}
@@ -0,0 +1,201 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#pragma once
+
+#include "Basics.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <memory>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// ---------------------------------------------------------------------------
+// AsyncLogWriter -- static helper class that moves log I/O off the calling thread
+//
+// On jobs whose stdout/stderr are redirected to a network file system, every
+// flushed log line costs the training thread a round trip (~ms). When enabled
+// with CNTK_ASYNC_LOGGING=1, messages and flush requests are pushed onto a
+// bounded lock-free queue (a fixed ring of sequence-numbered cells) and a
+// writer thread performs the actual fprintf/fflush calls. Disabled (the
+// default), every call degenerates to the direct synchronous call it replaces.
+//
+// Ordering is preserved only among messages that go through this class; raw
+// fprintf calls to the same stream may overtake queued ones. Callers therefore
+// route self-contained lines here (e.g. the PROGRESS/EVALERR lines of
+// ProgressTracing), or only the trailing flush of a line that was composed
+// with raw fprintf calls (e.g. the per-minibatch log in SGD).
+//
+// When the queue is full the producer waits for the writer to free a cell:
+// bypassing the queue would reorder the log, and dropping would lose messages;
+// a burst of >1024 undrained lines is the rare case where logging may still
+// briefly block. FlushSync() is the escape hatch for crash paths: it drains the
+// queue and flushes both standard streams before e.g. a call stack is printed.
+// ---------------------------------------------------------------------------
+
+/*static*/ class AsyncLogWriter
+{
+    // one entry of the bounded queue; an empty text means "fflush(stream)"
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        FILE* stream;
+        std::string text;
+    };
+
+    static const size_t capacity = 1024; // power of two; ~a few seconds of verbose logging
+
+    bool m_enabled;
+    std::unique_ptr<Cell[]> m_cells;
+    std::atomic<size_t> m_enqueuePos;
+    std::atomic<size_t> m_dequeuePos;
+    std::atomic<bool> m_shutdown;
+    std::thread m_writer;
+
+    AsyncLogWriter()
+        : m_enqueuePos(0), m_dequeuePos(0), m_shutdown(false)
+    {
+        const char* p = std::getenv("CNTK_ASYNC_LOGGING");
+        m_enabled = p && (std::string(p) == "1");
+        if (!m_enabled)
+            return;
+        m_cells.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; i++)
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        m_writer = std::thread([this] { WriterLoop(); });
+    }
+
+    ~AsyncLogWriter()
+    {
+        if (!m_enabled)
+            return;
+        m_shutdown = true;
+        m_writer.join();
+        DrainOnce(); // whatever arrived after the writer checked last
+    }
+
+    static AsyncLogWriter& GetStaticInstance()
+    {
+        static AsyncLogWriter us;
+        return us;
+    } // wrap static state in an accessor, so we won't need a CPP file
+
+    // multi-producer enqueue; returns false when the queue is full
+    bool TryEnqueue(FILE* stream, std::string&& text)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_cells[pos & (capacity - 1)];
+            intptr_t diff = (intptr_t) cell.sequence.load(std::memory_order_acquire) - (intptr_t) pos;
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.stream = stream;
+                    cell.text = std::move(text);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) // the cell still holds an entry from one lap ago: full
+                return false;
+            else
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // single-consumer dequeue-and-write; returns false when the queue is empty
+    bool DequeueAndWrite()
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & (capacity - 1)];
+        if ((intptr_t) cell.sequence.load(std::memory_order_acquire) - (intptr_t) (pos + 1) < 0)
+            return false;
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        WriteCell(cell);
+        cell.text = std::string(); // give memory back while the cell sits idle
+        cell.sequence.store(pos + capacity, std::memory_order_release);
+        return true;
+    }
+
+    static void WriteCell(const Cell& cell)
+    {
+        if (cell.text.empty())
+            fflush(cell.stream);
+        else
+            fwrite(cell.text.data(), 1, cell.text.size(), cell.stream);
+    }
+
+    void WriterLoop()
+    {
+        while (!m_shutdown)
+        {
+            if (!DequeueAndWrite())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1)); // idle; latency is irrelevant for logs
+        }
+    }
+
+    void DrainOnce()
+    {
+        while (DequeueAndWrite())
+            ;
+    }
+
+public:
+    static bool IsEnabled()
+    {
+        return GetStaticInstance().m_enabled;
+    }
+
+    // write a self-contained message (typically one full line) to the stream
+    static void Write(FILE* stream, std::string&& text)
+    {
+        auto& us = GetStaticInstance();
+        if (!us.m_enabled)
+        {
+            fwrite(text.data(), 1, text.size(), stream);
+            return;
+        }
+        // 'text' is untouched whenever TryEnqueue() returns false
+        while (!us.TryEnqueue(stream, std::move(text)))
+            std::this_thread::yield(); // full: wait for the writer rather than overtaking queued lines
+    }
+
+    // request an fflush of the stream, without waiting for it
+    static void RequestFlush(FILE* stream)
+    {
+        auto& us = GetStaticInstance();
+        if (!us.m_enabled)
+        {
+            fflush(stream);
+            return;
+        }
+        while (!us.TryEnqueue(stream, std::string()))
+            std::this_thread::yield();
+    }
+
+    // Synchronously push out everything: wait (bounded) for the writer to catch up, then flush
+    // the standard streams. For crash paths, so buffered lines land before the failure report;
+    // must stay safe to call from any state, including when logging was never enabled.
+    static void FlushSync()
+    {
+        auto& us = GetStaticInstance();
+        if (us.m_enabled)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (us.m_dequeuePos.load(std::memory_order_relaxed) != us.m_enqueuePos.load(std::memory_order_relaxed) &&
+                   std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        }
+        fflush(stdout);
+        fflush(stderr);
+    }
+};
+
+}}}
@@ -5,47 +5,76 @@
 
 #pragma once
 
-#include <stack>
+#include "Platform.h" // for THREAD_LOCAL
+#include <atomic>
 #include <functional>
-#include <mutex>
+#include <cstdint>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 // -----------------------------------------------------------------------
 // conc_stack -- very simple version of thread-safe stack. Add other functions as needed.
 // Kept in a separate header because it pulls in some large headers that are not super-commonly needed otherwise.
+//
+// This is lock-free. The original version guarded a std::stack with a mutex, which shows
+// real contention when many eval threads recycle temp objects through one instance. Items
+// now live in two tiers:
+//  - a fixed array of per-thread slots: each thread hashes to a home slot and claims or
+//    releases an item with a single atomic exchange, so the common pop/push alternation of
+//    temp reuse never touches state shared with other threads;
+//  - a Treiber stack as overflow tier for whatever does not fit a slot. Its head packs a
+//    16-bit modification counter into the unused upper bits of the x64 node pointer, which
+//    makes the pop CAS immune to ABA when nodes are recycled through the internal free list.
+// Nodes are only ever freed in the destructor, so a concurrent pop may safely dereference a
+// node another thread just recycled; the counter ensures its CAS then fails.
 // -----------------------------------------------------------------------
 
 template <typename T>
 class conc_stack
 {
 public:
-    typedef typename std::stack<T>::value_type value_type;
+    typedef T value_type;
 
     conc_stack()
+        : m_head(0), m_free(0)
     {
+        for (size_t i = 0; i < numSlots; i++)
+            m_slots[i].n.store(nullptr);
+    }
+
+    ~conc_stack()
+    {
+        for (size_t i = 0; i < numSlots; i++)
+            delete m_slots[i].n.load();
+        FreeChain(m_head.load());
+        FreeChain(m_free.load());
     }
 
     value_type pop_or_create(std::function<value_type()> factory)
     {
-        std::lock_guard<std::mutex> g(m_locker);
-        if (m_stack.size() == 0)
-            return factory();
-        auto res = std::move(m_stack.top());
-        m_stack.pop();
-        return res;
+        // fast path: this thread's home slot, then a neighbor
+        const size_t h = ThreadSlot();
+        for (size_t i = 0; i < slotProbes; i++)
+        {
+            node* n = m_slots[(h + i) % numSlots].n.exchange(nullptr);
+            if (n != nullptr)
+                return TakeItem(n);
+        }
+        // overflow tier
+        node* n = PopNode(m_head);
+        if (n != nullptr)
+            return TakeItem(n);
+        return factory();
     }
 
     void push(const value_type& item)
     {
-        std::lock_guard<std::mutex> g(m_locker);
-        m_stack.push(item);
+        StoreNode(MakeNode(value_type(item)));
     }
 
     void push(value_type&& item)
     {
-        std::lock_guard<std::mutex> g(m_locker);
-        m_stack.push(std::forward<value_type>(item));
+        StoreNode(MakeNode(std::move(item)));
     }
 
 public:
@@ -55,7 +84,108 @@ public:
     conc_stack& operator=(conc_stack&&) = delete;
 
 private:
-    std::stack<value_type> m_stack;
-    std::mutex m_locker;
+    struct node
+    {
+        value_type item;
+        std::atomic<node*> next; // atomic: a racing pop may read this on a node that was just recycled
+        node() : item(), next(nullptr) { }
+    };
+
+    static const size_t numSlots = 64;  // per-thread slots (threads hash into these)
+    static const size_t slotProbes = 2; // home slot plus neighbors probed before the overflow tier
+
+    // one slot per cache line, so threads working their home slots do not false-share
+    struct slot
+    {
+        std::atomic<node*> n;
+        char pad[64 - sizeof(std::atomic<node*>)];
+    };
+
+    // index of this thread's home slot; assigned on first use (the counter starts threads
+    // on distinct slots; unrelated threads may still collide, which is correct, just slower)
+    static size_t ThreadSlot()
+    {
+        THREAD_LOCAL static unsigned t_slotIndex; // 0 = not yet assigned (zero-initialized, so no dynamic TLS construction)
+        if (t_slotIndex == 0)
+            t_slotIndex = (s_nextThreadSlot++ % numSlots) + 1;
+        return t_slotIndex - 1;
+    }
+
+    // --- tagged-pointer helpers for the Treiber stacks
+    static node* Ptr(uint64_t head) { return (node*) (head & 0x0000ffffffffffffULL); }
+    static uint64_t Tag(uint64_t head) { return head >> 48; }
+    static uint64_t Tagged(node* p, uint64_t tag) { return ((uint64_t) p & 0x0000ffffffffffffULL) | (tag << 48); }
+
+    static void PushNode(std::atomic<uint64_t>& top, node* n)
+    {
+        uint64_t old = top.load();
+        do
+        {
+            n->next.store(Ptr(old), std::memory_order_relaxed);
+        } while (!top.compare_exchange_weak(old, Tagged(n, Tag(old) + 1)));
+    }
+
+    static node* PopNode(std::atomic<uint64_t>& top)
+    {
+        uint64_t old = top.load();
+        for (;;)
+        {
+            node* n = Ptr(old);
+            if (n == nullptr)
+                return nullptr;
+            if (top.compare_exchange_weak(old, Tagged(n->next.load(std::memory_order_relaxed), Tag(old) + 1)))
+                return n;
+        }
+    }
+
+    // move the item out of a node and park the node on the free list
+    value_type TakeItem(node* n)
+    {
+        value_type res = std::move(n->item);
+        n->item = value_type(); // release whatever the moved-from item may still hold
+        PushNode(m_free, n);
+        return res;
+    }
+
+    node* MakeNode(value_type&& item)
+    {
+        node* n = PopNode(m_free);
+        if (n == nullptr)
+            n = new node();
+        n->item = std::move(item);
+        return n;
+    }
+
+    // store a filled node: preferably in a per-thread slot, else on the overflow stack
+    void StoreNode(node* n)
+    {
+        const size_t h = ThreadSlot();
+        for (size_t i = 0; i < slotProbes; i++)
+        {
+            node* expected = nullptr;
+            if (m_slots[(h + i) % numSlots].n.compare_exchange_strong(expected, n))
+                return;
+        }
+        PushNode(m_head, n);
+    }
+
+    static void FreeChain(uint64_t head)
+    {
+        for (node* n = Ptr(head); n != nullptr;)
+        {
+            node* next = n->next.load();
+            delete n;
+            n = next;
+        }
+    }
+
+    slot m_slots[numSlots];
+    std::atomic<uint64_t> m_head; // tagged head of the overflow stack
+    std::atomic<uint64_t> m_free; // tagged head of the recycled-node list
+    static std::atomic<unsigned> s_nextThreadSlot;
 };
+
+template <typename T>
+std::atomic<unsigned> conc_stack<T>::s_nextThreadSlot(0);
+
 } } }
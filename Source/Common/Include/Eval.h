@@ -26,6 +26,14 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <deque>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -352,9 +360,29 @@ public:
 
     //
     // Same as above, and
-    // resetRNN - flags whether to reset memory cells of RNN. 
+    // resetRNN - flags whether to reset memory cells of RNN.
     //
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) = 0;
+
+    //
+    // ForwardPassBatched - evaluate several independent single-sample requests as one batch.
+    // Each entry of inputBatch/outputBatch is one caller's request, with the same per-request
+    // buffer layout as ForwardPass(). The requests are packed as parallel sequences of a single
+    // minibatch, evaluated with one forward pass, and the results scattered back per request.
+    // Restrictions: inputs must be dense and exactly one sample per request, and every output
+    // must produce one column per sample.
+    //
+    virtual void ForwardPassBatched(const std::vector<const Values<ElemType>*>& inputBatch,
+                                    const std::vector<Values<ElemType>*>& outputBatch) = 0;
+
+    //
+    // CreateSharedSession - create an additional evaluation instance sharing this model's weights.
+    // The new instance duplicates the network structure but aliases the (immutable) parameter
+    // values, so concurrent scoring threads pay only for their activation buffers instead of a
+    // full copy of the model. Call StartForwardEvaluation() on the new instance before its first
+    // ForwardPass(); each instance may be used by one thread at a time. Release with Destroy().
+    //
+    virtual IEvaluateModelExtended<ElemType>* CreateSharedSession() = 0;
 };
 
 template <typename ElemType>
@@ -362,4 +390,191 @@ void EVAL_API GetEvalExtended(IEvaluateModelExtended<ElemType>** peval);
 extern "C" EVAL_API void GetEvalExtendedF(IEvaluateModelExtended<float>** peval);
 extern "C" EVAL_API void GetEvalExtendedD(IEvaluateModelExtended<double>** peval);
 
+//
+// EvalSessionPool - fixed-size pool of evaluation sessions sharing one set of immutable weights.
+//
+// Construction takes a fully loaded primary instance, clones it via CreateSharedSession(), and
+// prepares every session for the given outputs, so N concurrent scoring threads keep a single
+// copy of the model parameters and own only their activation buffers.
+// AcquireSession()/ReleaseSession() dispatch requests to free sessions with one atomic operation
+// per call and no locks; AcquireSession() yields while all sessions are busy.
+// The pool owns the sessions it created; the primary instance remains owned by the caller.
+//
+template <typename ElemType>
+class EvalSessionPool
+{
+public:
+    EvalSessionPool(IEvaluateModelExtended<ElemType>* primary, size_t numSessions, const std::vector<std::wstring>& outputs) :
+        m_busy(new std::atomic<bool>[numSessions])
+    {
+        if (numSessions == 0)
+            throw std::runtime_error("EvalSessionPool: numSessions must be at least 1.");
+        m_sessions.push_back(primary);
+        for (size_t i = 1; i < numSessions; i++)
+            m_sessions.push_back(primary->CreateSharedSession());
+        for (size_t i = 0; i < numSessions; i++)
+        {
+            m_sessions[i]->StartForwardEvaluation(outputs);
+            m_busy[i] = false;
+        }
+    }
+
+    ~EvalSessionPool()
+    {
+        for (size_t i = 1; i < m_sessions.size(); i++) // [0] is the caller-owned primary
+            m_sessions[i]->Destroy();
+    }
+
+    // borrow a free session; spins (with yield) when all sessions are in flight
+    IEvaluateModelExtended<ElemType>* AcquireSession()
+    {
+        for (;;)
+        {
+            for (size_t i = 0; i < m_sessions.size(); i++)
+                if (!m_busy[i].exchange(true, std::memory_order_acquire))
+                    return m_sessions[i];
+            std::this_thread::yield();
+        }
+    }
+
+    // return a session previously obtained from AcquireSession()
+    void ReleaseSession(IEvaluateModelExtended<ElemType>* session)
+    {
+        for (size_t i = 0; i < m_sessions.size(); i++)
+        {
+            if (m_sessions[i] == session)
+            {
+                m_busy[i].store(false, std::memory_order_release);
+                return;
+            }
+        }
+        throw std::runtime_error("ReleaseSession: session does not belong to this pool.");
+    }
+
+    size_t Size() const { return m_sessions.size(); }
+
+private:
+    EvalSessionPool(const EvalSessionPool&) = delete;
+    EvalSessionPool& operator=(const EvalSessionPool&) = delete;
+
+    std::vector<IEvaluateModelExtended<ElemType>*> m_sessions;
+    std::unique_ptr<std::atomic<bool>[]> m_busy; // [i] session i is currently in flight
+};
+
+//
+// EvalBatchAggregator - bounded-latency request combiner for single-sample scoring.
+//
+// Serving tiers often receive independent single-sample requests; scoring them one at a time
+// leaves most of the device idle. Request threads call Evaluate(), which parks the request in a
+// queue; a worker thread coalesces everything that arrives within the latency budget (or until
+// maxBatchSize requests are pending) into one ForwardPassBatched() call and scatters the
+// per-request results back before waking the callers.
+//
+template <typename ElemType>
+class EvalBatchAggregator
+{
+public:
+    EvalBatchAggregator(IEvaluateModelExtended<ElemType>* eval, size_t maxBatchSize = 32, size_t maxLatencyMs = 2) :
+        m_eval(eval),
+        m_maxBatchSize(maxBatchSize == 0 ? 1 : maxBatchSize),
+        m_maxLatency(maxLatencyMs),
+        m_shutdown(false)
+    {
+        m_worker = std::thread([this] { WorkerLoop(); });
+    }
+
+    ~EvalBatchAggregator()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_pending.notify_all();
+        m_worker.join();
+    }
+
+    // score one request; blocks until its results are available
+    // Buffer layout and restrictions are those of ForwardPassBatched(). Evaluation errors are
+    // rethrown on the calling thread.
+    void Evaluate(const Values<ElemType>& inputs, Values<ElemType>& outputs)
+    {
+        Request request{&inputs, &outputs, std::promise<void>()};
+        auto done = request.m_done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(&request);
+        }
+        m_pending.notify_one();
+        done.get();
+    }
+
+private:
+    struct Request
+    {
+        const Values<ElemType>* m_inputs;
+        Values<ElemType>* m_outputs;
+        std::promise<void> m_done;
+    };
+
+    void WorkerLoop()
+    {
+        std::vector<Request*> batch;
+        std::vector<const Values<ElemType>*> inputBatch;
+        std::vector<Values<ElemType>*> outputBatch;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_pending.wait(lock, [this] { return m_shutdown || !m_queue.empty(); });
+                if (m_shutdown && m_queue.empty())
+                    return;
+
+                // bounded-latency combining: once the first request is in, wait out the latency
+                // budget (or until the batch is full) before scoring
+                auto deadline = std::chrono::steady_clock::now() + m_maxLatency;
+                while (m_queue.size() < m_maxBatchSize && !m_shutdown)
+                {
+                    if (m_pending.wait_until(lock, deadline) == std::cv_status::timeout)
+                        break;
+                }
+
+                size_t count = m_queue.size() < m_maxBatchSize ? m_queue.size() : m_maxBatchSize;
+                batch.assign(m_queue.begin(), m_queue.begin() + count);
+                m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+            }
+
+            inputBatch.clear();
+            outputBatch.clear();
+            for (const auto& request : batch)
+            {
+                inputBatch.push_back(request->m_inputs);
+                outputBatch.push_back(request->m_outputs);
+            }
+            try
+            {
+                m_eval->ForwardPassBatched(inputBatch, outputBatch);
+                for (const auto& request : batch)
+                    request->m_done.set_value();
+            }
+            catch (...)
+            {
+                for (const auto& request : batch)
+                    request->m_done.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    EvalBatchAggregator(const EvalBatchAggregator&) = delete;
+    EvalBatchAggregator& operator=(const EvalBatchAggregator&) = delete;
+
+    IEvaluateModelExtended<ElemType>* m_eval;
+    size_t m_maxBatchSize;
+    std::chrono::milliseconds m_maxLatency;
+    bool m_shutdown;                   // protected by m_mutex
+    std::deque<Request*> m_queue;      // protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_pending;
+    std::thread m_worker;
+};
+
 } } }
@@ -19,6 +19,10 @@
 #include "fileutil.h" // for f{ge,pu}t{,Text}()
 #include <fstream>    // for LoadMatrixFromTextFile() --TODO: change to using this File class
 #include <sstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -34,6 +38,9 @@ enum FileOptions
     fileOptionsRead = 8,                                        // open in read mode
     fileOptionsWrite = 16,                                      // open in write mode
     fileOptionsSequential = 32,                                 // optimize for sequential reads (allocates big buffer)
+    fileOptionsAsyncWrite = 64,                                 // write-behind: writes are staged and flushed to disk by a background thread
+    fileOptionsSyncOnFlush = 128,                               // fsync the file as part of Flush() (only meaningful with fileOptionsAsyncWrite)
+    fileOptionsUncached = 256,                                  // one-pass streaming: hint the OS not to retain this file's pages in the page cache
     fileOptionsReadWrite = fileOptionsRead | fileOptionsWrite,  // read/write mode
 };
 
@@ -91,6 +98,80 @@ static void attempt(const FUNCTION& body)
     // msra::util::attempt<FUNCTION> (retries, body);
 }
 
+// ---------------------------------------------------------------------------
+// MappedFile -- read-only memory-mapped view of a file
+//
+// For bulk payloads of hundreds of MB (model files, reader index files), the
+// stream-style File accessors pay a library call and a buffer copy per read.
+// A mapping hands the caller the kernel's page cache directly: one view for
+// the whole file, typed access through AsSpan<T>(), and Advise() to steer the
+// paging pattern (madvise on POSIX; a no-op on Windows, which has no
+// equivalent short of Win8-only PrefetchVirtualMemory).
+// Obtain instances via File::Map().
+// ---------------------------------------------------------------------------
+class MappedFile
+{
+public:
+    // lightweight typed read-only view into the mapping
+    template <typename T>
+    struct Span
+    {
+        const T* data;
+        size_t size; // in elements
+        const T* begin() const { return data; }
+        const T* end() const { return data + size; }
+        const T& operator[](size_t i) const { return data[i]; }
+    };
+
+    // the access pattern the kernel should optimize the mapping for
+    enum class Advice
+    {
+        Normal,     // default readahead
+        Sequential, // aggressive readahead; pages may be dropped after use
+        Random,     // disable readahead
+        WillNeed    // start paging in the range now, ahead of first touch
+    };
+
+    MappedFile(const std::wstring& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* Data() const { return (const char*) m_view; }
+    size_t Size() const { return m_size; } // in bytes
+
+    // typed view over the byte range [offset, offset + count * sizeof(T))
+    // count = SIZE_MAX means "as many whole elements as fit until the end of the file"
+    template <typename T>
+    Span<T> AsSpan(size_t offset = 0, size_t count = SIZE_MAX) const
+    {
+        if (offset > m_size)
+            RuntimeError("MappedFile: span offset %d exceeds the size of file %S", (int) offset, Filename().c_str());
+        if (count == SIZE_MAX)
+            count = (m_size - offset) / sizeof(T);
+        else if (count * sizeof(T) > m_size - offset)
+            RuntimeError("MappedFile: typed span of %d elements exceeds the size of file %S", (int) count, Filename().c_str());
+        return Span<T>{(const T*) (Data() + offset), count};
+    }
+
+    // advise the kernel on the paging pattern for a byte range (whole file by default)
+    // This is a hint; failures are ignored.
+    void Advise(Advice advice, size_t offset = 0, size_t size = SIZE_MAX) const;
+
+    const std::wstring& Filename() const { return m_filename; }
+
+private:
+    std::wstring m_filename;
+    void* m_view;
+    size_t m_size;
+#ifdef _WIN32
+    HANDLE m_hndl;
+    HANDLE m_mapping;
+#else
+    int m_fd;
+#endif
+};
+
 class File
 {
 private:
@@ -101,6 +182,21 @@ private:
     int m_options;       // FileOptions ored togther
     void Init(const wchar_t* filename, int fileOptions);
 
+    // Write-behind state (fileOptionsAsyncWrite). User-visible writes go through m_file,
+    // which is redirected into a pipe; a background thread drains the pipe into the actual
+    // output file (m_targetFile) with large buffered writes, so that the many small writes
+    // of e.g. n-best output do not pay per-write I/O latency.
+    FILE* m_targetFile;  // the actual output file, written only by the writer thread
+    int m_pipeReadFd;    // read end of the staging pipe
+    std::thread m_writerThread;
+    std::mutex m_writerMutex; // serializes pipe draining with Flush() and shutdown
+    std::atomic<bool> m_writerFailed;
+    std::atomic<bool> m_writerShutdown;
+
+    void StartAsyncWriter();
+    void StopAsyncWriter();
+    void WriteBehindThread();
+
 public:
     File(const std::wstring& filename, int fileOptions);
     File(const std::string&  filename, int fileOptions);
@@ -110,6 +206,7 @@ public:
     void Flush();
 
     bool CanSeek() const { return m_seekable; }
+    const std::wstring& Filename() const { return m_filename; }
     size_t Size();
     uint64_t GetPosition();
     void SetPosition(uint64_t pos);
@@ -122,6 +219,7 @@ public:
     bool IsWhiteSpace(bool skip = false);
     int EndOfLineOrEOF(bool skip = false);
     int Setvbuf();
+    int Setvbuf(size_t bufferSize); // resize the stdio buffer; call before the first read/write (multi-MB pays off for sequential scans)
 
     // TryGetText - for text value, try and get a particular type
     // returns - true if value returned, otherwise false, can't parse
@@ -152,6 +250,12 @@ public:
     // get path of current executable
     static std::wstring GetExecutablePath();
 
+    // map a whole file read-only; see MappedFile above
+    static std::shared_ptr<MappedFile> Map(const std::wstring& filename)
+    {
+        return std::make_shared<MappedFile>(filename);
+    }
+
     // put operator for basic types
     template <typename T>
     File& operator<<(T val)
@@ -195,6 +299,36 @@ public:
         return *this;
     }
 
+    // put/get for contiguous arrays of basic types
+    // In binary mode these are single bulk transfers; the on-disk layout is identical to
+    // writing the elements one by one, but streaming large matrices element-wise costs a
+    // library call per element and dominates model load/save time.
+    template <typename T>
+    File& PutArray(const T* data, size_t count)
+    {
+        if (IsTextBased())
+        {
+            for (size_t i = 0; i < count; i++)
+                *this << data[i];
+        }
+        else
+            fwriteOrDie(data, sizeof(T), count, m_file);
+        return *this;
+    }
+
+    template <typename T>
+    File& GetArray(T* data, size_t count)
+    {
+        if (IsTextBased())
+        {
+            for (size_t i = 0; i < count; i++)
+                *this >> data[i];
+        }
+        else
+            freadOrDie(data, sizeof(T), count, m_file);
+        return *this;
+    }
+
     void WriteString(const char* str, int size = 0);                   // zero terminated strings use size=0
     void ReadString(char* str, int size);                              // read up to size bytes, or a zero terminator (or space in text mode)
     void WriteString(const wchar_t* str, int size = 0);                // zero terminated strings use size=0
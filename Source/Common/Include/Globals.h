@@ -31,6 +31,62 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static void SetHyperCompressMemory(bool enable) { m_enableHyperCompressMemory = enable; }
         static bool ShouldEnableHyperCompressMemory() { return m_enableHyperCompressMemory; }
 
+        // Stream-parallel forward: runs data-independent top-level subgraphs on separate GPU
+        // streams. Requires shareNodeValueMatrices to be disabled as the memory sharing liveness
+        // analysis assumes strictly sequential execution.
+        static void SetStreamParallelForward(bool enable) { m_enableStreamParallelForward = enable; }
+        static bool ShouldEnableStreamParallelForward() { return m_enableStreamParallelForward; }
+
+        // Node fusion: lets network compilation fuse chains of a binary elementwise op feeding a
+        // unary nonlinearity (e.g. Plus >> Sigmoid) into single nodes, eliminating the inner
+        // node's activation buffer. Fused nodes implement forward only, so this must stay off
+        // for training; enable it per-run on serving/eval hosts.
+        static void SetNodeFusion(bool enable) { m_enableNodeFusion = enable; }
+        static bool ShouldEnableNodeFusion() { return m_enableNodeFusion; }
+
+        // Task-parallel CPU forward: runs independent top-level branches of the eval order on
+        // worker threads during CPU-only execution. Requires shareNodeValueMatrices to be
+        // disabled, for the same reason as stream-parallel forward above.
+        static void SetParallelCpuForward(bool enable) { m_enableParallelCpuForward = enable; }
+        static bool ShouldEnableParallelCpuForward() { return m_enableParallelCpuForward; }
+
+        // Lazy parameter load: when loading a model, LearnableParameter values are not read
+        // eagerly; instead their file location is recorded and the payload is materialized on
+        // first ForwardProp touch (see LearnableParameter::EnsureValueIsLoaded()). Intended for
+        // evaluation hosts that keep many model variants resident but evaluate few of them.
+        static void SetLazyParameterLoad(bool enable) { m_enableLazyParameterLoad = enable; }
+        static bool ShouldLazyLoadParameters() { return m_enableLazyParameterLoad; }
+
+        // Inference-only compilation: when a network is compiled without a training root, nodes
+        // whose values are induced solely by parameters also stay sharable, so their activations
+        // participate in MatrixPool reuse like everything else. Their buffers may then be
+        // overwritten between passes, so ForwardProp() re-marks them outdated before every
+        // evaluation (recompute traded for resident memory); keep this off for training runs.
+        static void SetOptimizeForInference(bool enable) { m_optimizeForInference = enable; }
+        static bool ShouldOptimizeForInference() { return m_optimizeForInference; }
+
+        // Activation recomputation (gradient checkpointing): in training, the values of nodes
+        // between checkpoint nodes are released after the forward pass and recomputed segment by
+        // segment during backprop (see ComputationNetwork::AllocateAllMatrices()), trading about
+        // one extra forward pass of compute for most of the activation memory. Only effective
+        // when shareNodeValueMatrices is enabled.
+        static void SetActivationRecomputation(bool enable) { m_recomputeActivations = enable; }
+        static bool ShouldRecomputeActivations() { return m_recomputeActivations; }
+
+        // Atomic tensor reduction: lets large GPU tensor reductions combine partial sums with
+        // atomicAdd() instead of the deterministic two-pass tree reduction, saving the temp
+        // buffer and second kernel at the cost of run-to-run bit reproducibility.
+        // Ignored (tree reduction stays in effect) when forceDeterministicAlgorithms is set.
+        static void SetAtomicTensorReduction(bool enable) { m_useAtomicTensorReduction = enable; }
+        static bool ShouldUseAtomicTensorReduction() { return m_useAtomicTensorReduction && !m_forceDeterministicAlgorithms; }
+
+        // Per-node profiling: the flow-control nodes accumulate cumulative forward/backward wall
+        // time, invocation counts, and peak value/gradient matrix sizes on every ComputationNode;
+        // report with ComputationNetwork::DumpProfile(). On GPU devices the times are host-side
+        // dispatch times unless the performance profiler's syncGpu mode keeps the device drained.
+        static void SetNodeProfiling(bool enable) { m_enableNodeProfiling = enable; }
+        static bool ShouldEnableNodeProfiling() { return m_enableNodeProfiling; }
+
     private:
         static std::atomic<bool> m_forceDeterministicAlgorithms;
         // The global flag to enable matrices values in forward and backward prop
@@ -39,5 +95,21 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static std::atomic<bool> m_enableHyperCompressMemory;
         static std::atomic<bool> m_forceConstantRandomSeed;
         static std::atomic<bool> m_optimizeGradientAccumulation;
+        // The global flag to run independent forward subgraphs on separate GPU streams
+        static std::atomic<bool> m_enableStreamParallelForward;
+        // The global flag to run independent forward subgraphs on CPU worker threads
+        static std::atomic<bool> m_enableParallelCpuForward;
+        // The global flag to allow atomicAdd-based (non-deterministic) GPU tensor reductions
+        static std::atomic<bool> m_useAtomicTensorReduction;
+        // The global flag to enable operator fusion during network compilation
+        static std::atomic<bool> m_enableNodeFusion;
+        // The global flag to defer reading of LearnableParameter values until first use
+        static std::atomic<bool> m_enableLazyParameterLoad;
+        // The global flag to keep parameter-induced node values sharable in inference-only networks
+        static std::atomic<bool> m_optimizeForInference;
+        // The global flag to release and recompute inter-checkpoint activations during training
+        static std::atomic<bool> m_recomputeActivations;
+        // The global flag to accumulate per-node time and memory statistics during evaluation
+        static std::atomic<bool> m_enableNodeProfiling;
     };
 }}}
@@ -20,11 +20,22 @@
 #endif
 #pragma comment(lib, "msmpi.lib")
 
-#include <errno.h> 
+#if defined(OPEN_MPI)
+// for MPIX_Query_cuda_support(), used to detect CUDA-aware (GPUDirect) builds at runtime
+#include "mpi-ext.h"
+#endif
+
+#include <errno.h>
 #include <string>
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 #include "CommonMatrix.h"
 
@@ -78,10 +89,21 @@ class MPIWrapper : public std::enable_shared_from_this<MPIWrapper>
     int m_numMPINodes;
     size_t m_numNodesInUse;
     bool m_multiHost;
+    bool m_gpuAware;
 
     // MPI communicator that reflects the current subset selection
     MPI_Comm m_currentComm;
 
+    // async-progress engine state (see the "async progress" section below)
+public:
+    struct AsyncOperation;
+private:
+    bool m_asyncProgressRequested; // CNTK_MPI_PROGRESS_THREAD=1 and MPI_THREAD_MULTIPLE granted
+    std::atomic<AsyncOperation*> m_asyncNewOps; // lock-free submission stack, drained by the progress thread
+    std::atomic<bool> m_asyncShutdown;
+    std::once_flag m_asyncThreadStarted; // the thread is only spawned once something is tracked
+    std::thread m_asyncProgressThread;
+
     static MPIWrapperPtr s_mpi;
 
     // MPI_Init() with delay-loading the msmpi.dll (possibly causing a failure if missing; we want to catch that)
@@ -95,15 +117,38 @@ class MPIWrapper : public std::enable_shared_from_this<MPIWrapper>
             int flag = 0;
             MPI_Initialized(&flag);
             if (flag)
+            {
+                // somebody else initialized MPI; the progress thread needs MPI_THREAD_MULTIPLE,
+                // so check whether we actually got it
+                if (m_asyncProgressRequested)
+                {
+                    int level = MPI_THREAD_SINGLE;
+                    MPI_Query_thread(&level);
+                    if (level < MPI_THREAD_MULTIPLE)
+                    {
+                        fprintf(stderr, "mpihelper: MPI was initialized without MPI_THREAD_MULTIPLE; disabling the MPI progress thread\n");
+                        m_asyncProgressRequested = false;
+                    }
+                }
                 return MPI_SUCCESS;
+            }
 
             int argc = 0;
             char **argv = NULL;
             // TODO(qiwye) Multiverso(parameter server) will benefit from MPI_THREAD_MULTIPLE .
-            int requiredThreadLevelSupport = MPI_THREAD_SERIALIZED;
+            // The async-progress thread polls MPI_Test concurrently with collectives posted on
+            // the compute thread, which requires MPI_THREAD_MULTIPLE; everything else runs
+            // collectives on a single thread at a time and is fine with MPI_THREAD_SERIALIZED.
+            int requiredThreadLevelSupport = m_asyncProgressRequested ? MPI_THREAD_MULTIPLE : MPI_THREAD_SERIALIZED;
             int provided;
             int ret = MPI_Init_thread(&argc, &argv, requiredThreadLevelSupport, &provided);
-            if (provided != requiredThreadLevelSupport)
+            if (m_asyncProgressRequested && provided < MPI_THREAD_MULTIPLE)
+            {
+                // not fatal: fall back to the usual wait-in-main-thread completion
+                fprintf(stderr, "mpihelper: MPI_THREAD_MULTIPLE not available; disabling the MPI progress thread\n");
+                m_asyncProgressRequested = false;
+            }
+            if (provided < MPI_THREAD_SERIALIZED)
                 LogicError("Failed to initialize MPI with the desired level of thread support");
 
             return ret;
@@ -130,9 +175,34 @@ class MPIWrapper : public std::enable_shared_from_this<MPIWrapper>
         Sleep(s_myRank * 50);
     }
 
+    // Detect whether the MPI library can take GPU device pointers directly (CUDA-aware MPI,
+    // e.g. Open MPI built with GPUDirect support); callers may then skip the page-locked host
+    // staging copy. Only Open MPI exposes a runtime query; other libraries conservatively
+    // report false. Set CNTK_CUDA_AWARE_MPI=0 to force the staging path even on a CUDA-aware
+    // build (e.g. when the fabric itself is not GPUDirect-capable).
+    static bool DetectGpuAwareSupport()
+    {
+        const char* p = std::getenv("CNTK_CUDA_AWARE_MPI");
+        if (p && (string(p) == "0"))
+            return false;
+#if defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT
+        return MPIX_Query_cuda_support() != 0;
+#else
+        return false;
+#endif
+    }
+
+    // Whether the user asked for the dedicated MPI progress thread (CNTK_MPI_PROGRESS_THREAD=1).
+    // Off by default: it costs a (mostly sleeping) core and requires MPI_THREAD_MULTIPLE.
+    static bool AsyncProgressRequestedByEnv()
+    {
+        const char* p = std::getenv("CNTK_MPI_PROGRESS_THREAD");
+        return p && (string(p) == "1");
+    }
+
 public:
     MPIWrapper()
-        : m_currentComm(MPI_COMM_WORLD)
+        : m_currentComm(MPI_COMM_WORLD), m_asyncProgressRequested(AsyncProgressRequestedByEnv()), m_asyncNewOps(nullptr), m_asyncShutdown(false)
     {
         static bool initialized = false;
         if (initialized)
@@ -154,6 +224,13 @@ public:
         m_numNodesInUse = m_numMPINodes;
         m_multiHost = true;
 
+        m_gpuAware = DetectGpuAwareSupport();
+        if (m_gpuAware && (GetMathLibTraceLevel() > 0))
+        {
+            fprintf(stderr, "MPIWrapper: CUDA-aware MPI detected, GPU buffers will be passed to MPI directly\n");
+            fflush(stderr);
+        }
+
         // Verify that the environment variable used by GetTotalNumberOfMPINodes()  
         // matches what the MPI API says. There're actually two possible cases:
         // 1) when we're running with mpiexec both values have to match;
@@ -222,6 +299,14 @@ public:
             fprintf(stderr, "~MPIWrapper\n");
         }
 
+        // stop the progress thread before MPI_Finalize; any well-behaved caller has already
+        // waited for its tracked operations at this point
+        if (m_asyncProgressThread.joinable())
+        {
+            m_asyncShutdown = true;
+            m_asyncProgressThread.join();
+        }
+
         // Do not finalize in event of an exception since calling MPI_Finalize without
         // all pending communications being finished results in a hang
         int rc = fflush(stderr);
@@ -402,6 +487,117 @@ public:
         return m_multiHost;
     }
 
+    // true if gradients residing on a GPU device can be passed to MPI calls directly
+    // (CUDA-aware MPI), without staging through page-locked host buffers
+    bool IsGpuAware() const
+    {
+        return m_gpuAware;
+    }
+
+    // -----------------------------------------------------------------------
+    // communication timeline / imbalance detection
+    // -----------------------------------------------------------------------
+
+    // Turns on per-collective timing in AllReduce/Bcast. Each collective is then preceded
+    // by a timed barrier, splitting the measured time into wait (how long this rank sat in
+    // the barrier for the others, i.e. arrival skew) and transfer (the collective proper).
+    // Every 'reportInterval' collectives the per-rank wait totals are allgathered and the
+    // main rank prints a report naming the slowest rank with the lag distribution.
+    // Off by default: the extra barrier serializes arrival and adds a small latency, so
+    // this is a diagnosis mode, not an always-on counter. Must be enabled with the same
+    // parameters on all ranks, since the piggybacked allgather is itself a collective.
+    void EnableCommTiming(size_t reportInterval)
+    {
+        m_commTimingEnabled = reportInterval > 0;
+        m_commReportInterval = reportInterval;
+    }
+
+    // Registers a hook that is invoked (on every rank, after the periodic exchange) when
+    // the average per-collective arrival skew exceeds thresholdSeconds. SGD uses this to
+    // put a straggler warning into the training log next to the epoch it affected.
+    void SetImbalanceHook(double thresholdSeconds, std::function<void(int slowestRank, double skewSeconds)> hook)
+    {
+        m_skewThreshold = thresholdSeconds;
+        m_imbalanceHook = hook;
+    }
+
+    // Results of the last periodic exchange: the rank the others waited on most, and the
+    // average per-collective arrival skew (slowest minus fastest arrival) in seconds.
+    int GetLastSlowestRank() const
+    {
+        return m_lastSlowestRank;
+    }
+    double GetLastArrivalSkew() const
+    {
+        return m_lastSkew;
+    }
+
+private:
+    // Times the pre-collective barrier; returns this rank's wait in seconds.
+    // The rank that arrives last waits the least - over an interval, the rank with the
+    // smallest accumulated wait is the straggler everyone else is waiting on.
+    double TimedArrivalBarrier() const
+    {
+        auto start = std::chrono::steady_clock::now();
+        MPI_Barrier(m_currentComm) || MpiFail("TimedArrivalBarrier: MPI_Barrier");
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Accumulates one timed collective and periodically exchanges + reports the skew.
+    void FinishTimedCollective(double waitSeconds, double transferSeconds) const
+    {
+        m_intervalWaitSeconds += waitSeconds;
+        m_intervalTransferSeconds += transferSeconds;
+        if (++m_intervalCollectiveCount < m_commReportInterval)
+            return;
+
+        // Piggyback the per-rank wait totals on one small allgather. All ranks run the same
+        // sequence of timed collectives, so they reach this exchange in lockstep.
+        std::vector<double> waitPerRank(NumNodesInUse());
+        double myWait = m_intervalWaitSeconds;
+        MPI_Allgather(&myWait, 1, MPI_DOUBLE, waitPerRank.data(), 1, MPI_DOUBLE, m_currentComm) ||
+            MpiFail("FinishTimedCollective: MPI_Allgather");
+
+        auto minmax = std::minmax_element(waitPerRank.begin(), waitPerRank.end());
+        m_lastSlowestRank = (int)(minmax.first - waitPerRank.begin());
+        m_lastSkew = (*minmax.second - *minmax.first) / m_intervalCollectiveCount;
+
+        if (IsMainNode())
+        {
+            std::vector<double> sorted = waitPerRank;
+            std::sort(sorted.begin(), sorted.end());
+            fprintf(stderr, "MPI comm timeline: %d collectives, avg wait %.3f ms, avg transfer %.3f ms per collective; "
+                    "per-rank wait min/median/max %.3f/%.3f/%.3f s; slowest rank %d (avg arrival skew %.3f ms)\n",
+                    (int)m_intervalCollectiveCount,
+                    1e3 * m_intervalWaitSeconds / m_intervalCollectiveCount,
+                    1e3 * m_intervalTransferSeconds / m_intervalCollectiveCount,
+                    sorted.front(), sorted[sorted.size() / 2], sorted.back(),
+                    m_lastSlowestRank, 1e3 * m_lastSkew);
+            fflush(stderr);
+        }
+
+        if (m_imbalanceHook && m_skewThreshold > 0 && m_lastSkew > m_skewThreshold)
+            m_imbalanceHook(m_lastSlowestRank, m_lastSkew);
+
+        m_intervalCollectiveCount = 0;
+        m_intervalWaitSeconds = 0;
+        m_intervalTransferSeconds = 0;
+    }
+
+    bool m_commTimingEnabled = false;
+    size_t m_commReportInterval = 0;
+    double m_skewThreshold = 0;
+    std::function<void(int, double)> m_imbalanceHook;
+
+    // Interval accumulators; collectives run on a single thread (MPI_THREAD_SERIALIZED),
+    // mutable so the const data-exchange wrappers can record into them.
+    mutable size_t m_intervalCollectiveCount = 0;
+    mutable double m_intervalWaitSeconds = 0;
+    mutable double m_intervalTransferSeconds = 0;
+    mutable int m_lastSlowestRank = -1;
+    mutable double m_lastSkew = 0;
+
+public:
     // -----------------------------------------------------------------------
     // data-exchange functions (wrappers around MPI functions)
     // -----------------------------------------------------------------------
@@ -473,6 +669,14 @@ public:
     template <class ElemType>
     void AllReduce(ElemType *sendData, ElemType *receiveData, size_t numElements, MPI_Op op = MPI_SUM) const
     {
+        if (m_commTimingEnabled)
+        {
+            double waitSeconds = TimedArrivalBarrier();
+            auto start = std::chrono::steady_clock::now();
+            MPI_Allreduce(sendData, receiveData, (int)numElements, GetDataType(sendData), op, Communicator()) || MpiFail("AllReduce: MPI_Allreduce");
+            FinishTimedCollective(waitSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            return;
+        }
         MPI_Allreduce(sendData, receiveData, (int)numElements, GetDataType(sendData), op, Communicator()) || MpiFail("AllReduce: MPI_Allreduce");
     }
 
@@ -491,6 +695,14 @@ public:
     template <class ElemType>
     void Bcast(ElemType *pData, size_t nData, size_t srcRank)
     {
+        if (m_commTimingEnabled)
+        {
+            double waitSeconds = TimedArrivalBarrier();
+            auto start = std::chrono::steady_clock::now();
+            MPI_Bcast(pData, (int) nData, GetDataType(pData), (int) srcRank, Communicator()) || MpiFail("Bcast: MPI_Bcast");
+            FinishTimedCollective(waitSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            return;
+        }
         MPI_Bcast(pData, (int) nData, GetDataType(pData), (int) srcRank, Communicator()) || MpiFail("Bcast: MPI_Bcast");
     }
 
@@ -515,6 +727,149 @@ public:
     {
         MPI_Waitall((int)requests.size(), &requests[0], MPI_STATUSES_IGNORE) || MpiFail("waitall: MPI_Waitall");
     }
+
+    // -----------------------------------------------------------------------
+    // async progress
+    // -----------------------------------------------------------------------
+    // Many MPI stacks only progress nonblocking collectives while some thread is inside an MPI
+    // call, so an Iallreduce posted mid-backprop makes no headway until the compute thread
+    // finally enters MPI_Wait -- the "overlap" then overlaps nothing. When enabled with
+    // CNTK_MPI_PROGRESS_THREAD=1 (and the library grants MPI_THREAD_MULTIPLE), a dedicated
+    // thread polls tracked requests with MPI_Test, driving progress while the compute thread
+    // keeps computing, and fires an optional completion callback as each one finishes.
+    // Operations reach the thread through a lock-free submission stack, so tracking one from
+    // the middle of backprop costs a single CAS. When the thread is unavailable, TrackAsync
+    // and WaitAsync degrade to the plain post-then-MPI_Wait behavior.
+
+    // Handle for one tracked nonblocking operation. The owner starts the operation into
+    // 'request' (e.g. via AllReduceAsync), hands the handle to TrackAsync(), and must keep it
+    // alive and unmoved until WaitAsync() returns -- the same contract as a raw MPI_Request.
+    struct AsyncOperation
+    {
+        MPI_Request request;
+        std::function<void()> onCompletion; // optional; runs on the progress thread, right before the handle completes
+
+        AsyncOperation()
+            : request(MPI_REQUEST_NULL), m_completed(false), m_next(nullptr)
+        {
+        }
+        // move support is for container setup only; a handle must not move while tracked
+        AsyncOperation(AsyncOperation&& other)
+            : request(other.request), onCompletion(std::move(other.onCompletion)), m_completed(other.m_completed.load()), m_next(nullptr)
+        {
+        }
+
+    private:
+        friend class MPIWrapper;
+        std::atomic<bool> m_completed;
+        AsyncOperation* m_next; // link in the submission stack
+    };
+
+    bool AsyncProgressEnabled() const
+    {
+        return m_asyncProgressRequested;
+    }
+
+    // hand a started nonblocking operation over to the progress thread
+    void TrackAsync(AsyncOperation* op)
+    {
+        if (!m_asyncProgressRequested)
+            return; // no progress thread; WaitAsync() will fall back to MPI_Wait
+        op->m_completed.store(false, std::memory_order_relaxed);
+        std::call_once(m_asyncThreadStarted, [this]
+                       {
+                           m_asyncProgressThread = std::thread([this] { AsyncProgressLoop(); });
+                       });
+        AsyncOperation* head = m_asyncNewOps.load();
+        do
+            op->m_next = head;
+        while (!m_asyncNewOps.compare_exchange_weak(head, op));
+    }
+
+    // wait for a tracked operation; its completion callback has run once this returns
+    void WaitAsync(AsyncOperation* op)
+    {
+        if (!m_asyncProgressRequested)
+        {
+            MPI_Wait(&op->request, MPI_STATUSES_IGNORE) || MpiFail("WaitAsync: MPI_Wait");
+            if (op->onCompletion)
+                op->onCompletion();
+            return;
+        }
+        // the progress thread is doing the real work; this is only reached once the compute
+        // thread has nothing left to overlap, so a polite spin is good enough
+        while (!op->m_completed.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+private:
+    void AsyncProgressLoop()
+    {
+        std::vector<AsyncOperation*> pending;
+        while (!m_asyncShutdown)
+        {
+            // adopt newly submitted operations (stack order does not matter; completion order is MPI's)
+            for (AsyncOperation* op = m_asyncNewOps.exchange(nullptr); op != nullptr;)
+            {
+                AsyncOperation* next = op->m_next;
+                pending.push_back(op);
+                op = next;
+            }
+
+            size_t stillPending = 0;
+            for (size_t i = 0; i < pending.size(); i++)
+            {
+                AsyncOperation* op = pending[i];
+                int flag = 0;
+                MPI_Test(&op->request, &flag, MPI_STATUS_IGNORE) || MpiFail("AsyncProgressLoop: MPI_Test");
+                if (!flag)
+                {
+                    pending[stillPending++] = op;
+                    continue;
+                }
+                if (op->onCompletion)
+                    op->onCompletion();
+                op->m_completed.store(true, std::memory_order_release); // last touch: the owner may now reuse or destroy the handle
+            }
+            pending.resize(stillPending);
+
+            if (!pending.empty())
+                std::this_thread::yield(); // keep driving MPI progress while operations are in flight
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(200)); // idle; cheap enough to keep the thread around
+        }
+    }
+
+public:
+    // -----------------------------------------------------------------------
+    // worker health check
+    // -----------------------------------------------------------------------
+
+    // Checks within 'timeoutSeconds' whether every rank has entered this call, by polling a
+    // non-blocking barrier. Call at safe points (epoch or checkpoint boundaries): when a worker
+    // has been lost (e.g. a preempted VM), the job then fails right away with a clear message
+    // instead of hanging in the next blocking collective until the scheduler kills it. This is
+    // a fail-fast device, not a recovery mechanism: continuing with the surviving ranks would
+    // need the MPI fault-tolerance extensions (ULFM), since once a rank is gone the survivors
+    // can no longer complete any collective on this communicator.
+    bool AllRanksResponding(double timeoutSeconds) const
+    {
+        MPI_Request request;
+        MPI_Ibarrier(m_currentComm, &request) || MpiFail("AllRanksResponding: MPI_Ibarrier");
+
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds((long long)(timeoutSeconds * 1000.0));
+        for (;;)
+        {
+            int flag = 0;
+            MPI_Test(&request, &flag, MPI_STATUS_IGNORE) || MpiFail("AllRanksResponding: MPI_Test");
+            if (flag)
+                return true;
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false; // the barrier request is deliberately left pending; the caller is expected to abort
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
 };
 
 }}}
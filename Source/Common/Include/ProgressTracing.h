@@ -7,6 +7,7 @@
 #include "Basics.h"
 #include <chrono>
 #include "TimerUtility.h"
+#include "AsyncLogging.h"
 #include <string>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -145,7 +146,8 @@ public:
         {
             double epochProg = ((100.0f * (double) (us.m_currentStepOffset + epochNumber)) / (double) us.m_totalNumberOfSteps);
             mbProg = (mbProg * 100.0f) / (double) us.m_totalNumberOfSteps;
-            printf("PROGRESS: %.2f%%\n", epochProg + mbProg);
+            // rate-limited by the timer above; a self-contained line, so it may go through the async log writer
+            AsyncLogWriter::Write(stdout, msra::strfun::strprintf("PROGRESS: %.2f%%\n", epochProg + mbProg));
             us.m_progressTracingTimer.Restart();
         }
         return needToPrint;
@@ -162,7 +164,7 @@ public:
             return;
         }
 
-        printf("EVALERR: %.7f%%\n", err);
+        AsyncLogWriter::Write(stdout, msra::strfun::strprintf("EVALERR: %.7f%%\n", err));
     }
 
     // This prints a PROGRESS message with a percentage value of 0 to prevent timeouts on Philly
@@ -175,7 +177,7 @@ public:
             newNumItersSinceLastPrintOfProgress++;
             if (newNumItersSinceLastPrintOfProgress >= numIterationsBeforePrintingProgress)
             {
-                printf("PROGRESS: %.2f%%\n", 0.0f);
+                AsyncLogWriter::Write(stdout, msra::strfun::strprintf("PROGRESS: %.2f%%\n", 0.0f));
                 newNumItersSinceLastPrintOfProgress = 0;
             }
         }
@@ -161,4 +161,144 @@ public:
     }
 };
 
+// ---------------------------------------------------------------------------
+// LazyRandomOrdering -- constant-memory replacement for RandomOrdering
+//
+// RandomOrdering materializes the permutation as a vector, which costs
+// 4 bytes per sample--gigabytes when a legacy reader instantiates it at
+// corpus scale. This class computes the same kind of mapping on the fly:
+// the timeline is cut into blocks of randomizationrange/2 samples, and each
+// block is permuted by a small format-preserving cipher (4-round Feistel
+// network with cycle-walking so the result stays inside the block). Each
+// block's permutation is a bijection, hence the whole mapping is, and since
+// source and target always share a block, |t - t'| < randomizationrange/2,
+// which is the same windowing condition the table-based version enforces
+// (locality suitable for paging with a sliding window).
+//
+// The interface mirrors RandomOrdering: Resize(), then operator()(seed) to
+// select the sweep (this only derives four 64-bit round keys), then
+// operator[] to map indices. Mapping is deterministic in (seed, t).
+// ---------------------------------------------------------------------------
+
+class LazyRandomOrdering // note: NOT thread-safe at all
+{
+    // constants for randomization
+    const static size_t randomizeDisable = 0;
+
+    size_t len;                // number of samples covered by the mapping
+    size_t currentseed;        // seed for current sequence
+    size_t randomizationrange; // t - randomizationrange/2 <= t' < t + randomizationrange/2
+    size_t blockSize;          // permutation granularity, <= randomizationrange/2 so the window condition holds
+    uint64_t roundKeys[4];     // Feistel round keys, derived from currentseed
+
+    void Invalidate()
+    {
+        currentseed = (size_t) -1;
+    }
+
+    // 64-bit mixing finalizer (splitmix64); used as the Feistel round function
+    static uint64_t Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // map an in-block offset i in [0, blockLen) to another offset in [0, blockLen)
+    // 'blockTweak' makes every block use a different permutation for the same keys.
+    size_t PermuteInBlock(size_t i, size_t blockLen, uint64_t blockTweak) const
+    {
+        if (blockLen <= 1)
+            return i;
+        // smallest even-split Feistel domain covering blockLen
+        size_t halfBits = 1;
+        while ((((size_t) 1) << (2 * halfBits)) < blockLen)
+            halfBits++;
+        const uint64_t halfMask = (((uint64_t) 1) << halfBits) - 1;
+        // cycle-walking: the domain is < 4 * blockLen, so this loops < 4 times in expectation
+        uint64_t v = i;
+        do
+        {
+            uint64_t hi = v >> halfBits;
+            uint64_t lo = v & halfMask;
+            for (size_t round = 0; round < 4; round++)
+            {
+                uint64_t next = hi ^ (Mix(lo ^ roundKeys[round] ^ blockTweak) & halfMask);
+                hi = lo;
+                lo = next;
+            }
+            v = (hi << halfBits) | lo;
+        } while (v >= blockLen);
+        return (size_t) v;
+    }
+
+public:
+    LazyRandomOrdering()
+    {
+        Invalidate();
+        len = 0;
+        randomizationrange = randomizeDisable;
+        blockSize = 1;
+    }
+
+    void Resize(size_t p_len, size_t p_randomizationrange)
+    {
+        len = p_len;
+        randomizationrange = p_randomizationrange;
+        if (randomizationrange != randomizeDisable)
+            blockSize = max((size_t) 1, min(randomizationrange / 2, len));
+        Invalidate();
+    }
+
+    // return the randomized feature bounds for a time range
+    std::pair<size_t, size_t> Bounds(size_t ts, size_t te) const
+    {
+        size_t tbegin = max(ts, randomizationrange / 2) - randomizationrange / 2;
+        size_t tend = min(te + randomizationrange / 2, len);
+        return std::make_pair<size_t, size_t>(std::move(tbegin), std::move(tend));
+    }
+
+    // select the sweep; unlike RandomOrdering this does not build a table but
+    // only derives the cipher keys, so switching seeds is O(1)
+    const LazyRandomOrdering& operator()(size_t seed) // throw()
+    {
+        if (seed != currentseed && randomizationrange != randomizeDisable)
+        {
+            std::mt19937_64 rng((uint64_t) seed);
+            for (size_t round = 0; round < 4; round++)
+                roundKeys[round] = rng();
+            currentseed = seed;
+        }
+        return *this; // caller can now access the mapping through operator[]
+    }
+
+    // map a sample index to its randomized position; bijective over [0, len)
+    size_t operator[](size_t t) const
+    {
+        if (randomizationrange == randomizeDisable || currentseed == (size_t) -1 || t >= len)
+            return t;
+        const size_t blockBegin = (t / blockSize) * blockSize;
+        const size_t blockLen = min(blockSize, len - blockBegin); // last block may be partial
+        return blockBegin + PermuteInBlock(t - blockBegin, blockLen, (uint64_t)(blockBegin) * 0x9e3779b97f4a7c15ULL);
+    }
+
+    size_t size() const
+    {
+        return len;
+    }
+
+    size_t CurrentSeed() const
+    {
+        return currentseed;
+    }
+
+    bool IsRandomizationDisabled() const
+    {
+        return randomizationrange == randomizeDisable;
+    }
+};
+
 }}}
@@ -12,6 +12,7 @@
 #include <mutex>
 #include "Basics.h"
 #include "Matrix.h"
+#include "HotPathCounters.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -131,8 +132,12 @@ struct MBLayout
         m_numFramesDeclared = other->m_numFramesDeclared;
         m_numGapFrames = other->m_numGapFrames;
 
-        m_distanceToStart.SetValue(other->m_distanceToStart);
-        m_distanceToEnd.SetValue(other->m_distanceToEnd);
+        m_distanceMatricesValid = other->m_distanceMatricesValid;
+        if (m_distanceMatricesValid) // if the source never materialized them, neither do we; they can be rebuilt from m_sequences
+        {
+            m_distanceToStart.SetValue(other->m_distanceToStart);
+            m_distanceToEnd.SetValue(other->m_distanceToEnd);
+        }
 
         m_distanceToNearestStart = other->m_distanceToNearestStart;
         m_distanceToNearestEnd = other->m_distanceToNearestEnd;
@@ -159,6 +164,7 @@ struct MBLayout
 
         m_distanceToStart = std::move(other->m_distanceToStart);
         m_distanceToEnd = std::move(other->m_distanceToEnd);
+        m_distanceMatricesValid = other->m_distanceMatricesValid;
 
         m_distanceToNearestStart = std::move(other->m_distanceToNearestStart);
         m_distanceToNearestEnd = std::move(other->m_distanceToNearestEnd);
@@ -178,11 +184,14 @@ public:
     // resize and reset all frames to None (note: this is an invalid state and must be fixed by caller afterwards)
     void Init(size_t numParallelSequences, size_t numTimeSteps)
     {
+        HOTPATH_COUNTER_ADD(hotpathMBLayoutInit, numParallelSequences * numTimeSteps);
         // remember the dimensions
         m_numParallelSequences = numParallelSequences;
         m_numTimeSteps = numTimeSteps;
-        m_distanceToStart.Resize(m_numParallelSequences, m_numTimeSteps);
-        m_distanceToEnd.Resize(m_numParallelSequences, m_numTimeSteps);
+        // Note: m_distanceToStart/m_distanceToEnd are not resized (or filled) here; they are
+        // materialized lazily from m_sequences upon first access, since only sequence-aware
+        // consumers (delay nodes, sequence training) ever read them.
+        m_distanceMatricesValid = false;
         m_distanceToNearestStart.assign(m_numTimeSteps, PTRDIFF_MAX);
         m_distanceToNearestEnd.assign(m_numTimeSteps, PTRDIFF_MAX);
         m_timeStepHasGap.assign(m_numTimeSteps, false);
@@ -384,10 +393,7 @@ public:
         {
             m_numGapFrames += (e - b);
             for (size_t t = b; t < e; t++)
-            {
                 m_timeStepHasGap[t] = true;
-                m_distanceToStart(s, t) = -1; // start flags also encode gaps
-            }
         }
         else
             for (size_t t = b; t < e; t++)
@@ -396,14 +402,13 @@ public:
                 // If 0, then we are on a boundary. If not 0, we can still test in presence of FrameRange.m_timeOffset.
                 ptrdiff_t distanceToStart = (ptrdiff_t) t - beginTime;
                 ptrdiff_t distanceToEnd = (ptrdiff_t)(endTime - 1 - t);
-                m_distanceToStart(s, t) = (float) distanceToStart;
-                m_distanceToEnd(s, t) = (float) distanceToEnd;
-                // and the aggregate
                 if (m_distanceToNearestStart[t] > distanceToStart)
                     m_distanceToNearestStart[t] = distanceToStart;
                 if (m_distanceToNearestEnd[t] > distanceToEnd)
                     m_distanceToNearestEnd[t] = distanceToEnd;
             }
+        // note: the per-(s,t) m_distanceToStart/m_distanceToEnd cells are not written here;
+        // EnsureDistanceMatrices() replays them from m_sequences if anyone asks
     }
 
     // short-hand to initialize an MBLayout for the common case of frame mode
@@ -427,9 +432,8 @@ public:
         }
         m_numFramesDeclared = numSamples;
 
-        // create all the cached fast-lookup information
-        m_distanceToStart.SetValue(0);
-        m_distanceToEnd.SetValue(0);
+        // create all the cached fast-lookup information (the distance matrices stay lazy;
+        // frame mode has no recurrence, so they are typically never asked for)
         m_distanceToNearestStart[0] = 0;
         m_distanceToNearestEnd[0] = 0;
 
@@ -525,6 +529,9 @@ private:
         m_writable = false;
     }
 
+    // materialize m_distanceToStart/m_distanceToEnd from m_sequences upon first access
+    void EnsureDistanceMatrices() const;
+
 private:
     // -------------------------------------------------------------------
     // data members: main information
@@ -560,7 +567,12 @@ private:
     //                              2  1  0  .  . ]          // (last two time steps undefined)
     // m_distanceToNearestStart = [ 0  1  2  3  4 ]
     // m_distanceToNearestEnd   = [ 2  1  0  1  0 ]
-    Matrix<float> m_distanceToStart, m_distanceToEnd;                   // (s,t); value<0 stands for gap
+    // These matrices are materialized lazily (like m_columnsValidityMask below): building them is
+    // a per-column pass that only sequence-aware consumers need, so plain feed-forward minibatches
+    // skip it. m_distanceMatricesValid says whether their content matches m_sequences; while it is
+    // false, EnsureDistanceMatrices() rebuilds them on first access.
+    mutable Matrix<float> m_distanceToStart, m_distanceToEnd;           // (s,t); value<0 stands for gap
+    mutable bool m_distanceMatricesValid;
     vector<ptrdiff_t> m_distanceToNearestStart, m_distanceToNearestEnd; // [t]    (does not store info about gaps; consult m_timeStepHasGap[] vector instead)
 
     vector<bool> m_timeStepHasGap; // [t] true if at least one gap in time step t
@@ -590,6 +602,7 @@ public:
     // special accessor for sequence training  --TODO: must be replaced by a different mechanism
     bool IsEnd(size_t s, size_t t) const
     {
+        EnsureDistanceMatrices();
         auto distanceToStart = (ptrdiff_t) m_distanceToStart(s, t);
 #if 1 // I don't exactly know what this does, so try assert() first
         assert(distanceToStart != -1);
@@ -786,6 +799,36 @@ inline bool MBLayout::HasGaps() const
     return m_numGapFrames > 0; /*HasGaps(FrameRange());*/
 }
 
+// lazily rebuild the per-(s,t) boundary-distance matrices from m_sequences
+// This replays the fill that AddSequence() used to do eagerly. It runs after CheckIsValid(),
+// i.e. all frames are declared, so every (s,t) cell is covered by a sequence or a gap.
+inline void MBLayout::EnsureDistanceMatrices() const
+{
+    if (m_distanceMatricesValid)
+        return;
+    m_distanceToStart.Resize(m_numParallelSequences, m_numTimeSteps);
+    m_distanceToEnd.Resize(m_numParallelSequences, m_numTimeSteps);
+    for (const auto &seq : m_sequences)
+    {
+        size_t b = (size_t) (max(seq.tBegin, (ptrdiff_t) 0));
+        size_t e = min(seq.tEnd, m_numTimeSteps);
+        if (seq.seqId == GAP_SEQUENCE_ID)
+        {
+            for (size_t t = b; t < e; t++)
+                m_distanceToStart(seq.s, t) = -1; // start flags also encode gaps
+        }
+        else
+        {
+            for (size_t t = b; t < e; t++)
+            {
+                m_distanceToStart(seq.s, t) = (float) ((ptrdiff_t) t - seq.tBegin);
+                m_distanceToEnd(seq.s, t) = (float) (seq.tEnd - 1 - t);
+            }
+        }
+    }
+    m_distanceMatricesValid = true;
+}
+
 inline bool MBLayout::HasGaps(const FrameRange &fr) const
 {
     CheckIsValid();
@@ -811,6 +854,7 @@ inline bool MBLayout::IsGap(const FrameRange &fr) const
         return m_timeStepHasGap[t];
 
     // determine flags from matrices
+    EnsureDistanceMatrices();
     return m_distanceToStart(s, t) < 0; // value is -1 for gaps, non-negative otherwise
 }
 
@@ -853,6 +897,7 @@ inline bool MBLayout::IsBeyondStartOrEnd(const FrameRange &fr) const
     }
 
     // determine flags from matrices
+    EnsureDistanceMatrices();
     auto distanceToStart = (ptrdiff_t) m_distanceToStart(s, t);
     if (distanceToStart == -1) // indicates a gap
     {
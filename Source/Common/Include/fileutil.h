@@ -43,6 +43,22 @@
 FILE* fopenOrDie(const std::string& pathname, const char* mode);
 FILE* fopenOrDie(const std::wstring& pathname, const wchar_t* mode);
 
+// ----------------------------------------------------------------------------
+// streaming-scan hints -- all best-effort; no-ops where the OS has no equivalent
+//
+// fsetbuffer(): setvbuf-equivalent; resize the stdio buffer of a freshly opened
+// stream (multi-MB buffers pay off for sequential corpus scans).
+// fsetuncached(): ask the OS not to retain this file's pages in the page cache,
+// for large one-pass scans that would otherwise evict more useful data.
+// fdropCachedPages(): drop cached pages of a byte range already processed
+// (end = 0 means up to EOF); long scans can call this periodically behind the
+// read position.
+// ----------------------------------------------------------------------------
+
+void fsetbuffer(FILE* f, size_t size);
+void fsetuncached(FILE* f);
+void fdropCachedPages(FILE* f, uint64_t beg = 0, uint64_t end = 0);
+
 #ifndef __unix__
 // ----------------------------------------------------------------------------
 // fsetmode(): set mode to binary or text
@@ -21,9 +21,18 @@
 #include <string>
 #include <unordered_map>
 #include <algorithm> // for find()
+#include <memory>
 #include "simplesenonehmm.h"
 #include "Matrix.h"
 
+#ifndef _WIN32 // for memory-mapped archive files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
 namespace msra { namespace math {
 
 class ssematrixbase;
@@ -62,6 +71,55 @@ enum mbrclassdefinition // used to identify definition of class in minimum bayes
     // monophonestate = 2,
     monophone = 3, // pMBR?
 };
+// ===========================================================================
+// memreader -- sequential reader over an in-memory byte range
+// This mirrors the FILE*-based helpers of fileutil.h (freadOrDie(), fgetint(),
+// fcheckTag()) so that lattice::fread() can decode a lattice straight out of a
+// memory-mapped archive, without a seek+read round-trip per utterance.
+// ===========================================================================
+struct memreader
+{
+    const char* p;   // current read position
+    const char* end; // end of readable range
+    memreader(const char* begin, const char* end)
+        : p(begin), end(end)
+    {
+    }
+};
+
+inline void freadOrDie(void* ptr, size_t size, size_t count, memreader& f)
+{
+    const size_t bytes = size * count;
+    if (bytes > (size_t) (f.end - f.p))
+        RuntimeError("freadOrDie: attempted to read beyond end of memory-mapped archive");
+    memcpy(ptr, f.p, bytes);
+    f.p += bytes;
+}
+
+template <class _T>
+inline void freadOrDie(_T& data, size_t num, memreader& f) // template for std::vector<>
+{
+    data.resize(num);
+    if (data.size() > 0)
+        freadOrDie(&data[0], sizeof(data[0]), data.size(), f);
+}
+
+inline int fgetint(memreader& f)
+{
+    int v;
+    freadOrDie(&v, sizeof(v), 1, f);
+    return v;
+}
+
+inline void fcheckTag(memreader& f, const char* expectedTag)
+{
+    char tag[5];
+    freadOrDie(&tag[0], 4, 1, f);
+    tag[4] = 0;
+    if (strcmp(tag, expectedTag) != 0)
+        RuntimeError("fcheckTag: tag mismatch: found %s, expected %s", tag, expectedTag);
+}
+
 // ===========================================================================
 // lattice -- one lattice in memory
 // ===========================================================================
@@ -942,14 +1000,17 @@ public:
     {
     }
 
-    size_t freadtag(FILE* f, const char* tag)
+    // The readers are templated over the stream handle so the same decoding code
+    // serves both FILE* (seek+read) and memreader (memory-mapped archive) access.
+    template <class FHANDLE>
+    size_t freadtag(FHANDLE& f, const char* tag)
     {
         fcheckTag(f, tag);
         return (unsigned int) fgetint(f);
     }
 
-    template <class VECTOR>
-    void freadvector(FILE* f, const char* tag, VECTOR& v, size_t expectedsize = SIZE_MAX)
+    template <class FHANDLE, class VECTOR>
+    void freadvector(FHANDLE& f, const char* tag, VECTOR& v, size_t expectedsize = SIZE_MAX)
     {
         const size_t sz = freadtag(f, tag);
         if (expectedsize != SIZE_MAX && sz != expectedsize)
@@ -964,8 +1025,9 @@ public:
     // If this fails, the lattice is in unusable state, but it is OK to call fread() again to regain a usable object. I.e. this is safe to be used in retry loops.
     // This will also map the aligninfo entries to the new symbol table, through idmap.
     // V1 lattices will be converted. 'spsenoneid' is used in that process.
-    template <class IDMAP>
-    void fread(FILE* f, const IDMAP& idmap, size_t spunit)
+    // 'f' may be a FILE* positioned at the lattice, or a memreader over a memory-mapped archive.
+    template <class FHANDLE, class IDMAP>
+    void fread(FHANDLE& f, const IDMAP& idmap, size_t spunit)
     {
         size_t version = freadtag(f, "LAT ");
         if (version == 1)
@@ -1119,6 +1181,122 @@ public:
     }
 };
 
+// ===========================================================================
+// memmappedfile -- read-only memory mapping of an archive file
+// Lattices are decoded lazily out of the mapping (no seek+read per utterance),
+// and prefetch() lets us hint the OS to read ahead at the fetch position, which
+// follows the randomizer's utterance order. Throws on failure; callers are
+// expected to fall back to buffered reads.
+// ===========================================================================
+class memmappedfile
+{
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    HANDLE hfile;
+    HANDLE hmapping;
+#endif
+    memmappedfile(const memmappedfile&);
+    void operator=(const memmappedfile&);
+
+public:
+    memmappedfile(const std::wstring& path)
+        : data_(NULL), size_(0)
+    {
+#ifdef _WIN32
+        hfile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (hfile == INVALID_HANDLE_VALUE)
+            RuntimeError("memmappedfile: error opening file '%S': %d", path.c_str(), (int) GetLastError());
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(hfile, &size))
+        {
+            CloseHandle(hfile);
+            RuntimeError("memmappedfile: error getting size of file '%S': %d", path.c_str(), (int) GetLastError());
+        }
+        size_ = (size_t) size.QuadPart;
+        hmapping = NULL;
+        if (size_ > 0) // (cannot map an empty file; leave data_ NULL)
+        {
+            hmapping = CreateFileMappingW(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (hmapping == NULL)
+            {
+                CloseHandle(hfile);
+                RuntimeError("memmappedfile: error creating file mapping for '%S': %d", path.c_str(), (int) GetLastError());
+            }
+            data_ = (const char*) MapViewOfFile(hmapping, FILE_MAP_READ, 0, 0, 0);
+            if (data_ == NULL)
+            {
+                CloseHandle(hmapping);
+                CloseHandle(hfile);
+                RuntimeError("memmappedfile: error mapping view of file '%S': %d", path.c_str(), (int) GetLastError());
+            }
+        }
+#else
+        int fd = ::open(msra::strfun::utf8(path).c_str(), O_RDONLY);
+        if (fd == -1)
+            RuntimeError("memmappedfile: error opening file '%S': %s", path.c_str(), strerror(errno));
+        struct stat buf;
+        if (fstat(fd, &buf) == -1)
+        {
+            ::close(fd);
+            RuntimeError("memmappedfile: error getting size of file '%S': %s", path.c_str(), strerror(errno));
+        }
+        size_ = (size_t) buf.st_size;
+        if (size_ > 0) // (cannot map an empty file; leave data_ NULL)
+        {
+            void* p = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                RuntimeError("memmappedfile: error mapping file '%S': %s", path.c_str(), strerror(errno));
+            }
+            data_ = (const char*) p;
+            // fetches jump around the archive in the randomizer's order, so disable the
+            // default sequential readahead; prefetch() hints the actually needed ranges
+            madvise(p, size_, MADV_RANDOM);
+        }
+        ::close(fd); // (the mapping keeps its own reference)
+#endif
+    }
+    ~memmappedfile()
+    {
+#ifdef _WIN32
+        if (data_ != NULL)
+            UnmapViewOfFile(data_);
+        if (hmapping != NULL)
+            CloseHandle(hmapping);
+        CloseHandle(hfile);
+#else
+        if (data_ != NULL)
+            munmap((void*) data_, size_);
+#endif
+    }
+    const char* data() const
+    {
+        return data_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    // hint the OS to read ahead at the given position, so decoding does not block on page faults
+    void prefetch(size_t offset, size_t bytes) const
+    {
+#ifdef _WIN32
+        UNUSED(offset); // TODO: PrefetchVirtualMemory() once we can require Windows 8; page faults will read on demand
+        UNUSED(bytes);
+#else
+        if (offset >= size_)
+            return;
+        if (bytes > size_ - offset)
+            bytes = size_ - offset;
+        const size_t pagemask = 4096 - 1;
+        const size_t begin = offset & ~pagemask; // round down to page boundary
+        posix_madvise((void*) (data_ + begin), bytes + (offset - begin), POSIX_MADV_WILLNEED);
+#endif
+    }
+};
+
 // ===========================================================================
 // archive -- a disk-based archive of lattices
 // Optimized for sequentially retrieving lattices in order of original archive
@@ -1213,6 +1391,153 @@ class archive
     mutable size_t currentarchiveindex;               // which archive is open
     mutable auto_file_ptr f;                          // cached archive file handle of currentarchiveindex
     std::unordered_map<std::wstring, latticeref> toc; // [key] -> (file, offset)  --table of content (.toc file)
+
+    // memory mappings of the archive files, established lazily upon first fetch
+    mutable std::vector<std::shared_ptr<memmappedfile>> mappedarchives; // [archiveindex] -> mapping, or NULL if not (yet) mapped
+    mutable std::vector<bool> mappingfailed;                            // [archiveindex] -> mapping failed; stick to buffered reads
+
+    // lazily establish the memory mapping of an archive file; returns NULL if mapping is unavailable
+    const memmappedfile* getmappedarchive(size_t archiveindex) const
+    {
+        if (mappingfailed[archiveindex])
+            return NULL;
+        auto& mapping = mappedarchives[archiveindex];
+        if (mapping == nullptr)
+        {
+            try
+            {
+                mapping.reset(new memmappedfile(archivepaths[archiveindex]));
+            }
+            catch (const std::exception& e)
+            {
+                fprintf(stderr, "getmappedarchive: %s; falling back to buffered reads\n", e.what());
+                mappingfailed[archiveindex] = true;
+                return NULL;
+            }
+        }
+        return mapping.get();
+    }
+
+    // ---- binary TOC index ----
+    // The text .toc files take minutes to line-parse for archives with tens of millions of
+    // lattices. We therefore remember the parse result in a binary sidecar (<tocpath>.idx)
+    // and use that on subsequent startups, as long as it is newer than the .toc file.
+    // Archive paths are stored as they appear in the .toc, i.e. without prefixPathInToc,
+    // so the index remains valid if a different prefix is passed later.
+    // The offset/archive-index packing of entries follows the latticeref layout, with the
+    // archive index being local to this TOC's path table.
+
+    static const int tocindexversion = 1;
+
+    // parse a text TOC file into its archive-path table and (key, packed offset) entries
+    static void parsetoc(const std::wstring& tocpath, std::vector<std::string>& tocarchivepaths, std::vector<std::pair<std::string, uint64_t>>& entries)
+    {
+        std::vector<char> textbuffer;
+        auto toclines = msra::files::fgetfilelines(tocpath, textbuffer, 3);
+        size_t localindex = SIZE_MAX;
+        entries.reserve(toclines.size());
+        foreach_index (i, toclines)
+        {
+            const char* line = toclines[i];
+            const char* p = strchr(line, '=');
+            if (p == NULL)
+                RuntimeError("open: invalid TOC line (no = sign): %s", line);
+            std::string key(line, p - line);
+            p++;
+            const char* q = strchr(p, '[');
+            if (q == NULL)
+                RuntimeError("open: invalid TOC line (no [): %s", line);
+            if (q != p)
+            {
+                std::string archivepath(p, q - p);
+                if (localindex == SIZE_MAX || archivepath != tocarchivepaths[localindex]) // (fast path: same as previous line)
+                {
+                    auto iter = std::find(tocarchivepaths.begin(), tocarchivepaths.end(), archivepath);
+                    localindex = iter - tocarchivepaths.begin();
+                    if (localindex == tocarchivepaths.size())
+                        tocarchivepaths.push_back(std::move(archivepath));
+                }
+            }
+            if (localindex == SIZE_MAX)
+                RuntimeError("open: invalid TOC line (empty archive pathname): %s", line);
+            char c;
+            uint64_t offset;
+#ifdef _WIN32
+            if (sscanf_s(q, "[%I64u]%c", &offset, &c, (unsigned int) sizeof(c)) != 1)
+#else
+            if (sscanf(q, "[%" PRIu64 "]%c", &offset, &c) != 1)
+#endif
+                RuntimeError("open: invalid TOC line (bad [] expression): %s", line);
+            entries.push_back(std::make_pair(std::move(key), (offset & ((1ull << 48) - 1)) | ((uint64_t) localindex << 48)));
+        }
+    }
+
+    // write the parsed TOC to a binary index file (to a temp name, then renamed into place)
+    static void writetocindex(const std::wstring& tocindexpath, const std::vector<std::string>& tocarchivepaths, const std::vector<std::pair<std::string, uint64_t>>& entries)
+    {
+        const std::wstring tmppath = tocindexpath + L".tmp";
+        {
+            auto_file_ptr f(fopenOrDie(tmppath, L"wbS"));
+            fputTag(f, "LTOC");
+            fputint(f, tocindexversion);
+            fputint(f, (int) tocarchivepaths.size());
+            for (const auto& path : tocarchivepaths)
+            {
+                fputint(f, (int) path.size());
+                fwriteOrDie(path.data(), 1, path.size(), f);
+            }
+            const uint64_t numentries = entries.size();
+            fwriteOrDie(&numentries, sizeof(numentries), 1, f);
+            for (const auto& entry : entries)
+            {
+                fputint(f, (int) entry.first.size());
+                fwriteOrDie(entry.first.data(), 1, entry.first.size(), f);
+                fwriteOrDie(&entry.second, sizeof(entry.second), 1, f);
+            }
+            fputTag(f, "END ");
+            fflushOrDie(f);
+        }
+        renameOrDie(tmppath, tocindexpath);
+    }
+
+    // read a binary TOC index; returns false (with a warning) if it cannot be used
+    static bool readtocindex(const std::wstring& tocindexpath, std::vector<std::string>& tocarchivepaths, std::vector<std::pair<std::string, uint64_t>>& entries)
+    {
+        try
+        {
+            auto_file_ptr f(fopenOrDie(tocindexpath, L"rbS"));
+            fcheckTag(f, "LTOC");
+            if (fgetint(f) != tocindexversion)
+                RuntimeError("readtocindex: unexpected binary TOC index version");
+            tocarchivepaths.resize((size_t) fgetint(f));
+            for (auto& path : tocarchivepaths)
+            {
+                path.resize((size_t) fgetint(f));
+                if (!path.empty())
+                    freadOrDie(&path[0], 1, path.size(), f);
+            }
+            uint64_t numentries;
+            freadOrDie(&numentries, sizeof(numentries), 1, f);
+            entries.resize((size_t) numentries);
+            for (auto& entry : entries)
+            {
+                entry.first.resize((size_t) fgetint(f));
+                if (!entry.first.empty())
+                    freadOrDie(&entry.first[0], 1, entry.first.size(), f);
+                freadOrDie(&entry.second, sizeof(entry.second), 1, f);
+            }
+            fcheckTag(f, "END ");
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            fprintf(stderr, "open: ignoring unusable binary TOC index '%S' (%s)\n", tocindexpath.c_str(), e.what());
+            tocarchivepaths.clear();
+            entries.clear();
+            return false;
+        }
+    }
+
 public:
     // construct = open the archive
     // archive() : currentarchiveindex (SIZE_MAX) {}
@@ -1249,50 +1574,48 @@ public:
     void open(const std::wstring& tocpath)
     {
         // BUGBUG: we only really support one archive file at this point
-        // read the TOC in one swoop
-        std::vector<char> textbuffer;
-        auto toclines = msra::files::fgetfilelines(tocpath, textbuffer, 3);
-
-        // parse it one by one
-        size_t archiveindex = SIZE_MAX; // its index
-        foreach_index (i, toclines)
+        // get the TOC content, preferring the binary index if we have a current one
+        const std::wstring tocindexpath = tocpath + L".idx";
+        std::vector<std::string> tocarchivepaths;              // [localindex] -> archive path as recorded in the TOC
+        std::vector<std::pair<std::string, uint64_t>> entries; // [i] -> (key, packed offset/local archive index)
+        if (!msra::files::fuptodate(tocindexpath, tocpath) || !readtocindex(tocindexpath, tocarchivepaths, entries))
         {
-            const char* line = toclines[i];
-            const char* p = strchr(line, '=');
-            if (p == NULL)
-                RuntimeError("open: invalid TOC line (no = sign): %s", line);
-            const std::wstring key = msra::strfun::utf16(std::string(line, p - line));
-            p++;
-            const char* q = strchr(p, '[');
-            if (q == NULL)
-                RuntimeError("open: invalid TOC line (no [): %s", line);
-            if (q != p)
+            parsetoc(tocpath, tocarchivepaths, entries);
+            // remember the parse result as a binary index, to make the next startup fast
+            // This is best effort--the TOC may live in a read-only location.
+            try
             {
-                std::wstring archivepath = msra::strfun::utf16(std::string(p, q - p));
-                if (!prefixPathInToc.empty())
-                {
-                    archivepath = prefixPathInToc + L"/" + archivepath;
-                }
-                // TODO: should we allow paths relative to TOC file?
-                archiveindex = getarchiveindex(archivepath);
+                writetocindex(tocindexpath, tocarchivepaths, entries);
             }
-            if (archiveindex == SIZE_MAX)
-                RuntimeError("open: invalid TOC line (empty archive pathname): %s", line);
-            char c;
-            uint64_t offset;
-#ifdef _WIN32
-            if (sscanf_s(q, "[%I64u]%c", &offset, &c, (unsigned int)sizeof(c)) != 1)
-#else
+            catch (const std::exception& e)
+            {
+                fprintf(stderr, "open: failed to write binary TOC index '%S' (%s)\n", tocindexpath.c_str(), e.what());
+            }
+        }
 
-            if (sscanf(q, "[%" PRIu64 "]%c", &offset, &c) != 1)
-#endif
-                RuntimeError("open: invalid TOC line (bad [] expression): %s", line);
-            if (!toc.insert(make_pair(key, latticeref(offset, archiveindex))).second)
-                RuntimeError("open: TOC entry leads to duplicate key: %s", line);
+        // enter the entries into the TOC, mapping this TOC's archive indices to global ones
+        std::vector<size_t> archiveindexmap(tocarchivepaths.size()); // [localindex] -> index in archivepaths[]
+        foreach_index (i, tocarchivepaths)
+        {
+            std::wstring archivepath = msra::strfun::utf16(tocarchivepaths[i]);
+            if (!prefixPathInToc.empty())
+            {
+                archivepath = prefixPathInToc + L"/" + archivepath;
+            }
+            // TODO: should we allow paths relative to TOC file?
+            archiveindexmap[i] = getarchiveindex(archivepath);
+        }
+        for (const auto& entry : entries)
+        {
+            const latticeref ref(entry.second & ((1ull << 48) - 1), archiveindexmap[(size_t) (entry.second >> 48)]);
+            if (!toc.insert(make_pair(msra::strfun::utf16(entry.first), ref)).second)
+                RuntimeError("open: TOC entry leads to duplicate key: %s", entry.first.c_str());
         }
 
-        // initialize symmaps  --alloc the array, but actually read the symmap on demand
+        // initialize symmaps and archive mappings  --alloc the arrays, but actually read/map on demand
         symmaps.resize(archivepaths.size());
+        mappedarchives.resize(archivepaths.size());
+        mappingfailed.resize(archivepaths.size());
     }
 
     // check if a lattice for a given key is available  --do this during initial check ideally
@@ -1335,18 +1658,17 @@ public:
         if (spunit2 != spunit)
             LogicError("getlattice: huh? same lookup of /sp/ gives different result?");
 #endif
-        // open archive file in case it is not the current one
-        if (archiveindex != currentarchiveindex)
+        // decode straight out of the memory-mapped archive if we managed to map it
+        // (no seek+read system calls per utterance, and pages stay in the OS cache across epochs)
+        const memmappedfile* mapped = getmappedarchive(archiveindex);
+        if (mapped != NULL)
         {
-            f = fopenOrDie(archivepaths[archiveindex], L"rbS"); // or throw (will close old 'f' iff succeeded)
-            currentarchiveindex = archiveindex;
-        }
-        try // (for read operation)
-        {
-            // seek to start
-            fsetpos(f, offset);
-            // get it
-            L.fread(f, idmap, spunit);
+            if (offset >= mapped->size())
+                RuntimeError("getlattice: offset beyond end of archive file '%S'", archivepaths[archiveindex].c_str());
+            const size_t readaheadbytes = 262144; // generous bound on one lattice's size
+            mapped->prefetch(offset, readaheadbytes); // fetches follow the randomizer's utterance order, so this is our readahead hint
+            memreader reader(mapped->data() + offset, mapped->data() + mapped->size());
+            L.fread(reader, idmap, spunit);
             L.setverbosity(verbosity);
 #ifdef HACK_IN_SILENCE // hack to simulate DEL in the lattice
             const size_t silunit = getid(modelsymmap, "sil");
@@ -1354,11 +1676,33 @@ public:
             L.hackinsilencesubstitutionedges(silunit, spunit, addsp);
 #endif
         }
-        catch (...) // to retry a read error due to a disconnected file handle, we need to reopen the file
+        else // mapping unavailable: buffered seek+read
         {
-            currentarchiveindex = SIZE_MAX;
-            f = NULL; // this closes the file handle
-            throw;
+            // open archive file in case it is not the current one
+            if (archiveindex != currentarchiveindex)
+            {
+                f = fopenOrDie(archivepaths[archiveindex], L"rbS"); // or throw (will close old 'f' iff succeeded)
+                currentarchiveindex = archiveindex;
+            }
+            try // (for read operation)
+            {
+                // seek to start
+                fsetpos(f, offset);
+                // get it
+                L.fread(f, idmap, spunit);
+                L.setverbosity(verbosity);
+#ifdef HACK_IN_SILENCE // hack to simulate DEL in the lattice
+                const size_t silunit = getid(modelsymmap, "sil");
+                const bool addsp = true;
+                L.hackinsilencesubstitutionedges(silunit, spunit, addsp);
+#endif
+            }
+            catch (...) // to retry a read error due to a disconnected file handle, we need to reopen the file
+            {
+                currentarchiveindex = SIZE_MAX;
+                f = NULL; // this closes the file handle
+                throw;
+            }
         }
         // check if number of frames is as expected
         if (expectedframes != SIZE_MAX && L.getnumframes() != expectedframes)
@@ -27,6 +27,21 @@
 #undef min // some garbage from some Windows header that conflicts with std::min()
 #endif
 
+// AVX2/FMA kernels: 8-wide versions of the hot loops, selected at runtime via
+// ssematrixbase::hasavx2(). On gcc/clang the kernels carry a target attribute so
+// the rest of the build stays at its baseline (SSE) architecture flags; MSVC
+// compiles AVX2 intrinsics without special flags.
+#if !defined(__aarch64__)
+#define SSEMATRIX_HAS_AVX2 1
+#ifdef _MSC_VER
+#define SSEMATRIX_AVX2_TARGET
+#else
+#define SSEMATRIX_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#else
+#define SSEMATRIX_HAS_AVX2 0
+#endif
+
 namespace msra { namespace math {
 
 // ===========================================================================
@@ -372,6 +387,117 @@ public:
         return result;
     }
 
+    // runtime test for AVX2/FMA support, cached on first call
+    static bool hasavx2()
+    {
+#if SSEMATRIX_HAS_AVX2
+        static const bool cached = []()
+        {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 12)) == 0 || (info[2] & (1 << 27)) == 0) // FMA, OSXSAVE
+                return false;
+            if ((_xgetbv(0) & 6) != 6) // YMM state not enabled by the OS
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0; // AVX2
+#else
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? true : false;
+#endif
+        }();
+        return cached;
+#else
+        return false;
+#endif
+    }
+
+#if SSEMATRIX_HAS_AVX2
+    // 8-wide version of dotprod() below. The buffers only guarantee 16-byte alignment
+    // and 4-float column padding (the SSE contract), so we use unaligned loads and
+    // finish the last non-multiple-of-8 part with a 4-wide block.
+    static SSEMATRIX_AVX2_TARGET void dotprod_avx2(const_array_ref<float> a, const_array_ref<float> b, float &result,
+                                                   bool addtoresult, const float thisscale, const float weight)
+    {
+        const float *pa = &a[0];
+        const float *pb = &b[0];
+        const size_t n8 = a.size() / 8;
+        __m256 acc8 = _mm256_setzero_ps();
+        for (size_t m = 0; m < n8; m++)
+            acc8 = _mm256_fmadd_ps(_mm256_loadu_ps(pa + 8 * m), _mm256_loadu_ps(pb + 8 * m), acc8);
+        __m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+        const size_t nlong = (a.size() + 3) / 4; // number of SSE elements (stays within the padded column)
+        for (size_t m = 2 * n8; m < nlong; m++)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_load_ps(pa + 4 * m), _mm_load_ps(pb + 4 * m)));
+        acc = _mm_hadd_ps(acc, acc);
+        acc = _mm_hadd_ps(acc, acc);
+        const float sum = _mm_cvtss_f32(acc);
+        if (addtoresult)
+            result = result * thisscale + weight * sum;
+        else
+            result = sum;
+    }
+
+    // 8-wide version of dotprod4() below, same contract as dotprod_avx2()
+    static SSEMATRIX_AVX2_TARGET void dotprod4_avx2(const_array_ref<float> row, const_array_ref<float> cols4, size_t cols4stride,
+                                                    array_ref<float> usij, size_t usijstride,
+                                                    bool addtoresult, const float thisscale, const float weight)
+    {
+        const float *prow = &row[0];
+        const float *pcol0 = &cols4[0 * cols4stride];
+        const float *pcol1 = &cols4[1 * cols4stride];
+        const float *pcol2 = &cols4[2 * cols4stride];
+        const float *pcol3 = &cols4[3 * cols4stride];
+        const size_t n8 = row.size() / 8;
+        __m256 acc08 = _mm256_setzero_ps();
+        __m256 acc18 = _mm256_setzero_ps();
+        __m256 acc28 = _mm256_setzero_ps();
+        __m256 acc38 = _mm256_setzero_ps();
+        for (size_t m = 0; m < n8; m++)
+        {
+            const __m256 rowm = _mm256_loadu_ps(prow + 8 * m);
+            acc08 = _mm256_fmadd_ps(rowm, _mm256_loadu_ps(pcol0 + 8 * m), acc08);
+            acc18 = _mm256_fmadd_ps(rowm, _mm256_loadu_ps(pcol1 + 8 * m), acc18);
+            acc28 = _mm256_fmadd_ps(rowm, _mm256_loadu_ps(pcol2 + 8 * m), acc28);
+            acc38 = _mm256_fmadd_ps(rowm, _mm256_loadu_ps(pcol3 + 8 * m), acc38);
+        }
+        __m128 acc0 = _mm_add_ps(_mm256_castps256_ps128(acc08), _mm256_extractf128_ps(acc08, 1));
+        __m128 acc1 = _mm_add_ps(_mm256_castps256_ps128(acc18), _mm256_extractf128_ps(acc18, 1));
+        __m128 acc2 = _mm_add_ps(_mm256_castps256_ps128(acc28), _mm256_extractf128_ps(acc28, 1));
+        __m128 acc3 = _mm_add_ps(_mm256_castps256_ps128(acc38), _mm256_extractf128_ps(acc38, 1));
+        const size_t nlong = (row.size() + 3) / 4;
+        for (size_t m = 2 * n8; m < nlong; m++)
+        {
+            const __m128 rowm = _mm_load_ps(prow + 4 * m);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(rowm, _mm_load_ps(pcol0 + 4 * m)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(rowm, _mm_load_ps(pcol1 + 4 * m)));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(rowm, _mm_load_ps(pcol2 + 4 * m)));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(rowm, _mm_load_ps(pcol3 + 4 * m)));
+        }
+        // transpose-sum the four accumulators into one vector {sum0, sum1, sum2, sum3}
+        const __m128 sums = _mm_hadd_ps(_mm_hadd_ps(acc0, acc1), _mm_hadd_ps(acc2, acc3));
+        float sum4[4];
+        _mm_storeu_ps(sum4, sums);
+        if (addtoresult)
+        {
+            usij[0 * usijstride] = usij[0 * usijstride] * thisscale + weight * sum4[0];
+            usij[1 * usijstride] = usij[1 * usijstride] * thisscale + weight * sum4[1];
+            usij[2 * usijstride] = usij[2 * usijstride] * thisscale + weight * sum4[2];
+            usij[3 * usijstride] = usij[3 * usijstride] * thisscale + weight * sum4[3];
+        }
+        else
+        {
+            usij[0 * usijstride] = sum4[0];
+            usij[1 * usijstride] = sum4[1];
+            usij[2 * usijstride] = sum4[2];
+            usij[3 * usijstride] = sum4[3];
+        }
+    }
+#endif
+
     // dot product of two vectors (which may or may not be columns matrices)
     // If 'addtoresult' then scale the result then add to it weighted, rather than overwriting it.
     static void dotprod(const_array_ref<float> a, const_array_ref<float> b, float &result)
@@ -386,6 +512,13 @@ public:
         assert((15 & reinterpret_cast<uintptr_t>(&a[0])) == 0);
         assert((15 & reinterpret_cast<uintptr_t>(&b[0])) == 0); // enforce SSE alignment
 
+#if SSEMATRIX_HAS_AVX2
+        if (hasavx2())
+        {
+            dotprod_avx2(a, b, result, addtoresult, thisscale, weight);
+            return;
+        }
+#endif
         size_t nlong = (a.size() + 3) / 4; // number of SSE elements
         const msra::math::float4 *pa = (const msra::math::float4 *) &a[0];
         const msra::math::float4 *pb = (const msra::math::float4 *) &b[0];
@@ -425,6 +558,13 @@ public:
         // assert (cols4stride * 4 == cols4.size());     // (passed in one vector with 4 columns stacked on top of each other)
         // assert (row.size() * 4 == cols4.size());  // this assert is no longer appropriate because of further breaking into blocks
 
+#if SSEMATRIX_HAS_AVX2
+        if (hasavx2())
+        {
+            dotprod4_avx2(row, cols4, cols4stride, usij, usijstride, addtoresult, thisscale, weight);
+            return;
+        }
+#endif
         // perform multiple columns in parallel
         const size_t nlong = (row.size() + 3) / 4; // number of SSE elements
 
@@ -775,12 +915,60 @@ public:
         }
     }
 
+#if SSEMATRIX_HAS_AVX2
+    // 8-wide version of addweighted() below, operating on the same long padded vector
+    SSEMATRIX_AVX2_TARGET void addweighted_avx2(float thisweight, const ssematrixbase &other, float weight)
+    {
+        float *pus = p;
+        const float *pother = other.p;
+        const size_t n = colstride * numcols; // total floats incl. column padding (multiple of 4)
+        const size_t n8 = n / 8;
+        const __m256 weight8 = _mm256_set1_ps(weight);
+        if (thisweight == 1.0f)
+        {
+            for (size_t m = 0; m < n8; m++)
+                _mm256_storeu_ps(pus + 8 * m, _mm256_fmadd_ps(_mm256_loadu_ps(pother + 8 * m), weight8, _mm256_loadu_ps(pus + 8 * m)));
+        }
+        else if (thisweight == 0.0f)
+        {
+            for (size_t m = 0; m < n8; m++)
+                _mm256_storeu_ps(pus + 8 * m, _mm256_mul_ps(_mm256_loadu_ps(pother + 8 * m), weight8));
+        }
+        else
+        {
+            const __m256 thisweight8 = _mm256_set1_ps(thisweight);
+            for (size_t m = 0; m < n8; m++)
+                _mm256_storeu_ps(pus + 8 * m, _mm256_fmadd_ps(_mm256_loadu_ps(pother + 8 * m), weight8,
+                                                              _mm256_mul_ps(_mm256_loadu_ps(pus + 8 * m), thisweight8)));
+        }
+        // 4-wide remainder (the padded buffer is a multiple of 4 floats, not necessarily of 8)
+        for (size_t k = 8 * n8; k < n; k += 4)
+        {
+            const __m128 o = _mm_load_ps(pother + k);
+            const __m128 u = _mm_load_ps(pus + k);
+            if (thisweight == 1.0f)
+                _mm_store_ps(pus + k, _mm_add_ps(u, _mm_mul_ps(o, _mm256_castps256_ps128(weight8))));
+            else if (thisweight == 0.0f)
+                _mm_store_ps(pus + k, _mm_mul_ps(o, _mm256_castps256_ps128(weight8)));
+            else
+                _mm_store_ps(pus + k, _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(thisweight)), _mm_mul_ps(o, _mm256_castps256_ps128(weight8))));
+        }
+    }
+#endif
+
     // this = thisweight * this + other * weight
     void addweighted(float thisweight, const ssematrixbase &other, float weight)
     {
         auto &us = *this;
         assert(rows() == other.rows() && cols() == other.cols());
 
+#if SSEMATRIX_HAS_AVX2
+        if (hasavx2())
+        {
+            addweighted_avx2(thisweight, other, weight);
+            return;
+        }
+#endif
         // get data as long vectors
         // ... why do I need to explicitly use operator T ()?
         array_ref<msra::math::float4> us4(us.operator array_ref<msra::math::float4>());
@@ -46,6 +46,7 @@
 #define SET_BINARY_MODE(handle) setmode(handle, _O_BINARY)
 #define SET_TEXT_MODE(handle) setmode(handle, _O_TEXT)
 #else
+#include <fcntl.h> // for posix_fadvise()
 #define SET_BINARY_MODE(handle) ((int) 0)
 #define SET_TEXT_MODE(handle) ((int) 0)
 #endif
@@ -249,6 +250,17 @@ FILE* fopenStdHandle(const _T* mode)
     return f;
 }
 
+// apply the streaming hints requested via the nonstandard 'S' (sequential scan) mode flag
+static void fapplySequentialHints(FILE* f)
+{
+    // If optimized for sequential access, then use large buffer. OK if it fails
+    setvbuf(f, NULL, _IOFBF, LARGE_BUF_SIZE);
+#ifdef __unix__
+    // also widen the kernel readahead window (on Windows the CRT maps 'S' to FILE_FLAG_SEQUENTIAL_SCAN by itself)
+    posix_fadvise(fileno(f), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
 FILE* fopenOrDie(const string& pathname, const char* mode)
 {
     FILE* f = (pathname[0] == '-') ? fopenStdHandle(mode) : fopen(pathname.c_str(), mode);
@@ -257,10 +269,7 @@ FILE* fopenOrDie(const string& pathname, const char* mode)
         RuntimeError("error opening file '%s': %s", pathname.c_str(), strerror(errno));
     }
     if (strchr(mode, 'S'))
-    {
-        // If optimized for sequential access, then use large buffer. OK if it fails
-        setvbuf(f, NULL, _IOFBF, LARGE_BUF_SIZE);
-    }
+        fapplySequentialHints(f);
     return f;
 }
 
@@ -272,13 +281,41 @@ FILE* fopenOrDie(const wstring& pathname, const wchar_t* mode)
         RuntimeError("error opening file '%ls': %s", pathname.c_str(), strerror(errno));
     }
     if (strchr(mode, 'S'))
-    {
-        // If optimized for sequential access, then use large buffer. OK if it fails
-        setvbuf(f, NULL, _IOFBF, LARGE_BUF_SIZE);
-    }
+        fapplySequentialHints(f);
     return f;
 }
 
+// ----------------------------------------------------------------------------
+// fsetbuffer() / fsetuncached() / fdropCachedPages() -- streaming-scan hints
+// ----------------------------------------------------------------------------
+
+void fsetbuffer(FILE* f, size_t size)
+{
+    // buffering is purely a performance knob, so like the 'S' path above this is OK to fail
+    setvbuf(f, NULL, _IOFBF, size);
+}
+
+void fsetuncached(FILE* f)
+{
+#ifdef __unix__
+    posix_fadvise(fileno(f), 0, 0, POSIX_FADV_NOREUSE);
+#else
+    UNUSED(f); // no fopen()-level equivalent of FILE_FLAG_NO_BUFFERING on Windows
+#endif
+}
+
+void fdropCachedPages(FILE* f, uint64_t beg, uint64_t end)
+{
+#ifdef __unix__
+    // length 0 means "to end of file" for posix_fadvise()
+    posix_fadvise(fileno(f), (off_t) beg, (end > beg) ? (off_t) (end - beg) : 0, POSIX_FADV_DONTNEED);
+#else
+    UNUSED(f);
+    UNUSED(beg);
+    UNUSED(end);
+#endif
+}
+
 // ----------------------------------------------------------------------------
 // set mode to binary or text (pass 'b' or 't')
 // ----------------------------------------------------------------------------
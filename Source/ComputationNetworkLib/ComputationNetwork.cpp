@@ -36,15 +36,15 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 // -----------------------------------------------------------------------
 
 template <>
-vector<shared_ptr<Matrix<float>>>& MatrixPool::GetReleasedMatrices<float>()
+vector<MemRequestInfo<float>>& MatrixPool::GetMemRequestInfoVec<float>()
 {
-    return m_releasedFloatMatrices;
+    return m_memRequestInfoFloatVec;
 }
 
 template <>
-vector<shared_ptr<Matrix<double>>>& MatrixPool::GetReleasedMatrices<double>()
+vector<MemRequestInfo<double>>& MatrixPool::GetMemRequestInfoVec<double>()
 {
-    return m_releasedDoubleMatrices;
+    return m_memRequestInfoDoubleVec;
 }
 
 // -----------------------------------------------------------------------
@@ -76,6 +76,7 @@ void ComputationNetwork::ClearNetwork()
     }
 
     m_nameToNodeMap.clear();
+    m_nameToNodeIndex.clear();
 
     m_pMBLayoutOfNetwork->Init(1, 0);
 }
@@ -216,6 +217,7 @@ void ComputationNetwork::ReadPersistableParameters(File& fstream, bool create)
 
     size_t numNodes;
     fstream >> numNodes;
+    m_nameToNodeIndex.reserve(m_nameToNodeIndex.size() + numNodes); // pre-size the lookup index: one rehash instead of log(numNodes) many
 
     // get all node info first
     fstream.GetMarker(FileMarker::fileMarkerBeginSection, L"BNodeList");
@@ -269,6 +271,9 @@ void ComputationNetwork::Read(const wstring& fileName)
     ClearNetwork();
 
     File fstream(fileName, FileOptions::fileOptionsBinary | FileOptions::fileOptionsRead);
+    // Buffer reads in large blocks; together with the bulk matrix transfers this keeps
+    // model loading close to sequential disk bandwidth.
+    fstream.Setvbuf();
 
     ReadPersistableParameters<ElemType>(fstream, true);
 
@@ -15,6 +15,8 @@
 #include "ComputationEnvironment.h"
 
 #include <map>
+#include <unordered_map>
+#include <cwctype>
 #include <string>
 #include <stdexcept>
 #include <list>
@@ -29,6 +31,7 @@
 #include <chrono>
 #include <unordered_map>
 #include <set>
+#include <thread>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -51,11 +54,15 @@ public:
     ComputationNetwork() :
         m_randomSeedOffset(0),
         m_isCompiled(false),
+        m_hasBeenValidated(false),
+        m_fullRevalidationNeeded(false),
         m_areMatricesAllocated(false),
+        m_parameterPrefetchStarted(false),
         m_pMBLayoutOfNetwork(make_shared<MBLayout>(1, 0, L"*")),
         m_environment(make_shared<ComputationEnvironment>())
     {
         //m_pMBLayoutOfNetwork->SetAxisName(L"T");
+        m_nameToNodeIndex.reserve(1024); // pre-size; ReadPersistableParameters() re-reserves once the actual node count is known
     }
 
     ComputationNetwork(DEVICEID_TYPE deviceId) :
@@ -67,11 +74,16 @@ public:
 
     virtual ~ComputationNetwork()
     {
+        if (m_parameterPrefetchThread.joinable())
+            m_parameterPrefetchThread.join();
         ClearNetwork(); // This will explicitly remove all nodes. This is needed to break circular references in loops.
     }
 
     void ClearNetwork();
     void InvalidateCompiledNetwork();
+    // variant that attributes the invalidation to an edited node: the next CompileNetwork()
+    // then only revalidates that node's downstream cone (see ValidateNetwork())
+    void InvalidateCompiledNetwork(const ComputationNodeBasePtr& editedNode);
 
     void SetDeviceId(DEVICEID_TYPE deviceId)
     {
@@ -136,6 +148,26 @@ public:
     // main entry point for backprop
     void Backprop(const ComputationNodeBasePtr rootNode);
 
+    // Register a callback that fires as each learnable parameter's gradient becomes final during Backprop().
+    // Used by distributed training to overlap gradient aggregation with the remaining backward computation.
+    void SetGradientReadyCallback(const std::function<void(const ComputationNodeBasePtr&)>& callback)
+    {
+        m_gradientReadyCallback = callback;
+    }
+    void ClearGradientReadyCallback()
+    {
+        m_gradientReadyCallback = nullptr;
+    }
+
+    // Tag the nodes whose values are kept live across the forward/backward boundary when
+    // activation recomputation (Globals::ShouldRecomputeActivations()) is enabled; everything
+    // between two checkpoints is released after forward and recomputed during Backprop().
+    // Must be called before AllocateAllMatrices(); empty list = pick checkpoints heuristically.
+    void SetRecomputeCheckpointNodes(const std::vector<ComputationNodeBasePtr>& nodes)
+    {
+        m_recomputeCheckpointNodes = nodes;
+    }
+
     template <class NODESET> // version that takes multiple nodes
     void ForwardProp(const NODESET& nodes)
     {
@@ -175,13 +207,22 @@ public:
     void CompileNetwork(); // call this after creation, Load(), and any modification
 
 private:
-    void ValidateNetwork();
+    void ValidateNetwork(bool incrementalRevalidation = false);
     size_t ValidateNodes(list<ComputationNodeBasePtr> nodes, bool isFirstPass, bool isFinalValidationPass);
     bool ValidateNode(ComputationNodeBasePtr node, bool isFinalValidationPass) const;
     void MarkValueNonSharableNodes();
+    std::list<ComputationNodeBasePtr> GatherParameterInducedNodes();
     void ChangeNodeInputs(ComputationNodeBasePtr fromNode, ComputationNodeBasePtr toNode);
 
 private:
+    void FuseElementwiseChains();
+    template <class ElemType>
+    bool TryFuseBinaryUnary(const ComputationNodeBasePtr& outer, const ComputationNodeBasePtr& inner,
+                            ElementWiseOperator binaryOp, ElementWiseOperator unaryOp);
+    template <class ElemType>
+    bool TryConvertTimesNodeToQuantized(const ComputationNodeBasePtr& node, size_t bitShiftA, size_t bitShiftB);
+    template <class ElemType>
+    ComputationNodeBasePtr TryCreateTransferNode(const ComputationNodeBasePtr& producer, DEVICEID_TYPE deviceId, const std::wstring& name);
     void DetermineSetOfAllRoots();
     void CollectInputAndLearnableParameters(const ComputationNodeBasePtr& rootNode);
     void CollectInputAndLearnableParametersRec(const ComputationNodeBasePtr& node, set<ComputationNodeBasePtr>& visited, list<ComputationNodeBasePtr>& inputs, list<ComputationNodeBasePtr>& learnableParameters);
@@ -394,6 +435,7 @@ public:
 
     ComputationNodeBasePtr CopyNode(const ComputationNetwork& fromNet, const std::wstring fromName, std::wstring toName, const CopyNodeFlags flags);
     void CopySubTree(const ComputationNetwork& fromNet, const std::wstring fromName, std::wstring toNamePrefix, const CopyNodeFlags flags);
+    ComputationNetworkPtr CreateSharedParameterClone() const; // evaluation-only clone that aliases this network's parameter values
     void CopyInputs(const std::wstring fromName, std::wstring toName);
     void RenameNode(const std::wstring& nodeNameOrig, const std::wstring& nodeNameNew);
     void RenameNode(ComputationNodeBasePtr node, const std::wstring& newNodeName);
@@ -405,6 +447,8 @@ public:
     void AddFeatureNode(ComputationNodeBasePtr featureNode);
     //ComputationNodeBasePtr RemoveFeatureNode(ComputationNodeBasePtr featureNode);
     void SetLearnableNodesBelowLearningRateMultiplier(const float learningRateMultiplier, const ComputationNodeBasePtr& rootNode = nullptr);
+    size_t ConvertTimesNodesToQuantizedTimes(size_t bitShiftA = 1, size_t bitShiftB = 1);
+    void PartitionIntoPipelineStages(const std::vector<DEVICEID_TYPE>& stageDevices);
 
     // -----------------------------------------------------------------------
     // node access
@@ -412,14 +456,14 @@ public:
 
     bool NodeNameExists(const std::wstring& name) const
     {
-        auto iter = m_nameToNodeMap.find(name);
-        return (iter != m_nameToNodeMap.end());
+        auto iter = m_nameToNodeIndex.find(name);
+        return (iter != m_nameToNodeIndex.end());
     }
 
     ComputationNodeBasePtr GetNodeFromName(const std::wstring& name) const
     {
-        auto iter = m_nameToNodeMap.find(name);
-        if (iter == m_nameToNodeMap.end())
+        auto iter = m_nameToNodeIndex.find(name);
+        if (iter == m_nameToNodeIndex.end())
             RuntimeError("GetNodeFromName: Network has no node named '%ls'.", name.c_str());
         return iter->second;
     }
@@ -809,6 +853,7 @@ public:
         auto result = m_nameToNodeMap.insert(make_pair(node->NodeName(), node));
         if (!result.second)
             RuntimeError("AddNodeToNet: Duplicated name for %ls %ls operation.", node->NodeName().c_str(), node->OperationName().c_str());
+        m_nameToNodeIndex[node->NodeName()] = node;
         node->SetEnvironment(m_environment);
         return node; // allows e.g. return AddNodeToNet(New...);
     }
@@ -844,6 +889,8 @@ public:
             node->SetName(L"_" + node->NodeName());
             result = m_nameToNodeMap.insert(make_pair(node->NodeName(), node));
         }
+        if (result.second)
+            m_nameToNodeIndex[node->NodeName()] = node;
         node->SetEnvironment(m_environment); // (note: redundant if already part of the network)
         return result.second;
     }
@@ -856,6 +903,7 @@ public:
     {
         node->SetEnvironment(nullptr);
         m_nameToNodeMap.erase(node->NodeName());
+        m_nameToNodeIndex.erase(node->NodeName());
         return node;
     }
 public:
@@ -984,6 +1032,63 @@ public:
         }
     }
 
+    // -----------------------------------------------------------------------
+    // node profiling
+    // -----------------------------------------------------------------------
+
+    // Dump the per-node statistics collected while node profiling (Globals::SetNodeProfiling())
+    // was enabled: cumulative forward/backward time with invocation counts, plus the peak value
+    // and gradient matrix sizes observed after each pass. Nodes are sorted by total time, so the
+    // first lines answer "where does the time go" without bisecting the model by hand.
+    // On GPU devices the times are host-side dispatch times unless the performance profiler's
+    // syncGpu mode keeps the device drained.
+    void DumpProfile(const std::wstring& outputFile)
+    {
+        File fstream(outputFile,
+                     FileOptions::fileOptionsText | FileOptions::fileOptionsWrite);
+        DumpProfile(fstream);
+    }
+
+    void DumpProfile(File& fstream)
+    {
+        std::vector<ComputationNodeBasePtr> nodes;
+        for (const auto& iter : m_nameToNodeMap)
+            if (iter.second->ProfForwardCalls() > 0 || iter.second->ProfBackwardCalls() > 0)
+                nodes.push_back(iter.second);
+        std::sort(nodes.begin(), nodes.end(),
+                  [](const ComputationNodeBasePtr& a, const ComputationNodeBasePtr& b)
+                  {
+                      return a->ProfForwardSeconds() + a->ProfBackwardSeconds() >
+                             b->ProfForwardSeconds() + b->ProfBackwardSeconds();
+                  });
+
+        double totalSeconds = 0;
+        for (const auto& node : nodes)
+            totalSeconds += node->ProfForwardSeconds() + node->ProfBackwardSeconds();
+
+        fstream << msra::strfun::wstrprintf(L"%7ls %12ls %8ls %12ls %8ls %12ls %12ls  %ls\n",
+                                            L"time%", L"fwd ms", L"fwd #", L"bwd ms", L"bwd #",
+                                            L"peak val MB", L"peak grad MB", L"node");
+        for (const auto& node : nodes)
+        {
+            double nodeSeconds = node->ProfForwardSeconds() + node->ProfBackwardSeconds();
+            fstream << msra::strfun::wstrprintf(L"%6.2f%% %12.3f %8d %12.3f %8d %12.3f %12.3f  %ls (%ls)\n",
+                                                totalSeconds > 0 ? 100.0 * nodeSeconds / totalSeconds : 0.0,
+                                                1000.0 * node->ProfForwardSeconds(), (int) node->ProfForwardCalls(),
+                                                1000.0 * node->ProfBackwardSeconds(), (int) node->ProfBackwardCalls(),
+                                                node->ProfPeakValueBytes() / (1024.0 * 1024.0),
+                                                node->ProfPeakGradientBytes() / (1024.0 * 1024.0),
+                                                node->NodeName().c_str(), node->OperationName().c_str());
+        }
+    }
+
+    // clear the accumulated statistics, e.g. to exclude warm-up minibatches from the report
+    void ResetProfilingStats()
+    {
+        for (const auto& iter : m_nameToNodeMap)
+            iter.second->ResetProfilingStats();
+    }
+
     // -----------------------------------------------------------------------
     // topological plot [1/13/2015 erw] plot network topology using dot language
     // -----------------------------------------------------------------------
@@ -1070,6 +1175,12 @@ protected:
         {
             SetNodeName(L"Loop_" + m_sourceNode->NodeName());
         }
+
+    private:
+        // per time step of the current minibatch: whether any column holds sequence data;
+        // steps that are all gaps are skipped entirely by ForwardProp()/Backprop().
+        // Empty when every step has data (the common case), so no per-step test is needed.
+        std::vector<bool> m_stepHasData;
     };
 
     // -----------------------------------------------------------------------
@@ -1117,11 +1228,42 @@ protected:
         virtual void RequestMatricesBeforeBackprop(MatrixPool& matrixPool);
         virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool);
 
+        // fired after each nested node completes its backprop step; used to overlap gradient aggregation with backprop
+        void SetNodeBackpropCompleteCallback(const std::function<void(const ComputationNodeBasePtr&)>& callback)
+        {
+            m_nodeBackpropCompleteCallback = callback;
+        }
+
+        // fired before each nested node begins its backprop step; used by activation
+        // recomputation to re-run the forward segment whose values this node needs
+        void SetNodeBackpropStartCallback(const std::function<void(const ComputationNodeBasePtr&)>& callback)
+        {
+            m_nodeBackpropStartCallback = callback;
+        }
+
     public:
         // this special constructor constructs the top-level network node
         // There is currently no other constructor for inner nested PAR-traversed sub-networks, but there will be.
         PARTraversalFlowControlNode(const std::vector<shared_ptr<SEQTraversalFlowControlNode>>& recurrentInfo, const std::list<ComputationNodeBasePtr>& allNodes);
         // Base::m_nestedNodes contains all top-level nodes, in evaluation order
+
+    private:
+        // Stream schedule for stream-parallel forward execution (Globals::ShouldEnableStreamParallelForward()).
+        // Computed once in the constructor from the input edges of m_nestedNodes.
+        std::vector<int> m_nodeStream;                      // stream index per nested node; -1 = leaf/no compute, run wherever
+        std::vector<std::vector<size_t>> m_crossStreamDeps; // per node: indices of producers on other streams to wait for
+        std::vector<bool> m_nodeRecordsEvent;               // whether some consumer on another stream waits on this node
+        size_t m_numStreamsUsed = 0;                        // number of distinct pool streams in the schedule
+
+        // Dependency levels for task-parallel CPU forward execution (Globals::ShouldEnableParallelCpuForward()).
+        // Nodes within one level only depend on earlier levels and can run concurrently.
+        // Empty when there is no branch parallelism to exploit or nodes are not CPU-resident.
+        std::vector<std::vector<size_t>> m_parLevels; // per level: indices into m_nestedNodes
+        void ForwardPropTaskParallel(const FrameRange& fr);
+        void ForwardPropNode(const ComputationNodeBasePtr& node, const FrameRange& fr);
+
+        std::function<void(const ComputationNodeBasePtr&)> m_nodeBackpropCompleteCallback;
+        std::function<void(const ComputationNodeBasePtr&)> m_nodeBackpropStartCallback;
     };
 
 public:
@@ -1145,6 +1287,30 @@ private:
     // main node holder
     std::map<const std::wstring, ComputationNodeBasePtr, nocase_compare> m_nameToNodeMap; // [name] -> node; this is the main container that holds this networks' nodes
 
+    // Hash index over m_nameToNodeMap for O(1) name resolution, which big NDL/MEL builds hit
+    // once per edge. The sorted map above remains the canonical holder (serialization and the
+    // dump functions iterate it in name order); this index only serves the find path and is
+    // kept in sync by AddNodeToNet()/AddNodeToNetIfNotYet()/RemoveNodeFromNet()/ClearNetwork().
+    // Hash and equality fold case to match the nocase_compare semantics of the map.
+    struct CaseInsensitiveNameHash
+    {
+        size_t operator()(const std::wstring& s) const
+        {
+            size_t hash = (size_t) 14695981039346656037ULL; // FNV-1a over the lowercased characters
+            for (wchar_t c : s)
+                hash = (hash ^ (size_t) towlower(c)) * (size_t) 1099511628211ULL;
+            return hash;
+        }
+    };
+    struct CaseInsensitiveNameEqual
+    {
+        bool operator()(const std::wstring& a, const std::wstring& b) const
+        {
+            return EqualCI(a, b);
+        }
+    };
+    std::unordered_map<std::wstring, ComputationNodeBasePtr, CaseInsensitiveNameHash, CaseInsensitiveNameEqual> m_nameToNodeIndex;
+
     // node groups
     // These are specified by the user by means of tags or explicitly listing the node groups.
     // TODO: Are these meant to be disjoint?
@@ -1183,6 +1349,13 @@ private:
     bool m_isCompiled; // CompileNetwork has been called
     bool m_areMatricesAllocated; // AllocateAllMatrices has been called
 
+    // incremental-revalidation bookkeeping: nodes that editing operations attributed their
+    // changes to since the last completed compilation. When every invalidation since then was
+    // attributed, ValidateNetwork() only revisits these nodes' downstream cone.
+    std::set<ComputationNodeBasePtr> m_editedNodes;
+    bool m_hasBeenValidated;      // a compilation including full validation has completed before
+    bool m_fullRevalidationNeeded; // an unattributed InvalidateCompiledNetwork() has occurred
+
     // cached network iterations
     std::map<const ComputationNodeBasePtr, std::list<ComputationNodeBasePtr>> m_evalOrders; // [out node] flat depth-first traversal starting from out node
     std::map<const ComputationNodeBasePtr, ComputationNodeBasePtr> m_nestedNetworks;        // [out node] network rewritten as recursive traveral, potentially optimized; execution plan
@@ -1191,6 +1364,25 @@ private:
     std::map<const ComputationNodeBasePtr, std::list<ComputationNodeBasePtr>> m_inputValues;         // [out node] -> all input nodes feeding into out node
     std::map<const ComputationNodeBasePtr, std::list<ComputationNodeBasePtr>> m_learnableParameters; // [out node] -> all parameter nodes feeding into out node
 
+    // fired per learnable parameter as its gradient becomes final during Backprop(); see SetGradientReadyCallback()
+    std::function<void(const ComputationNodeBasePtr&)> m_gradientReadyCallback;
+
+    // background thread that warms lazily-loaded parameter values (lazyParameterLoad); started on first ForwardProp()
+    std::thread m_parameterPrefetchThread;
+    bool m_parameterPrefetchStarted;
+
+    // parameter-induced nodes whose values were left sharable by inference-only compilation
+    // (optimizeForInference); ForwardProp() re-marks these outdated before every evaluation since
+    // their buffers may have been reused once released back to the pool
+    std::list<ComputationNodeBasePtr> m_inferenceRecomputeNodes;
+
+    // checkpoint nodes for activation recomputation (recomputeActivations), as tagged by the
+    // user via SetRecomputeCheckpointNodes(); empty = pick checkpoints heuristically
+    std::vector<ComputationNodeBasePtr> m_recomputeCheckpointNodes;
+    // [checkpoint node] -> nodes (in eval order) whose values were released after forward and
+    // must be recomputed just before the checkpoint's backprop step; built in AllocateAllMatrices()
+    std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> m_recomputeSegments;
+
 private:
     // pool for matrices that can be shared across nodes
     // TODO: does this apply to anything else besides temporary node-internal intermediate results? What, for example?
@@ -9,10 +9,14 @@
 #include "ComputationNode.h"
 #include "ComputationNetwork.h"
 #include "InputAndParamNodes.h"
+#include "LinearAlgebraNodes.h"
+#include "SpecialPurposeNodes.h"
 #include "TrainingNodes.h"
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
 
 using namespace std;
 
@@ -29,8 +33,6 @@ ComputationNodeBasePtr ComputationNetwork::CopyNode(const ComputationNetwork& fr
                                                     std::wstring toName,
                                                     const CopyNodeFlags flags)
 {
-    InvalidateCompiledNetwork();
-
     if (toName == L"")
         toName = fromName;
 
@@ -47,6 +49,7 @@ ComputationNodeBasePtr ComputationNetwork::CopyNode(const ComputationNetwork& fr
     if (!NodeNameExists(toName))
     {
         pToNode = pFromNode->Duplicate(toName, flags);
+        InvalidateCompiledNetwork(pToNode);
         AddNodeToNet(pToNode);
     }
     else
@@ -57,8 +60,9 @@ ComputationNodeBasePtr ComputationNetwork::CopyNode(const ComputationNetwork& fr
         // same node. no copy needed
         if (pFromNode == pToNode)
             LogicError("CopyNode: You are copying the node to the same network with same node name.");
-        else
-            pFromNode->CopyTo(pToNode, toName, flags); // blast it over the existing node
+
+        InvalidateCompiledNetwork(pToNode);
+        pFromNode->CopyTo(pToNode, toName, flags); // blast it over the existing node
     }
     return pToNode;
 }
@@ -97,6 +101,61 @@ void ComputationNetwork::CopySubTree(const ComputationNetwork& fromNet,
     }
 }
 
+// helper for CreateSharedParameterClone() below: make 'to' alias the value matrix of 'from'
+// Returns false if 'from' is not a ComputationNode<ElemType>, so callers can try both precisions.
+template <class ElemType>
+static bool ShareParameterValue(const ComputationNodeBasePtr& from, const ComputationNodeBasePtr& to)
+{
+    auto fromNode = dynamic_pointer_cast<ComputationNode<ElemType>>(from);
+    if (!fromNode)
+        return false;
+    dynamic_pointer_cast<ComputationNode<ElemType>>(to)->ShareValueMatrixWith(*fromNode);
+    return true;
+}
+
+// create a structural clone of this network that shares this network's parameter values
+// All nodes are duplicated, so the clone owns its own activation buffers, minibatch layouts, and
+// evaluation state, and can run ForwardProp() concurrently with the original; but the value
+// matrices of LearnableParameters are aliased rather than copied, so N clones keep a single copy
+// of the model weights. The clone is for evaluation only: updating parameters through any of the
+// clones would silently update all of them. The caller must CompileNetwork() the clone (e.g. via
+// StartEvaluateMinibatchLoop()) before use.
+ComputationNetworkPtr ComputationNetwork::CreateSharedParameterClone() const
+{
+    auto clone = make_shared<ComputationNetwork>(m_deviceId);
+
+    // duplicate all nodes; for parameters, replace the duplicated value by an alias of the original
+    for (const auto& entry : m_nameToNodeMap)
+    {
+        const auto& node = entry.second;
+        auto dup = node->Duplicate(node->NodeName(), CopyNodeFlags::copyNodeValue);
+        if (node->OperationName() == OperationNameOf(LearnableParameter))
+        {
+            if (!ShareParameterValue<float>(node, dup) && !ShareParameterValue<double>(node, dup))
+                LogicError("CreateSharedParameterClone: %ls %ls operation is neither <float> nor <double>.", node->NodeName().c_str(), node->OperationName().c_str());
+        }
+        clone->AddNodeToNet(dup);
+    }
+
+    // fix up the input links to point to the cloned nodes
+    for (const auto& entry : m_nameToNodeMap)
+    {
+        const auto& node = entry.second;
+        auto dup = clone->GetNodeFromName(node->NodeName());
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+            dup->SetInput(i, clone->GetNodeFromName(node->GetInputs()[i]->NodeName()));
+    }
+
+    // replicate the node groups (features, labels, criteria, evaluation, outputs)
+    auto fromGroups = const_cast<ComputationNetwork*>(this)->GetAllNodeGroups();
+    auto toGroups = clone->GetAllNodeGroups();
+    for (size_t i = 0; i < fromGroups.size(); i++)
+        for (const auto& node : *fromGroups[i])
+            toGroups[i]->push_back(clone->GetNodeFromName(node->NodeName()));
+
+    return clone;
+}
+
 // you can only copy inputs from nodes in the same network
 void ComputationNetwork::CopyInputs(const std::wstring fromName, std::wstring toName)
 {
@@ -118,7 +177,7 @@ void ComputationNetwork::RenameNode(ComputationNodeBasePtr node, const std::wstr
     if (iter != m_nameToNodeMap.end()) // found
         RuntimeError("RenameNode: Target name already exists.");
 
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(node);
 
     RemoveNodeFromNet(node);        // take it out remporarily
     node->SetNodeName(newNodeName); // change the name
@@ -128,10 +187,10 @@ void ComputationNetwork::RenameNode(ComputationNodeBasePtr node, const std::wstr
 // deletes a node from the network including setting all input links to it to null, and removing it from the node groups
 void ComputationNetwork::DeleteNode(const std::wstring& nodeName)
 {
-    InvalidateCompiledNetwork();
-
     ComputationNodeBasePtr nodeToDelete = GetNodeFromName(nodeName);
 
+    InvalidateCompiledNetwork(nullptr); // parents of the deleted node get attributed below
+
     // first delete links, if this node is involved, the whole connection will be removed
     for (auto nodeIter = m_nameToNodeMap.begin(); nodeIter != m_nameToNodeMap.end(); nodeIter++)
     {
@@ -145,6 +204,7 @@ void ComputationNetwork::DeleteNode(const std::wstring& nodeName)
             {
                 // this used to call DetatchInputs(), but it's better for MEL to retain other inputs
                 node->SetInput(i, nullptr);
+                InvalidateCompiledNetwork(node); // the former parent is where the edit surfaces
                 break;
             }
         }
@@ -179,7 +239,7 @@ void ComputationNetwork::ReplaceNode(wstring nodeName, ComputationNodeBasePtr ne
     if (newNode->NodeName() != nodeName) // TODO: This was not tested for earlier; I hope no code depends on this.
         InvalidArgument("ChangeNode: newNode must have the same name as the old node.");
 
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(newNode);
 
     // change all nodes that have old node as input to point to the new node instead
     ChangeNodeInputs(oldNode, newNode);
@@ -213,7 +273,7 @@ void ComputationNetwork::InsertNode(wstring inputNodeName, ComputationNodeBasePt
 
     ComputationNodeBasePtr inputNode = GetNodeFromName(inputNodeName);
 
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(newNode);
 
     // change all nodes that have old node as input to point to the new node instead
     ChangeNodeInputs(inputNode, newNode);
@@ -248,7 +308,7 @@ void ComputationNetwork::ChangeNodeInputs(ComputationNodeBasePtr fromNode, Compu
 // BUGBUG: Or what if an unrelated node of the same name exists?
 void ComputationNetwork::ReplaceLeafNode(wstring oldNodeName, ComputationNodeBasePtr newNode)
 {
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(newNode);
 
     ComputationNodeBasePtr oldNode = GetNodeFromName(oldNodeName);
 
@@ -271,7 +331,7 @@ void ComputationNetwork::ReplaceLeafNode(wstring oldNodeName, ComputationNodeBas
 // BUGBUG: Can this operate on both new and existing nodes?
 void ComputationNetwork::ReplaceFinalCriterionNode(wstring oldNodeName, ComputationNodeBasePtr newNode)
 {
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(newNode);
 
     // remove old criterion node
     // BUGBUG: The old node is not removed from the network. Seems strangely inconsistent.
@@ -298,7 +358,7 @@ void ComputationNetwork::ReplaceFinalCriterionNode(wstring oldNodeName, Computat
 
 void ComputationNetwork::AddFeatureNode(ComputationNodeBasePtr featureNode)
 {
-    InvalidateCompiledNetwork();
+    InvalidateCompiledNetwork(featureNode);
 
     AddNodeToNet(featureNode);
     AddToNodeGroup(L"feature", featureNode);
@@ -367,4 +427,186 @@ void ComputationNetwork::SetLearnableNodesBelowLearningRateMultiplier(const floa
     }
 }
 
+// convert one Times node to its fixed-point equivalent if the conversion is safe
+// A node is eligible if it runs on the CPU and its left operand is a LearnableParameter,
+// i.e. the common weight-times-activation case where the quantized copy of the weight can
+// be cached across minibatches. Layers whose weight range is hostile to symmetric
+// quantization (a few outliers dwarfing the typical magnitude, which would round most
+// entries towards zero) are left in floating point.
+template <class ElemType>
+bool ComputationNetwork::TryConvertTimesNodeToQuantized(const ComputationNodeBasePtr& node, size_t bitShiftA, size_t bitShiftB)
+{
+    auto timesNode = dynamic_pointer_cast<TimesNode<ElemType>>(node);
+    if (!timesNode)
+        return false;
+
+    auto weightNode = dynamic_pointer_cast<LearnableParameter<ElemType>>(node->GetInputs()[0]);
+    if (!weightNode)
+        return false;
+
+    const auto& W = weightNode->Value();
+    if (W.GetDeviceId() != CPUDEVICE) // the block multiplier runs on the CPU only
+        return false;
+    size_t numElements = W.GetNumElements();
+    if (numElements == 0 || W.GetMatrixType() == SPARSE) // the quantized product handles dense matrices only
+        return false;
+
+    ElemType absMax = W.MatrixNormInf();
+    if (absMax == 0) // degenerate (all-zero) weight; nothing to gain
+        return false;
+    ElemType rms = (ElemType) (W.FrobeniusNorm() / sqrt((double) numElements));
+    const ElemType maxRangeRatio = 256; // beyond this, fewer than ~7 of the 15 significand bits cover typical values
+    if (absMax / rms > maxRangeRatio)
+    {
+        fprintf(stderr, "ConvertTimesNodesToQuantizedTimes: keeping %ls in floating point, weight range is hostile to quantization (absmax/rms = %.1f)\n",
+                node->NodeName().c_str(), (double) (absMax / rms));
+        return false;
+    }
+
+    auto quantizedNode = make_shared<QuantizedTimesNode<ElemType>>(W.GetDeviceId(), timesNode->NodeName(), bitShiftA, bitShiftB,
+                                                                   timesNode->OutputRank(), timesNode->InferInputRankToMap());
+    ReplaceNode(timesNode->NodeName(), quantizedNode);
+    return true;
+}
+
+// replace every eligible Times node in the network with a QuantizedTimesNode, so that a
+// trained model can be served with int16 fixed-point matrix products without hand-editing
+// the model description (see the QuantizedTimesNode comment for the per-node Edit recipe).
+// Activation ranges need no offline calibration pass: the symmetric quantizers re-range the
+// non-constant operand on every call, only the constant (weight) side is quantized once.
+// Returns the number of nodes converted.
+size_t ComputationNetwork::ConvertTimesNodesToQuantizedTimes(size_t bitShiftA, size_t bitShiftB)
+{
+    InvalidateCompiledNetwork();
+
+    // operate on a snapshot since ReplaceNode() rewrites m_nameToNodeMap
+    std::vector<ComputationNodeBasePtr> allNodes;
+    for (const auto& iter : m_nameToNodeMap)
+        allNodes.push_back(iter.second);
+
+    size_t numConverted = 0;
+    size_t numTimesNodes = 0;
+    for (const auto& node : allNodes)
+    {
+        if (node->OperationName() != OperationNameOf(TimesNode))
+            continue;
+        numTimesNodes++;
+        if (TryConvertTimesNodeToQuantized<float>(node, bitShiftA, bitShiftB) ||
+            TryConvertTimesNodeToQuantized<double>(node, bitShiftA, bitShiftB))
+            numConverted++;
+    }
+
+    if (numTimesNodes > 0)
+        fprintf(stderr, "ConvertTimesNodesToQuantizedTimes: converted %d of %d Times nodes to QuantizedTimes\n",
+                (int) numConverted, (int) numTimesNodes);
+    return numConverted;
+}
+
+// helper for PartitionIntoPipelineStages() below: splice a TransferToDeviceNode of the
+// producer's element type between 'producer' and its consumers on 'deviceId'
+// Returns nullptr if 'producer' is not a ComputationNode<ElemType>, so callers can try both precisions.
+template <class ElemType>
+ComputationNodeBasePtr ComputationNetwork::TryCreateTransferNode(const ComputationNodeBasePtr& producer, DEVICEID_TYPE deviceId, const std::wstring& name)
+{
+    if (!dynamic_pointer_cast<ComputationNode<ElemType>>(producer))
+        return nullptr;
+
+    auto transferNode = make_shared<TransferToDeviceNode<ElemType>>(deviceId, name);
+    AddNodeToNet(transferNode);
+    transferNode->AttachInputs({ producer });
+    return transferNode;
+}
+
+// distribute the network over multiple devices as a chain of pipeline stages, so that a
+// model too large for a single GPU's memory can still be trained and evaluated
+// The global evaluation order is split into stageDevices.size() contiguous segments of
+// roughly equal activation volume; segment k is re-homed onto stageDevices[k], and a
+// TransferToDeviceNode is spliced into every edge that crosses a stage boundary (one per
+// producer and consumer device, so fan-out into a stage transfers only once). Recurrent
+// loops are never split across stages. Leaf nodes (parameters and inputs) are placed on
+// the stage of their first consumer rather than by traversal position, so that weights
+// do not travel between devices on every minibatch.
+// Stages still execute one after another within a minibatch; this trades transfer time
+// at the (few) stage boundaries for the ability to hold the model at all.
+void ComputationNetwork::PartitionIntoPipelineStages(const std::vector<DEVICEID_TYPE>& stageDevices)
+{
+    size_t numStages = stageDevices.size();
+    if (numStages < 2)
+        InvalidArgument("PartitionIntoPipelineStages: at least two stage devices are required.");
+
+    // the split needs validated sample layouts and loop membership
+    VerifyIsCompiled("PartitionIntoPipelineStages");
+
+    // snapshot the global evaluation order before editing invalidates it
+    std::vector<ComputationNodeBasePtr> evalOrder(GetEvalOrder(nullptr).begin(), GetEvalOrder(nullptr).end());
+
+    InvalidateCompiledNetwork();
+
+    double totalWeight = 0;
+    for (const auto& node : evalOrder)
+        totalWeight += (double) node->GetSampleLayout().GetNumElements();
+
+    // assign contiguous segments of the traversal to stages, advancing once a stage holds
+    // its share of the total activation volume, but never in the middle of a loop
+    std::map<ComputationNodeBasePtr, size_t> stageOfNode;
+    size_t stage = 0;
+    double accumulatedWeight = 0;
+    for (const auto& node : evalOrder)
+    {
+        accumulatedWeight += (double) node->GetSampleLayout().GetNumElements();
+        stageOfNode[node] = stage;
+        if (stage + 1 < numStages && !node->IsPartOfLoop() &&
+            accumulatedWeight >= (stage + 1) * totalWeight / numStages)
+            stage++;
+    }
+
+    // leaves follow their first consumer instead of their traversal position
+    // (stages are non-decreasing along the traversal, so the first consumer is the earliest one)
+    std::set<ComputationNodeBasePtr> reassignedLeaves;
+    for (const auto& node : evalOrder)
+        for (const auto& input : node->GetInputs())
+            if (input->GetNumInputs() == 0 && reassignedLeaves.insert(input).second)
+                stageOfNode[input] = stageOfNode[node];
+
+    std::vector<size_t> numNodesPerStage(numStages, 0);
+    for (const auto& node : evalOrder)
+    {
+        size_t nodeStage = stageOfNode[node];
+        numNodesPerStage[nodeStage]++;
+        if (node->GetDeviceId() != stageDevices[nodeStage])
+            node->MoveToDevice(stageDevices[nodeStage]);
+    }
+
+    // splice a transfer node into every edge that crosses a stage boundary
+    std::map<std::pair<ComputationNodeBasePtr, DEVICEID_TYPE>, ComputationNodeBasePtr> transferNodes;
+    for (const auto& node : evalOrder)
+    {
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+        {
+            const auto& input = node->GetInputs()[i];
+            if (input->GetDeviceId() == node->GetDeviceId())
+                continue;
+            auto key = std::make_pair(input, node->GetDeviceId());
+            auto iter = transferNodes.find(key);
+            if (iter == transferNodes.end())
+            {
+                std::wstring name = input->NodeName() + L".PipelineTransfer" + std::to_wstring((int) node->GetDeviceId());
+                auto transferNode = TryCreateTransferNode<float>(input, node->GetDeviceId(), name);
+                if (!transferNode)
+                    transferNode = TryCreateTransferNode<double>(input, node->GetDeviceId(), name);
+                if (!transferNode)
+                    LogicError("PartitionIntoPipelineStages: unexpected precision for %ls %ls operation.",
+                               input->NodeName().c_str(), input->OperationName().c_str());
+                iter = transferNodes.insert(std::make_pair(key, transferNode)).first;
+            }
+            node->SetInput(i, iter->second);
+        }
+    }
+
+    fprintf(stderr, "PartitionIntoPipelineStages: %d stages,", (int) numStages);
+    for (size_t k = 0; k < numStages; k++)
+        fprintf(stderr, "%s %d nodes on device[%d]", (k == 0) ? "" : ";", (int) numNodesPerStage[k], (int) stageDevices[k]);
+    fprintf(stderr, "; %d transfer nodes inserted\n", (int) transferNodes.size());
+}
+
 }}}
@@ -6,17 +6,25 @@
 #define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
 
 #include "Basics.h"
+#include "Globals.h"
 #include "ComputationNode.h"
 #include "ComputationNetwork.h"
 #include "RecurrentNodes.h"
 #include "InputAndParamNodes.h"
 #include "LinearAlgebraNodes.h"
+#include "NonlinearityNodes.h"
+#include "TrainingNodes.h" // for IRngUser, to exclude stochastic nodes from activation recomputation
+#include "TimerUtility.h"  // for Clock, to time per-node execution when node profiling is on
 #include <string>
 #include <vector>
 #include <list>
 #include <set>
 #include <algorithm>
 #include <map>
+#include <thread>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -28,6 +36,21 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 // forward and backward propagation
 // -----------------------------------------------------------------------
 
+// helpers for per-node profiling (Globals::ShouldEnableNodeProfiling()): bracket a node's
+// forward/backward dispatch with time stamps and accumulate the elapsed time on the node itself,
+// for later reporting by ComputationNetwork::DumpProfile(). A zero begin stamp means "off", so
+// disabled runs pay only the flag test. Note that on GPU devices these are host-side dispatch
+// times; they only reflect true kernel times when the device is kept drained (e.g. the
+// performance profiler's syncGpu mode).
+static inline long long NodeProfilingBegin()
+{
+    return Globals::ShouldEnableNodeProfiling() ? Clock::GetTimeStamp() : 0;
+}
+static inline double NodeProfilingElapsedSeconds(long long beginStamp)
+{
+    return (double) (Clock::GetTimeStamp() - beginStamp) / (double) Clock::GetTicksPerSecond();
+}
+
 // MAIN ENTRY POINT for evaluating one minibatch (forward prop)
 // This calls ForwardProp() on all nodes in order of data flow through the network.
 // By default, the network is applied concurrently on all frames in a minibatch in parallel (PAR mode, a "map" operation)
@@ -40,6 +63,34 @@ void ComputationNetwork::ForwardProp(const ComputationNodeBasePtr rootNode)
 {
     VerifyIsCompiled("ForwardProp");
 
+    // On the first forward pass with lazy parameter loading, start a background thread that warms
+    // the deferred parameter values in eval order, so that fault-ins overlap with computation
+    // instead of serializing on first touch. The per-node fault-in during traversal remains the
+    // correctness guarantee; this thread is only a warmer.
+    if (Globals::ShouldLazyLoadParameters() && !m_parameterPrefetchStarted)
+    {
+        m_parameterPrefetchStarted = true;
+        std::vector<ComputationNodeBasePtr> nodes(GetEvalOrder(rootNode).begin(), GetEvalOrder(rootNode).end());
+        m_parameterPrefetchThread = std::thread([nodes]()
+        {
+            try
+            {
+                for (const auto& node : nodes)
+                    node->EnsureValueIsLoaded();
+            }
+            catch (const std::exception& e)
+            {
+                // not fatal: anything left deferred is retried (and any error surfaced) on first touch
+                fprintf(stderr, "WARNING: background parameter prefetch failed: %s\n", e.what());
+            }
+        });
+    }
+
+    // Values left sharable by inference-only compilation may have been overwritten since the
+    // last pass; mark them outdated so the timestamp check recomputes rather than reuses them.
+    for (auto& node : m_inferenceRecomputeNodes)
+        node->SetEvalTimeStampOutdatedWrtAll();
+
     // traverse all nodes in the pre-determined evaluation order
     GetNestedNetwork(rootNode)->ForwardProp(FrameRange(nullptr));
 }
@@ -76,8 +127,80 @@ void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // trai
     // reset all gradients below rootNode to zero (actually, internally, this is lazy, but we don't care here)
     ZeroInputGradients(rootNode);
 
+    auto nestedNetwork = GetNestedNetwork(rootNode);
+
+    // When a gradient-ready callback is registered, fire it for each learnable parameter as soon as its
+    // last consumer has completed backprop, so that e.g. distributed gradient aggregation can overlap
+    // with the remaining backward computation.
+    shared_ptr<PARTraversalFlowControlNode> parNode;
+    if (m_gradientReadyCallback || !m_recomputeSegments.empty())
+        parNode = dynamic_pointer_cast<PARTraversalFlowControlNode>(nestedNetwork);
+    if (parNode && m_gradientReadyCallback)
+    {
+        // count, per learnable parameter, how many consumers still have to backprop into it
+        auto remainingConsumers = make_shared<std::map<ComputationNodeBase*, size_t>>();
+        for (const auto& node : GetEvalOrder(rootNode))
+        {
+            if (!node->NeedsGradient())
+                continue;
+            for (const auto& input : node->GetInputs())
+                if (input->IsParameterUpdateRequired())
+                    (*remainingConsumers)[input.get()]++;
+        }
+        auto gradientReadyCallback = m_gradientReadyCallback;
+        parNode->SetNodeBackpropCompleteCallback([remainingConsumers, gradientReadyCallback](const ComputationNodeBasePtr& completedNode)
+        {
+            // a recurrent loop completes as a single entry; expand it into its member nodes
+            std::vector<ComputationNodeBasePtr> completedNodes;
+            auto seqNode = dynamic_pointer_cast<SEQTraversalFlowControlNode>(completedNode);
+            if (seqNode)
+                completedNodes = seqNode->m_nestedNodes;
+            else
+                completedNodes.push_back(completedNode);
+            for (const auto& node : completedNodes)
+            {
+                if (!node->NeedsGradient())
+                    continue;
+                for (const auto& input : node->GetInputs())
+                {
+                    if (!input->IsParameterUpdateRequired())
+                        continue;
+                    auto iter = remainingConsumers->find(input.get());
+                    if (iter != remainingConsumers->end() && --(iter->second) == 0)
+                        gradientReadyCallback(input);
+                }
+            }
+        });
+    }
+
+    // With activation recomputation, the values between checkpoint nodes were released after the
+    // forward pass; re-run each forward segment just before its checkpoint's backprop step, so
+    // that the backprop steps above the next checkpoint find the input values they need.
+    if (parNode && !m_recomputeSegments.empty())
+    {
+        parNode->SetNodeBackpropStartCallback([this](const ComputationNodeBasePtr& node)
+        {
+            auto segmentIter = m_recomputeSegments.find(node);
+            if (segmentIter == m_recomputeSegments.end())
+                return;
+            for (const auto& rnode : segmentIter->second) // segment is stored in forward order
+            {
+                rnode->BeginForwardProp();
+                rnode->ForwardProp(FrameRange(rnode->GetMBLayout()));
+                rnode->EndForwardProp();
+                rnode->BumpEvalTimeStamp();
+            }
+        });
+    }
+
     // backpropagate through the network
-    GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
+    nestedNetwork->Backprop(FrameRange(nullptr), true, true);
+
+    if (parNode)
+    {
+        parNode->SetNodeBackpropCompleteCallback(nullptr);
+        parNode->SetNodeBackpropStartCallback(nullptr);
+    }
 }
 
 void ComputationNetwork::FormNestedNetwork(const ComputationNodeBasePtr& rootNode)
@@ -131,29 +254,263 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
             nodeIter++; // and consume this node
         }
     }
+
+    // Precompute the stream schedule for stream-parallel forward execution:
+    // a node inherits its producers' stream when they all agree, starts a new stream when it has
+    // no computing producer inside this list (the source of an independent branch), and joins with
+    // event waits when branches meet. Leaves (no inputs) perform no bulk GPU work in ForwardProp
+    // and stay unscheduled; SEQ loop sentinels act as full barriers to stay conservative since
+    // their internal dependencies are not visible here.
+    const size_t maxStreams = 4; // towers beyond this fold onto existing streams (correct, just serialized)
+    size_t n = m_nestedNodes.size();
+    m_nodeStream.assign(n, -1);
+    m_crossStreamDeps.resize(n);
+    m_nodeRecordsEvent.assign(n, false);
+    std::map<ComputationNodeBase*, size_t> producerIndex; // node -> position in m_nestedNodes
+    std::vector<int> lastNodeOfStream(maxStreams, -1);    // most recent node scheduled on each stream
+    size_t nextStream = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const auto& node = m_nestedNodes[i];
+        producerIndex[node.get()] = i;
+        bool isBarrier = (dynamic_pointer_cast<SEQTraversalFlowControlNode>(node) != nullptr);
+        if (!isBarrier && node->GetNumInputs() == 0) // leaf: stays unscheduled
+            continue;
+
+        int stream = -1;
+        if (isBarrier)
+        {
+            // run on stream 0 after every stream has caught up
+            stream = 0;
+            for (size_t s = 1; s < maxStreams; s++)
+            {
+                if (lastNodeOfStream[s] >= 0)
+                {
+                    m_crossStreamDeps[i].push_back((size_t) lastNodeOfStream[s]);
+                    m_nodeRecordsEvent[lastNodeOfStream[s]] = true;
+                }
+            }
+        }
+        else
+        {
+            // gather computing producers within this list
+            std::vector<size_t> producers;
+            for (const auto& input : node->GetInputs())
+            {
+                auto iter = producerIndex.find(input.get());
+                if (iter != producerIndex.end() && m_nodeStream[iter->second] >= 0)
+                    producers.push_back(iter->second);
+            }
+            if (producers.empty())
+                stream = (int) (nextStream++ % maxStreams); // source of a new branch
+            else
+            {
+                stream = m_nodeStream[producers.front()];
+                for (size_t p : producers)
+                {
+                    if (m_nodeStream[p] != stream)
+                    {
+                        m_crossStreamDeps[i].push_back(p);
+                        m_nodeRecordsEvent[p] = true;
+                    }
+                }
+            }
+        }
+        m_nodeStream[i] = stream;
+        lastNodeOfStream[stream] = (int) i;
+    }
+    m_numStreamsUsed = min(nextStream, maxStreams);
+
+    // Precompute dependency levels for task-parallel CPU forward execution: nodes in level k
+    // only consume nodes of levels < k (or nodes outside this list), so all nodes within one
+    // level can run concurrently. SEQ loop sentinels act as barriers here as well, since their
+    // internal dependencies are not visible at this granularity. The schedule is only kept when
+    // all nodes are CPU-resident and some level actually has more than one node.
+    {
+        std::vector<size_t> levels(n, 0);
+        size_t numLevels = 0;
+        size_t barrierLevel = 0; // no node may be scheduled below this
+        bool allOnCpu = true;
+        for (size_t i = 0; i < n; i++)
+        {
+            const auto& node = m_nestedNodes[i];
+            allOnCpu &= (node->GetDeviceId() < 0);
+            size_t level = barrierLevel;
+            for (const auto& input : node->GetInputs())
+            {
+                auto iter = producerIndex.find(input.get());
+                if (iter != producerIndex.end())
+                    level = max(level, levels[iter->second] + 1);
+            }
+            if (dynamic_pointer_cast<SEQTraversalFlowControlNode>(node))
+            {
+                for (size_t j = 0; j < i; j++) // barrier: run alone, after everything before it
+                    level = max(level, levels[j] + 1);
+                barrierLevel = level + 1;
+            }
+            levels[i] = level;
+            numLevels = max(numLevels, level + 1);
+        }
+        size_t maxWidth = 0;
+        m_parLevels.assign(numLevels, std::vector<size_t>());
+        for (size_t i = 0; i < n; i++)
+            m_parLevels[levels[i]].push_back(i);
+        for (const auto& levelNodes : m_parLevels)
+            maxWidth = max(maxWidth, levelNodes.size());
+        if (!allOnCpu || maxWidth <= 1)
+            m_parLevels.clear(); // nothing to gain; ForwardProp() stays sequential
+    }
 }
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(const FrameRange& fr) /*override*/
 {
+    // Task-parallel CPU mode: run independent branches of the eval order on worker threads.
+    if (!m_parLevels.empty() && Globals::ShouldEnableParallelCpuForward())
+    {
+        if (Globals::ShouldEnableShareNodeValueMatrices())
+        {
+            // memory sharing derives buffer lifetimes from sequential execution order and is unsafe here
+            static bool warnedCpu = false;
+            if (!warnedCpu)
+            {
+                fprintf(stderr, "WARNING: task-parallel CPU forward requires shareNodeValueMatrices to be disabled; executing sequentially.\n");
+                warnedCpu = true;
+            }
+        }
+        else
+        {
+            ForwardPropTaskParallel(fr);
+            return;
+        }
+    }
+
+    // Stream-parallel mode: run independent branches on separate GPU streams with event-based
+    // dependency edges, so e.g. multi-tower models fill the SMs at small batch sizes.
+    bool streamParallel = m_numStreamsUsed > 1 && Globals::ShouldEnableStreamParallelForward();
+    if (streamParallel && Globals::ShouldEnableShareNodeValueMatrices())
+    {
+        // memory sharing derives buffer lifetimes from sequential execution order and is unsafe here
+        static bool warned = false;
+        if (!warned)
+        {
+            fprintf(stderr, "WARNING: stream-parallel forward requires shareNodeValueMatrices to be disabled; executing sequentially.\n");
+            warned = true;
+        }
+        streamParallel = false;
+    }
+    if (streamParallel)
+        ForkPooledComputeStreams(m_numStreamsUsed);
+
+    size_t nodeIndex = 0;
     for (auto& node : m_nestedNodes)
     {
 #if 0
         if (dynamic_pointer_cast<LearnableParameter<float>>(node))
             dynamic_pointer_cast<ComputationNode<float>>(node)->DebugLogMinibatch();
 #endif
+        if (streamParallel && m_nodeStream[nodeIndex] >= 0)
+        {
+            SetPooledComputeStream(m_nodeStream[nodeIndex]);
+            for (size_t dep : m_crossStreamDeps[nodeIndex])
+                WaitForComputeStreamEvent(dep);
+        }
+        node->EnsureValueIsLoaded(); // fault in lazily-loaded parameter values (no-op otherwise)
         if (node->IsOutOfDateWrtInputs())
         {
+            let profStamp = NodeProfilingBegin();
             node->BeginForwardProp();
             node->ForwardProp(fr.WithLayout(node->GetMBLayout()));
             node->EndForwardProp();
+            if (profStamp)
+                node->RecordForwardTime(NodeProfilingElapsedSeconds(profStamp));
 
             node->BumpEvalTimeStamp();
         }
+        if (streamParallel && m_nodeStream[nodeIndex] >= 0 && m_nodeRecordsEvent[nodeIndex])
+            RecordComputeStreamEvent(nodeIndex);
+        nodeIndex++;
 
         // Extreme Tracing, part 1/4
         if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode())
             DumpNode<float>(node, /*dumpGradient=*/false) || DumpNode<double>(node, false);
     }
+
+    if (streamParallel)
+    {
+        SetPooledComputeStream(-1);
+        JoinPooledComputeStreams();
+    }
 }
+
+// run one node's forward pass; shared between the sequential and task-parallel paths
+void ComputationNetwork::PARTraversalFlowControlNode::ForwardPropNode(const ComputationNodeBasePtr& node, const FrameRange& fr)
+{
+    node->EnsureValueIsLoaded(); // fault in lazily-loaded parameter values (no-op otherwise)
+    if (node->IsOutOfDateWrtInputs())
+    {
+        let profStamp = NodeProfilingBegin();
+        node->BeginForwardProp();
+        node->ForwardProp(fr.WithLayout(node->GetMBLayout()));
+        node->EndForwardProp();
+        if (profStamp)
+            node->RecordForwardTime(NodeProfilingElapsedSeconds(profStamp));
+
+        node->BumpEvalTimeStamp();
+    }
+}
+
+// task-parallel CPU forward: execute the precomputed dependency levels, fanning each
+// multi-node level out onto worker threads (see constructor for how levels are formed)
+void ComputationNetwork::PARTraversalFlowControlNode::ForwardPropTaskParallel(const FrameRange& fr)
+{
+    for (const auto& levelNodes : m_parLevels)
+    {
+        if (levelNodes.size() == 1) // single node: run inline, with full intra-op parallelism
+            ForwardPropNode(m_nestedNodes[levelNodes.front()], fr);
+        else
+        {
+#ifdef _OPENMP
+            // give each worker an equal share of the intra-op OpenMP threads, so inter-op and
+            // intra-op parallelism compose instead of oversubscribing the machine; the setting
+            // is per worker thread and dies with it
+            int ompThreadShare = std::max(1, omp_get_max_threads() / (int) levelNodes.size());
+#endif
+            std::vector<std::thread> workers;
+            std::vector<std::exception_ptr> exceptions(levelNodes.size());
+            for (size_t k = 0; k < levelNodes.size(); k++)
+            {
+                const auto& node = m_nestedNodes[levelNodes[k]];
+                workers.emplace_back([&, node, k]()
+                {
+                    try
+                    {
+#ifdef _OPENMP
+                        omp_set_num_threads(ompThreadShare);
+#endif
+                        ForwardPropNode(node, fr);
+                    }
+                    catch (...)
+                    {
+                        exceptions[k] = std::current_exception();
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            for (const auto& exception : exceptions)
+                if (exception)
+                    std::rethrow_exception(exception);
+        }
+
+        // tracing runs sequentially once the level has completed
+        for (size_t i : levelNodes)
+        {
+            const auto& node = m_nestedNodes[i];
+            if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode())
+                DumpNode<float>(node, /*dumpGradient=*/false) || DumpNode<double>(node, false);
+        }
+    }
+}
+
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::Backprop(const FrameRange& fr, bool childrenInThisLoop, bool childrenInOuterLoop) /*override*/
 {
     childrenInThisLoop, childrenInOuterLoop; // TODO: think through what these mean when coming from PAR mode
@@ -162,9 +519,18 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
     {
         auto& node = *pnode;
 
+        if (m_nodeBackpropStartCallback)
+            m_nodeBackpropStartCallback(node);
+
+        let profStamp = NodeProfilingBegin();
         node->BeginBackprop();
         node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
         node->EndBackprop();
+        if (profStamp)
+            node->RecordBackwardTime(NodeProfilingElapsedSeconds(profStamp));
+
+        if (m_nodeBackpropCompleteCallback)
+            m_nodeBackpropCompleteCallback(node);
 
         // Extreme Tracing, part 2/4
         if (node->HasEnvironmentPtr() && node->Environment().ShouldDumpNode() && node->NeedsGradient())
@@ -227,6 +593,30 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
                        m_nestedNodes[0]->NodeName().c_str(), m_nestedNodes[0]->GetMBLayoutAxisString().c_str());
     }
 
+    // determine which time steps hold any sequence data at all: steps that are all gaps
+    // (e.g. the tail of a minibatch whose sequences all ended early) produce nothing but
+    // masked-out garbage, so the time loops skip them entirely
+    {
+        const auto& pMBLayout = GetMBLayout();
+        size_t T = pMBLayout->GetNumTimeSteps();
+        m_stepHasData.assign(T, false);
+        size_t numStepsWithData = 0;
+        for (const auto& seq : pMBLayout->GetAllSequences())
+        {
+            if (seq.seqId == GAP_SEQUENCE_ID)
+                continue;
+            size_t tBegin = (size_t) max(seq.tBegin, (ptrdiff_t) 0);
+            size_t tEnd = min(seq.tEnd, T);
+            for (size_t t = tBegin; t < tEnd; t++)
+            {
+                numStepsWithData += !m_stepHasData[t];
+                m_stepHasData[t] = true;
+            }
+        }
+        if (numStepsWithData == T) // common case: no all-gap steps; skip the per-step test
+            m_stepHasData.clear();
+    }
+
     // tell all that loop is about to commence
     for (auto& node : m_nestedNodes)
         node->BeginForwardProp();
@@ -248,9 +638,14 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     FrameRangeIteration range(GetMBLayout(), m_steppingDirection);
     for (auto t = range.begin(); t != range.end(); t++)
     {
+        if (!m_stepHasData.empty() && !m_stepHasData[t.timeIdxInSeq]) // all-gap step: nothing to compute
+            continue;
         for (auto& node : m_nestedNodes)
         {
+            let profStamp = NodeProfilingBegin();
             node->ForwardProp(t);
+            if (profStamp)
+                node->RecordForwardTime(NodeProfilingElapsedSeconds(profStamp));
             node->BumpEvalTimeStamp();
         }
     }
@@ -287,10 +682,15 @@ static bool DumpNode(ComputationNodeBasePtr nodep, bool dumpGradient)
     FrameRangeIteration range(pMBLayout, m_steppingDirection);
     for (auto t = range.rbegin(); t != range.rend(); t++) // note: reverse iteration
     {
+        if (!m_stepHasData.empty() && !m_stepHasData[t.timeIdxInSeq]) // all-gap step: nothing to compute
+            continue;
         for (auto nodeIter2 = recurrentNodes.rbegin(); nodeIter2 != recurrentNodes.rend(); ++nodeIter2)
         {
             auto& node2 = *nodeIter2;
+            let profStamp = NodeProfilingBegin();
             node2->Backprop(t, true /*childrenInThisLoop*/, false /*childrenInOuterLoop*/);
+            if (profStamp)
+                node2->RecordBackwardTime(NodeProfilingElapsedSeconds(profStamp));
             // The above flags tell Backprop() to skip back-propagation from inside a node into
             // a node that is outside the loop, which is done later in EndBackprop() in PAR mode.
         }
@@ -425,8 +825,19 @@ void ComputationNetwork::PrintComputationTree(const ComputationNodeBasePtr& root
 
 // called by model editing operations, such as DeleteNode(); and by RebuildNetwork()
 // These invalidates any post-processed structures. If they are accessed, we will fail.
+// This unattributed form forces the next CompileNetwork() to revalidate every node. Editing
+// operations that can name the node they changed use the attributed overload below instead,
+// which allows the next compilation to revalidate only that node's downstream cone.
 void ComputationNetwork::InvalidateCompiledNetwork()
 {
+    m_fullRevalidationNeeded = true;
+    InvalidateCompiledNetwork(nullptr);
+}
+
+void ComputationNetwork::InvalidateCompiledNetwork(const ComputationNodeBasePtr& editedNode)
+{
+    if (editedNode)
+        m_editedNodes.insert(editedNode);
     m_isCompiled = false;
     m_allSEQNodes.clear();
     m_evalOrders.clear();
@@ -435,6 +846,106 @@ void ComputationNetwork::InvalidateCompiledNetwork()
     m_learnableParameters.clear();
 }
 
+// -----------------------------------------------------------------------
+// network optimization: operator fusion
+// -----------------------------------------------------------------------
+
+// match a unary nonlinearity that can serve as a fusion epilogue
+static bool MatchFusibleUnaryOp(const wstring& opName, ElementWiseOperator& unaryOp)
+{
+    if      (opName == OperationNameOf(SigmoidNode))         unaryOp = ElementWiseOperator::opSigmoid;
+    else if (opName == OperationNameOf(TanhNode))            unaryOp = ElementWiseOperator::opTanh;
+    else if (opName == OperationNameOf(RectifiedLinearNode)) unaryOp = ElementWiseOperator::opLinearRectifier;
+    else
+        return false;
+    return true;
+}
+
+// match a fusible binary elementwise op
+static bool MatchFusibleBinaryOp(const wstring& opName, ElementWiseOperator& binaryOp)
+{
+    if      (opName == OperationNameOf(PlusNode))         binaryOp = ElementWiseOperator::opSum;
+    else if (opName == OperationNameOf(MinusNode))        binaryOp = ElementWiseOperator::opDifference;
+    else if (opName == OperationNameOf(ElementTimesNode)) binaryOp = ElementWiseOperator::opElementwiseProduct;
+    else
+        return false;
+    return true;
+}
+
+// fuse chains of a binary elementwise op feeding a unary nonlinearity (e.g. Plus >> Sigmoid)
+// into FusedBinaryUnaryNodes, eliminating the inner node and its activation buffer.
+// Where a dedicated fused opcode exists (opSigmoidOfSum etc.), the chain further collapses into
+// a single memory pass. This rewires the graph, so it must run before any eval orders, loops,
+// or nested networks are formed. The inner node must feed only the outer node and must not be
+// referenced externally (e.g. tagged as an output).
+void ComputationNetwork::FuseElementwiseChains()
+{
+    // determine fan-out and external references of every node
+    map<ComputationNodeBasePtr, size_t> fanOut;
+    for (const auto& iter : m_nameToNodeMap)
+    {
+        let& node = iter.second;
+        for (size_t i = 0; i < node->GetNumInputs(); i++)
+            fanOut[node->GetInputs()[i]]++;
+    }
+    set<ComputationNodeBasePtr> externallyReferenced;
+    for (auto* group : GetAllNodeGroups())
+        externallyReferenced.insert(group->begin(), group->end());
+
+    // snapshot the node set, since fusing modifies m_nameToNodeMap
+    vector<ComputationNodeBasePtr> nodes;
+    for (const auto& iter : m_nameToNodeMap)
+        nodes.push_back(iter.second);
+
+    size_t numFused = 0;
+    for (const auto& outer : nodes)
+    {
+        ElementWiseOperator binaryOp, unaryOp;
+        if (outer->GetNumInputs() != 1 || !MatchFusibleUnaryOp(outer->OperationName(), unaryOp))
+            continue;
+        let& inner = outer->GetInputs()[0];
+        if (!MatchFusibleBinaryOp(inner->OperationName(), binaryOp))
+            continue;
+        if (fanOut[inner] != 1 || externallyReferenced.count(inner))
+            continue;
+        // a dedicated fused opcode collapses the chain into a single memory pass
+        if (binaryOp == ElementWiseOperator::opSum)
+        {
+            if      (unaryOp == ElementWiseOperator::opSigmoid)         binaryOp = ElementWiseOperator::opSigmoidOfSum;
+            else if (unaryOp == ElementWiseOperator::opTanh)            binaryOp = ElementWiseOperator::opTanhOfSum;
+            else if (unaryOp == ElementWiseOperator::opLinearRectifier) binaryOp = ElementWiseOperator::opLinearRectifierOfSum;
+            unaryOp = ElementWiseOperator::opCopy;
+        }
+        if (TryFuseBinaryUnary<float>(outer, inner, binaryOp, unaryOp) || TryFuseBinaryUnary<double>(outer, inner, binaryOp, unaryOp))
+            numFused++;
+    }
+    if (TraceLevel() > 0 && numFused > 0)
+        fprintf(stderr, "FuseElementwiseChains: fused %d elementwise chains\n", (int) numFused);
+}
+
+template <class ElemType>
+bool ComputationNetwork::TryFuseBinaryUnary(const ComputationNodeBasePtr& outer, const ComputationNodeBasePtr& inner,
+                                            ElementWiseOperator binaryOp, ElementWiseOperator unaryOp)
+{
+    if (!dynamic_pointer_cast<ComputationNode<ElemType>>(outer) || !dynamic_pointer_cast<ComputationNode<ElemType>>(inner))
+        return false; // not this ElemType
+
+    // the fused node takes over the inner node's inputs and the outer node's consumers and name
+    auto fusedNode = make_shared<FusedBinaryUnaryNode<ElemType>>(outer->GetDeviceId(), outer->NodeName(), binaryOp, unaryOp);
+    fusedNode->AttachInputs(vector<ComputationNodeBasePtr>{inner->GetInputs()[0], inner->GetInputs()[1]});
+    ChangeNodeInputs(outer, fusedNode);
+    RemoveNodeFromNet(outer);
+    RemoveNodeFromNet(inner);
+    outer->DetachInputs(); // break remaining links of the orphaned nodes
+    inner->DetachInputs();
+    AddNodeToNet(fusedNode);
+    for (auto groupIter : GetAllNodeGroups()) // the outer node may be tagged, e.g. as an output
+        for (auto& groupNode : *groupIter)
+            if (groupNode == outer)
+                groupNode = fusedNode;
+    return true;
+}
+
 // verify that network has undergone CompileNetwork()
 void ComputationNetwork::VerifyIsCompiled(const char* where) const
 {
@@ -452,8 +963,22 @@ void ComputationNetwork::CompileNetwork()
     fprintf(stderr, "\nPost-processing network...\n");
 
     // We may only get here if not !IsCompiled(). We could now verify each member to be virgin.
-    // Or just invalidate it again, which is easier and safer.
-    InvalidateCompiledNetwork();
+    // Or just invalidate it again, which is easier and safer. Use the attributed form so the
+    // edit attribution collected since the last compilation survives for the scoped
+    // revalidation decision below.
+    InvalidateCompiledNetwork(nullptr);
+
+    // Dependency-scoped revalidation applies when the network has been fully validated before
+    // and every invalidation since then named the node it edited; any unattributed
+    // invalidation forces the full pass.
+    const bool incrementalRevalidation = m_hasBeenValidated && !m_fullRevalidationNeeded && !m_editedNodes.empty();
+
+    // STEP: Fuse fusible operator chains. This rewires the graph, so it must precede root
+    // detection and all eval-order/loop formation below. Skipped under scoped revalidation:
+    // fusion creates new nodes outside the edit attribution (the graph was already fused in
+    // the previous compilation, so only chains inside the edited cone are missed).
+    if (Globals::ShouldEnableNodeFusion() && !incrementalRevalidation)
+        FuseElementwiseChains();
 
     // all steps below have to be repeated for all root nodes (=nodes without parents and PreComputeNodes)
     DetermineSetOfAllRoots();
@@ -479,8 +1004,11 @@ void ComputationNetwork::CompileNetwork()
 
     // STEP: Establish time-axis relationships.
     // This sets all MBLayout pointers of Input nodes according to user spec of time axes.
+    // Skipped under scoped revalidation: nodes outside the edited cone keep their layout links
+    // from the previous compilation, and revalidated nodes re-derive theirs from their inputs.
     // TODO: Don't use m_inputValues, traverse ourselves, to remove dependency on FormEvalOrder().
-    ResetMBLayouts();
+    if (!incrementalRevalidation)
+        ResetMBLayouts();
 
     // STEP: Discover nested loops.
     FormRecurrentLoops(nullptr); // form the global one  --TODO: just use this; should be no need to do this for each root
@@ -499,7 +1027,7 @@ void ComputationNetwork::CompileNetwork()
         FormNestedNetwork(node);
 
     // STEP: Infer node dimensions.
-    ValidateNetwork();
+    ValidateNetwork(incrementalRevalidation);
 
     // STEP: Optimize the network.
     // :)
@@ -509,6 +1037,9 @@ void ComputationNetwork::CompileNetwork()
 
     if (TraceLevel() > 0)
     fprintf(stderr, "\nPost-processing network complete.\n\n");
+    m_editedNodes.clear();
+    m_fullRevalidationNeeded = false;
+    m_hasBeenValidated = true;
     m_isCompiled = true;
 }
 
@@ -628,14 +1159,56 @@ void ComputationNetwork::ResetMBLayouts()
 // This calls Validate() on every node in evaluation order (allowing to propagate things forwards through the net).
 // This is called lazily but once only per node until next ClearCache().
 // MBLayout links are expected to have been set up already for inputs, and reset to nullptr for all other nodes.
-void ComputationNetwork::ValidateNetwork()
+void ComputationNetwork::ValidateNetwork(bool incrementalRevalidation)
 {
     // we call all nodes' Validate() in order to validate, that is, set up MBLayout and FunctionValues dimension
     // A problem is that recurrent loops may require partial validation.
     // Nodes validated on partial input (i.e. some children not yet validated) will be revisited.
     const auto& nodes = GetEvalOrder(nullptr);
 
-    for (auto& node : nodes)
+    // Dependency-scoped revalidation: an edit can only change the validation results
+    // (dimensions, MBLayout link, needsGradient) of the edited nodes and their downstream cone
+    // of transitive consumers; everything else keeps the results of the previous validation.
+    // The eval order lists inputs before their consumers, so one sweep closes the cone; loops
+    // contain backward edges, so iterate until no node is added.
+    list<ComputationNodeBasePtr> nodesToValidate;
+    if (incrementalRevalidation)
+    {
+        set<ComputationNodeBasePtr> cone;
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (const auto& node : nodes)
+            {
+                if (cone.find(node) != cone.end())
+                    continue;
+                bool inCone = (m_editedNodes.find(node) != m_editedNodes.end());
+                for (const auto& child : node->GetInputs())
+                    inCone |= (cone.find(child) != cone.end());
+                if (inCone)
+                {
+                    cone.insert(node);
+                    changed = true;
+                }
+            }
+        }
+        for (const auto& node : nodes) // gather in eval order
+            if (cone.find(node) != cone.end())
+                nodesToValidate.push_back(node);
+
+        if (TraceLevel() > 0)
+            fprintf(stderr, "\nValidateNetwork: scoped revalidation of %d of %d nodes, downstream of %d edited nodes.\n",
+                    (int) nodesToValidate.size(), (int) nodes.size(), (int) m_editedNodes.size());
+
+        // nodes outside the cone count as validated and keep their dims/layouts/needsGradient
+        for (auto& node : nodes)
+            node->m_visited = true;
+    }
+    else
+        nodesToValidate = nodes;
+
+    for (auto& node : nodesToValidate)
     {
         node->m_visited = false;
         node->m_needsGradient = node->IsParameterUpdateRequired(); // these get propagated upwards in the following
@@ -648,17 +1221,17 @@ void ComputationNetwork::ValidateNetwork()
     //  - validate (final)              // final means consistency checks
     //    Fail if any change during this stage.
     size_t pass = 1;
-    size_t toValidate = nodes.size();
+    size_t toValidate = nodesToValidate.size();
     while (toValidate > 0)
     {
         if (TraceLevel() > 0)
         fprintf(stderr, "\nValidating network. %d nodes to process in pass %d.\n\n", (int) toValidate, (int) pass);
-        toValidate = ValidateNodes(nodes, /*isFirstPass=*/pass == 1, false /*isFinalValidationPass*/);
+        toValidate = ValidateNodes(nodesToValidate, /*isFirstPass=*/pass == 1, false /*isFinalValidationPass*/);
         pass++;
     }
     if (TraceLevel() > 0)
     fprintf(stderr, "\nValidating network, final pass.\n\n");
-    toValidate = ValidateNodes(nodes, /*isFirstPass=*/pass == 1, true /*isFinalValidationPass*/);
+    toValidate = ValidateNodes(nodesToValidate, /*isFirstPass=*/pass == 1, true /*isFinalValidationPass*/);
     if (toValidate != 0)
         LogicError("ValidateSubNetwork: ValidateNodes(true) unexpectedly returned with work left to do.");
 
@@ -802,8 +1375,12 @@ size_t ComputationNetwork::ValidateNodes(list<ComputationNodeBasePtr> nodes, boo
 // memory allocation
 // -----------------------------------------------------------------------
 // mark nodes that are purely induced by parameters as non-sharable and create space for value if null
-void ComputationNetwork::MarkValueNonSharableNodes()
+// Returns the interior nodes whose leaf descendants are all learnable parameters; these are the
+// nodes MarkValueNonSharableNodes() marks non-sharable, and the ones inference-only compilation
+// instead schedules for recomputation on every forward pass (see AllocateAllMatrices()).
+std::list<ComputationNodeBasePtr> ComputationNetwork::GatherParameterInducedNodes()
 {
+    std::list<ComputationNodeBasePtr> parameterInducedNodes;
     const auto& nodes = GetEvalOrder(nullptr);
     std::map<wstring, bool> allLeafDescendentsAreParametersOrPreComputeNodes;
     std::list<ComputationNodeBasePtr> allLearnableParameters = GetNodesWithType(OperationNameOf(LearnableParameter));
@@ -857,9 +1434,17 @@ void ComputationNetwork::MarkValueNonSharableNodes()
 
             allLeafDescendentsAreParametersOrPreComputeNodes[myname] = allParametersOrPreComputeNodes;
             if (allParametersOrPreComputeNodes)
-                node->MarkValueNonSharable();
+                parameterInducedNodes.push_back(node);
         }
     }
+
+    return parameterInducedNodes;
+}
+
+void ComputationNetwork::MarkValueNonSharableNodes()
+{
+    for (auto& node : GatherParameterInducedNodes())
+        node->MarkValueNonSharable();
 }
 
 // From the set of nodes extract all nodes which are used as accumulator nodes.
@@ -1000,8 +1585,14 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
     for (auto& rootNode : forwardPropRoots)
         rootNode->MarkValueNonSharable();
 
-    // Due to special topology, if a node is solely induced by parameters, its function value should not be shared
-    MarkValueNonSharableNodes();
+    // Due to special topology, if a node is solely induced by parameters, its function value should not be shared.
+    // In inference-only compilation these values stay sharable so that they participate in pool
+    // reuse like any other activation; since their buffers may then be overwritten between
+    // passes, they are recorded for forced recomputation on every ForwardProp() instead.
+    if ((trainRootNode == nullptr) && Globals::ShouldOptimizeForInference())
+        m_inferenceRecomputeNodes = GatherParameterInducedNodes();
+    else
+        MarkValueNonSharableNodes();
 
     bool performingBackPropagation = (trainRootNode != nullptr) || (Globals::ShouldEnableHyperCompressMemory());
 
@@ -1050,6 +1641,95 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         }
     }
 
+    // Activation recomputation (gradient checkpointing): segment the training eval order at
+    // checkpoint nodes and mark the eligible values in between as not needed during backprop, so
+    // that the forward simulation below releases them back to the pool. Each segment is recorded
+    // in m_recomputeSegments; Backprop() re-runs it just before its checkpoint's backprop step,
+    // and the backward simulation below reopens the matching pool intervals at that same point.
+    m_recomputeSegments.clear();
+    if (trainRootNode != nullptr && Globals::ShouldRecomputeActivations() &&
+        Globals::ShouldEnableShareNodeValueMatrices() && !Globals::ShouldEnableHyperCompressMemory())
+    {
+        const std::list<ComputationNodeBasePtr>& trainEvalOrder = GetEvalOrder(trainRootNode);
+        std::vector<ComputationNodeBasePtr> trainNodes(trainEvalOrder.begin(), trainEvalOrder.end());
+        std::map<ComputationNodeBasePtr, size_t> nodePosition;
+        for (size_t i = 0; i < trainNodes.size(); i++)
+            nodePosition[trainNodes[i]] = i;
+
+        // determine the checkpoint positions: the user-tagged nodes if given, else every
+        // ceil(sqrt(N))-th node (which bounds both kept values and per-segment recompute work by
+        // O(sqrt(N))). Checkpoints must be top-level (non-loop) nodes, since the recompute
+        // callback in PARTraversalFlowControlNode::Backprop() fires per nested node.
+        std::vector<size_t> checkpointPositions;
+        for (const auto& node : m_recomputeCheckpointNodes)
+        {
+            auto posIter = nodePosition.find(node);
+            if (posIter == nodePosition.end())
+                InvalidArgument("AllocateAllMatrices: Recompute checkpoint node %ls %ls operation is not part of the training network.",
+                                node->NodeName().c_str(), node->OperationName().c_str());
+            if (node->IsPartOfLoop())
+                InvalidArgument("AllocateAllMatrices: Recompute checkpoint node %ls %ls operation must not be part of a recurrent loop.",
+                                node->NodeName().c_str(), node->OperationName().c_str());
+            checkpointPositions.push_back(posIter->second);
+        }
+        if (checkpointPositions.empty())
+        {
+            size_t stride = (size_t) ceil(sqrt((double) trainNodes.size()));
+            for (size_t i = stride; i < trainNodes.size(); i += stride)
+                if (!trainNodes[i]->IsPartOfLoop())
+                    checkpointPositions.push_back(i);
+        }
+        std::sort(checkpointPositions.begin(), checkpointPositions.end());
+
+        // Collect each segment's recomputable interior. A value may only be released if every
+        // consumer sits at or below the segment's checkpoint in the eval order: then the
+        // recompute pass at the checkpoint restores it before any consumer's backprop step, and
+        // any released input the recompute itself reads lies in the same segment and is restored
+        // by the same pass, in forward order. This also keeps values alive across skip
+        // connections that reach past a checkpoint. Stochastic nodes (IRngUser) must keep their
+        // values, as re-running them would draw fresh random numbers and corrupt the gradients;
+        // the same goes for loop members (recomputed per frame), leaves and pre-compute nodes.
+        size_t prevCheckpoint = 0; // interiors of the first segment start at position 0 (a leaf, never released)
+        for (size_t checkpoint : checkpointPositions)
+        {
+            std::vector<ComputationNodeBasePtr> segment;
+            for (size_t i = prevCheckpoint; i < checkpoint; i++)
+            {
+                const ComputationNodeBasePtr& node = trainNodes[i];
+                auto neededIter = outputValueNeededDuringBackProp.find(node);
+                if (neededIter == outputValueNeededDuringBackProp.end() || !neededIter->second)
+                    continue; // already released after forward; nothing to gain
+                if (!node->IsValueSharable() || node->IsPartOfLoop() || node->IsLeaf() ||
+                    node->RequiresPreCompute() || dynamic_pointer_cast<IRngUser>(node))
+                    continue;
+                bool allConsumersBelowCheckpoint = true;
+                for (const auto& parent : parentsMap[node])
+                {
+                    auto posIter = nodePosition.find(parent);
+                    // parents outside the training order only consume the value during forward
+                    if (posIter != nodePosition.end() && posIter->second > checkpoint)
+                        allConsumersBelowCheckpoint = false;
+                }
+                if (!allConsumersBelowCheckpoint)
+                    continue;
+                neededIter->second = false; // release after last forward use; reopened below
+                segment.push_back(node);
+            }
+            if (!segment.empty())
+                m_recomputeSegments[trainNodes[checkpoint]] = std::move(segment);
+            prevCheckpoint = checkpoint;
+        }
+
+        if (TraceLevel() > 0 && !m_recomputeSegments.empty())
+        {
+            size_t numRecomputed = 0;
+            for (const auto& segment : m_recomputeSegments)
+                numRecomputed += segment.second.size();
+            fprintf(stderr, "AllocateAllMatrices: Releasing %d of %d activations after forward prop, to be recomputed in %d segments during backprop.\n",
+                    (int) numRecomputed, (int) trainNodes.size(), (int) m_recomputeSegments.size());
+        }
+    }
+
     // Construct the composite forward prop eval order by enumerating the
     // nodes corresponding to each of our roots and then arranging them in the
     // relative order that they appear in the global evaluation order
@@ -1091,6 +1771,10 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         // now, simulate the gradient computation order to determine how to allocate matrices
         set<ComputationNodeBasePtr> completedGradient;
 
+        // values of the most recently reopened recompute segment; retired once the backward
+        // simulation reaches the next checkpoint down, when all their consumers have backpropped
+        std::vector<ComputationNodeBasePtr> pendingRecomputedNodes;
+
         // we need to call it here since we always compute gradients for children and root node is not children of other node
         trainRootNode->RequestMatricesBeforeBackprop(m_matrixPool);
 
@@ -1113,6 +1797,19 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
             }
             else
             {
+                // at a recompute checkpoint: the segment above this one has completed its
+                // backprop, so retire its recomputed values, and reopen this checkpoint's own
+                // segment, which Backprop() recomputes just before this node's backprop step
+                auto segmentIter = m_recomputeSegments.find(n);
+                if (segmentIter != m_recomputeSegments.end())
+                {
+                    for (auto& recomputedNode : pendingRecomputedNodes)
+                        recomputedNode->ReleaseMatricesAfterForwardProp(m_matrixPool);
+                    for (auto& recomputedNode : segmentIter->second)
+                        recomputedNode->RequestMatricesBeforeForwardProp(m_matrixPool);
+                    pendingRecomputedNodes = segmentIter->second;
+                }
+
                 // PAR mode: we can allocate and immediately deallocate one by one
                 n->AllocateGradientMatricesForInputs(m_matrixPool);
                 // Root node's information will be used and should not be shared with others, also it's small (1x1)
@@ -1120,8 +1817,16 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
                     n->ReleaseMatricesAfterBackprop(m_matrixPool);
             }
         }
+
+        // retire the recomputed values of the lowest segment
+        for (auto& recomputedNode : pendingRecomputedNodes)
+            recomputedNode->ReleaseMatricesAfterForwardProp(m_matrixPool);
     }
 
+    // The simulation above only recorded first-use/last-use intervals; now solve the buffer
+    // assignment and materialize the actual matrices into the nodes' members.
+    m_matrixPool.OptimizedMemoryAllocation();
+
     m_areMatricesAllocated = true;
 
     // print the memory sharing structure
@@ -514,13 +514,33 @@ void ComputationNode<ElemType>::WriteMinibatchWithFormatting(FILE* f, const Fram
                                                              string valueFormatString,
                                                              bool outputGradient,
                                                              bool onlyShowAbsSumForDense) const
+{
+    // callers that do not pass a reusable buffer get a transient one
+    ElemType* scratchBuffer = nullptr;
+    size_t scratchBufferSize = 0;
+    WriteMinibatchWithFormatting(f, fr, onlyUpToRow, onlyUpToT, transpose, isCategoryLabel, isSparse, labelMapping,
+                                 sequenceSeparator, sequencePrologue, sequenceEpilogue, elementSeparator, sampleSeparator,
+                                 valueFormatString, outputGradient, onlyShowAbsSumForDense, scratchBuffer, scratchBufferSize);
+    delete[] scratchBuffer;
+}
+
+template <class ElemType>
+void ComputationNode<ElemType>::WriteMinibatchWithFormatting(FILE* f, const FrameRange& fr,
+                                                             size_t onlyUpToRow, size_t onlyUpToT, bool transpose, bool isCategoryLabel, bool isSparse,
+                                                             const vector<string>& labelMapping, const string& sequenceSeparator, 
+                                                             const string& sequencePrologue, const string& sequenceEpilogue,
+                                                             const string& elementSeparator, const string& sampleSeparator,
+                                                             string valueFormatString,
+                                                             bool outputGradient,
+                                                             bool onlyShowAbsSumForDense,
+                                                             ElemType*& scratchBuffer, size_t& scratchBufferSize) const
 {
     // get minibatch matrix -> matData, matRows, matStride
     const Matrix<ElemType>& outputValues = outputGradient ? Gradient() : Value();
     let matRows   = outputValues.GetNumRows();
     let matStride = matRows; // how to get from one column to the next
-    unique_ptr<ElemType[]> matDataPtr(outputValues.CopyToArray());
-    ElemType* matData = matDataPtr.get();
+    outputValues.CopyToArray(scratchBuffer, scratchBufferSize); // reuses (and grows) the caller's buffer
+    ElemType* matData = scratchBuffer;
     let sampleLayout = GetSampleLayout(); // this is currently only used for sparse; dense tensors are linearized
 
     // process all sequences one by one
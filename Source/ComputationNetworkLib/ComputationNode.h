@@ -632,6 +632,12 @@ public:
 
     DEVICEID_TYPE GetDeviceId() const { return m_deviceId; }
 
+    // re-home this node onto another device
+    // Overridden by ComputationNode<ElemType> to also move already-allocated matrices.
+    // Must be called before AllocateAllMatrices(), since pooled buffers are requested
+    // on whatever device the node has at allocation time.
+    virtual void MoveToDevice(DEVICEID_TYPE deviceId) { m_deviceId = deviceId; }
+
     // helper to access to element(0,0) without having to type-cast
     virtual double Get00Element() const = 0;
     virtual MatrixBasePtr ValuePtr() const = 0; // for use in readers that pass the agnostic object around
@@ -755,6 +761,10 @@ public:
         return false;
     }
 
+    // materialize a value whose read was deferred at model-load time (lazyParameterLoad);
+    // no-op for everything but LearnableParameter, which overrides this
+    virtual void EnsureValueIsLoaded() {}
+
     // reset gradients of a node's inputs
     // This really only clears the lazy-init flags (LazyZeroGradient() actually clears the values lazily).
     void /*ComputationNodeBase::*/ ZeroGradientsOfInputs()
@@ -763,6 +773,54 @@ public:
             Input(i)->m_gradientInitialized = false;
     }
 
+    // -----------------------------------------------------------------------
+    // profiling
+    // -----------------------------------------------------------------------
+
+    // Per-node cumulative statistics, accumulated by the flow-control nodes when
+    // Globals::ShouldEnableNodeProfiling() is on, and reported by ComputationNetwork::DumpProfile().
+    void RecordForwardTime(double seconds)
+    {
+        m_profForwardSeconds += seconds;
+        m_profForwardCalls++;
+        size_t bytes = ValueBytes();
+        if (bytes > m_profPeakValueBytes)
+            m_profPeakValueBytes = bytes;
+    }
+    void RecordBackwardTime(double seconds)
+    {
+        m_profBackwardSeconds += seconds;
+        m_profBackwardCalls++;
+        size_t bytes = GradientBytes();
+        if (bytes > m_profPeakGradientBytes)
+            m_profPeakGradientBytes = bytes;
+    }
+    double ProfForwardSeconds() const    { return m_profForwardSeconds; }
+    double ProfBackwardSeconds() const   { return m_profBackwardSeconds; }
+    size_t ProfForwardCalls() const      { return m_profForwardCalls; }
+    size_t ProfBackwardCalls() const     { return m_profBackwardCalls; }
+    size_t ProfPeakValueBytes() const    { return m_profPeakValueBytes; }
+    size_t ProfPeakGradientBytes() const { return m_profPeakGradientBytes; }
+    void ResetProfilingStats()
+    {
+        m_profForwardSeconds = m_profBackwardSeconds = 0.0;
+        m_profForwardCalls = m_profBackwardCalls = 0;
+        m_profPeakValueBytes = m_profPeakGradientBytes = 0;
+    }
+
+    // current allocation of the value/gradient matrix in bytes; overridden by the <ElemType> variant
+    virtual size_t ValueBytes() const { return 0; }
+    virtual size_t GradientBytes() const { return 0; }
+
+protected:
+    double m_profForwardSeconds = 0.0;  // cumulative wall time spent in ForwardProp() for this node
+    double m_profBackwardSeconds = 0.0; // cumulative wall time spent in Backprop() for this node
+    size_t m_profForwardCalls = 0;
+    size_t m_profBackwardCalls = 0;
+    size_t m_profPeakValueBytes = 0;    // largest value matrix observed right after ForwardProp()
+    size_t m_profPeakGradientBytes = 0; // largest gradient matrix observed right after Backprop()
+
+public:
     // -----------------------------------------------------------------------
     // masking
     // -----------------------------------------------------------------------
@@ -1226,6 +1284,11 @@ public:
         }
     }
 
+    // alias the value matrix of another node of the same type, instead of owning one
+    // Used by ComputationNetwork::CreateSharedParameterClone() so that per-session network
+    // clones keep a single copy of the (immutable) model weights.
+    void ShareValueMatrixWith(const ComputationNode<ElemType>& other) { m_value = other.m_value; }
+
     // duplicate a node
     // Create a copy of a ComputationNode object. Inputs will be shared. Values (and gradients if applicable) are copied.
     ComputationNodeBasePtr Duplicate(const std::wstring& newName, const CopyNodeFlags flags) const override
@@ -1442,6 +1505,21 @@ public:
     std::shared_ptr<Matrix<ElemType>>& GradientPtrRef() { return m_gradient; }
     // TODO: This is only used for testing whether a gradient has been allocated. Maybe reduce to bool HasGradient()?
 
+    // current matrix sizes for per-node profiling (ComputationNetwork::DumpProfile())
+    virtual size_t ValueBytes() const override { return m_value ? m_value->GetNumElements() * sizeof(ElemType) : 0; }
+    virtual size_t GradientBytes() const override { return m_gradient ? m_gradient->GetNumElements() * sizeof(ElemType) : 0; }
+
+    // re-home this node onto another device, moving matrices that were already allocated
+    // (e.g. LearnableParameter values loaded from a model file) along with it
+    virtual void MoveToDevice(DEVICEID_TYPE deviceId) override
+    {
+        m_deviceId = deviceId;
+        if (m_value)
+            m_value->TransferToDeviceIfNotThere(deviceId, /*isBeingMoved=*/true);
+        if (m_gradient)
+            m_gradient->TransferToDeviceIfNotThere(deviceId, /*isBeingMoved=*/true);
+    }
+
 private:
 
     template<class E>
@@ -1540,12 +1618,67 @@ public:
             Rethrow(e);
         }
     }
+    // cached per-time-step views
+    // In a SEQ loop, ValueTensorFor()/GradientTensorFor() re-derive the identical tensor slice
+    // for each time step from scratch; the TensorShape bookkeeping and view construction show up
+    // in profiles of deep unrolled RNNs. For the common single-frame case (no time offset, no
+    // custom range, all parallel sequences) we construct each view once per minibatch and hand
+    // out refcount-free copies. The cached views are non-owning (TensorView::Unowned), which is
+    // safe because they point into m_value/m_gradient, which outlive the minibatch; the cache is
+    // invalidated when the storage object, rank, or layout dimensions change.
+private:
+    struct TensorViewCache
+    {
+        MatrixBase* sob = nullptr; // identity of the storage object the cached views point into
+        size_t rank = 0;
+        size_t numParallelSequences = 0;
+        size_t numTimeSteps = 0;
+        std::vector<char> valid;                      // flag per time step: view has been constructed
+        std::vector<TensorView<ElemType>> frameViews; // one view per time step
+    };
+    TensorViewCache m_valueViewCache, m_gradientViewCache;
+
+    // returns the cached view for 'fr', or nullptr if 'fr' is not cacheable (caller takes the regular path)
+    const TensorView<ElemType>* CachedDataTensorFor(TensorViewCache& cache, Matrix<ElemType>& data, size_t rank, const FrameRange& fr)
+    {
+        if (!m_pMBLayout || fr.m_pMBLayout != m_pMBLayout || fr.IsAllFrames() ||
+            fr.m_timeOffset != 0 || fr.m_timeRange != 1 || fr.seqIndex != SIZE_MAX)
+            return nullptr;
+        const size_t S = m_pMBLayout->GetNumParallelSequences();
+        const size_t T = m_pMBLayout->GetNumTimeSteps();
+        if (cache.sob != &data || cache.rank != rank || cache.numParallelSequences != S || cache.numTimeSteps != T)
+        {
+            cache.sob = &data;
+            cache.rank = rank;
+            cache.numParallelSequences = S;
+            cache.numTimeSteps = T;
+            cache.valid.assign(T, 0);
+            cache.frameViews.resize(T);
+        }
+        const size_t t = fr.timeIdxInSeq;
+        if (t >= T)
+            return nullptr; // out of range; let the regular path produce the proper error
+        if (!cache.valid[t])
+        {
+            cache.frameViews[t] = TensorView<ElemType>::Unowned(data, GetTensorSliceFor(rank, fr));
+            cache.valid[t] = 1;
+        }
+        return &cache.frameViews[t];
+    }
+
+public:
     TensorView<ElemType> ValueTensorFor(size_t rank, const FrameRange& fr)
     {
+        const auto* cached = m_value ? CachedDataTensorFor(m_valueViewCache, Value(), rank, fr) : nullptr;
+        if (cached)
+            return *cached;
         return DataTensorFor(ValuePtr(), rank, fr);
     }
     TensorView<ElemType> GradientTensorFor(size_t rank, const FrameRange& fr)
     {
+        const auto* cached = m_gradient ? CachedDataTensorFor(m_gradientViewCache, Gradient(), rank, fr) : nullptr;
+        if (cached)
+            return *cached;
         return DataTensorFor(GradientPtr(), rank, fr);
     }
 
@@ -1563,6 +1696,12 @@ public:
 
 private:
 
+    // last size that BeginForwardProp() set the value matrix to, so that re-setup can be
+    // skipped when nothing changed between minibatches (see BeginForwardProp())
+    const MatrixBase* m_lastSetupValueMatrix = nullptr;
+    size_t m_lastSetupRows = 0;
+    size_t m_lastSetupCols = 0;
+
     // determine the size that we should set our Matrix storage to
     void DetermineDataSize(size_t& rows, size_t& cols) const
     {
@@ -1628,13 +1767,46 @@ public:
 
         // update the actual m_value allocation
         if (!IsLeaf() && !RequiresPreCompute()) // TODO: guard this through overrides instead
-            UpdateFunctionValuesSize();
+        {
+            // Incremental re-setup: derive the target size once. If this node's buffer is
+            // private (not aliased through the matrix pool) and neither the buffer nor the
+            // target size changed since the last minibatch, the matrix is exactly as we left
+            // it, and the resize and verification are skipped. Aliased buffers must always be
+            // resized, since another node may have used them in between. A dimension change
+            // from re-validation is caught here as well, since the size is re-derived from
+            // the current sample layout and MBLayout every time.
+            size_t rows, cols;
+            DetermineDataSize(rows, cols);
+            Matrix<ElemType>& value = Value();
+            if (rows != m_lastSetupRows || cols != m_lastSetupCols || &value != m_lastSetupValueMatrix || m_value.use_count() > 1)
+            {
+                value.Resize(rows, cols);
+                value.CollapseDataLocation();
 
-        // give nodes a chance to update their internal state that may also have to match MB size
-        UpdateFunctionMBSize();
+                // give nodes a chance to update their internal state that may also have to match MB size
+                UpdateFunctionMBSize();
 
-        // and make sure dimensions are what we expect
-        VerifyDataSize(Value());
+                // and make sure dimensions are what we expect
+                VerifyDataSize(value);
+
+                m_lastSetupValueMatrix = &value;
+                m_lastSetupRows = rows;
+                m_lastSetupCols = cols;
+            }
+            else
+            {
+                // still give nodes the chance to update temporaries, which may be pool-shared
+                UpdateFunctionMBSize();
+            }
+        }
+        else
+        {
+            // give nodes a chance to update their internal state that may also have to match MB size
+            UpdateFunctionMBSize();
+
+            // and make sure dimensions are what we expect
+            VerifyDataSize(Value());
+        }
     }
 
     // NaN checks
@@ -1769,7 +1941,7 @@ public:
     virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
     {
         if (IsValueSharable())
-            RequestMatrixFromPool(m_value, matrixPool);
+            RequestMatrixFromPool(m_value, matrixPool, GetSampleLayout().GetNumElements(), HasMBLayout());
         else
             CreateMatrixIfNull(m_value);
     }
@@ -1778,7 +1950,8 @@ public:
     // don't release matrices that need to be used in the gradient computation
     virtual void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool) override
     {
-        if (!IsOutputNeededDuringBackprop() && (m_value->GetMatrixType() != SPARSE) && IsValueSharable())
+        // a still-null member is a pending pool request, which is always dense
+        if (!IsOutputNeededDuringBackprop() && (m_value == nullptr || m_value->GetMatrixType() != SPARSE) && IsValueSharable())
             ReleaseMatrixToPool(m_value, matrixPool);
     }
 
@@ -1794,7 +1967,7 @@ public:
     // request matrices that are needed for gradient computation
     virtual void RequestMatricesBeforeBackprop(MatrixPool& matrixPool) override
     {
-        RequestMatrixFromPool(m_gradient, matrixPool);
+        RequestMatrixFromPool(m_gradient, matrixPool, GetSampleLayout().GetNumElements(), HasMBLayout());
     }
 
     // release gradient and temp matrices that no longer needed after all the children's gradients are computed.
@@ -1802,12 +1975,12 @@ public:
     {
         if (!IsLeaf() && !RequiresPreCompute())
         {
-            if (m_gradient != nullptr && m_gradient->GetMatrixType() != SPARSE) // since we don't have a sparse pool yet
+            if (m_gradient == nullptr || m_gradient->GetMatrixType() != SPARSE) // since we don't have a sparse pool yet
                 ReleaseMatrixToPool(m_gradient, matrixPool);
 
             // Release the Value matrix only if the output value is needed during backprop
             // since in the case it isn't used, we release it during forward prop itself
-            if (IsOutputNeededDuringBackprop() && m_value->GetMatrixType() != SPARSE && IsValueSharable())
+            if (IsOutputNeededDuringBackprop() && (m_value == nullptr || m_value->GetMatrixType() != SPARSE) && IsValueSharable())
                 ReleaseMatrixToPool(m_value, matrixPool);
         }
     }
@@ -1839,18 +2012,21 @@ protected:
             matrixPtr = make_shared<Matrix<ElemType>>(m_deviceId);
     }
 
-    void RequestMatrixFromPool(shared_ptr<Matrix<ElemType>>& matrixPtr, MatrixPool& matrixPool)
+    // Requests and releases only record lifetime intervals; the matrix member stays null until
+    // MatrixPool::OptimizedMemoryAllocation() assigns buffers at the end of AllocateAllMatrices().
+    // matrixSize is a size estimate in elements used to prioritize buffer assignment (0 = unknown,
+    // e.g. for workspaces); mbScale says whether the size scales with the minibatch size.
+    void RequestMatrixFromPool(shared_ptr<Matrix<ElemType>>& matrixPtr, MatrixPool& matrixPool, size_t matrixSize = 0, bool mbScale = false)
     {
         if (matrixPtr == nullptr)
         {
-            matrixPtr = matrixPool.Request<ElemType>(m_deviceId);
+            matrixPool.RequestAllocate<ElemType>(m_deviceId, &matrixPtr, matrixSize, mbScale);
         }
     }
 
     void ReleaseMatrixToPool(shared_ptr<Matrix<ElemType>>& matrixPtr, MatrixPool& matrixPool)
     {
-        assert(matrixPtr != nullptr);
-        matrixPool.Release<ElemType>(matrixPtr);
+        matrixPool.RequestRelease<ElemType>(&matrixPtr);
     }
 
 public:
@@ -1867,6 +2043,15 @@ public:
                                       const std::string& sampleSeparator, std::string valueFormatString,
                                       bool outputGradient = false, bool onlyShowAbsSumForDense = false) const;
 
+    // same, but with a caller-provided host buffer that is reused (and grown as needed) across calls,
+    // so that bulk output does not reallocate a full copy of the minibatch per node and minibatch
+    void WriteMinibatchWithFormatting(FILE* f, const FrameRange& fr, size_t onlyUpToRow, size_t onlyUpToT, bool transpose, bool isCategoryLabel, bool isSparse,
+                                      const std::vector<std::string>& labelMapping, const std::string& sequenceSeparator, 
+                                      const std::string& sequencePrologue, const std::string& sequenceEpilogue, const std::string& elementSeparator,
+                                      const std::string& sampleSeparator, std::string valueFormatString,
+                                      bool outputGradient, bool onlyShowAbsSumForDense,
+                                      ElemType*& scratchBuffer, size_t& scratchBufferSize) const;
+
     // simple helper to log the content of a minibatch
     void DebugLogMinibatch(bool outputGradient = false) const
     {
@@ -500,7 +500,28 @@ public:
     void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
     {
         Base::RequestMatricesBeforeForwardProp(matrixPool);
-        RequestMatrixFromPool(m_tempMatrix, matrixPool);
+        // Plan the im2col workspace with the engine's per-sample size bound (known once the
+        // geometry is fixed in Validate()), so the pool treats it like any other
+        // minibatch-scaled tensor instead of an unknown-size request that gets grown by
+        // per-call Resize. Sequentially scheduled convolution nodes then share one
+        // right-sized workspace buffer.
+        size_t workspaceSize = (m_convEng != nullptr) ? m_convEng->WorkspaceSize(1) : 0;
+        RequestMatrixFromPool(m_tempMatrix, matrixPool, workspaceSize, /* mbScale = */ workspaceSize != 0);
+    }
+
+    void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool) override
+    {
+        Base::ReleaseMatricesAfterForwardProp(matrixPool);
+        // The workspace is scratch whose contents do not carry over from forward to backprop;
+        // handing it back between the phases lets other nodes alias it in the meantime.
+        ReleaseMatrixToPool(m_tempMatrix, matrixPool);
+    }
+
+    void RequestMatricesBeforeBackprop(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeBackprop(matrixPool);
+        size_t workspaceSize = (m_convEng != nullptr) ? m_convEng->WorkspaceSize(1) : 0;
+        RequestMatrixFromPool(m_tempMatrix, matrixPool, workspaceSize, /* mbScale = */ workspaceSize != 0);
     }
 
     void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool) override
@@ -415,6 +415,8 @@ void LearnableParameter<ElemType>::Save(File& fstream) const /*override*/
 {
     if (!m_initString.empty())
         LogicError("LearnableParameter: Cannot Save() before deferred initialization has completed.");
+    // a value whose load was deferred must be read in before it can be written back out
+    const_cast<LearnableParameter<ElemType>*>(this)->EnsureValueIsLoaded();
     Base::Save(fstream);
     fstream << m_learningRateMultiplier;
     m_sampleLayout.Save(fstream);
@@ -451,16 +453,86 @@ void LearnableParameter<ElemType>::Load(File& fstream, size_t modelVersion) /*ov
         }
     }
 
-    LoadValue(fstream);
+    // When lazy parameter loading is enabled, only record where the value lives in the file and
+    // skip over it; EnsureValueIsLoaded() reads it in on first use.
+    if (Globals::ShouldLazyLoadParameters() && fstream.CanSeek() && !fstream.IsTextBased())
+        DeferLoadValue(fstream);
+    else
+        LoadValue(fstream);
     SetDims(sampleLayout, false); // note: call this after LoadValue() since LoadValue() overwrites m_sampleLayout
     VerifyDataSize(Value());      // sanity check
 
     m_initString.clear(); // deferred initialization not possible after loading
 }
 
+// record the location of the value payload in the model file and seek past it
+// This duplicates the framing that Matrix<ElemType>::Read()/operator>>(File&, CPUMatrix&) expect;
+// anything this cannot handle (sparse matrices, element-size mismatch) falls back to reading eagerly.
+template <class ElemType>
+void LearnableParameter<ElemType>::DeferLoadValue(File& fstream)
+{
+    uint64_t matrixStart = fstream.GetPosition();
+
+    char type;
+    fstream >> type;
+    size_t elsize = 0;
+    if (type == 'd') // dense matrix: 'd', BMAT marker, elsize, name, format, dims, data, EMAT marker
+    {
+        fstream.GetMarker(fileMarkerBeginSection, std::wstring(L"BMAT"));
+        fstream >> elsize;
+    }
+    if (elsize != sizeof(ElemType)) // sparse, or a float/double mismatch: let the eager path deal with it
+    {
+        fstream.SetPosition(matrixStart);
+        LoadValue(fstream);
+        return;
+    }
+
+    std::wstring matrixName;
+    int format;
+    size_t numRows, numCols;
+    fstream >> matrixName >> format >> numRows >> numCols;
+
+    m_valueLoadFilePath = fstream.Filename();
+    m_valueLoadOffset = fstream.GetPosition();
+    m_valueLoadNumRows = numRows;
+    m_valueLoadNumCols = numCols;
+
+    fstream.SetPosition(m_valueLoadOffset + numRows * numCols * sizeof(ElemType));
+    fstream.GetMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
+
+    // allocate the matrix at its final dimensions (contents stay undefined until materialized),
+    // so that validation and memory planning see the real geometry
+    CreateMatrixIfNull(m_value);
+    Value().Resize(numRows, numCols);
+    SetDims(TensorShape(numRows, numCols), false);
+
+    m_valueLoadDeferred = true;
+}
+
+template <class ElemType>
+void LearnableParameter<ElemType>::EnsureValueIsLoaded() /*override*/
+{
+    if (!m_valueLoadDeferred)
+        return;
+    std::lock_guard<std::mutex> lock(m_valueLoadMutex);
+    if (!m_valueLoadDeferred) // lost the race against the prefetch thread: value is already there
+        return;
+
+    File fstream(m_valueLoadFilePath, FileOptions::fileOptionsBinary | FileOptions::fileOptionsRead);
+    fstream.SetPosition(m_valueLoadOffset);
+    std::vector<ElemType> buffer(m_valueLoadNumRows * m_valueLoadNumCols);
+    fstream.GetArray(buffer.data(), buffer.size());
+    Value().SetValue(m_valueLoadNumRows, m_valueLoadNumCols, Value().GetDeviceId(), buffer.data(), matrixFlagNormal);
+
+    m_valueLoadDeferred = false;
+}
+
 template <class ElemType>
 /*virtual*/ void LearnableParameter<ElemType>::CopyTo(ComputationNodeBasePtr nodeP, const wstring& newName, const CopyNodeFlags flags) const /*override*/
 {
+    // Base::CopyTo() copies m_value, so a deferred value must be materialized first
+    const_cast<LearnableParameter<ElemType>*>(this)->EnsureValueIsLoaded();
     Base::CopyTo(nodeP, newName, flags);
     if (flags & CopyNodeFlags::copyNodeValue)
     {
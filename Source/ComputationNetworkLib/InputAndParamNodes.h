@@ -11,6 +11,8 @@
 #include "Matrix.h"
 
 #include <string>
+#include <atomic>
+#include <mutex>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -125,6 +127,11 @@ public:
     virtual void Save(File& fstream) const override;
     virtual void Load(File& fstream, size_t modelVersion) override;
 
+    // deferred value loading (lazyParameterLoad): Load() only records where the value lives in
+    // the model file; this reads it in on first use. Called from the forward-prop traversal and
+    // from the background prefetch thread, hence the lock.
+    virtual void EnsureValueIsLoaded() override;
+
     virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override;
 
     // computation functions don't do anything for parameter nodes
@@ -165,6 +172,14 @@ private:
 
     // flags related to gradient update
     float m_regMultiplier; // The multiplier to adjust the L1Reg and L2Reg for Learnable node
+
+    // state for deferred value loading (lazyParameterLoad); see Load()/EnsureValueIsLoaded()
+    void DeferLoadValue(File& fstream);
+    std::atomic<bool> m_valueLoadDeferred{false};
+    std::mutex m_valueLoadMutex;
+    std::wstring m_valueLoadFilePath; // model file to read the value from
+    uint64_t m_valueLoadOffset;       // position of the raw element data within that file
+    size_t m_valueLoadNumRows, m_valueLoadNumCols;
 };
 
 // -----------------------------------------------------------------------
@@ -612,6 +627,22 @@ public:
         gradientValues.Reshape(rowsp, colsp);
     }
 
+    virtual void AllocateGradientMatricesForInputs(MatrixPool& matrixPool) override
+    {
+        // If the input (one-hot or few-hot word indices) is sparse, then the gradient of the embedding
+        // matrix will also be sparse: only the columns of the words seen in the minibatch are touched.
+        // Use block-sparse-column so the learner and aggregators only process the touched columns.
+        if (Input(0)->NeedsGradient() && Input(1)->Value().GetMatrixType() == SPARSE)
+        {
+            // We need a sparse matrix for the gradient. We will allocate later (as needed),
+            // but make the type sparse now, so that the memory pool does not hand out a shared dense one.
+            InputRef(0).GradientPtrRef() = std::make_shared<Matrix<ElemType>>(0, 0, Gradient().GetPreferredDeviceId(), SPARSE, MatrixFormat::matrixFormatSparseBlockCol);
+        }
+
+        // Request the rest from the pool.
+        Base::AllocateGradientMatricesForInputs(matrixPool);
+    }
+
     virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& t) override
     {
         // input0 is the weight (each column is an embedding of one word), input 1 contains m_nbrLooked words in each column (sample)
@@ -104,15 +104,15 @@ template <class ElemType>
 void EpochAccumulatorNode<ElemType>::RequestMatricesBeforeForwardProp(MatrixPool& matrixPool)
 {
     Base::RequestMatricesBeforeForwardProp(matrixPool);
-    RequestMatrixFromPool(m_accumulator, matrixPool);
-    const size_t sampleSize = GetSampleLayout().GetNumElements();
-    m_accumulator->Resize(sampleSize, 1);
-    Reset();
+    // the accumulator persists across minibatches, so it is requested but never released back;
+    // it cannot be sized here since pooled matrices only materialize once all lifetimes are known
+    RequestMatrixFromPool(m_accumulator, matrixPool, GetSampleLayout().GetNumElements());
 }
 
 template <class ElemType>
 void EpochAccumulatorNode<ElemType>::Reset()
 {
+    m_accumulator->Resize(GetSampleLayout().GetNumElements(), 1);
     m_accumulator->SetValue(0);
     m_numSamples = 0;
 }
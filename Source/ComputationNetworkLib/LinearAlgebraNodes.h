@@ -72,6 +72,66 @@ public:
 template class PlusNode<float>;
 template class PlusNode<double>;
 
+// -----------------------------------------------------------------------
+// FusedBinaryUnaryNode (operand1, operand2)
+// Computes unaryOp(binaryOp(operand1, operand2)), e.g. Sigmoid(Plus(a, b)), in a single node.
+// Created only by the operator-fusion pass during network compilation
+// (ComputationNetwork::FuseElementwiseChains()); it cannot be built from BrainScript and is
+// never saved (fusion runs after load, on the in-memory graph). The unary op is applied in
+// place on this node's own output, so the inner node's activation buffer disappears entirely.
+// Forward only: the fusion pass is meant for serving/eval graphs and must stay off for training.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class FusedBinaryUnaryNode : public BinaryElementWiseNode<ElemType>
+{
+    typedef BinaryElementWiseNode<ElemType> Base; UsingBinaryElementwiseNodeBaseMembers;
+    static const std::wstring TypeName() { return L"FusedBinaryUnary"; }
+
+public:
+    FusedBinaryUnaryNode(DEVICEID_TYPE deviceId, const wstring& name,
+                         ElementWiseOperator binaryOp = ElementWiseOperator::opSum,
+                         ElementWiseOperator unaryOp = ElementWiseOperator::opCopy)
+        : Base(deviceId, name), m_binaryOp(binaryOp), m_unaryOp(unaryOp)
+    {
+    }
+
+    virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
+    {
+        size_t rank = DetermineElementwiseTensorRank();
+        auto result =             ValueTensorFor(rank, fr);
+        auto input0 = InputRef(0).ValueTensorFor(rank, fr.AllowBroadcast());
+        auto input1 = InputRef(1).ValueTensorFor(rank, fr.AllowBroadcast());
+        result.DoBinaryOpOf(0, input0, input1, 1, m_binaryOp, ElementWiseOperator::opSum);
+        if (m_unaryOp != ElementWiseOperator::opCopy)
+            result.DoUnaryOpOf(0, result, 1, m_unaryOp, ElementWiseOperator::opSum); // in place
+    }
+
+    virtual void /*ComputationNode::*/ BackpropTo(const size_t /*inputIndex*/, const FrameRange& /*fr*/) override
+    {
+        LogicError("%ls %ls operation is forward-only; disable nodeFusion (Globals::SetNodeFusion) for training.",
+                   NodeName().c_str(), OperationName().c_str());
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<FusedBinaryUnaryNode<ElemType>>(nodeP);
+            node->m_binaryOp = m_binaryOp;
+            node->m_unaryOp = m_unaryOp;
+        }
+    }
+
+private:
+    ElementWiseOperator m_binaryOp; // inner elementwise op combining the two inputs
+    ElementWiseOperator m_unaryOp;  // epilogue applied in place (opCopy = none)
+};
+
+template class FusedBinaryUnaryNode<float>;
+template class FusedBinaryUnaryNode<double>;
+
 // -----------------------------------------------------------------------
 // LogPlusNode (summand1, summand2)
 // Computes ln(exp(summand1) + exp(summand2)) in an overflow safe way.
@@ -666,8 +726,13 @@ class QuantizedTimesNode : public TimesNodeBase<ElemType, false>
 
 private:
     // Quantizer bit shift for matrices A and B
-    size_t m_bitShiftA; 
-    size_t m_bitShiftB; 
+    size_t m_bitShiftA;
+    size_t m_bitShiftB;
+
+    // Timestamps of the parameter inputs when their cached quantized copies were last prepared
+    // (see ForwardProp); initialized so that the first call always prepares them
+    uint64_t m_paramTimeStampA = (uint64_t) -1;
+    uint64_t m_paramTimeStampB = (uint64_t) -1;
 
 public:
     QuantizedTimesNode(DEVICEID_TYPE deviceId, const wstring& name, size_t bitShiftA = 1, size_t bitShiftB = 1, size_t outputRank = 1, int inferInputRankToMap = -1)
@@ -715,10 +780,29 @@ public:
 
     virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
     {
+        // Frozen-weight cache: a parameter input is treated as constant, so its quantized and
+        // (for A) block-reordered copy is prepared once and reused across evaluations instead
+        // of being re-derived per call. The cache is keyed on the parameter's timestamp, which
+        // is bumped whenever its value is updated, so fine-tuning between evaluations
+        // invalidates the cached copy correctly.
         if (dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(0)))
+        {
             this->m_pQuantizedMultiplier->SetIsAConstant(true);
+            if (Input(0)->GetEvalTimeStamp() != m_paramTimeStampA)
+            {
+                m_paramTimeStampA = Input(0)->GetEvalTimeStamp();
+                this->m_pQuantizedMultiplier->InvalidateCachedA();
+            }
+        }
         if (dynamic_pointer_cast<LearnableParameter<ElemType>>(Input(1)))
+        {
             this->m_pQuantizedMultiplier->SetIsBConstant(true);
+            if (Input(1)->GetEvalTimeStamp() != m_paramTimeStampB)
+            {
+                m_paramTimeStampB = Input(1)->GetEvalTimeStamp();
+                this->m_pQuantizedMultiplier->InvalidateCachedB();
+            }
+        }
 
         Base::ForwardProp(fr);
     }
@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <climits>
 #include <stdlib.h>
 
 #include "Basics.h"
@@ -17,59 +18,154 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// MemRequestInfo -- the lifetime intervals recorded for one matrix member while
+// AllocateAllMatrices() simulates the forward/backward schedule. pMatrixPtr points at the
+// requesting node's matrix member, which stays unassigned until OptimizedMemoryAllocation()
+// has seen all intervals. A member normally has a single first-use/last-use interval; with
+// activation recomputation a released value can be re-requested for the backward pass, which
+// opens a second disjoint interval on the same member.
+template <class ElemType>
+struct MemRequestInfo
+{
+    DEVICEID_TYPE deviceId;                   // the device the matrix will live on
+    shared_ptr<Matrix<ElemType>>* pMatrixPtr; // the matrix member to fill in once buffers are assigned
+    size_t matrixSize;                        // size estimate in elements (0 = unknown, e.g. workspaces)
+    bool mbScale;                             // true if the size scales with the minibatch size
+    vector<pair<int, int>> intervals;         // (Request step, Release step) pairs; INT_MAX = never released
+
+    MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>* pMatrixPtr, size_t matrixSize, bool mbScale, int allocStep)
+        : deviceId(deviceId), pMatrixPtr(pMatrixPtr), matrixSize(matrixSize), mbScale(mbScale)
+    {
+        intervals.push_back(make_pair(allocStep, INT_MAX));
+    }
+};
+
 // MatrixPool -- class to support memory sharing
-// Despite the gather general name of this class, it is specifically designed to support the memory sharing of ComputationNodes.
+// Despite the rather general name of this class, it is specifically designed to support the memory sharing of ComputationNodes.
+// AllocateAllMatrices() records a Request/Release interval for every matrix as it simulates the
+// forward/backward schedule, then calls OptimizedMemoryAllocation(), which assigns intervals to
+// buffers by interval-graph coloring (largest tensors first) so that matrices with disjoint
+// lifetimes alias the same storage--including across the forward/backward phase boundary.
 // Note: see #define SUPRESS_MEMSHARING below as for how to temporarily disable memory sharing altogether, for debugging
 class MatrixPool
 {
-    vector<shared_ptr<Matrix<float>>>  m_releasedFloatMatrices;
-    vector<shared_ptr<Matrix<double>>> m_releasedDoubleMatrices;
+    vector<MemRequestInfo<float>>  m_memRequestInfoFloatVec;
+    vector<MemRequestInfo<double>> m_memRequestInfoDoubleVec;
+    int m_stepCounter = 0;
 
     template <class ElemType>
-    vector<shared_ptr<Matrix<ElemType>>>& GetReleasedMatrices();
+    vector<MemRequestInfo<ElemType>>& GetMemRequestInfoVec();
 
 public:
-    // release here means the matrix can be put back and shared by others
+    // record that matrixPtr is first used at the current step; the matrix itself is created in OptimizedMemoryAllocation()
     template <class ElemType>
-    void Release(shared_ptr<Matrix<ElemType>> freeMatrix)
+    void RequestAllocate(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>* pMatrixPtr, size_t matrixSize, bool mbScale)
     {
-        if (freeMatrix == nullptr || freeMatrix->GetMatrixType() == SPARSE)
-            LogicError("MatrixPool::Release: freeMatrix should not be null or sparse.");
-//#define SUPRESS_MEMSHARING // #define this to disable memory sharing through this structure
-        // TODO: Make this a runtime option.
-#ifndef SUPRESS_MEMSHARING
-        vector<shared_ptr<Matrix<ElemType>>>& releasedMatrices = GetReleasedMatrices<ElemType>();
-#ifdef _DEBUG
-        for (int i = 0; i < releasedMatrices.size(); i++)
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        for (auto& memInfo : memInfoVec)
         {
-            if (releasedMatrices[i] == freeMatrix)
-                RuntimeError("MatrixPool::Release: freeMatrix is already in the released pool.");
+            if (memInfo.pMatrixPtr == pMatrixPtr)
+            {
+                // a matrix member may be requested more than once, e.g. a gradient once per parent;
+                // while its interval is still open a second Request is a no-op (matching the old
+                // behavior where it was a no-op because the member was already assigned)
+                if (memInfo.intervals.back().second == INT_MAX)
+                    return;
+                // a Request after a Release reopens the member for a second lifetime on the same
+                // buffer; this is how recomputed activations are planned for the backward pass
+                memInfo.intervals.push_back(make_pair(m_stepCounter, INT_MAX));
+                m_stepCounter++;
+                return;
+            }
         }
-
-#endif
-        releasedMatrices.push_back(freeMatrix);
-#endif
+        memInfoVec.push_back(MemRequestInfo<ElemType>(deviceId, pMatrixPtr, matrixSize, mbScale, m_stepCounter));
+        m_stepCounter++;
     }
 
+    // record that matrixPtr is last used at the current step
     template <class ElemType>
-    shared_ptr<Matrix<ElemType>> Request(DEVICEID_TYPE deviceId)
+    void RequestRelease(shared_ptr<Matrix<ElemType>>* pMatrixPtr)
     {
-        vector<shared_ptr<Matrix<ElemType>>>& releasedMatrices = GetReleasedMatrices<ElemType>();
-        shared_ptr<Matrix<ElemType>> matrixPtr;
-        if (releasedMatrices.empty())
+        // close the open interval for this matrix member, if any
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        for (auto& memInfo : memInfoVec)
         {
-            matrixPtr = make_shared<Matrix<ElemType>>(deviceId);
+            if (memInfo.pMatrixPtr == pMatrixPtr && memInfo.intervals.back().second == INT_MAX)
+            {
+                memInfo.intervals.back().second = m_stepCounter;
+                break;
+            }
         }
-        else
+        m_stepCounter++;
+    }
+
+    // solve the buffer assignment for all recorded intervals and create the actual matrices
+    void OptimizedMemoryAllocation()
+    {
+        OptimizedMemoryAllocationFunc<float>();
+        OptimizedMemoryAllocationFunc<double>();
+        m_stepCounter = 0;
+    }
+
+private:
+    template <class ElemType>
+    void OptimizedMemoryAllocationFunc()
+    {
+        vector<MemRequestInfo<ElemType>>& memInfoVec = GetMemRequestInfoVec<ElemType>();
+        if (memInfoVec.empty())
+            return;
+
+        // one shared buffer and the lifetime intervals currently assigned to it
+        struct MemBuffer
         {
-            matrixPtr = releasedMatrices.back();
-            releasedMatrices.pop_back();
-        }
+            DEVICEID_TYPE deviceId;
+            bool mbScale;
+            vector<pair<int, int>> intervals;
+            shared_ptr<Matrix<ElemType>> matrixPtr;
+        };
+        vector<MemBuffer> buffers;
 
-        if (!matrixPtr) // this can't really happen
-            LogicError("MatrixPool::Request: failed to get a valid matrix.");
+        // assign the largest tensors first so they get first pick of the buffers they can
+        // share; ties keep schedule order. Sorting by a size estimate rather than an exact
+        // size is fine: a wrong estimate only costs sharing quality, never correctness.
+        vector<size_t> order(memInfoVec.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return memInfoVec[a].matrixSize > memInfoVec[b].matrixSize; });
 
-        return matrixPtr;
+        for (size_t i : order)
+        {
+            MemRequestInfo<ElemType>& memInfo = memInfoVec[i];
+            MemBuffer* assigned = nullptr;
+//#define SUPRESS_MEMSHARING // #define this to disable memory sharing through this structure
+#ifndef SUPRESS_MEMSHARING
+            for (auto& buffer : buffers)
+            {
+                // minibatch-scaled tensors never alias fixed-size ones: their relative sizes change at runtime
+                if (buffer.deviceId != memInfo.deviceId || buffer.mbScale != memInfo.mbScale)
+                    continue;
+                // all lifetime intervals of this member must fit the same buffer, since there is
+                // only one member pointer to assign
+                bool overlaps = false;
+                for (const auto& myInterval : memInfo.intervals)
+                    for (const auto& interval : buffer.intervals)
+                        overlaps |= (myInterval.first <= interval.second && interval.first <= myInterval.second);
+                if (!overlaps)
+                {
+                    assigned = &buffer;
+                    break;
+                }
+            }
+#endif
+            if (assigned == nullptr)
+            {
+                buffers.push_back(MemBuffer{memInfo.deviceId, memInfo.mbScale, {}, make_shared<Matrix<ElemType>>(memInfo.deviceId)});
+                assigned = &buffers.back();
+            }
+            assigned->intervals.insert(assigned->intervals.end(), memInfo.intervals.begin(), memInfo.intervals.end());
+            *memInfo.pMatrixPtr = assigned->matrixPtr;
+        }
+        memInfoVec.clear();
     }
 };
 
@@ -10,9 +10,11 @@
 #include "LinearAlgebraNodes.h"
 #include "Matrix.h"
 
+#include <functional>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -190,6 +192,12 @@ public:
         }
     }
 
+    // Merge statistics accumulated over disjoint corpus shards by data-parallel workers.
+    // 'allReduceInPlace' must element-wise sum a vector of doubles across all workers; the
+    // caller (SGD's precompute pass) invokes this between the accumulation loop and
+    // MarkComputed(true), on all workers, for all precompute nodes in the same order.
+    virtual void MergeAccumulatorsAcrossWorkers(const std::function<void(std::vector<double>&)>& allReduceInPlace) = 0;
+
 protected:
     size_t m_numSamples; // (SIZE_MAX while outside accumulation state)
     bool IsAccumulating() const { return m_numSamples != SIZE_MAX; }
@@ -248,6 +256,32 @@ public:
 
         UpdateRunningAverage(InputRef(0), mean, m_numSamples);
     }
+
+    virtual void MergeAccumulatorsAcrossWorkers(const std::function<void(std::vector<double>&)>& allReduceInPlace) override
+    {
+        if (!IsAccumulating())
+            LogicError("%ls %ls operation: MergeAccumulatorsAcrossWorkers() called outside of accumulation.", NodeName().c_str(), OperationName().c_str());
+
+        // ship the sample count and the running mean scaled back to a per-shard sum, so that
+        // element-wise summation across workers is the merge
+        size_t numElements = Value().GetNumElements();
+        std::unique_ptr<ElemType[]> mean(Value().CopyToArray());
+        std::vector<double> sums(numElements + 1);
+        sums[0] = (double) m_numSamples;
+        for (size_t i = 0; i < numElements; i++)
+            sums[i + 1] = (double) mean[i] * (double) m_numSamples;
+
+        allReduceInPlace(sums);
+
+        size_t totalNumSamples = (size_t) (sums[0] + 0.5);
+        if (totalNumSamples == 0) // no worker saw any data; leave the (zero) accumulator alone
+            return;
+        for (size_t i = 0; i < numElements; i++)
+            mean[i] = (ElemType) (sums[i + 1] / totalNumSamples);
+
+        Value().SetValue(Value().GetNumRows(), Value().GetNumCols(), Value().GetDeviceId(), mean.get());
+        m_numSamples = totalNumSamples;
+    }
 };
 
 template class MeanNode<float>;
@@ -342,6 +376,53 @@ public:
         m_numSamples += InputRef(0).GetMBLayout()->GetActualNumSamples();
     }
 
+    virtual void MergeAccumulatorsAcrossWorkers(const std::function<void(std::vector<double>&)>& allReduceInPlace) override
+    {
+        if (!IsAccumulating())
+            LogicError("%ls %ls operation: MergeAccumulatorsAcrossWorkers() called outside of accumulation.", NodeName().c_str(), OperationName().c_str());
+
+        size_t numElements = m_mean->GetNumElements();
+        std::unique_ptr<ElemType[]> mean(m_mean->CopyToArray());
+        std::unique_ptr<ElemType[]> var (m_var ->CopyToArray());
+
+        // first reduction: sample count and first moment as per-shard sums
+        std::vector<double> sums(numElements + 1);
+        sums[0] = (double) m_numSamples;
+        for (size_t i = 0; i < numElements; i++)
+            sums[i + 1] = (double) mean[i] * (double) m_numSamples;
+
+        allReduceInPlace(sums);
+
+        size_t totalNumSamples = (size_t) (sums[0] + 0.5);
+        if (totalNumSamples == 0) // no worker saw any data; leave the (zero) accumulators alone
+            return;
+        std::vector<double> globalMean(numElements);
+        for (size_t i = 0; i < numElements; i++)
+            globalMean[i] = sums[i + 1] / totalNumSamples;
+
+        // second reduction: second moments shifted to the global mean (parallel-axis theorem).
+        // Shifting keeps the summands on the scale of the variance itself, avoiding the
+        // cancellation a raw sum-of-squares would suffer when the variance is small relative
+        // to the mean.
+        std::vector<double> sqSums(numElements);
+        for (size_t i = 0; i < numElements; i++)
+        {
+            double shift = (double) mean[i] - globalMean[i];
+            sqSums[i] = ((double) var[i] + shift * shift) * (double) m_numSamples;
+        }
+
+        allReduceInPlace(sqSums);
+
+        for (size_t i = 0; i < numElements; i++)
+        {
+            mean[i] = (ElemType) globalMean[i];
+            var[i]  = (ElemType) (sqSums[i] / totalNumSamples);
+        }
+        m_mean->SetValue(m_mean->GetNumRows(), m_mean->GetNumCols(), m_mean->GetDeviceId(), mean.get());
+        m_var ->SetValue(m_var ->GetNumRows(), m_var ->GetNumCols(), m_var ->GetDeviceId(), var.get());
+        m_numSamples = totalNumSamples;
+    }
+
     virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
     {
         Base::CopyTo(nodeP, newName, flags);
@@ -106,6 +106,10 @@ private:
 
     RnnAttributes m_rnnAttributes;
 
+    // how many sequences are packed into each frame, derived from the MBLayout in PackSequencesForCuDNN()
+    // (per node: two RNN nodes in one network see different layouts)
+    std::vector<size_t> m_numSequencesForFrame;
+
     bool m_legacySwapInputsPending = false; // to support an internal legacy version
 };
 
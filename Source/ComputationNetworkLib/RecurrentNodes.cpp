@@ -35,6 +35,7 @@ DelayedValueNodeBase<ElemType, direction>::DelayedValueNodeBase(DEVICEID_TYPE de
 {
     m_initialStateValue = initialState;
     m_timeStep = 1;
+    m_inputInvalidMatrixZeroedCols = 0;
     CreateMatrixIfNull(m_value);
     SetDims(sampleLayout, HasMBLayout() /*false at this point*/);
     m_initialStateValueMatrix->Resize(1, 1);
@@ -123,46 +124,55 @@ template<class ElemType, int direction>
     // So the V2 library just sets the sequence tBegin to be SentinelValueIndicatingUnspecifedSequenceBeginIdx if the sequence
     // does not begin in the current MB and we patch the actual tBegin in by obtaining the info from the saved m_delayedActivationMBLayout.
 
-    // Collect the trailing sequences in each parallel stream in the previous MB
-    // TODO: Switch to a vector instead of an unordered_map
-    std::unordered_map<size_t, MBLayout::SequenceInfo> trailingSequencesOfLastMB;
-    if (m_delayedActivationMBLayout)
+    // Scan for sentinels first, so that the common case of no truncated V2 sequences pays none of the patching cost.
+    bool anySequencesToPatch = false;
+    for (const auto& sequenceInfo : m_pMBLayout->GetAllSequences())
     {
-        const auto& prevMBSequences = m_delayedActivationMBLayout->GetAllSequences();
-        for (const auto& sequenceInfo : prevMBSequences)
+        if (sequenceInfo.seqId != GAP_SEQUENCE_ID && sequenceInfo.tBegin == SentinelValueIndicatingUnspecifedSequenceBeginIdx)
         {
-            if (sequenceInfo.seqId != GAP_SEQUENCE_ID)
+            anySequencesToPatch = true;
+            break;
+        }
+    }
+
+    if (anySequencesToPatch)
+    {
+        // Collect the trailing sequences in each parallel stream in the previous MB
+        // TODO: Switch to a vector instead of an unordered_map
+        std::unordered_map<size_t, MBLayout::SequenceInfo> trailingSequencesOfLastMB;
+        if (m_delayedActivationMBLayout)
+        {
+            const auto& prevMBSequences = m_delayedActivationMBLayout->GetAllSequences();
+            for (const auto& sequenceInfo : prevMBSequences)
             {
-                auto insertPos = trailingSequencesOfLastMB.insert({ sequenceInfo.s, sequenceInfo });
-                if (!insertPos.second)
+                if (sequenceInfo.seqId != GAP_SEQUENCE_ID)
                 {
-                    if (trailingSequencesOfLastMB[sequenceInfo.s].tBegin < sequenceInfo.tBegin)
-                        trailingSequencesOfLastMB[sequenceInfo.s] = sequenceInfo;
+                    auto insertPos = trailingSequencesOfLastMB.insert({ sequenceInfo.s, sequenceInfo });
+                    if (!insertPos.second)
+                    {
+                        if (trailingSequencesOfLastMB[sequenceInfo.s].tBegin < sequenceInfo.tBegin)
+                            trailingSequencesOfLastMB[sequenceInfo.s] = sequenceInfo;
+                    }
                 }
             }
         }
-    }
 
-    bool anySequencesPatched = false;
-    std::vector<MBLayout::SequenceInfo> patchedMBSequences = m_pMBLayout->GetAllSequences();
-    for (auto& patchedSequenceInfo : patchedMBSequences)
-    {
-        if (patchedSequenceInfo.seqId != GAP_SEQUENCE_ID)
+        std::vector<MBLayout::SequenceInfo> patchedMBSequences = m_pMBLayout->GetAllSequences();
+        for (auto& patchedSequenceInfo : patchedMBSequences)
         {
-            if (patchedSequenceInfo.tBegin == SentinelValueIndicatingUnspecifedSequenceBeginIdx)
+            if (patchedSequenceInfo.seqId != GAP_SEQUENCE_ID)
             {
-                if (trailingSequencesOfLastMB.find(patchedSequenceInfo.s) == trailingSequencesOfLastMB.end())
-                    LogicError("No matching sequence found in the saved previous MBLayout to determine the real tBegin from for a truncated sequence in the current MBLayout");
+                if (patchedSequenceInfo.tBegin == SentinelValueIndicatingUnspecifedSequenceBeginIdx)
+                {
+                    if (trailingSequencesOfLastMB.find(patchedSequenceInfo.s) == trailingSequencesOfLastMB.end())
+                        LogicError("No matching sequence found in the saved previous MBLayout to determine the real tBegin from for a truncated sequence in the current MBLayout");
 
-                anySequencesPatched = true;
-                patchedSequenceInfo.tBegin = trailingSequencesOfLastMB[patchedSequenceInfo.s].tBegin - m_delayedActivationMBLayout->GetNumTimeSteps();
+                    patchedSequenceInfo.tBegin = trailingSequencesOfLastMB[patchedSequenceInfo.s].tBegin - m_delayedActivationMBLayout->GetNumTimeSteps();
+                }
             }
         }
-    }
 
-    // Now reconstruct the MBLayout with patched sequences if needed
-    if (anySequencesPatched)
-    {
+        // Now reconstruct the MBLayout with patched sequences
         auto newMBLayout = make_shared<MBLayout>();
         newMBLayout->Init(m_pMBLayout->GetNumParallelSequences(), m_pMBLayout->GetNumTimeSteps());
         for (auto sequence : patchedMBSequences)
@@ -171,8 +181,6 @@ template<class ElemType, int direction>
         m_pMBLayout->MoveFrom(newMBLayout);
     }
 
-    m_inputInvalidMatrix->SetValue(0);
-
     // create the mask for invalid sequences
     // The mask stores for every time step of every sequence whether that location is invalid; that is, when
     //  - the delayed time crosses a boundary, or
@@ -182,6 +190,7 @@ template<class ElemType, int direction>
     m_inputAnySeqValid.assign(GetNumTimeSteps(), false); // start with assumptions which we update in the loop below
     m_inputAllSeqValid.assign(GetNumTimeSteps(), true);
     m_inputInvalidMatrixTemp.assign(m_inputInvalidMatrix->GetNumCols(), 0);
+    bool anyInvalid = false; // whether any entry of the mask is set at all
 
     let S = GetNumParallelSequences();
     int dir = direction; // (this avoids a 'conditional expression is constant' warning)
@@ -214,12 +223,24 @@ template<class ElemType, int direction>
                 m_inputAllSeqValid[t] = false;
                 let j = fr.t() * S + s;
                 m_inputInvalidMatrixTemp[j] = 1; // invalid: exclude this in copy/backprop
+                anyInvalid = true;
             }
         }
     }
     // move to GPU
+    // When no frame is invalid (steady-state streaming, or full utterances without gaps), the mask is all-zero
+    // and we can skip the per-MB upload; we only re-zero the matrix if a previous MB left entries in it.
     // TODO: move this to the MBLayout where this can be done together with the creation of the other mask and is likely to further improve performance.
-    m_inputInvalidMatrix->SetValue(1, m_inputInvalidMatrixTemp.size(), m_deviceId, m_inputInvalidMatrixTemp.data(), matrixFlagNormal);
+    if (anyInvalid)
+    {
+        m_inputInvalidMatrix->SetValue(1, m_inputInvalidMatrixTemp.size(), m_deviceId, m_inputInvalidMatrixTemp.data(), matrixFlagNormal);
+        m_inputInvalidMatrixZeroedCols = 0; // the mask now holds non-zero entries
+    }
+    else if (m_inputInvalidMatrixZeroedCols != m_inputInvalidMatrix->GetNumCols())
+    {
+        m_inputInvalidMatrix->SetValue(0);
+        m_inputInvalidMatrixZeroedCols = m_inputInvalidMatrix->GetNumCols();
+    }
 }
 
 // update temporaries' column dimensions from MBLayout
@@ -325,17 +346,29 @@ template<class ElemType, int direction>
 {
     // In truncated BPTT, we carry over left-to-right state across minibatches.
     // It is kept in m_delayedValue, m_delayedActivationMBLayout.
-    // This could be optimized as follows:
+    // This could be optimized further as follows:
     //  - only keep the required number of frames (m_timeStep)
-    //  - we don't need to keep anything in full-sequence mode
-    //  - we don't need to keep anything if all sequences are closed (sentence end)
-    //    This condition includes full-sequence mode.
-    // TODO: Can we optimize this and only copy if there is a sequence spanning across the end of the MB? And add a check to BeginForwardProp() to make sure we got one if there is a boundary at the start?
-    m_delayedValue->SetValue(InputRef(0).Value());
-    if (!m_delayedActivationMBLayout)
-        m_delayedActivationMBLayout = make_shared<MBLayout>();
-    m_delayedActivationMBLayout->CopyFrom(m_pMBLayout);
-    // Perf BUGBUG: ^^ This copies a matrix from CPU to GPU at each MB; we should short-circuit it
+    int dir = direction; // (this avoids a 'conditional expression is constant' warning)
+    if (dir == -1 && !m_pMBLayout->HasSequenceBeyondEnd())
+    {
+        // No sequence reaches beyond the end of this minibatch (full-sequence mode, or all utterances
+        // just ended), so nothing can ever be read back from the carried-over state: skip the copies
+        // and drop the state. Reading it regardless would be an input error, which the empty matrix
+        // turns into the missing-sentence-start LogicError in ForwardProp().
+        // (Only the past direction carries state this way; the future direction keeps the
+        // unconditional copy, which feeds sub-minibatch state export.)
+        m_delayedValue->Resize(GetSampleLayout().GetNumElements(), 0);
+        if (!m_delayedActivationMBLayout) // (state export requires the layout object to exist)
+            m_delayedActivationMBLayout = make_shared<MBLayout>();
+    }
+    else
+    {
+        m_delayedValue->SetValue(InputRef(0).Value());
+        if (!m_delayedActivationMBLayout)
+            m_delayedActivationMBLayout = make_shared<MBLayout>();
+        m_delayedActivationMBLayout->CopyFrom(m_pMBLayout);
+        // Perf BUGBUG: ^^ This copies a matrix from CPU to GPU at each MB; we should short-circuit it
+    }
 
     Base::EndForwardProp();
 }
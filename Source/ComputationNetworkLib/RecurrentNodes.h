@@ -84,6 +84,7 @@ protected:
 
     vector<ElemType> m_inputInvalidMatrixTemp;              // [j] CPU-side buffer for constructing the mask matrix
     vector<bool> m_inputAnySeqValid, m_inputAllSeqValid;    // [t] denotes whether there are any valid frames at a time step, and if all are valid
+    size_t m_inputInvalidMatrixZeroedCols;                  // #cols m_inputInvalidMatrix is known to be all-zero for (0 = unknown); lets us skip the per-MB mask upload when no frame is invalid
 
     shared_ptr<Matrix<ElemType>> m_initialStateValueMatrix; // potentially GPU-side versions
     shared_ptr<Matrix<ElemType>> m_inputInvalidMatrix;      // [0,j] contains 1 if matrix column belongs to an frame with boundary condition or a gap frame
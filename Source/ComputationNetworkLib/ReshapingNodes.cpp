@@ -97,7 +97,7 @@ template <class ElemType>
             // Let: f(x, y, z) = log(exp x + exp y + exp z)
             // For the derivative we get:
             // df / dx = exp(x)/exp(f)
-            //         = exp(x � f)
+            //         = exp(x � f)
             sliceInputGrad.AddElementwiseProductWithExpOfDiffOf(sliceOutputGrad, input, output);
     }
         break;
@@ -243,6 +243,9 @@ template <class ElemType>
     // gather all sequences
     let& inMBLayout = InputRef(0).GetMBLayout();
     let& input = InputRef(0).Value();
+    // Pull the condition values to the host in one batched copy, rather than reading the matrix
+    // element-wise (which would drag it into BOTH state for all other consumers as well).
+    unique_ptr<ElemType[]> inputData(input.CopyToArray());
     let& sequences = inMBLayout->GetAllSequences();
     auto& indexSequences = m_indexSequenceBuffer;
     if (indexSequences.size() < sequences.size())
@@ -255,11 +258,9 @@ template <class ElemType>
         auto& indexSequence = indexSequences[i];
         indexSequence.clear();
         for (size_t t = 0; t < seq.GetNumTimeSteps(); t++)
-            if (input(0, inMBLayout->GetColumnIndex(seq, t))) // this is the condition check that this node performs; the meat
+            if (inputData[inMBLayout->GetColumnIndex(seq, t)]) // this is the condition check that this node performs; the meat
                 indexSequence.push_back(t);
-        // Note: The above accesses m_value directly on the CPU, putting it into BOTH state, possibly for other consumers as well.
     }
-    input.CollapseDataLocation(); // BUGBUG: Move back, since BOTH state is broken at present.
     // create a new MBLayout
     let& outMBLayout = GetMBLayout();
     outMBLayout->InitAsPackedSequences(SequenceLengthVector(sequences, indexSequences), /*temp*/m_placementBuffer, /*temp*/m_rowAllocationsBuffer);
@@ -324,6 +325,12 @@ template <class ElemType>
     let& indexMBLayout  = InputRef(INDEXDATA).GetMBLayout();
     let&  index  = InputRef(INDEXDATA).Value(); // per-seq index values that are to be mapped
     auto& result =                   Value(); // packed index values as mapped to sourceData's layout
+    // The index values are data-dependent (they typically come out of a WhereNode), so the mapping
+    // has to be recomputed each minibatch; but we pull them to the host in one batched copy and
+    // assemble the packed indices in a flat buffer, instead of going through per-element matrix
+    // accesses (which dispatch per element and drag the matrices into BOTH state).
+    unique_ptr<ElemType[]> indexData(index.CopyToArray());
+    vector<ElemType> buf(indexMBLayout->GetNumCols(), (ElemType)-1); // gap columns become -1, which Gather/Scatter treat as invalid
     // loop over sourceSequences
     // Input matrix contains time indices for each sequence that refer to frames inside that sequence.
     // We replace every per-sequence index by the resolved column index w.r.t. the same MBLayout.
@@ -337,13 +344,13 @@ template <class ElemType>
         for (size_t tIndex = 0; tIndex < indexSeq.GetNumTimeSteps(); tIndex++) // map all index values in index sequence
         {
             let jIndex  = indexMBLayout->GetColumnIndex(indexSeq, tIndex);    // map time index to actual location in the matrix storage object
-            let tSource = (size_t)index(0, jIndex);                           // the new time location (relative to source sequence)
+            let tSource = (size_t)indexData[jIndex];                          // the new time location (relative to source sequence)
             let jSource = sourceMBLayout->GetColumnIndex(sourceSeq, tSource); // map new time index as well. This performs a range check.
-            result(0, jIndex) = (ElemType)jSource;
+            buf[jIndex] = (ElemType)jSource;
         }
     }
-    // Note: maybe this is no longer needed, now that we do the same inside UpdateFunctionValueSize() for all nodes.
-    result.CollapseDataLocation(); // BUGBUG: Move back, since BOTH state is broken at present.
+    // write the result back in a single batched copy, directly to the device where Gather/Scatter will consume it
+    result.SetValue(1, indexMBLayout->GetNumCols(), result.GetDeviceId(), buf.data(), MatrixFormat::matrixFormatColMajor);
 }
 
 template <class ElemType>
@@ -64,6 +64,65 @@ private:
     std::vector<std::string> m_labelMapping;
 };
 
+// -----------------------------------------------------------------------
+// TransferToDeviceNode (input) -- copy a node's value to this node's device
+// Identity function whose output lives on a different device than its input.
+// Used as the boundary between pipeline stages of a model-parallel network
+// (see ComputationNetwork::PartitionIntoPipelineStages()). The forward pass
+// stages the input through a private transfer buffer and moves it to this
+// node's device; the backward pass moves the gradient the opposite way.
+// The transfer buffers are not pooled, since they must persist across the
+// device move and must not be shared with same-device temporaries.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class TransferToDeviceNode : public ComputationNodeNonLooping<ElemType>, public NumInputs<1>
+{
+    typedef ComputationNodeNonLooping<ElemType> Base; UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName() { return L"TransferToDevice"; }
+
+public:
+    DeclareConstructorFromConfigWithNumInputs(TransferToDeviceNode);
+    TransferToDeviceNode(DEVICEID_TYPE deviceId, const wstring& name)
+        : Base(deviceId, name)
+    {
+    }
+
+    virtual void /*ComputationNodeNonLooping::*/ ForwardPropNonLooping() override
+    {
+        if (!m_transferBuffer)
+            m_transferBuffer = std::make_shared<Matrix<ElemType>>(InputRef(0).Value().GetDeviceId());
+        m_transferBuffer->AssignValuesOf(InputRef(0).Value());
+        m_transferBuffer->TransferToDeviceIfNotThere(m_deviceId, /*isBeingMoved=*/true);
+        Value().AssignValuesOf(*m_transferBuffer);
+    }
+
+    virtual void /*ComputationNodeNonLooping::*/ BackpropToNonLooping(size_t /*inputIndex*/) override
+    {
+        if (!m_gradientTransferBuffer)
+            m_gradientTransferBuffer = std::make_shared<Matrix<ElemType>>(Gradient().GetDeviceId());
+        m_gradientTransferBuffer->AssignValuesOf(Gradient());
+        m_gradientTransferBuffer->TransferToDeviceIfNotThere(InputRef(0).Gradient().GetDeviceId(), /*isBeingMoved=*/true);
+        InputRef(0).Gradient() += *m_gradientTransferBuffer;
+    }
+
+    virtual bool OutputUsedInComputingInputNodesGradients() const override { return false; }
+    virtual bool InputUsedInComputingInputNodesGradients(size_t /*childIndex*/) const override { return false; }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        ValidateUnaryMap(isFinalValidationPass);
+    }
+
+private:
+    // staging buffers for the device move (lazily created, not pooled)
+    std::shared_ptr<Matrix<ElemType>> m_transferBuffer;
+    std::shared_ptr<Matrix<ElemType>> m_gradientTransferBuffer;
+};
+
+template class TransferToDeviceNode<float>;
+template class TransferToDeviceNode<double>;
+
 #ifdef COMING_SOON
 
 // -----------------------------------------------------------------------
@@ -20,6 +20,7 @@
 #include <list>
 #include <memory>
 #include <random>
+#include <unordered_set>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -1142,6 +1143,232 @@ private:
 template class NoiseContrastiveEstimationNode<float>;
 template class NoiseContrastiveEstimationNode<double>;
 
+// -----------------------------------------------------------------------
+// SampledSoftmaxNode (labels, hidden, weight)
+// Sampled-softmax cross-entropy criterion for very large output vocabularies.
+// Instead of the full C-way output GEMM, training restricts the softmax to the
+// true class plus 'numSamples' negative classes drawn uniformly (without
+// replacement, shared across the minibatch). The sampled logits carry the
+// log(numSamples/numClasses) correction for the uniform proposal, so the
+// criterion is an unbiased estimate of full softmax cross-entropy in
+// expectation. Inputs: 0 = one-hot labels (C x T minibatch, may be sparse),
+// 1 = hidden activations (d x T minibatch), 2 = output weight (d x C matrix).
+// Outside of training, the exact full softmax is evaluated instead.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class SampledSoftmaxNode : public ComputationNodeNonLooping /*ComputationNode*/<ElemType>, public NumInputs<3>
+{
+    typedef ComputationNodeNonLooping<ElemType> Base;
+    UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName()
+    {
+        return L"SampledSoftmax";
+    }
+
+public:
+    SampledSoftmaxNode(DEVICEID_TYPE deviceId, const wstring& name, size_t numSamples = 0)
+        : Base(deviceId, name),
+          m_numSamples(numSamples),
+          m_sampleIdx(deviceId),
+          m_sampledWeights(deviceId),
+          m_trueWeights(deviceId),
+          m_trueLogits(deviceId),
+          m_sampledLogits(deviceId),
+          m_logits(deviceId),
+          m_posterior(deviceId),
+          m_logitGradient(deviceId),
+          m_tmp(deviceId),
+          m_gradTmp(deviceId),
+          m_rng(CreateUniqId()),
+          m_needRecomputeLogitGradient(false)
+    {
+    }
+    SampledSoftmaxNode(const ScriptableObjects::IConfigRecordPtr configp)
+        : SampledSoftmaxNode(configp->Get(L"deviceId"), L"<placeholder>", configp->Get(L"numSamples"))
+    {
+        AttachInputsFromConfig(configp, this->GetExpectedNumInputs());
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<SampledSoftmaxNode<ElemType>>(nodeP);
+            node->m_numSamples = m_numSamples;
+        }
+    }
+
+    virtual void Save(File& fstream) const override
+    {
+        Base::Save(fstream);
+        fstream << m_numSamples;
+    }
+
+    virtual void Load(File& fstream, size_t modelVersion) override
+    {
+        Base::Load(fstream, modelVersion);
+        fstream >> m_numSamples;
+    }
+
+    virtual bool OutputUsedInComputingInputNodesGradients() const override
+    {
+        return false;
+    }
+
+    virtual void UpdateFunctionMBSize() override
+    {
+        // member matrices resize themselves in ForwardPropNonLooping()
+    }
+
+    virtual void /*ComputationNodeNonLooping::*/ ForwardPropNonLooping() override
+    {
+        FrameRange fr(InputRef(0).GetMBLayout());
+        Matrix<ElemType>& weight = InputRef(2).ValueAsMatrix(); // d x C
+        size_t numClasses = weight.GetNumCols();
+
+        if (!Environment().IsTraining())
+        {
+            // exact evaluation: full softmax cross-entropy over all classes
+            m_logits.AssignProductOf(weight, true, InputRef(1).ValueFor(fr), false); // C x T
+            m_logits.InplaceLogSoftmax(true);
+            MaskMissingColumnsToZero(m_logits, InputRef(0).GetMBLayout(), fr);
+            Value().AssignInnerProductOfMatrices(InputRef(0).MaskedValueFor(fr), m_logits);
+            Value() *= -1;
+            return;
+        }
+
+        if (m_numSamples == 0 || m_numSamples >= numClasses)
+            InvalidArgument("%ls %ls operation requires 0 < numSamples (%d) < number of classes (%d).",
+                            NodeName().c_str(), OperationName().c_str(), (int)m_numSamples, (int)numClasses);
+
+        // Draw this minibatch's shared negative sample set: uniform without replacement, on the
+        // CPU (numSamples indices per minibatch are negligible next to the gathered GEMMs below).
+        // Uniqueness also makes the column scatter in BackpropToNonLooping() collision-free.
+        std::vector<ElemType> samples(m_numSamples);
+        std::unordered_set<size_t> drawn;
+        std::uniform_int_distribution<size_t> dist(0, numClasses - 1);
+        for (size_t i = 0; i < m_numSamples;)
+        {
+            size_t classId = dist(m_rng);
+            if (drawn.insert(classId).second)
+                samples[i++] = (ElemType)classId;
+        }
+        m_sampleIdx.SetValue(1, m_numSamples, Value().GetDeviceId(), samples.data());
+
+        // gather the sampled columns of the weight matrix and form the sampled logits,
+        // shifted by log(numSamples/numClasses) to correct for the uniform proposal
+        m_sampledWeights.DoGatherColumnsOf(0, m_sampleIdx, weight, 1);                        // d x numSamples
+        m_sampledLogits.AssignProductOf(m_sampledWeights, true, InputRef(1).ValueFor(fr), false); // numSamples x T
+        m_sampledLogits -= (ElemType)log((double)m_numSamples / numClasses);
+
+        // true-class logits w_y . h, with w_y picked out by the one-hot labels in one (sparse) product
+        m_trueWeights.AssignProductOf(weight, false, InputRef(0).ValueFor(fr), false); // d x T
+        m_tmp.SetValue(m_trueWeights);
+        m_tmp.ElementMultiplyWith(InputRef(1).ValueFor(fr));
+        Matrix<ElemType>::VectorSum(m_tmp, m_trueLogits, true); // 1 x T
+
+        // stack [true; sampled] and take the log-softmax over the restricted (numSamples+1)-way output
+        m_logits.Resize(m_numSamples + 1, m_trueLogits.GetNumCols());
+        m_logits.AssignToRowSliceValuesOf(m_trueLogits, 0, 1);
+        m_logits.AssignToRowSliceValuesOf(m_sampledLogits, 1, m_numSamples);
+        m_logits.InplaceLogSoftmax(true);
+
+        // keep the posteriors for the gradient (the criterion value itself is not used in backprop)
+        m_posterior.SetValue(m_logits);
+        m_posterior.InplaceExp();
+
+        // criterion = -sum over frames of the true-class log-posterior (gaps flattened to zero)
+        MaskMissingColumnsToZero(m_logits, InputRef(0).GetMBLayout(), fr);
+        m_trueLogits.AssignRowSliceValuesOf(m_logits, 0, 1);
+        Value().AssignSumOfElements(m_trueLogits);
+        Value() *= -1;
+
+        m_needRecomputeLogitGradient = true;
+    }
+
+    virtual void BackpropToNonLooping(size_t inputIndex) override
+    {
+        FrameRange fr(InputRef(0).GetMBLayout());
+        if (inputIndex == 0)
+            InvalidArgument("%ls %ls operation cannot compute a gradient with respect to the label input.", NodeName().c_str(), OperationName().c_str());
+
+        if (m_needRecomputeLogitGradient)
+        {
+            // d(criterion)/d(logits) = softmax(logits) - e_0, zeroed in gap columns,
+            // with the 1x1 root gradient folded in once instead of into every product below
+            m_logitGradient.SetValue(m_posterior);
+            m_trueLogits.AssignRowSliceValuesOf(m_logitGradient, 0, 1);
+            m_trueLogits -= 1;
+            m_logitGradient.AssignToRowSliceValuesOf(m_trueLogits, 0, 1);
+            MaskMissingColumnsToZero(m_logitGradient, InputRef(0).GetMBLayout(), fr);
+            Matrix<ElemType>::Multiply1x1AndWeightedAdd(1.0f, Gradient() /*1x1*/, m_logitGradient, 0.0f, m_logitGradient);
+            m_needRecomputeLogitGradient = false;
+        }
+
+        m_sampledLogits.AssignRowSliceValuesOf(m_logitGradient, 1, m_numSamples); // numSamples x T
+        m_trueLogits.AssignRowSliceValuesOf(m_logitGradient, 0, 1);               // 1 x T
+
+        if (inputIndex == 1) // gradient to the hidden activations: Ws * Gs + w_y .* g0
+        {
+            auto gradient = InputRef(1).GradientFor(fr);
+            Matrix<ElemType>::MultiplyAndWeightedAdd(1, m_sampledWeights, false, m_sampledLogits, false, 1, gradient);
+            m_gradTmp.SetValue(m_trueWeights);
+            m_gradTmp.RowElementMultiplyWith(m_trueLogits);
+            gradient += m_gradTmp;
+        }
+        else if (inputIndex == 2) // gradient to the output weight matrix (only the touched columns)
+        {
+            Matrix<ElemType>& weightGradient = InputRef(2).Gradient();
+            // sampled columns: scatter h * Gs^T into the sampled positions (indices are unique, so no collisions)
+            m_gradTmp.AssignProductOf(InputRef(1).ValueFor(fr), false, m_sampledLogits, true); // d x numSamples
+            weightGradient.DoScatterColumnsOf(1, m_sampleIdx, m_gradTmp, 1);
+            // true-class columns: (h .* g0) * labels^T; the (sparse) product accumulates repeated labels correctly
+            m_gradTmp.SetValue(InputRef(1).ValueFor(fr));
+            m_gradTmp.RowElementMultiplyWith(m_trueLogits);
+            Matrix<ElemType>::MultiplyAndWeightedAdd(1, m_gradTmp, false, InputRef(0).ValueFor(fr), true, 1, weightGradient);
+        }
+    }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        Base::Validate(isFinalValidationPass);
+        m_pMBLayout = nullptr; // this node does not hold mini-batch data
+
+        if (isFinalValidationPass)
+        {
+            if (Input(1)->GetSampleMatrixNumRows() != Input(2)->GetAsMatrixNumRows())
+                LogicError("The matrix dimensions of the observation and the weight in the %ls %ls operation do not match.", NodeName().c_str(), OperationName().c_str());
+            if (Input(0)->GetSampleMatrixNumRows() != Input(2)->GetAsMatrixNumCols())
+                LogicError("The label dimension in the %ls %ls operation must equal the number of weight matrix columns (classes).", NodeName().c_str(), OperationName().c_str());
+            if (!Input(0)->HasMBLayout() || !Input(1)->HasMBLayout() || Input(2)->HasMBLayout())
+                LogicError("%ls %ls operation requires inputs 0 and 1 to be a minibatch, and input 2 to be a matrix.", NodeName().c_str(), OperationName().c_str());
+        }
+
+        SetDims(TensorShape(1), false);
+    }
+
+protected:
+    size_t m_numSamples; // number of negative classes sampled per minibatch
+
+    Matrix<ElemType> m_sampleIdx;       // 1 x numSamples row of sampled class indices
+    Matrix<ElemType> m_sampledWeights;  // d x numSamples gathered weight columns
+    Matrix<ElemType> m_trueWeights;     // d x T weight columns of the true classes
+    Matrix<ElemType> m_trueLogits;      // 1 x T scratch row
+    Matrix<ElemType> m_sampledLogits;   // numSamples x T
+    Matrix<ElemType> m_logits;          // (numSamples+1) x T during training; C x T in the exact eval path
+    Matrix<ElemType> m_posterior;       // softmax over the restricted output, kept for the gradient
+    Matrix<ElemType> m_logitGradient;   // (numSamples+1) x T, shared by both gradient computations
+    Matrix<ElemType> m_tmp;
+    Matrix<ElemType> m_gradTmp;
+
+    std::mt19937_64 m_rng;
+    bool m_needRecomputeLogitGradient;
+};
+template class SampledSoftmaxNode<float>;
+template class SampledSoftmaxNode<double>;
+
 
 
 // Nodes using a random number generators should derive from this interface.
@@ -1437,12 +1664,16 @@ private:
 
         ComputeSoftMaxPartial(); // Note: Flag m_needRecomputeGradientToSoftmaxInput guards so that this computes only once.
 
+        // slice handles hoisted out of the loop and re-pointed per column, to avoid a header allocation per iteration
+        Matrix<ElemType> weightForClass(m_deviceId);
+        Matrix<ElemType> grd_to_soft_max_input(m_deviceId);
+        Matrix<ElemType> grd_to_wgt_t(m_deviceId);
         ForColumnsWithClass([&](size_t /*s*/, size_t /*t*/, const FrameRange& fr, size_t /*y_t*/, size_t c_t, size_t sz, size_t lft_bnd, size_t nbr_wrd)
         {
             // compute prb - 1 and prb
-            Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(lft_bnd, nbr_wrd);
+            weightForClass.AssignColumnSliceViewOf(InputRef(EMBEDDINGMATRIX).ValueAsMatrix(), lft_bnd, nbr_wrd);
             Matrix<ElemType> obs = InputRef(INPUTDATA).ValueFor(fr); // hidden activation vector for current word token
-            Matrix<ElemType> grd_to_soft_max_input = m_grdToSoftMaxInput.ColumnSlice(sz, nbr_wrd);
+            grd_to_soft_max_input.AssignColumnSliceViewOf(m_grdToSoftMaxInput, sz, nbr_wrd);
 
             switch (inputIndex)
             {
@@ -1456,7 +1687,7 @@ private:
                 case 2:
                 {
                     // gradient to input weight
-                    Matrix<ElemType> grd_to_wgt_t = InputRef(EMBEDDINGMATRIX).GradientAsMatrix().ColumnSlice(lft_bnd, nbr_wrd);
+                    grd_to_wgt_t.AssignColumnSliceViewOf(InputRef(EMBEDDINGMATRIX).GradientAsMatrix(), lft_bnd, nbr_wrd);
                     Matrix<ElemType>::MultiplyAndAdd(obs, false, grd_to_soft_max_input, false, grd_to_wgt_t);
                     break;
                 }
@@ -1487,14 +1718,17 @@ private:
         {
             m_grdToSoftMaxInput.Resize(1, m_totalNbrWords); // buffer that contains a concatenation of class-conditional values
 
+            Matrix<ElemType> softMax(m_deviceId);            // reusable slice handles, see BackpropToNonLooping()
+            Matrix<ElemType> grdToSoftMaxInput_t(m_deviceId);
             ForColumnsWithClass([&](size_t /*s*/, size_t /*t*/, const FrameRange& /*fr*/, size_t y_t, size_t /*c_t*/, size_t sz, size_t lft_bnd, size_t nbr_wrd)
             {
-                Matrix<ElemType> softMax = m_softMax.ColumnSlice(sz, nbr_wrd);
+                softMax.AssignColumnSliceViewOf(m_softMax, sz, nbr_wrd);
 
                 size_t idx_in_class = y_t - lft_bnd;
                 ComputeCEPartialToSoftmaxInputs(softMax, Gradient(), idx_in_class);
 
-                m_grdToSoftMaxInput.ColumnSlice(sz, nbr_wrd).AssignValuesOf(softMax);
+                grdToSoftMaxInput_t.AssignColumnSliceViewOf(m_grdToSoftMaxInput, sz, nbr_wrd);
+                grdToSoftMaxInput_t.AssignValuesOf(softMax);
             });
 
             m_needRecomputeGradientToSoftmaxInput = false;
@@ -1539,16 +1773,20 @@ public:
 
         // accumulate objective
         functionValues.SetValue(0);
+        // slice handles declared outside of the loop and re-pointed per column to avoid the malloc
+        Matrix<ElemType> weightForClass(m_deviceId);
+        Matrix<ElemType> softMax_t(m_deviceId);
+        Matrix<ElemType> logSoftMax_t(m_deviceId);
         ForColumnsWithClass([&](size_t s, size_t t, const FrameRange& fr, size_t y_t, size_t c_t, size_t sz, size_t lft_bnd, size_t nbr_wrd)
         {
             // now get views of various arrays that correspond to the index range of words belonging to this class
 
             // get hidden vectors for the words in this class
-            Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(lft_bnd, nbr_wrd); // [hdSize x nbr_wrd]
+            weightForClass.AssignColumnSliceViewOf(InputRef(EMBEDDINGMATRIX).ValueAsMatrix(), lft_bnd, nbr_wrd); // [hdSize x nbr_wrd]
 
             // buffer to hold the class-conditional distribution
-            Matrix<ElemType> softMax_t = m_softMax.ColumnSlice(sz, nbr_wrd); // TODO: declare these outside of the loop to avoid the malloc
-            Matrix<ElemType> logSoftMax_t = m_logSoftmax.ColumnSlice(sz, nbr_wrd);
+            softMax_t.AssignColumnSliceViewOf(m_softMax, sz, nbr_wrd);
+            logSoftMax_t.AssignColumnSliceViewOf(m_logSoftmax, sz, nbr_wrd);
 
             Matrix<ElemType> obs = InputRef(INPUTDATA).ValueFor(fr); // hidden activation vector for current word token
 
@@ -2781,4 +3019,170 @@ private:
 template class BatchNormalizationNode<float>;
 template class BatchNormalizationNode<double>;
 
+// -----------------------------------------------------------------------
+// LayerNormalizationNode (input, scale, bias)
+// Per-sample (per-column) normalization: each input column is normalized by
+// its own mean and standard deviation over the sample dimension, then scaled
+// and shifted by the learnable per-element scale and bias vectors. Unlike
+// BatchNormalizationNode there are no running statistics, so training and
+// inference use the same code path. Forward and backward each run as fused
+// Matrix kernels (one launch per pass on GPU) instead of the half-dozen
+// primitive nodes a BrainScript-composed layer norm expands into.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class LayerNormalizationNode : public ComputationNodeNonLooping<ElemType>, public NumInputs<3>
+{
+    typedef ComputationNodeNonLooping<ElemType> Base; UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName() { return L"LayerNormalization"; }
+
+public:
+    LayerNormalizationNode(DEVICEID_TYPE deviceId, const wstring& name, double epsilon = 1e-5)
+        : Base(deviceId, name), m_epsilon(epsilon)
+    {
+    }
+    LayerNormalizationNode(const ScriptableObjects::IConfigRecordPtr configp)
+        : LayerNormalizationNode(configp->Get(L"deviceId"), L"<placeholder>", configp->Get(L"epsilon"))
+    {
+        AttachInputsFromConfig(configp, this->GetExpectedNumInputs());
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<LayerNormalizationNode<ElemType>>(nodeP);
+            node->m_epsilon = m_epsilon;
+        }
+    }
+
+    virtual void Save(File& fstream) const override
+    {
+        Base::Save(fstream);
+        fstream << m_epsilon;
+    }
+
+    virtual void Load(File& fstream, size_t modelVersion) override
+    {
+        Base::Load(fstream, modelVersion);
+        fstream >> m_epsilon;
+    }
+
+    virtual void /*ComputationNodeNonLooping::*/ ForwardPropNonLooping() override
+    {
+        FrameRange fr(Input(0)->GetMBLayout());
+        Matrix<ElemType> sliceInputValue  = Input(0)->ValueFor(fr);
+        const Matrix<ElemType>& scale     = Input(1)->Value();
+        const Matrix<ElemType>& bias      = Input(2)->Value();
+        Matrix<ElemType> sliceOutputValue = ValueFor(fr);
+
+        sliceInputValue.LayerNormalizationForward(scale, bias, sliceOutputValue, m_epsilon, *m_savedMean, *m_savedInvStdDev);
+    }
+
+    // Note: Like BatchNormalizationNode, this assumes that inputIndex=0 is called before the others,
+    // since the scale and bias gradients fall out of the fused data-gradient kernel.
+    virtual void BackpropToNonLooping(size_t inputIndex) override
+    {
+        FrameRange fr(Input(0)->GetMBLayout());
+
+        if (inputIndex == 0) // derivative with respect to the input
+        {
+            auto sliceOutputGrad          = MaskedGradientFor(fr); // gaps are zeroed, so they contribute nothing below
+            auto sliceInputValue          = Input(0)->ValueFor(fr);
+            const Matrix<ElemType>& scale = Input(1)->Value();
+            auto sliceInputGrad           = Input(0)->GradientFor(fr);
+
+            m_dScale->Resize(scale); // gradients for scale and bias get stored here
+            m_dBias->Resize(Input(2)->Value());
+
+            sliceOutputGrad.LayerNormalizationBackward(sliceInputValue, sliceInputGrad, scale,
+                                                       *m_savedMean, *m_savedInvStdDev,
+                                                       *m_dScale, *m_dBias);
+        }
+        else if (inputIndex == 1) // derivative with respect to the scale, precomputed above
+        {
+            Input(1)->Gradient() += *m_dScale;
+        }
+        else if (inputIndex == 2) // derivative with respect to the bias, precomputed above
+        {
+            Input(2)->Gradient() += *m_dBias;
+        }
+    }
+
+    virtual bool OutputUsedInComputingInputNodesGradients() const override { return false; }
+
+    void Validate(bool isFinalValidationPass) override
+    {
+        Base::Validate(isFinalValidationPass);
+        InferMBLayoutFromInputsForStandardCase(isFinalValidationPass);
+
+        SetDims(Input(0));
+
+        const auto& inputLayout = Input(0)->GetSampleLayout();
+
+        // infer [0 x 1] parameter dimensions from the data input (same workaround as BatchNormalizationNode)
+        for (size_t i = 1; i < GetNumInputs(); i++)
+        {
+            auto paramLayout = Input(i)->GetSampleLayout();
+            if (paramLayout.GetRank() == 2 && paramLayout[0] == 0 && paramLayout[1] == 1 && inputLayout.GetNumElements() > 0) // [0 x 1]
+                Input(i)->ValidateInferInputDimsFrom(TensorShape(inputLayout.GetNumElements(), 1));
+        }
+
+        if (isFinalValidationPass)
+        {
+            // scale and bias gradients fall out of the data-gradient computation (cf. BackpropToNonLooping())
+            if ((Input(1)->NeedsGradient() || Input(2)->NeedsGradient()) && !Input(0)->NeedsGradient())
+                InvalidArgument("%ls %ls currently supports learnable scale and bias parameters only if the first input also needs gradient (i.e. is dependent on at-least one learnable parameter).", NodeName().c_str(), OperationName().c_str());
+
+            for (size_t i = 1; i < GetNumInputs(); i++)
+            {
+                if (Input(i)->HasMBLayout())
+                    InvalidArgument("%ls: Input[%d] has a dynamic axis. LayerNormalization parameters cannot have that.", NodeDescription().c_str(), (int)i);
+                if (Input(i)->GetSampleLayout().GetNumElements() != inputLayout.GetNumElements())
+                    InvalidArgument("%ls: Input[%d] must have as many elements as one sample of the data input.", NodeDescription().c_str(), (int)i);
+            }
+
+            if (m_epsilon < 0)
+                InvalidArgument("%ls %ls requires epsilon to be >= 0.", NodeName().c_str(), OperationName().c_str());
+        }
+    }
+
+    void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeForwardProp(matrixPool);
+        RequestMatrixFromPool(m_savedMean, matrixPool);
+        RequestMatrixFromPool(m_savedInvStdDev, matrixPool);
+    }
+
+    void RequestMatricesBeforeBackprop(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeBackprop(matrixPool);
+        RequestMatrixFromPool(m_dScale, matrixPool);
+        RequestMatrixFromPool(m_dBias, matrixPool);
+    }
+
+    void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool) override
+    {
+        Base::ReleaseMatricesAfterBackprop(matrixPool);
+        ReleaseMatrixToPool(m_savedMean, matrixPool);
+        ReleaseMatrixToPool(m_savedInvStdDev, matrixPool);
+        ReleaseMatrixToPool(m_dScale, matrixPool);
+        ReleaseMatrixToPool(m_dBias, matrixPool);
+    }
+
+private:
+    double m_epsilon; // added to the per-column variance before the inverse square root
+
+    // per-column mean and inverse standard deviation saved by ForwardProp() for the gradient
+    shared_ptr<Matrix<ElemType>> m_savedMean;
+    shared_ptr<Matrix<ElemType>> m_savedInvStdDev;
+    // temp gradients for scale and bias, produced by the fused backward kernel
+    shared_ptr<Matrix<ElemType>> m_dScale;
+    shared_ptr<Matrix<ElemType>> m_dBias;
+};
+
+template class LayerNormalizationNode<float>;
+template class LayerNormalizationNode<double>;
+
 }}}
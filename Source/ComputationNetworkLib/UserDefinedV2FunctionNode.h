@@ -36,7 +36,10 @@ public:
 
     virtual void ForwardPropNonLooping() override
     {
-        // Get the arguments of the external function
+        // Get the arguments of the external function. The Value objects are borrowed read-only
+        // views over the live input matrices whenever the packed layout permits sharing the
+        // storage; a function that declares it mutates its inputs gets private writable copies.
+        bool externalFunctionMutatesInputs = m_externalFunction->Attributes().Contains(MutatesInputsAttributeName);
         auto arguments = m_externalFunction->Arguments();
         std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> argumentValues;
         auto numInputs = GetNumInputs();
@@ -49,12 +52,21 @@ public:
 
             auto argumentVar = arguments[j++];
             auto argumentValue = ::CNTK::Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout(argumentVar, input.Value(), input.GetMBLayout());
+            if (externalFunctionMutatesInputs)
+                argumentValue = argumentValue->DeepClone(/*readOnly =*/ false);
+
             argumentValues.insert(std::make_pair(argumentVar, argumentValue));
         }
         assert(j == arguments.size());
 
-        // TODO: Instead of passing null for output values, we should have the forward call directly produce the outputs in the output Value() of this node
-        std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> outputValue = { { m_externalFunction->Output(), nullptr } };
+        // Where the packed layout permits sharing the storage, pass a writable view over this
+        // node's Value() so the external function can produce its output in place instead of
+        // allocating a new Value that we then have to copy over
+        ::CNTK::ValuePtr borrowedOutputValue;
+        if (CanShareMatrixStorage(GetMBLayout()))
+            borrowedOutputValue = ::CNTK::Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout(m_externalFunction->Output(), Value(), GetMBLayout(), /*readOnly =*/ false);
+
+        std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> outputValue = { { m_externalFunction->Output(), borrowedOutputValue } };
         std::unordered_set<::CNTK::Variable> outputsToRetainBackwardStateFor;
         if (Environment().IsTraining())
             outputsToRetainBackwardStateFor.insert(m_externalFunction->Output());
@@ -62,13 +74,18 @@ public:
         auto computeDevice = ::CNTK::AsDeviceDescriptor(InputRef(0).Value().GetDeviceId());
         m_currentBackpropStatePtr = m_externalFunction->Forward(argumentValues, outputValue, computeDevice, outputsToRetainBackwardStateFor);
 
-        // Copy the computed output to Value() of this node
+        // If the external function produced its output in the borrowed view, this node's Value()
+        // already holds the result; otherwise copy over whatever Value the function allocated
         // TODO: We currently assume that the external Function does not generate a new MBLayout
-        auto outputMatrixAndLayout = ::CNTK::Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElemType>(outputValue.begin()->first, outputValue.begin()->second);
-        Value().AssignValuesOf(*outputMatrixAndLayout.first);
+        auto computedOutputValue = outputValue.begin()->second;
+        if ((borrowedOutputValue == nullptr) || (computedOutputValue != borrowedOutputValue))
+        {
+            auto outputMatrixAndLayout = ::CNTK::Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElemType>(outputValue.begin()->first, computedOutputValue);
+            Value().AssignValuesOf(*outputMatrixAndLayout.first);
 
-        if (*GetMBLayout() != *outputMatrixAndLayout.second)
-            LogicError("The MBLayout of the output computed by the external function (%S) does not match the expected MBLayout", this->GetName().c_str());
+            if (*GetMBLayout() != *outputMatrixAndLayout.second)
+                LogicError("The MBLayout of the output computed by the external function (%S) does not match the expected MBLayout", this->GetName().c_str());
+        }
     }
 
     virtual void BackpropToNonLooping(size_t inputIndex) override
@@ -85,19 +102,38 @@ public:
 
         auto gradientValue = ::CNTK::Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout(m_externalFunction->Output(), Gradient(), GetMBLayout());
         std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> outputGradientValue = { { m_externalFunction->Output(), gradientValue } };
-        std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> inputGradientValue = { { input, nullptr } };
+
+        // When this node is the input's sole parent (the gradient overwrite optimization), the
+        // input's gradient buffer is not zero-initialized and we own it outright; where the
+        // packed layout additionally permits sharing the storage, hand the external function a
+        // writable view over the gradient matrix so it can produce the input gradient in place
+        bool overwriteInputGradient = Input(inputIndex)->ParentOverwritesGradient();
+        ::CNTK::ValuePtr borrowedInputGradientValue;
+        if (overwriteInputGradient && CanShareMatrixStorage(InputRef(inputIndex).GetMBLayout()))
+            borrowedInputGradientValue = ::CNTK::Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout(input, InputRef(inputIndex).Gradient(), InputRef(inputIndex).GetMBLayout(), /*readOnly =*/ false);
+
+        std::unordered_map<::CNTK::Variable, ::CNTK::ValuePtr> inputGradientValue = { { input, borrowedInputGradientValue } };
         m_externalFunction->Backward(m_currentBackpropStatePtr, outputGradientValue, inputGradientValue);
 
-        // Accumulate the computed input gradient value into the existing input gradient value
-        // TODO: We should directly pass the actual input gradient tensor to the Backward method 
-        // instead of allocating a new value and accumulating it ourselves
-        auto newInputGradientMatrixAndLayout = ::CNTK::Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElemType>(inputGradientValue.begin()->first, inputGradientValue.begin()->second);
-        InputRef(inputIndex).Gradient() += *newInputGradientMatrixAndLayout.first;
+        // If the external function produced the gradient in the borrowed view, the input's
+        // Gradient() already holds it
+        auto computedInputGradientValue = inputGradientValue.begin()->second;
+        if ((borrowedInputGradientValue != nullptr) && (computedInputGradientValue == borrowedInputGradientValue))
+            return;
+
+        // Otherwise overwrite with, or accumulate, the gradient value the function allocated
+        auto newInputGradientMatrixAndLayout = ::CNTK::Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElemType>(inputGradientValue.begin()->first, computedInputGradientValue);
+        if (overwriteInputGradient)
+            InputRef(inputIndex).Gradient().AssignValuesOf(*newInputGradientMatrixAndLayout.first);
+        else
+            InputRef(inputIndex).Gradient() += *newInputGradientMatrixAndLayout.first;
 
         if (*InputRef(inputIndex).GetMBLayout() != *newInputGradientMatrixAndLayout.second)
             LogicError("The MBLayout of the input (%lu) gradient computed by the external function (%S) does not match the expected MBLayout", (unsigned long)inputIndex, this->GetName().c_str());
     }
 
+    virtual bool ImplementsGradientOverwriteOptimization() const override { return true; }
+
     virtual void Validate(bool isFinalValidationPass) override
     {
         Base::Validate(isFinalValidationPass);
@@ -143,10 +179,26 @@ public:
     }
 
 private:
+    // A Value can borrow the underlying matrix storage (instead of copying) iff the conversion
+    // helpers do not need to unshuffle the CNTK packed layout, i.e. for layout-free values and
+    // for layouts with a single time step or a single sequence
+    static bool CanShareMatrixStorage(const MBLayoutPtr& layout)
+    {
+        return (layout == nullptr) || (layout->GetNumTimeSteps() == 1) || (layout->GetNumSequences() == 1);
+    }
+
+    // Attribute by which an external function declares that its Forward mutates the contents of
+    // the input Values it is passed; such functions receive writable copies instead of borrowed
+    // read-only views
+    static const wchar_t* MutatesInputsAttributeName;
+
     ::CNTK::FunctionPtr m_externalFunction;
     ::CNTK::BackPropStatePtr m_currentBackpropStatePtr;
 };
 
+template <class ElemType>
+const wchar_t* UserDefinedV2FunctionNode<ElemType>::MutatesInputsAttributeName = L"userFunctionMutatesInputs";
+
 template class UserDefinedV2FunctionNode<float>;
 template class UserDefinedV2FunctionNode<double>;
 
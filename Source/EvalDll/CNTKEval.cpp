@@ -43,6 +43,7 @@ void CNTKEvalBase<ElemType>::Init(const std::string& config)
 
     Globals::SetShareNodeValueMatrices(m_config(L"shareNodeValueMatrices", true));
     Globals::SetHyperCompressMemory(m_config(L"hyperCompressMemory", false));
+    Globals::SetLazyParameterLoad(m_config(L"lazyParameterLoad", false));
 }
 
 
@@ -434,6 +435,95 @@ void CNTKEvalExtended<ElemType>::ForwardPass(const ValueRefs<ElemType>& inputs,
     ForwardPassT(inputs, outputs, resetRNN);
 }
 
+template<typename ElemType>
+void CNTKEvalExtended<ElemType>::ForwardPassBatched(const std::vector<const Values<ElemType>*>& inputBatch, const std::vector<Values<ElemType>*>& outputBatch)
+{
+    if (!m_started)
+        RuntimeError("ForwardPassBatched() called before StartForwardEvaluation()");
+
+    size_t numRequests = inputBatch.size();
+    if (numRequests == 0)
+        RuntimeError("ForwardPassBatched: batch must contain at least one request.");
+    if (outputBatch.size() != numRequests)
+        RuntimeError("ForwardPassBatched: expected %d output sets, but got %d.", (int)numRequests, (int)outputBatch.size());
+
+    size_t numInputs = (size_t)std::distance(m_inputMatrices.begin(), m_inputMatrices.end());
+    for (size_t r = 0; r < numRequests; ++r)
+    {
+        if (inputBatch[r]->size() != numInputs)
+            RuntimeError("ForwardPassBatched: request %d: expected %d inputs, but got %d.", (int)r, (int)numInputs, (int)inputBatch[r]->size());
+        if (outputBatch[r]->size() != m_outputNodes.size())
+            RuntimeError("ForwardPassBatched: request %d: expected %d outputs, but got %d.", (int)r, (int)m_outputNodes.size(), (int)outputBatch[r]->size());
+    }
+
+    // pack the requests column by column: one sample (column) per request, presented to the
+    // network as parallel single-frame sequences of one minibatch
+    size_t i = 0;
+    std::vector<ElemType> packed;
+    for (auto& inputNode : m_inputNodes)
+    {
+        auto matrix = dynamic_pointer_cast<Matrix<ElemType>>(inputNode->ValuePtr());
+        if (matrix->GetMatrixType() != MatrixType::DENSE)
+            RuntimeError("Input %ls: only dense inputs are supported by ForwardPassBatched().", inputNode->GetName().c_str());
+
+        size_t numRows = inputNode->GetSampleLayout().GetNumElements();
+        packed.resize(numRows * numRequests);
+        for (size_t r = 0; r < numRequests; ++r)
+        {
+            const auto& buffer = (*inputBatch[r])[i];
+            if (buffer.m_buffer.size() != numRows)
+                RuntimeError("Input %ls: request %d must be a single sample of %" PRIu64 " elements, but has %" PRIu64 ".",
+                             inputNode->GetName().c_str(), (int)r, numRows, (size_t)buffer.m_buffer.size());
+            memcpy(packed.data() + r * numRows, buffer.m_buffer.data(), numRows * sizeof(ElemType));
+        }
+
+        inputNode->GetMBLayout()->InitAsFrameMode(numRequests);
+        matrix->SetValue(numRows, numRequests, matrix->GetDeviceId(), packed.data(), matrixFlagNormal);
+        ++i;
+    }
+
+    ComputationNetwork::BumpEvalTimeStamp(m_inputNodes);
+    this->m_net->ForwardProp(m_outputNodes);
+
+    // scatter each output column back to its request
+    for (size_t i2 = 0; i2 < m_outputNodes.size(); ++i2)
+    {
+        auto node = m_outputNodes[i2];
+        shared_ptr<Matrix<ElemType>> outputMatrix = dynamic_pointer_cast<Matrix<ElemType>>(node->ValuePtr());
+        if (outputMatrix->GetNumCols() != numRequests)
+            RuntimeError("Output %ls: does not produce one column per request; cannot be scattered by ForwardPassBatched().", node->GetName().c_str());
+
+        size_t numRows = outputMatrix->GetNumRows();
+        for (size_t r = 0; r < numRequests; ++r)
+        {
+            auto& vec = (*outputBatch[r])[i2].m_buffer;
+            if (vec.capacity() < numRows)
+            {
+                // Bad luck - we can't reallocate memory of an external object at this point.
+                RuntimeError("Not enough space in output buffer for output '%ls'.", node->GetName().c_str());
+            }
+            vec.resize(numRows);
+            ElemType* data = const_cast<ElemType*>(vec.data());
+            size_t dataSize = numRows;
+            outputMatrix->ColumnSlice(r, 1).CopyToArray(data, dataSize);
+        }
+    }
+}
+
+template <typename ElemType>
+IEvaluateModelExtended<ElemType>* CNTKEvalExtended<ElemType>::CreateSharedSession()
+{
+    if (this->m_net == nullptr)
+        RuntimeError("CreateSharedSession: no model loaded. Call CreateNetwork() first.");
+
+    auto session = new CNTKEvalExtended<ElemType>();
+    session->m_config = this->m_config;
+    // duplicate the network structure, aliasing the (immutable) parameter values; the session
+    // allocates its own activation buffers from its own MatrixPool in StartForwardEvaluation()
+    session->m_net = this->m_net->CreateSharedParameterClone();
+    return session;
+}
+
 template <typename ElemType>
 void CNTKEvalExtended<ElemType>::Destroy()
 {
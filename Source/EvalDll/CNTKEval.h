@@ -107,6 +107,10 @@ public:
 
     virtual void ForwardPass(const ValueRefs<ElemType>& inputs, ValueRefs<ElemType>& output, bool resetRNN) override;
 
+    virtual void ForwardPassBatched(const std::vector<const Values<ElemType>*>& inputBatch, const std::vector<Values<ElemType>*>& outputBatch) override;
+
+    virtual IEvaluateModelExtended<ElemType>* CreateSharedSession() override;
+
     virtual void Destroy() override;
 
     virtual void CreateNetwork(const std::string& networkDescription) override
@@ -0,0 +1,46 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full licence information.
+//
+#include "stdafx.h"
+#include <malloc.h>
+#include <immintrin.h>
+#include <assert.h>
+#include <iostream>
+#include <exception>
+#include "BlockMultiplierMatrixUtil.h"
+
+#include "BlockHandlerAVX512.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+int BlockHandlerAVX512::RowToColOffsetRewrittenA(int row, int kOffset, int blockSize, int rowsPerBlock, int origCols)
+{
+    int rowIdx = row / rowsPerBlock;
+    int offsetFromBlockBeginning = row % rowsPerBlock;
+    int colIdx = kOffset * rowsPerBlock * blockSize + (offsetFromBlockBeginning * blockSize);
+    return (rowIdx * (origCols / blockSize) * rowsPerBlock * blockSize) + colIdx;
+}
+
+
+//col is the original column of B
+//kOffset is the offset to the current block we are multiplying against (in absolute
+int BlockHandlerAVX512::RowToColOffsetRewrittenB(int col, int kOffset, int blockSize, int origCols)
+{
+    return (origCols *  blockSize * kOffset) + (col * blockSize);
+}
+
+
+
+void BlockHandlerAVX512::DumpM512(__m512i dumpMe)
+{
+    union { int32_t i[16]; __m512i z; } u;
+    u.z = dumpMe;
+    for (int i = 0; i < 16; ++i)
+    {
+        std::cout << u.i[i] << " ";
+    }
+    std::cout << std::endl;
+}
+
+}}}
@@ -0,0 +1,467 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full licence information.
+//
+#pragma once
+#include "BlockMultiplierPlatform.h"
+#include <immintrin.h>
+#include <emmintrin.h>
+#include <assert.h>
+#include <cstdint>
+#define FOR_CNTK
+#ifdef FOR_CNTK
+#include "CommonMatrix.h"
+#endif
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// AVX-512 (F + BW) implementation of the BlockHandler interface.
+// A 512-bit register holds 32 shorts, so a 128-block needs only four zmm registers per
+// row (half of what the AVX2 handler uses) and the madd/add reduction chains are
+// correspondingly shorter. When the compiler also targets AVX512_VNNI the madd + add
+// pair collapses into the single saturating dot-product instruction (vpdpwssds).
+// The 16-wide block does not fill a 512-bit register, so it falls back to the AVX2
+// kernel and widens its partial sums into the low lanes of the zmm accumulators;
+// the 8-wide block reuses the SSE kernel just like BlockHandlerAVX does.
+class MATH_API BlockHandlerAVX512
+{
+    private:
+        // One dot-product step: multiply 32 shorts from the row with 32 shorts from the
+        // column and accumulate the sixteen 32-bit partial sums into accum.
+        FORCEINLINE static __m512i MultiplyAdd(__m512i row, __m512i col, __m512i accum)
+        {
+#if defined(__AVX512VNNI__)
+            return _mm512_dpwssds_epi32(accum, row, col);
+#else
+            return _mm512_add_epi32(accum, _mm512_madd_epi16(row, col));
+#endif
+        }
+
+        // Widen a 256-bit partial sum into the low lanes of a zmm register (upper lanes zero),
+        // so that the 16-wide fallback kernels can share the __m512i result storage.
+        FORCEINLINE static __m512i Widen(__m256i accum)
+        {
+            return _mm512_inserti64x4(_mm512_setzero_si512(), accum, 0);
+        }
+
+        FORCEINLINE static void kernelsse8x4(__m128i xmmRow0, __m128i xmmRow1, __m128i xmmRow2, __m128i xmmRow3,
+                short* B, __m128i* return1, __m128i* return2, __m128i* return3, __m128i* return4);
+        FORCEINLINE static void kernelsse8x1(__m128i xmmRow0, short* B, __m128i* return1);
+
+        //TODO: Should these be refactored somewhere else? Any BlockHandler will need access to these functions.
+        static int RowToColOffsetRewrittenB(int col, int kOffset, int blockSize, int origCols);
+        static int RowToColOffsetRewrittenA(int row, int kOffset, int blockSize, int rowsPerBlock, int origCols);
+        static void DumpM512(__m512i dumpMe);
+    public:
+        typedef __m512i VectorT;
+        typedef int16_t ScalarAT;
+        typedef int16_t ScalarBT;
+        typedef int32_t ScalarCT;
+        FORCEINLINE static void HandleBlock8x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m128i* resultStorage);
+        FORCEINLINE static void HandleBlock16x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock32x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock64x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock128x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage, VectorT* subtractMe);
+
+        FORCEINLINE static void HandleBlock8x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m128i* resultStorage);
+        FORCEINLINE static void HandleBlock16x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock32x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock64x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage);
+        FORCEINLINE static void HandleBlock128x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+                int blockCnt, __m512i* resultStorage, VectorT* subtractMe);
+
+        static VectorT* PrepareExtraB(const ScalarBT* /*prepareMe*/, int /*k*/, int /*n*/)
+        {
+            return nullptr;
+        }
+        static void FreePreparedB(VectorT* freeMe) { freeMe; assert(nullptr == freeMe); }
+};
+
+#define LOADAVX512_128x4 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);        \
+__m512i r0b0b = _mm512_load_si512((__m512i*)(currA + 32));     \
+__m512i r0b0c = _mm512_load_si512((__m512i*)(currA + 64));     \
+__m512i r0b0d = _mm512_load_si512((__m512i*)(currA + 96));     \
+\
+__m512i r1b0a = _mm512_load_si512((__m512i*)(currA + 128));    \
+__m512i r1b0b = _mm512_load_si512((__m512i*)(currA + 160));    \
+__m512i r1b0c = _mm512_load_si512((__m512i*)(currA + 192));    \
+__m512i r1b0d = _mm512_load_si512((__m512i*)(currA + 224));    \
+\
+__m512i r2b0a = _mm512_load_si512((__m512i*)(currA + 256));    \
+__m512i r2b0b = _mm512_load_si512((__m512i*)(currA + 288));    \
+__m512i r2b0c = _mm512_load_si512((__m512i*)(currA + 320));    \
+__m512i r2b0d = _mm512_load_si512((__m512i*)(currA + 352));    \
+\
+__m512i r3b0a = _mm512_load_si512((__m512i*)(currA + 384));    \
+__m512i r3b0b = _mm512_load_si512((__m512i*)(currA + 416));    \
+__m512i r3b0c = _mm512_load_si512((__m512i*)(currA + 448));    \
+__m512i r3b0d = _mm512_load_si512((__m512i*)(currA + 480));
+
+#define LOADAVX512_128x1 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);        \
+__m512i r0b0b = _mm512_load_si512((__m512i*)(currA + 32));     \
+__m512i r0b0c = _mm512_load_si512((__m512i*)(currA + 64));     \
+__m512i r0b0d = _mm512_load_si512((__m512i*)(currA + 96));
+
+#define LOADAVX512_64x4 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);        \
+__m512i r0b0b = _mm512_load_si512((__m512i*)(currA + 32));     \
+__m512i r1b0a = _mm512_load_si512((__m512i*)(currA + 64));     \
+__m512i r1b0b = _mm512_load_si512((__m512i*)(currA + 96));     \
+__m512i r2b0a = _mm512_load_si512((__m512i*)(currA + 128));    \
+__m512i r2b0b = _mm512_load_si512((__m512i*)(currA + 160));    \
+__m512i r3b0a = _mm512_load_si512((__m512i*)(currA + 192));    \
+__m512i r3b0b = _mm512_load_si512((__m512i*)(currA + 224));
+
+#define LOADAVX512_64x1 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);        \
+__m512i r0b0b = _mm512_load_si512((__m512i*)(currA + 32));
+
+#define LOADAVX512_32x4 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);        \
+__m512i r1b0a = _mm512_load_si512((__m512i*)(currA + 32));     \
+__m512i r2b0a = _mm512_load_si512((__m512i*)(currA + 64));     \
+__m512i r3b0a = _mm512_load_si512((__m512i*)(currA + 96));
+
+#define LOADAVX512_32x1 \
+    __m512i r0b0a = _mm512_load_si512((__m512i*)currA);
+
+#define LOADAVX512_16x4 \
+    __m256i r0b0a = _mm256_load_si256((__m256i*)currA);        \
+__m256i r1b0a = _mm256_load_si256((__m256i*)currA + 1);        \
+__m256i r2b0a = _mm256_load_si256((__m256i*)currA + 2);        \
+__m256i r3b0a = _mm256_load_si256((__m256i*)currA + 3);
+
+#define LOADAVX512_16x1 \
+    __m256i r0b0a = _mm256_load_si256((__m256i*)currA);
+
+#define LOADAVX512_8x4 \
+    __m128i r0b0a = _mm_load_si128((__m128i*)currA);           \
+__m128i r1b0a = _mm_load_si128((__m128i*)currA + 1);           \
+__m128i r2b0a = _mm_load_si128((__m128i*)currA + 2);           \
+__m128i r3b0a = _mm_load_si128((__m128i*)currA + 3);
+
+#define LOADAVX512_8x1 \
+    __m128i r0b0a = _mm_load_si128((__m128i*)currA);
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock8x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int blockCnt, __m128i* resultStorage)
+{
+    blockCnt; //warning 4100
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 8, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_8x4;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 8, n)];
+        __m128i accum1 = _mm_set_epi32(0, 0, 0, 0);
+        __m128i accum2 = _mm_set_epi32(0, 0, 0, 0);
+        __m128i accum3 = _mm_set_epi32(0, 0, 0, 0);
+        __m128i accum4 = _mm_set_epi32(0, 0, 0, 0);
+        kernelsse8x4(r0b0a, r1b0a, r2b0a, r3b0a,
+                currB, &accum1, &accum2, &accum3, &accum4);
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+        resultStorage[RowColToOffset(1, c, n)] = _mm_add_epi32(resultStorage[RowColToOffset(1, c, n)], accum2);
+        resultStorage[RowColToOffset(2, c, n)] = _mm_add_epi32(resultStorage[RowColToOffset(2, c, n)], accum3);
+        resultStorage[RowColToOffset(3, c, n)] = _mm_add_epi32(resultStorage[RowColToOffset(3, c, n)], accum4);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock8x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m128i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 8, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_8x1;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 8, n)];
+        __m128i accum1 = _mm_set_epi32(0, 0, 0, 0);
+        kernelsse8x1(r0b0a, currB, &accum1);
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock16x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 16, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_16x4;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 16, n)];
+        __m256i xmmCol0B0a = _mm256_load_si256((__m256i*)currB);
+
+        __m256i accum1 = _mm256_madd_epi16(r0b0a, xmmCol0B0a);
+        __m256i accum2 = _mm256_madd_epi16(r1b0a, xmmCol0B0a);
+        __m256i accum3 = _mm256_madd_epi16(r2b0a, xmmCol0B0a);
+        __m256i accum4 = _mm256_madd_epi16(r3b0a, xmmCol0B0a);
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], Widen(accum1));
+        resultStorage[RowColToOffset(1, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(1, c, n)], Widen(accum2));
+        resultStorage[RowColToOffset(2, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(2, c, n)], Widen(accum3));
+        resultStorage[RowColToOffset(3, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(3, c, n)], Widen(accum4));
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock16x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 16, 1, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_16x1;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 16, n)];
+        __m256i xmmCol0B0a = _mm256_load_si256((__m256i*)currB);
+        __m256i accum1 = _mm256_madd_epi16(r0b0a, xmmCol0B0a);
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], Widen(accum1));
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock32x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 32, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_32x4;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 32, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+
+        __m512i accum1 = MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum2 = MultiplyAdd(r1b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum3 = MultiplyAdd(r2b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum4 = MultiplyAdd(r3b0a, zmmCol0B0a, _mm512_setzero_si512());
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+        resultStorage[RowColToOffset(1, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(1, c, n)], accum2);
+        resultStorage[RowColToOffset(2, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(2, c, n)], accum3);
+        resultStorage[RowColToOffset(3, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(3, c, n)], accum4);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock32x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 32, 1, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_32x1;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 32, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+        __m512i accum1 = MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512());
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock64x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 64, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_64x4;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 64, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+        __m512i zmmCol0B0b = _mm512_load_si512((__m512i*)(currB + 32));
+
+        __m512i accum1 = MultiplyAdd(r0b0b, zmmCol0B0b, MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512()));
+        __m512i accum2 = MultiplyAdd(r1b0b, zmmCol0B0b, MultiplyAdd(r1b0a, zmmCol0B0a, _mm512_setzero_si512()));
+        __m512i accum3 = MultiplyAdd(r2b0b, zmmCol0B0b, MultiplyAdd(r2b0a, zmmCol0B0a, _mm512_setzero_si512()));
+        __m512i accum4 = MultiplyAdd(r3b0b, zmmCol0B0b, MultiplyAdd(r3b0a, zmmCol0B0a, _mm512_setzero_si512()));
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+        resultStorage[RowColToOffset(1, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(1, c, n)], accum2);
+        resultStorage[RowColToOffset(2, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(2, c, n)], accum3);
+        resultStorage[RowColToOffset(3, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(3, c, n)], accum4);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock64x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int /*blockCnt*/, __m512i* resultStorage)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 64, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_64x1;
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 64, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+        __m512i zmmCol0B0b = _mm512_load_si512((__m512i*)(currB + 32));
+        __m512i accum1 = MultiplyAdd(r0b0b, zmmCol0B0b, MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512()));
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock128x4(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int blockCnt, __m512i* resultStorage, VectorT* /*subtractMe*/)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 128, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_128x4;
+
+    // Unlike the AVX2 handler we only touch the second block when it actually exists,
+    // so the tail of an odd block count never reads past the end of the rewritten A.
+    __m512i r0b1a = _mm512_setzero_si512(), r0b1b = _mm512_setzero_si512(), r0b1c = _mm512_setzero_si512(), r0b1d = _mm512_setzero_si512();
+    __m512i r1b1a = _mm512_setzero_si512(), r1b1b = _mm512_setzero_si512(), r1b1c = _mm512_setzero_si512(), r1b1d = _mm512_setzero_si512();
+    __m512i r2b1a = _mm512_setzero_si512(), r2b1b = _mm512_setzero_si512(), r2b1c = _mm512_setzero_si512(), r2b1d = _mm512_setzero_si512();
+    __m512i r3b1a = _mm512_setzero_si512(), r3b1b = _mm512_setzero_si512(), r3b1c = _mm512_setzero_si512(), r3b1d = _mm512_setzero_si512();
+    if (blockCnt > 1)
+    {
+        short* currA2 = &newA[RowToColOffsetRewrittenA(startRow, currBlock + 1, 128, 4, k)];
+        r0b1a = _mm512_load_si512((__m512i*)currA2);         r0b1b = _mm512_load_si512((__m512i*)(currA2 + 32));
+        r0b1c = _mm512_load_si512((__m512i*)(currA2 + 64));  r0b1d = _mm512_load_si512((__m512i*)(currA2 + 96));
+        r1b1a = _mm512_load_si512((__m512i*)(currA2 + 128)); r1b1b = _mm512_load_si512((__m512i*)(currA2 + 160));
+        r1b1c = _mm512_load_si512((__m512i*)(currA2 + 192)); r1b1d = _mm512_load_si512((__m512i*)(currA2 + 224));
+        r2b1a = _mm512_load_si512((__m512i*)(currA2 + 256)); r2b1b = _mm512_load_si512((__m512i*)(currA2 + 288));
+        r2b1c = _mm512_load_si512((__m512i*)(currA2 + 320)); r2b1d = _mm512_load_si512((__m512i*)(currA2 + 352));
+        r3b1a = _mm512_load_si512((__m512i*)(currA2 + 384)); r3b1b = _mm512_load_si512((__m512i*)(currA2 + 416));
+        r3b1c = _mm512_load_si512((__m512i*)(currA2 + 448)); r3b1d = _mm512_load_si512((__m512i*)(currA2 + 480));
+    }
+
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 128, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+        __m512i zmmCol0B0b = _mm512_load_si512((__m512i*)(currB + 32));
+        __m512i zmmCol0B0c = _mm512_load_si512((__m512i*)(currB + 64));
+        __m512i zmmCol0B0d = _mm512_load_si512((__m512i*)(currB + 96));
+
+        __m512i accum1 = MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum2 = MultiplyAdd(r1b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum3 = MultiplyAdd(r2b0a, zmmCol0B0a, _mm512_setzero_si512());
+        __m512i accum4 = MultiplyAdd(r3b0a, zmmCol0B0a, _mm512_setzero_si512());
+        accum1 = MultiplyAdd(r0b0b, zmmCol0B0b, accum1);
+        accum2 = MultiplyAdd(r1b0b, zmmCol0B0b, accum2);
+        accum3 = MultiplyAdd(r2b0b, zmmCol0B0b, accum3);
+        accum4 = MultiplyAdd(r3b0b, zmmCol0B0b, accum4);
+        accum1 = MultiplyAdd(r0b0c, zmmCol0B0c, accum1);
+        accum2 = MultiplyAdd(r1b0c, zmmCol0B0c, accum2);
+        accum3 = MultiplyAdd(r2b0c, zmmCol0B0c, accum3);
+        accum4 = MultiplyAdd(r3b0c, zmmCol0B0c, accum4);
+        accum1 = MultiplyAdd(r0b0d, zmmCol0B0d, accum1);
+        accum2 = MultiplyAdd(r1b0d, zmmCol0B0d, accum2);
+        accum3 = MultiplyAdd(r2b0d, zmmCol0B0d, accum3);
+        accum4 = MultiplyAdd(r3b0d, zmmCol0B0d, accum4);
+
+        if (blockCnt > 1)
+        {
+            short* currB2 = &B[RowToColOffsetRewrittenB(c, currBlock + 1, 128, n)];
+            __m512i zmmCol0B1a = _mm512_load_si512((__m512i*)currB2);
+            __m512i zmmCol0B1b = _mm512_load_si512((__m512i*)(currB2 + 32));
+            __m512i zmmCol0B1c = _mm512_load_si512((__m512i*)(currB2 + 64));
+            __m512i zmmCol0B1d = _mm512_load_si512((__m512i*)(currB2 + 96));
+
+            accum1 = MultiplyAdd(r0b1a, zmmCol0B1a, accum1);
+            accum2 = MultiplyAdd(r1b1a, zmmCol0B1a, accum2);
+            accum3 = MultiplyAdd(r2b1a, zmmCol0B1a, accum3);
+            accum4 = MultiplyAdd(r3b1a, zmmCol0B1a, accum4);
+            accum1 = MultiplyAdd(r0b1b, zmmCol0B1b, accum1);
+            accum2 = MultiplyAdd(r1b1b, zmmCol0B1b, accum2);
+            accum3 = MultiplyAdd(r2b1b, zmmCol0B1b, accum3);
+            accum4 = MultiplyAdd(r3b1b, zmmCol0B1b, accum4);
+            accum1 = MultiplyAdd(r0b1c, zmmCol0B1c, accum1);
+            accum2 = MultiplyAdd(r1b1c, zmmCol0B1c, accum2);
+            accum3 = MultiplyAdd(r2b1c, zmmCol0B1c, accum3);
+            accum4 = MultiplyAdd(r3b1c, zmmCol0B1c, accum4);
+            accum1 = MultiplyAdd(r0b1d, zmmCol0B1d, accum1);
+            accum2 = MultiplyAdd(r1b1d, zmmCol0B1d, accum2);
+            accum3 = MultiplyAdd(r2b1d, zmmCol0B1d, accum3);
+            accum4 = MultiplyAdd(r3b1d, zmmCol0B1d, accum4);
+        }
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+        resultStorage[RowColToOffset(1, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(1, c, n)], accum2);
+        resultStorage[RowColToOffset(2, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(2, c, n)], accum3);
+        resultStorage[RowColToOffset(3, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(3, c, n)], accum4);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::HandleBlock128x1(int currBlock, int startRow, int k, int n, short* newA, short* B,
+        int blockCnt, __m512i* resultStorage, VectorT* /*subtractMe*/)
+{
+    int aOffset = RowToColOffsetRewrittenA(startRow, currBlock, 128, 4, k);
+    short* currA = &newA[aOffset];
+    LOADAVX512_128x1;
+
+    __m512i r0b1a = _mm512_setzero_si512(), r0b1b = _mm512_setzero_si512(), r0b1c = _mm512_setzero_si512(), r0b1d = _mm512_setzero_si512();
+    if (blockCnt > 1)
+    {
+        short* currA2 = &newA[RowToColOffsetRewrittenA(startRow, currBlock + 1, 128, 4, k)];
+        r0b1a = _mm512_load_si512((__m512i*)currA2);
+        r0b1b = _mm512_load_si512((__m512i*)(currA2 + 32));
+        r0b1c = _mm512_load_si512((__m512i*)(currA2 + 64));
+        r0b1d = _mm512_load_si512((__m512i*)(currA2 + 96));
+    }
+
+    for (int c = 0; c < n; ++c)
+    {
+        short* currB = &B[RowToColOffsetRewrittenB(c, currBlock, 128, n)];
+        __m512i zmmCol0B0a = _mm512_load_si512((__m512i*)currB);
+        __m512i zmmCol0B0b = _mm512_load_si512((__m512i*)(currB + 32));
+        __m512i zmmCol0B0c = _mm512_load_si512((__m512i*)(currB + 64));
+        __m512i zmmCol0B0d = _mm512_load_si512((__m512i*)(currB + 96));
+
+        __m512i accum1 = MultiplyAdd(r0b0a, zmmCol0B0a, _mm512_setzero_si512());
+        accum1 = MultiplyAdd(r0b0b, zmmCol0B0b, accum1);
+        accum1 = MultiplyAdd(r0b0c, zmmCol0B0c, accum1);
+        accum1 = MultiplyAdd(r0b0d, zmmCol0B0d, accum1);
+
+        if (blockCnt > 1)
+        {
+            short* currB2 = &B[RowToColOffsetRewrittenB(c, currBlock + 1, 128, n)];
+            accum1 = MultiplyAdd(r0b1a, _mm512_load_si512((__m512i*)currB2), accum1);
+            accum1 = MultiplyAdd(r0b1b, _mm512_load_si512((__m512i*)(currB2 + 32)), accum1);
+            accum1 = MultiplyAdd(r0b1c, _mm512_load_si512((__m512i*)(currB2 + 64)), accum1);
+            accum1 = MultiplyAdd(r0b1d, _mm512_load_si512((__m512i*)(currB2 + 96)), accum1);
+        }
+
+        resultStorage[RowColToOffset(0, c, n)] = _mm512_add_epi32(resultStorage[RowColToOffset(0, c, n)], accum1);
+    }
+}
+
+FORCEINLINE void BlockHandlerAVX512::kernelsse8x1(__m128i xmmRow0,
+        short* B, __m128i* return1)
+{
+    __m128i xmmCol0 = _mm_load_si128((__m128i*)B);
+    __m128i result1 = _mm_madd_epi16(xmmRow0, xmmCol0);
+    *return1 = result1;
+}
+
+FORCEINLINE void BlockHandlerAVX512::kernelsse8x4(__m128i xmmRow0, __m128i xmmRow1, __m128i xmmRow2, __m128i xmmRow3,
+        short* B, __m128i* return1, __m128i* return2, __m128i* return3, __m128i* return4)
+{
+    __m128i xmmCol0 = _mm_load_si128((__m128i*)B);
+
+    __m128i result1 = _mm_madd_epi16(xmmRow0, xmmCol0);
+    __m128i result2 = _mm_madd_epi16(xmmRow1, xmmCol0);
+    __m128i result3 = _mm_madd_epi16(xmmRow2, xmmCol0);
+    __m128i result4 = _mm_madd_epi16(xmmRow3, xmmCol0);
+
+    *return1 = result1;
+    *return2 = result2;
+    *return3 = result3;
+    *return4 = result4;
+}
+
+}}}
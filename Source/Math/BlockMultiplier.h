@@ -23,8 +23,11 @@
 #ifdef SUPPORT_AVX2
 #include "BlockHandlerAVX.h"
 #endif
-//#define STDTHREAD
-#define OPENMPTHREAD
+#ifdef SUPPORT_AVX512
+#include "BlockHandlerAVX512.h"
+#endif
+#define STDTHREAD
+//#define OPENMPTHREAD
 #ifdef STDTHREAD
 #include "StdThreadPool.h"
 #else 
@@ -107,6 +110,11 @@ template<typename BlockHandlerT> class BlockMultiplier
         int m_blockSize;
         std::mutex m_MultiplyMut;
 
+        // Threshold (in multiply-accumulate operations, i.e. m * k * n) below which the
+        // multiplication runs on the calling thread. For the small-batch multiplies typical
+        // of online inference, queueing row tasks costs more than it buys.
+        int64_t m_parallelismThreshold;
+
         // Function objects - thin wrappers around the thread functions (which know how to feed
         // blocks to the actualy dot product kernels implemented in BlockHandlerT).
 
@@ -182,7 +190,7 @@ template<typename BlockHandlerT> class BlockMultiplier
         static void BlockHandler128x4Thread(HandlerArgs<BlockHandlerT> ha)
         {
             // Accumulate full row results locally b/f writing to C
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * ha.rowsPerBlock * ha.n);
             const int blocksAtOnce = 2;
 
@@ -221,7 +229,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler64x4Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * 4 * ha.n);
             int32_t* transC = ha.transC;
 
@@ -254,7 +262,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler32x4Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * 4 * ha.n);
             int32_t* transC = ha.transC;
 
@@ -287,7 +295,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler16x4Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*) ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 16);
+            VectorT* resultStorage = (VectorT*) ALIGNED_ALLOC(sizeof(VectorT) * 4 * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * 4 * ha.n);
             int32_t* transC = ha.transC;
             for (int currBlock = 0; currBlock < ha.blocks; ++currBlock)
@@ -379,7 +387,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler64x1Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * ha.rowsPerBlock * ha.n);
             int32_t* transC = ha.transC;
 
@@ -403,7 +411,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler32x1Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * ha.rowsPerBlock * ha.n);
             int32_t* transC = ha.transC;
 
@@ -427,7 +435,7 @@ template<typename BlockHandlerT> class BlockMultiplier
 
         static void BlockHandler16x1Thread(HandlerArgs<BlockHandlerT> ha)
         {
-            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 16);
+            VectorT* resultStorage = (VectorT*)ALIGNED_ALLOC(sizeof(VectorT) * ha.rowsPerBlock * ha.n, 64);
             memset(resultStorage, 0, sizeof(VectorT) * ha.rowsPerBlock  * ha.n);
             int32_t* transC = ha.transC;
 
@@ -545,11 +553,41 @@ template<typename BlockHandlerT> class BlockMultiplier
         }
 #endif
 
+#ifdef SUPPORT_AVX512
+        //Same as above, for AVX-512 registers. The blendv-on-sign-bit trick is reproduced
+        //here with a compare-against-zero mask plus a masked move.
+        FORCEINLINE static __m512i my_adds_epi32(__m512i a, __m512i b)
+        {
+            __m512i int_min = _mm512_set1_epi32(0x80000000);
+            __m512i int_max = _mm512_set1_epi32(0x7FFFFFFF);
+            __m512i res = _mm512_add_epi32(a, b);
+            __m512i sign_and = _mm512_and_si512(a, b);
+            __m512i sign_or = _mm512_or_si512(a, b);
+            __mmask16 min_sat_mask = _mm512_cmplt_epi32_mask(_mm512_andnot_si512(res, sign_and), _mm512_setzero_si512());
+            __mmask16 max_sat_mask = _mm512_cmplt_epi32_mask(_mm512_andnot_si512(sign_or, res), _mm512_setzero_si512());
+            res = _mm512_mask_mov_epi32(res, min_sat_mask, int_min);
+            return _mm512_mask_mov_epi32(res, max_sat_mask, int_max);
+        }
+
+        //Same as above, for AVX-512 registers. Fold the upper half onto the lower one
+        //(saturating), then reuse the AVX2 horizontal add.
+        FORCEINLINE static int32_t my_hadd(__m512i hAddMe)
+        {
+            __m256i lo = _mm512_castsi512_si256(hAddMe);
+            __m256i hi = _mm512_extracti64x4_epi64(hAddMe, 1);
+            return my_hadd(my_adds_epi32(lo, hi));
+        }
+#endif
+
 
         int m_numThreads;
 
-        BlockMultiplier(int numThreads = 1) 
+        BlockMultiplier(int numThreads = 1)
         {
+            // PrepareB may never get called (e.g. the multiplier object is constructed but the
+            // network is not evaluated), so make sure the destructor sees a well-defined value.
+            m_pBlockHandlerBInfo = nullptr;
+            m_parallelismThreshold = DEFAULTPARALLELISMTHRESHOLD;
             SetNumThreads(numThreads);
         }
 
@@ -566,10 +604,18 @@ template<typename BlockHandlerT> class BlockMultiplier
 #endif
         }
 
+        // Multiplies with fewer than this many multiply-accumulates stay on the calling thread.
+        void SetParallelismThreshold(int64_t macsThreshold)
+        {
+            m_parallelismThreshold = macsThreshold;
+        }
+
         ~BlockMultiplier()
         {
             BlockHandlerT::FreePreparedB(m_pBlockHandlerBInfo);
+#ifdef OPENMPTHREAD
             omp_set_num_threads(m_oldNumThreads);
+#endif
         }
         static ScalarAT* CreateMatrixA(int m, int n, ScalarAT initVal = 0);
         static ScalarBT* CreateMatrixB(int m, int n, ScalarBT initVal = 0);
@@ -580,6 +626,7 @@ template<typename BlockHandlerT> class BlockMultiplier
         // For now we assume m, k and n are all multiples of kernelsize.
         void MultiplyMatrices(ScalarAT* A, int m, int k, ScalarBT* B, int n, int32_t* C, ScalarAT alpha = 1, ScalarBT beta = 0);
         static const int MAXRANGE = 1 << 13;
+        static const int64_t DEFAULTPARALLELISMTHRESHOLD = 64 * 1024;
         int m_oldNumThreads;
 };
 
@@ -854,6 +901,10 @@ template<typename BlockHandlerT> void BlockMultiplier<BlockHandlerT>::MultiplyMa
             throw std::logic_error("alpha / beta not yet implemented for this class");
         }
 
+        // Below the threshold the queueing overhead exceeds the win from parallelism,
+        // so run the row tasks inline on the calling thread.
+        bool runParallel = ((int64_t)m * k * n) >= m_parallelismThreshold;
+
         ScalarAT* newA = CreateMatrixA(m, k);
 
         RewriteAInBlockOrder(A, newA, m, k, m_blockSize, rowsPerBlock);
@@ -928,13 +979,16 @@ template<typename BlockHandlerT> void BlockMultiplier<BlockHandlerT>::MultiplyMa
                 {
 
 #ifdef OPENMPTHREAD
-#pragma omp parallel for
+#pragma omp parallel for if (runParallel)
 #endif
                     for (int startRow = 0; startRow < m; startRow += 4)
                     {
                         ha.startRow = startRow;
 #ifdef STDTHREAD
-                        m_pPool->QueueAndWake(ha, currBlockInfo.fourFn);
+                        if (runParallel)
+                            m_pPool->QueueAndWake(ha, currBlockInfo.fourFn);
+                        else
+                            currBlockInfo.fourFn(ha);
 #else
 #ifdef OPENMPTHREAD
                         currBlockInfo.fourFn(ha);
@@ -943,20 +997,24 @@ template<typename BlockHandlerT> void BlockMultiplier<BlockHandlerT>::MultiplyMa
                     }
 
 #ifdef STDTHREAD 
-                    m_pPool->Drain();
+                    if (runParallel)
+                        m_pPool->Drain();
 #endif
                 }
 
                 else if (rowsPerBlock == 1)
                 {
 #ifdef OPENMPTHREAD
-#pragma omp parallel for
+#pragma omp parallel for if (runParallel)
 #endif
                     for (int startRow = 0; startRow < m; ++startRow)
                     {
                         ha.startRow = startRow;
 #ifdef STDTHREAD
-                        m_pPool->QueueAndWake(ha, currBlockInfo.oneFn);
+                        if (runParallel)
+                            m_pPool->QueueAndWake(ha, currBlockInfo.oneFn);
+                        else
+                            currBlockInfo.oneFn(ha);
 #else
 #ifdef OPENMPTHREAD
                         currBlockInfo.oneFn(ha);
@@ -964,7 +1022,8 @@ template<typename BlockHandlerT> void BlockMultiplier<BlockHandlerT>::MultiplyMa
 #endif
                     }
 #ifdef STDTHREAD
-                    m_pPool->Drain();
+                    if (runParallel)
+                        m_pPool->Drain();
 #endif
                 }
                 else
@@ -3,17 +3,73 @@
 // Licensed under the MIT license. See LICENSE.md file in the project root for full licence information.
 //
 #pragma once
+#include <cstdint>
 #ifdef _MSC_VER
+#include <intrin.h>
 #define ALIGNED_ALLOC(bytes,alignment) _aligned_malloc(bytes,alignment)
 #define ALIGNED_FREE(ptr) _aligned_free(ptr)
 #define FORCEINLINE __forceinline
 #else
 #ifdef __GNUC__
 #include <stdlib.h>
+#include <cpuid.h>
 #define ALIGNED_ALLOC(bytes,alignment) aligned_alloc(alignment,bytes)
 #define ALIGNED_FREE(ptr) free(ptr)
-//#define FORCEINLINE __attribute__((always_inline)) 
-#define FORCEINLINE inline 
+//#define FORCEINLINE __attribute__((always_inline))
+#define FORCEINLINE inline
 #endif
 #endif
 
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Runtime CPU feature probes used to dispatch to the widest block handler that was
+// compiled in. Besides the CPUID feature bits we also check (via XGETBV) that the OS
+// actually saves the corresponding register state, otherwise the wider instructions
+// would fault even though CPUID advertises them.
+inline void PlatformCpuid(int func, int subFunc, int* regs /*eax, ebx, ecx, edx*/)
+{
+#ifdef _MSC_VER
+    __cpuidex(regs, func, subFunc);
+#else
+    __cpuid_count(func, subFunc, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+inline uint64_t PlatformXgetbv()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+inline bool CpuHasAvx2Support()
+{
+    int regs[4];
+    PlatformCpuid(1, 0, regs);
+    if ((regs[2] & (1 << 27)) == 0) // OSXSAVE
+        return false;
+    if ((PlatformXgetbv() & 0x6) != 0x6) // XMM and YMM state enabled
+        return false;
+    PlatformCpuid(7, 0, regs);
+    return (regs[1] & (1 << 5)) != 0; // EBX bit 5: AVX2
+}
+
+inline bool CpuHasAvx512Support()
+{
+    int regs[4];
+    PlatformCpuid(1, 0, regs);
+    if ((regs[2] & (1 << 27)) == 0) // OSXSAVE
+        return false;
+    if ((PlatformXgetbv() & 0xE6) != 0xE6) // XMM, YMM and the three ZMM state components
+        return false;
+    PlatformCpuid(7, 0, regs);
+    // The madd kernels need both AVX512F (EBX bit 16) and AVX512BW (EBX bit 30).
+    return (regs[1] & (1 << 16)) != 0 && (regs[1] & (1 << 30)) != 0;
+}
+
+}}}
+
@@ -115,11 +115,56 @@ CPUMatrix<ElemType>::CPUMatrix()
     ZeroInit();
 }
 
+// NUMA placement policy for CPU matrix buffers; see the comment on CPUMatrixNumaPolicy.
+static CPUMatrixNumaPolicy s_numaAllocationPolicy = CPUMatrixNumaPolicy::None;
+static CPUMatrixNumaPolicy s_numaAllocationPolicyOverride = CPUMatrixNumaPolicy::None;
+
+void SetCPUMatrixNumaAllocationPolicy(CPUMatrixNumaPolicy policy)
+{
+    s_numaAllocationPolicy = policy;
+}
+
+CPUMatrixNumaPolicy GetCPUMatrixNumaAllocationPolicy()
+{
+    return s_numaAllocationPolicyOverride != CPUMatrixNumaPolicy::None ? s_numaAllocationPolicyOverride : s_numaAllocationPolicy;
+}
+
+void OverrideCPUMatrixNumaAllocationPolicy(CPUMatrixNumaPolicy policy)
+{
+    s_numaAllocationPolicyOverride = policy;
+}
+
 // helper to allocate an array of ElemType
 // Use this instead of new[] to get NaN initialization for debugging.
 template <class ElemType>
 static ElemType* NewArray(size_t n)
 {
+    // Buffers of at least one memory page per thread get placed according to the NUMA
+    // policy: allocate without value-initialization (so no page is touched yet) and zero
+    // page-sized chunks on the OpenMP team, relying on first-touch placement by the OS.
+    // schedule(static) gives each thread one contiguous range — the same partition the
+    // elementwise loops use — while schedule(static, 1) interleaves pages round-robin.
+    const size_t pageElems = 4096 / sizeof(ElemType);
+    CPUMatrixNumaPolicy policy = GetCPUMatrixNumaAllocationPolicy();
+    if (policy != CPUMatrixNumaPolicy::None && n >= pageElems * (size_t)omp_get_max_threads())
+    {
+        ElemType* p = new ElemType[n];
+        long long numPages = (long long)((n + pageElems - 1) / pageElems);
+        if (policy == CPUMatrixNumaPolicy::FirstTouch)
+        {
+#pragma omp parallel for schedule(static)
+            for (long long page = 0; page < numPages; ++page)
+                memset(p + page * pageElems, 0, sizeof(ElemType) * std::min(pageElems, n - page * pageElems));
+        }
+        else
+        {
+#pragma omp parallel for schedule(static, 1)
+            for (long long page = 0; page < numPages; ++page)
+                memset(p + page * pageElems, 0, sizeof(ElemType) * std::min(pageElems, n - page * pageElems));
+        }
+        return p;
+    }
+
     ElemType* p = new ElemType[n]();
 #if 0 // _DEBUG
         ElemType nan = Matrix<ElemType>::MakeNan(__LINE__);
@@ -598,23 +643,27 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AssignTransposeOf(const CPUMatrix<Elem
     RequireSize(a.GetNumCols(), a.GetNumRows());
     long n = (long) a.GetNumCols(), m = (long) a.GetNumRows();
 
-    auto& us = *this;
+    // Transpose in square tiles. A straight column walk reads a(:, j) contiguously but scatters the
+    // writes with a stride of n elements, so on large matrices every store misses the cache. Within a
+    // tile both source and target stay resident, and the contiguous side of each tile loop vectorizes.
+    const long blockSize = 64;
+
+    const ElemType* aBuffer = a.Data();
+    ElemType* usBuffer = Data();
 
 #pragma omp parallel for
-    for (long j = 0; j < n; j++)
+    for (long jb = 0; jb < n; jb += blockSize)
     {
-        // four-way unrolling
-        for (long i = 0; i < (m & ~3); i += 4)
-        {
-            us(j, i) = a(i, j);
-            us(j, i + 1) = a(i + 1, j);
-            us(j, i + 2) = a(i + 2, j);
-            us(j, i + 3) = a(i + 3, j);
-        }
-        // handle remaining stuffs
-        for (long i = m & ~3; i < m; i++)
+        long jend = std::min(jb + blockSize, n);
+        for (long ib = 0; ib < m; ib += blockSize)
         {
-            us(j, i) = a(i, j);
+            long iend = std::min(ib + blockSize, m);
+            for (long j = jb; j < jend; j++)
+            {
+                const ElemType* aCol = aBuffer + (size_t) j * m; // a(:, j)
+                for (long i = ib; i < iend; i++)
+                    usBuffer[(size_t) i * n + j] = aCol[i]; // us(j, i) = a(i, j)
+            }
         }
     }
 
@@ -653,6 +702,45 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::DoGatherColumnsOf(ElemType beta, const
         Resize(a.GetNumRows(), idx.GetNumCols());
 
     auto& us = *this;
+
+    // fast path for the plain-copy case (beta == 0, alpha == 1)
+    // Attention-style models gather with maps that are largely sorted or even static; batching
+    // maximal runs of consecutive source columns into single memcpy() calls then copies whole
+    // blocks instead of going column by column (columns are contiguous in our dense storage).
+    // With a fully unsorted map every run has length 1 and this degenerates to the general loop.
+    if (beta == 0 && alpha == 1)
+    {
+        let numRows = GetNumRows();
+        let numCols = GetNumCols();
+        std::vector<std::pair<size_t, size_t>> runs; // (first output column, #columns) per run
+        runs.reserve(numCols);
+        for (size_t jOut = 0; jOut < numCols;)
+        {
+            auto jInF = idx(0, jOut);         // this is the column we need to get
+            if (std::isnan(jInF) || jInF < 0) // negative index means gap: output column remains untouched
+            {
+                jOut++;
+                continue;
+            }
+            size_t jIn = (size_t)jInF;
+            size_t len = 1;
+            while (jOut + len < numCols && idx(0, jOut + len) == jInF + (ElemType)len)
+                len++;
+            if (jIn + len > a.GetNumCols())
+                InvalidArgument("DoGatherColumnsOf: Map out of bounds. %ld >= %ld", (long int)(jIn + len - 1), (long int)a.GetNumCols());
+            runs.push_back(std::make_pair(jOut, len));
+            jOut += len;
+        }
+#pragma omp parallel for
+        for (long r = 0; r < (long) runs.size(); r++)
+        {
+            let jOut = runs[r].first;
+            let jIn = (size_t) idx(0, jOut);
+            memcpy(&us(0, jOut), &a(0, jIn), sizeof(ElemType) * numRows * runs[r].second);
+        }
+        return *this;
+    }
+
 #pragma omp parallel for // TODO: Depending in circumstance, it may be more efficient to parallelize over rows.
     foreach_column(jOut, us)
     {
@@ -870,6 +958,41 @@ void CPUMatrix<ElemType>::SetValue(const GPUSparseMatrix<ElemType>& /*deepCopyFr
 }
 #endif
 
+// Widen a half-precision (column-major) buffer into this matrix. The matrix is resized as needed.
+template <class ElemType>
+void CPUMatrix<ElemType>::SetValueFromFloat16(const size_t numRows, const size_t numCols, const float16* pArray)
+{
+    if (pArray == nullptr && numRows * numCols > 0)
+        InvalidArgument("Invalid pArray. pArray == nullptr, but matrix is of size %d * %d = %d.", (int) numRows, (int) numCols, (int) (numRows * numCols));
+
+    SetFormat(matrixFormatDense);
+    SetComputeDeviceId(CPUDEVICE);
+    RequireSize(numRows, numCols);
+
+    if (IsEmpty())
+        return;
+
+    ElemType* bufPtr = Data();
+    long numElements = (long) GetNumElements();
+#pragma omp parallel for
+    for (long i = 0; i < numElements; i++)
+        bufPtr[i] = (ElemType) (float) pArray[i];
+}
+
+// Narrow this matrix into a caller-allocated half-precision buffer of GetNumElements() entries.
+template <class ElemType>
+void CPUMatrix<ElemType>::CopyToFloat16Array(float16* pArray) const
+{
+    if (pArray == nullptr && !IsEmpty())
+        InvalidArgument("CopyToFloat16Array: pArray is nullptr.");
+
+    const ElemType* bufPtr = Data();
+    long numElements = (long) GetNumElements();
+#pragma omp parallel for
+    for (long i = 0; i < numElements; i++)
+        pArray[i] = float16((float) bufPtr[i]);
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::SetValue(const size_t numRows, const size_t numCols, ElemType* pArray, const size_t matrixFlags)
 {
@@ -1101,29 +1224,48 @@ void CPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
     CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
     assert(cpuRNGHandle != nullptr);
 
-    auto& us = *this;
-    boost::random::uniform_real_distribution<ElemType> r(0, 1);
-    long m = (long) GetNumRows(), n = (long) GetNumCols();
-    ElemType v;
+    // Counter-based generation (Philox4x32): each block of four elements is computed from
+    // (seed, stream position) alone, so the mask is bitwise identical regardless of how the
+    // column loop is partitioned across the OpenMP worker pool, and identical to what a serial
+    // pass would produce. The stream position advances by one per element, keeping the handle
+    // aligned with the node-level rng offset (which advances by GetNumElements() per minibatch).
+    ElemType* bufPtr = Data();
+    const long m = (long) GetNumRows(), n = (long) GetNumCols();
+    const uint64_t seed = cpuRNGHandle->Seed();
+    const uint64_t callOffset = cpuRNGHandle->ConsumeCounter((size_t) m * n);
+#pragma omp parallel for
     for (long j = 0; j < n; j++)
     {
-        // four-way unrolling
-        for (long i = 0; i < (m & ~3); i += 4)
+        ElemType* column = bufPtr + (size_t) j * m;
+        const uint64_t colStart = callOffset + (uint64_t) j * m;
+        uint32_t rnd[4];
+        long i = 0;
+        // head: a column's first stream position may fall inside a block of four when m % 4 != 0
+        for (; i < m && ((colStart + i) & 3) != 0; i++)
         {
-            v = r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 1, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 2, j) = v <= maskRate ? 0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 3, j) = v <= maskRate ? 0 : scaleValue;
+            Philox4x32::Generate(seed, 0, (colStart + i) >> 2, rnd);
+            const ElemType v = (ElemType) Philox4x32::ToUniform(rnd[(colStart + i) & 3]);
+            column[i] = v <= maskRate ? 0 : scaleValue;
         }
-        // handle remaining stuffs
-        for (long i = m & ~3; i < m; i++)
+        // aligned blocks of four elements per Philox invocation
+        for (; i + 4 <= m; i += 4)
         {
-            v = r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? 0 : scaleValue;
+            Philox4x32::Generate(seed, 0, (colStart + i) >> 2, rnd);
+            for (long k = 0; k < 4; k++)
+            {
+                const ElemType v = (ElemType) Philox4x32::ToUniform(rnd[k]);
+                column[i + k] = v <= maskRate ? 0 : scaleValue;
+            }
+        }
+        // tail
+        if (i < m)
+        {
+            Philox4x32::Generate(seed, 0, (colStart + i) >> 2, rnd);
+            for (long k = 0; i + k < m; k++)
+            {
+                const ElemType v = (ElemType) Philox4x32::ToUniform(rnd[k]);
+                column[i + k] = v <= maskRate ? 0 : scaleValue;
+            }
         }
     }
 }
@@ -1215,31 +1357,35 @@ void CPUMatrix<ElemType>::FSAdagrad(CPUMatrix<ElemType>& gradients,
     ElemType* smoothAda = Data();
     ElemType* smoothMom = Data() + n;
     ElemType* val = functionValues.Data();
-#pragma omp parallel for
-    // TODO: Unroll 4-times for better performance leveraging vectorization
-    for (long i = 0; i < n; i++)
+
+    // The loop body is written branch-free (selects instead of ifs) and the momentum test is
+    // hoisted out of the loop, so the compiler can vectorize the single fused pass over the
+    // four arrays; OpenMP partitions the element range across cores.
+    if (momentum > 0.0f)
     {
-        ElemType g = grad[i];
-        ElemType adaSqr = adaWeight * smoothAda[i] + (1.0f - adaWeight) * g * g;
-        smoothAda[i] = adaSqr;
-        if (adaSqr != 0.0f)
+#pragma omp parallel for
+        for (long i = 0; i < (long) n; i++)
         {
-            ElemType ada = sqrt(adaSqr);
-            ElemType w = adaMul * ((ElemType) 1.0 / ada);
-
-            if (w > 10.0f)
-                w = 10.0f;
-            g *= w;
+            ElemType g = grad[i];
+            ElemType adaSqr = adaWeight * smoothAda[i] + (1.0f - adaWeight) * g * g;
+            smoothAda[i] = adaSqr;
+            ElemType w = adaSqr != 0.0f ? std::min(adaMul / sqrt(adaSqr), (ElemType) 10.0) : (ElemType) 1.0;
+            g = momentum * smoothMom[i] + (1.0f - momentum) * (g * w);
+            smoothMom[i] = g;
+            val[i] -= g * learnRatePerSample;
         }
-
-        if (momentum > 0.0f)
+    }
+    else
+    {
+#pragma omp parallel for
+        for (long i = 0; i < (long) n; i++)
         {
-            g = momentum * smoothMom[i] + (1.0f - momentum) * g;
-            smoothMom[i] = g;
+            ElemType g = grad[i];
+            ElemType adaSqr = adaWeight * smoothAda[i] + (1.0f - adaWeight) * g * g;
+            smoothAda[i] = adaSqr;
+            ElemType w = adaSqr != 0.0f ? std::min(adaMul / sqrt(adaSqr), (ElemType) 10.0) : (ElemType) 1.0;
+            val[i] -= g * w * learnRatePerSample;
         }
-
-        g *= learnRatePerSample;
-        val[i] -= g;
     }
 }
 
@@ -1314,18 +1460,20 @@ ElemType CPUMatrix<ElemType>::RmsProp(CPUMatrix<ElemType>& gradients,
     //    curr_grad[i] *= steps[i] / sqrt(avars[i] + floor);
     //      }
 
-    ElemType aveMultiplier = 0, a;
-    for (long i = 0; i < n; i++)
+    // fused single pass over the four state arrays; the step update is a select rather than a
+    // branch so the loop vectorizes, and the average multiplier is an OpenMP reduction
+    ElemType aveMultiplier = 0;
+#pragma omp parallel for reduction(+ : aveMultiplier)
+    for (long i = 0; i < (long) n; i++)
     {
         avars[i] = RMS_GAMMA * avars[i] + ONE_MINUS_GAMMA * (curr_grad[i] * curr_grad[i]);
         const int grad_sign = (ElemType(0) < curr_grad[i]) - (curr_grad[i] < ElemType(0));
 
-        if (signs[i] * grad_sign > 0)
-            steps[i] = std::min(steps[i] * RMS_WGT_INC, RMS_WGT_MAX);
-        else
-            steps[i] = std::max(steps[i] * RMS_WGT_DEC, RMS_WGT_MIN);
+        steps[i] = (signs[i] * grad_sign > 0)
+                       ? std::min(steps[i] * RMS_WGT_INC, RMS_WGT_MAX)
+                       : std::max(steps[i] * RMS_WGT_DEC, RMS_WGT_MIN);
 
-        a = steps[i] / sqrt(avars[i] + floor);
+        ElemType a = steps[i] / sqrt(avars[i] + floor);
         curr_grad[i] *= a;
         signs[i] = (ElemType) grad_sign;
 
@@ -1352,10 +1500,10 @@ void CPUMatrix<ElemType>::Reshape(const size_t numRows, const size_t numCols)
 
 // RequireSize() -- Tests if the matrix is the right size. If not, resizes the matrix. This avoids the VerifyResizable check if we're already the right size.
 template <class ElemType>
-void CPUMatrix<ElemType>::RequireSize(const size_t numRows, const size_t numCols, bool growOnly /*=true*/)
+void CPUMatrix<ElemType>::RequireSize(const size_t numRows, const size_t numCols, bool growOnly /*=true*/, bool cachedResize /*=false*/)
 {
     if (GetNumRows() != numRows || GetNumCols() != numCols)
-        Resize(numRows, numCols, growOnly);
+        Resize(numRows, numCols, growOnly, cachedResize);
 }
 
 // Resize() -- change matrix size
@@ -1363,26 +1511,38 @@ void CPUMatrix<ElemType>::RequireSize(const size_t numRows, const size_t numCols
 // Current content is not preserved.
 // If growOnly is true, resize will not reallocate memory if the current memory is large enough (i.e., will not shrink).
 // If this object does not own its memory then new memory cannot be allocated (one can still shrink and/or reshape).
+// If cachedResize is true, the buffer is drawn from (and released back to) the BufferManagement pool, mirroring the
+// cached-resize path of GPUMatrix::Resize. Buffers then persist across minibatches at their high-water-mark size, so
+// per-minibatch resizes stop hitting the system allocator.
 template <class ElemType>
-void CPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, bool growOnly /*=true*/)
+void CPUMatrix<ElemType>::Resize(const size_t numRows, const size_t numCols, bool growOnly /*=true*/, bool cachedResize /*=false*/)
 {
     if (GetNumRows() == numRows && GetNumCols() == numCols)
         return;
 
     VerifyResizable(__func__);
+    bool isForceResize = (!growOnly) || cachedResize;
 
     size_t numElements = numRows * numCols;
-    if (numElements > GetSizeAllocated() ||                 // grow allocation
-        (!growOnly && (numElements != GetSizeAllocated()))) // shrink allocation (not if 'growOnly')
+    if (numElements > GetSizeAllocated() ||                    // grow allocation
+        (isForceResize && numElements != GetSizeAllocated()))  // shrink allocation (not if 'growOnly')
     {
         // reallocate buffer
         ElemType* pArray = nullptr;
         if (numElements > 0)
         {
-            pArray = NewArray<ElemType>(numElements);
+            if (cachedResize)
+                pArray = BufferManagement::GetManagerInstance(CPUDEVICE).RequestBuffer<ElemType>(numElements);
+            else
+                pArray = NewArray<ElemType>(numElements);
         }
         // success: update the object
-        delete[] Buffer();
+        // Pooled buffers are plain new[] allocations, so handing a buffer to the pool here and having it freed
+        // later by delete[] (e.g. in ~BaseMatrixStorage) and vice versa are both safe.
+        if (cachedResize && Buffer() != nullptr)
+            BufferManagement::GetManagerInstance(CPUDEVICE).LogicalReleaseBuffer<ElemType>(Buffer(), GetSizeAllocated());
+        else
+            delete[] Buffer();
 
         SetBuffer(pArray, numElements * sizeof(ElemType));
         SetSizeAllocated(numElements);
@@ -2242,20 +2402,47 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AssignLogSoftmaxOf(const CPUMatrix<Ele
 
     if (isColWise)
     {
-#pragma omp parallel for
-        foreach_column (j, a)
+        // Columns are contiguous, so work on raw column buffers: the max/shift/sum/subtract loops then
+        // vectorize, which matters for the large-vocabulary softmax where this function dominates eval
+        // time. With MKL the exp pass uses the vectorized VML kernel via a per-thread scratch column.
+        long m = (long) a.GetNumRows(), n = (long) a.GetNumCols();
+        const ElemType* aBuf = a.Data();
+        ElemType* usBuf = Data();
+#pragma omp parallel
         {
-            // we need to extract max before applying exp to avoid overflow
-            ElemType maxV = a(0, j);
-            foreach_row (i, a)
-                maxV = std::max(maxV, a(i, j));
+#ifdef USE_MKL
+            std::vector<ElemType> expScratch(m);
+#endif
+#pragma omp for
+            for (long j = 0; j < n; j++)
+            {
+                const ElemType* aCol = aBuf + (size_t) j * m;
+                ElemType* usCol = usBuf + (size_t) j * m;
 
-            ElemType sum = 0;
-            foreach_row (i, a)
-                sum += exp(us(i, j) = a(i, j) - maxV);
-            sum = log(sum);
-            foreach_row (i, us)
-                us(i, j) -= sum;
+                // we need to extract max before applying exp to avoid overflow
+                ElemType maxV = aCol[0];
+                for (long i = 1; i < m; i++)
+                    maxV = std::max(maxV, aCol[i]);
+
+                for (long i = 0; i < m; i++)
+                    usCol[i] = aCol[i] - maxV;
+
+                ElemType sum = 0;
+#ifdef USE_MKL
+                if (sizeof(ElemType) == sizeof(double))
+                    vdExp((MKL_INT) m, reinterpret_cast<const double*>(usCol), reinterpret_cast<double*>(expScratch.data()));
+                else
+                    vsExp((MKL_INT) m, reinterpret_cast<const float*>(usCol), reinterpret_cast<float*>(expScratch.data()));
+                for (long i = 0; i < m; i++)
+                    sum += expScratch[i];
+#else
+                for (long i = 0; i < m; i++)
+                    sum += exp(usCol[i]);
+#endif
+                sum = log(sum);
+                for (long i = 0; i < m; i++)
+                    usCol[i] -= sum;
+            }
         }
     }
     else
@@ -4555,6 +4742,28 @@ void CPUMatrix<ElemType>::AveragePoolingBackward(const CPUMatrix<int>& mpRowCol,
     }
 }
 
+// apply a per-channel folded scale and shift, y = foldedScale[c] * x + foldedShift[c], in one fused pass
+// sqrt and division have already been hoisted into the folded coefficients, so the inner loop over the
+// contiguous spatial extent is a plain multiply-add that the compiler can vectorize
+template <class ElemType>
+static void ApplyFoldedScaleShift(const ElemType* x, ElemType* y, const ElemType* foldedScale, const ElemType* foldedShift,
+                                  size_t vectorSize, size_t spatialSize, size_t numChannels, size_t batchSize)
+{
+#pragma omp parallel for
+    for (long icol = 0; icol < (long) batchSize; icol++)
+    {
+        const ElemType* px = x + icol * vectorSize;
+        ElemType* py = y + icol * vectorSize;
+        for (size_t imap = 0; imap < numChannels; imap++)
+        {
+            ElemType fs = foldedScale[imap];
+            ElemType fb = foldedShift[imap];
+            for (size_t i = 0; i < spatialSize; i++)
+                py[imap * spatialSize + i] = fs * px[imap * spatialSize + i] + fb;
+        }
+    }
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::BatchNormalizationForward(const CPUMatrix<ElemType>& scale, const CPUMatrix<ElemType>& bias, bool inferenceOnly, double expAvgFactor, double blendFactor,
                                                     CPUMatrix<ElemType>& runMean, CPUMatrix<ElemType>& runVariance, CPUMatrix<ElemType>& out, double epsilon,
@@ -4562,48 +4771,232 @@ void CPUMatrix<ElemType>::BatchNormalizationForward(const CPUMatrix<ElemType>& s
 {
     assert((GetNumRows() % scale.GetNumRows()) == 0);
 
-    if (!inferenceOnly || expAvgFactor != 0 || blendFactor != 1)
-        RuntimeError("Batch normalization training on CPU is not yet implemented.");
+    bool spatial = GetNumRows() != scale.GetNumRows();
+    size_t vectorSize = GetNumRows();
+    size_t numChannels = scale.GetNumRows();
+    size_t spatialSize = spatial ? vectorSize / numChannels : 1; // non-spatial is handled as spatialSize == 1
+    size_t batchSize = GetNumCols();
 
-    saveMean.Resize(0, 0); // only doing inference: these two are not produced
-    saveInvStdDev.Resize(0, 0);
+    const ElemType* x = Data();
 
-    bool spatial = GetNumRows() != scale.GetNumRows();
-    if (spatial)
+    std::vector<ElemType> foldedScale(numChannels);
+    std::vector<ElemType> foldedShift(numChannels);
+
+    if (inferenceOnly)
     {
-        size_t spatialSize = GetNumRows() / scale.GetNumRows();
+        assert(expAvgFactor == 0 && blendFactor == 1);
+        saveMean.Resize(0, 0); // only doing inference: these two are not produced
+        saveInvStdDev.Resize(0, 0);
+
+        // fold running mean/variance, scale, and bias into one scale and one shift per channel
+        for (size_t imap = 0; imap < numChannels; imap++)
+        {
+            ElemType invStdDev = (ElemType)(1.0 / sqrt(runVariance(imap, 0) + epsilon));
+            foldedScale[imap] = scale(imap, 0) * invStdDev;
+            foldedShift[imap] = bias(imap, 0) - scale(imap, 0) * runMean(imap, 0) * invStdDev;
+        }
+        ApplyFoldedScaleShift(x, out.Data(), foldedScale.data(), foldedShift.data(), vectorSize, spatialSize, numChannels, batchSize);
+        return;
+    }
+
+    // training: single-pass per-channel statistics, channels partitioned across threads.
+    // Semantics (incl. the expAvgFactor/blendFactor updates) match kComputeBatchMeanAndInvStdDev
+    // in CntkBatchNormalization.cuh; like the GPU kernel we use the Welford recurrence, which is
+    // single-pass yet does not suffer the cancellation of the sum/sum-of-squares formula.
+    saveMean.Resize(numChannels, 1);
+    saveInvStdDev.Resize(numChannels, 1);
+
+    size_t n = batchSize * spatialSize; // number of samples each channel is normalized over
 #pragma omp parallel for
-        for (long icol = 0; icol < out.GetNumCols(); icol++)
+    for (long imap = 0; imap < (long) numChannels; imap++)
+    {
+        double mean = 0;
+        double m2 = 0;
+        size_t count = 0;
+        for (size_t icol = 0; icol < batchSize; icol++)
         {
-            for (long irow = 0; irow < out.GetNumRows(); irow++)
+            const ElemType* px = x + icol * vectorSize + imap * spatialSize;
+            for (size_t i = 0; i < spatialSize; i++)
             {
-                size_t imap = irow / spatialSize;
-                ElemType stdDev = sqrt(runVariance(imap, 0) + epsilon);
-                out(irow, icol) = scale(imap, 0) * ((*this)(irow, icol) - runMean(imap, 0)) / stdDev + bias(imap, 0);
+                count++;
+                double d = px[i] - mean;
+                mean += d / count;
+                m2 += d * (px[i] - mean);
             }
         }
+
+        // update running statistics and compute the (possibly blended) statistics to normalize with
+        runMean(imap, 0) = (ElemType)(expAvgFactor * mean + (1 - expAvgFactor) * runMean(imap, 0));
+        saveMean(imap, 0) = (ElemType)(blendFactor * runMean(imap, 0) + (1 - blendFactor) * mean);
+
+        double unbiasedVariance = (n == 1) ? 0 : m2 / (n - 1);
+        runVariance(imap, 0) = (ElemType)(expAvgFactor * unbiasedVariance + (1 - expAvgFactor) * runVariance(imap, 0));
+
+        double invStdDev = 1.0 / sqrt(m2 / n + epsilon);
+        if (blendFactor != 0)
+        {
+            double runInvStdDev = 1.0 / sqrt(runVariance(imap, 0) + epsilon);
+            invStdDev = blendFactor * runInvStdDev + (1 - blendFactor) * invStdDev;
+        }
+        saveInvStdDev(imap, 0) = (ElemType) invStdDev;
+
+        foldedScale[imap] = (ElemType)(scale(imap, 0) * saveInvStdDev(imap, 0));
+        foldedShift[imap] = (ElemType)(bias(imap, 0) - scale(imap, 0) * saveMean(imap, 0) * saveInvStdDev(imap, 0));
     }
-    else
-    {
+
+    // normalize with the saved statistics, folded per channel just like in the inference path
+    ApplyFoldedScaleShift(x, out.Data(), foldedScale.data(), foldedShift.data(), vectorSize, spatialSize, numChannels, batchSize);
+}
+
+// 'this' is the incoming gradient (dy); semantics match kBackpropagateBatchNormGradients in CntkBatchNormalization.cuh
+template <class ElemType>
+void CPUMatrix<ElemType>::BatchNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale, double blendFactor,
+                                                     const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
+                                                     CPUMatrix<ElemType>& scaleGrad, CPUMatrix<ElemType>& biasGrad) const
+{
+    assert((GetNumRows() % scale.GetNumRows()) == 0);
+
+    bool spatial = GetNumRows() != scale.GetNumRows();
+    size_t vectorSize = GetNumRows();
+    size_t numChannels = scale.GetNumRows();
+    size_t spatialSize = spatial ? vectorSize / numChannels : 1;
+    size_t batchSize = GetNumCols();
+
+    const ElemType* x = in.Data();
+    const ElemType* dy = Data();
+    ElemType* dx = grad.Data();
+
+    double mbStatsWeight = 1 - blendFactor; // weight for contribution from actual MB stats (0 if none, e.g. locked BN node)
+    double m = (double)(batchSize * spatialSize);
+
+    // channel partitioning: each thread owns whole channels, so the dScale/dBias reductions need no atomics
 #pragma omp parallel for
-        for (long icol = 0; icol < out.GetNumCols(); icol++)
+    for (long imap = 0; imap < (long) numChannels; imap++)
+    {
+        double mean = saveMean(imap, 0);
+        double invStdDev = saveInvStdDev(imap, 0);
+
+        // first pass: dBias = Reduce(dy), dScale = Reduce(dy * xHat)
+        double ds = 0;
+        double db = 0;
+        for (size_t icol = 0; icol < batchSize; icol++)
+        {
+            const ElemType* px = x + icol * vectorSize + imap * spatialSize;
+            const ElemType* pdy = dy + icol * vectorSize + imap * spatialSize;
+            for (size_t i = 0; i < spatialSize; i++)
+            {
+                ds += pdy[i] * (px[i] - mean) * invStdDev;
+                db += pdy[i];
+            }
+        }
+        scaleGrad(imap, 0) = (ElemType) ds;
+        biasGrad(imap, 0) = (ElemType) db;
+
+        // second pass: dL/dxi = scale * invStdDev * (dL/dyi - mbStatsWeight * (xHat * dL/dScale + dL/dBias) / m)
+        // (see the derivation in CntkBatchNormalization.cuh; added to the existing gradient)
+        ElemType sc = (ElemType)(scale(imap, 0) * invStdDev);
+        ElemType dsOverM = (ElemType)(mbStatsWeight * ds / m);
+        ElemType dbOverM = (ElemType)(mbStatsWeight * db / m);
+        for (size_t icol = 0; icol < batchSize; icol++)
         {
-            for (long irow = 0; irow < out.GetNumRows(); irow++)
+            const ElemType* px = x + icol * vectorSize + imap * spatialSize;
+            const ElemType* pdy = dy + icol * vectorSize + imap * spatialSize;
+            ElemType* pdx = dx + icol * vectorSize + imap * spatialSize;
+            for (size_t i = 0; i < spatialSize; i++)
             {
-                ElemType stdDev = sqrt(runVariance(irow, 0) + epsilon);
-                out(irow, icol) = scale(irow, 0) * ((*this)(irow, icol) - runMean(irow, 0)) / stdDev + bias(irow, 0);
+                ElemType xHat = (ElemType)((px[i] - mean) * invStdDev);
+                pdx[i] += sc * (pdy[i] - (xHat * dsOverM + dbOverM));
             }
         }
     }
 }
 
 template <class ElemType>
-void CPUMatrix<ElemType>::BatchNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale, double blendFactor,
+void CPUMatrix<ElemType>::LayerNormalizationForward(const CPUMatrix<ElemType>& scale, const CPUMatrix<ElemType>& bias, CPUMatrix<ElemType>& out, double epsilon,
+                                                    CPUMatrix<ElemType>& saveMean, CPUMatrix<ElemType>& saveInvStdDev) const
+{
+    assert(GetNumRows() == scale.GetNumRows());
+    assert(GetNumRows() == bias.GetNumRows());
+
+    long rows = (long) GetNumRows();
+    long cols = (long) GetNumCols();
+    saveMean.Resize(1, cols);
+    saveInvStdDev.Resize(1, cols);
+
+#pragma omp parallel for
+    for (long icol = 0; icol < cols; icol++)
+    {
+        // Welford's single-pass mean/variance accumulation
+        ElemType mean = 0;
+        ElemType m2 = 0;
+        for (long irow = 0; irow < rows; irow++)
+        {
+            ElemType x = (*this)(irow, icol);
+            ElemType delta = x - mean;
+            mean += delta / (irow + 1);
+            m2 += delta * (x - mean);
+        }
+        ElemType invStdDev = (ElemType)(1.0 / sqrt(m2 / rows + epsilon));
+        saveMean(0, icol) = mean;
+        saveInvStdDev(0, icol) = invStdDev;
+
+        for (long irow = 0; irow < rows; irow++)
+            out(irow, icol) = scale(irow, 0) * (((*this)(irow, icol) - mean) * invStdDev) + bias(irow, 0);
+    }
+}
+
+template <class ElemType>
+void CPUMatrix<ElemType>::LayerNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale,
                                                      const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
                                                      CPUMatrix<ElemType>& scaleGrad, CPUMatrix<ElemType>& biasGrad) const
 {
-    UNUSED(in); UNUSED(grad); UNUSED(scale); UNUSED(blendFactor), UNUSED(saveMean); UNUSED(saveInvStdDev); UNUSED(scaleGrad); UNUSED(biasGrad);
-    RuntimeError("Batch normalization training on CPU is not yet implemented.");
+    long rows = (long) GetNumRows();
+    long cols = (long) GetNumCols();
+    scaleGrad.Resize(rows, 1);
+    biasGrad.Resize(rows, 1);
+
+    // gradient to the data input (accumulated), fused over the two per-column reductions
+#pragma omp parallel for
+    for (long icol = 0; icol < cols; icol++)
+    {
+        ElemType mean = saveMean(0, icol);
+        ElemType invStdDev = saveInvStdDev(0, icol);
+
+        ElemType sumG = 0;
+        ElemType sumGX = 0;
+        for (long irow = 0; irow < rows; irow++)
+        {
+            ElemType xHat = (in(irow, icol) - mean) * invStdDev;
+            ElemType g = (*this)(irow, icol) * scale(irow, 0);
+            sumG += g;
+            sumGX += g * xHat;
+        }
+        sumG /= rows;
+        sumGX /= rows;
+
+        for (long irow = 0; irow < rows; irow++)
+        {
+            ElemType xHat = (in(irow, icol) - mean) * invStdDev;
+            ElemType g = (*this)(irow, icol) * scale(irow, 0);
+            grad(irow, icol) += invStdDev * (g - sumG - xHat * sumGX);
+        }
+    }
+
+    // scale/bias gradients reduce over columns; parallelize over rows to keep writes disjoint
+#pragma omp parallel for
+    for (long irow = 0; irow < rows; irow++)
+    {
+        ElemType ds = 0;
+        ElemType db = 0;
+        for (long icol = 0; icol < cols; icol++)
+        {
+            ElemType xHat = (in(irow, icol) - saveMean(0, icol)) * saveInvStdDev(0, icol);
+            ds += (*this)(irow, icol) * xHat;
+            db += (*this)(irow, icol);
+        }
+        scaleGrad(irow, 0) = ds;
+        biasGrad(irow, 0) = db;
+    }
 }
 
 
@@ -4693,6 +5086,126 @@ void CPUMatrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix
     }
 }
 
+// Batched version of MultiplyAndWeightedAdd for many small GEMMs of identical shape, e.g. the groups of a
+// grouped convolution or the per-frame steps of an unrolled recurrence. a, b and c each hold numBatches
+// equal column blocks, one per GEMM; batch i multiplies block i of a (optionally transposed) with block i
+// of b into block i of c. With MKL this issues a single cblas_?gemm_batch call, amortizing the per-call
+// dispatch overhead that dominates tiny GEMMs; other BLAS backends spread the batches across OpenMP threads.
+template <class ElemType>
+void CPUMatrix<ElemType>::BatchedMultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& a, const bool transposeA, const CPUMatrix<ElemType>& b, const bool transposeB,
+                                                        ElemType beta, CPUMatrix<ElemType>& c, const size_t numBatches)
+{
+    if (numBatches == 1)
+        return MultiplyAndWeightedAdd(alpha, a, transposeA, b, transposeB, beta, c);
+
+    if (a.IsEmpty() || b.IsEmpty())
+        return;
+
+    if (numBatches == 0 || a.GetNumCols() % numBatches != 0 || b.GetNumCols() % numBatches != 0)
+        InvalidArgument("CPUMatrix<ElemType>::BatchedMultiplyAndWeightedAdd : The number of columns of a (= %lu) and b (= %lu) must be multiples of numBatches (= %lu).",
+                        a.GetNumCols(), b.GetNumCols(), numBatches);
+
+    int m, n, k, l;
+    int lda, ldb, ldc;
+    CBLAS_TRANSPOSE mklTransA;
+    CBLAS_TRANSPOSE mklTransB;
+
+    size_t aColsPerBatch = a.GetNumCols() / numBatches;
+    size_t bColsPerBatch = b.GetNumCols() / numBatches;
+
+    if (transposeA)
+    {
+        m = (int) aColsPerBatch;
+        k = (int) a.GetNumRows();
+        lda = k;
+        mklTransA = CBLAS_TRANSPOSE::CblasTrans;
+    }
+    else
+    {
+        m = (int) a.GetNumRows();
+        k = (int) aColsPerBatch;
+        lda = m;
+        mklTransA = CBLAS_TRANSPOSE::CblasNoTrans;
+    }
+
+    if (transposeB)
+    {
+        l = (int) bColsPerBatch;
+        n = (int) b.GetNumRows();
+        ldb = n;
+        mklTransB = CBLAS_TRANSPOSE::CblasTrans;
+    }
+    else
+    {
+        l = (int) b.GetNumRows();
+        n = (int) bColsPerBatch;
+        ldb = l;
+        mklTransB = CBLAS_TRANSPOSE::CblasNoTrans;
+    }
+
+    assert(m > 0 && k > 0 && l > 0 && n > 0); // converting from size_t to int may cause overflow
+    assert(k == l);
+    if (k != l)
+        InvalidArgument("CPUMatrix<ElemType>::BatchedMultiplyAndWeightedAdd : The inner dimensions of a and b must match.");
+
+    if (beta == 0)
+        c.RequireSize(m, n * numBatches);
+    else
+        c.VerifySize(m, n * numBatches); // Can't resize if beta != 0
+
+    ldc = (int) c.GetNumRows();
+
+    size_t strideA = a.GetNumRows() * aColsPerBatch;
+    size_t strideB = b.GetNumRows() * bColsPerBatch;
+    size_t strideC = (size_t) ldc * n;
+
+#ifdef USE_MKL
+    // One group of numBatches identical GEMMs; MKL parallelizes across (and within) the batch.
+    std::vector<const ElemType*> aArray(numBatches), bArray(numBatches);
+    std::vector<ElemType*> cArray(numBatches);
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        aArray[i] = a.Data() + i * strideA;
+        bArray[i] = b.Data() + i * strideB;
+        cArray[i] = c.Data() + i * strideC;
+    }
+    // use MKL_INT copies of the sizes so this also builds with ILP64 MKL
+    MKL_INT groupSize = (MKL_INT) numBatches;
+    MKL_INT mklM = m, mklN = n, mklK = k, mklLda = lda, mklLdb = ldb, mklLdc = ldc;
+    if (sizeof(ElemType) == sizeof(double))
+    {
+        double alphaD = (double) alpha, betaD = (double) beta;
+        cblas_dgemm_batch((CBLAS_ORDER) (int) MatrixOrder::ColMajor, &mklTransA, &mklTransB, &mklM, &mklN, &mklK, &alphaD,
+                          reinterpret_cast<const double**>(aArray.data()), &mklLda,
+                          reinterpret_cast<const double**>(bArray.data()), &mklLdb, &betaD,
+                          reinterpret_cast<double**>(cArray.data()), &mklLdc, 1, &groupSize);
+    }
+    else
+    {
+        float alphaF = (float) alpha, betaF = (float) beta;
+        cblas_sgemm_batch((CBLAS_ORDER) (int) MatrixOrder::ColMajor, &mklTransA, &mklTransB, &mklM, &mklN, &mklK, &alphaF,
+                          reinterpret_cast<const float**>(aArray.data()), &mklLda,
+                          reinterpret_cast<const float**>(bArray.data()), &mklLdb, &betaF,
+                          reinterpret_cast<float**>(cArray.data()), &mklLdc, 1, &groupSize);
+    }
+#else
+    // No batch API available: the batches are independent, so spread them across threads.
+#pragma omp parallel for
+    for (long long i = 0; i < (long long) numBatches; i++)
+    {
+        if (sizeof(ElemType) == sizeof(double))
+        {
+            cblas_dgemm((CBLAS_ORDER) (int) MatrixOrder::ColMajor, mklTransA, mklTransB, m, n, k, alpha, reinterpret_cast<double*>(a.Data() + i * strideA), lda, reinterpret_cast<double*>(b.Data() + i * strideB), ldb, beta, reinterpret_cast<double*>(c.Data() + i * strideC), ldc);
+        }
+        else
+        {
+#pragma warning(suppress : 4244)
+            cblas_sgemm((CBLAS_ORDER) (int) MatrixOrder::ColMajor, mklTransA, mklTransB, m, n, k, alpha, reinterpret_cast<float*>(a.Data() + i * strideA), lda, reinterpret_cast<float*>(b.Data() + i * strideB), ldb, beta, reinterpret_cast<float*>(c.Data() + i * strideC), ldc);
+        }
+    }
+#endif
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::Multiply1x1AndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& a, const CPUMatrix<ElemType>& b,
                                                     ElemType beta, CPUMatrix<ElemType>& c)
@@ -5822,12 +6335,29 @@ void CPUMatrix<ElemType>::RCRFBackwardCompute(const CPUMatrix<ElemType>& alpha,
 
     beta.RequireSize(iNumLab, iNumPos);
 
+    // The per-timestep log-normalizers logZ[j] = logadd_m(alpha(m, t) + pair_scores(j, m)) do not
+    // depend on k, so hoisting them out of the per-k kernel takes the recursion from O(T L^3) down
+    // to O(T L^2).
+    std::vector<ElemType> logZ(iNumLab);
     for (int t = iNumPos - 1; t >= 0; t--)
     {
+        if (t < iNumPos - 1)
+        {
+#pragma omp parallel for
+            for (int j = 0; j < iNumLab; j++)
+            {
+                ElemType fSum = (ElemType) LZERO;
+                for (int m = 0; m < iNumLab; m++)
+                {
+                    fSum = (ElemType) LogAddD(fSum, alpha(m, t) + pair_scores(j, m));
+                }
+                logZ[j] = fSum;
+            }
+        }
 #pragma omp parallel for
         for (int k = 0; k < iNumLab; k++)
         {
-            _rcrfBackwardCompute(t, k, alpha, beta, pair_scores);
+            _rcrfBackwardCompute(t, k, alpha, beta, pair_scores, logZ.data());
         }
     }
 };
@@ -5836,7 +6366,8 @@ void CPUMatrix<ElemType>::RCRFBackwardCompute(const CPUMatrix<ElemType>& alpha,
 template <class ElemType>
 void CPUMatrix<ElemType>::_rcrfBackwardCompute(size_t t, size_t k, const CPUMatrix<ElemType>& alpha,
                                                CPUMatrix<ElemType>& beta,
-                                               const CPUMatrix<ElemType>& pair_scores)
+                                               const CPUMatrix<ElemType>& pair_scores,
+                                               const ElemType* logZ)
 {
     size_t iNumLab = alpha.GetNumRows();
     size_t iNumPos = alpha.GetNumCols();
@@ -5858,13 +6389,7 @@ void CPUMatrix<ElemType>::_rcrfBackwardCompute(size_t t, size_t k, const CPUMatr
     {
         for (int j = 0; j < iNumLab; j++)
         {
-            fSum = (ElemType) LZERO;
-            for (int m = 0; m < iNumLab; m++)
-            {
-                fSum = (ElemType) LogAddD(fSum, alpha(m, t) + pair_scores(j, m));
-            }
-
-            fTmp = (ElemType) LogAddD(fTmp, beta(j, t + 1) + alpha(k, t) + pair_scores(j, k) - fSum);
+            fTmp = (ElemType) LogAddD(fTmp, beta(j, t + 1) + alpha(k, t) + pair_scores(j, k) - logZ[j]);
         }
         beta(k, t) = fTmp;
     }
@@ -5888,6 +6413,10 @@ void CPUMatrix<ElemType>::RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
             break;
         }
 
+    // The log-normalizers logZ[j] = logadd_k(alpha(k, tPos-1) + pair_scores(j, k)) do not depend
+    // on i, so they are computed once per position instead of once per (i, position), taking the
+    // gradient from O(T L^3) down to O(T L^2).
+    std::vector<ElemType> logZ(iNumLab);
     for (size_t tPos = 0; tPos < iNumPos; tPos++)
     {
         CPUMatrix<ElemType> b = beta.ColumnSlice(tPos, 1);
@@ -5895,10 +6424,26 @@ void CPUMatrix<ElemType>::RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
         if (tPos > 0)
             a = alpha.ColumnSlice(tPos - 1, 1);
 
+#pragma omp parallel for
+        for (int j = 0; j < iNumLab; j++)
+        {
+            ElemType fSum = (ElemType) LZERO;
+            for (int k = 0; k < iNumLab; k++)
+            {
+                ElemType fTmp2;
+                if (tPos == 0)
+                    fTmp2 = (k == firstLbl) ? (ElemType) 0.0 : (ElemType) LZERO;
+                else
+                    fTmp2 = a(k, 0);
+                fSum = (ElemType) LogAddD(fSum, fTmp2 + pair_scores(j, k));
+            }
+            logZ[j] = fSum;
+        }
+
 #pragma omp parallel for
         for (int i = 0; i < iNumLab; i++)
         {
-            _rcrfTransGrdCompute(i, lbls, alpha, beta, pair_scores, grd, tPos);
+            _rcrfTransGrdCompute(i, lbls, alpha, beta, pair_scores, grd, tPos, logZ.data());
         }
 
         // transition score
@@ -5936,7 +6481,8 @@ void CPUMatrix<ElemType>::_rcrfTransGrdCompute(size_t i,
                                                const CPUMatrix<ElemType>& beta,
                                                const CPUMatrix<ElemType>& pair_scores,
                                                CPUMatrix<ElemType>& grd,
-                                               const size_t tPos // position
+                                               const size_t tPos, // position
+                                               const ElemType* logZ
                                                )
 {
     int iNumLab = (int) alpha.GetNumRows();
@@ -5975,29 +6521,7 @@ void CPUMatrix<ElemType>::_rcrfTransGrdCompute(size_t i,
             }
             fTmp += pair_scores(j, i);
 
-            ElemType fSum = (ElemType) LZERO;
-            for (int k = 0; k < iNumLab; k++)
-            {
-                ElemType fTmp2;
-                if (tPos == 0)
-                {
-                    if (k == firstLbl)
-                    {
-                        fTmp2 = 0;
-                    }
-                    else
-                    {
-                        fTmp2 = (ElemType) LZERO;
-                    }
-                }
-                else
-                {
-                    fTmp2 = a(k, 0);
-                }
-                fSum = (ElemType) LogAddD(fSum, fTmp2 + pair_scores(j, k));
-            }
-
-            fTmp -= fSum;
+            fTmp -= logZ[j];
             fTmp += b(j, 0);
 
             grd(j, i) += exp(fTmp);
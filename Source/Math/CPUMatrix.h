@@ -9,6 +9,7 @@
 #include "Helpers.h"
 #include "CommonMatrix.h"
 #include "CPURNGHandle.h"
+#include "Float16.h"
 #include <vector>
 #include <stdio.h>
 #include <ctime>
@@ -28,6 +29,29 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
 double logadd(double x, double y);
 
+// Placement policy for CPU matrix buffers on NUMA machines.
+// 'None' keeps the historical behavior: a value-initializing new[], which touches every
+// page on the allocating thread and therefore places the whole buffer on that thread's node.
+// 'FirstTouch' zeroes the buffer on the OpenMP team instead, with the same contiguous static
+// partition that the elementwise loops use, so each node ends up owning the part of the matrix
+// its cores will mostly work on. 'Interleaved' round-robins pages across the team, spreading
+// memory bandwidth for buffers with no single-thread affinity (e.g. shared parameter matrices).
+enum class CPUMatrixNumaPolicy
+{
+    None,
+    FirstTouch,
+    Interleaved,
+};
+
+// Process-wide policy for newly allocated CPU matrix buffers (default: None).
+MATH_API void SetCPUMatrixNumaAllocationPolicy(CPUMatrixNumaPolicy policy);
+MATH_API CPUMatrixNumaPolicy GetCPUMatrixNumaAllocationPolicy();
+
+// Per-matrix selection: overrides the global policy for allocations made while the override
+// is in effect (same usage pattern as msra::numa::overridenode — set it, construct/resize the
+// matrix, then reset). Pass None to clear.
+MATH_API void OverrideCPUMatrixNumaAllocationPolicy(CPUMatrixNumaPolicy policy);
+
 // To comply with BLAS libraries matrices are stored in ColMajor. However, by default C/C++/C# use RowMajor
 // conversion is need when passing data between CPUMatrix and C++ matrices
 template <class ElemType>
@@ -108,10 +132,12 @@ public:
     // RequireSize is now the new preferred method of ensuring the correct size inside of the Matrix class. Since Resize will fail if the storage object has
     // multiple views, RequireSize will first check to see if Resize is required. If it is not, then it short-circuits and is a noop. Otherwise, RequireSize
     // will call Resize, which may fail if the matrix has multiple views.
-    void RequireSize(const size_t numRows, const size_t numCols, bool growOnly = true); // by default we only reallocate if need to grow
+    void RequireSize(const size_t numRows, const size_t numCols, bool growOnly = true, bool cachedResize = false); // by default we only reallocate if need to grow
     // Resize first checks to ensure that the caller has the authority to call Resize (i.e., it checks to ensure the underlying data is owned by only this matrix), and then
     // actually resizes the underlying matrix, doing any allocation as required.
-    void Resize(const size_t numRows, const size_t numCols, bool growOnly = true); // by default we only reallocate if need to grow
+    // With cachedResize, allocation and release go through the BufferManagement pool instead of the heap, so that
+    // per-minibatch resizes (e.g. for variable-length sequences) reuse previously freed buffers instead of churning malloc.
+    void Resize(const size_t numRows, const size_t numCols, bool growOnly = true, bool cachedResize = false); // by default we only reallocate if need to grow
 
 
     ElemType* CopyToArray() const;                                                 // allocated by the callee but need to be deleted by the caller
@@ -137,6 +163,10 @@ public:
     //void SetValue(const CPUSparseMatrix<ElemType>& deepCopyFrom);
     //void SetValue(const GPUSparseMatrix<ElemType>& deepCopyFrom);
     void SetValue(const size_t numRows, const size_t numCols, ElemType* pArray, size_t matrixFlags = matrixFlagNormal);
+    // half-precision storage interop: widen a float16 backing store into this matrix / narrow this matrix into one.
+    // Lets large read-mostly buffers (e.g. embedding tables) be kept at half the footprint while compute stays in ElemType.
+    void SetValueFromFloat16(const size_t numRows, const size_t numCols, const float16* pArray);
+    void CopyToFloat16Array(float16* pArray) const; // pArray must hold GetNumElements() entries
 
     void MaskColumnsValue(const CPUMatrix<char>& columnsMask, ElemType val);
 
@@ -386,6 +416,12 @@ public:
     void BatchNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale, double blendFactor, const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
                                     CPUMatrix<ElemType>& scaleGrad, CPUMatrix<ElemType>& biasGrad) const;
 
+    void LayerNormalizationForward(const CPUMatrix<ElemType>& scale, const CPUMatrix<ElemType>& bias, CPUMatrix<ElemType>& out, double epsilon,
+                                   CPUMatrix<ElemType>& saveMean, CPUMatrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale,
+                                    const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
+                                    CPUMatrix<ElemType>& scaleGrad, CPUMatrix<ElemType>& biasGrad) const;
+
 public:
     // This functions do not depend on <ElemType>, i.e. you can call them on any <ElemType>
     static int SetNumThreads(int numThreads);
@@ -397,6 +433,7 @@ public:
     static void SVD(const CPUMatrix<ElemType>& A, CPUMatrix<ElemType>& SIGMA, CPUMatrix<ElemType>& U, CPUMatrix<ElemType>& VT, CPUMatrix<ElemType>& W);
 
     static void MultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& a, const bool transposeA, const CPUMatrix<ElemType>& b, const bool transposeB, ElemType beta, CPUMatrix<ElemType>& c, shared_ptr<QuantizedMultiplier<ElemType>> pQuantizedMultiplier=nullptr);
+    static void BatchedMultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& a, const bool transposeA, const CPUMatrix<ElemType>& b, const bool transposeB, ElemType beta, CPUMatrix<ElemType>& c, const size_t numBatches);
     static void MultiplyAndAdd(const CPUMatrix<ElemType>& a, const bool transposeA, const CPUMatrix<ElemType>& b, const bool transposeB, CPUMatrix<ElemType>& c);
     static void Multiply(const CPUMatrix<ElemType>& a, const bool transposeA, const CPUMatrix<ElemType>& b, const bool transposeB, CPUMatrix<ElemType>& c);
     static void Multiply(const CPUMatrix<ElemType>& a, const CPUMatrix<ElemType>& b, CPUMatrix<ElemType>& c);
@@ -466,8 +503,7 @@ public:
         int format;
         stream >> matrixName >> format >> numRows >> numCols;
         ElemType* d_array = new ElemType[numRows * numCols];
-        for (size_t i = 0; i < numRows * numCols; ++i)
-            stream >> d_array[i];
+        stream.GetArray(d_array, numRows * numCols);
         stream.GetMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
         us.SetValue(numRows, numCols, d_array, matrixFlagNormal);
 
@@ -484,8 +520,7 @@ public:
         stream << s << format;
 
         stream << us.m_numRows << us.m_numCols;
-        for (size_t i = 0; i < us.GetNumElements(); ++i)
-            stream << us.Buffer()[i];
+        stream.PutArray(us.Buffer(), us.GetNumElements());
         stream.PutMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
         return stream;
     }
@@ -500,7 +535,8 @@ public:
                                     const CPUMatrix<ElemType>& pair_scores);
     static void _rcrfBackwardCompute(size_t t, size_t k, const CPUMatrix<ElemType>& alpha,
                                      CPUMatrix<ElemType>& beta,
-                                     const CPUMatrix<ElemType>& pair_scores);
+                                     const CPUMatrix<ElemType>& pair_scores,
+                                     const ElemType* logZ /*[j] precomputed logadd_m(alpha(m, t) + pair_scores(j, m))*/);
 
     static void RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
                                     const CPUMatrix<ElemType>& alpha,
@@ -514,7 +550,8 @@ public:
                                      const CPUMatrix<ElemType>& beta,
                                      const CPUMatrix<ElemType>& pair_scores,
                                      CPUMatrix<ElemType>& grd,
-                                     const size_t tPos // position
+                                     const size_t tPos, // position
+                                     const ElemType* logZ /*[j] precomputed logadd_k(alpha(k, tPos-1) + pair_scores(j, k))*/
                                      );
 
 protected:
@@ -11,7 +11,7 @@
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 CPURNGHandle::CPURNGHandle(int deviceId, uint64_t seed, uint64_t offset)
-    : RNGHandle(deviceId)
+    : RNGHandle(deviceId), m_seed(seed), m_counter(offset)
 {
     m_generator.reset(new std::mt19937_64(seed));
     m_generator->discard(offset);
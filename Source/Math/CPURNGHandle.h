@@ -13,6 +13,46 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// Counter-based Philox4x32-10 generator (Salmon et al., "Parallel random numbers: as easy as
+// 1, 2, 3", SC'11). The four 32-bit output lanes are a pure function of a 128-bit counter and a
+// 64-bit key, so any position of the random stream can be generated independently, in any order,
+// on any thread -- the values depend only on (key, counter), never on how a loop over positions
+// is partitioned. The round is branch-free straight-line integer code that the compiler can
+// vectorize across adjacent counter values.
+struct Philox4x32
+{
+    // generate the block of four values at position (counterHi, counterLo) of stream 'key'
+    static void Generate(uint64_t key, uint64_t counterHi, uint64_t counterLo, uint32_t (&result)[4])
+    {
+        uint32_t c0 = (uint32_t) counterLo, c1 = (uint32_t)(counterLo >> 32);
+        uint32_t c2 = (uint32_t) counterHi, c3 = (uint32_t)(counterHi >> 32);
+        uint32_t k0 = (uint32_t) key, k1 = (uint32_t)(key >> 32);
+        for (int round = 0; round < 10; round++)
+        {
+            uint64_t p0 = 0xD2511F53ull * c0;
+            uint64_t p1 = 0xCD9E8D57ull * c2;
+            uint32_t t1 = c1;
+            uint32_t t3 = c3;
+            c0 = (uint32_t)(p1 >> 32) ^ t1 ^ k0;
+            c1 = (uint32_t) p1;
+            c2 = (uint32_t)(p0 >> 32) ^ t3 ^ k1;
+            c3 = (uint32_t) p0;
+            k0 += 0x9E3779B9u; // Weyl-sequence key schedule
+            k1 += 0xBB67AE85u;
+        }
+        result[0] = c0;
+        result[1] = c1;
+        result[2] = c2;
+        result[3] = c3;
+    }
+
+    // map one 32-bit lane to a uniform value in [0, 1)
+    static double ToUniform(uint32_t r)
+    {
+        return r * (1.0 / 4294967296.0);
+    }
+};
+
 class CPURNGHandle : public RNGHandle
 {
 public:
@@ -23,9 +63,27 @@ public:
         return *m_generator;
     }
 
+    uint64_t Seed() const
+    {
+        return m_seed;
+    }
+
+    // Counter-based consumption: returns the stream position of the first of 'count' values about
+    // to be generated and advances past them. This mirrors what drawing 'count' values does to the
+    // sequential generator, so both stay aligned with the node-level rng offset (DropoutNode
+    // advances its offset by GetNumElements() per minibatch and re-creates the handle from it).
+    uint64_t ConsumeCounter(size_t count)
+    {
+        uint64_t position = m_counter;
+        m_counter += count;
+        return position;
+    }
+
 private:
     std::unique_ptr<std::mt19937_64> m_generator;
     // TODO: why is this a ptr?
+    uint64_t m_seed;
+    uint64_t m_counter; // stream position for counter-based generation; starts at 'offset'
 };
 
 }}}
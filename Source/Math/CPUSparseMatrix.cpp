@@ -645,21 +645,42 @@ void CPUSparseMatrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYP
     memcpy(NzValues(), h_Val, sizeof(ElemType)*nz);
 }
 
-#if 0 // add it back with test
 template <class ElemType>
 void CPUSparseMatrix<ElemType>::SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols)
 {
     if (!OwnBuffer())
         LogicError("Cannot modify since the buffer is managed externally.");
 
+    if (numBlocks > 0 && (blockIds == nullptr || val == nullptr))
+        LogicError("SetMatrixFromSBCFormat: nullptr passed in.");
+
     SetFormat(matrixFormatSparseBlockCol);
-    Resize(numRows, numCols, numBlocks * numRows);
+    RequireSizeAndAllocate(numRows, numCols, numBlocks * numRows, true, false);
     SetBlockSize(numBlocks);
+    SetBlockIdShift(0);
 
-    memcpy(GetBlockIds(), blockIds, sizeof(size_t)*(numBlocks));
-    memcpy(Data(), val, sizeof(ElemType)*numBlocks*numRows);
+    if (numBlocks == 0)
+        return;
+
+    memcpy(GetBlockIds(), blockIds, sizeof(size_t) * numBlocks);
+    memcpy(Data(), val, sizeof(ElemType) * numBlocks * numRows);
+}
+
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::GetMatrixFromSBCFormat(std::vector<size_t>& blockIds, std::vector<ElemType>& val) const
+{
+    if (GetFormat() != matrixFormatSparseBlockCol)
+        NOT_IMPLEMENTED;
+
+    size_t numBlocks = GetBlockSize();
+    size_t numRows = GetNumRows();
+    blockIds.resize(numBlocks);
+    val.resize(numBlocks * numRows);
+
+    for (size_t j = 0; j < numBlocks; j++)
+        blockIds[j] = GetBlockIds()[j] - GetBlockIdShift();
+    memcpy(val.data(), Data(), sizeof(ElemType) * numBlocks * numRows);
 }
-#endif
 
 template <class ElemType>
 ElemType* CPUSparseMatrix<ElemType>::Data()  const
@@ -868,6 +889,59 @@ public:
         // * checked that the matrices are compatible in size
         // * Initialized the output matrix c
 
+        // Fast path for the non-transposed cases, which cover the hot products (e.g. dense embedding
+        // times sparse one-hot input, and its counterpart). Instead of addressing every element through
+        // operator() we walk raw column-major buffers, so the inner loops run over contiguous memory and
+        // auto-vectorize; the outer loop partitions independent output columns across OpenMP threads.
+        if (!transposeA && !transposeB)
+        {
+            const CPUSPARSE_INDEX_TYPE* colCSC = sparse.SecondaryIndexLocation();
+            const ElemType* values = sparse.Buffer() + colCSC[0];
+            const CPUSPARSE_INDEX_TYPE* rowIndex = sparse.MajorIndexLocation();
+            ElemType* cBuffer = c.Data();
+            const ElemType* denseBuffer = dense.Data();
+            size_t denseRows = dense.GetNumRows();
+            size_t cRows = c.GetNumRows();
+
+            if (denseTimesSparse)
+            {
+                // c(:, colSparse) += alpha * sparseVal * dense(:, rowSparse) -- both contiguous columns.
+                // Distinct sparse columns update distinct columns of c, so they can run in parallel.
+#pragma omp parallel for
+                for (long colSparse = 0; colSparse < (long) sparse.GetNumCols(); colSparse++)
+                {
+                    ElemType* cCol = cBuffer + colSparse * cRows;
+                    size_t nzEnd = colCSC[colSparse + 1] - colCSC[0];
+                    for (size_t nz = colCSC[colSparse] - colCSC[0]; nz < nzEnd; nz++)
+                    {
+                        const ElemType* denseCol = denseBuffer + rowIndex[nz] * denseRows;
+                        ElemType scaledSparseVal = alpha * values[nz];
+                        for (size_t i = 0; i < outerDimensionDense; i++)
+                            cCol[i] += scaledSparseVal * denseCol[i];
+                    }
+                }
+            }
+            else /* sparse times dense */
+            {
+                // c(rowSparse, colDense) += alpha * sparseVal * dense(colSparse, colDense).
+                // Partition over the columns of the dense matrix; each produces one column of c.
+#pragma omp parallel for
+                for (long colDense = 0; colDense < (long) outerDimensionDense; colDense++)
+                {
+                    ElemType* cCol = cBuffer + colDense * cRows;
+                    const ElemType* denseCol = denseBuffer + colDense * denseRows;
+                    for (size_t colSparse = 0; colSparse < sparse.GetNumCols(); colSparse++)
+                    {
+                        ElemType scaledDenseVal = alpha * denseCol[colSparse];
+                        size_t nzEnd = colCSC[colSparse + 1] - colCSC[0];
+                        for (size_t nz = colCSC[colSparse] - colCSC[0]; nz < nzEnd; nz++)
+                            cCol[rowIndex[nz]] += scaledDenseVal * values[nz];
+                    }
+                }
+            }
+            return;
+        }
+
         // Now do the actual multiplication.
         ElemType* valueBuffer = sparse.Buffer() + *sparse.SecondaryIndexLocation(); // Points to the value buffer of the current view (i.e. buffer containing values of non-zero elements).
         int* rowIndexBuffer = sparse.MajorIndexLocation();                          // Points to the index buffer of the current view (i.e. buffer containing indices of non-zero elements).
@@ -1503,18 +1577,9 @@ MATH_API File& operator>>(File& stream, CPUSparseMatrix<ElemType>& us)
         CPUSPARSE_INDEX_TYPE* compressedIndex = us.SecondaryIndexLocation();
 
         // read in the sparse matrix info
-        for (size_t i = 0; i < nz; ++i)
-        {
-            stream >> dataBuffer[i];
-        }
-        for (size_t i = 0; i < nz; ++i)
-        {
-            stream >> unCompressedIndex[i];
-        }
-        for (size_t i = 0; i < compressedSize; ++i)
-        {
-            stream >> compressedIndex[i];
-        }
+        stream.GetArray(dataBuffer, nz);
+        stream.GetArray(unCompressedIndex, nz);
+        stream.GetArray(compressedIndex, compressedSize);
     }
     stream.GetMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
 
@@ -1546,18 +1611,9 @@ MATH_API File& operator<<(File& stream, const CPUSparseMatrix<ElemType>& us)
         CPUSPARSE_INDEX_TYPE* unCompressedIndex = us.MajorIndexLocation();
         CPUSPARSE_INDEX_TYPE* compressedIndex = us.SecondaryIndexLocation();
 
-        for (size_t i = 0; i < nz; ++i)
-        {
-            stream << dataBuffer[i];
-        }
-        for (size_t i = 0; i < nz; ++i)
-        {
-            stream << unCompressedIndex[i];
-        }
-        for (size_t i = 0; i < compressedSize; ++i)
-        {
-            stream << compressedIndex[i];
-        }
+        stream.PutArray(dataBuffer, nz);
+        stream.PutArray(unCompressedIndex, nz);
+        stream.PutArray(compressedIndex, compressedSize);
     }
     stream.PutMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
 
@@ -123,6 +123,14 @@ public:
                 *resibj = val - uval;
             }
         }
+        else if (valQ.NBits() == 4) // tuned packing for the sub-byte widths used in gradient exchange
+        {
+            bitBuf = QuantizeOneQWordFixed<4>(inMat, inResidual, M, rowStart, rowEnd, rowStride, colIdx, outResidual);
+        }
+        else if (valQ.NBits() == 2)
+        {
+            bitBuf = QuantizeOneQWordFixed<2>(inMat, inResidual, M, rowStart, rowEnd, rowStride, colIdx, outResidual);
+        }
         else
         {
             // number of bits in a QWord
@@ -144,6 +152,37 @@ public:
         return bitBuf;
     }
 
+    // fixed-width packing loop for the small multi-bit widths (2 and 4 bits): the compile-time
+    // width gives a constant trip count (16 or 8 values per 32-bit QWord), which the compiler
+    // fully unrolls with the bit cursor kept in registers, and the per-value width dispatch
+    // inside ValueQuantizer::Quantize() is hoisted out via QuantizeLinear(). Quantization math
+    // and residual-carry semantics are identical to the generic path above. (Explicit SIMD
+    // intrinsics do not fit here: this code also compiles as CUDA device code.)
+    template <size_t N>
+    cudacode QWord QuantizeOneQWordFixed(
+        const ElemType* inMat, const ElemType* inResidual,
+        long M,
+        size_t rowStart, size_t rowEnd, size_t rowStride,
+        size_t colIdx,
+        ElemType* outResidual) const
+    {
+        QWord bitBuf = 0;
+        size_t i = rowStart;
+        for (size_t k = 0; (k < QWordNumBits) && (i < rowEnd); k += N, i += rowStride)
+        {
+            // quantize
+            size_t ij = ColMIDX(i, colIdx, M);
+            ElemType val = inMat[ij] + inResidual[ij];
+            QWordVal qval = valQ.QuantizeLinear(val);
+
+            // compute residual
+            ElemType uval = valQ.UnquantizeLinear(qval);
+            outResidual[ij] = val - uval;
+            bitBuf = bitBuf | (qval << k);
+        }
+        return bitBuf;
+    }
+
     // unquantize one QWord of a quantized matrix column
     cudacode void UnquantizeOneQWord(
         ElemType* us, long M,
@@ -177,6 +216,14 @@ public:
                 *usibj = val;
             }
         }
+        else if (valQ.NBits() == 4) // tuned unpacking, mirroring QuantizeOneQWordFixed()
+        {
+            UnquantizeOneQWordFixed<4>(us, M, rowStart, rowEnd, rowStride, colIdx, bitBuf, add);
+        }
+        else if (valQ.NBits() == 2)
+        {
+            UnquantizeOneQWordFixed<2>(us, M, rowStart, rowEnd, rowStride, colIdx, bitBuf, add);
+        }
         else
         {
             // (rangeend MUST be a power of two; ensured by constructing off ldNbits)
@@ -200,6 +247,32 @@ public:
         }
     }
 
+    // fixed-width unpacking loop for 2- and 4-bit quantization (see QuantizeOneQWordFixed())
+    template <size_t N>
+    cudacode void UnquantizeOneQWordFixed(
+        ElemType* us, long M,
+        size_t rowStart, size_t rowEnd, size_t rowStride,
+        size_t colIdx, QWord bitBuf, bool add) const
+    {
+        const QWordVal bitmask = (((QWordVal) 1) << N) - 1;
+        size_t i = rowStart;
+        for (size_t k = 0; (k < QWordNumBits) && (i < rowEnd); k += N, i += rowStride)
+        {
+            // get value
+            const QWordVal qval = (bitBuf >> k) & bitmask; // % 2^N
+
+            // unquantize
+            ElemType val = valQ.UnquantizeLinear(qval);
+            size_t ij = ColMIDX(i, colIdx, M);
+            if (add)
+            {
+                val += us[ij];
+            }
+
+            us[ij] = val;
+        }
+    }
+
     // determine quantization range of one column
     // This code is written so that it can run in parallel threads on CUDA for collated memory access;
     // set 'subsets' to >1 and pass cross-thread reducer functions for 'float' and 'size_t' (which would reduce through using CUDA __shared__ memory).
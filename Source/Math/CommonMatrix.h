@@ -100,6 +100,9 @@ enum ElementWiseOperator
     opElementwiseProductWithCosDerivative, opElementwiseProductWithSinDerivative,
     opElementwiseProductWithAbsDerivative, opElementwiseProductWithSqrtDerivative,
     opElementwiseProductWithReciprocalDerivative, opSqrOfDifference,
+    // fused binary ops: activation applied to the sum, so that e.g. bias-add + nonlinearity
+    // makes a single pass over memory instead of two (these loops are memory-bound)
+    opSigmoidOfSum, opTanhOfSum, opLinearRectifierOfSum,
     // binary ops for indexing
     // opIndex,
     // ternary
@@ -162,6 +165,9 @@ enum ElementWiseOperator
     Macro(ElementwiseProductWithReciprocalDerivative);                \
     Macro(ElementwiseProductWithSqrtDerivative);                      \
     Macro(SqrOfDifference);                                           \
+    Macro(SigmoidOfSum);                                              \
+    Macro(TanhOfSum);                                                 \
+    Macro(LinearRectifierOfSum);                                      \
     //Macro(Index);
 
 #define ForAllTernaryOps(Macro)                         \
@@ -259,11 +265,28 @@ public:
         return *(instance->second);
     }
 
+    // round a requested size up to its size class: the next power of two, starting at a small floor
+    // (sub-page requests all share one class; rounding those has no fragmentation benefit)
+    static size_t RoundUpToSizeClass(size_t size)
+    {
+        const size_t minSizeClass = 256;
+        size_t sizeClass = minSizeClass;
+        while (sizeClass < size)
+            sizeClass <<= 1;
+        return sizeClass;
+    }
+
     // for requesting, find in buffer container first, if failed, allocate a new one
     // if allocating from buffer, the size will be modified to the real buffer size
     template<class ElemType>
     ElemType* RequestBuffer(size_t& size)
     {
+        // Bucket the request into its power-of-two size class. Freed buffers then land in a small
+        // number of classes and get picked up again by requests of any nearby size; with exact sizes,
+        // variable sequence lengths leave the pool full of slightly-off buffers that never match and
+        // the device fragments long before real capacity is reached.
+        size = RoundUpToSizeClass(size);
+
         ElemType* bufferPtr = nullptr;
         auto& bufferContainer = BufferContainer<ElemType>();
 
@@ -337,15 +360,34 @@ public:
     {
         auto& bufferContainer = BufferContainer<ElemType>();
 
-        for (auto& iter : bufferContainer) 
+        for (auto& iter : bufferContainer)
         {
+            m_totalAllocSize -= iter.first;
+            m_totalManageSize -= iter.first; // only this type's share; other types may still have cached buffers
             PhysicalReleaseBuffer<ElemType>(iter.second);
         }
 
         bufferContainer.clear();
-        m_totalManageSize = 0;
     }
 
+    // Physically release every cached buffer of every element type on this device, handing the memory
+    // back to the underlying allocator so it can coalesce free space. Meant to be called at a quiet
+    // point (e.g. between epochs); the pool simply refills afterwards.
+    void Defragment()
+    {
+        PhysicalReleaseAllBuffer<float>();
+        PhysicalReleaseAllBuffer<double>();
+        PhysicalReleaseAllBuffer<char>();
+        PhysicalReleaseAllBuffer<short>();
+        PhysicalReleaseAllBuffer<int>();
+    }
+
+    // monitoring counters (element counts, summed across element types):
+    // total size sitting unused in the pool's free lists
+    size_t TotalManagedSize() const { return m_totalManageSize; }
+    // total size held by pool allocations that were not yet physically released (live + cached)
+    size_t TotalAllocatedSize() const { return m_totalAllocSize; }
+
 private:
     static std::unordered_map<DEVICEID_TYPE, std::unique_ptr<BufferManagement>> m_instances;
 
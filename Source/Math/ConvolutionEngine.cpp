@@ -565,6 +565,34 @@ public:
     {
     }
 
+    // Upper bound on the im2col workspace, taken over the forward, backward data and backward
+    // kernel passes. Mirrors the workspace.Resize calls in the 3 core methods below; keep them
+    // in sync.
+    size_t WorkspaceSize(size_t batchSize) const override
+    {
+        size_t subBatchSize = m_maxTempMemSizeInSamples == 0 ? batchSize : min(batchSize, m_maxTempMemSizeInSamples);
+        if (subBatchSize == 0)
+            return 0;
+
+        const auto& inT = m_geometry->InputShape();
+        const auto& kernT = m_geometry->KernelShape();
+        const auto& outT = m_geometry->OutputShape();
+
+        size_t dimCount = inT.GetRank();
+        size_t mapOutCount = m_geometry->GetMapCount(dimCount - 1);
+        size_t mapOutSize = outT.GetNumElements() / mapOutCount;
+        size_t mapInCount = kernT[dimCount - 1];
+        size_t mapInSize = inT.GetNumElements() / mapInCount;
+        size_t kernSize = kernT.GetNumElements();
+        size_t kernElems = kernSize * mapOutCount;
+
+        // ForwardCore and BackwardKernelCore use the same workspace shape (transposed).
+        size_t fwdSize = mapOutSize * subBatchSize * (kernSize + (subBatchSize > 1 ? mapOutCount : 0));
+        // BackwardDataCore additionally keeps the transposed kernel weights.
+        size_t bwdDataSize = kernElems + mapInSize * subBatchSize * (kernElems / mapInCount + (subBatchSize > 1 ? mapInCount : 0));
+        return max(fwdSize, bwdDataSize);
+    }
+
 protected:
     using typename Base::IntMatPtr;
 
@@ -848,6 +876,428 @@ public:
     }
 };
 
+//------------------------------------------------------------------
+// Winograd convolution engine implementation.
+// Implements the F(2x2,3x3) minimal filtering algorithm
+// (Fast Algorithms for Convolutional Neural Networks; Lavin, Gray)
+// for 2D 3x3 stride-1 convolutions on the CPU. Each 2x2 output tile
+// takes 16 multiplies in the transform domain instead of 36, and the
+// per-tile products over all channels/maps are batched into 16 GEMM
+// calls so the math library does the heavy lifting.
+// Uses the GEMM engine for backprop and the reference engine for pooling.
+//------------------------------------------------------------------
+template <class ElemType>
+class WinogradConvolutionEngine : public GemmConvolutionEngine<ElemType>
+{
+public:
+    using Base = GemmConvolutionEngine<ElemType>;
+    using typename Base::Mat;
+
+public:
+    WinogradConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind)
+        : Base(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind)
+    {
+    }
+
+protected:
+    using Base::IsGpu;
+
+    using Base::m_geometry;
+    using Base::m_deviceId;
+    using Base::m_imageLayout;
+    using Base::m_maxTempMemSizeInSamples;
+
+    void EnsureCompatible() override
+    {
+        Base::EnsureCompatible();
+        if (!IsSupported(m_deviceId, m_geometry))
+            LogicError("Winograd convolution engine supports only 2D 3x3 stride-1 convolutions with full sharing on the CPU.");
+    }
+
+    // The forward method consists of 4 parts (notation as in the GEMM engine above,
+    // with P as the total number of 4x4 input/2x2 output tiles in the sub-batch):
+    // 1. Kernel transform: U = G g G^T per (map, channel): [XYC x K] -> 16 matrices of [K x C].
+    // 2. Input transform: V = B^T d B per (channel, tile): [WHC x N] -> 16 matrices of [C x P].
+    // 3. 16 GEMMs, one per transform-domain position: [K x C] * [C x P] -> [K x P].
+    // 4. Output transform: Y = A^T M A per (map, tile), scattered to [W'H'K x N].
+    // The kernel transform is cheap (16*K*C flops) and is redone each call so that
+    // kernel updates during training are picked up without an invalidation protocol.
+    void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& workspace) override
+    {
+        size_t batchSize = in.GetNumCols();
+        size_t subBatchSize = m_maxTempMemSizeInSamples == 0 ? batchSize : min(batchSize, m_maxTempMemSizeInSamples);
+
+        const auto& inT = m_geometry->InputShape();
+        const auto& outT = m_geometry->OutputShape();
+        size_t inW = inT[0], inH = inT[1], inC = inT[2];
+        size_t outW = outT[0], outH = outT[1];
+        size_t mapCount = m_geometry->GetMapCount(inT.GetRank() - 1);
+        int padW = m_geometry->GetLowerPad(0);
+        int padH = m_geometry->GetLowerPad(1);
+
+        size_t tilesW = (outW + 1) / 2;
+        size_t tilesH = (outH + 1) / 2;
+        size_t tilesPerImage = tilesW * tilesH;
+        size_t tileCount = tilesPerImage * subBatchSize;
+
+        // Reserve space for the 16 kernel transform blocks [K x C], input transform
+        // blocks [C x P] and transform-domain product blocks [K x P].
+        size_t uSize = mapCount * inC;
+        size_t vSize = inC * tileCount;
+        size_t mSize = mapCount * tileCount;
+        workspace.Resize(1, 16 * (uSize + vSize + mSize));
+
+        // 1. Kernel transform. kernel is [XYC x K] (cudnn layout uses row-major weights),
+        // so g(y, x) of map k, channel c is at x + 3*y + 9*c + 9*C*k.
+        // G = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1]
+        const ElemType* kernData = kernel.Data();
+        ElemType* uData = workspace.Data();
+#pragma omp parallel for
+        for (long kc = 0; kc < (long) (mapCount * inC); kc++)
+        {
+            size_t k = kc / inC;
+            size_t c = kc % inC;
+            const ElemType* g = kernData + 9 * (c + inC * k);
+            ElemType Gg[4][3];
+            for (int b = 0; b < 3; b++)
+            {
+                ElemType g0 = g[b], g1 = g[3 + b], g2 = g[6 + b];
+                Gg[0][b] = g0;
+                Gg[1][b] = (g0 + g1 + g2) / 2;
+                Gg[2][b] = (g0 - g1 + g2) / 2;
+                Gg[3][b] = g2;
+            }
+            for (int i = 0; i < 4; i++)
+            {
+                ElemType t0 = Gg[i][0], t1 = Gg[i][1], t2 = Gg[i][2];
+                ElemType* u = uData + k + mapCount * c;
+                u[(i * 4 + 0) * uSize] = t0;
+                u[(i * 4 + 1) * uSize] = (t0 + t1 + t2) / 2;
+                u[(i * 4 + 2) * uSize] = (t0 - t1 + t2) / 2;
+                u[(i * 4 + 3) * uSize] = t2;
+            }
+        }
+
+        for (size_t start = 0; start < batchSize; start += subBatchSize)
+        {
+            size_t curBatchSize = min(subBatchSize, batchSize - start);
+            size_t curTileCount = tilesPerImage * curBatchSize;
+            auto inputSlice = in.ColumnSlice(start, curBatchSize);
+            auto outSlice = out.ColumnSlice(start, curBatchSize);
+
+            // 2. Input transform. B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1]
+            const ElemType* inData = inputSlice.Data();
+            ElemType* vData = workspace.Data() + 16 * uSize;
+#pragma omp parallel for
+            for (long p = 0; p < (long) curTileCount; p++)
+            {
+                size_t n = p / tilesPerImage;
+                size_t t = p % tilesPerImage;
+                size_t ty = t / tilesW;
+                size_t tx = t % tilesW;
+                ptrdiff_t iy0 = (ptrdiff_t)(2 * ty) - padH;
+                ptrdiff_t ix0 = (ptrdiff_t)(2 * tx) - padW;
+                const ElemType* sample = inData + n * (inW * inH * inC);
+                for (size_t c = 0; c < inC; c++)
+                {
+                    const ElemType* channel = sample + inW * inH * c;
+                    ElemType d[4][4];
+                    for (int a = 0; a < 4; a++)
+                    {
+                        ptrdiff_t iy = iy0 + a;
+                        for (int b = 0; b < 4; b++)
+                        {
+                            ptrdiff_t ix = ix0 + b;
+                            d[a][b] = (iy >= 0 && iy < (ptrdiff_t) inH && ix >= 0 && ix < (ptrdiff_t) inW)
+                                          ? channel[ix + inW * iy]
+                                          : 0;
+                        }
+                    }
+                    ElemType Bd[4][4];
+                    for (int b = 0; b < 4; b++)
+                    {
+                        Bd[0][b] = d[0][b] - d[2][b];
+                        Bd[1][b] = d[1][b] + d[2][b];
+                        Bd[2][b] = d[2][b] - d[1][b];
+                        Bd[3][b] = d[1][b] - d[3][b];
+                    }
+                    ElemType* v = vData + c + inC * p;
+                    for (int i = 0; i < 4; i++)
+                    {
+                        v[(i * 4 + 0) * vSize] = Bd[i][0] - Bd[i][2];
+                        v[(i * 4 + 1) * vSize] = Bd[i][1] + Bd[i][2];
+                        v[(i * 4 + 2) * vSize] = Bd[i][2] - Bd[i][1];
+                        v[(i * 4 + 3) * vSize] = Bd[i][1] - Bd[i][3];
+                    }
+                }
+            }
+
+            // 3. Batched element products: one GEMM per transform-domain position.
+            for (size_t xi = 0; xi < 16; xi++)
+            {
+                auto uSlice = workspace.ColumnSlice(xi * uSize, uSize);
+                uSlice.Reshape(mapCount, inC);
+                auto vSlice = workspace.ColumnSlice(16 * uSize + xi * vSize, inC * curTileCount);
+                vSlice.Reshape(inC, curTileCount);
+                auto mSlice = workspace.ColumnSlice(16 * (uSize + vSize) + xi * mSize, mapCount * curTileCount);
+                mSlice.Reshape(mapCount, curTileCount);
+                Mat::Multiply(uSlice, false, vSlice, false, mSlice);
+            }
+
+            // 4. Output transform and scatter. A^T = [1 1 1 0; 0 1 -1 -1]
+            const ElemType* mData = workspace.Data() + 16 * (uSize + vSize);
+            ElemType* outData = outSlice.Data();
+#pragma omp parallel for
+            for (long p = 0; p < (long) curTileCount; p++)
+            {
+                size_t n = p / tilesPerImage;
+                size_t t = p % tilesPerImage;
+                size_t ty = t / tilesW;
+                size_t tx = t % tilesW;
+                ElemType* outSample = outData + n * (outW * outH * mapCount);
+                for (size_t k = 0; k < mapCount; k++)
+                {
+                    const ElemType* m = mData + k + mapCount * p;
+                    ElemType Am[2][4];
+                    for (int j = 0; j < 4; j++)
+                    {
+                        ElemType m0 = m[(0 * 4 + j) * mSize];
+                        ElemType m1 = m[(1 * 4 + j) * mSize];
+                        ElemType m2 = m[(2 * 4 + j) * mSize];
+                        ElemType m3 = m[(3 * 4 + j) * mSize];
+                        Am[0][j] = m0 + m1 + m2;
+                        Am[1][j] = m1 - m2 - m3;
+                    }
+                    for (int r = 0; r < 2; r++)
+                    {
+                        size_t oy = 2 * ty + r;
+                        if (oy >= outH)
+                            break;
+                        ElemType y0 = Am[r][0] + Am[r][1] + Am[r][2];
+                        ElemType y1 = Am[r][1] - Am[r][2] - Am[r][3];
+                        ElemType* outRow = outSample + outW * oy + outW * outH * k;
+                        outRow[2 * tx] = y0;
+                        if (2 * tx + 1 < outW)
+                            outRow[2 * tx + 1] = y1;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    static bool IsSupported(DEVICEID_TYPE deviceId, ConvolveGeometryPtr geometry)
+    {
+        if (!GemmConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
+            return false;
+        const auto& inT = geometry->InputShape();
+        const auto& kernT = geometry->KernelShape();
+        // 2D 3x3 kernel spanning all input channels, stride 1 in both spatial dimensions.
+        return inT.GetRank() == 3 && kernT.GetRank() == 3 &&
+               kernT[0] == 3 && kernT[1] == 3 && kernT[2] == inT[2] &&
+               geometry->GetStride(0) == 1 && geometry->GetStride(1) == 1;
+    }
+};
+
+//------------------------------------------------------------------
+// Direct convolution engine with compile-time unrolled microkernels.
+// Kernel extent and stride are template parameters, so the innermost
+// loops have constant bounds that the compiler fully unrolls and
+// vectorizes, and a block of four output columns is accumulated in
+// registers per kernel weight load. This avoids both the per-element
+// geometry indirection tables of the reference engine and the unroll
+// buffer traffic of the GEMM engine. Exact (no transform domain), so
+// it is part of the default engine set, tried before the GEMM engine.
+// Uses the GEMM engine for backprop and the reference engine for pooling.
+//------------------------------------------------------------------
+template <class ElemType, size_t kernW, size_t kernH, size_t strideW, size_t strideH>
+class DirectConvolutionEngine : public GemmConvolutionEngine<ElemType>
+{
+public:
+    using Base = GemmConvolutionEngine<ElemType>;
+    using typename Base::Mat;
+
+public:
+    DirectConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind)
+        : Base(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind)
+    {
+    }
+
+protected:
+    using Base::IsGpu;
+
+    using Base::m_geometry;
+    using Base::m_deviceId;
+    using Base::m_imageLayout;
+
+    void EnsureCompatible() override
+    {
+        Base::EnsureCompatible();
+        if (!IsSupported(m_deviceId, m_geometry))
+            LogicError("Direct convolution engine supports only 2D %dx%d stride-%dx%d convolutions with full sharing on the CPU.",
+                       (int)kernW, (int)kernH, (int)strideW, (int)strideH);
+    }
+
+    // Direct convolution over the CHW/cudnn layout: in is [WHC x N], kernel is [XYC x K]
+    // (row-major weights), out is [W'H'K x N]. Parallelized over (sample, output map) pairs.
+    // Within one output row, the columns whose kernel window lies fully inside the image take
+    // an unchecked path that accumulates a block of 4 output values in registers per weight;
+    // the remaining border columns take a bounds-checked path.
+    void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& /*workspace*/) override
+    {
+        size_t batchSize = in.GetNumCols();
+
+        const auto& inT = m_geometry->InputShape();
+        const auto& outT = m_geometry->OutputShape();
+        size_t inW = inT[0], inH = inT[1], inC = inT[2];
+        size_t outW = outT[0], outH = outT[1];
+        size_t mapCount = m_geometry->GetMapCount(inT.GetRank() - 1);
+        int padW = m_geometry->GetLowerPad(0);
+        int padH = m_geometry->GetLowerPad(1);
+
+        // output columns [oxSafeFirst, oxSafeEnd) whose kernel window is horizontally inside the image
+        ptrdiff_t safeFirst = padW > 0 ? (padW + (ptrdiff_t)strideW - 1) / (ptrdiff_t)strideW : 0;
+        ptrdiff_t safeLast = ((ptrdiff_t)inW - (ptrdiff_t)kernW + padW) / (ptrdiff_t)strideW; // last safe column; negative numerator = none
+        size_t oxSafeFirst = (size_t)min((ptrdiff_t)outW, safeFirst);
+        size_t oxSafeEnd = ((ptrdiff_t)inW - (ptrdiff_t)kernW + padW) >= 0 ? max(oxSafeFirst, min(outW, (size_t)safeLast + 1)) : oxSafeFirst;
+
+        const ElemType* inData = in.Data();
+        const ElemType* kernData = kernel.Data();
+        ElemType* outData = out.Data();
+#pragma omp parallel for
+        for (long nk = 0; nk < (long)(batchSize * mapCount); nk++)
+        {
+            size_t n = nk / mapCount;
+            size_t k = nk % mapCount;
+            const ElemType* sample = inData + n * (inW * inH * inC);
+            const ElemType* kern = kernData + kernW * kernH * inC * k;
+            ElemType* outPlane = outData + n * (outW * outH * mapCount) + outW * outH * k;
+
+            for (size_t oy = 0; oy < outH; oy++)
+            {
+                ptrdiff_t iy0 = (ptrdiff_t)(oy * strideH) - padH;
+                ElemType* outRow = outPlane + outW * oy;
+
+                // bounds-checked accumulation for border columns
+                auto computeChecked = [&](size_t ox)
+                {
+                    ptrdiff_t ix0 = (ptrdiff_t)(ox * strideW) - padW;
+                    ElemType acc = 0;
+                    for (size_t c = 0; c < inC; c++)
+                    {
+                        const ElemType* channel = sample + inW * inH * c;
+                        const ElemType* kc = kern + kernW * kernH * c;
+                        for (size_t ky = 0; ky < kernH; ky++)
+                        {
+                            ptrdiff_t iy = iy0 + (ptrdiff_t)ky;
+                            if (iy < 0 || iy >= (ptrdiff_t)inH)
+                                continue;
+                            const ElemType* row = channel + inW * iy;
+                            const ElemType* krow = kc + kernW * ky;
+                            for (size_t kx = 0; kx < kernW; kx++)
+                            {
+                                ptrdiff_t ix = ix0 + (ptrdiff_t)kx;
+                                if (ix >= 0 && ix < (ptrdiff_t)inW)
+                                    acc += krow[kx] * row[ix];
+                            }
+                        }
+                    }
+                    outRow[ox] = acc;
+                };
+
+                for (size_t ox = 0; ox < oxSafeFirst; ox++)
+                    computeChecked(ox);
+
+                size_t ox = oxSafeFirst;
+                for (; ox + 4 <= oxSafeEnd; ox += 4)
+                {
+                    ElemType acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+                    ptrdiff_t ix0 = (ptrdiff_t)(ox * strideW) - padW;
+                    for (size_t c = 0; c < inC; c++)
+                    {
+                        const ElemType* channel = sample + inW * inH * c;
+                        const ElemType* kc = kern + kernW * kernH * c;
+                        for (size_t ky = 0; ky < kernH; ky++)
+                        {
+                            ptrdiff_t iy = iy0 + (ptrdiff_t)ky;
+                            if (iy < 0 || iy >= (ptrdiff_t)inH)
+                                continue;
+                            const ElemType* row = channel + inW * iy + ix0;
+                            const ElemType* krow = kc + kernW * ky;
+                            for (size_t kx = 0; kx < kernW; kx++) // constant bounds; fully unrolled
+                            {
+                                ElemType w = krow[kx];
+                                acc0 += w * row[kx];
+                                acc1 += w * row[kx + strideW];
+                                acc2 += w * row[kx + 2 * strideW];
+                                acc3 += w * row[kx + 3 * strideW];
+                            }
+                        }
+                    }
+                    outRow[ox] = acc0;
+                    outRow[ox + 1] = acc1;
+                    outRow[ox + 2] = acc2;
+                    outRow[ox + 3] = acc3;
+                }
+                for (; ox < oxSafeEnd; ox++)
+                {
+                    ElemType acc = 0;
+                    ptrdiff_t ix0 = (ptrdiff_t)(ox * strideW) - padW;
+                    for (size_t c = 0; c < inC; c++)
+                    {
+                        const ElemType* channel = sample + inW * inH * c;
+                        const ElemType* kc = kern + kernW * kernH * c;
+                        for (size_t ky = 0; ky < kernH; ky++)
+                        {
+                            ptrdiff_t iy = iy0 + (ptrdiff_t)ky;
+                            if (iy < 0 || iy >= (ptrdiff_t)inH)
+                                continue;
+                            const ElemType* row = channel + inW * iy + ix0;
+                            const ElemType* krow = kc + kernW * ky;
+                            for (size_t kx = 0; kx < kernW; kx++)
+                                acc += krow[kx] * row[kx];
+                        }
+                    }
+                    outRow[ox] = acc;
+                }
+
+                for (ox = max(ox, oxSafeEnd); ox < outW; ox++)
+                    computeChecked(ox);
+            }
+        }
+    }
+
+public:
+    static bool IsSupported(DEVICEID_TYPE deviceId, ConvolveGeometryPtr geometry)
+    {
+        if (!GemmConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
+            return false;
+        const auto& inT = geometry->InputShape();
+        const auto& kernT = geometry->KernelShape();
+        // 2D kernel of the fixed extent spanning all input channels, with the fixed strides.
+        return inT.GetRank() == 3 && kernT.GetRank() == 3 &&
+               kernT[0] == kernW && kernT[1] == kernH && kernT[2] == inT[2] &&
+               geometry->GetStride(0) == strideW && geometry->GetStride(1) == strideH;
+    }
+};
+
+// Tries the fixed-shape direct engine specializations in order and returns the first one that
+// supports the geometry, nullptr if none does. Extend the list to cover new fixed shapes.
+template <class ElemType>
+static std::unique_ptr<ConvolutionEngine<ElemType>> TryCreateDirectConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId,
+                                                                                     ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind)
+{
+    if (DirectConvolutionEngine<ElemType, 3, 3, 1, 1>::IsSupported(deviceId, geometry))
+        return std::make_unique<DirectConvolutionEngine<ElemType, 3, 3, 1, 1>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+    if (DirectConvolutionEngine<ElemType, 3, 3, 2, 2>::IsSupported(deviceId, geometry))
+        return std::make_unique<DirectConvolutionEngine<ElemType, 3, 3, 2, 2>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+    if (DirectConvolutionEngine<ElemType, 5, 5, 1, 1>::IsSupported(deviceId, geometry))
+        return std::make_unique<DirectConvolutionEngine<ElemType, 5, 5, 1, 1>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+    if (DirectConvolutionEngine<ElemType, 5, 5, 2, 2>::IsSupported(deviceId, geometry))
+        return std::make_unique<DirectConvolutionEngine<ElemType, 5, 5, 2, 2>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+    return nullptr;
+}
+
 template <class ElemType>
 std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId,
                                                                                  ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind,
@@ -883,6 +1333,26 @@ std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create
         return CuDnnConvolutionEngineFactory<ElemType>::Create(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, forceDeterministicAlgorithms);
     }
 
+    if (isEnabled(ConvolutionEngineKind::Winograd) && WinogradConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
+    {
+        if (GetMathLibTraceLevel() > 0)
+            fprintf(stderr, "%lsusing Winograd convolution engine for geometry: %s.\n", logPrefix.c_str(), engStr.c_str());
+
+        return std::make_unique<WinogradConvolutionEngine<ElemType>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+    }
+
+    if (isEnabled(ConvolutionEngineKind::Direct))
+    {
+        auto directEngine = TryCreateDirectConvolutionEngine<ElemType>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind);
+        if (directEngine != nullptr)
+        {
+            if (GetMathLibTraceLevel() > 0)
+                fprintf(stderr, "%lsusing direct convolution engine for geometry: %s.\n", logPrefix.c_str(), engStr.c_str());
+
+            return directEngine;
+        }
+    }
+
     if (isEnabled(ConvolutionEngineKind::Gemm) && GemmConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
     {
         if (GetMathLibTraceLevel() > 0)
@@ -22,8 +22,10 @@ enum class ConvolutionEngineKind
     CuDnn     = 1 << 1, // cuDNN, works only for 2D/3D convos with full sharing.
     Legacy    = 1 << 2, // Legacy, for backwards compatibility. REVIEW alexeyk: implement sparse version and remove Legacy altogether.
     Gemm      = 1 << 3, // Uses convolution unrolling+GEMM technique. Works only for convos with full sharing.
+    Winograd  = 1 << 4, // Winograd F(2x2,3x3) fast convolution. CPU only, 3x3 stride-1 convos with full sharing. Opt-in (not part of All).
+    Direct    = 1 << 5, // Direct convolution with compile-time unrolled microkernels. CPU only, fixed kernel/stride shapes (3x3/5x5) with full sharing.
 
-    All       = Reference | CuDnn | Legacy | Gemm
+    All       = Reference | CuDnn | Legacy | Gemm | Direct
 };
 
 enum class PoolKind
@@ -74,6 +76,12 @@ public:
 
     virtual bool ImplementsGradientOverwriteOptimization() const { return false; }
 
+    // Upper bound, in elements, on the workspace this engine will ever request for a minibatch
+    // of batchSize samples; 0 if the engine needs no workspace or cannot bound it. The bound
+    // only depends on the geometry, so callers can plan a right-sized persistent workspace up
+    // front instead of growing it call by call.
+    virtual size_t WorkspaceSize(size_t /*batchSize*/) const { return 0; }
+
 protected:
     ConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind)
         : m_geometry(geometry), m_deviceId(deviceId), m_imageLayout(imageLayout), m_maxTempMemSizeInSamples(maxTempMemSizeInSamples), m_poolKind(poolKind)
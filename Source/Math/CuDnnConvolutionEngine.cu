@@ -8,6 +8,11 @@
 #include "GPUMatrix.h"
 #include <typeinfo>
 #include <typeindex>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include "CuDnnCommon.h"
 
 template <>
@@ -164,6 +169,87 @@ private:
     cudnnPoolingDescriptor_t m_pool;
 };
 
+// Persistent cache of cuDNN auto-tuner results. Entries are keyed by convolution geometry,
+// GPU model, cuDNN version, element type, operation and batch size, so restarts and elastic
+// rescheduling skip cudnnFind* entirely for configurations tuned by an earlier run.
+// The cache is backed by the file named in the CNTK_CONVOLUTION_ALGO_CACHE environment
+// variable: it is read once per process and appended to as new configurations are tuned.
+// Appends are line-atomic so concurrent workers may share one file on a common filesystem;
+// when the variable is not set the cache is disabled and behavior is unchanged.
+class CuDnnAlgoCache
+{
+public:
+    static CuDnnAlgoCache& Instance()
+    {
+        static CuDnnAlgoCache instance;
+        return instance;
+    }
+
+    bool Lookup(const std::string& key, int& algo, size_t& memory, int& noWorkspaceAlgo)
+    {
+        if (!m_enabled)
+            return false;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto iter = m_cache.find(key);
+        if (iter == m_cache.end())
+            return false;
+        algo = iter->second.Algo;
+        memory = iter->second.Memory;
+        noWorkspaceAlgo = iter->second.NoWorkspaceAlgo;
+        return true;
+    }
+
+    void Insert(const std::string& key, int algo, size_t memory, int noWorkspaceAlgo)
+    {
+        if (!m_enabled)
+            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cache.find(key) != m_cache.end())
+            return;
+        m_cache[key] = Entry{algo, memory, noWorkspaceAlgo};
+        std::ofstream file(m_path, std::ios::app);
+        if (file)
+            file << key << '\t' << algo << ' ' << memory << ' ' << noWorkspaceAlgo << '\n';
+        // Failure to persist is not fatal - the in-memory cache still avoids re-tuning in this process.
+    }
+
+    DISABLE_COPY_AND_MOVE(CuDnnAlgoCache);
+
+private:
+    struct Entry
+    {
+        int Algo;
+        size_t Memory;
+        int NoWorkspaceAlgo;
+    };
+
+    CuDnnAlgoCache()
+    {
+        const char* path = std::getenv("CNTK_CONVOLUTION_ALGO_CACHE");
+        m_enabled = (path != nullptr && *path != '\0');
+        if (!m_enabled)
+            return;
+        m_path = path;
+        std::ifstream file(m_path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            auto tab = line.find('\t');
+            if (tab == std::string::npos)
+                continue;
+            Entry entry;
+            std::istringstream values(line.substr(tab + 1));
+            if (values >> entry.Algo >> entry.Memory >> entry.NoWorkspaceAlgo)
+                m_cache[line.substr(0, tab)] = entry;
+        }
+    }
+
+    std::mutex m_mutex;
+    std::map<std::string, Entry> m_cache;
+    std::string m_path;
+    bool m_enabled;
+};
+
 template <class ElemType>
 class CuDnnConvolutionEngine : public ConvolutionEngine<ElemType>
 {
@@ -231,7 +317,7 @@ protected:
         {
             return cudnnGetConvolutionForwardAlgorithm(*m_cudnn, m_inT, *m_kernelT, *m_conv, m_outT, CUDNN_CONVOLUTION_FWD_NO_WORKSPACE, 0, &algo);
         };
-        FindBestAlgo(batchSize, m_fwdAlgo, finder, staticFinder);
+        FindBestAlgo(batchSize, m_fwdAlgo, finder, staticFinder, "fwd");
         if (m_fwdAlgo.Algo.memory > 0)
             workspace.Resize((m_fwdAlgo.Algo.memory + sizeof(ElemType) - 1) / sizeof(ElemType), 1);
         // Perform forward convolution operation.
@@ -279,7 +365,7 @@ protected:
         {
             return cudnnGetConvolutionBackwardDataAlgorithm(*m_cudnn, *m_kernelT, m_outT, *m_conv, m_inT, CUDNN_CONVOLUTION_BWD_DATA_NO_WORKSPACE, 0, &algo);
         };
-        FindBestAlgo(batchSize, m_backDataAlgo, finder, staticFinder);
+        FindBestAlgo(batchSize, m_backDataAlgo, finder, staticFinder, "bwdData");
         if (m_backDataAlgo.Algo.memory > 0)
             workspace.Resize((m_backDataAlgo.Algo.memory + sizeof(ElemType) - 1) / sizeof(ElemType), 1);
         // Compute gradients with respect to the output tensor (data).
@@ -310,7 +396,7 @@ protected:
         {
             return cudnnGetConvolutionBackwardFilterAlgorithm(*m_cudnn, m_inT, m_outT, *m_conv, *m_kernelT, CUDNN_CONVOLUTION_BWD_FILTER_NO_WORKSPACE, 0, &algo);
         };
-        FindBestAlgo(batchSize, m_backFiltAlgo, finder, staticFinder);
+        FindBestAlgo(batchSize, m_backFiltAlgo, finder, staticFinder, "bwdFilter");
         if (m_backFiltAlgo.Algo.memory > 0)
             workspace.Resize((m_backFiltAlgo.Algo.memory + sizeof(ElemType) - 1) / sizeof(ElemType), 1);
         // Compute gradients with respect to the output tensor (data).
@@ -356,8 +442,26 @@ private:
 
     static const int MaxAlgoCount = 10;
 
+    // Builds the persistent auto-tuner cache key. Everything the algorithm choice depends on
+    // must be part of it: the convolution geometry, the GPU model, the cuDNN version, the
+    // element type, the workspace limit, determinism and the operation/batch size being tuned.
+    std::string AlgoCacheKey(const char* op, size_t batchSize) const
+    {
+        cudaDeviceProp props = {0};
+        if ((cudaGetDeviceProperties(&props, m_deviceId) | cudaGetLastError()) != cudaSuccess)
+            props.name[0] = '\0';
+        std::ostringstream key;
+        key << props.name << "; cudnn " << cudnnGetVersion()
+            << "; elemSize " << sizeof(ElemType)
+            << "; maxTempMemSamples " << m_maxTempMemSizeInSamples
+            << "; deterministic " << (m_forceDeterministicAlgorithms ? 1 : 0)
+            << "; op " << op << "; batch " << batchSize
+            << "; " << (std::string)(*m_geometry);
+        return key.str();
+    }
+
     template <typename TAlgo, typename TFinder, typename TStaticFinder>
-    void FindBestAlgo(size_t batchSize, TAlgo& algo, TFinder finder, TStaticFinder staticFinder)
+    void FindBestAlgo(size_t batchSize, TAlgo& algo, TFinder finder, TStaticFinder staticFinder, const char* op)
     {
         m_inT.UpdateBatchSize(batchSize);
         m_outT.UpdateBatchSize(batchSize);
@@ -366,6 +470,21 @@ private:
             return;
 
         using CuDnnAlgoT = decltype(TAlgo::Algo);
+
+        // Consult the persistent cache first so tuned configurations skip cudnnFind* on restart.
+        std::string cacheKey = AlgoCacheKey(op, batchSize);
+        int cachedAlgo, cachedNoWorkspaceAlgo;
+        size_t cachedMemory;
+        if (CuDnnAlgoCache::Instance().Lookup(cacheKey, cachedAlgo, cachedMemory, cachedNoWorkspaceAlgo))
+        {
+            algo.MaxAllowedMBSizeForCurrentAlgo = batchSize;
+            algo.Algo.algo = (decltype(CuDnnAlgoT::algo)) cachedAlgo;
+            algo.Algo.memory = cachedMemory;
+            algo.Algo.status = CUDNN_STATUS_SUCCESS;
+            algo.NoWorkspaceAlgo = (decltype(CuDnnAlgoT::algo)) cachedNoWorkspaceAlgo;
+            return;
+        }
+
         CuDnnAlgoT algoPerf[MaxAlgoCount];
         int calgo = 0;
         cudnnStatus_t err = finder(calgo, algoPerf);
@@ -401,11 +520,14 @@ private:
         algo.Algo = *res;
 
         if (m_forceDeterministicAlgorithms) // does not allow fallback.
+        {
+            CuDnnAlgoCache::Instance().Insert(cacheKey, (int) algo.Algo.algo, algo.Algo.memory, (int) algo.Algo.algo);
             return;
+        }
 
         // Find fastest algorithm that does NOT require workspace. It is used as a fallback algo in Forward function.
         // Currently all Forward algorithms are deterministic, so no need for checking.
-        res = std::find_if(algoPerf, algoPerf + calgo, 
+        res = std::find_if(algoPerf, algoPerf + calgo,
             [](const CuDnnAlgoT& cur) { return cur.status == CUDNN_STATUS_SUCCESS && cur.memory == 0; });
         if (res == algoPerf + calgo)
         {
@@ -414,6 +536,10 @@ private:
         }
         else
             algo.NoWorkspaceAlgo = (*res).algo;
+
+        // Note: the CUDNN_STATUS_ALLOC_FAILED fallback above is deliberately not cached
+        // since it reflects transient memory pressure, not a property of the configuration.
+        CuDnnAlgoCache::Instance().Insert(cacheKey, (int) algo.Algo.algo, algo.Algo.memory, (int) algo.NoWorkspaceAlgo);
     }
 
     static ElemType* ptr(Mat& src)
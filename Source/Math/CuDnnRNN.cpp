@@ -76,28 +76,38 @@ void CuDnnRNNExecutor<ElemType>::ForwardCore(
     if (m_yDim != (m_rnnT->isBidirectional() ? 2 : 1) * m_rnnT->GetNumHidden())
         InvalidArgument("CuDnn ForwardCore: Output leading dimension must be twice hidden size for bidirectional networks");
 
-    // set up the input and output descriptors
-    SetDescriptors(m_xDim, numSequencesForFrame, xDesc);
-    SetDescriptors(m_yDim, numSequencesForFrame, yDesc);
-
-    // ensure workspace and reserve are large enough
+    // Set up the input and output descriptors: one descriptor per frame, with the frame's packed
+    // batch size in the leading dimension. When the minibatch's length profile is unchanged from
+    // the previous pass (common with length-sorted or bucketed batching), the descriptors, filter
+    // descriptor, and workspace/reserve sizes are all still valid and are reused as is.
+    bool profileChanged = wDesc == nullptr || numSequencesForFrame != m_numSequencesForFrame;
     m_seqLength = numSequencesForFrame.size();
-    size_t workSize;
-    size_t reserveSize;
+    if (profileChanged)
+    {
+        SetDescriptors(m_xDim, numSequencesForFrame, xDesc);
+        SetDescriptors(m_yDim, numSequencesForFrame, yDesc);
+        m_numSequencesForFrame = numSequencesForFrame;
+
+        size_t workSize;
+        size_t reserveSize;
 
-    // Need for every pass
-    CUDNN_CALL(cudnnGetRNNWorkspaceSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &workSize));
-    // Only needed in training, can't be touched between passes.
-    CUDNN_CALL(cudnnGetRNNTrainingReserveSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &reserveSize));
+        // Need for every pass
+        CUDNN_CALL(cudnnGetRNNWorkspaceSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &workSize));
+        // Only needed in training, can't be touched between passes.
+        CUDNN_CALL(cudnnGetRNNTrainingReserveSize(*m_cudnn, *m_rnnT, (int)m_seqLength, xDesc.data(), &reserveSize));
 
-    // convert from bytes to ElemType
-    workSize = (workSize + sizeof(ElemType) - 1) / (sizeof(ElemType));
-    reserveSize = (reserveSize + sizeof(ElemType) - 1) / sizeof(ElemType);
+        // convert from bytes to ElemType
+        m_workSize = (workSize + sizeof(ElemType) - 1) / (sizeof(ElemType));
+        m_reserveSize = (reserveSize + sizeof(ElemType) - 1) / sizeof(ElemType);
+
+        wDesc = make_unique<CuDnnFilter<ElemType>>(*m_rnnT, xDesc[0]);
+    }
 
-    reserve.Resize(reserveSize, 1);
-    workspace.Resize(workSize, 1);
+    // ensure workspace and reserve are large enough (the matrices come from the pool, so their
+    // current size cannot be assumed even when the sizes themselves were cached)
+    reserve.Resize(m_reserveSize, 1);
+    workspace.Resize(m_workSize, 1);
 
-    wDesc = make_unique<CuDnnFilter<ElemType>>(*m_rnnT, xDesc[0]);
     if (wDesc->GetSize() != weightsW.GetNumElements())
         InvalidArgument("RNN needs %ld parameters, but %ld were allocated", wDesc->GetSize(), weightsW.GetNumElements());
 
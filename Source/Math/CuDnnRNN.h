@@ -218,6 +218,13 @@ private:
     std::unique_ptr<CuDnnRNN<ElemType>> m_rnnT;
     bool m_BackwardDataCalledYet;
     size_t m_seqLength;
+
+    // the per-frame batch sizes of the previous minibatch. With variable-length packing these
+    // follow the length profile of the minibatch; when the profile repeats, the tensor and filter
+    // descriptors and the workspace/reserve sizes from the previous pass are reused as is.
+    vector<size_t> m_numSequencesForFrame;
+    size_t m_workSize = 0;    // in ElemType units
+    size_t m_reserveSize = 0; // in ElemType units
 };
 
 } } }
\ No newline at end of file
@@ -50,6 +50,24 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         // Waits on the event that triggers when all copies have been finished.
         virtual void WaitForCopyCPUToGPU() = 0;
 
+        // Asynchronously uploads the cpu buffer in numChunks contiguous slices, recording a completion
+        // event per slice, so compute on the early slices can overlap with the transfer of later ones
+        // (double-buffered H2D upload). The default implementation issues one monolithic copy and records
+        // a single completion; transferers with per-chunk events override it.
+        virtual void CopyCPUToGPUChunkedAsync(const void* cpuBuffer, size_t numElements, size_t elementSize, void* gpuBuffer, size_t /*numChunks*/)
+        {
+            CopyCPUToGPUAsync(cpuBuffer, numElements, elementSize, gpuBuffer);
+            RecordCPUToGPUCopy();
+        }
+
+        // Makes the compute stream wait (asynchronously if possible) until the given slice of the last
+        // chunked upload has landed on the device. The default implementation conservatively waits for
+        // the whole upload.
+        virtual void WaitForUploadChunkOnComputeStreamAsync(size_t /*chunkIndex*/)
+        {
+            WaitForCopyCPUToGPU();
+        }
+
         // Records an event on a compute stream.
         virtual void RecordComputeStreamSyncPoint() = 0;
 
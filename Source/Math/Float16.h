@@ -0,0 +1,118 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// -----------------------------------------------------------------------
+// float16 -- IEEE 754 half-precision storage type
+//
+// This is a storage-only type: it halves the memory footprint of large
+// read-mostly buffers (e.g. embedding tables on eval machines), while all
+// arithmetic stays in single precision. Values are widened to float on
+// access and narrowed (with round-to-nearest-even) on store; there are no
+// half-precision compute kernels.
+// -----------------------------------------------------------------------
+
+struct float16
+{
+    uint16_t bits;
+
+    float16() : bits(0) {}
+    explicit float16(float f) : bits(FromFloat(f)) {}
+
+    operator float() const { return ToFloat(bits); }
+
+    // float -> half bit pattern, round-to-nearest-even, with overflow to
+    // infinity, NaN preservation and gradual underflow to half subnormals
+    static uint16_t FromFloat(float f)
+    {
+        uint32_t x;
+        memcpy(&x, &f, sizeof(x));
+        uint32_t sign = (x >> 16) & 0x8000;
+        x &= 0x7fffffff;
+
+        if (x >= 0x47800000) // too large for half: infinity, or NaN passed through
+            return (uint16_t) (sign | (x > 0x7f800000 ? 0x7e00 : 0x7c00));
+
+        if (x < 0x38800000) // too small for a normal half: subnormal or zero
+        {
+            if (x < 0x33000000) // below half the smallest subnormal: rounds to zero
+                return (uint16_t) sign;
+            uint32_t shift = 125 - (x >> 23);
+            uint32_t mantissa = (x & 0x7fffff) | 0x800000;
+            uint16_t value = (uint16_t) (mantissa >> (shift + 1));
+            uint32_t remainder = mantissa & ((1u << (shift + 1)) - 1);
+            uint32_t halfway = 1u << shift;
+            if (remainder > halfway || (remainder == halfway && (value & 1)))
+                value++;
+            return (uint16_t) (sign | value);
+        }
+
+        // normal case: rebias exponent and round the mantissa
+        uint16_t value = (uint16_t) (((x - 0x38000000) >> 13) & 0x7fff);
+        uint32_t remainder = x & 0x1fff;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (value & 1)))
+            value++;
+        return (uint16_t) (sign | value);
+    }
+
+    // half bit pattern -> float (exact; every half value is representable as float)
+    static float ToFloat(uint16_t h)
+    {
+        uint32_t sign = (uint32_t) (h & 0x8000) << 16;
+        uint32_t exponent = (h >> 10) & 0x1f;
+        uint32_t mantissa = h & 0x3ff;
+        uint32_t x;
+
+        if (exponent == 0)
+        {
+            if (mantissa == 0) // +/- zero
+                x = sign;
+            else // subnormal: normalize it
+            {
+                exponent = 127 - 15 + 1;
+                while ((mantissa & 0x400) == 0)
+                {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                x = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+            }
+        }
+        else if (exponent == 0x1f) // infinity or NaN
+            x = sign | 0x7f800000 | (mantissa << 13);
+        else // normal
+            x = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+
+        float f;
+        memcpy(&f, &x, sizeof(f));
+        return f;
+    }
+};
+
+static_assert(sizeof(float16) == 2, "float16 must be 2 bytes");
+
+// widen a half-precision array into a float or double buffer
+template <class ElemType>
+inline void Float16ToElemTypeArray(const float16* src, ElemType* dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        dst[i] = (ElemType) (float) src[i];
+}
+
+// narrow a float or double buffer into a half-precision array
+template <class ElemType>
+inline void ElemTypeToFloat16Array(const ElemType* src, float16* dst, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        dst[i] = float16((float) src[i]);
+}
+
+}}}
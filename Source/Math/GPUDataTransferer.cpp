@@ -76,6 +76,8 @@ GranularGPUDataTransferer::~GranularGPUDataTransferer()
     cudaEventDestroy(m_assignCompleteEvent);
     cudaEventDestroy(m_fetchCompleteEvent);
     cudaEventDestroy(m_syncEvent);
+    for (auto ev : m_chunkCompleteEvents)
+        cudaEventDestroy(ev);
 }
 
 void GranularGPUDataTransferer::CopyGPUToCPUAsync(const void* gpuBuffer, size_t numElements, size_t elementSize, void* cpuBuffer)
@@ -113,6 +115,51 @@ void GranularGPUDataTransferer::WaitForCopyCPUToGPU()
     cudaEventSynchronize(m_assignCompleteEvent) || "cudaEventSynchronize failed";
 }
 
+void GranularGPUDataTransferer::CopyCPUToGPUChunkedAsync(const void* cpuBuffer, size_t numElements, size_t elementSize, void* gpuBuffer, size_t numChunks)
+{
+    if (numChunks < 2 || numElements < numChunks)
+    {
+        // nothing to overlap: issue the monolithic copy
+        CopyCPUToGPUAsync(cpuBuffer, numElements, elementSize, gpuBuffer);
+        RecordCPUToGPUCopy();
+        return;
+    }
+
+    PrepareDevice(m_deviceId);
+
+    // grow the event pool on demand; events are reused across uploads
+    while (m_chunkCompleteEvents.size() < numChunks)
+    {
+        cudaEvent_t ev = nullptr;
+        cudaEventCreateWithFlags(&ev, cudaEventDisableTiming) || "cudaEventCreateWithFlags failed";
+        m_chunkCompleteEvents.push_back(ev);
+    }
+
+    // split into near-equal contiguous slices; the last chunk takes the remainder
+    size_t chunkElements = numElements / numChunks;
+    for (size_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+        size_t firstElement = chunk * chunkElements;
+        size_t thisChunkElements = (chunk == numChunks - 1) ? numElements - firstElement : chunkElements;
+        const char* src = (const char*) cpuBuffer + firstElement * elementSize;
+        char* dst = (char*) gpuBuffer + firstElement * elementSize;
+        cudaMemcpyAsync(dst, src, thisChunkElements * elementSize, cudaMemcpyHostToDevice, GetAssignStream()) || "cudaMemcpyAsync failed";
+        cudaEventRecord(m_chunkCompleteEvents[chunk], GetAssignStream()) || "cudaEventRecord failed";
+    }
+
+    // the last chunk event doubles as the whole-upload completion, so WaitForCopyCPUToGPU keeps working
+    cudaEventRecord(m_assignCompleteEvent, GetAssignStream()) || "cudaEventRecord failed";
+}
+
+void GranularGPUDataTransferer::WaitForUploadChunkOnComputeStreamAsync(size_t chunkIndex)
+{
+    if (chunkIndex >= m_chunkCompleteEvents.size())
+        LogicError("WaitForUploadChunkOnComputeStreamAsync: chunk index %d out of range.", (int) chunkIndex);
+
+    PrepareDevice(m_deviceId);
+    cudaStreamWaitEvent(GetStream(), m_chunkCompleteEvents[chunkIndex], 0 /*flags 'must be 0'*/) || "cudaStreamWaitEvent failed";
+}
+
 void GranularGPUDataTransferer::RecordComputeStreamSyncPoint()
 {
     PrepareDevice(m_deviceId);
@@ -42,6 +42,9 @@ public:
     void RecordCPUToGPUCopy() override;
     void WaitForCopyCPUToGPU() override;
 
+    void CopyCPUToGPUChunkedAsync(const void* cpuBuffer, size_t numElements, size_t elementSize, void* gpuBuffer, size_t numChunks) override;
+    void WaitForUploadChunkOnComputeStreamAsync(size_t chunkIndex) override;
+
     void RecordComputeStreamSyncPoint() override;
     void WaitForSyncPointOnFetchStreamAsync() override;
     void WaitForSyncPointOnAssignStreamAsync() override;
@@ -67,6 +70,9 @@ protected:
     mutable cudaEvent_t m_fetchCompleteEvent;
     mutable cudaEvent_t m_assignCompleteEvent;
     mutable cudaEvent_t m_syncEvent;
+
+    // per-chunk completion events for chunked uploads, created on demand and reused across minibatches
+    std::vector<cudaEvent_t> m_chunkCompleteEvents;
 #endif // !CPUONLY
 
 protected:
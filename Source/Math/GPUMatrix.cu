@@ -24,6 +24,9 @@
 #include "cublas_v2.h"
 #include <assert.h>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "CntkBatchNormalization.cuh"
 #include "Convolution.cuh"
 #include "CuDnnRNN.h"
@@ -127,6 +130,22 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     s_isSyncEnabled = true;
 }
 
+// One cached event per (thread, device), reused across guards. When sync mode is enabled every
+// kernel launch is guarded, so paying cudaEventCreate/cudaEventDestroy per launch both adds to the
+// overhead being measured and distorts it. The cached events deliberately live until thread exit.
+static cudaEvent_t GetSyncGuardEvent()
+{
+    const int maxDevices = 32;
+    THREAD_LOCAL static cudaEvent_t doneEvents[maxDevices] = {};
+    int device = 0;
+    CUDA_CALL(cudaGetDevice(&device));
+    if (device < 0 || device >= maxDevices)
+        RuntimeError("GetSyncGuardEvent: device id %d out of range.", device);
+    if (doneEvents[device] == nullptr)
+        CUDA_CALL(cudaEventCreate(&doneEvents[device]));
+    return doneEvents[device];
+}
+
 SyncGuard::SyncGuard(bool forceSync /*= false*/)
     : m_forceSync(forceSync)
 {
@@ -134,7 +153,7 @@ SyncGuard::SyncGuard(bool forceSync /*= false*/)
     if (m_forceSync || s_isSyncEnabled)
     {
         CUDA_CALL(cudaGetLastError());
-        CUDA_CALL(cudaEventCreate(&m_done));
+        m_done = GetSyncGuardEvent();
     }
 }
 
@@ -145,19 +164,100 @@ SyncGuard::~SyncGuard()
         // The regular use of this destructor is to synchronize the GPU, but also
         // to check for errors. So this destructor is where CUDA errors would be thrown.
         // If this destructor runs during stack unwinding, then a different error has
-        // already happened that should be reported; so we only clean up the resource.
-        if (std::uncaught_exception())
-            cudaEventDestroy(m_done);
-        else
+        // already happened that should be reported; so we do nothing here (the event
+        // is owned by the per-thread cache, not by this guard).
+        if (!std::uncaught_exception())
         {
             // failures in a prior launch might be reported here
             CUDA_CALL(cudaEventRecord(m_done));
             CUDA_CALL(cudaEventSynchronize(m_done));
-            CUDA_CALL(cudaEventDestroy(m_done));
         }
     }
 }
 
+// -----------------------------------------------------------------------
+// Compute-stream pool used by stream-parallel graph execution.
+// Streams and events are created on first use on the then-current device
+// (CNTK drives one device per process) and deliberately never freed,
+// same as the cublas handles below: CUDA reclaims them at process exit.
+// -----------------------------------------------------------------------
+
+static std::vector<cudaStream_t> s_pooledComputeStreams;
+static std::vector<cudaEvent_t> s_pooledStreamJoinEvents; // one per pool stream, for fork/join
+static cudaEvent_t s_pooledStreamForkEvent = nullptr;
+static std::vector<cudaEvent_t> s_computeStreamEvents; // dependency-edge events, indexed by caller-chosen id
+static std::mutex s_computeStreamPoolMutex;
+
+// grows the pool under the lock; pool streams are non-blocking, so ordering against the
+// default stream comes exclusively from the fork/join events
+static void EnsurePooledComputeStreams(size_t numStreams)
+{
+    std::lock_guard<std::mutex> lock(s_computeStreamPoolMutex);
+    while (s_pooledComputeStreams.size() < numStreams)
+    {
+        cudaStream_t stream;
+        CUDA_CALL(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+        s_pooledComputeStreams.push_back(stream);
+        cudaEvent_t joinEvent;
+        CUDA_CALL(cudaEventCreateWithFlags(&joinEvent, cudaEventDisableTiming));
+        s_pooledStreamJoinEvents.push_back(joinEvent);
+    }
+}
+
+static cudaEvent_t GetComputeStreamEvent(size_t eventId)
+{
+    std::lock_guard<std::mutex> lock(s_computeStreamPoolMutex);
+    while (s_computeStreamEvents.size() <= eventId)
+    {
+        cudaEvent_t event;
+        CUDA_CALL(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+        s_computeStreamEvents.push_back(event);
+    }
+    return s_computeStreamEvents[eventId];
+}
+
+void SetPooledComputeStream(int streamIndex)
+{
+    if (streamIndex < 0)
+    {
+        SetStream(cudaStreamDefault);
+        return;
+    }
+    EnsurePooledComputeStreams((size_t) streamIndex + 1);
+    SetStream(s_pooledComputeStreams[streamIndex]);
+}
+
+void ForkPooledComputeStreams(size_t numStreams)
+{
+    EnsurePooledComputeStreams(numStreams);
+    if (s_pooledStreamForkEvent == nullptr)
+        CUDA_CALL(cudaEventCreateWithFlags(&s_pooledStreamForkEvent, cudaEventDisableTiming));
+    CUDA_CALL(cudaEventRecord(s_pooledStreamForkEvent, GetStream()));
+    for (size_t i = 0; i < numStreams; i++)
+        CUDA_CALL(cudaStreamWaitEvent(s_pooledComputeStreams[i], s_pooledStreamForkEvent, 0));
+}
+
+void JoinPooledComputeStreams()
+{
+    for (size_t i = 0; i < s_pooledComputeStreams.size(); i++)
+    {
+        CUDA_CALL(cudaEventRecord(s_pooledStreamJoinEvents[i], s_pooledComputeStreams[i]));
+        CUDA_CALL(cudaStreamWaitEvent(GetStream(), s_pooledStreamJoinEvents[i], 0));
+    }
+}
+
+void RecordComputeStreamEvent(size_t eventId)
+{
+    CUDA_CALL(cudaEventRecord(GetComputeStreamEvent(eventId), GetStream()));
+}
+
+void WaitForComputeStreamEvent(size_t eventId)
+{
+    // waiting on a never-recorded event completes immediately, which is the behavior we
+    // want when the producer node was skipped because it was already up to date
+    CUDA_CALL(cudaStreamWaitEvent(GetStream(), GetComputeStreamEvent(eventId), 0));
+}
+
 template <typename AllocatedElemType>
 AllocatedElemType* TracingGPUMemoryAllocator::Allocate(int deviceId, size_t numRows, size_t numCols)
 {
@@ -1330,15 +1430,27 @@ void GPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
     GPURNGHandle* gpuRNGHandle = dynamic_cast<GPURNGHandle*>(&rngHandle);
     assert(gpuRNGHandle != nullptr);
 
-    cudaEvent_t done = nullptr;
-    CUDA_CALL(cudaEventCreate(&done)); // TODO: why not condition on do_sync, so that we can use SyncGuard?
-    if (sizeof(ElemType) == sizeof(float))
-        CURAND_CALL(curandGenerateUniform(gpuRNGHandle->Generator(), reinterpret_cast<float*>(Data()), GetNumElements()));
+    // When the batched RNG service is enabled, slice pre-generated uniforms from its ring buffer
+    // instead of launching curand inline; this also avoids the host-side event sync below.
+    void* pregenerated = nullptr;
+    if (GPURNGBatchedService::IsEnabled())
+        pregenerated = GPURNGBatchedService::Instance(GetComputeDeviceId()).ClaimUniform(GetNumElements(), sizeof(ElemType), t_stream);
+    if (pregenerated != nullptr)
+    {
+        CUDA_CALL(cudaMemcpyAsync(Data(), pregenerated, GetNumElements() * sizeof(ElemType), cudaMemcpyDeviceToDevice, t_stream));
+    }
     else
-        CURAND_CALL(curandGenerateUniformDouble(gpuRNGHandle->Generator(), reinterpret_cast<double*>(Data()), GetNumElements()));
-    CUDA_CALL(cudaEventRecord(done));
-    CUDA_CALL(cudaEventSynchronize(done));
-    CUDA_CALL(cudaEventDestroy(done));
+    {
+        cudaEvent_t done = nullptr;
+        CUDA_CALL(cudaEventCreate(&done)); // TODO: why not condition on do_sync, so that we can use SyncGuard?
+        if (sizeof(ElemType) == sizeof(float))
+            CURAND_CALL(curandGenerateUniform(gpuRNGHandle->Generator(), reinterpret_cast<float*>(Data()), GetNumElements()));
+        else
+            CURAND_CALL(curandGenerateUniformDouble(gpuRNGHandle->Generator(), reinterpret_cast<double*>(Data()), GetNumElements()));
+        CUDA_CALL(cudaEventRecord(done));
+        CUDA_CALL(cudaEventSynchronize(done));
+        CUDA_CALL(cudaEventDestroy(done));
+    }
 
     size_t N = GetNumElements();
     size_t blocksPerGrid = (size_t) ceil(N / (double) GridDim::maxThreadsPerBlock);
@@ -1346,6 +1458,52 @@ void GPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
     _setMaskAndScale<ElemType><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, t_stream>>>(Data(), N, maskRate, scaleValue);
 }
 
+template <class ElemType>
+/*static*/ void GPUMatrix<ElemType>::BatchedNormalGrad(const std::vector<GPUMatrix<ElemType>*>& smoothedGradients,
+                                                       const std::vector<GPUMatrix<ElemType>*>& gradients,
+                                                       const std::vector<GPUMatrix<ElemType>*>& functionValues,
+                                                       ElemType learnRatePerSample, ElemType momentum, bool useNesterovMomentum)
+{
+    size_t numTensors = smoothedGradients.size();
+    if ((gradients.size() != numTensors) || (functionValues.size() != numTensors))
+        LogicError("BatchedNormalGrad: the tensor lists must have the same length.");
+
+    if (numTensors == 0)
+        return;
+
+    smoothedGradients[0]->PrepareDevice();
+    SyncGuard syncGuard;
+    for (size_t first = 0; first < numTensors; first += BatchedGradientUpdateChunk<ElemType>::MaxTensors)
+    {
+        BatchedGradientUpdateChunk<ElemType> chunk;
+        int chunkSize = (int) min((size_t) BatchedGradientUpdateChunk<ElemType>::MaxTensors, numTensors - first);
+        CUDA_LONG maxNumElements = 0;
+        for (int i = 0; i < chunkSize; i++)
+        {
+            GPUMatrix<ElemType>& smoothedGradient = *smoothedGradients[first + i];
+            GPUMatrix<ElemType>& gradient = *gradients[first + i];
+            GPUMatrix<ElemType>& functionValue = *functionValues[first + i];
+
+            size_t n = gradient.GetNumElements();
+            if ((smoothedGradient.GetNumElements() != n) || (functionValue.GetNumElements() != n))
+                LogicError("BatchedNormalGrad: tensors within a group must have matching numbers of elements.");
+
+            chunk.smoothedGradients[i] = smoothedGradient.Data();
+            chunk.gradients[i] = gradient.Data();
+            chunk.functionValues[i] = functionValue.Data();
+            chunk.numElements[i] = (CUDA_LONG) n;
+            maxNumElements = max(maxNumElements, (CUDA_LONG) n);
+        }
+
+        if (maxNumElements == 0)
+            continue;
+
+        int blocksPerGrid = (int) ceil(1.0 * maxNumElements / GridDim::maxThreadsPerBlock);
+        _batchedNormalGrad<ElemType><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, t_stream>>>(chunk, chunkSize, maxNumElements,
+                                                                                                  learnRatePerSample, momentum, useNesterovMomentum);
+    }
+}
+
 template <class ElemType>
 ElemType GPUMatrix<ElemType>::Adagrad(GPUMatrix<ElemType>& gradients, const bool needAveMultiplier)
 {
@@ -2282,6 +2440,18 @@ ElemType GPUMatrix<ElemType>::SumOfAbsElements() const
     }
 }
 
+// launch the single-pass cub-based sum reduction; the result is left in device memory at d_sum
+// and no device-to-host synchronization is performed, so callers may keep chaining device work
+template <class ElemType>
+static void LaunchSumReductionSinglePass(const ElemType* data, ElemType* d_sum, CUDA_LONG N, bool takeSqr)
+{
+    const int blockSize = 1024;
+    // cap the block count to limit atomic contention on the single accumulator
+    int blocksPerGrid = (int) min((CUDA_LONG) 128, (N + blockSize - 1) / blockSize);
+    CUDA_CALL(cudaMemsetAsync(d_sum, 0, sizeof(ElemType), t_stream));
+    _reductionSumSinglePass<blockSize, ElemType><<<blocksPerGrid, blockSize, 0, t_stream>>>(data, d_sum, N, takeSqr);
+}
+
 template <class ElemType>
 ElemType GPUMatrix<ElemType>::SumOfElements() const
 {
@@ -2291,9 +2461,7 @@ ElemType GPUMatrix<ElemType>::SumOfElements() const
     ElemType* d_sum = TracingGPUMemoryAllocator::Allocate<ElemType>(GetComputeDeviceId(), 1);
     ElemType h_sum;
 
-    // WARNING: THIS kernel is not the most efficient way!
-    // note: kernel has hard-coded dimension of 1024
-    _reductionSum1024Threads<ElemType> << <1, 1024, 0, t_stream >> >(Data(), d_sum, (CUDA_LONG)GetNumElements());
+    LaunchSumReductionSinglePass(Data(), d_sum, (CUDA_LONG) GetNumElements(), false);
     CUDA_CALL(cudaMemcpy(&h_sum, d_sum, sizeof(ElemType), cudaMemcpyDeviceToHost));
     TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), d_sum);
     return h_sum;
@@ -2322,9 +2490,7 @@ DeviceBoundNumber<ElemType> GPUMatrix<ElemType>::Sum_AsDeviceBoundNum() const
         LogicError("Matrix is empty");
     ElemType* d_sum = TracingGPUMemoryAllocator::Allocate<ElemType>(GetComputeDeviceId(), 1);
 
-    // WARNING: THIS kernel is not the most efficient way!
-    // note: kernel has hard-coded dimension of 1024
-    _reductionSum1024Threads<ElemType> << <1, 1024, 0, t_stream >> >(Data(), d_sum, (CUDA_LONG)GetNumElements());
+    LaunchSumReductionSinglePass(Data(), d_sum, (CUDA_LONG) GetNumElements(), false);
     DeviceBoundNumber<ElemType> result;
     result.ShallowCopyFrom(d_sum, GetComputeDeviceId());
     return result;
@@ -2625,15 +2791,30 @@ ElemType GPUMatrix<ElemType>::FrobeniusNorm() const
     ElemType* d_sum = TracingGPUMemoryAllocator::Allocate<ElemType>(GetComputeDeviceId(), 1);
 
     ElemType h_sum = 0;
-    // WARNING: THIS kernel is not the most efficient way!
-    // note: kernel has hard-coded dimension of 1024
-    _reductionSum21024Threads<ElemType> << <1, 1024, 0, t_stream >> >(Data(), d_sum, (CUDA_LONG)GetNumElements(), true);
+    LaunchSumReductionSinglePass(Data(), d_sum, (CUDA_LONG) GetNumElements(), true);
+    _sqrtScalarInPlace<ElemType><<<1, 1, 0, t_stream>>>(d_sum);
     CUDA_CALL(cudaMemcpy(&h_sum, d_sum, sizeof(ElemType), cudaMemcpyDeviceToHost));
     TracingGPUMemoryAllocator::Free<ElemType>(GetComputeDeviceId(), d_sum);
 
     return (h_sum);
 }
 
+// Frobenius norm with the result left in device memory; lets callers such as gradient
+// clipping consume the value without stalling the pipeline on a device-to-host sync
+template <class ElemType>
+DeviceBoundNumber<ElemType> GPUMatrix<ElemType>::FrobeniusNorm_AsDeviceBoundNum() const
+{
+    if (IsEmpty())
+        LogicError("FrobeniusNorm: Matrix is empty.");
+
+    ElemType* d_sum = TracingGPUMemoryAllocator::Allocate<ElemType>(GetComputeDeviceId(), 1);
+    LaunchSumReductionSinglePass(Data(), d_sum, (CUDA_LONG) GetNumElements(), true);
+    _sqrtScalarInPlace<ElemType><<<1, 1, 0, t_stream>>>(d_sum);
+    DeviceBoundNumber<ElemType> result;
+    result.ShallowCopyFrom(d_sum, GetComputeDeviceId());
+    return result;
+}
+
 template <class ElemType>
 GPUMatrix<ElemType>& GPUMatrix<ElemType>::AssignFrobeniusNormOf(const GPUMatrix<ElemType>& a)
 {
@@ -2643,9 +2824,8 @@ GPUMatrix<ElemType>& GPUMatrix<ElemType>::AssignFrobeniusNormOf(const GPUMatrix<
     RequireSize(1, 1);
 
     PrepareDevice();
-    // WARNING: THIS kernel is not the most efficient way!
-    // note: kernel has hard-coded dimension of 1024
-    _reductionSum21024Threads<ElemType> << <1, 1024, 0, t_stream >> >(a.Data(), Data(), (CUDA_LONG)a.GetNumElements(), true);
+    LaunchSumReductionSinglePass(a.Data(), Data(), (CUDA_LONG) a.GetNumElements(), true);
+    _sqrtScalarInPlace<ElemType><<<1, 1, 0, t_stream>>>(Data());
 
     return *this;
 }
@@ -3308,6 +3488,42 @@ void GPUMatrix<ElemType>::BatchNormalizationBackward(const GPUMatrix<ElemType>&
                                                     in.Data(), Data(), grad.Data(), scale.Data(), mbStatsWeight, scaleGrad.Data(), biasGrad.Data(), savedMean.Data(), savedInvStdDev.Data(), GetStream());
 }
 
+template <class ElemType>
+void GPUMatrix<ElemType>::LayerNormalizationForward(const GPUMatrix<ElemType>& scale, const GPUMatrix<ElemType>& bias, GPUMatrix<ElemType>& out, double epsilon,
+                                                    GPUMatrix<ElemType>& saveMean, GPUMatrix<ElemType>& saveInvStdDev) const
+{
+    assert(GetNumRows() == scale.GetNumRows());
+    assert(GetNumRows() == bias.GetNumRows());
+
+    saveMean.RequireSize(1, GetNumCols());
+    saveInvStdDev.RequireSize(1, GetNumCols());
+
+    PrepareDevice();
+    SyncGuard syncGuard;
+    _layerNormForward512Threads<ElemType><<<(unsigned int) GetNumCols(), 512, 0, t_stream>>>(
+        Data(), scale.Data(), bias.Data(), out.Data(), saveMean.Data(), saveInvStdDev.Data(),
+        (CUDA_LONG) GetNumRows(), (ElemType) epsilon);
+}
+
+template <class ElemType>
+void GPUMatrix<ElemType>::LayerNormalizationBackward(const GPUMatrix<ElemType>& in, GPUMatrix<ElemType>& grad, const GPUMatrix<ElemType>& scale,
+                                                     const GPUMatrix<ElemType>& saveMean, const GPUMatrix<ElemType>& saveInvStdDev,
+                                                     GPUMatrix<ElemType>& scaleGrad, GPUMatrix<ElemType>& biasGrad) const
+{
+    scaleGrad.RequireSize(GetNumRows(), 1);
+    biasGrad.RequireSize(GetNumRows(), 1);
+
+    PrepareDevice();
+    SyncGuard syncGuard;
+    _layerNormBackward512Threads<ElemType><<<(unsigned int) GetNumCols(), 512, 0, t_stream>>>(
+        Data(), in.Data(), scale.Data(), saveMean.Data(), saveInvStdDev.Data(), grad.Data(), (CUDA_LONG) GetNumRows());
+
+    int blocksPerGrid = (int) ceil(1.0 * GetNumRows() / GridDim::maxThreadsPerBlock);
+    _layerNormScaleBiasGradients<ElemType><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, t_stream>>>(
+        Data(), in.Data(), saveMean.Data(), saveInvStdDev.Data(), scaleGrad.Data(), biasGrad.Data(),
+        (CUDA_LONG) GetNumRows(), (CUDA_LONG) GetNumCols());
+}
+
 #pragma region RNN Functions
 
 template <class ElemType>
@@ -3354,6 +3570,115 @@ static cublasStatus_t cublas_axpy(cublasHandle_t handle, int n, const double* al
     return cublasDaxpy(handle, n, alpha, x, incx, y, incy);
 }
 
+// -----------------------------------------------------------------------
+// tensor-core GEMM path (opt-in)
+// -----------------------------------------------------------------------
+// With CNTK_TENSOR_CORE_GEMM=1 (or =fp16), large float GEMMs are issued as cublasSgemmEx() with
+// half-precision operands and fp32 accumulation: the stored matrices stay fp32 -- they are the
+// master weights -- and the A/B operands are rounded to half on the fly into a per-device scratch
+// buffer. Because accumulation and all persistent state remain fp32, no loss scaling is needed.
+// With CNTK_TENSOR_CORE_GEMM=tf32 (CUDA 11+), the regular fp32 GEMM runs under TF32 tensor-core
+// math instead: no conversion pass, and 18 significand bits instead of half's 10. Double-precision
+// GEMMs are never rerouted.
+static int TensorCoreGemmModeFromEnv()
+{
+    const char* env = getenv("CNTK_TENSOR_CORE_GEMM");
+    if (env == nullptr)
+        return 0;
+    if (strcmp(env, "1") == 0 || strcmp(env, "fp16") == 0)
+        return 1;
+    if (strcmp(env, "tf32") == 0)
+        return 2;
+    return 0;
+}
+
+#if CUDA_VERSION >= 8000
+// per-device grow-only half-precision operand scratch; like the cublas handles, it is never
+// freed and lives until the process ends
+static __half* GetHalfScratch(int deviceId, size_t numElements)
+{
+    static std::map<int, std::pair<__half*, size_t>> s_halfScratch;
+    static std::mutex s_halfScratchMutex;
+    std::lock_guard<std::mutex> lock(s_halfScratchMutex);
+    auto& entry = s_halfScratch[deviceId];
+    if (entry.second < numElements)
+    {
+        if (entry.first != nullptr)
+            TracingGPUMemoryAllocator::Free<char>(deviceId, (char*) entry.first);
+        entry.first = (__half*) TracingGPUMemoryAllocator::Allocate<char>(deviceId, numElements * sizeof(__half));
+        entry.second = numElements;
+    }
+    return entry.first;
+}
+#endif
+
+// double overload: tensor cores only apply to single precision
+static bool TryTensorCoreGemm(cublasHandle_t, int, cublasOperation_t, cublasOperation_t, int, int, int,
+                              const double*, const double*, int, const double*, int, const double*, double*, int)
+{
+    return false;
+}
+
+static bool TryTensorCoreGemm(cublasHandle_t cuHandle, int deviceId, cublasOperation_t transA, cublasOperation_t transB, int m, int n, int k,
+                              const float* alpha, const float* A, int lda, const float* B, int ldb, const float* beta, float* C, int ldc)
+{
+#if CUDA_VERSION >= 8000
+    static const int mode = TensorCoreGemmModeFromEnv();
+    if (mode == 0)
+        return false;
+    // small or skinny products gain nothing from tensor cores; leave them on the plain fp32 path
+    if (m < 64 || n < 64 || k < 64)
+        return false;
+
+    if (mode == 2)
+    {
+#if CUDA_VERSION >= 11000
+        // TF32: same fp32 GEMM, tensor-core math mode for the duration of the call
+        CUBLAS_CALL(cublasSetMathMode(cuHandle, CUBLAS_TF32_TENSOR_OP_MATH));
+        cublasStatus_t status = cublasSgemm(cuHandle, transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+        CUBLAS_CALL(cublasSetMathMode(cuHandle, CUBLAS_DEFAULT_MATH));
+        CUBLAS_CALL(status);
+        return true;
+#else
+        return false; // TF32 requires CUDA 11; fall back to the plain fp32 path
+#endif
+    }
+
+    // number of stored elements of A and B as laid out for the GEMM call
+    size_t numA = (size_t) lda * (transA == CUBLAS_OP_N ? k : m);
+    size_t numB = (size_t) ldb * (transB == CUBLAS_OP_N ? n : k);
+    if (numA > INT_MAX || numB > INT_MAX) // conversion kernels index with CUDA_LONG
+        return false;
+
+    __half* halfA = GetHalfScratch(deviceId, numA + numB);
+    __half* halfB = halfA + numA;
+    {
+        SyncGuard syncGuard;
+        GridDim gridA((CUDA_LONG) numA);
+        _floatToHalf<<<gridA.m_blocksPerGrid, gridA.m_threadsPerBlock, 0, t_stream>>>(A, halfA, (CUDA_LONG) numA);
+        GridDim gridB((CUDA_LONG) numB);
+        _floatToHalf<<<gridB.m_blocksPerGrid, gridB.m_threadsPerBlock, 0, t_stream>>>(B, halfB, (CUDA_LONG) numB);
+    }
+
+#if CUDA_VERSION >= 9000
+    CUBLAS_CALL(cublasSetMathMode(cuHandle, CUBLAS_TENSOR_OP_MATH)); // allow tensor cores (V100 and later)
+#endif
+    cublasStatus_t status = cublasSgemmEx(cuHandle, transA, transB, m, n, k, alpha,
+                                          halfA, CUDA_R_16F, lda,
+                                          halfB, CUDA_R_16F, ldb,
+                                          beta, C, CUDA_R_32F, ldc);
+#if CUDA_VERSION >= 9000
+    CUBLAS_CALL(cublasSetMathMode(cuHandle, CUBLAS_DEFAULT_MATH));
+#endif
+    CUBLAS_CALL(status);
+    return true;
+#else
+    (void) cuHandle; (void) deviceId; (void) transA; (void) transB; (void) m; (void) n; (void) k;
+    (void) alpha; (void) A; (void) lda; (void) B; (void) ldb; (void) beta; (void) C; (void) ldc;
+    return false;
+#endif
+}
+
 template <class ElemType>
 void GPUMatrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const GPUMatrix<ElemType>& a, const bool transposeA, const GPUMatrix<ElemType>& b, const bool transposeB,
                                                  ElemType beta, GPUMatrix<ElemType>& c)
@@ -3376,7 +3701,8 @@ void GPUMatrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const GPUMatrix
         RuntimeError("!(m>0 && k>0 && l>0 && n>0)"); // converting from size_t to int may cause overflow
     if (k != l)
         RuntimeError("matrix dim mismatch in MultiplyAndWeightedAdd");
-    CUBLAS_CALL(cublas_gemm(cuHandle, transA, transB, m, n, k, &alpha, a.Data(), (int) a.m_numRows, b.Data(), (int) b.m_numRows, &beta, c.Data(), (int) c.m_numRows));
+    if (!TryTensorCoreGemm(cuHandle, b.GetComputeDeviceId(), transA, transB, m, n, k, &alpha, a.Data(), (int) a.m_numRows, b.Data(), (int) b.m_numRows, &beta, c.Data(), (int) c.m_numRows))
+        CUBLAS_CALL(cublas_gemm(cuHandle, transA, transB, m, n, k, &alpha, a.Data(), (int) a.m_numRows, b.Data(), (int) b.m_numRows, &beta, c.Data(), (int) c.m_numRows));
     c.m_numRows = m;
     c.m_numCols = n;
 }
@@ -3393,6 +3719,32 @@ void GPUMatrix<ElemType>::Multiply1x1AndWeightedAdd(ElemType alpha, const GPUMat
     _multiply1x1AndWeightedAdd<ElemType><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, t_stream>>>(alpha, a.Data(), b.Data(), beta, c.Data(), N);
 }
 
+template <class ElemType>
+void GPUMatrix<ElemType>::FusedPeepholeLSTMStep(const GPUMatrix<ElemType>& gates, const GPUMatrix<ElemType>& prevCellState, const GPUMatrix<ElemType>& peephole, GPUMatrix<ElemType>& cellState, GPUMatrix<ElemType>& output)
+{
+    if ((gates.GetComputeDeviceId() != prevCellState.GetComputeDeviceId()) ||
+        (!peephole.IsEmpty() && peephole.GetComputeDeviceId() != gates.GetComputeDeviceId()))
+        InvalidArgument("All matrices must be on the same GPU");
+
+    size_t cellSize = prevCellState.GetNumRows();
+    size_t batch = prevCellState.GetNumCols();
+    if (gates.GetNumRows() != 4 * cellSize || gates.GetNumCols() != batch)
+        InvalidArgument("FusedPeepholeLSTMStep: gates must be [4 * cellSize x batch].");
+    if (!peephole.IsEmpty() && (peephole.GetNumRows() != 3 * cellSize || peephole.GetNumCols() != 1))
+        InvalidArgument("FusedPeepholeLSTMStep: peephole weights must be [3 * cellSize x 1] or empty.");
+
+    cellState.RequireSize(cellSize, batch);
+    output.RequireSize(cellSize, batch);
+
+    CUDA_LONG N = (CUDA_LONG) (cellSize * batch);
+    int blocksPerGrid = (int) ceil(1.0 * N / GridDim::maxThreadsPerBlock);
+    prevCellState.PrepareDevice();
+    SyncGuard syncGuard;
+    _fusedPeepholeLSTMStep<ElemType><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0, t_stream>>>(
+        gates.Data(), prevCellState.Data(), peephole.IsEmpty() ? nullptr : peephole.Data(),
+        cellState.Data(), output.Data(), (CUDA_LONG) cellSize, N);
+}
+
 template <class ElemType>
 void GPUMatrix<ElemType>::MultiplyAndAdd(const GPUMatrix<ElemType>& a, const bool transposeA, const GPUMatrix<ElemType>& b, const bool transposeB, GPUMatrix<ElemType>& c)
 {
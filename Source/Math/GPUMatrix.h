@@ -223,6 +223,14 @@ public:
         return Buffer() + m_sliceViewOffset;
     }
 
+    // Batched (multi-tensor) variant of the momentum SGD update performed by Matrix::NormalGrad:
+    // updates all tensors in the group with one kernel launch per chunk instead of several
+    // launches per tensor. All matrices must be dense and reside on the same device.
+    static void BatchedNormalGrad(const std::vector<GPUMatrix<ElemType>*>& smoothedGradients,
+                                  const std::vector<GPUMatrix<ElemType>*>& gradients,
+                                  const std::vector<GPUMatrix<ElemType>*>& functionValues,
+                                  ElemType learnRatePerSample, ElemType momentum, bool useNesterovMomentum);
+
     ElemType Adagrad(GPUMatrix<ElemType>& gradients, const bool needAveMultiplier);
     void FSAdagrad(GPUMatrix<ElemType>& gradients, GPUMatrix<ElemType>& functionValues, ElemType learnRatePerSample, ElemType momentum, ElemType adaWeight, ElemType adaMul);
     ElemType RmsProp(GPUMatrix<ElemType>& gradients, ElemType RMS_GAMMA, ElemType RMS_WGT_INC, ElemType RMS_WGT_MAX, ElemType RMS_WGT_DEC, ElemType RMS_WGT_MIN, const bool needAveMultiplier);
@@ -390,6 +398,7 @@ public:
     GPUMatrix<ElemType>& AddWithScaleOf(ElemType alpha, const GPUMatrix<ElemType>& a);
 
     ElemType FrobeniusNorm() const;
+    DeviceBoundNumber<ElemType> FrobeniusNorm_AsDeviceBoundNum() const;
     GPUMatrix<ElemType>& AssignFrobeniusNormOf(const GPUMatrix<ElemType>& a);
 
     ElemType MatrixNormInf() const;
@@ -487,6 +496,12 @@ public:
                                     const GPUMatrix<ElemType>& saveMean, const GPUMatrix<ElemType>& saveInvStdDev,
                                     GPUMatrix<ElemType>& scaleGrad, GPUMatrix<ElemType>& biasGrad) const;
 
+    void LayerNormalizationForward(const GPUMatrix<ElemType>& scale, const GPUMatrix<ElemType>& bias, GPUMatrix<ElemType>& out, double epsilon,
+                                   GPUMatrix<ElemType>& saveMean, GPUMatrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationBackward(const GPUMatrix<ElemType>& in, GPUMatrix<ElemType>& grad, const GPUMatrix<ElemType>& scale,
+                                    const GPUMatrix<ElemType>& saveMean, const GPUMatrix<ElemType>& saveInvStdDev,
+                                    GPUMatrix<ElemType>& scaleGrad, GPUMatrix<ElemType>& biasGrad) const;
+
     // RNN support functions
     void RNNForward(const GPUMatrix<ElemType>& inputX, const GPUMatrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const struct RnnAttributes& rnnAttributes, GPUMatrix<ElemType>& reserve, GPUMatrix<ElemType>& workspace);
     void RNNBackwardData(const GPUMatrix<ElemType>& outputDY, const GPUMatrix<ElemType>& paramW, GPUMatrix<ElemType>& outputDX, const struct RnnAttributes& rnnAttributes, GPUMatrix<ElemType>& reserve, GPUMatrix<ElemType>& workspace);
@@ -499,6 +514,10 @@ public:
     static void Multiply(const GPUMatrix<ElemType>& a, const bool transposeA, const GPUMatrix<ElemType>& b, const bool transposeB, GPUMatrix<ElemType>& c);
     static void Multiply(const GPUMatrix<ElemType>& a, const GPUMatrix<ElemType>& b, GPUMatrix<ElemType>& c);
     static void Multiply1x1AndWeightedAdd(ElemType alpha, const GPUMatrix<ElemType>& a, const GPUMatrix<ElemType>& b, ElemType beta, GPUMatrix<ElemType>& c);
+    // fused pointwise (peephole) LSTM step: gate sigmoids, tanh and cell/output update in one kernel launch.
+    // gates is [4*cellSize x batch] stacked as [input; forget; candidate; output]; peephole is [3*cellSize x 1]
+    // ([Wci; Wcf; Wco]) or empty for a cell without peephole connections.
+    static void FusedPeepholeLSTMStep(const GPUMatrix<ElemType>& gates, const GPUMatrix<ElemType>& prevCellState, const GPUMatrix<ElemType>& peephole, GPUMatrix<ElemType>& cellState, GPUMatrix<ElemType>& output);
 
     static void ScaleAndAdd(ElemType alpha, const GPUMatrix<ElemType>& a, GPUMatrix<ElemType>& c);
     static void ScaleAndAdd(ElemType alpha, const GPUMatrix<ElemType>& a, const GPUMatrix<ElemType>& b, GPUMatrix<ElemType>& c);
@@ -584,8 +603,7 @@ public:
         int format;
         stream >> matrixNameDummy >> format >> numRows >> numCols;
         ElemType* d_array = new ElemType[numRows * numCols];
-        for (size_t i = 0; i < numRows * numCols; ++i)
-            stream >> d_array[i];
+        stream.GetArray(d_array, numRows * numCols);
         stream.GetMarker(fileMarkerEndSection, std::wstring(L"EMAT"));
         us.SetValue(numRows, numCols, us.GetComputeDeviceId(), d_array, matrixFlagNormal | format);
         delete[] d_array;
@@ -603,8 +621,7 @@ public:
 
         stream << us.m_numRows << us.m_numCols;
         ElemType* pArray = us.CopyToArray();
-        for (size_t i = 0; i < us.GetNumElements(); ++i)
-            stream << pArray[i];
+        stream.PutArray(pArray, us.GetNumElements());
         
         delete[] pArray;
 
@@ -16,6 +16,9 @@
 #include "TensorOps.h" // for exp_() etc.
 #include "device_functions.h"
 #include <cuda_runtime.h>
+#if CUDA_VERSION >= 8000
+#include <cuda_fp16.h> // for the __half operand buffers of the tensor-core GEMM path
+#endif
 #include <assert.h>
 #include <float.h>
 #pragma pop_macro("TENSOR_OPS_DECL")
@@ -282,6 +285,49 @@ __global__ void _assignSigmoidOf(
 #endif
 };
 
+// Fused pointwise step of a (peephole) LSTM cell: everything downstream of the gate GEMMs --
+// the gate sigmoids, candidate/cell tanh and the elementwise state update -- in one launch,
+// instead of the dozen elementwise kernels a recurrence built from primitive nodes issues per
+// timestep.
+// gates:        4*cellSize x batch column-major gate preactivations, rows stacked as
+//               [input; forget; candidate; output]
+// peephole:     optional diagonal peephole weights, a 3*cellSize vector [Wci; Wcf; Wco]
+//               (nullptr if the cell has no peephole connections)
+// cellState/output: cellSize x batch results; N = cellSize * batch
+template <class ElemType>
+__global__ void _fusedPeepholeLSTMStep(
+    const ElemType* gates,
+    const ElemType* prevCellState,
+    const ElemType* peephole,
+    ElemType* cellState,
+    ElemType* output,
+    const CUDA_LONG cellSize,
+    const CUDA_LONG N)
+{
+    CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+    CUDA_LONG row = id % cellSize;
+    const ElemType* gateCol = gates + (id / cellSize) * 4 * cellSize;
+
+    ElemType cPrev = prevCellState[id];
+    ElemType zi = gateCol[row];
+    ElemType zf = gateCol[cellSize + row];
+    ElemType zc = gateCol[2 * cellSize + row];
+    ElemType zo = gateCol[3 * cellSize + row];
+    if (peephole != nullptr)
+    {
+        zi += peephole[row] * cPrev;
+        zf += peephole[cellSize + row] * cPrev;
+    }
+    ElemType i = 1 / (1 + exp_(-zi));
+    ElemType f = 1 / (1 + exp_(-zf));
+    ElemType c = f * cPrev + i * tanh_(zc);
+    if (peephole != nullptr)
+        zo += peephole[2 * cellSize + row] * c; // peephole on the output gate sees the new cell state
+    ElemType o = 1 / (1 + exp_(-zo));
+    cellState[id] = c;
+    output[id] = o * tanh_(c);
+};
+
 template <class ElemType>
 __global__ void _elementWiseLinRectDerivativeOnCuda(
     const ElemType* a,
@@ -985,6 +1031,154 @@ __global__ void _assignColumnwiseLogSoftmaxOf512Threads(
     }
 }
 
+// layer normalization forward, fused into a single launch: one block per column computes the
+// column mean and variance with a shared-memory tree reduction, then normalizes in place
+template <class ElemType>
+__global__ void _layerNormForward512Threads(
+    const ElemType* in,
+    const ElemType* scale,
+    const ElemType* bias,
+    ElemType* out,
+    ElemType* saveMean,
+    ElemType* saveInvStdDev,
+    const CUDA_LONG m_numRows,
+    const ElemType epsilon)
+{
+    __shared__ ElemType partialSums[512];
+    __shared__ ElemType partialSqSums[512];
+    __shared__ ElemType mean;
+    __shared__ ElemType invStdDev;
+
+    ElemType sum = 0;
+    ElemType sqSum = 0;
+    for (CUDA_LONG i = threadIdx.x; i < m_numRows; i += 512)
+    {
+        ElemType x = in[IDX2C(i, blockIdx.x, m_numRows)];
+        sum += x;
+        sqSum += x * x;
+    }
+    partialSums[threadIdx.x] = sum;
+    partialSqSums[threadIdx.x] = sqSum;
+    __syncthreads();
+
+    for (int stride = 256; stride > 0; stride >>= 1)
+    {
+        if (threadIdx.x < stride)
+        {
+            partialSums[threadIdx.x] += partialSums[threadIdx.x + stride];
+            partialSqSums[threadIdx.x] += partialSqSums[threadIdx.x + stride];
+        }
+        __syncthreads();
+    }
+
+    if (threadIdx.x == 0)
+    {
+        mean = partialSums[0] / m_numRows;
+        ElemType variance = partialSqSums[0] / m_numRows - mean * mean;
+        if (variance < 0) // clamp numerical noise from the sum-of-squares formulation
+            variance = 0;
+        invStdDev = (sizeof(ElemType) == sizeof(float)) ? rsqrtf(variance + epsilon) : rsqrt(variance + epsilon);
+        saveMean[blockIdx.x] = mean;
+        saveInvStdDev[blockIdx.x] = invStdDev;
+    }
+    __syncthreads();
+
+    for (CUDA_LONG i = threadIdx.x; i < m_numRows; i += 512)
+    {
+        CUDA_LONG idx = IDX2C(i, blockIdx.x, m_numRows);
+        out[idx] = scale[i] * ((in[idx] - mean) * invStdDev) + bias[i];
+    }
+}
+
+// layer normalization gradient to the data input: one block per column reduces the two
+// per-column terms (mean of g and of g*xHat, g = srcGrad .* scale), then adds the result
+template <class ElemType>
+__global__ void _layerNormBackward512Threads(
+    const ElemType* srcGrad,
+    const ElemType* in,
+    const ElemType* scale,
+    const ElemType* saveMean,
+    const ElemType* saveInvStdDev,
+    ElemType* grad,
+    const CUDA_LONG m_numRows)
+{
+    __shared__ ElemType partialSums[512];
+    __shared__ ElemType partialXSums[512];
+    __shared__ ElemType meanG;
+    __shared__ ElemType meanGX;
+
+    const ElemType mean = saveMean[blockIdx.x];
+    const ElemType invStdDev = saveInvStdDev[blockIdx.x];
+
+    ElemType sumG = 0;
+    ElemType sumGX = 0;
+    for (CUDA_LONG i = threadIdx.x; i < m_numRows; i += 512)
+    {
+        CUDA_LONG idx = IDX2C(i, blockIdx.x, m_numRows);
+        ElemType xHat = (in[idx] - mean) * invStdDev;
+        ElemType g = srcGrad[idx] * scale[i];
+        sumG += g;
+        sumGX += g * xHat;
+    }
+    partialSums[threadIdx.x] = sumG;
+    partialXSums[threadIdx.x] = sumGX;
+    __syncthreads();
+
+    for (int stride = 256; stride > 0; stride >>= 1)
+    {
+        if (threadIdx.x < stride)
+        {
+            partialSums[threadIdx.x] += partialSums[threadIdx.x + stride];
+            partialXSums[threadIdx.x] += partialXSums[threadIdx.x + stride];
+        }
+        __syncthreads();
+    }
+
+    if (threadIdx.x == 0)
+    {
+        meanG = partialSums[0] / m_numRows;
+        meanGX = partialXSums[0] / m_numRows;
+    }
+    __syncthreads();
+
+    for (CUDA_LONG i = threadIdx.x; i < m_numRows; i += 512)
+    {
+        CUDA_LONG idx = IDX2C(i, blockIdx.x, m_numRows);
+        ElemType xHat = (in[idx] - mean) * invStdDev;
+        ElemType g = srcGrad[idx] * scale[i];
+        grad[idx] += invStdDev * (g - meanG - xHat * meanGX);
+    }
+}
+
+// layer normalization gradients to scale and bias: one thread per row reduces over columns
+template <class ElemType>
+__global__ void _layerNormScaleBiasGradients(
+    const ElemType* srcGrad,
+    const ElemType* in,
+    const ElemType* saveMean,
+    const ElemType* saveInvStdDev,
+    ElemType* scaleGrad,
+    ElemType* biasGrad,
+    const CUDA_LONG m_numRows,
+    const CUDA_LONG m_numCols)
+{
+    CUDA_LONG row = blockDim.x * blockIdx.x + threadIdx.x;
+    if (row >= m_numRows)
+        return;
+
+    ElemType ds = 0;
+    ElemType db = 0;
+    for (CUDA_LONG j = 0; j < m_numCols; j++)
+    {
+        CUDA_LONG idx = IDX2C(row, j, m_numRows);
+        ElemType xHat = (in[idx] - saveMean[j]) * saveInvStdDev[j];
+        ds += srcGrad[idx] * xHat;
+        db += srcGrad[idx];
+    }
+    scaleGrad[row] = ds;
+    biasGrad[row] = db;
+}
+
 template <class ElemType>
 __global__ void _logSoftMaxRowWise(
     ElemType* a,
@@ -1365,6 +1559,51 @@ __global__ void _setDiagonalValueFromVector(
     a[IDX2C(id, id, N)] = b[id];
 }
 
+// Bundle of per-tensor pointers for the batched (multi-tensor) momentum SGD update below.
+// The bundle is passed to the kernel by value, so its size stays within the kernel argument
+// size limit; callers split larger parameter groups into chunks of MaxTensors.
+template <class ElemType>
+struct BatchedGradientUpdateChunk
+{
+    static const int MaxTensors = 32;
+    ElemType* smoothedGradients[MaxTensors];
+    ElemType* gradients[MaxTensors];
+    ElemType* functionValues[MaxTensors];
+    CUDA_LONG numElements[MaxTensors];
+};
+
+// Applies the (Nesterov) momentum SGD update to a whole group of tensors in a single launch,
+// replacing the per-parameter ScaleAndAdd sequences that Matrix::NormalGrad() would issue.
+// The grid is sized for the largest tensor in the chunk; each thread walks the tensor list
+// and updates its element in every tensor that is large enough.
+template <class ElemType>
+__global__ void _batchedNormalGrad(
+    BatchedGradientUpdateChunk<ElemType> chunk,
+    const int numTensors,
+    const CUDA_LONG maxNumElements,
+    const ElemType learnRatePerSample,
+    const ElemType momentum,
+    const bool useNesterovMomentum)
+{
+    CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x;
+    if (id >= maxNumElements)
+        return;
+
+    for (int tensor = 0; tensor < numTensors; tensor++)
+    {
+        if (id >= chunk.numElements[tensor])
+            continue;
+
+        ElemType g = chunk.gradients[tensor][id];
+        ElemType sg = momentum * chunk.smoothedGradients[tensor][id] + (1 - momentum) * learnRatePerSample * g;
+        chunk.smoothedGradients[tensor][id] = sg;
+        if (!useNesterovMomentum)
+            chunk.functionValues[tensor][id] -= sg;
+        else
+            chunk.functionValues[tensor][id] -= momentum * sg + (1 - momentum) * learnRatePerSample * g;
+    }
+}
+
 template <class ElemType>
 __global__ void _adagrad(
     ElemType* a,
@@ -1454,6 +1693,56 @@ __global__ void _fsadagrad(CUDA_LONG size, ElemType* grad, ElemType* smoothAda,
     }
 }
 
+// FSAdaGrad update for a column-block sparse gradient (e.g. the LookupTable/embedding
+// gradient): only the model rows whose columns appear in the minibatch are touched,
+// while the dense accumulators and the model are indexed through blockId2Col.
+template <class ElemType>
+__global__ void _fsadagrad4BlockSparseCol(CUDA_LONG size,
+                                          ElemType* grad_bsc,                         // block sparse column values
+                                          const GPUSPARSE_INDEX_TYPE* blockId2Col,    // block id -> column in the dense model
+                                          const size_t len,                           // column length (numRows)
+                                          ElemType* smoothAda, ElemType* smoothMom, ElemType* val,
+                                          ElemType lr, ElemType mom, ElemType adaWeight, ElemType adaMul)
+{
+    CUDA_LONG idx = blockIdx.x * blockDim.x + threadIdx.x;
+    CUDA_LONG stride = blockDim.x * gridDim.x;
+    for (; idx < size; idx += stride)
+    {
+        CUDA_LONG blockid = idx / len;
+        CUDA_LONG row = idx - blockid * len;
+        CUDA_LONG denseIdx = blockId2Col[blockid] * len + row;
+
+        ElemType g = grad_bsc[idx];
+        ElemType adaSqr = adaWeight * smoothAda[denseIdx] + (1.0f - adaWeight) * g * g;
+        smoothAda[denseIdx] = adaSqr;
+        if (adaSqr != 0.0f)
+        {
+            ElemType w;
+            if (sizeof(ElemType) == sizeof(double))
+            {
+                w = adaMul * rsqrt(adaSqr);
+            }
+            else
+            {
+                w = adaMul * rsqrtf(adaSqr);
+            }
+
+            if (w > 10.0f)
+                w = 10.0f;
+            g *= w;
+        }
+
+        if (mom > 0.0f)
+        {
+            g = mom * smoothMom[denseIdx] + (1.0f - mom) * g;
+            smoothMom[denseIdx] = g;
+        }
+
+        g *= lr;
+        val[denseIdx] -= g;
+    }
+}
+
 template <class ElemType>
 __global__ void _rmsprop_init(
     ElemType* avars, ElemType* signs, ElemType* steps,
@@ -2706,6 +2995,21 @@ __global__ void _scaleArray(
     us[id] = us[id] * alpha;
 }
 
+#if CUDA_VERSION >= 8000
+// round-to-nearest conversion of a float array into a half-precision scratch buffer; used to
+// feed fp16 operands to cublasGemmEx()/cublasSgemmEx() while the stored matrices stay fp32
+__global__ void _floatToHalf(
+    const float* src,
+    __half* dst,
+    CUDA_LONG N)
+{
+    CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x;
+    if (id >= N)
+        return;
+    dst[id] = __float2half(src[id]);
+}
+#endif
+
 template <class ElemType>
 __global__ void _sparseCSRPlusDense(
     ElemType alpha,
@@ -2748,6 +3052,66 @@ __global__ void _sparseCSRElemMulDense(
     }
 }
 
+// load-balanced CSR x dense SpMM: c += alpha * A * B, with A in CSR format and B, c dense column-major
+// Unlike row-per-thread kernels (and cusparse csrmm on skewed inputs), each thread owns a fixed-size
+// chunk of nonzeros for one output column (nonzero splitting), so per-thread work is independent of
+// the row-length distribution; a power-law row with 100k nonzeros is simply spread over many threads.
+// The row containing the chunk's first nonzero is found by binary search in the CSR row-pointer array;
+// partial row sums are committed with atomicAdd since a row may span several chunks.
+// Note: c must already hold beta * c (the kernel only adds).
+template <class ElemType>
+__global__ void _sparseCSRMulDenseLoadBalanced(
+    ElemType alpha,
+    const ElemType* aVal,
+    const GPUSPARSE_INDEX_TYPE* aRow, // CSR row-pointer array, m + 1 entries
+    const GPUSPARSE_INDEX_TYPE* aCol,
+    const ElemType* b, // dense [k x n]
+    ElemType* c,       // dense [m x n]
+    const CUDA_LONG m,
+    const CUDA_LONG k,
+    const CUDA_LONG n,
+    const CUDA_LONG nz,
+    const CUDA_LONG nnzPerThread)
+{
+    CUDA_LONG id = blockDim.x * blockIdx.x + threadIdx.x;
+    CUDA_LONG numChunks = (nz + nnzPerThread - 1) / nnzPerThread;
+    CUDA_LONG col = id / numChunks; // output column this thread contributes to
+    if (col >= n)
+        return;
+    CUDA_LONG begin = (id % numChunks) * nnzPerThread;
+    CUDA_LONG end = min(begin + nnzPerThread, nz);
+
+    // binary-search the row containing the chunk's first nonzero: first row with aRow[row + 1] > begin
+    CUDA_LONG lo = 0;
+    CUDA_LONG hi = m - 1;
+    while (lo < hi)
+    {
+        CUDA_LONG mid = (lo + hi) / 2;
+        if (aRow[mid + 1] <= begin)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    CUDA_LONG row = lo;
+
+    ElemType sum = 0;
+    for (CUDA_LONG i = begin; i < end; ++i)
+    {
+        while (i >= aRow[row + 1]) // advance to the row containing nonzero i, committing the finished run
+        {
+            if (sum != 0)
+            {
+                atomicAdd(&c[IDX2C(row, col, m)], alpha * sum);
+                sum = 0;
+            }
+            ++row;
+        }
+        sum += aVal[i] * b[IDX2C(aCol[i], col, k)];
+    }
+    if (sum != 0)
+        atomicAdd(&c[IDX2C(row, col, m)], alpha * sum);
+}
+
 template <class ElemType>
 __global__ void _isValid(
     const GPUSPARSE_INDEX_TYPE* rowIndex,
@@ -4125,6 +4489,40 @@ __global__ void _reductionSum21024Threads(
     }
 }
 
+// Single-pass grid-wide sum reduction: each block reduces its grid-stride slice with
+// cub::BlockReduce and atomically accumulates into sum[0]. The caller must zero sum[0]
+// before the launch. With takeSqr the squares of the elements are summed instead
+// (partial result for the Frobenius norm). The result stays in device memory, so no
+// device-to-host sync is needed to chain further device-side work on it.
+template <int BlockSize, class ElemType>
+__global__ void _reductionSumSinglePass(
+    const ElemType* data,
+    ElemType* sum,
+    CUDA_LONG N,
+    bool takeSqr)
+{
+    ElemType cur = 0;
+    for (CUDA_LONG i = blockIdx.x * BlockSize + threadIdx.x; i < N; i += (CUDA_LONG) gridDim.x * BlockSize)
+        cur += takeSqr ? data[i] * data[i] : data[i];
+
+    using BlockReduceT = cub::BlockReduce<ElemType, BlockSize>;
+    __shared__ typename BlockReduceT::TempStorage tmp;
+
+    ElemType res = BlockReduceT(tmp).Sum(cur);
+    if (threadIdx.x == 0)
+        atomicAdd(sum, res);
+}
+
+// epilogue for device-resident norm results: a[0] <- sqrt(a[0]). Launch with <<<1, 1>>>.
+template <class ElemType>
+__global__ void _sqrtScalarInPlace(ElemType* a)
+{
+    if (sizeof(ElemType) == sizeof(float))
+        a[0] = sqrtf((float) a[0]);
+    else
+        a[0] = sqrt((double) a[0]);
+}
+
 //This function should be called with 1024 threads per block and 1 block
 //THIS IS NOT THE MOST EFFICIENT IMPLEMENTATION!!!
 template <class ElemType>
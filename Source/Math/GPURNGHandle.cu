@@ -7,6 +7,9 @@
 
 #include "GPURNGHandle.h"
 #include "GPUMatrix.h"
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -33,4 +36,124 @@ GPURNGHandle::GPURNGHandle(int deviceId, uint64_t seed, uint64_t offset)
         CURAND_CALL(curandDestroyGenerator(m_generator));
 }
 
+// -----------------------------------------------------------------------
+// GPURNGBatchedService
+// -----------------------------------------------------------------------
+
+// Elements per bank. 4M keeps the footprint modest (16 MB float / 32 MB double per bank,
+// two banks per element size) while still covering typical dropout masks many times over.
+static const size_t c_rngBankElems = 1 << 22;
+
+/*static*/ bool GPURNGBatchedService::IsEnabled()
+{
+    static const bool enabled = []()
+    {
+        const char* env = getenv("CNTK_BATCHED_RNG");
+        return env != nullptr && env[0] != '\0' && strcmp(env, "0") != 0;
+    }();
+    return enabled;
+}
+
+/*static*/ GPURNGBatchedService& GPURNGBatchedService::Instance(int deviceId)
+{
+    static std::mutex instanceMutex;
+    static std::map<int, std::shared_ptr<GPURNGBatchedService>> instances;
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    auto iter = instances.find(deviceId);
+    if (iter == instances.end())
+        iter = instances.emplace(deviceId, std::shared_ptr<GPURNGBatchedService>(new GPURNGBatchedService(deviceId),
+                                                                                 [](GPURNGBatchedService* p) { delete p; })).first;
+    return *iter->second;
+}
+
+GPURNGBatchedService::GPURNGBatchedService(int deviceId)
+    : m_deviceId(deviceId)
+{
+    if (GetMathLibTraceLevel() > 0)
+        fprintf(stderr, "(GPU): creating batched RNG service on device %d\n", deviceId);
+
+    CUDA_CALL(cudaSetDevice(deviceId));
+    CUDA_CALL(cudaStreamCreateWithFlags(&m_sideStream, cudaStreamNonBlocking));
+    CURAND_CALL(curandCreateGenerator(&m_generator, CURAND_RNG_PSEUDO_XORWOW));
+    // A fixed per-device seed: the service feeds all consumers on the device from one stream,
+    // so per-node seeds do not apply here anyway.
+    CURAND_CALL(curandSetPseudoRandomGeneratorSeed(m_generator, 20161453ULL + (unsigned long long) deviceId));
+    CURAND_CALL(curandSetGeneratorOrdering(m_generator, CURAND_ORDERING_PSEUDO_SEEDED));
+    CURAND_CALL(curandSetStream(m_generator, m_sideStream));
+}
+
+GPURNGBatchedService::~GPURNGBatchedService()
+{
+    for (auto& kv : m_rings)
+    {
+        for (int b = 0; b < 2; b++)
+        {
+            cudaEventDestroy(kv.second.fillDone[b]);
+            cudaEventDestroy(kv.second.retired[b]);
+            TracingGPUMemoryAllocator::Free<char>(m_deviceId, kv.second.banks[b], true /*ignoreCUDARetCode*/);
+        }
+    }
+    curandDestroyGenerator(m_generator);
+    cudaStreamDestroy(m_sideStream);
+}
+
+void GPURNGBatchedService::Refill(Ring& ring, int bank, size_t elemSize)
+{
+    // The side stream must not overwrite a bank the compute stream is still reading from.
+    CUDA_CALL(cudaStreamWaitEvent(m_sideStream, ring.retired[bank], 0));
+    if (elemSize == sizeof(float))
+        CURAND_CALL(curandGenerateUniform(m_generator, reinterpret_cast<float*>(ring.banks[bank]), c_rngBankElems));
+    else
+        CURAND_CALL(curandGenerateUniformDouble(m_generator, reinterpret_cast<double*>(ring.banks[bank]), c_rngBankElems));
+    CUDA_CALL(cudaEventRecord(ring.fillDone[bank], m_sideStream));
+}
+
+GPURNGBatchedService::Ring& GPURNGBatchedService::EnsureRing(size_t elemSize)
+{
+    auto iter = m_rings.find(elemSize);
+    if (iter != m_rings.end())
+        return iter->second;
+
+    Ring ring;
+    for (int b = 0; b < 2; b++)
+    {
+        ring.banks[b] = TracingGPUMemoryAllocator::Allocate<char>(m_deviceId, c_rngBankElems * elemSize);
+        CUDA_CALL(cudaEventCreateWithFlags(&ring.fillDone[b], cudaEventDisableTiming));
+        CUDA_CALL(cudaEventCreateWithFlags(&ring.retired[b], cudaEventDisableTiming));
+    }
+    ring.cursorElems = 0;
+    ring.active = 0;
+    iter = m_rings.emplace(elemSize, ring).first;
+
+    // Prime both banks. Waiting on the never-recorded 'retired' events is a no-op.
+    Refill(iter->second, 0, elemSize);
+    Refill(iter->second, 1, elemSize);
+    return iter->second;
+}
+
+void* GPURNGBatchedService::ClaimUniform(size_t count, size_t elemSize, cudaStream_t computeStream)
+{
+    if (count > c_rngBankElems)
+        return nullptr; // caller falls back to inline generation
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Ring& ring = EnsureRing(elemSize);
+
+    if (ring.cursorElems + count > c_rngBankElems)
+    {
+        // Retire the active bank and refill it asynchronously while consumers move on to the other one.
+        CUDA_CALL(cudaEventRecord(ring.retired[ring.active], computeStream));
+        Refill(ring, ring.active, elemSize);
+        ring.active ^= 1;
+        ring.cursorElems = 0;
+    }
+
+    // Cheap no-op once the fill has completed; guarantees the bank is ready on first use after a swap.
+    CUDA_CALL(cudaStreamWaitEvent(computeStream, ring.fillDone[ring.active], 0));
+
+    void* p = ring.banks[ring.active] + ring.cursorElems * elemSize;
+    ring.cursorElems += count;
+    return p;
+}
+
 }}}
@@ -11,6 +11,8 @@
 
 #ifndef CPUONLY
 #include <curand.h>
+#include <map>
+#include <mutex>
 #endif // !CPUONLY
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -32,4 +34,55 @@ private:
 #endif // !CPUONLY
 };
 
+#ifndef CPUONLY
+
+// Process-wide batched random generation service. Creating a curand generator and launching
+// curandGenerate* inline (as SetUniformRandomMask does) costs a noticeable amount of host time
+// when a network has many dropout layers. The service keeps one generator per device and
+// pre-generates large banks of uniform values on a side stream; consumers slice pre-made
+// randomness out of the active bank and only pay a device-to-device copy on the compute stream.
+//
+// Opt-in via CNTK_BATCHED_RNG=1: all consumers on a device draw from one shared stream, so
+// per-node seed/offset reproducibility (RngUser semantics) is traded for throughput.
+class GPURNGBatchedService
+{
+public:
+    static bool IsEnabled();
+    static GPURNGBatchedService& Instance(int deviceId);
+
+    // Returns a device pointer to 'count' pre-generated uniform (0,1] values of the given
+    // element size, valid until the containing bank is recycled; ordering against the caller's
+    // compute stream is handled with events. Returns nullptr if the request exceeds the bank
+    // size, in which case the caller should fall back to inline generation.
+    void* ClaimUniform(size_t count, size_t elemSize, cudaStream_t computeStream);
+
+private:
+    GPURNGBatchedService(int deviceId);
+    ~GPURNGBatchedService();
+    GPURNGBatchedService(const GPURNGBatchedService&) = delete;
+    GPURNGBatchedService& operator=(const GPURNGBatchedService&) = delete;
+
+    // Double-banked ring per element size: the compute stream consumes the active bank while
+    // the side stream refills the retired one.
+    struct Ring
+    {
+        char* banks[2];
+        cudaEvent_t fillDone[2]; // recorded on the side stream after a bank is regenerated
+        cudaEvent_t retired[2];  // recorded on the compute stream when a bank is exhausted
+        size_t cursorElems;
+        int active;
+    };
+
+    Ring& EnsureRing(size_t elemSize);
+    void Refill(Ring& ring, int bank, size_t elemSize);
+
+    int m_deviceId;
+    curandGenerator_t m_generator;
+    cudaStream_t m_sideStream;
+    std::map<size_t, Ring> m_rings; // keyed by element size
+    std::mutex m_mutex;
+};
+
+#endif // !CPUONLY
+
 }}}
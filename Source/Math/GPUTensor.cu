@@ -9,6 +9,7 @@
 
 #ifndef CPUONLY
 
+#include "Globals.h"
 #include "GPUTensor.h"
 #include "GPUMatrix.h"
 #include "GPUMatrixCUDAKernels.cuh"
@@ -474,7 +475,6 @@ struct TensorOpElement<ElemType, N, M, K, /*parallelReduce=*/false, /*k=*/-1>
     }
 };
 
-#undef ALLOW_ATOMIC_REDUCTION // undefine to disable use of atomicAdd() below, for testing it
 
 // specialization for k = -1 terminates the template recursion, and computes reductions in parallel
 template <class ElemType, C_size_t N, C_int M, C_int K>
@@ -534,15 +534,16 @@ struct TensorOpElement<ElemType, N, M, K, /*parallelReduce=*/true, /*k=*/-1>
             if (N < 4 || val != 0 || beta != 1) // (skip memory access if not needed) (N<4: skip this test)
             {
                 auto* pout = pointers[pointers.size() - 1];
-#ifdef ALLOW_ATOMIC_REDUCTION
                 CUDA_LONG reductionBlocks = gridDim.z; // number of reduction blocks. If >1 we need atomicAdd
-                if (reductionBlocks > 1) // multiple blocks: need to use atomicAdd()
+                // Multiple blocks writing the same output element: combine with atomicAdd().
+                // The atomic launcher always passes beta = 1 for such launches, whereas the
+                // deterministic tree launcher passes beta = 0 (it writes disjoint slices of a
+                // temp buffer), so this condition discriminates the two modes at runtime.
+                if (reductionBlocks > 1 && beta == 1)
                 {
-                    // in this case, outer calling code must pass beta = 1
                     atomicAdd(pout, val);
                 }
                 else
-#endif
                 {
                     if (beta != 0)
                         val += beta * *pout;
@@ -605,10 +606,9 @@ __global__ void _launchTensorOpWithReduction(ElemType beta, FixedArray<ElemType*
                                              CUDA_LONG reductionBegin, CUDA_LONG reductionChunkSize)
 {
     CUDA_LONG id = gridDim.x * blockIdx.y + blockIdx.x; // input dimensions are Y dimension of blocks in this case, so we can use thread dim for shared-memory/parallelization
-#ifndef ALLOW_ATOMIC_REDUCTION
-    CUDA_LONG reductionBlock = blockIdx.z;                         // reduction-block index  --larger reductions are split into blocks
-    pointers[pointers.size() - 1] += numElements * reductionBlock; // the output tensor is dense (no gaps); and there is one copy for each reduction block (those get further reduced into one later)
-#endif
+    CUDA_LONG reductionBlock = blockIdx.z; // reduction-block index  --larger reductions are split into blocks
+    if (beta != 1) // deterministic tree reduction: the output tensor is dense (no gaps); and there is one copy for each reduction block (those get further reduced into one later)
+        pointers[pointers.size() - 1] += numElements * reductionBlock; // (the atomic launcher passes beta = 1 for multi-block launches and accumulates in place instead)
     if (id < numElements)                               // note: we have __syncthread() calls but only entire blocks in sync, so this is OK
         TensorOpElement<ElemType, N, M, K, true, K - 1>::Compute(id, beta, pointers, alpha, op, reductionOp, regularOpStrides, regularStrides, reducingOpDims, reducingStrides, reductionBegin, reductionChunkSize);
 }
@@ -754,8 +754,11 @@ static void LaunchTensorOpWithReduction(ElemType beta, array<ElemType*, N> point
         }
         // --- case (b)
         // Reduction across blocks. This is the difficult one.
-#ifndef ALLOW_ATOMIC_REDUCTION // temporarily disabled to ensure it is not causing the non-reproducability
-        else
+        // Default is the deterministic two-pass tree reduction; the atomicAdd() variant below is
+        // faster (no temp buffer, no second pass) but not bit-reproducible across runs, so it must
+        // be opted into via Globals::SetAtomicTensorReduction() and is never taken when
+        // forceDeterministicAlgorithms is set.
+        else if (!Globals::ShouldUseAtomicTensorReduction())
         {
             // we get here if NN <= #multiprocs
             assert(NN <= props.multiProcessorCount && numBlocksX == NN && numBlocksY == 1);
@@ -828,7 +831,6 @@ static void LaunchTensorOpWithReduction(ElemType beta, array<ElemType*, N> point
             sin(1.0);
 #endif
         }
-#else
         else if (beta == 1)
         {
             // no need to pre-scale; just add (common for gradients)
@@ -843,7 +845,6 @@ static void LaunchTensorOpWithReduction(ElemType beta, array<ElemType*, N> point
             // We will leave it like this for a while, but eventually need to revisit using temporary memory.
             _launchTensorOpWithReduction<ElemType, N, M, K><<<dim3(numBlocksX, numBlocksY, numBlocksZ - 1), numThreadsX, numThreadsX * sizeof(ReduceElemType), t_stream>>>(/*beta=*/1, pointers, alpha, op, reductionOp, regularOpStrides, regularStrides, NN, reducingOpDims, reducingStrides, reductionChunkSize, reductionChunkSize);
         }
-#endif
     }
 }
 
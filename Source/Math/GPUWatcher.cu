@@ -53,6 +53,12 @@ size_t GPUWatcher::GetFreeMemoryOnCUDADevice(int devId)
         return free;
 }
 
+size_t GPUWatcher::GetCachedMemorySizeOnCUDADevice(int devId)
+{
+    using Microsoft::MSR::CNTK::BufferManagement;
+    return BufferManagement::GetManagerInstance(devId).TotalManagedSize();
+}
+
 GPUWatcher::GPUWatcher(void)
 {
 }
@@ -12,6 +12,9 @@ class MATH_API GPUWatcher
 public:
     static size_t GetFreeMemoryOnCUDADevice(int devId);
     static int GetGPUIdWithTheMostFreeMemory();
+    // size of the cached (free-listed) buffer pool held by BufferManagement for the device,
+    // in elements; useful for spotting fragmentation buildup between epochs
+    static size_t GetCachedMemorySizeOnCUDADevice(int devId);
     GPUWatcher(void);
     ~GPUWatcher(void);
 };
@@ -0,0 +1,130 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// HotPathCounters.cpp -- per-thread counter blocks behind the hot-path instrumentation facade
+//
+#include "stdafx.h"
+#include "HotPathCounters.h"
+#include "TimerUtility.h"
+
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+std::atomic<bool> HotPathCounters::s_enabled(false);
+
+// keep in sync with the HotPathCounterId enum
+static const char* c_hotPathCounterNames[hotpathNumCounters] =
+{
+    "Matrix transfer CPU->GPU",
+    "Matrix transfer GPU->CPU",
+    "Matrix transfer GPU->GPU",
+    "MBLayout init",
+};
+
+namespace
+{
+    struct CounterBlock
+    {
+        struct
+        {
+            unsigned long long count;
+            unsigned long long value;
+            long long ticks;
+        } counters[hotpathNumCounters];
+    };
+
+    std::mutex s_registryMutex;
+
+    // One block per thread that ever bumped a counter. Blocks are heap-allocated and never
+    // freed, so a dump at the end of the run still sees the contributions of exited threads;
+    // the facility is a diagnostic tool and the leak is a few hundred bytes per thread.
+    std::vector<CounterBlock*>& Registry()
+    {
+        static std::vector<CounterBlock*> registry;
+        return registry;
+    }
+
+    CounterBlock* GetThreadBlock()
+    {
+        thread_local CounterBlock* t_block = nullptr;
+        if (t_block == nullptr)
+        {
+            t_block = new CounterBlock();
+            memset(t_block, 0, sizeof(CounterBlock));
+            std::lock_guard<std::mutex> lock(s_registryMutex);
+            Registry().push_back(t_block);
+        }
+        return t_block;
+    }
+}
+
+void HotPathCounters::SetEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void HotPathCounters::Add(HotPathCounterId id, unsigned long long value)
+{
+    auto& counter = GetThreadBlock()->counters[id];
+    counter.count++;
+    counter.value += value;
+}
+
+void HotPathCounters::AddTimed(HotPathCounterId id, unsigned long long value, long long startTicks)
+{
+    auto& counter = GetThreadBlock()->counters[id];
+    counter.count++;
+    counter.value += value;
+    counter.ticks += Clock::GetTimeStamp() - startTicks;
+}
+
+long long HotPathCounters::GetTimeStamp()
+{
+    return Clock::GetTimeStamp();
+}
+
+void HotPathCounters::Dump(FILE* f)
+{
+    CounterBlock total;
+    memset(&total, 0, sizeof(total));
+    size_t numThreads;
+    {
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        numThreads = Registry().size();
+        for (const auto* block : Registry())
+        {
+            for (int id = 0; id < hotpathNumCounters; id++)
+            {
+                total.counters[id].count += block->counters[id].count;
+                total.counters[id].value += block->counters[id].value;
+                total.counters[id].ticks += block->counters[id].ticks;
+            }
+        }
+    }
+
+    fprintf(f, "\nHot-path counters (%d threads):\n", (int) numThreads);
+    const double ticksPerSecond = (double) Clock::GetTicksPerSecond();
+    for (int id = 0; id < hotpathNumCounters; id++)
+    {
+        const auto& counter = total.counters[id];
+        if (counter.count == 0)
+            continue;
+        fprintf(f, "\t%-26s: %13llu calls, %16llu total, %10.3f s\n",
+                c_hotPathCounterNames[id], counter.count, counter.value,
+                (double) counter.ticks / ticksPerSecond);
+    }
+    fflush(f);
+}
+
+void HotPathCounters::Reset()
+{
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    for (auto* block : Registry())
+        memset(block, 0, sizeof(CounterBlock));
+}
+
+}}}
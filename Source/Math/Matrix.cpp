@@ -15,6 +15,7 @@
 #include <assert.h>
 #include <math.h>
 #include "GPUWatcher.h" // bring in this class as well so that it gets exported from this DLL
+#include "HotPathCounters.h"
 #include <memory>
 #include <atomic>
 #include "Quantizers.h"
@@ -156,6 +157,19 @@ int GetMathLibTraceLevel()
     return m_mathLibTraceLevel.load();
 }
 
+// audit counter over all matrices (see the declaration in Matrix.h)
+static std::atomic<unsigned long long> m_numMatrixDeviceTransfers(0);
+
+unsigned long long GetNumMatrixDeviceTransfers()
+{
+    return m_numMatrixDeviceTransfers.load();
+}
+
+void ResetNumMatrixDeviceTransfers()
+{
+    m_numMatrixDeviceTransfers.store(0);
+}
+
 MatrixBase::~MatrixBase() { }
 
 #pragma region BufferManagement
@@ -194,6 +208,7 @@ void Matrix<ElemType>::Init(DEVICEID_TYPE deviceId)
 {
     ReleaseMemory();
     m_preferredDeviceId = deviceId;
+    m_residencyPolicy = residencyPolicyAuto;
     m_numTimesDeviceChanged = 0;
     m_numTimesMatrixTypeChanged = 0;
     m_devicesTransferedTo[1]    = m_devicesTransferedTo[0] = CPUDEVICE - 1; // (some value that is different from any valid value)
@@ -213,6 +228,7 @@ void Matrix<ElemType>::ShallowCopyFrom(const Matrix<ElemType>& other)
     m_currentDataLocation       = other.m_currentDataLocation;
 
     m_preferredDeviceId         = other.m_preferredDeviceId;
+    m_residencyPolicy           = other.m_residencyPolicy;
     m_numTimesDeviceChanged     = other.m_numTimesDeviceChanged;
     m_numTimesMatrixTypeChanged = other.m_numTimesMatrixTypeChanged;
     m_devicesTransferedTo[0]    = other.m_devicesTransferedTo[0]; // TODO: spelling
@@ -752,54 +768,68 @@ Matrix<ElemType> Matrix<ElemType>::ColumnSlice(size_t startColumn, size_t numCol
 {
     int devId = GetDeviceId();
 
-    Matrix<ElemType> slice(matrixFlagDontOwnBuffer, (DEVICEID_TYPE) devId); // this already creates pointers
+    Matrix<ElemType> slice(matrixFlagDontOwnBuffer, (DEVICEID_TYPE) devId);
 
-    slice.m_preferredDeviceId = m_preferredDeviceId;
+    slice.AssignColumnSliceViewOf(*this, startColumn, numCols);
 
-    // create slices for the underlying object
+    return slice;
+}
+
+// re-point 'this' to be a non-owning view of a column range of 'fromMatrix'
+// This is the in-place form of ColumnSlice(): where ColumnSlice() constructs a fresh Matrix header
+// (one make_shared per live data location), this reuses the sub-objects that 'this' already holds,
+// so re-slicing through the same handle in a loop performs no heap allocation or shared_ptr
+// refcount traffic after the first call. Like ColumnSlice(), the view aliases fromMatrix's buffer;
+// it must not outlive it.
+template <class ElemType>
+Matrix<ElemType>& Matrix<ElemType>::AssignColumnSliceViewOf(const Matrix<ElemType>& fromMatrix, size_t startColumn, size_t numCols)
+{
+    m_preferredDeviceId = fromMatrix.m_preferredDeviceId;
+
+    // create slices for the underlying object, reusing our sub-objects where they already exist
     // Note: In case of data location == BOTH, this creates two objects just like in the source.
-    if (GetMatrixType() == MatrixType::DENSE)
+    if (fromMatrix.GetMatrixType() == MatrixType::DENSE)
     {
-        if (GetCurrentMatrixLocation() == CPU || GetCurrentMatrixLocation() == BOTH)
+        if (fromMatrix.GetCurrentMatrixLocation() == CPU || fromMatrix.GetCurrentMatrixLocation() == BOTH)
         {
-            if (slice.m_CPUMatrix)
-                slice.m_CPUMatrix->operator=(static_cast<CPUMatrix<ElemType>&&>(m_CPUMatrix->ColumnSlice(startColumn, numCols)));
+            if (m_CPUMatrix)
+                m_CPUMatrix->operator=(static_cast<CPUMatrix<ElemType>&&>(fromMatrix.m_CPUMatrix->ColumnSlice(startColumn, numCols)));
             else
-                slice.m_CPUMatrix = make_shared<CPUMatrix<ElemType>>(static_cast<CPUMatrix<ElemType>&&>(m_CPUMatrix->ColumnSlice(startColumn, numCols)));
+                m_CPUMatrix = make_shared<CPUMatrix<ElemType>>(static_cast<CPUMatrix<ElemType>&&>(fromMatrix.m_CPUMatrix->ColumnSlice(startColumn, numCols)));
         }
-        if (GetCurrentMatrixLocation() == GPU || GetCurrentMatrixLocation() == BOTH)
+        if (fromMatrix.GetCurrentMatrixLocation() == GPU || fromMatrix.GetCurrentMatrixLocation() == BOTH)
         {
-            if (slice.m_GPUMatrix)
-                slice.m_GPUMatrix->operator=(static_cast<GPUMatrix<ElemType>&&>(m_GPUMatrix->ColumnSlice(startColumn, numCols)));
+            if (m_GPUMatrix)
+                m_GPUMatrix->operator=(static_cast<GPUMatrix<ElemType>&&>(fromMatrix.m_GPUMatrix->ColumnSlice(startColumn, numCols)));
             else
-                slice.m_GPUMatrix = make_shared<GPUMatrix<ElemType>>(static_cast<GPUMatrix<ElemType>&&>(m_GPUMatrix->ColumnSlice(startColumn, numCols)));
+                m_GPUMatrix = make_shared<GPUMatrix<ElemType>>(static_cast<GPUMatrix<ElemType>&&>(fromMatrix.m_GPUMatrix->ColumnSlice(startColumn, numCols)));
         }
     }
-    else if (GetMatrixType() == MatrixType::SPARSE)
+    else if (fromMatrix.GetMatrixType() == MatrixType::SPARSE)
     {
-        if (GetCurrentMatrixLocation() == CPU || GetCurrentMatrixLocation() == BOTH)
+        if (fromMatrix.GetCurrentMatrixLocation() == CPU || fromMatrix.GetCurrentMatrixLocation() == BOTH)
         {
-            if (slice.m_CPUSparseMatrix)
-                slice.m_CPUSparseMatrix->operator=(static_cast<CPUSparseMatrix<ElemType>&&>(m_CPUSparseMatrix->ColumnSlice(startColumn, numCols)));
+            if (m_CPUSparseMatrix)
+                m_CPUSparseMatrix->operator=(static_cast<CPUSparseMatrix<ElemType>&&>(fromMatrix.m_CPUSparseMatrix->ColumnSlice(startColumn, numCols)));
             else
-                slice.m_CPUSparseMatrix = make_shared<CPUSparseMatrix<ElemType>>(static_cast<CPUSparseMatrix<ElemType>&&>(m_CPUSparseMatrix->ColumnSlice(startColumn, numCols)));
+                m_CPUSparseMatrix = make_shared<CPUSparseMatrix<ElemType>>(static_cast<CPUSparseMatrix<ElemType>&&>(fromMatrix.m_CPUSparseMatrix->ColumnSlice(startColumn, numCols)));
         }
-        if (GetCurrentMatrixLocation() == GPU || GetCurrentMatrixLocation() == BOTH)
+        if (fromMatrix.GetCurrentMatrixLocation() == GPU || fromMatrix.GetCurrentMatrixLocation() == BOTH)
         {
-            if (slice.m_GPUSparseMatrix)
-                slice.m_GPUSparseMatrix->operator=(static_cast<GPUSparseMatrix<ElemType>&&>(m_GPUSparseMatrix->ColumnSlice(startColumn, numCols)));
+            if (m_GPUSparseMatrix)
+                m_GPUSparseMatrix->operator=(static_cast<GPUSparseMatrix<ElemType>&&>(fromMatrix.m_GPUSparseMatrix->ColumnSlice(startColumn, numCols)));
             else
-                slice.m_GPUSparseMatrix = make_shared<GPUSparseMatrix<ElemType>>(static_cast<GPUSparseMatrix<ElemType>&&>(m_GPUSparseMatrix->ColumnSlice(startColumn, numCols)));
+                m_GPUSparseMatrix = make_shared<GPUSparseMatrix<ElemType>>(static_cast<GPUSparseMatrix<ElemType>&&>(fromMatrix.m_GPUSparseMatrix->ColumnSlice(startColumn, numCols)));
         }
     }
     else
         LogicError("Undetermined matrix type");
 
-    // update the slice's m_currentDataLocation, m_matrixType, and m_baseMatrix
+    // update our m_currentDataLocation, m_matrixType, and m_baseMatrix
     // This will work for CPU, GPU, and BOTH.
-    slice.SetDataLocation(GetCurrentMatrixLocation(), GetMatrixType());
+    SetDataLocation(fromMatrix.GetCurrentMatrixLocation(), fromMatrix.GetMatrixType());
 
-    return slice;
+    return *this;
 }
 
 template <class ElemType>
@@ -1360,6 +1390,34 @@ void Matrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYPE* h_CSCC
         { m_GPUSparseMatrix->SetMatrixFromCSCFormat(h_CSCCol, h_Row, h_Val, nz, numRows, numCols, false, -1, transferer); });
 }
 
+// Sets the matrix in block-sparse-column format: block j is the dense column blockIds[j], with its numRows values at val + j * numRows.
+// Used to rebuild block-sparse gradients (e.g. of an embedding matrix) from their touched blocks after aggregation.
+template <class ElemType>
+void Matrix<ElemType>::SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols)
+{
+    DISPATCH_MATRIX_ON_FLAG(this, this,
+        { NOT_IMPLEMENTED; },
+        { NOT_IMPLEMENTED; },
+        { m_CPUSparseMatrix->SetMatrixFromSBCFormat(blockIds, val, numBlocks, numRows, numCols); },
+        { m_GPUSparseMatrix->SetMatrixFromSBCFormat(blockIds, val, numBlocks, numRows, numCols); });
+}
+
+// Copies the stored blocks of a block-sparse-column matrix to host vectors: the column index of
+// each block and its numRows values, in matching order. GPU matrices are staged through a CPU copy.
+template <class ElemType>
+void Matrix<ElemType>::GetMatrixFromSBCFormat(std::vector<size_t>& blockIds, std::vector<ElemType>& val) const
+{
+    DISPATCH_MATRIX_ON_FLAG(this, nullptr,
+        { NOT_IMPLEMENTED; },
+        { NOT_IMPLEMENTED; },
+        { m_CPUSparseMatrix->GetMatrixFromSBCFormat(blockIds, val); },
+        {
+            CPUSparseMatrix<ElemType> stagingMatrix(matrixFormatSparseBlockCol);
+            m_GPUSparseMatrix->CopyToCPUSparseMatrix(stagingMatrix);
+            stagingMatrix.GetMatrixFromSBCFormat(blockIds, val);
+        });
+}
+
 template <class ElemType>
 void Matrix<ElemType>::SetDiagonalValue(const ElemType v)
 {
@@ -1550,6 +1608,51 @@ void Matrix<ElemType>::NormalGrad(Matrix<ElemType>& gradients,
     }
 }
 
+// Applies NormalGrad to a whole group of parameters in one call. When the group consists of
+// more than one set of dense GPU matrices that all reside on the same device, the update is
+// performed with a single batched kernel launch per chunk of tensors instead of several
+// launches per parameter; in all other cases it falls back to per-matrix NormalGrad.
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::BatchedNormalGrad(const std::vector<Matrix<ElemType>*>& smoothedGradients,
+                                                    const std::vector<Matrix<ElemType>*>& gradients,
+                                                    const std::vector<Matrix<ElemType>*>& functionValues,
+                                                    const ElemType learnRatePerSample,
+                                                    const ElemType momentum,
+                                                    const bool useNesterovMomentum)
+{
+    size_t numTensors = smoothedGradients.size();
+    if ((gradients.size() != numTensors) || (functionValues.size() != numTensors))
+        LogicError("BatchedNormalGrad: the tensor lists must have the same length.");
+
+    bool canBatch = (numTensors > 1);
+    DEVICEID_TYPE deviceId = canBatch ? smoothedGradients[0]->GetDeviceId() : CPUDEVICE;
+    for (size_t i = 0; canBatch && (i < numTensors); i++)
+    {
+        canBatch = (deviceId >= 0) &&
+                   (smoothedGradients[i]->GetMatrixType() == MatrixType::DENSE) && (smoothedGradients[i]->GetDeviceId() == deviceId) &&
+                   (gradients[i]->GetMatrixType() == MatrixType::DENSE) && (gradients[i]->GetDeviceId() == deviceId) &&
+                   (functionValues[i]->GetMatrixType() == MatrixType::DENSE) && (functionValues[i]->GetDeviceId() == deviceId);
+    }
+
+    if (!canBatch)
+    {
+        for (size_t i = 0; i < numTensors; i++)
+            smoothedGradients[i]->NormalGrad(*gradients[i], *functionValues[i], learnRatePerSample, momentum, useNesterovMomentum);
+        return;
+    }
+
+    std::vector<GPUMatrix<ElemType>*> smoothedGradientMatrices(numTensors), gradientMatrices(numTensors), functionValueMatrices(numTensors);
+    for (size_t i = 0; i < numTensors; i++)
+    {
+        smoothedGradientMatrices[i] = smoothedGradients[i]->m_GPUMatrix.get();
+        gradientMatrices[i] = gradients[i]->m_GPUMatrix.get();
+        functionValueMatrices[i] = functionValues[i]->m_GPUMatrix.get();
+    }
+
+    GPUMatrix<ElemType>::BatchedNormalGrad(smoothedGradientMatrices, gradientMatrices, functionValueMatrices,
+                                           learnRatePerSample, momentum, useNesterovMomentum);
+}
+
 // both 'this' and gradients will be changed
 template <class ElemType>
 ElemType Matrix<ElemType>::Adagrad(Matrix<ElemType>& gradients, const bool needAveMultiplier)
@@ -1589,7 +1692,7 @@ void Matrix<ElemType>::FSAdagradUpdate(size_t mbSize,
         { m_CPUMatrix->FSAdagrad(*gradients.m_CPUMatrix, *functionValues.m_CPUMatrix, (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum, targetAdagradAvDenom_x_sqrtAdagradSqrFrames); SetDataLocation(CPU); },
         { m_GPUMatrix->FSAdagrad(*gradients.m_GPUMatrix, *functionValues.m_GPUMatrix, (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum, targetAdagradAvDenom_x_sqrtAdagradSqrFrames); SetDataLocation(GPU); },
         { NOT_IMPLEMENTED; },
-        { NOT_IMPLEMENTED; });
+        { gradients.m_GPUSparseMatrix->FSAdagrad(*m_GPUMatrix, *functionValues.m_GPUMatrix, (ElemType)learnRatePerSample, (ElemType)meanMomentum, (ElemType)varMomentum, targetAdagradAvDenom_x_sqrtAdagradSqrFrames); SetDataLocation(GPU); });
     // Note: Since both 'this' and gradients are changed, we must call SetDataLocation() on 'this' as well.
 }
 
@@ -1632,7 +1735,7 @@ void Matrix<ElemType>::Resize(const size_t numRows, const size_t numCols, const
 {
     // TODO: should this function test whether the size is changing, and skip if it isn't? We have at least one explicit test for this code calling this (recurrent node)
     DISPATCH_MATRIX_ON_FLAG_USEBOTH_4BOTH(this,
-        { m_CPUMatrix->Resize(numRows, numCols, growOnly); },
+        { m_CPUMatrix->Resize(numRows, numCols, growOnly, m_useCachedResize); },
         { m_GPUMatrix->Resize(numRows, numCols, growOnly, m_useCachedResize); },
         { m_CPUSparseMatrix->RequireSizeAndAllocate(numRows, numCols, numNZElemToReserve, growOnly, false); },
         { m_GPUSparseMatrix->RequireSizeAndAllocate(numRows, numCols, numNZElemToReserve, growOnly, false); });
@@ -3373,6 +3476,24 @@ ElemType Matrix<ElemType>::FrobeniusNorm() const
                             return m_GPUSparseMatrix->FrobeniusNorm());
 }
 
+// Frobenius norm left on the compute device; avoids the device-to-host sync of FrobeniusNorm()
+template <class ElemType>
+DeviceBoundNumber<ElemType> Matrix<ElemType>::FrobeniusNorm_AsDeviceBoundNum() const
+{
+    if (IsEmpty())
+        LogicError("FrobeniusNorm: Matrix is empty.");
+
+    DeviceBoundNumber<ElemType> result;
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            nullptr,
+                            ElemType* val = new ElemType;
+                                * val = m_CPUMatrix->FrobeniusNorm(); result.ShallowCopyFrom(val, -1); return result,
+                                                                                                              return m_GPUMatrix->FrobeniusNorm_AsDeviceBoundNum(),
+                                                                                                              NOT_IMPLEMENTED,
+                                                                                                              NOT_IMPLEMENTED);
+}
+
 template <class ElemType>
 Matrix<ElemType>& Matrix<ElemType>::AssignFrobeniusNormOf(const Matrix<ElemType>& a)
 {
@@ -3682,6 +3803,19 @@ void Matrix<ElemType>::_transferFromDeviceToDevice(int from_id, int to_id, bool
         return;
     }
 
+    // enforce the residency policy: every device transfer funnels through here, so this is the
+    // one place where a locked-down matrix can catch a stray code path trying to move it
+    if (m_residencyPolicy != residencyPolicyAuto)
+        RuntimeError("Attempt to transfer a %s [%lu x %lu] matrix from device %d to device %d.",
+                     m_residencyPolicy == residencyPolicyPinned ? "device-pinned" : "residency-strict",
+                     (unsigned long) GetNumRows(), (unsigned long) GetNumCols(), from_id, to_id);
+    if (!emptyTransfer)
+        m_numMatrixDeviceTransfers++; // audit counter: data actually crosses the bus
+
+    // count and time the transfer, so hidden CPU<->GPU ping-ponging caused by the automatic
+    // location management can be quantified (see HotPathCounters.h)
+    HOTPATH_TIMER_BEGIN(transferStartTicks);
+
     // warn about device change
 #define NUM_DEVICE_CHANGED_WARN 20
     if (m_numTimesDeviceChanged <= NUM_DEVICE_CHANGED_WARN &&
@@ -3829,6 +3963,12 @@ void Matrix<ElemType>::_transferFromDeviceToDevice(int from_id, int to_id, bool
             }
         }
     } // and of omp critical section
+
+    HOTPATH_TIMER_END(transferStartTicks,
+                      from_id == CPUDEVICE ? hotpathMatrixTransferToGpu
+                                           : to_id == CPUDEVICE ? hotpathMatrixTransferToCpu
+                                                                : hotpathMatrixTransferGpuToGpu,
+                      emptyTransfer ? 0 : GetNumElements());
 }
 
 template <class ElemType>
@@ -3838,6 +3978,17 @@ void Matrix<ElemType>::TransferFromDeviceToDevice(int from_id, int to_id, bool i
     if (updatePreferredDevice)
         m_preferredDeviceId = GetDeviceId();
 }
+// Pin the matrix to a device: move it there now (an explicit, sanctioned transfer), then make
+// any later transfer away an error. For hot matrices in production graphs that must never pay
+// hidden PCIe traffic.
+template <class ElemType>
+void Matrix<ElemType>::PinToDevice(DEVICEID_TYPE deviceId)
+{
+    m_residencyPolicy = residencyPolicyAuto; // the move itself is sanctioned
+    TransferToDeviceIfNotThere(deviceId, true /*isBeingMoved: collapse a BOTH state*/);
+    m_residencyPolicy = residencyPolicyPinned;
+}
+
 template <class ElemType>
 void Matrix<ElemType>::TransferToDeviceIfNotThere(int to_id, bool isBeingMoved/*false: may leave in BOTH state*/, bool emptyTransfer/* = false*/, bool updatePreferredDevice/* = true*/) const
 {
@@ -4425,6 +4576,41 @@ void Matrix<ElemType>::BatchNormalizationBackward(const Matrix<ElemType>& in, Ma
                             NOT_IMPLEMENTED);
 }
 
+template <class ElemType>
+void Matrix<ElemType>::LayerNormalizationForward(const Matrix<ElemType>& scale, const Matrix<ElemType>& bias, Matrix<ElemType>& out, double epsilon,
+                                                 Matrix<ElemType>& saveMean, Matrix<ElemType>& saveInvStdDev) const
+{
+    DecideAndMoveToRightDevice(*this, out);
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            this,
+                            m_CPUMatrix->LayerNormalizationForward(*(scale.m_CPUMatrix), *(bias.m_CPUMatrix), *(out.m_CPUMatrix), epsilon,
+                                                                   *(saveMean.m_CPUMatrix), *(saveInvStdDev.m_CPUMatrix)),
+                            m_GPUMatrix->LayerNormalizationForward(*(scale.m_GPUMatrix), *(bias.m_GPUMatrix), *(out.m_GPUMatrix), epsilon,
+                                                                   *(saveMean.m_GPUMatrix), *(saveInvStdDev.m_GPUMatrix)),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+template <class ElemType>
+void Matrix<ElemType>::LayerNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<ElemType>& scale,
+                                                  const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev,
+                                                  Matrix<ElemType>& scaleGrad, Matrix<ElemType>& biasGrad) const
+{
+    DecideAndMoveToRightDevice(*this, grad);
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            this,
+                            m_CPUMatrix->LayerNormalizationBackward(*(in.m_CPUMatrix), *(grad.m_CPUMatrix), *(scale.m_CPUMatrix),
+                                                                    *(saveMean.m_CPUMatrix), *(saveInvStdDev.m_CPUMatrix),
+                                                                    *(scaleGrad.m_CPUMatrix), *(biasGrad.m_CPUMatrix)),
+                            m_GPUMatrix->LayerNormalizationBackward(*(in.m_GPUMatrix), *(grad.m_GPUMatrix), *(scale.m_GPUMatrix),
+                                                                    *(saveMean.m_GPUMatrix), *(saveInvStdDev.m_GPUMatrix),
+                                                                    *(scaleGrad.m_GPUMatrix), *(biasGrad.m_GPUMatrix)),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
 template <class ElemType>
 void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<ElemType> &paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace)
 {
@@ -4654,6 +4840,52 @@ void Matrix<ElemType>::MultiplyAndWeightedAdd(ElemType alpha, const Matrix<ElemT
     }
 }
 
+/// <summary>Batched matrix-matrix multiply: numBatches GEMMs of identical shape, stored as equal
+/// column blocks of a, b and c; block i of c = op(block i of a) * op(block i of b) + beta * block i of c.
+/// On the CPU this drives a single batched BLAS call instead of numBatches dispatches.</summary>
+template <class ElemType>
+void Matrix<ElemType>::BatchedMultiplyAndWeightedAdd(ElemType alpha, const Matrix<ElemType>& a, const bool transposeA, const Matrix<ElemType>& b, const bool transposeB,
+                                                     ElemType beta, Matrix<ElemType>& c, const size_t numBatches)
+{
+    DecideAndMoveToRightDevice(a, b, c);
+
+    if (a.GetMatrixType() != MatrixType::DENSE || b.GetMatrixType() != MatrixType::DENSE || c.GetMatrixType() != MatrixType::DENSE)
+        NOT_IMPLEMENTED;
+
+    if (c.GetDeviceId() < 0) // CPU
+    {
+        CPUMatrix<ElemType>::BatchedMultiplyAndWeightedAdd(alpha, *a.m_CPUMatrix, transposeA, *b.m_CPUMatrix, transposeB, beta, *c.m_CPUMatrix, numBatches);
+        c.SetDataLocation(CPU, DENSE);
+    }
+    else // GPU: no batched kernel is wired up here, so issue the batch as per-block GEMMs on column slices.
+    {
+        if (numBatches == 0 || a.GetNumCols() % numBatches != 0 || b.GetNumCols() % numBatches != 0)
+            InvalidArgument("BatchedMultiplyAndWeightedAdd: The number of columns of a (= %lu) and b (= %lu) must be multiples of numBatches (= %lu).",
+                            a.GetNumCols(), b.GetNumCols(), numBatches);
+
+        size_t aColsPerBatch = a.GetNumCols() / numBatches;
+        size_t bColsPerBatch = b.GetNumCols() / numBatches;
+        size_t m = transposeA ? aColsPerBatch : a.GetNumRows();
+        size_t n = transposeB ? b.GetNumRows() : bColsPerBatch;
+
+        if (beta == 0)
+        {
+            if (c.GetNumRows() != m || c.GetNumCols() != n * numBatches)
+                c.Resize(m, n * numBatches);
+        }
+        else
+            c.VerifySize(m, n * numBatches); // Can't resize if beta != 0
+
+        for (size_t i = 0; i < numBatches; i++)
+        {
+            auto aSlice = a.ColumnSlice(i * aColsPerBatch, aColsPerBatch);
+            auto bSlice = b.ColumnSlice(i * bColsPerBatch, bColsPerBatch);
+            auto cSlice = c.ColumnSlice(i * n, n);
+            MultiplyAndWeightedAdd(alpha, aSlice, transposeA, bSlice, transposeB, beta, cSlice);
+        }
+    }
+}
+
 template <class ElemType>
 /*static*/ void Matrix<ElemType>::Multiply1x1AndWeightedAdd(ElemType alpha, const Matrix<ElemType>& a, const Matrix<ElemType>& b, ElemType beta, Matrix<ElemType>& c)
 {
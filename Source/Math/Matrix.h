@@ -38,6 +38,20 @@ enum CurrentDataLocation
     BOTH
 };
 
+// device-residency policy of a matrix (see Matrix::PinToDevice() and Matrix::SetResidencyStrict())
+enum MatrixResidencyPolicy
+{
+    residencyPolicyAuto = 0,   // default: the automatic location management may transfer freely
+    residencyPolicyPinned = 1, // pinned to a device via PinToDevice(); any transfer away is an error
+    residencyPolicyStrict = 2  // any further device transfer of this matrix is an error
+};
+
+// Audit counter: total number of data-carrying device transfers performed by any Matrix since
+// process start or the last reset. Production graphs can assert that it stays flat across steps
+// to guarantee zero hidden PCIe traffic.
+MATH_API unsigned long long GetNumMatrixDeviceTransfers();
+MATH_API void ResetNumMatrixDeviceTransfers();
+
 enum MatrixType
 {
     UNDETERMINED,
@@ -82,6 +96,7 @@ private:
     mutable CurrentDataLocation m_currentDataLocation; // Indicates which matrix is current
 
     mutable DEVICEID_TYPE m_preferredDeviceId;
+    MatrixResidencyPolicy m_residencyPolicy; // enforced in _transferFromDeviceToDevice(), the choke point of all transfers
     mutable size_t m_numTimesDeviceChanged;
     mutable size_t m_numTimesMatrixTypeChanged;
     mutable int m_devicesTransferedTo[2]; // TODO: what is this for? Seems only diagnostics
@@ -175,6 +190,12 @@ public:
     // Same as TransferFromDeviceToDevice() but moves only if it is currently not on the target device
     void TransferToDeviceIfNotThere(int id_to, bool isBeingMoved = false, bool emptyTransfer = false, bool updatePreferredDevice = true) const;
     CurrentDataLocation GetCurrentMatrixLocation() const { return m_currentDataLocation; };
+    // residency policy: lock a matrix down so that stray code paths (e.g. a Get00Element in a
+    // logging statement) cannot silently bounce it between CPU and GPU
+    void PinToDevice(DEVICEID_TYPE deviceId); // move there now, then fail on any transfer away
+    void SetResidencyStrict() { m_residencyPolicy = residencyPolicyStrict; } // fail on any further transfer, wherever the matrix lives now
+    void ResetResidencyPolicy() { m_residencyPolicy = residencyPolicyAuto; }
+    MatrixResidencyPolicy GetResidencyPolicy() const { return m_residencyPolicy; }
     void SwitchToMatrixType(MatrixType newMatrixType, MatrixFormat newMatrixFormat, bool keepValues); // sets matrix type between dense and sparse
     size_t GetNumRows() const;
     size_t GetNumCols() const;
@@ -201,6 +222,12 @@ public:
     Matrix<ElemType>& AssignColumnSlice(const Matrix<ElemType>& fromMatrix, size_t startColumn, size_t numCols);
     Matrix<ElemType>& SetColumnSlice(const Matrix<ElemType>& fromMatrix, size_t startColumn, size_t numCols);
 
+    // AssignColumnSliceViewOf: in-place form of ColumnSlice(). Re-points 'this' at
+    // fromMatrix(:, startColumn:startColumn+numCols-1) without taking ownership, reusing the
+    // sub-objects 'this' already holds. Re-slicing through the same handle in a loop therefore
+    // performs no allocation, unlike ColumnSlice() which constructs a new Matrix header each call.
+    Matrix<ElemType>& AssignColumnSliceViewOf(const Matrix<ElemType>& fromMatrix, size_t startColumn, size_t numCols);
+
     void CopyColumnsStrided(const Matrix<ElemType>& fromMatrix, size_t numCols, size_t srcNumColsStride, size_t destNumColsStride);
 
     Matrix<ElemType> Diagonal() const;
@@ -208,6 +235,8 @@ public:
 
     // TODO: all these scalars should be passed as doubles and cast down inside
     void NormalGrad(Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, const ElemType learnRatePerSample, const ElemType momentum, const bool useNAG);
+    static void BatchedNormalGrad(const std::vector<Matrix<ElemType>*>& smoothedGradients, const std::vector<Matrix<ElemType>*>& gradients, const std::vector<Matrix<ElemType>*>& functionValues,
+                                  const ElemType learnRatePerSample, const ElemType momentum, const bool useNAG);
     ElemType Adagrad(Matrix<ElemType>& gradients, const bool needAveMultiplier);
     void FSAdagradUpdate(size_t mbSize,
                          Matrix<ElemType>& gradients, Matrix<ElemType>& functionValues, double& smoothedCount,
@@ -277,6 +306,8 @@ public:
     }
     void SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYPE* h_CSCCol, const CPUSPARSE_INDEX_TYPE* h_Row, const ElemType* h_Val,
         const size_t nz, const size_t numRows, const size_t numCols, DataTransferer* transferer = nullptr);
+    void SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols);
+    void GetMatrixFromSBCFormat(std::vector<size_t>& blockIds, std::vector<ElemType>& val) const;
 
     void MaskColumnsValue(const Matrix<char>& columnsMask, ElemType val);
 
@@ -447,6 +478,7 @@ public:
     Matrix<ElemType>& AddWithScaleOf(ElemType alpha, const Matrix<ElemType>& a); // this += alpha * a
 
     ElemType FrobeniusNorm() const;
+    DeviceBoundNumber<ElemType> FrobeniusNorm_AsDeviceBoundNum() const;
     Matrix<ElemType>& AssignFrobeniusNormOf(const Matrix<ElemType>& a);
 
     ElemType MatrixNormInf() const;
@@ -533,6 +565,11 @@ public:
     void BatchNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<ElemType>& scale, double blendFactor, const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev,
                                     Matrix<ElemType>& scaleGrad, Matrix<ElemType>& biasGrad) const;
 
+    void LayerNormalizationForward(const Matrix<ElemType>& scale, const Matrix<ElemType>& bias, Matrix<ElemType>& out, double epsilon,
+                                   Matrix<ElemType>& saveMean, Matrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<ElemType>& scale, const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev,
+                                    Matrix<ElemType>& scaleGrad, Matrix<ElemType>& biasGrad) const;
+
     void RNNForward(const Matrix<ElemType>& inputX, const Matrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
     void RNNBackwardData(const Matrix<ElemType>& outputDY, const Matrix<ElemType>& paramW, Matrix<ElemType>& outputDX, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
     void RNNBackwardWeights(const Matrix<ElemType>& inputX, const Matrix<ElemType>& outputY, Matrix<ElemType>& dw, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
@@ -550,6 +587,7 @@ public:
     static void SVD(const Matrix<ElemType>& A, Matrix<ElemType>& SIGMA, Matrix<ElemType>& U, Matrix<ElemType>& VT, Matrix<ElemType>& W);
 
     static void MultiplyAndWeightedAdd(ElemType alpha, const Matrix<ElemType>& a, const bool transposeA, const Matrix<ElemType>& b, const bool transposeB, ElemType beta, Matrix<ElemType>& c, shared_ptr<QuantizedMultiplier<ElemType>> pQuantizedMultiplier=nullptr); // SGEMM
+    static void BatchedMultiplyAndWeightedAdd(ElemType alpha, const Matrix<ElemType>& a, const bool transposeA, const Matrix<ElemType>& b, const bool transposeB, ElemType beta, Matrix<ElemType>& c, const size_t numBatches); // batch of equal-shape GEMMs stored as column blocks
     static void MultiplyAndAdd(const Matrix<ElemType>& a, const bool transposeA, const Matrix<ElemType>& b, const bool transposeB, Matrix<ElemType>& c);
     static void Multiply(const Matrix<ElemType>& a, const bool transposeA, const Matrix<ElemType>& b, const bool transposeB, Matrix<ElemType>& c);
     static void Multiply(const Matrix<ElemType>& a, const Matrix<ElemType>& b, Matrix<ElemType>& c);
@@ -646,4 +684,21 @@ File& operator<<(File& stream, const Matrix<ElemType>& M)
 typedef Matrix<float> SingleMatrix;
 typedef Matrix<double> DoubleMatrix;
 
+// -----------------------------------------------------------------------
+// Compute-stream pool -- opaque facade over CUDA streams and events for
+// stream-parallel graph execution (see PARTraversalFlowControlNode).
+// All of these are no-ops in CPUONLY builds.
+// -----------------------------------------------------------------------
+
+// Routes subsequent GPU math calls to the pool stream with the given index; -1 restores the default compute stream.
+MATH_API void SetPooledComputeStream(int streamIndex);
+// Makes the first numStreams pool streams wait for all work queued on the current compute stream.
+MATH_API void ForkPooledComputeStreams(size_t numStreams);
+// Makes the current compute stream wait until all pool streams have drained.
+MATH_API void JoinPooledComputeStreams();
+// Records the event with the given id on the current compute stream.
+MATH_API void RecordComputeStreamEvent(size_t eventId);
+// Makes the current compute stream wait for the event with the given id (no-op if it was never recorded).
+MATH_API void WaitForComputeStreamEvent(size_t eventId);
+
 }}}
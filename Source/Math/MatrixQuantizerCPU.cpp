@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "MatrixQuantizerCPU.h"
+#include <cmath>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -11,6 +12,21 @@ MatrixQuantizerCPU<ElemType>::MatrixQuantizerCPU()
 
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatrix, const Matrix<ElemType>& inResidual, QuantizedMatrix<ElemType>& outQMatrix, Matrix<ElemType>& outResidual, bool zeroThresholdFor1Bit)
+{
+    // only one quantize operation may be in flight per quantizer instance
+    if (m_quantizeOp.valid())
+        m_quantizeOp.get();
+
+    // run the quantization on a background task so the caller can overlap quantization of
+    // several gradient matrices (or other work) before synchronizing in WaitQuantizeAsyncDone()
+    m_quantizeOp = std::async(std::launch::async, [this, &inMatrix, &inResidual, &outQMatrix, &outResidual, zeroThresholdFor1Bit]()
+    {
+        QuantizeSync(inMatrix, inResidual, outQMatrix, outResidual, zeroThresholdFor1Bit);
+    });
+}
+
+template <class ElemType>
+void MatrixQuantizerCPU<ElemType>::QuantizeSync(const Matrix<ElemType>& inMatrix, const Matrix<ElemType>& inResidual, QuantizedMatrix<ElemType>& outQMatrix, Matrix<ElemType>& outResidual, bool zeroThresholdFor1Bit)
 {
     // The outQMatrix should be on the CPU
     // TODO: Support transferring the quantization output to a quantized matrix on the GPU
@@ -27,22 +43,70 @@ void MatrixQuantizerCPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatri
     assert((outResidual.GetNumRows() == nRow) && (outResidual.GetNumCols() == nCol));
 
     const size_t ldNbits = ValueQuantizer<ElemType>::ld(nBits);
-#ifdef QUANTUSEPPL
-    Concurrency::parallel_for((size_t) 0, us.cols(), [&](size_t j)
-#else
-    for (size_t j = 0; j < nCol; j++)
-#endif
+
+    // Decide whether this call may reuse the cached per-column ranges. Gradient ranges drift
+    // slowly in steady-state training, so with a recompute stride of N only every N-th call pays
+    // for the range-statistics pass over the data; in between, the cached range is used and the
+    // quantization is a single pass. The cache is only valid for a same-shaped matrix quantized
+    // at the same bit width; a stride of 0 (the default) recomputes on every call, as before.
+    const size_t rangeStride = this->GetRangeRecomputeStride();
+    if ((rangeStride > 1) && ((m_cachedNumRows != nRow) || (m_cachedNumBits != nBits) || (m_cachedLower.size() != nCol)))
+    {
+        m_cachedLower.assign(nCol, (ElemType) 0);
+        m_cachedUpper.assign(nCol, (ElemType) 0);
+        m_cachedNumRows = nRow;
+        m_cachedNumBits = nBits;
+        m_cachePrimed = false;
+    }
+    const bool useCachedRange = (rangeStride > 1) && m_cachePrimed && !m_forceExactNextCall &&
+                                ((m_numQuantizeCalls % rangeStride) != 0);
+    m_numQuantizeCalls++;
+    if (!useCachedRange)
+        m_forceExactNextCall = false;
+    // weight of the freshly computed range when blending it into the cache
+    const ElemType emaWeight = (ElemType) 0.5;
+
+    // each column is quantized independently, so partition the column range across the OpenMP
+    // worker pool; the cache updates below are per-column and therefore race-free
+    int sawOverflow = 0;
+#pragma omp parallel for reduction(|| : sawOverflow)
+    for (long j = 0; j < (long) nCol; j++)
     {
         auto& qcol = *(outQMatrix.GetQuantizedColumn(j));
-        if (zeroThresholdFor1Bit)
+        if (useCachedRange)
         {
-            // Explicit use of 'template' keyword is needed to compile with GCC
-            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<true>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            qcol.lower = m_cachedLower[j];
+            qcol.upper = m_cachedUpper[j];
         }
         else
         {
-            // Explicit use of 'template' keyword is needed to compile with GCC
-            ColumnQuantizer<ElemType>::template ComputeRangeStatColj<false>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            if (zeroThresholdFor1Bit)
+            {
+                // Explicit use of 'template' keyword is needed to compile with GCC
+                ColumnQuantizer<ElemType>::template ComputeRangeStatColj<true>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            }
+            else
+            {
+                // Explicit use of 'template' keyword is needed to compile with GCC
+                ColumnQuantizer<ElemType>::template ComputeRangeStatColj<false>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, nBits, qcol.lower, qcol.upper);
+            }
+
+            if (rangeStride > 1)
+            {
+                if (m_cachePrimed)
+                {
+                    // fold the fresh statistics into the cache as an exponential moving average
+                    m_cachedLower[j] = ((1 - emaWeight) * m_cachedLower[j]) + (emaWeight * qcol.lower);
+                    m_cachedUpper[j] = ((1 - emaWeight) * m_cachedUpper[j]) + (emaWeight * qcol.upper);
+                    qcol.lower = m_cachedLower[j];
+                    qcol.upper = m_cachedUpper[j];
+                }
+                else
+                {
+                    m_cachedLower[j] = qcol.lower;
+                    m_cachedUpper[j] = qcol.upper;
+                }
+            }
         }
 
         ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
@@ -56,21 +120,56 @@ void MatrixQuantizerCPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatri
             // Explicit use of 'template' keyword is needed to compile with GCC
             q.template Quantize<false>(inMatrix.Data(), inResidual.Data(), (long) nRow, j, qcol.bits, outResidual.Data());
         }
+
+        // overflow detection: a value far outside the cached range is clamped and leaves a
+        // residual larger than the whole range width; sample the freshly written (cache-warm)
+        // residual column and, if that happened, recompute this matrix's ranges exactly on the
+        // next call. No gradient mass is lost in the meantime -- the clamped part stays in the
+        // residual and is shipped once the range has caught up.
+        if (useCachedRange && !sawOverflow)
+        {
+            const ElemType rangeWidth = qcol.upper - qcol.lower;
+            const ElemType* residualCol = outResidual.Data() + (j * nRow);
+            for (size_t i = 0; i < nRow; i += 16)
+            {
+                if (std::abs(residualCol[i]) > rangeWidth)
+                {
+                    sawOverflow = 1;
+                    break;
+                }
+            }
+        }
     }
-#ifdef QUANTUSEPPL
-    );
-#endif
+
+    if (sawOverflow)
+        m_forceExactNextCall = true;
+    if (!useCachedRange && rangeStride > 1)
+        m_cachePrimed = true;
 }
 
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::WaitQuantizeAsyncDone()
 {
-    // TODO: Currently this is a no-op since the actual quantization is synchronous
+    if (m_quantizeOp.valid())
+        m_quantizeOp.get();
 }
 
 // unquantize an entire matrix, calling unquantize() for each column
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::UnquantizeAsync(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add /*= false*/)
+{
+    // only one unquantize operation may be in flight per quantizer instance
+    if (m_unquantizeOp.valid())
+        m_unquantizeOp.get();
+
+    m_unquantizeOp = std::async(std::launch::async, [this, &inQMatrix, &outMatrix, add]()
+    {
+        UnquantizeSync(inQMatrix, outMatrix, add);
+    });
+}
+
+template <class ElemType>
+void MatrixQuantizerCPU<ElemType>::UnquantizeSync(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add)
 {
     // The inQMatrix and hould be on the CPU
     assert(inQMatrix.GetDeviceId() == CPUDEVICE);
@@ -84,25 +183,20 @@ void MatrixQuantizerCPU<ElemType>::UnquantizeAsync(QuantizedMatrix<ElemType>& in
     assert((outMatrix.GetNumRows() == nRow) && (outMatrix.GetNumCols() == nCol));
 
     const size_t ldNbits = ValueQuantizer<ElemType>::ld(nBits);
-#ifdef QUANTUSEPPL
-    Concurrency::parallel_for((size_t) 0, us.cols(), [&](size_t j)
-#else
-    for (size_t j = 0; j < nCol; j++)
-#endif
+#pragma omp parallel for
+    for (long j = 0; j < (long) nCol; j++)
     {
         const auto& qcol = *(inQMatrix.GetQuantizedColumn(j));
         ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
         q.Unquantize(outMatrix.Data(), (long) nRow, j, qcol.bits, add);
     }
-#ifdef QUANTUSEPPL
-    );
-#endif
 }
 
 template <class ElemType>
 void MatrixQuantizerCPU<ElemType>::WaitUnquantizeAsyncDone()
 {
-    // TODO: Currently this is a no-op since the actual quantization is synchronous
+    if (m_unquantizeOp.valid())
+        m_unquantizeOp.get();
 }
 
 //The explicit instantiation part will make the linker happy
@@ -4,6 +4,7 @@
 #include "ColumnQuantizer.h"
 #include "QuantizedMatrix.h"
 #include "CPUMatrix.h"
+#include <future>
 
 #ifdef _WIN32
 #ifdef MATH_EXPORTS
@@ -33,5 +34,25 @@ public:
 
     void UnquantizeAsync(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add = false) override;
     void WaitUnquantizeAsyncDone() override;
+
+private:
+    // synchronous bodies, executed on a background task by the Async entry points; the per-column
+    // loops inside are partitioned across the OpenMP worker pool
+    void QuantizeSync(const Matrix<ElemType>& inMatrix, const Matrix<ElemType>& inResidual, QuantizedMatrix<ElemType>& outQMatrix, Matrix<ElemType>& outResidual, bool zeroThresholdFor1Bit);
+    void UnquantizeSync(QuantizedMatrix<ElemType>& inQMatrix, Matrix<ElemType>& outMatrix, bool add);
+
+    // in-flight background operations; the caller must keep the matrices alive until the
+    // corresponding Wait*AsyncDone() returns (same contract as the GPU quantizer's streams)
+    std::future<void> m_quantizeOp;
+    std::future<void> m_unquantizeOp;
+    // per-column quantization range cache (see SetRangeRecomputeStride()); on most calls the
+    // cached range is reused, skipping the range-statistics pass over the gradient data
+    std::vector<ElemType> m_cachedLower;
+    std::vector<ElemType> m_cachedUpper;
+    size_t m_cachedNumRows = 0;
+    size_t m_cachedNumBits = 0;
+    size_t m_numQuantizeCalls = 0;
+    bool m_cachePrimed = false;
+    bool m_forceExactNextCall = false;
 };
 } } }
@@ -251,21 +251,51 @@ void MatrixQuantizerGPU<ElemType>::QuantizeAsync(const Matrix<ElemType>& inMatri
         cudaStreamWaitEvent(GetComputeStream(), m_tempMatrixZeroingCompleteEvent, 0 /*flags 'must be 0'*/) || "cudaStreamWaitEvent failed";
     }
 
-    // Do the quantization on compute sstream and insert event into stream
-    _QuantizeMatrix<ElemType>(inMatrix.Data(), inResidual.Data(),
-                              inMatrix.GetNumRows(), inMatrix.GetNumCols(),
-                              outQMatrixGPU.Buffer(), nBits, GetComputeStream(),
-                              outResidual.Data(), zeroThresholdFor1Bit);
-
-    RecordQuantizeCompleteEvent(GetComputeStream());
-
-    // copy from gpu to cpu if needed
+    size_t numRows = inMatrix.GetNumRows();
+    size_t numCols = inMatrix.GetNumCols();
     m_quantizeOpIncludedFetch = false;
-    if (outQMatrix.GetDeviceId() == CPUDEVICE)
+    if (outQMatrix.GetDeviceId() == CPUDEVICE && numCols > 1)
     {
-        SyncQuantizeCompleEventAndFetchAndRecordFetchCompleteEvent(outQMatrix.Buffer(), outQMatrixGPU.Buffer(), outQMatrixGPU.GetSize());
+        // Quantize in column chunks and fetch each chunk as soon as it completes, so the
+        // device-to-host copy of chunk k-1 overlaps the quantization of chunk k on the compute
+        // stream. For large gradients this hides nearly the entire quantization time behind
+        // the transfer (or vice versa, whichever is shorter). Reusing the single
+        // quantize-complete event per chunk is safe since each cudaStreamWaitEvent() is
+        // scheduled before the event is recorded again.
+        const size_t chunkBytes = 1 << 22; // ~4 MB of input per chunk keeps the kernel efficient
+        size_t chunkCols = std::max((size_t) 1, chunkBytes / (numRows * sizeof(ElemType)));
+        const size_t qColSize = QuantizedColumn<ElemType>::QuantizedColumnSize(nBits, numRows);
+        for (size_t j0 = 0; j0 < numCols; j0 += chunkCols)
+        {
+            size_t cols = std::min(chunkCols, numCols - j0);
+            _QuantizeMatrix<ElemType>(inMatrix.Data() + (j0 * numRows), inResidual.Data() + (j0 * numRows),
+                                      numRows, cols,
+                                      outQMatrixGPU.Buffer() + (j0 * qColSize), nBits, GetComputeStream(),
+                                      outResidual.Data() + (j0 * numRows), zeroThresholdFor1Bit);
+
+            RecordQuantizeCompleteEvent(GetComputeStream());
+
+            SyncQuantizeCompleEventAndFetchAndRecordFetchCompleteEvent(outQMatrix.Buffer() + (j0 * qColSize), outQMatrixGPU.Buffer() + (j0 * qColSize), cols * qColSize);
+        }
         m_quantizeOpIncludedFetch = true;
     }
+    else
+    {
+        // Do the quantization on compute sstream and insert event into stream
+        _QuantizeMatrix<ElemType>(inMatrix.Data(), inResidual.Data(),
+                                  numRows, numCols,
+                                  outQMatrixGPU.Buffer(), nBits, GetComputeStream(),
+                                  outResidual.Data(), zeroThresholdFor1Bit);
+
+        RecordQuantizeCompleteEvent(GetComputeStream());
+
+        // copy from gpu to cpu if needed
+        if (outQMatrix.GetDeviceId() == CPUDEVICE)
+        {
+            SyncQuantizeCompleEventAndFetchAndRecordFetchCompleteEvent(outQMatrix.Buffer(), outQMatrixGPU.Buffer(), outQMatrixGPU.GetSize());
+            m_quantizeOpIncludedFetch = true;
+        }
+    }
 }
 
 template <class ElemType>
@@ -6,6 +6,9 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+template <class ElemType>
+/*static*/ size_t MatrixQuantizerImpl<ElemType>::s_rangeRecomputeStride = 0;
+
 template <class ElemType>
 /*static*/ MatrixQuantizerImpl<ElemType>* MatrixQuantizerImpl<ElemType>::Create(int deviceId, bool useAsync)
 {
@@ -38,6 +38,19 @@ public:
         return m_deviceId;
     }
 
+    // Gradient ranges drift slowly in steady-state training, so implementations may cache the
+    // per-column quantization range and only recompute it exactly every 'stride' calls, blending
+    // the fresh statistics into the cache as an exponential moving average. 0 (the default)
+    // recomputes on every call, i.e. caching is off.
+    static void SetRangeRecomputeStride(size_t stride)
+    {
+        s_rangeRecomputeStride = stride;
+    }
+    static size_t GetRangeRecomputeStride()
+    {
+        return s_rangeRecomputeStride;
+    }
+
 protected:
     MatrixQuantizerImpl(int deviceId)
         : m_deviceId(deviceId)
@@ -46,6 +59,8 @@ protected:
 
 private:
     int m_deviceId;
+
+    static size_t s_rangeRecomputeStride;
 };
 
 // This type records and synchronizes events on the main
@@ -9,6 +9,7 @@
 #include "GPUMatrix.h"
 #include <nccl.h>
 #include <cuda_runtime.h>
+#include <cstring>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -20,54 +21,123 @@ static void operator||(cudaError_t rc, const char *msg)
 }
 
 NcclComm::NcclComm(int deviceId, const MPIWrapperPtr& mpi)
-    : m_ncclComm(nullptr), m_stream(nullptr)
+    : m_ncclComm(nullptr), m_stream(nullptr), m_hierarchical(false), m_isLocalLeader(false),
+      m_leaderComm(MPI_COMM_NULL), m_hostBuffer(nullptr), m_hostBufferBytes(0)
 {
-    if (mpi->IsMultiHost())
-        return;
-
     size_t numRanks = mpi->NumNodesInUse();
     MPI_Comm mpiComm = mpi->Communicator();
-    std::vector<int> allDevs(numRanks);
-    MPI_Allgather(&deviceId, 1, MPI_INT, allDevs.data(), 1, MPI_INT, mpiComm)
+    int myRank = (int) mpi->CurrentNodeRank();
+
+    // On multi-host runs the NCCL communicator only spans the ranks of the local host; reductions
+    // then run in two levels (see AllReduceHierarchicalImpl). On a single host it spans all ranks
+    // and AllReduce is a plain ncclAllReduce.
+    MPI_Comm localComm = mpiComm;
+    size_t numLocalRanks = numRanks;
+    int localRank = myRank;
+    if (mpi->IsMultiHost())
+    {
+        // group the ranks by host, the same way MPIWrapper detects multi-host runs
+        const int nameMax = MPI_MAX_PROCESSOR_NAME + 1;
+        char myName[nameMax] = {0};
+        int myNameLen = 0;
+        MPI_Get_processor_name(myName, &myNameLen) || MpiFail("NcclComm: MPI_Get_processor_name");
+        myName[myNameLen] = '\0';
+
+        std::vector<char> allNames(numRanks * nameMax);
+        MPI_Allgather(myName, nameMax, MPI_CHAR, allNames.data(), nameMax, MPI_CHAR, mpiComm)
+            || MpiFail("NcclComm: MPI_Allgather");
+
+        // color = lowest global rank running on my host
+        int color = 0;
+        while (strcmp(allNames.data() + (color * nameMax), myName) != 0)
+            color++;
+        MPI_Comm_split(mpiComm, color, myRank, &localComm)
+            || MpiFail("NcclComm: MPI_Comm_split");
+
+        int localSize;
+        MPI_Comm_rank(localComm, &localRank);
+        MPI_Comm_size(localComm, &localSize);
+        numLocalRanks = localSize;
+
+        // with a single rank per host there is nothing to reduce locally; keep NCCL disabled
+        // as before and let the aggregator fall back to flat MPI
+        int maxLocalRanks = localSize;
+        MPI_Allreduce(MPI_IN_PLACE, &maxLocalRanks, 1, MPI_INT, MPI_MAX, mpiComm)
+            || MpiFail("NcclComm: MPI_Allreduce");
+        if (maxLocalRanks < 2)
+        {
+            fprintf(stderr, "NcclComm: disabled, single rank per host\n");
+            return;
+        }
+
+        m_isLocalLeader = (localRank == 0);
+        MPI_Comm_split(mpiComm, m_isLocalLeader ? 0 : MPI_UNDEFINED, myRank, &m_leaderComm)
+            || MpiFail("NcclComm: MPI_Comm_split");
+        m_hierarchical = true;
+    }
+
+    std::vector<int> allDevs(numLocalRanks);
+    MPI_Allgather(&deviceId, 1, MPI_INT, allDevs.data(), 1, MPI_INT, localComm)
         || MpiFail("NcclComm: MPI_Allgather");
 
-    for (size_t r = 0; r<numRanks; r++)
+    int devsOk = 1;
+    for (size_t r = 0; r<numLocalRanks; r++)
     {
         if (allDevs[r] == CPUDEVICE)
         {
             fprintf(stderr, "NcclComm: disabled, at least one rank using CPU device\n");
-            return;
+            devsOk = 0;
         }
         for (size_t s = 0; s<r; s++)
             if (allDevs[r] == allDevs[s])
             {
                 fprintf(stderr, "NcclComm: disabled, same device used by more than one rank\n");
-                return;
+                devsOk = 0;
             }
     }
+    if (m_hierarchical)
+    {
+        // the device checks above are per-host; all ranks must agree on whether NCCL is in use,
+        // otherwise the aggregator would take different code paths on different ranks and hang
+        MPI_Allreduce(MPI_IN_PLACE, &devsOk, 1, MPI_INT, MPI_MIN, mpiComm)
+            || MpiFail("NcclComm: MPI_Allreduce");
+    }
+    if (!devsOk)
+    {
+        m_hierarchical = false;
+        return;
+    }
 
     ncclUniqueId ncclId;
     ncclResult_t res;
 
-    res = ncclGetUniqueId(&ncclId);
-    if (res != ncclSuccess)
-        RuntimeError("NcclComm failed to obtain ncclUniqueId: %s", ncclGetErrorString(res));
+    if (localRank == 0)
+    {
+        res = ncclGetUniqueId(&ncclId);
+        if (res != ncclSuccess)
+            RuntimeError("NcclComm failed to obtain ncclUniqueId: %s", ncclGetErrorString(res));
+    }
 
-    MPI_Bcast(&ncclId, NCCL_UNIQUE_ID_BYTES, MPI_CHAR, 0, mpiComm)
+    MPI_Bcast(&ncclId, NCCL_UNIQUE_ID_BYTES, MPI_CHAR, 0, localComm)
         || MpiFail("NcclComm: MPI_Bcase");
 
     PrepareDevice(deviceId);
-    res = ncclCommInitRank(&m_ncclComm, numRanks, ncclId, mpi->CurrentNodeRank());
+    res = ncclCommInitRank(&m_ncclComm, numLocalRanks, ncclId, localRank);
     if (res != ncclSuccess)
       RuntimeError("NcclComm failed to initialize ncclComm_t: %s", ncclGetErrorString(res));
 
     cudaStreamCreateWithFlags(&m_stream, cudaStreamNonBlocking)
         || "cudaStreamCreateWithFlags failed";
-    fprintf(stderr, "NcclComm: initialized\n");
+    if (m_hierarchical)
+        fprintf(stderr, "NcclComm: initialized (hierarchical, %d ranks on this host)\n", (int) numLocalRanks);
+    else
+        fprintf(stderr, "NcclComm: initialized\n");
 }
 
 NcclComm::~NcclComm()
 {
+    if (m_hostBuffer != nullptr)
+        cudaFreeHost(m_hostBuffer);
     if (m_stream != nullptr)
         cudaStreamDestroy(m_stream);
     if (m_ncclComm != nullptr)
@@ -81,11 +151,21 @@ bool NcclComm::IsSupported()
 
 void NcclComm::AllReduceImpl(void* buffer, size_t count, DataType dtype)
 {
+    if (m_hierarchical)
+    {
+        AllReduceHierarchicalImpl(buffer, count, dtype);
+        return;
+    }
+
     ncclResult_t res;
     if (dtype == DataType::FLOAT)
     {
         res = ncclAllReduce(buffer, buffer, count, ncclFloat, ncclSum, m_ncclComm, m_stream);
     }
+    else if (dtype == DataType::HALF)
+    {
+        res = ncclAllReduce(buffer, buffer, count, ncclHalf, ncclSum, m_ncclComm, m_stream);
+    }
     else
     {
         assert(dtype == DataType::DOUBLE);
@@ -96,6 +176,50 @@ void NcclComm::AllReduceImpl(void* buffer, size_t count, DataType dtype)
         RuntimeError("NcclComm ncclAllReduce failed: %s", ncclGetErrorString(res));
 }
 
+// Two-level reduction for multi-host runs: NCCL reduces onto the per-host leader over
+// NVLink/PCIe, the leaders allreduce one host-reduced copy per node over MPI, and NCCL
+// broadcasts the aggregate back out within each host. Only one rank per host touches the
+// inter-node fabric, cutting its traffic by the number of ranks per host.
+void NcclComm::AllReduceHierarchicalImpl(void* buffer, size_t count, DataType dtype)
+{
+    // the leaders' exchange runs over MPI, which has no native half-precision sum; half-precision
+    // reductions are therefore limited to single-host (pure NCCL) runs
+    if (dtype == DataType::HALF)
+        RuntimeError("NcclComm: half-precision reduction is not supported on multi-host (hierarchical) runs.");
+
+    ncclDataType_t ncclType = (dtype == DataType::FLOAT) ? ncclFloat : ncclDouble;
+    MPI_Datatype mpiType = (dtype == DataType::FLOAT) ? MPI_FLOAT : MPI_DOUBLE;
+    size_t bytes = count * ((dtype == DataType::FLOAT) ? sizeof(float) : sizeof(double));
+
+    ncclResult_t res = ncclReduce(buffer, buffer, count, ncclType, ncclSum, 0, m_ncclComm, m_stream);
+    if (res != ncclSuccess)
+        RuntimeError("NcclComm ncclReduce failed: %s", ncclGetErrorString(res));
+
+    // The non-leader ranks just enqueue the broadcast below; it does not complete until the
+    // leader joins it after the MPI exchange. MPI here is not assumed CUDA-aware, so the
+    // leader stages through a pinned host buffer.
+    if (m_isLocalLeader)
+    {
+        if (m_hostBufferBytes < bytes)
+        {
+            if (m_hostBuffer != nullptr)
+                cudaFreeHost(m_hostBuffer) || "NcclComm: cudaFreeHost failed";
+            cudaMallocHost(&m_hostBuffer, bytes) || "NcclComm: cudaMallocHost failed";
+            m_hostBufferBytes = bytes;
+        }
+
+        cudaStreamSynchronize(m_stream) || "NcclComm: cudaStreamSynchronize failed";
+        cudaMemcpy(m_hostBuffer, buffer, bytes, cudaMemcpyDeviceToHost) || "NcclComm: cudaMemcpy failed";
+        MPI_Allreduce(MPI_IN_PLACE, m_hostBuffer, (int) count, mpiType, MPI_SUM, m_leaderComm)
+            || MpiFail("NcclComm: MPI_Allreduce");
+        cudaMemcpy(buffer, m_hostBuffer, bytes, cudaMemcpyHostToDevice) || "NcclComm: cudaMemcpy failed";
+    }
+
+    res = ncclBcast(buffer, count, ncclType, 0, m_ncclComm, m_stream);
+    if (res != ncclSuccess)
+        RuntimeError("NcclComm ncclBcast failed: %s", ncclGetErrorString(res));
+}
+
 void NcclComm::Sync()
 {
     cudaStreamSynchronize(m_stream) || "NcclComm: cudaStreamSynchronize failed";
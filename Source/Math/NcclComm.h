@@ -19,12 +19,26 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
 class NcclComm
 {
+public:
+    // element type of a raw reduction buffer; HALF has no matrix type in this code base,
+    // so it is only reachable through the raw-buffer AllReduce below
+    enum class DataType : int {FLOAT, DOUBLE, HALF};
+
 #ifdef USE_NCCL
 private:
-    enum class DataType : int {FLOAT, DOUBLE};
     void AllReduceImpl(void* buffer, size_t count, DataType dtype);
+    void AllReduceHierarchicalImpl(void* buffer, size_t count, DataType dtype);
     cudaStream_t m_stream;
     ncclComm_t m_ncclComm;
+
+    // Multi-host runs aggregate in two levels: NCCL reduce to a per-host leader over
+    // NVLink/PCIe, MPI allreduce across the leaders (one host-reduced copy per node on the
+    // wire), NCCL broadcast back within each host.
+    bool m_hierarchical;
+    bool m_isLocalLeader;
+    MPI_Comm m_leaderComm;
+    void* m_hostBuffer; // pinned staging buffer for the leader's MPI exchange
+    size_t m_hostBufferBytes;
 #endif
 
 public:
@@ -49,6 +63,18 @@ public:
         }
 #else
         RuntimeError("NcclComm: CNTK was built without NCCL support.");
+#endif
+    }
+
+    // raw-buffer variant for callers that manage their own device buffers, e.g. half-precision
+    // staging copies of the gradients; 'count' is in elements of 'dtype'
+    void AllReduce(void* buffer, size_t count, DataType dtype)
+    {
+#ifdef USE_NCCL
+        AllReduceImpl(buffer, count, dtype);
+#else
+        UNUSED(buffer); UNUSED(count); UNUSED(dtype);
+        RuntimeError("NcclComm: CNTK was built without NCCL support.");
 #endif
     }
 };
@@ -212,12 +212,10 @@ void GPUSparseMatrix<ElemType>::SetMatrixFromCSCFormat(const CPUSPARSE_INDEX_TYP
 {
 }
 
-#if 0
 template <class ElemType>
 void GPUSparseMatrix<ElemType>::SetMatrixFromSBCFormat(const size_t*, const ElemType*, const size_t, const size_t, const size_t)
 {
 }
-#endif
 
 // forward pass from feature to hidden layer
 template <class ElemType>
@@ -255,6 +253,10 @@ ElemType GPUSparseMatrix<ElemType>::Adagrad(GPUMatrix<ElemType>& c, const bool n
 {
     return 1;
 }
+template <class ElemType>
+void GPUSparseMatrix<ElemType>::FSAdagrad(GPUMatrix<ElemType>&, GPUMatrix<ElemType>&, ElemType, ElemType, ElemType, ElemType)
+{
+}
 //template<class ElemType>
 //void GPUSparseMatrix<ElemType>::FSAdagrad(CPUMatrix<ElemType>& gradients, CPUMatrix<ElemType>&, ElemType, ElemType, ElemType, ElemType) { }
 
@@ -1052,6 +1054,14 @@ void GPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
 {
 }
 
+template <class ElemType>
+void GPUMatrix<ElemType>::BatchedNormalGrad(const std::vector<GPUMatrix<ElemType>*>& smoothedGradients,
+                                            const std::vector<GPUMatrix<ElemType>*>& gradients,
+                                            const std::vector<GPUMatrix<ElemType>*>& functionValues,
+                                            ElemType learnRatePerSample, ElemType momentum, bool useNesterovMomentum)
+{
+}
+
 template <class ElemType>
 ElemType GPUMatrix<ElemType>::Adagrad(GPUMatrix<ElemType>& gradients, const bool needAveMultiplier)
 {
@@ -1552,6 +1562,13 @@ DeviceBoundNumber<ElemType> GPUMatrix<ElemType>::Sum_AsDeviceBoundNum() const
     return result;
 }
 
+template <class ElemType>
+DeviceBoundNumber<ElemType> GPUMatrix<ElemType>::FrobeniusNorm_AsDeviceBoundNum() const
+{
+    DeviceBoundNumber<ElemType> result;
+    return result;
+}
+
 template <class ElemType>
 ElemType GPUMatrix<ElemType>::Max() const
 {
@@ -1852,7 +1869,20 @@ void GPUMatrix<ElemType>::BatchNormalizationForward(const GPUMatrix<ElemType>& s
 }
 
 template <class ElemType>
-void GPUMatrix<ElemType>::BatchNormalizationBackward(const GPUMatrix<ElemType>& in, GPUMatrix<ElemType>& grad, const GPUMatrix<ElemType>& scale, double blendFactor, 
+void GPUMatrix<ElemType>::BatchNormalizationBackward(const GPUMatrix<ElemType>& in, GPUMatrix<ElemType>& grad, const GPUMatrix<ElemType>& scale, double blendFactor,
+                                                     const GPUMatrix<ElemType>& saveMean, const GPUMatrix<ElemType>& saveInvStdDev,
+                                                     GPUMatrix<ElemType>& scaleGrad, GPUMatrix<ElemType>& biasGrad) const
+{
+}
+
+template <class ElemType>
+void GPUMatrix<ElemType>::LayerNormalizationForward(const GPUMatrix<ElemType>& scale, const GPUMatrix<ElemType>& bias, GPUMatrix<ElemType>& out, double epsilon,
+                                                    GPUMatrix<ElemType>& saveMean, GPUMatrix<ElemType>& saveInvStdDev) const
+{
+}
+
+template <class ElemType>
+void GPUMatrix<ElemType>::LayerNormalizationBackward(const GPUMatrix<ElemType>& in, GPUMatrix<ElemType>& grad, const GPUMatrix<ElemType>& scale,
                                                      const GPUMatrix<ElemType>& saveMean, const GPUMatrix<ElemType>& saveInvStdDev,
                                                      GPUMatrix<ElemType>& scaleGrad, GPUMatrix<ElemType>& biasGrad) const
 {
@@ -1886,6 +1916,11 @@ void GPUMatrix<ElemType>::Multiply1x1AndWeightedAdd(ElemType alpha, const GPUMat
 {
 }
 
+template <class ElemType>
+void GPUMatrix<ElemType>::FusedPeepholeLSTMStep(const GPUMatrix<ElemType>& /*gates*/, const GPUMatrix<ElemType>& /*prevCellState*/, const GPUMatrix<ElemType>& /*peephole*/, GPUMatrix<ElemType>& /*cellState*/, GPUMatrix<ElemType>& /*output*/)
+{
+}
+
 template <class ElemType>
 void GPUMatrix<ElemType>::MultiplyAndAdd(const GPUMatrix<ElemType>& /*a*/, const bool transposeA, const GPUMatrix<ElemType>& /*b*/, const bool transposeB, GPUMatrix<ElemType>& c)
 {
@@ -2220,6 +2255,10 @@ void GranularGPUDataTransferer::RecordCPUToGPUCopy() {}
 
 void GranularGPUDataTransferer::WaitForCopyCPUToGPU() {}
 
+void GranularGPUDataTransferer::CopyCPUToGPUChunkedAsync(const void* /*cpuBuffer*/, size_t /*numElements*/, size_t /*elementSize*/, void* /*gpuBuffer*/, size_t /*numChunks*/) {}
+
+void GranularGPUDataTransferer::WaitForUploadChunkOnComputeStreamAsync(size_t /*chunkIndex*/) {}
+
 void GranularGPUDataTransferer::RecordComputeStreamSyncPoint() {}
 
 void GranularGPUDataTransferer::WaitForSyncPointOnFetchStreamAsync() {}
@@ -2313,6 +2352,26 @@ float CudaTimer::Elapsed()
 /*static*/ void SyncGuard::EnableSync()
 {
 }
+
+void SetPooledComputeStream(int)
+{
+}
+
+void ForkPooledComputeStreams(size_t)
+{
+}
+
+void JoinPooledComputeStreams()
+{
+}
+
+void RecordComputeStreamEvent(size_t)
+{
+}
+
+void WaitForComputeStreamEvent(size_t)
+{
+}
 } } }
 
 // define a dummy GPUWatcher class too
@@ -2328,6 +2387,11 @@ size_t GPUWatcher::GetFreeMemoryOnCUDADevice(int /*devId*/)
     return 0;
 }
 
+size_t GPUWatcher::GetCachedMemorySizeOnCUDADevice(int /*devId*/)
+{
+    return 0;
+}
+
 GPUWatcher::GPUWatcher(void)
 {
 }
@@ -4,9 +4,66 @@
 //
 #pragma once
 #include "Quantizers.h"
+#include "BlockMultiplier.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// Small polymorphic shim over the BlockMultiplier<BlockHandlerT> instantiations, so that
+// QuantizedMultiplier can pick the widest instruction set available on the running CPU once,
+// at construction time, instead of committing to a single handler at compile time.
+class Int16GemmBase
+{
+public:
+    virtual ~Int16GemmBase() {}
+    virtual short* PrepareB(short* B, int k, int n) = 0;
+    virtual void FreePreparedB(short* preparedB) = 0;
+    // A[m,k] * preparedB[k,n] = C[m,n], all row-major; C must be zeroed out by the caller.
+    virtual void MultiplyMatrices(short* A, int m, int k, short* preparedB, int n, int32_t* C) = 0;
+    virtual void SetNumThreads(int threads) = 0;
+    virtual void SetParallelismThreshold(int64_t macsThreshold) = 0;
+};
+
+template <class BlockHandlerT>
+class Int16Gemm final : public Int16GemmBase
+{
+    BlockMultiplier<BlockHandlerT> m_multiplier;
+
+public:
+    short* PrepareB(short* B, int k, int n) override
+    {
+        return m_multiplier.PrepareB(B, k, n);
+    }
+    void FreePreparedB(short* preparedB) override
+    {
+        BlockMultiplier<BlockHandlerT>::FreeMatrix(preparedB);
+    }
+    void MultiplyMatrices(short* A, int m, int k, short* preparedB, int n, int32_t* C) override
+    {
+        m_multiplier.MultiplyMatrices(A, m, k, preparedB, n, C);
+    }
+    void SetNumThreads(int threads) override
+    {
+        m_multiplier.SetNumThreads(threads);
+    }
+    void SetParallelismThreshold(int64_t macsThreshold) override
+    {
+        m_multiplier.SetParallelismThreshold(macsThreshold);
+    }
+};
+
+// Picks the widest block handler that is both compiled in and supported by the running CPU.
+inline std::unique_ptr<Int16GemmBase> CreateWidestInt16Gemm()
+{
+#ifdef SUPPORT_AVX512
+    if (CpuHasAvx512Support())
+        return std::unique_ptr<Int16GemmBase>(new Int16Gemm<BlockHandlerAVX512>());
+#endif
+#ifdef SUPPORT_AVX2
+    if (CpuHasAvx2Support())
+        return std::unique_ptr<Int16GemmBase>(new Int16Gemm<BlockHandlerAVX>());
+#endif
+    return std::unique_ptr<Int16GemmBase>(new Int16Gemm<BlockHandlerSSE>());
+}
 
 // Quantized product of two dense matrices A and B, where each matrix has its own quantizer.
 // This class handles quantization of both matrices, product and de-quantization of the result.
@@ -21,39 +78,73 @@ class QuantizedMultiplier
     // Placeholders for quantized matrices A and B
     vector<short> m_pMatA, m_pMatB;
 
+    // 32-bit integer result of the block multiplication, converted to ElemType on de-quantization
+    vector<int32_t> m_pMatC;
+
+    // Block multiplier for the widest instruction set available on this CPU
+    std::unique_ptr<Int16GemmBase> m_pGemm;
+
+    // A rewritten in block order (cached across calls when A is constant).
+    // The block multiplier works on row-major data; since CNTK stores matrices column-major
+    // we compute C' = B' * A' instead, for which the column-major buffers of B, A and C are
+    // exactly the row-major buffers of B' (n x k), A' (k x m) and C' (n x m). The right-hand
+    // side of the block product is therefore A, so the block-order rewrite applies to it.
+    short* m_pPreparedA;
+
     // Whether matrices A and B are constant (i.e. weights)
     // If the matrix is constant, the size of the underlying container for quatized values will be preserved for
     // the lifespan of the object
     bool m_isAConstant;
     bool m_isBConstant;
 
+    // Set when the caller knows a "constant" matrix has in fact changed (e.g. the weights were
+    // fine-tuned since the cached copy was prepared); forces a one-time refresh of the cache
+    bool m_refreshA;
+    bool m_refreshB;
+
     bool m_firstPass;
 
-public: 
+public:
     QuantizedMultiplier(shared_ptr<QuantizerBase<ElemType, short>> pQuantizerA, bool isAConstant, shared_ptr<QuantizerBase<ElemType, short>> pQuantizerB, bool isBConstant) :
-        m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_firstPass(true)
+        m_pQuantizerA(pQuantizerA), m_pQuantizerB(pQuantizerB), m_isAConstant(isAConstant), m_isBConstant(isBConstant), m_refreshA(false), m_refreshB(false), m_firstPass(true), m_pPreparedA(nullptr)
     {
         if (isAConstant && isBConstant)
             LogicError("Quantized multiplication is applied to two constant matrices -- it is highly inefficient. Better approach is to replace the operation with the resulting matrix.");
+
+        m_pGemm = CreateWidestInt16Gemm();
     };
     QuantizedMultiplier(shared_ptr<QuantizerBase<ElemType, short>> pQuantizerA, shared_ptr<QuantizerBase<ElemType, short>> pQuantizerB) :
         QuantizedMultiplier(pQuantizerA, false, pQuantizerB, false)
     {
     };
 
+    ~QuantizedMultiplier()
+    {
+        if (m_pPreparedA != nullptr)
+            m_pGemm->FreePreparedB(m_pPreparedA);
+    }
+
     // A[m,k]*B[k,n] = C[m,n]
     void Multiply(int m, int n, int k, ElemType* A, ElemType* B, ElemType* C)
     {
         // Quantize
-        if (!m_isAConstant || m_firstPass)
+        if (!m_isAConstant || m_firstPass || m_refreshA)
         {
+            m_refreshA = false;
             m_pMatA.resize(m*k);
             ArrayRef<short> refMatA(m_pMatA.data(), m_pMatA.size());
             m_pQuantizerA->Quantize(ArrayRef<ElemType>(A, m_pMatA.size()), refMatA);
+
+            // Rewrite A in block order (see the comment on m_pPreparedA for why A and not B).
+            // When A is constant the rewritten copy is kept for the lifespan of the object.
+            if (m_pPreparedA != nullptr)
+                m_pGemm->FreePreparedB(m_pPreparedA);
+            m_pPreparedA = m_pGemm->PrepareB(m_pMatA.data(), k, m);
         }
-        
-        if (!m_isBConstant || m_firstPass)
+
+        if (!m_isBConstant || m_firstPass || m_refreshB)
         {
+            m_refreshB = false;
             m_pMatB.resize(n*k);
             ArrayRef<short> refMatB(m_pMatB.data(), m_pMatB.size());
             m_pQuantizerB->Quantize(ArrayRef<ElemType>(B, m_pMatB.size()), refMatB);
@@ -61,29 +152,35 @@ public:
 
         m_firstPass = false;
 
-        // Do multiply
-        // Naive inefficient product, just for demonstation
-        // TODO: replace with an efficient version, e.g. IPG, block multiplier, Eigen, gemmlowp, etc.
-        for (size_t i = 0; i < m; i++)
-            for (size_t j = 0; j < n; j++)
-            {
-                int dotProduct=0;
-                for (size_t l = 0; l < k; l++)
-                {
-                    // CNTK is using column-major storage
-                    dotProduct += m_pMatA[i + l*m] * m_pMatB[l + k*j];
-                }
-                C[i + j*m] = (ElemType)dotProduct;
-            }
+        // Do multiply on the block multiplier that was selected for this CPU.
+        // The block multiplier assumes its target has been zeroed out.
+        int mn = m*n;
+        m_pMatC.resize(mn);
+        memset(m_pMatC.data(), 0, sizeof(int32_t) * mn);
+        m_pGemm->MultiplyMatrices(m_pMatB.data(), n, k, m_pPreparedA, m, m_pMatC.data());
 
         // De-quantize
-        int mn = m*n;
+        for (int i = 0; i < mn; ++i)
+            C[i] = (ElemType)m_pMatC[i];
         m_pQuantizerB->Dequantize(C, C, mn);
         m_pQuantizerA->Dequantize(C, C, mn);
     }
 
     void SetIsAConstant(bool v) { m_isAConstant = v; }
     void SetIsBConstant(bool v) { m_isBConstant = v; }
+
+    // Drop the cached quantized (and, for A, block-reordered) copy of a constant matrix; it is
+    // re-prepared from the current values on the next Multiply call
+    void InvalidateCachedA() { m_refreshA = true; }
+    void InvalidateCachedB() { m_refreshB = true; }
+
+    // Worker count of the multiplier-owned thread pool. The pool persists across
+    // Multiply calls, so this is a one-time setup cost, not a per-call one.
+    void SetNumThreads(int threads) { m_pGemm->SetNumThreads(threads); }
+
+    // Multiplies smaller than this many multiply-accumulates (m*k*n) bypass the pool
+    // and run single-threaded on the calling thread.
+    void SetParallelismThreshold(int64_t macsThreshold) { m_pGemm->SetParallelismThreshold(macsThreshold); }
 };
 
-}}}
\ No newline at end of file
+}}}
@@ -0,0 +1,136 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full licence information.
+//
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <cassert>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// A persistent thread pool for the block multiplier. The workers are spawned once and
+// live as long as the pool does, so a multiplication only pays for queueing its row
+// tasks, not for thread startup - that overhead dominates the actual GEMM for the
+// small batch sizes typical of inference.
+//
+// Each worker owns a deque; tasks are distributed round-robin and an idle worker
+// steals from the back of its neighbors' deques before going to sleep, which keeps
+// all cores busy when the per-row work is skewed (e.g. the tail rows of a matrix
+// whose row count is not a multiple of the worker count).
+//
+// The interface is the one BlockMultiplier expects: QueueAndWake to submit one task,
+// Drain to wait until everything submitted so far has finished. Submission and Drain
+// must happen on a single thread at a time (BlockMultiplier serializes them with its
+// multiply mutex).
+template <typename ArgT>
+class StdThreadPool
+{
+public:
+    typedef std::function<void(ArgT)> TaskFn;
+
+    StdThreadPool(int numThreads)
+        : m_queues(numThreads), m_outstanding(0), m_nextQueue(0), m_shutdown(false)
+    {
+        assert(numThreads > 0);
+        for (int i = 0; i < numThreads; ++i)
+            m_workers.emplace_back(&StdThreadPool::WorkerLoop, this, i);
+    }
+
+    ~StdThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    StdThreadPool(const StdThreadPool&) = delete;
+    StdThreadPool& operator=(const StdThreadPool&) = delete;
+
+    void QueueAndWake(ArgT arg, TaskFn fn)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_queues[m_nextQueue].push_back(Task{fn, arg});
+            m_nextQueue = (m_nextQueue + 1) % (int)m_queues.size();
+            ++m_outstanding;
+        }
+        m_wake.notify_one();
+    }
+
+    // Blocks until all tasks queued so far have run to completion.
+    void Drain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_drained.wait(lock, [this] { return m_outstanding == 0; });
+    }
+
+private:
+    struct Task
+    {
+        TaskFn fn;
+        ArgT arg;
+    };
+
+    void WorkerLoop(int myQueue)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            Task task;
+            if (TryTake(myQueue, task))
+            {
+                lock.unlock();
+                task.fn(task.arg);
+                lock.lock();
+                if (--m_outstanding == 0)
+                    m_drained.notify_all();
+                continue;
+            }
+            if (m_shutdown)
+                return;
+            m_wake.wait(lock);
+        }
+    }
+
+    // Pop from the front of our own deque; failing that, steal from the back of another.
+    // Called with m_mutex held.
+    bool TryTake(int myQueue, Task& task)
+    {
+        if (!m_queues[myQueue].empty())
+        {
+            task = m_queues[myQueue].front();
+            m_queues[myQueue].pop_front();
+            return true;
+        }
+        for (size_t victim = 0; victim < m_queues.size(); ++victim)
+        {
+            if (!m_queues[victim].empty())
+            {
+                task = m_queues[victim].back();
+                m_queues[victim].pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::deque<Task>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    int m_outstanding;
+    int m_nextQueue;
+    bool m_shutdown;
+};
+
+}}}
@@ -245,6 +245,10 @@ DefBinaryOp(ElementwiseProductWithAbsDerivative, a * Sgn(b)); // note: b = input
 DefBinaryOp(ElementwiseProductWithReciprocalDerivative, a * -Sqr(b)); // b = output
 DefBinaryOp(ElementwiseProductWithSqrtDerivative, a / (2 * b)); // b = output; d/dx sqrt(x) = 1/(2 * sqrt(x)) --> note this is the same as ElementwiseQuotient w a constant; if more show up like this we should add more template params
 DefBinaryOp(SqrOfDifference, Sqr(a - b));
+// fused activation-of-sum ops; a = input, b = bias (or any addend)
+DefBinaryOp(SigmoidOfSum, Sigmoid(a + b));
+DefBinaryOp(TanhOfSum, tanh_(a + b));
+DefBinaryOp(LinearRectifierOfSum, a + b > 0 ? a + b : 0);
 //DefBinaryOp(Index, IndexElement(a, b, i));  // note: this one uses the third argument
 
 #pragma pop_macro("DefBinaryOp")
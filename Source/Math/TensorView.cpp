@@ -23,6 +23,7 @@
 #include "Basics.h"
 #include "TensorView.h"
 #include <array>
+#include <mutex>
 
 #ifndef let
 #define let const auto
@@ -220,6 +221,141 @@ static void PrepareTensorOperands(array<TensorShape, N> shapes, array<size_t, N>
         offsets[i] = shapes[i].GetOffset();
 }
 
+// memoization of PrepareTensorOperands()
+// Node shapes are stable across minibatches for fixed geometry, so the same (dims, strides)
+// tuples recur tens of thousands of times per step; only the offsets differ between calls
+// (e.g. per-time-step slices of the same object). We therefore key a small thread-local
+// direct-mapped cache on dims and strides alone and read the offsets straight off the shapes
+// on every call, skipping the repeated rank-padding/flattening/singleton-dropping passes.
+template <size_t N>
+struct TensorOpPlan
+{
+    bool valid = false;
+    array<SmallVector<size_t>, N> keyDims;       // cache key: dimensions of each operand
+    array<SmallVector<ptrdiff_t>, N> keyStrides; // cache key: strides of each operand
+    SmallVector<size_t> regularOpDims, reducingOpDims;
+    array<SmallVector<ptrdiff_t>, N> regularStrides, reducingStrides;
+};
+
+template <size_t N>
+static size_t TensorOpPlanHash(const array<TensorShape, N>& shapes)
+{
+    size_t hash = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        const auto& dims = shapes[i].GetDims();
+        const auto& strides = shapes[i].GetStrides();
+        for (size_t k = 0; k < dims.size(); k++)
+        {
+            hash = hash * 1099511628211ULL + dims[k];
+            hash = hash * 1099511628211ULL + (size_t) strides[k];
+        }
+    }
+    return hash;
+}
+
+template <size_t N>
+static bool TensorOpPlanMatches(const TensorOpPlan<N>& plan, const array<TensorShape, N>& shapes)
+{
+    for (size_t i = 0; i < N; i++)
+        if (plan.keyDims[i] != shapes[i].GetDims() || plan.keyStrides[i] != shapes[i].GetStrides())
+            return false;
+    return true;
+}
+
+// memoizing wrapper around PrepareTensorOperands()  --see TensorOpPlan above
+// Offsets are not part of the cached plan: flattening and singleton-dropping never change them,
+// so they are read directly off the incoming shapes on both the hit and the miss path.
+template <class ElemType, size_t N>
+static void PrepareTensorOperandsMemoized(const array<TensorShape, N>& shapes, array<size_t, N>& offsets,
+                                          SmallVector<size_t>& regularOpDims,
+                                          array<SmallVector<ptrdiff_t>, N>& regularStrides,
+                                          SmallVector<size_t>& reducingOpDims,
+                                          array<SmallVector<ptrdiff_t>, N>& reducingStrides)
+{
+    static std::mutex s_mutex;
+    static std::array<TensorOpPlan<N>, 64> s_cache; // direct-mapped
+    let slot = TensorOpPlanHash(shapes) & (s_cache.size() - 1);
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const auto& plan = s_cache[slot];
+        if (plan.valid && TensorOpPlanMatches(plan, shapes))
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                offsets[i] = shapes[i].GetOffset();
+                regularStrides[i] = plan.regularStrides[i];
+                reducingStrides[i] = plan.reducingStrides[i];
+            }
+            regularOpDims = plan.regularOpDims;
+            reducingOpDims = plan.reducingOpDims;
+            return;
+        }
+    }
+    PrepareTensorOperands<ElemType, N>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto& plan = s_cache[slot];
+    for (size_t i = 0; i < N; i++)
+    {
+        plan.keyDims[i] = shapes[i].GetDims();
+        plan.keyStrides[i] = shapes[i].GetStrides();
+        plan.regularStrides[i] = regularStrides[i];
+        plan.reducingStrides[i] = reducingStrides[i];
+    }
+    plan.regularOpDims = regularOpDims;
+    plan.reducingOpDims = reducingOpDims;
+    plan.valid = true;
+}
+
+// is the shape stored contiguously, without stride magic or gaps?
+static bool IsContiguous(const TensorShape& shape)
+{
+    const auto& dims = shape.GetDims();
+    const auto& strides = shape.GetStrides();
+    ptrdiff_t expected = 1;
+    for (size_t k = 0; k < dims.size(); k++)
+    {
+        if (strides[k] != expected)
+            return false;
+        expected *= (ptrdiff_t) dims[k];
+    }
+    return true;
+}
+
+// fast-path classifier for the regular-stride case
+// When every operand is contiguous and either matches the output's element count or is a
+// 1-element scalar (uniform broadcast), the whole rank-padding/flattening/singleton-dropping
+// dance in PrepareTensorOperands() collapses to a single flat dimension. We build the flat
+// descriptors directly here; the shape bookkeeping alone costs a few microseconds per op,
+// which adds up for networks that issue tens of thousands of small element-wise ops per step.
+// Returns false if the operands do not fit the pattern (caller then takes the general path).
+template <size_t N>
+static bool TryPrepareFlatTensorOperands(const array<TensorShape, N>& shapes, array<size_t, N>& offsets,
+                                         SmallVector<size_t>& regularOpDims,
+                                         array<SmallVector<ptrdiff_t>, N>& regularStrides,
+                                         SmallVector<size_t>& reducingOpDims,
+                                         array<SmallVector<ptrdiff_t>, N>& reducingStrides)
+{
+    let numElements = shapes.back().GetNumElements(); // output determines the operation size
+    if (numElements == 0)
+        return false;
+    for (size_t i = 0; i < N; i++)
+    {
+        let n = shapes[i].GetNumElements();
+        if ((n != numElements && n != 1) || !IsContiguous(shapes[i]))
+            return false; // n > numElements would be a reduction; gaps/strides need the general machinery
+    }
+    for (size_t i = 0; i < N; i++)
+    {
+        offsets[i] = shapes[i].GetOffset();
+        regularStrides[i].assign(size_t(1), ptrdiff_t(shapes[i].GetNumElements() == numElements ? 1 : 0 /*scalar broadcast*/));
+        reducingStrides[i].clear();
+    }
+    regularOpDims.assign(size_t(1), numElements);
+    reducingOpDims.clear();
+    return true;
+}
+
 // enforce that in case of broadcasting, the output must not be an input
 template <class ElemType>
 static bool CheckDifferentObject(const TensorView<ElemType>& a, const TensorView<ElemType>& b)
@@ -239,7 +375,9 @@ void TensorView<ElemType>::DoUnaryOpOf(ElemType beta, const TensorView& a, ElemT
     array<size_t, 2> offsets;
     array<SmallVector<ptrdiff_t>, 2> regularStrides, reducingStrides;
     SmallVector<size_t> regularOpDims, reducingOpDims;
-    PrepareTensorOperands<ElemType, 2>(array<TensorShape, 2>{a.GetShape(), GetShape()}, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    array<TensorShape, 2> shapes{a.GetShape(), GetShape()};
+    if (!TryPrepareFlatTensorOperands<2>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides))
+        PrepareTensorOperandsMemoized<ElemType, 2>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
 
     // output cannot be input when reducing
     if (reducingOpDims.size() > 0)
@@ -258,7 +396,9 @@ void TensorView<ElemType>::DoBinaryOpOf(ElemType beta, const TensorView& a, cons
     array<size_t, 3> offsets;
     array<SmallVector<ptrdiff_t>, 3> regularStrides, reducingStrides;
     SmallVector<size_t> regularOpDims, reducingOpDims;
-    PrepareTensorOperands<ElemType, 3>(array<TensorShape, 3>{a.GetShape(), b.GetShape(), GetShape()}, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    array<TensorShape, 3> shapes{a.GetShape(), b.GetShape(), GetShape()};
+    if (!TryPrepareFlatTensorOperands<3>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides))
+        PrepareTensorOperandsMemoized<ElemType, 3>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
 
     // output cannot be input when reducing
     if (reducingOpDims.size() > 0)
@@ -276,7 +416,9 @@ void TensorView<ElemType>::DoTernaryOpOf(ElemType beta, const TensorView& a, con
     array<size_t, 4> offsets;
     array<SmallVector<ptrdiff_t>, 4> regularStrides, reducingStrides;
     SmallVector<size_t> regularOpDims, reducingOpDims;
-    PrepareTensorOperands<ElemType, 4>(array<TensorShape, 4>{a.GetShape(), b.GetShape(), c.GetShape(), GetShape()}, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
+    array<TensorShape, 4> shapes{a.GetShape(), b.GetShape(), c.GetShape(), GetShape()};
+    if (!TryPrepareFlatTensorOperands<4>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides))
+        PrepareTensorOperandsMemoized<ElemType, 4>(shapes, offsets, regularOpDims, regularStrides, reducingOpDims, reducingStrides);
 
     // output cannot be input when reducing
     if (reducingOpDims.size() > 0)
@@ -388,6 +530,211 @@ void TensorView<ElemType>::DoMatrixProductOf(ElemType beta, bool transC, const T
         Matrix<ElemType>::MultiplyAndWeightedAdd(alpha, *B, !transB, *A, !transA, beta, *C, pQuantizedMultiplier);
 }
 
+// Batched matrix product: the trailing axis of a, b and c is a batch axis of extent numBatches, and each
+// batch slice is multiplied independently, as in DoMatrixProductOf. This maps rank>2 contractions with a
+// shared outer dimension (e.g. the groups of a grouped convolution, or the frames of an unrolled
+// recurrence laid out along the last axis) onto a single batched GEMM instead of numBatches separate
+// products. The batch axis must be explicit: it cannot be inferred from the shapes, since a trailing
+// output dimension of the same extent would be indistinguishable from a batch dimension.
+template <class ElemType>
+void TensorView<ElemType>::DoBatchedMatrixProductOf(ElemType beta, bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha, size_t numBatches)
+{
+    if (numBatches == 1) // no batching: fall through to the regular product
+        return DoMatrixProductOf(beta, transC, a, transA, b, transB, alpha);
+
+    auto shapeA = a.m_shape;
+    auto shapeB = b.m_shape;
+    auto shapeC =   m_shape;
+    if (shapeA.GetRank() < 2 || shapeB.GetRank() < 2 || shapeC.GetRank() < 2 ||
+        shapeA[shapeA.GetRank() - 1] != numBatches || shapeB[shapeB.GetRank() - 1] != numBatches || shapeC[shapeC.GetRank() - 1] != numBatches)
+        InvalidArgument("DoBatchedMatrixProductOf: All operands %s must have a trailing batch dimension of extent %d.", MatrixProductFormat(shapeA, transA, shapeB, transB, shapeC, transC).c_str(), (int) numBatches);
+
+    // determine integration dimension offset, over the per-batch ranks (i.e. excluding the batch axis)
+    if (shapeA.GetRank() + shapeB.GetRank() < shapeC.GetRank() + 2)
+        InvalidArgument("DoBatchedMatrixProductOf: Ranks %s don't match, output must have a non-reduced output dimension.", MatrixProductFormat(shapeA, transA, shapeB, transB, shapeC, transC).c_str());
+    let removedDims = (shapeA.GetRank() - 1) + (shapeB.GetRank() - 1) - (shapeC.GetRank() - 1);
+    let numReducedDims = removedDims / 2;
+    if (numReducedDims * 2 != removedDims)
+        InvalidArgument("DoBatchedMatrixProductOf: Ranks %s mismatch.", MatrixProductFormat(shapeA, transA, shapeB, transB, shapeC, transC).c_str());
+
+    // Flatten each operand to [rows x (colsPerBatch * numBatches)]. The batch axis is last in storage
+    // order, so after flattening the batches form equal column blocks, which is the layout
+    // Matrix::BatchedMultiplyAndWeightedAdd expects. The split point is chosen so that the contracted
+    // dimensions end up on the correct side, taking per-operand transposition into account.
+    let numOutputDimsA = shapeA.GetRank() - 1 - numReducedDims; // per-batch rank of the non-contracted dims of a
+    let numOutputDimsB = shapeB.GetRank() - 1 - numReducedDims; // ditto for b
+    shapeA.FlattenTo2DInPlace(transA ? numReducedDims : numOutputDimsA, "DoBatchedMatrixProductOf");
+    shapeB.FlattenTo2DInPlace(transB ? numOutputDimsB : numReducedDims, "DoBatchedMatrixProductOf");
+    shapeC.FlattenTo2DInPlace(transC ? numOutputDimsB : numOutputDimsA, "DoBatchedMatrixProductOf");
+
+    // check per-batch dimensions
+    let mA = transA ? shapeA[1] / numBatches : shapeA[0];
+    let kA = transA ? shapeA[0] : shapeA[1] / numBatches;
+    let kB = transB ? shapeB[1] / numBatches : shapeB[0];
+    let nB = transB ? shapeB[0] : shapeB[1] / numBatches;
+    let mC = transC ? shapeC[1] / numBatches : shapeC[0];
+    let nC = transC ? shapeC[0] : shapeC[1] / numBatches;
+    if (mA != mC || nB != nC || kA != kB)
+        InvalidArgument("DoBatchedMatrixProductOf: Flattened tensor dimensions %s mismatch.", MatrixProductFormat(shapeA, transA, shapeB, transB, shapeC, transC).c_str());
+
+    // create Matrix objects out of this
+    let  A = a.Reshaped(shapeA).AsMatrix();
+    let  B = b.Reshaped(shapeB).AsMatrix();
+    auto C =   Reshaped(shapeC).AsMatrix();
+    // and go
+    if (!transC)
+        Matrix<ElemType>::BatchedMultiplyAndWeightedAdd(alpha, *A, transA, *B, transB, beta, *C, numBatches);
+    else // per batch: C' = A * B  <==>  C = (A * B)' = B' * A'
+        Matrix<ElemType>::BatchedMultiplyAndWeightedAdd(alpha, *B, !transB, *A, !transA, beta, *C, numBatches);
+}
+
+// -------------------------------------------------------------------
+// general tensor contraction -- einsum-style, with GEMM lowering
+// -------------------------------------------------------------------
+
+// can 'shape' be reinterpreted as a [rows x cols] matrix split at 'splitPoint' without copying?
+static bool CanFlattenToMatrix(const TensorShape& shape, size_t splitPoint)
+{
+    for (size_t k = 1; k < shape.GetRank(); k++)
+        if (k != splitPoint && !shape.CanFlatten(k))
+            return false;
+    return true;
+}
+
+// apply a permutation to the axes of a shape in place: axis k of the result is axis order[k] of
+// the input. Implemented as pairwise swaps, so each stride travels with its dimension and the
+// result is a transposed view, not a copy.
+static void PermuteDimsInPlace(TensorShape& shape, const SmallVector<size_t>& order)
+{
+    let rank = order.size();
+    SmallVector<size_t> location(rank); // location[i] = current position of input axis i
+    SmallVector<size_t> axisAt(rank);   // axisAt[pos] = input axis currently at position pos
+    for (size_t i = 0; i < rank; i++)
+        location[i] = axisAt[i] = i;
+    for (size_t k = 0; k < rank; k++)
+    {
+        let axis = order[k];     // input axis that must end up at position k
+        let pos = location[axis]; // where it currently sits
+        if (pos == k)
+            continue;
+        shape.SwapDimsInPlace(k, pos);
+        let displaced = axisAt[k];
+        axisAt[pos] = displaced;
+        location[displaced] = pos;
+        axisAt[k] = axis;
+        location[axis] = k;
+    }
+}
+
+template <class ElemType>
+void TensorView<ElemType>::DoContractionOf(ElemType beta, const TensorView& a, const TensorView& b, ElemType alpha, const SmallVector<size_t>& axesA, const SmallVector<size_t>& axesB)
+{
+    let& shapeA = a.m_shape;
+    let& shapeB = b.m_shape;
+    let rankA = shapeA.GetRank();
+    let rankB = shapeB.GetRank();
+    let numContracted = axesA.size();
+    if (numContracted == 0 || numContracted != axesB.size())
+        InvalidArgument("DoContractionOf: The contraction axis lists must be non-empty and of equal length.");
+
+    // classify the axes of both operands
+    SmallVector<bool> contractedA(rankA, false), contractedB(rankB, false);
+    for (size_t i = 0; i < numContracted; i++)
+    {
+        let axisA = axesA[i];
+        let axisB = axesB[i];
+        if (axisA >= rankA || axisB >= rankB)
+            InvalidArgument("DoContractionOf: Contraction axis out of range for [%s] * [%s].", string(shapeA).c_str(), string(shapeB).c_str());
+        if (contractedA[axisA] || contractedB[axisB])
+            InvalidArgument("DoContractionOf: Duplicate contraction axis for [%s] * [%s].", string(shapeA).c_str(), string(shapeB).c_str());
+        if (shapeA[axisA] != shapeB[axisB])
+            InvalidArgument("DoContractionOf: Contracted dimensions %d and %d of [%s] * [%s] do not match.", (int) axisA, (int) axisB, string(shapeA).c_str(), string(shapeB).c_str());
+        contractedA[axisA] = true;
+        contractedB[axisB] = true;
+    }
+
+    // the output must be the free axes of a followed by the free axes of b, each in operand order
+    SmallVector<size_t> freeA, freeB;
+    for (size_t k = 0; k < rankA; k++)
+        if (!contractedA[k])
+            freeA.push_back(k);
+    for (size_t k = 0; k < rankB; k++)
+        if (!contractedB[k])
+            freeB.push_back(k);
+    let rankC = freeA.size() + freeB.size();
+    if (m_shape.GetRank() != rankC)
+        InvalidArgument("DoContractionOf: Output [%s] must have one axis per non-contracted axis of [%s] * [%s].", string(m_shape).c_str(), string(shapeA).c_str(), string(shapeB).c_str());
+    for (size_t k = 0; k < rankC; k++)
+    {
+        let expected = k < freeA.size() ? shapeA[freeA[k]] : shapeB[freeB[k - freeA.size()]];
+        if (m_shape[k] != expected)
+            InvalidArgument("DoContractionOf: Output dimensions [%s] do not match the free dimensions of [%s] * [%s].", string(m_shape).c_str(), string(shapeA).c_str(), string(shapeB).c_str());
+    }
+
+    // fast path: if the contracted axes form a contiguous run at the front or the back of both
+    // operands, in matching order, and the index groups are dense, then the contraction is
+    // exactly a matrix product over reinterpreted operands -- a single GEMM, no copies
+    bool contiguousRun = true;
+    for (size_t i = 1; i < numContracted; i++)
+        if (axesA[i] != axesA[i - 1] + 1 || axesB[i] != axesB[i - 1] + 1)
+            contiguousRun = false;
+    if (contiguousRun)
+    {
+        let suffixA = axesA[numContracted - 1] == rankA - 1;
+        let prefixB = axesB[0] == 0;
+        let transA = !suffixA; // contracted axes leading -> a enters the GEMM transposed
+        let transB = !prefixB; // contracted axes trailing -> b enters the GEMM transposed
+        if ((axesA[0] == 0 || suffixA) && (prefixB || axesB[numContracted - 1] == rankB - 1))
+        {
+            auto flatA = shapeA;
+            auto flatB = shapeB;
+            auto flatC = m_shape;
+            let splitA = transA ? numContracted : freeA.size();
+            let splitB = transB ? freeB.size() : numContracted;
+            if (CanFlattenToMatrix(flatA, splitA) && CanFlattenToMatrix(flatB, splitB) && CanFlattenToMatrix(flatC, freeA.size()))
+            {
+                flatA.FlattenTo2DInPlace(splitA, "DoContractionOf");
+                flatB.FlattenTo2DInPlace(splitB, "DoContractionOf");
+                flatC.FlattenTo2DInPlace(freeA.size(), "DoContractionOf");
+                let  A = a.Reshaped(flatA).AsMatrix();
+                let  B = b.Reshaped(flatB).AsMatrix();
+                auto C =   Reshaped(flatC).AsMatrix();
+                Matrix<ElemType>::MultiplyAndWeightedAdd(alpha, *A, transA, *B, transB, beta, *C);
+                return;
+            }
+        }
+    }
+
+    // general path: one strided multiply-and-reduce pass over the original storage. All three
+    // operands are viewed with the common axis order [free a..., free b..., contracted...]: the
+    // axes an operand does not have are appended singleton (broadcast) dimensions, and the
+    // contracted axes reduce into the output's trailing singletons. No permuted copy is
+    // materialized; the tensor kernel walks the original strides.
+    let rankT = rankC + numContracted;
+    auto viewShapeA = shapeA.PadRank(rankT);
+    auto viewShapeB = shapeB.PadRank(rankT);
+    auto viewShapeC = m_shape.PadRank(rankT); // contracted axes are already trailing singletons
+
+    SmallVector<size_t> orderA, orderB;
+    for (size_t k = 0; k < freeA.size(); k++)
+        orderA.push_back(freeA[k]);
+    for (size_t k = 0; k < freeB.size(); k++)
+        orderA.push_back(rankA + k); // b's free axes: singletons appended by PadRank()
+    for (size_t i = 0; i < numContracted; i++)
+        orderA.push_back(axesA[i]);
+    for (size_t k = 0; k < freeA.size(); k++)
+        orderB.push_back(rankB + k); // a's free axes: singletons appended by PadRank()
+    for (size_t k = 0; k < freeB.size(); k++)
+        orderB.push_back(freeB[k]);
+    for (size_t i = 0; i < numContracted; i++)
+        orderB.push_back(axesB[i]);
+    PermuteDimsInPlace(viewShapeA, orderA);
+    PermuteDimsInPlace(viewShapeB, orderB);
+
+    Reshaped(viewShapeC).DoBinaryOpOf(beta, a.Reshaped(viewShapeA), b.Reshaped(viewShapeB), alpha,
+                                      ElementWiseOperator::opElementwiseProduct, ElementWiseOperator::opSum);
+}
+
 template class TensorView<float>;
 template class TensorView<double>;
 
@@ -60,6 +60,16 @@ public:
         return TensorView(*this, shape);
     }
 
+    // create a non-owning view over a storage object
+    // This uses the shared_ptr aliasing constructor with an empty owner, so neither this call
+    // nor copies of the returned view touch any reference count. The caller must guarantee that
+    // 'sob' outlives the view and all its copies, e.g. a view over a node's value matrix that is
+    // only used within the current minibatch.
+    static TensorView<ElemType> Unowned(Matrix<ElemType>& sob, const TensorShape& shape)
+    {
+        return TensorView(std::shared_ptr<Matrix<ElemType>>(std::shared_ptr<Matrix<ElemType>>(), &sob), shape);
+    }
+
     // -------------------------------------------------------------------
     // elementwise operations
     // Result goes into 'this', and can optionally be added to the existing value.
@@ -148,6 +158,25 @@ public:
     void AssignMatrixProductOf(           bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha = 1.0f, shared_ptr<QuantizedMultiplier<ElemType>> pQuantizedMultiplier = nullptr) { DoMatrixProductOf(0, transC, a, transA, b, transB, alpha, pQuantizedMultiplier); }
     void AddMatrixProductOf   (           bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha = 1.0f) { DoMatrixProductOf(1.0f, transC, a, transA, b, transB, alpha); }
 
+    // batched variant: the trailing axis of all operands is a batch axis; each batch slice is an independent product (single batched GEMM underneath)
+    void DoBatchedMatrixProductOf    (ElemType beta, bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha, size_t numBatches);
+    void AssignBatchedMatrixProductOf(               bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha, size_t numBatches) { DoBatchedMatrixProductOf(0, transC, a, transA, b, transB, alpha, numBatches); }
+    void AddBatchedMatrixProductOf   (               bool transC, const TensorView& a, bool transA, const TensorView& b, bool transB, ElemType alpha, size_t numBatches) { DoBatchedMatrixProductOf(1.0f, transC, a, transA, b, transB, alpha, numBatches); }
+
+    // -------------------------------------------------------------------
+    // einsum-style contraction: contract a with b over the given axis pairs,
+    //   this = beta * this + alpha * sum_{axesA/axesB} a * b
+    // The output must be [free axes of a..., free axes of b...], each group in the operand's
+    // original axis order. When the contracted axes form a contiguous run at the front or back of
+    // both operands, the contraction lowers to a single GEMM on reinterpreted (not copied)
+    // operands; otherwise it executes as one strided multiply-and-reduce pass over the original
+    // storage, i.e. no permuted intermediate is materialized on either path.
+    // -------------------------------------------------------------------
+
+    void DoContractionOf    (ElemType beta, const TensorView& a, const TensorView& b, ElemType alpha, const SmallVector<size_t>& axesA, const SmallVector<size_t>& axesB);
+    void AssignContractionOf(               const TensorView& a, const TensorView& b, ElemType alpha, const SmallVector<size_t>& axesA, const SmallVector<size_t>& axesB) { DoContractionOf(0, a, b, alpha, axesA, axesB); }
+    void AddContractionOf   (               const TensorView& a, const TensorView& b, ElemType alpha, const SmallVector<size_t>& axesA, const SmallVector<size_t>& axesB) { DoContractionOf(1.0f, a, b, alpha, axesA, axesB); }
+
     shared_ptr<Matrix<ElemType>> AsMatrix() const;
     const TensorShape& GetShape() const { return m_shape; }
 
@@ -140,6 +140,33 @@ public:
         return ((u + (ElemType) 0.5) * ufactor) + quantimin;
     }
 
+    // quantize one value --linear multi-bit case (1 < Nbits < QWordNumBits)
+    // Same math as the corresponding branch of Quantize(); having it separately lets the
+    // fixed-width packing loops in ColumnQuantizer skip the per-value width dispatch.
+    cudasharedcode QWordVal QuantizeLinear(ElemType u) const
+    {
+        assert(Nbits > 1 && Nbits < QWordNumBits);
+        if (u <= quantimin)
+        {
+            return 0;
+        }
+        else if (u >= quantimax)
+        {
+            return (rangeend - 1);
+        }
+        else
+        {
+            return (QWordVal)((QWordValSigned)((u - quantimin) * qfactor));
+        }
+    }
+
+    // unquantize one value --linear multi-bit case (1 < Nbits < QWordNumBits)
+    cudasharedcode ElemType UnquantizeLinear(QWordVal u) const
+    {
+        assert(Nbits > 1 && Nbits < QWordNumBits);
+        return ((u + (ElemType) 0.5) * ufactor) + quantimin;
+    }
+
     // quantize one value --special version for 1 bit
     template <bool ZeroThresholdFor1Bit>
     cudasharedcode bool Quantize1(ElemType u) const
@@ -208,7 +208,7 @@ __global__ void forwardlatticej(const size_t batchsize, const size_t startindex,
 __global__ void backwardlatticej(const size_t batchsize, const size_t startindex, const vectorref<float> edgeacscores,
                                  const size_t spalignunitid, const size_t silalignunitid,
                                  vectorref<msra::lattices::edgeinfowithscores> edges, vectorref<msra::lattices::nodeinfo> nodes,
-                                 vectorref<msra::lattices::aligninfo> aligns, const double totalfwscore,
+                                 vectorref<msra::lattices::aligninfo> aligns,
                                  vectorref<double> logpps, vectorref<double> logalphas, vectorref<double> logbetas,
                                  float lmf, float wp, float amf, const float boostingfactor, const bool returnEframescorrect,
                                  vectorref<double> logframescorrectedge, vectorref<double> logaccalphas,
@@ -219,6 +219,10 @@ __global__ void backwardlatticej(const size_t batchsize, const size_t startindex
     size_t j = jinblock + blockIdx.x * tpb;
     if (j < batchsize) // note: will cause issues if we ever use __synctreads()
     {
+        // read the total forward score off the device copy, rather than passing it in as a kernel
+        // argument: this way the backward pass can be launched right behind the forward pass
+        // without a host round-trip to fetch the score in between
+        const double totalfwscore = logalphas[nodes.size() - 1];
         msra::lattices::latticefunctionskernels::backwardlatticej(j + startindex, edgeacscores, spalignunitid, silalignunitid,
                                                                   edges, nodes, aligns, totalfwscore, logpps, logalphas, logbetas,
                                                                   lmf, wp, amf, boostingfactor, returnEframescorrect,
@@ -279,32 +283,36 @@ void latticefunctionsops::forwardbackwardlattice(const size_t *batchsizeforward,
         checklaunch("edgealignment");
         startindex += batchsizeforward[i];
     }
-    memcpy<double>(&totalfwscore, logalphas.get(), nodes.size() - 1, 1);
-    double totalfwacc = 0;
-    if (returnEframescorrect)
-    {
-        memcpy<double>(&totalfwacc, logaccalphas.get(), nodes.size() - 1, 1);
-        totalfwacc -= totalfwscore;
-    }
 
     // backward pass
+    // The backward kernels read the total forward score directly off the device, so we can queue
+    // them up right behind the forward pass. The many small per-level launches of both passes
+    // then execute back-to-back, without the GPU draining at a host round-trip in the middle
+    // (that sync used to cost more than the kernels themselves for short utterances).
     startindex = edges.size();
     for (size_t i = 0; i < numlaunchbackward; i++)
     {
         dim3 b2((unsigned int) ((batchsizebackward[i] + tpb - 1) / tpb));
         backwardlatticej<<<b2, t, 0, GetCurrentStream()>>>(batchsizebackward[i], startindex - batchsizebackward[i],
                                                           edgeacscores, spalignunitid, silalignunitid, edges, nodes, aligns,
-                                                          totalfwscore, logpps, logalphas, logbetas,
+                                                          logpps, logalphas, logbetas,
                                                           lmf, wp, amf, boostingfactor, returnEframescorrect, logframescorrectedge,
                                                           logaccalphas, logEframescorrect, logaccbetas);
         checklaunch("edgealignment");
         startindex -= batchsizebackward[i];
     }
+
+    // fetch the per-lattice totals, now that both passes are in flight; this is the only
+    // synchronization point of the forward/backward phase
+    memcpy<double>(&totalfwscore, logalphas.get(), nodes.size() - 1, 1);
     double totalbwscore = 0;
     memcpy<double>(&totalbwscore, logbetas.get(), 0, 1);
+    double totalfwacc = 0;
     double totalbwacc = 0;
     if (returnEframescorrect)
     {
+        memcpy<double>(&totalfwacc, logaccalphas.get(), nodes.size() - 1, 1);
+        totalfwacc -= totalfwscore;
         memcpy<double>(&totalbwacc, logaccbetas.get(), 0, 1);
         totalbwacc -= totalbwscore;
         logEframescorrecttotal = totalbwacc;
@@ -17,6 +17,8 @@
 #include "fileutil.h"
 #include "TimerUtility.h"
 #include <algorithm>
+#include <atomic>
+#include <climits>
 #include <memory>
 #include <mutex>
 #include <stdio.h>
@@ -70,16 +72,40 @@ static const FixedEventDesc c_fixedEvtDesc[profilerEvtMax] = {
 };
 
 
+// Fixed event statistics are aggregated lock-free (relaxed atomics), so that recording a fixed
+// event never takes the global mutex; that mutex only guards the variable-size custom event buffer.
 struct FixedEventRecord
 {
-    int             cnt;          // event count
-    long long       sum;          // time (ns) or throughput (kB/s)
-    double          sumsq;        // sum of squares
-    long long       min;          // time (ns) or throughput (kB/s)
-    long long       max;          // time (ns) or throughput (kB/s)
-    long long       totalBytes;   // used only for throughput events
+    std::atomic<int>       cnt;          // event count
+    std::atomic<long long> sum;          // time (ns) or throughput (kB/s)
+    std::atomic<double>    sumsq;        // sum of squares
+    std::atomic<long long> min;          // time (ns) or throughput (kB/s)
+    std::atomic<long long> max;          // time (ns) or throughput (kB/s)
+    std::atomic<long long> totalBytes;   // used only for throughput events
 };
 
+// Lock-free helpers for the statistics that cannot be updated with a plain atomic add.
+static void AtomicAddDouble(std::atomic<double>& target, double value)
+{
+    double oldValue = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(oldValue, oldValue + value, std::memory_order_relaxed))
+        ;
+}
+
+static void AtomicUpdateMin(std::atomic<long long>& target, long long value)
+{
+    long long oldValue = target.load(std::memory_order_relaxed);
+    while (value < oldValue && !target.compare_exchange_weak(oldValue, value, std::memory_order_relaxed))
+        ;
+}
+
+static void AtomicUpdateMax(std::atomic<long long>& target, long long value)
+{
+    long long oldValue = target.load(std::memory_order_relaxed);
+    while (value > oldValue && !target.compare_exchange_weak(oldValue, value, std::memory_order_relaxed))
+        ;
+}
+
 //
 // The custom event record is a variable size datastructure in memory:
 // NULL terminated description string, followed by CustomEventRecord struct
@@ -98,6 +124,7 @@ struct CustomEventRecord
 struct ProfilerState
 {
     bool                    enabled;                     // Profiler enabled (active)
+    bool                    productionMode;              // Low-overhead mode: fixed events bypass the detail event buffer
     bool                    syncGpu;                     // Sync GPU per each profiling event
     bool                    cudaSyncEnabled;             // Runtime state of CUDA kernel sync
     std::wstring            profilerDir;                 // Directory where reports/logs are saved
@@ -124,6 +151,7 @@ void FormatTimeStr(char* str, size_t strLen, double value);
 void FormatThroughputStr(char* str, size_t strLen, double value);
 void FormatBytesStr(char* str, size_t strLen, long long bytes);
 void ProfilerGenerateDetailFile(const std::wstring& fileName);
+void ProfilerGenerateChromeTraceFile(const std::wstring& fileName);
 
 
 double TicksToSeconds(long long ticks)
@@ -165,6 +193,14 @@ void PERF_PROFILER_API ProfilerInit(const std::wstring& profilerDir, const unsig
 
     g_profilerState->syncGpu = syncGpu;
     g_profilerState->enabled = false;
+    g_profilerState->productionMode = false;
+
+    // (value-initialization above zeroed the event table; min/max need non-zero starting points)
+    for (int evtIdx = 0; evtIdx < profilerEvtMax; evtIdx++)
+    {
+        g_profilerState->fixedEvents[evtIdx].min.store(LLONG_MAX, std::memory_order_relaxed);
+        g_profilerState->fixedEvents[evtIdx].max.store(LLONG_MIN, std::memory_order_relaxed);
+    }
 
     if (_wmkdir(g_profilerState->profilerDir.c_str()) == -1 && errno != EEXIST)
     {
@@ -187,27 +223,37 @@ void PERF_PROFILER_API ProfilerEnable(bool enable)
 }
 
 
+//
+// Enable/disable low-overhead production mode.
+// In production mode, fixed events bypass the detail event buffer (and its mutex) and are only
+// aggregated into the lock-free summary statistics.
+//
+void PERF_PROFILER_API ProfilerEnableProductionMode(bool enable)
+{
+    // A nullptr state indicates that the profiler is globally disabled, and not initialized
+    if (g_profilerState == nullptr)
+        return;
+
+    g_profilerState->productionMode = enable;
+}
+
+
 //
 // Internal helper functions to record fixed and custom profiling events.
 //
 void ProfilerTimeRecordFixedEvent(const int eventId, const long long beginClock, const long long endClock)
 {
-    std::lock_guard<std::mutex> lock(g_mutex);
-
     if (!g_profilerState->enabled)
         return;
 
+    // lock-free: a few relaxed atomic updates per event, so concurrent threads never serialize here
     long long delta = endClock - beginClock;
-    if (g_profilerState->fixedEvents[eventId].cnt == 0)
-    {
-        g_profilerState->fixedEvents[eventId].min = delta;
-        g_profilerState->fixedEvents[eventId].max = delta;
-    }
-    g_profilerState->fixedEvents[eventId].min = std::min(delta, g_profilerState->fixedEvents[eventId].min);
-    g_profilerState->fixedEvents[eventId].max = std::max(delta, g_profilerState->fixedEvents[eventId].max);
-    g_profilerState->fixedEvents[eventId].sum += delta;
-    g_profilerState->fixedEvents[eventId].sumsq += (double)delta * (double)delta;
-    g_profilerState->fixedEvents[eventId].cnt++;
+    FixedEventRecord& evt = g_profilerState->fixedEvents[eventId];
+    AtomicUpdateMin(evt.min, delta);
+    AtomicUpdateMax(evt.max, delta);
+    evt.sum.fetch_add(delta, std::memory_order_relaxed);
+    AtomicAddDouble(evt.sumsq, (double)delta * (double)delta);
+    evt.cnt.fetch_add(1, std::memory_order_relaxed);
 }
 
 void ProfilerTimeRecordToBuffer(const char* eventDescription, const long long beginClock, const long long endClock)
@@ -264,7 +310,8 @@ void PERF_PROFILER_API ProfilerTimeEnd(const long long stateId, const int eventI
 
     long long endClock = Clock::GetTimeStamp();
     ProfilerTimeRecordFixedEvent(eventId, stateId, endClock);
-    ProfilerTimeRecordToBuffer(c_fixedEvtDesc[eventId].eventDescription, stateId, endClock);
+    if (!g_profilerState->productionMode) // in production mode, fixed events only feed the summary statistics
+        ProfilerTimeRecordToBuffer(c_fixedEvtDesc[eventId].eventDescription, stateId, endClock);
 }
 
 
@@ -317,8 +364,6 @@ void PERF_PROFILER_API ProfilerThroughputEnd(const long long stateId, const int
     if (g_profilerState == nullptr)
         return;
 
-    std::lock_guard<std::mutex> lock(g_mutex);
-
     if (!g_profilerState->enabled)
         return;
 
@@ -328,17 +373,13 @@ void PERF_PROFILER_API ProfilerThroughputEnd(const long long stateId, const int
 
     // Use kB rather than bytes to prevent overflow
     long long kBytesPerSec = Clock::GetTicksPerSecond() * bytes / 1000 / (endClock - beginClock);
-    if (g_profilerState->fixedEvents[eventId].cnt == 0)
-    {
-        g_profilerState->fixedEvents[eventId].min = kBytesPerSec;
-        g_profilerState->fixedEvents[eventId].max = kBytesPerSec;
-    }
-    g_profilerState->fixedEvents[eventId].min = std::min(kBytesPerSec, g_profilerState->fixedEvents[eventId].min);
-    g_profilerState->fixedEvents[eventId].max = std::max(kBytesPerSec, g_profilerState->fixedEvents[eventId].max);
-    g_profilerState->fixedEvents[eventId].sum += kBytesPerSec;
-    g_profilerState->fixedEvents[eventId].sumsq += (double)kBytesPerSec * (double)kBytesPerSec;
-    g_profilerState->fixedEvents[eventId].totalBytes += bytes;
-    g_profilerState->fixedEvents[eventId].cnt++;
+    FixedEventRecord& evt = g_profilerState->fixedEvents[eventId];
+    AtomicUpdateMin(evt.min, kBytesPerSec);
+    AtomicUpdateMax(evt.max, kBytesPerSec);
+    evt.sum.fetch_add(kBytesPerSec, std::memory_order_relaxed);
+    AtomicAddDouble(evt.sumsq, (double)kBytesPerSec * (double)kBytesPerSec);
+    evt.totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    evt.cnt.fetch_add(1, std::memory_order_relaxed);
 }
 
 
@@ -366,6 +407,10 @@ void PERF_PROFILER_API ProfilerClose()
     fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_detail_" + g_profilerState->logSuffix + L".csv";
     ProfilerGenerateDetailFile(fileName);
 
+    // Generate Chrome trace timeline (load via chrome://tracing or the Perfetto UI)
+    fileName = g_profilerState->profilerDir + L"/" + std::wstring(timeStr) + L"_trace_" + g_profilerState->logSuffix + L".json";
+    ProfilerGenerateChromeTraceFile(fileName);
+
     g_profilerState.reset();
 }
 
@@ -411,35 +456,42 @@ void ProfilerGenerateReport(const std::wstring& fileName, struct tm* timeInfo)
 
         switch (c_fixedEvtDesc[evtIdx].eventType)
         {
+        // (the statistics are snapshotted into locals below, since the atomics cannot be passed through varargs)
         case profilerEvtTime:
             if (g_profilerState->fixedEvents[evtIdx].cnt > 0)
             {
+                int cnt = g_profilerState->fixedEvents[evtIdx].cnt;
+                long long sumTicks = g_profilerState->fixedEvents[evtIdx].sum;
+                double sumsqTicks = g_profilerState->fixedEvents[evtIdx].sumsq;
+                long long minTicks = g_profilerState->fixedEvents[evtIdx].min;
+                long long maxTicks = g_profilerState->fixedEvents[evtIdx].max;
+
                 printLine = true;
                 fprintfOrDie(f, "%-26s: ", c_fixedEvtDesc[evtIdx].eventDescription);
 
                 char str[32];
 
-                double mean = TicksToSeconds(g_profilerState->fixedEvents[evtIdx].sum) / g_profilerState->fixedEvents[evtIdx].cnt;
+                double mean = TicksToSeconds(sumTicks) / cnt;
                 FormatTimeStr(str, sizeof(str), mean);
                 fprintfOrDie(f, "%s ", str);
 
-                double sum = TicksToSeconds(g_profilerState->fixedEvents[evtIdx].sum);
-                double sumsq = TicksSqToSecondsSq(g_profilerState->fixedEvents[evtIdx].sumsq);
-                double stdDev = sumsq - (pow(sum, 2.0) / g_profilerState->fixedEvents[evtIdx].cnt);
+                double sum = TicksToSeconds(sumTicks);
+                double sumsq = TicksSqToSecondsSq(sumsqTicks);
+                double stdDev = sumsq - (pow(sum, 2.0) / cnt);
                 if (stdDev < 0.0) stdDev = 0.0;
-                stdDev = sqrt(stdDev / (double)g_profilerState->fixedEvents[evtIdx].cnt);
+                stdDev = sqrt(stdDev / (double)cnt);
                 FormatTimeStr(str, sizeof(str), stdDev);
                 fprintfOrDie(f, "%s ", str);
 
-                FormatTimeStr(str, sizeof(str), TicksToSeconds(g_profilerState->fixedEvents[evtIdx].min));
+                FormatTimeStr(str, sizeof(str), TicksToSeconds(minTicks));
                 fprintfOrDie(f, "%s ", str);
 
-                FormatTimeStr(str, sizeof(str), TicksToSeconds(g_profilerState->fixedEvents[evtIdx].max));
+                FormatTimeStr(str, sizeof(str), TicksToSeconds(maxTicks));
                 fprintfOrDie(f, "%s ", str);
 
-                fprintfOrDie(f, "%16d ", g_profilerState->fixedEvents[evtIdx].cnt);
+                fprintfOrDie(f, "%16d ", cnt);
 
-                FormatTimeStr(str, sizeof(str), TicksToSeconds(g_profilerState->fixedEvents[evtIdx].sum));
+                FormatTimeStr(str, sizeof(str), TicksToSeconds(sumTicks));
                 fprintfOrDie(f, "%s", str);
             }
             break;
@@ -447,30 +499,37 @@ void ProfilerGenerateReport(const std::wstring& fileName, struct tm* timeInfo)
         case profilerEvtThroughput:
             if (g_profilerState->fixedEvents[evtIdx].cnt > 0)
             {
+                int cnt = g_profilerState->fixedEvents[evtIdx].cnt;
+                long long sumKbps = g_profilerState->fixedEvents[evtIdx].sum;
+                double sumsqKbps = g_profilerState->fixedEvents[evtIdx].sumsq;
+                long long minKbps = g_profilerState->fixedEvents[evtIdx].min;
+                long long maxKbps = g_profilerState->fixedEvents[evtIdx].max;
+                long long totalBytes = g_profilerState->fixedEvents[evtIdx].totalBytes;
+
                 printLine = true;
                 fprintfOrDie(f, "%-26s: ", c_fixedEvtDesc[evtIdx].eventDescription);
 
                 char str[32];
 
-                double mean = ((double)g_profilerState->fixedEvents[evtIdx].sum / (double)g_profilerState->fixedEvents[evtIdx].cnt);
+                double mean = ((double)sumKbps / (double)cnt);
                 FormatThroughputStr(str, sizeof(str), mean);
                 fprintfOrDie(f, "%s ", str);
 
-                double stdDev = g_profilerState->fixedEvents[evtIdx].sumsq - (pow((double)g_profilerState->fixedEvents[evtIdx].sum, 2.0) / (double)g_profilerState->fixedEvents[evtIdx].cnt);
+                double stdDev = sumsqKbps - (pow((double)sumKbps, 2.0) / (double)cnt);
                 if (stdDev < 0.0) stdDev = 0.0;
-                stdDev = sqrt(stdDev / (double)g_profilerState->fixedEvents[evtIdx].cnt);
+                stdDev = sqrt(stdDev / (double)cnt);
                 FormatThroughputStr(str, sizeof(str), stdDev);
                 fprintfOrDie(f, "%s ", str);
 
-                FormatThroughputStr(str, sizeof(str), (double)g_profilerState->fixedEvents[evtIdx].min);
+                FormatThroughputStr(str, sizeof(str), (double)minKbps);
                 fprintfOrDie(f, "%s ", str);
 
-                FormatThroughputStr(str, sizeof(str), (double)g_profilerState->fixedEvents[evtIdx].max);
+                FormatThroughputStr(str, sizeof(str), (double)maxKbps);
                 fprintfOrDie(f, "%s ", str);
 
-                fprintfOrDie(f, "%16d ", g_profilerState->fixedEvents[evtIdx].cnt);
+                fprintfOrDie(f, "%16d ", cnt);
 
-                FormatBytesStr(str, sizeof(str), g_profilerState->fixedEvents[evtIdx].totalBytes);
+                FormatBytesStr(str, sizeof(str), totalBytes);
                 fprintfOrDie(f, "%s", str);
             }
             break;
@@ -555,6 +614,65 @@ void ProfilerGenerateDetailFile(const std::wstring& fileName)
 }
 
 
+//
+// Escape an event description for embedding in a JSON string literal.
+//
+static std::string JsonEscape(const char* str)
+{
+    std::string result;
+    for (const char* p = str; *p != '\0'; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            result += '\\';
+        result += *p;
+    }
+    return result;
+}
+
+//
+// Generate a Chrome trace timeline (chrome://tracing JSON array format) from the detail event
+// buffer. Each record becomes a complete ("X") event on its thread's row, so cross-thread
+// overlap -- main loop phases vs. reader prefetch vs. aggregation -- can be inspected visually.
+// Timestamps and durations are in microseconds, as the trace viewer expects. Note that for fixed
+// events with the syncGpu flag set (and syncGpu enabled at init), the span already includes GPU
+// completion, so CPU/GPU overlap shows up as the difference between neighboring spans.
+//
+void ProfilerGenerateChromeTraceFile(const std::wstring& fileName)
+{
+    FILE* f = _wfopen(fileName.c_str(), L"wt");
+    if (f == NULL)
+    {
+        RuntimeError("Error: ProfilerGenerateChromeTraceFile: Cannot create file <%ls>.\n", fileName.c_str());
+    }
+
+    fprintfOrDie(f, "[\n");
+
+    char* eventPtr = g_profilerState->customEventBuffer.get();
+    bool firstRecord = true;
+
+    while (eventPtr < (g_profilerState->customEventBuffer.get() + g_profilerState->customEventOffset))
+    {
+        char* descriptionStr = eventPtr;
+        eventPtr += strlen(descriptionStr) + 1;
+
+        CustomEventRecord* eventRecord = (CustomEventRecord*)eventPtr;
+        eventPtr += sizeof(CustomEventRecord);
+
+        fprintfOrDie(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            firstRecord ? "" : ",\n",
+            JsonEscape(descriptionStr).c_str(),
+            eventRecord->threadId,
+            1000000.0 * TicksToSeconds(eventRecord->beginClock),
+            1000000.0 * TicksToSeconds(eventRecord->endClock - eventRecord->beginClock));
+        firstRecord = false;
+    }
+
+    fprintfOrDie(f, "\n]\n");
+
+    fclose(f);
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Scoped helpers.
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -97,6 +97,16 @@ void PERF_PROFILER_API ProfilerInit(const std::wstring& profilerDir, const unsig
 void PERF_PROFILER_API ProfilerEnable(bool enable);
 
 
+//
+// Enable/disable low-overhead production mode.
+// In production mode, fixed events are only aggregated into the lock-free summary statistics and
+// are not copied to the detail event buffer. This keeps the per-event cost to a few atomic adds
+// and the memory bounded by the fixed event table, so profiling can stay enabled for entire
+// production runs; the summary report is unchanged. Custom events are recorded as usual.
+//
+void PERF_PROFILER_API ProfilerEnableProductionMode(bool enable);
+
+
 //
 // Measure either a fixed or custom event time.
 // ProfilerTimeBegin() returns a stateId that is passed to ProfilerTimeEnd().
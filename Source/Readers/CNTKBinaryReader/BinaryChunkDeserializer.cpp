@@ -210,6 +210,18 @@ void BinaryChunkDeserializer::GetSequencesForChunk(ChunkIdType chunkId, std::vec
     }
 }
 
+MappedFileRegionPtr BinaryChunkDeserializer::MapChunk(ChunkIdType chunkId)
+{
+    auto region = make_unique<MappedFileRegion>(m_file,
+        m_dataStart + m_offsetsTable->GetOffset(chunkId),
+        m_offsetsTable->GetChunkSize(chunkId));
+
+    if (!region->IsValid())
+        return nullptr;
+
+    return region;
+}
+
 unique_ptr<byte[]> BinaryChunkDeserializer::ReadChunk(ChunkIdType chunkId)
 {
     // Seek to the start of the chunk
@@ -230,7 +242,13 @@ unique_ptr<byte[]> BinaryChunkDeserializer::ReadChunk(ChunkIdType chunkId)
 
 ChunkPtr BinaryChunkDeserializer::GetChunk(ChunkIdType chunkId)
 {
-    // Read the chunk into memory
+    // Map the chunk region of the input file and let the deserialized sequences point
+    // straight into the page cache, avoiding both the allocation and the read copy.
+    MappedFileRegionPtr mappedRegion = MapChunk(chunkId);
+    if (mappedRegion != nullptr)
+        return make_shared<BinaryDataChunk>(chunkId, m_offsetsTable->GetStartIndex(chunkId), m_offsetsTable->GetNumSequences(chunkId), std::move(mappedRegion), m_deserializers);
+
+    // Mapping is not available, read the chunk into memory instead.
     unique_ptr<byte[]> chunkBuffer = ReadChunk(chunkId);
 
     return make_shared<BinaryDataChunk>(chunkId, m_offsetsTable->GetStartIndex(chunkId), m_offsetsTable->GetNumSequences(chunkId), std::move(chunkBuffer), m_deserializers);
@@ -10,6 +10,7 @@
 #include "CorpusDescriptor.h"
 #include "BinaryDataChunk.h"
 #include "BinaryDataDeserializer.h"
+#include "FileHelper.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -88,6 +89,10 @@ private:
     // Reads a chunk from disk into buffer
     unique_ptr<byte[]> ReadChunk(ChunkIdType chunkId);
 
+    // Maps a chunk region of the input file into memory. Returns nullptr if the
+    // mapping cannot be created, in which case the chunk is read with ReadChunk.
+    MappedFileRegionPtr MapChunk(ChunkIdType chunkId);
+
     BinaryChunkDeserializer(const wstring& filename);
 
     void SetTraceLevel(unsigned int traceLevel);
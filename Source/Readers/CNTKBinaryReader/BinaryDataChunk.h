@@ -10,6 +10,7 @@
 #include "CorpusDescriptor.h"
 #include "BinaryChunkDeserializer.h"
 #include "BinaryDataDeserializer.h"
+#include "FileHelper.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 class BinaryDataChunk : public Chunk, public std::enable_shared_from_this<Chunk>
@@ -20,6 +21,13 @@ public:
     {
     }
 
+    // Zero-copy variant: the chunk data stays in a memory-mapped region of the input
+    // file, and the deserialized sequences point straight into the page cache.
+    explicit BinaryDataChunk(ChunkIdType chunkId, size_t startSequence, size_t numSequences, MappedFileRegionPtr mappedRegion, std::vector<BinaryDataDeserializerPtr> deserializer)
+        : m_chunkId(chunkId), m_startSequence(startSequence), m_numSequences(numSequences), m_mappedRegion(std::move(mappedRegion)), m_deserializers(deserializer)
+    {
+    }
+
     // Gets sequences by id.
     void GetSequence(size_t sequenceId, std::vector<SequenceDataPtr>& result) override
     {
@@ -47,11 +55,13 @@ protected:
     {
         m_data.resize(m_deserializers.size());
 
+        byte* chunkData = m_mappedRegion != nullptr ? (byte*)m_mappedRegion->Data() : m_buffer.get();
+
         // the number of bytes of buffer that have been processed by the deserializer so far
         size_t bytesProcessed = 0;
         // Now call all of the deserializers on the chunk, in order
         for (size_t c = 0; c < m_deserializers.size(); c++)
-            bytesProcessed += m_deserializers[c]->GetSequenceDataForChunk(m_numSequences, 0, (byte*)m_buffer.get() + bytesProcessed, m_data[c]);
+            bytesProcessed += m_deserializers[c]->GetSequenceDataForChunk(m_numSequences, 0, chunkData + bytesProcessed, m_data[c]);
     }
 
     // chunk id (copied from the descriptor)
@@ -66,6 +76,10 @@ protected:
     // This is the actual chunk read from disk. We will call back to the deserializer for it to be deserialized
     unique_ptr<byte[]> m_buffer;
 
+    // Alternatively, the chunk region of the input file mapped into memory. The mapping
+    // must stay alive as long as the chunk, since the parsed sequences point into it.
+    MappedFileRegionPtr m_mappedRegion;
+
     // This is the deserializer who knows how to interpret the m_data chunk that we read in
     std::vector<BinaryDataDeserializerPtr> m_deserializers;
     
@@ -31,7 +31,9 @@ CNTKBinaryReader::CNTKBinaryReader(const ConfigParameters& config)
 
         if (configHelper.ShouldKeepDataInMemory())
         {
-            m_deserializer = shared_ptr<IDataDeserializer>(new ChunkCache(m_deserializer));
+            // Optional byte budget for the cache in MB; 0 (the default) keeps all chunks.
+            size_t cacheBudgetInMB = config(L"cacheBudgetInMB", (size_t)0);
+            m_deserializer = shared_ptr<IDataDeserializer>(new ChunkCache(m_deserializer, cacheBudgetInMB << 20));
             log += " | keeping data in memory";
         }
 
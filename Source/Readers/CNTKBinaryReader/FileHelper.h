@@ -17,10 +17,14 @@
 
 #include <stdio.h>
 #ifdef __WINDOWS__
+#include <Windows.h>
+#include <io.h>
 #endif
 #ifdef __unix__
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 #include <errno.h>
 #include <stdint.h>
@@ -94,5 +98,91 @@ private:
     CNTKBinaryFileHelper();
 };
 
+// A copy-on-write memory-mapped region of a file on Windows and Linux.
+// The mapping is private: the deserializers may patch the data in place (e.g., the
+// sparse index fixup), which copies only the touched pages while the untouched bulk
+// of the chunk stays shared with the page cache and the file is never modified.
+// The requested offset does not have to be aligned; the mapping is created at
+// the nearest preceding page (allocation granularity on Windows) boundary and
+// Data() points at the requested offset within it. If the mapping cannot be
+// created, IsValid() returns false and the caller should fall back to reading
+// the region into memory.
+class MappedFileRegion
+{
+public:
+    MappedFileRegion(FILE* file, int64_t offset, size_t size) :
+        m_base(nullptr),
+        m_data(nullptr),
+        m_mappedSize(0)
+#ifdef __WINDOWS__
+        , m_mapping(NULL)
+#endif
+    {
+#ifdef __WINDOWS__
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        int64_t alignedOffset = offset - offset % info.dwAllocationGranularity;
+        m_mappedSize = size + (size_t)(offset - alignedOffset);
+
+        HANDLE fileHandle = (HANDLE)_get_osfhandle(_fileno(file));
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            return;
+
+        m_mapping = CreateFileMapping(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (m_mapping == NULL)
+            return;
+
+        m_base = MapViewOfFile(m_mapping, FILE_MAP_COPY,
+            (DWORD)(alignedOffset >> 32), (DWORD)(alignedOffset & 0xFFFFFFFF), m_mappedSize);
+        if (m_base == nullptr)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = NULL;
+            return;
+        }
+#else
+        int64_t pageSize = sysconf(_SC_PAGESIZE);
+        int64_t alignedOffset = offset - offset % pageSize;
+        m_mappedSize = size + (size_t)(offset - alignedOffset);
+
+        void* base = mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(file), alignedOffset);
+        if (base == MAP_FAILED)
+            return;
+        m_base = base;
+#endif
+        m_data = (char*)m_base + (offset - alignedOffset);
+    }
+
+    ~MappedFileRegion()
+    {
+#ifdef __WINDOWS__
+        if (m_base != nullptr)
+            UnmapViewOfFile(m_base);
+        if (m_mapping != NULL)
+            CloseHandle(m_mapping);
+#else
+        if (m_base != nullptr)
+            munmap(m_base, m_mappedSize);
+#endif
+    }
+
+    bool IsValid() const { return m_data != nullptr; }
+
+    void* Data() const { return m_data; }
+
+private:
+    void* m_base; // page-aligned start of the mapping
+    void* m_data; // requested offset within the mapping
+    size_t m_mappedSize;
+#ifdef __WINDOWS__
+    HANDLE m_mapping;
+#endif
+
+    MappedFileRegion(const MappedFileRegion&) = delete;
+    MappedFileRegion& operator=(const MappedFileRegion&) = delete;
+};
+
+typedef std::unique_ptr<MappedFileRegion> MappedFileRegionPtr;
+
 }}}
 #endif
\ No newline at end of file
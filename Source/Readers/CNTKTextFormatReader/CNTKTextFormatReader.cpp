@@ -34,7 +34,11 @@ CNTKTextFormatReader::CNTKTextFormatReader(const ConfigParameters& config)
             m_deserializer = make_shared<TextParser<double>>(corpus, configHelper, true);
 
         if (configHelper.ShouldKeepDataInMemory())
-            m_deserializer = make_shared<ChunkCache>(m_deserializer);
+        {
+            // Optional byte budget for the cache in MB; 0 (the default) keeps all chunks.
+            size_t cacheBudgetInMB = config(L"cacheBudgetInMB", (size_t)0);
+            m_deserializer = make_shared<ChunkCache>(m_deserializer, cacheBudgetInMB << 20);
+        }
 
         size_t window = configHelper.GetRandomizationWindow();
         if (window > 0)
@@ -149,6 +149,9 @@ TextConfigHelper::TextConfigHelper(const ConfigParameters& config)
     m_chunkSizeBytes = config(L"chunkSizeInBytes", 32 * 1024 * 1024); // 32 MB by default
     m_keepDataInMemory = config(L"keepDataInMemory", false);
     m_frameMode = config(L"frameMode", false);
+    m_numIndexingThreads = config(L"numIndexingThreads", (size_t)1);
+    m_cacheIndex = config(L"cacheIndex", false);
+    m_cacheChunks = config(L"cacheChunks", false);
 }
 
 }}}
@@ -37,6 +37,12 @@ public:
 
     bool ShouldKeepDataInMemory() const { return m_keepDataInMemory; }
 
+    size_t GetNumIndexingThreads() const { return m_numIndexingThreads; }
+
+    bool ShouldCacheIndex() const { return m_cacheIndex; }
+
+    bool ShouldCacheChunks() const { return m_cacheChunks; }
+
     bool IsInFrameMode() const { return m_frameMode; }
 
     ElementType GetElementType() const { return m_elementType; }
@@ -54,6 +60,9 @@ private:
     size_t m_chunkSizeBytes; // chunks size in bytes
     bool m_keepDataInMemory; // if true the whole dataset is kept in memory
     bool m_frameMode; // if true, the maximum expected sequence length in the dataset is one sample.
+    size_t m_numIndexingThreads; // number of threads used to index the input file
+    bool m_cacheIndex; // if true, the index is cached on disk and reused across runs
+    bool m_cacheChunks; // if true, parsed chunks are cached on disk in a binary sidecar file and reused across runs
 };
 
 } } }
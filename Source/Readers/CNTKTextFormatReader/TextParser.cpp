@@ -7,6 +7,12 @@
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 #include <cfloat>
+#include <cstring>
+#include <sys/stat.h>
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 #include "Indexer.h"
 #include "TextParser.h"
 #include "TextReaderConstants.h"
@@ -21,6 +27,82 @@ inline bool IsDigit(char c)
     return '0' <= c && c <= '9';
 }
 
+// Returns true if all eight bytes at p are ASCII digits.
+// The high nibble of each byte must be 3 and the low nibble must not exceed 9.
+inline bool IsEightDigits(const char* p)
+{
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return ((((x & 0xF0F0F0F0F0F0F0F0ull) ^ 0x3030303030303030ull) |
+             (((x & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull)) == 0);
+}
+
+// Converts the eight ASCII digits at p (most significant digit first) into their
+// decimal value, combining adjacent digits with SWAR multiplies instead of a
+// per-digit loop. The caller must have verified the input with IsEightDigits.
+inline uint64_t ParseEightDigits(const char* p)
+{
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    x -= 0x3030303030303030ull;
+    x = ((x * (1 + (10ull << 8))) >> 8) & 0x00FF00FF00FF00FFull;
+    x = ((x * (1 + (100ull << 16))) >> 16) & 0x0000FFFF0000FFFFull;
+    return (x * (1 + (10000ull << 32))) >> 32;
+}
+
+// Index of the lowest set bit. The mask must be non-zero.
+inline size_t FirstSetBit(int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, (unsigned long)mask);
+    return index;
+#else
+    return __builtin_ctz((unsigned int)mask);
+#endif
+}
+
+// Header of the binary chunk cache sidecar file. The sidecar stores the parsed
+// representation of each chunk, so that epochs and runs after the first one read
+// binary data instead of re-parsing the text. The header is followed by one
+// ChunkCacheStream record per input stream, the chunk offsets table and the
+// chunk payloads, appended in the order the chunks were first parsed.
+struct ChunkCacheHeader
+{
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_elemSize; // sizeof(ElemType) the cache was written with
+    uint64_t m_numStreams;
+    uint64_t m_numChunks;
+    int64_t m_fileSize; // size of the input file the cache was built from
+    int64_t m_fileTime; // last modification time of the input file
+};
+
+struct ChunkCacheStream
+{
+    uint64_t m_sampleDimension;
+    int32_t m_type; // StorageType of the stream
+    int32_t m_unused;
+};
+
+const static uint64_t CHUNK_CACHE_MAGIC = 0x74614478465443ULL; // "CTFxDat"
+const static uint32_t CHUNK_CACHE_VERSION = 1;
+
+// TODO: not DRY (same in the Indexer), needs refactoring
+static int64_t GetFileTime(FILE* file)
+{
+#ifdef _MSC_VER
+    struct _stat64 s;
+    if (_fstat64(_fileno(file), &s) != 0)
+        return 0;
+#else
+    struct stat s;
+    if (fstat(fileno(file), &s) != 0)
+        return 0;
+#endif
+    return (int64_t)s.st_mtime;
+}
+
 enum State
 {
     Init = 0,
@@ -68,6 +150,9 @@ TextParser(corpus, helper.GetFilePath(), helper.GetStreams(), isPrimary)
     SetMaxAllowedErrors(helper.GetMaxAllowedErrors());
     SetChunkSize(helper.GetChunkSize());
     SetSkipSequenceIds(helper.ShouldSkipSequenceIds());
+    SetNumIndexingThreads(helper.GetNumIndexingThreads());
+    SetCacheIndex(helper.ShouldCacheIndex());
+    SetCacheChunks(helper.ShouldCacheChunks());
 
     Initialize();
 }
@@ -86,6 +171,10 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     m_bufferEnd(nullptr),
     m_pos(nullptr),
     m_chunkSizeBytes(0),
+    m_numIndexingThreads(1),
+    m_cacheIndex(false),
+    m_cacheChunks(false),
+    m_cacheFile(nullptr),
     m_traceLevel(TraceLevel::Error),
     m_hadWarnings(false),
     m_numAllowedErrors(0),
@@ -127,6 +216,11 @@ TextParser<ElemType>::~TextParser()
     {
         fclose(m_file);
     }
+
+    if (m_cacheFile)
+    {
+        fclose(m_cacheFile);
+    }
 }
 
 template <class ElemType>
@@ -168,7 +262,8 @@ void TextParser<ElemType>::Initialize()
                 "UTF-16 encoding is currently not supported.", m_filename.c_str());
         }
 
-        m_indexer = make_unique<Indexer>(m_file, m_isPrimary, m_skipSequenceIds, NAME_PREFIX, m_chunkSizeBytes);
+        m_indexer = make_unique<Indexer>(m_file, m_isPrimary, m_skipSequenceIds, NAME_PREFIX, m_chunkSizeBytes,
+                                         2 * 1024 * 1024, m_filename, m_numIndexingThreads, m_cacheIndex);
 
         m_indexer->Build(m_corpus);
     });
@@ -183,6 +278,11 @@ void TextParser<ElemType>::Initialize()
 
     m_fileOffsetStart = position;
     m_fileOffsetEnd = position;
+
+    if (m_cacheChunks)
+    {
+        OpenChunkCache();
+    }
 }
 
 template <class ElemType>
@@ -256,7 +356,12 @@ ChunkPtr TextParser<ElemType>::GetChunk(ChunkIdType chunkId)
             fclose(m_file);
             m_file = fopenOrDie(m_filename, L"rbS");
         }
-        LoadChunk(textChunk, chunkDescriptor);
+
+        if (!TryLoadCachedChunk(textChunk, chunkDescriptor))
+        {
+            LoadChunk(textChunk, chunkDescriptor);
+            SaveChunkToCache(textChunk, chunkDescriptor);
+        }
     });
 
     return textChunk;
@@ -272,6 +377,218 @@ void TextParser<ElemType>::LoadChunk(TextChunkPtr& chunk, const ChunkDescriptor&
     }
 }
 
+template <class ElemType>
+void TextParser<ElemType>::OpenChunkCache()
+{
+    std::wstring cachePath = m_filename + L".chunks.cache";
+    const size_t numChunks = m_indexer->GetIndex().m_chunks.size();
+    const int64_t fileSize = (int64_t)filesize(m_file);
+    const int64_t fileTime = GetFileTime(m_file);
+
+    try
+    {
+        if (fexists(cachePath))
+        {
+            FILE* cache = fopenOrDie(cachePath, L"r+bS");
+
+            ChunkCacheHeader header = {};
+            std::vector<ChunkCacheStream> streams(m_streamInfos.size());
+            std::vector<int64_t> offsets(numChunks);
+
+            bool valid = fread(&header, sizeof(header), 1, cache) == 1 &&
+                header.m_magic == CHUNK_CACHE_MAGIC &&
+                header.m_version == CHUNK_CACHE_VERSION &&
+                header.m_elemSize == sizeof(ElemType) &&
+                header.m_numStreams == m_streamInfos.size() &&
+                header.m_numChunks == numChunks &&
+                header.m_fileSize == fileSize &&
+                header.m_fileTime == fileTime &&
+                fread(streams.data(), sizeof(ChunkCacheStream), streams.size(), cache) == streams.size() &&
+                (offsets.empty() ||
+                 fread(offsets.data(), sizeof(int64_t), offsets.size(), cache) == offsets.size());
+
+            for (size_t i = 0; valid && i < m_streamInfos.size(); ++i)
+            {
+                valid = streams[i].m_type == (int32_t)m_streamInfos[i].m_type &&
+                    streams[i].m_sampleDimension == m_streamInfos[i].m_sampleDimension;
+            }
+
+            if (valid)
+            {
+                m_cacheFile = cache;
+                m_cacheChunkOffsets = std::move(offsets);
+                return;
+            }
+
+            // Stale or foreign cache (e.g., the input file or the stream configuration
+            // changed), recreate it below.
+            fclose(cache);
+        }
+
+        // Create a fresh sidecar with an empty offsets table. Chunk payloads are
+        // appended as the chunks get parsed for the first time.
+        FILE* cache = fopenOrDie(cachePath, L"w+bS");
+
+        ChunkCacheHeader header = {};
+        header.m_magic = CHUNK_CACHE_MAGIC;
+        header.m_version = CHUNK_CACHE_VERSION;
+        header.m_elemSize = sizeof(ElemType);
+        header.m_numStreams = m_streamInfos.size();
+        header.m_numChunks = numChunks;
+        header.m_fileSize = fileSize;
+        header.m_fileTime = fileTime;
+        fwriteOrDie(&header, sizeof(header), 1, cache);
+
+        std::vector<ChunkCacheStream> streams(m_streamInfos.size());
+        for (size_t i = 0; i < m_streamInfos.size(); ++i)
+        {
+            streams[i].m_sampleDimension = m_streamInfos[i].m_sampleDimension;
+            streams[i].m_type = (int32_t)m_streamInfos[i].m_type;
+            streams[i].m_unused = 0;
+        }
+        if (!streams.empty())
+            fwriteOrDie(streams.data(), sizeof(ChunkCacheStream), streams.size(), cache);
+
+        std::vector<int64_t> offsets(numChunks, -1);
+        if (!offsets.empty())
+            fwriteOrDie(offsets.data(), sizeof(int64_t), offsets.size(), cache);
+        fflushOrDie(cache);
+
+        m_cacheFile = cache;
+        m_cacheChunkOffsets = std::move(offsets);
+    }
+    catch (const std::exception& e)
+    {
+        // The cache is an optimization only, so a failure to open it must not fail the run.
+        fprintf(stderr, "WARNING: could not open the chunk cache file (%ls): %s."
+            " Continuing without the chunk cache.\n", cachePath.c_str(), e.what());
+        m_cacheFile = nullptr;
+    }
+}
+
+template <class ElemType>
+bool TextParser<ElemType>::TryLoadCachedChunk(TextChunkPtr& chunk, const ChunkDescriptor& descriptor)
+{
+    if (m_cacheFile == nullptr || m_cacheChunkOffsets[descriptor.m_id] < 0)
+        return false;
+
+    if (_fseeki64(m_cacheFile, m_cacheChunkOffsets[descriptor.m_id], SEEK_SET) != 0)
+        return false;
+
+    chunk->m_sequenceMap.resize(descriptor.m_sequences.size());
+    for (const auto& sequenceDsc : descriptor.m_sequences)
+    {
+        SequenceBuffer sequence;
+        for (auto const& stream : m_streamInfos)
+        {
+            uint32_t numSamples = 0;
+            if (fread(&numSamples, sizeof(numSamples), 1, m_cacheFile) != 1)
+                return false; // truncated cache entry, fall back to parsing
+
+            if (stream.m_type == StorageType::dense)
+            {
+                auto data = make_unique<DenseInputStreamBuffer>(stream.m_sampleDimension * numSamples);
+                data->m_buffer.resize(stream.m_sampleDimension * numSamples);
+                if (!data->m_buffer.empty() &&
+                    fread(data->m_buffer.data(), sizeof(ElemType), data->m_buffer.size(), m_cacheFile) != data->m_buffer.size())
+                {
+                    return false;
+                }
+                data->m_numberOfSamples = numSamples;
+                sequence.push_back(std::move(data));
+            }
+            else
+            {
+                IndexType totalNnz = 0;
+                if (fread(&totalNnz, sizeof(totalNnz), 1, m_cacheFile) != 1 || totalNnz < 0)
+                    return false;
+
+                auto data = make_unique<SparseInputStreamBuffer>();
+                data->m_nnzCounts.resize(numSamples);
+                data->m_indicesBuffer.resize(totalNnz);
+                data->m_buffer.resize(totalNnz);
+                if ((numSamples != 0 &&
+                     fread(data->m_nnzCounts.data(), sizeof(IndexType), numSamples, m_cacheFile) != numSamples) ||
+                    (totalNnz != 0 &&
+                     (fread(data->m_indicesBuffer.data(), sizeof(IndexType), totalNnz, m_cacheFile) != (size_t)totalNnz ||
+                      fread(data->m_buffer.data(), sizeof(ElemType), totalNnz, m_cacheFile) != (size_t)totalNnz)))
+                {
+                    return false;
+                }
+                data->m_totalNnzCount = totalNnz;
+                data->m_numberOfSamples = numSamples;
+                sequence.push_back(std::move(data));
+            }
+        }
+
+        FillSequenceMetadata(sequence, sequenceDsc.m_id);
+        chunk->m_sequenceMap[sequenceDsc.m_id] = std::move(sequence);
+    }
+
+    return true;
+}
+
+template <class ElemType>
+void TextParser<ElemType>::SaveChunkToCache(const TextChunkPtr& chunk, const ChunkDescriptor& descriptor)
+{
+    if (m_cacheFile == nullptr)
+        return;
+
+    try
+    {
+        // Append the payload at the end of the sidecar and only then patch the offsets
+        // table entry, so that an interrupted write leaves the chunk marked as not cached.
+        if (_fseeki64(m_cacheFile, 0, SEEK_END) != 0)
+            RuntimeError("Error seeking to the end of the chunk cache file.");
+        int64_t chunkOffset = _ftelli64(m_cacheFile);
+
+        for (const auto& sequenceDsc : descriptor.m_sequences)
+        {
+            const auto& sequence = chunk->m_sequenceMap[sequenceDsc.m_id];
+            for (size_t j = 0; j < m_streamInfos.size(); ++j)
+            {
+                uint32_t numSamples = sequence[j]->m_numberOfSamples;
+                fwriteOrDie(&numSamples, sizeof(numSamples), 1, m_cacheFile);
+
+                if (m_streamInfos[j].m_type == StorageType::dense)
+                {
+                    auto data = static_cast<DenseInputStreamBuffer*>(sequence[j].get());
+                    if (!data->m_buffer.empty())
+                        fwriteOrDie(data->m_buffer.data(), sizeof(ElemType), data->m_buffer.size(), m_cacheFile);
+                }
+                else
+                {
+                    auto data = static_cast<SparseInputStreamBuffer*>(sequence[j].get());
+                    fwriteOrDie(&data->m_totalNnzCount, sizeof(data->m_totalNnzCount), 1, m_cacheFile);
+                    if (!data->m_nnzCounts.empty())
+                        fwriteOrDie(data->m_nnzCounts.data(), sizeof(IndexType), data->m_nnzCounts.size(), m_cacheFile);
+                    if (!data->m_indicesBuffer.empty())
+                        fwriteOrDie(data->m_indicesBuffer.data(), sizeof(IndexType), data->m_indicesBuffer.size(), m_cacheFile);
+                    if (!data->m_buffer.empty())
+                        fwriteOrDie(data->m_buffer.data(), sizeof(ElemType), data->m_buffer.size(), m_cacheFile);
+                }
+            }
+        }
+        fflushOrDie(m_cacheFile);
+
+        int64_t tableStart = sizeof(ChunkCacheHeader) + m_streamInfos.size() * sizeof(ChunkCacheStream);
+        if (_fseeki64(m_cacheFile, tableStart + descriptor.m_id * sizeof(int64_t), SEEK_SET) != 0)
+            RuntimeError("Error seeking to the offsets table of the chunk cache file.");
+        fwriteOrDie(&chunkOffset, sizeof(chunkOffset), 1, m_cacheFile);
+        fflushOrDie(m_cacheFile);
+
+        m_cacheChunkOffsets[descriptor.m_id] = chunkOffset;
+    }
+    catch (const std::exception& e)
+    {
+        // The cache is an optimization only, so a failure to write it must not fail the run.
+        fprintf(stderr, "WARNING: could not write to the chunk cache file: %s."
+            " Continuing without the chunk cache.\n", e.what());
+        fclose(m_cacheFile);
+        m_cacheFile = nullptr;
+    }
+}
+
 template <class ElemType>
 void TextParser<ElemType>::IncrementNumberOfErrorsOrDie()
 {
@@ -881,10 +1198,33 @@ bool TextParser<ElemType>::TryReadSparseSample(std::vector<ElemType>& values, st
 template <class ElemType>
 void TextParser<ElemType>::SkipToNextValue(size_t& bytesToRead)
 {
+    // skip everything until we hit either a value delimiter, an input marker or the end of row,
+    // comparing sixteen bytes at a time while the buffer allows it.
+    const __m128i space = _mm_set1_epi8(SPACE_CHAR);
+    const __m128i tab = _mm_set1_epi8(TAB_CHAR);
+    const __m128i namePrefix = _mm_set1_epi8(NAME_PREFIX);
+    const __m128i rowDelimiter = _mm_set1_epi8(ROW_DELIMITER);
     while (bytesToRead && CanRead())
     {
+        while (bytesToRead >= 16 && m_bufferEnd - m_pos >= 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_pos));
+            __m128i hits = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, namePrefix), _mm_cmpeq_epi8(block, rowDelimiter)));
+            int mask = _mm_movemask_epi8(hits);
+            if (mask != 0)
+            {
+                size_t offset = FirstSetBit(mask);
+                m_pos += offset;
+                bytesToRead -= offset;
+                return;
+            }
+            m_pos += 16;
+            bytesToRead -= 16;
+        }
+
         char c = *m_pos;
-        // skip everything until we hit either a value delimiter, an input marker or the end of row.
         if (isValueDelimiter(c) || c == NAME_PREFIX || c == ROW_DELIMITER)
         {
             return;
@@ -897,10 +1237,29 @@ void TextParser<ElemType>::SkipToNextValue(size_t& bytesToRead)
 template <class ElemType>
 void TextParser<ElemType>::SkipToNextInput(size_t& bytesToRead)
 {
+    // skip everything until we hit either an input marker or the end of row,
+    // comparing sixteen bytes at a time while the buffer allows it.
+    const __m128i namePrefix = _mm_set1_epi8(NAME_PREFIX);
+    const __m128i rowDelimiter = _mm_set1_epi8(ROW_DELIMITER);
     while (bytesToRead && CanRead())
     {
+        while (bytesToRead >= 16 && m_bufferEnd - m_pos >= 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_pos));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, namePrefix), _mm_cmpeq_epi8(block, rowDelimiter));
+            int mask = _mm_movemask_epi8(hits);
+            if (mask != 0)
+            {
+                size_t offset = FirstSetBit(mask);
+                m_pos += offset;
+                bytesToRead -= offset;
+                return;
+            }
+            m_pos += 16;
+            bytesToRead -= 16;
+        }
+
         char c = *m_pos;
-        // skip everything until we hit either an input marker or the end of row.
         if (c == NAME_PREFIX || c == ROW_DELIMITER)
         {
             return;
@@ -917,6 +1276,22 @@ bool TextParser<ElemType>::TryReadUint64(size_t& value, size_t& bytesToRead)
     bool found = false;
     while (bytesToRead && CanRead())
     {
+        // Consume eight digits at a time while the buffer allows it and the result
+        // cannot overflow; the scalar loop below handles the tail and near-overflow values.
+        while (bytesToRead >= 8 && m_bufferEnd - m_pos >= 8 &&
+               value <= (SIZE_MAX - 99999999) / 100000000 && IsEightDigits(m_pos))
+        {
+            value = value * 100000000 + ParseEightDigits(m_pos);
+            m_pos += 8;
+            bytesToRead -= 8;
+            found = true;
+        }
+
+        if (!bytesToRead || !CanRead())
+        {
+            break;
+        }
+
         char c = *m_pos;
 
         if (!IsDigit(c))
@@ -1022,6 +1397,18 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
             if (IsDigit(c))
             {
                 number = number * 10 + (c - '0');
+                ++m_pos;
+                --bytesToRead;
+                // Consume eight digits at a time while the buffer allows it. The combined
+                // value is identical to the per-digit accumulation for all integral parts
+                // that are exactly representable in a double.
+                while (bytesToRead >= 8 && m_bufferEnd - m_pos >= 8 && IsEightDigits(m_pos))
+                {
+                    number = number * 100000000.0 + ParseEightDigits(m_pos);
+                    m_pos += 8;
+                    bytesToRead -= 8;
+                }
+                continue;
             }
             else if (c == '.')
             {
@@ -1060,6 +1447,17 @@ bool TextParser<ElemType>::TryReadRealNumber(ElemType& value, size_t& bytesToRea
                 // no state change
                 number = number * 10 + (c - '0');
                 divider *= 10;
+                ++m_pos;
+                --bytesToRead;
+                // Consume eight digits at a time while the buffer allows it.
+                while (bytesToRead >= 8 && m_bufferEnd - m_pos >= 8 && IsEightDigits(m_pos))
+                {
+                    number = number * 100000000.0 + ParseEightDigits(m_pos);
+                    divider *= 100000000.0;
+                    m_pos += 8;
+                    bytesToRead -= 8;
+                }
+                continue;
             }
             else if (isE(c))
             {
@@ -1183,6 +1581,24 @@ void TextParser<ElemType>::SetChunkSize(size_t size)
     m_chunkSizeBytes = size;
 }
 
+template <class ElemType>
+void TextParser<ElemType>::SetNumIndexingThreads(size_t numThreads)
+{
+    m_numIndexingThreads = numThreads;
+}
+
+template <class ElemType>
+void TextParser<ElemType>::SetCacheIndex(bool cacheIndex)
+{
+    m_cacheIndex = cacheIndex;
+}
+
+template <class ElemType>
+void TextParser<ElemType>::SetCacheChunks(bool cacheChunks)
+{
+    m_cacheChunks = cacheChunks;
+}
+
 template <class ElemType>
 void TextParser<ElemType>::SetNumRetries(unsigned int numRetries)
 {
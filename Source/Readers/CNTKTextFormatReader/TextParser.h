@@ -116,6 +116,16 @@ private:
     unique_ptr<char[]> m_scratch; // local buffer for string parsing
 
     size_t m_chunkSizeBytes;
+    size_t m_numIndexingThreads; // number of threads used to index the input file
+    bool m_cacheIndex; // if true, the index is cached on disk and reused across runs
+    bool m_cacheChunks; // if true, parsed chunks are cached on disk in a binary sidecar file
+
+    // Sidecar file with parsed chunks in a binary format, nullptr if chunk
+    // caching is disabled or the sidecar could not be opened.
+    FILE* m_cacheFile;
+    // File offset of each cached chunk payload in the sidecar, -1 if the chunk
+    // has not been cached yet.
+    std::vector<int64_t> m_cacheChunkOffsets;
     unsigned int m_traceLevel;
     bool m_hadWarnings;
     unsigned int m_numAllowedErrors;
@@ -182,6 +192,17 @@ private:
     // Given a descriptor, retrieves the data for the corresponding chunk from the file.
     void LoadChunk(TextChunkPtr& chunk, const ChunkDescriptor& descriptor);
 
+    // Opens (or creates) the binary chunk cache sidecar file, validating it
+    // against the input file. Disables chunk caching on failure.
+    void OpenChunkCache();
+
+    // Tries to load a chunk from the binary sidecar. Returns false if the chunk
+    // has not been cached yet or the cached payload cannot be read.
+    bool TryLoadCachedChunk(TextChunkPtr& chunk, const ChunkDescriptor& descriptor);
+
+    // Appends a freshly parsed chunk to the binary sidecar.
+    void SaveChunkToCache(const TextChunkPtr& chunk, const ChunkDescriptor& descriptor);
+
     // Fills some metadata members to be conformant to the exposed SequenceData interface.
     void FillSequenceMetadata(SequenceBuffer& sequenceBuffer, size_t sequenceId);
 
@@ -193,6 +214,12 @@ private:
 
     void SetChunkSize(size_t size);
 
+    void SetNumIndexingThreads(size_t numThreads);
+
+    void SetCacheIndex(bool cacheIndex);
+
+    void SetCacheChunks(bool cacheChunks);
+
     void SetNumRetries(unsigned int numRetries);
 
     friend class CNTKTextFormatReaderTestRunner<ElemType>;
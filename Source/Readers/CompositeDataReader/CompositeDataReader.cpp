@@ -118,7 +118,31 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
         randomizationWindow = config(L"randomizationWindow", randomizationWindow);
 
         bool shouldPrefetch = true;
-        m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch, multiThreadedDeserialization, maxErrors);
+        // Fetch this many upcoming chunks ahead of use; deeper queues help when chunk fetch
+        // latency is high (e.g. network file systems) and chunk transitions cluster.
+        size_t prefetchDepth = config(L"prefetchDepth", (size_t)1);
+
+        // Optional sequence length bucket boundaries, e.g. lengthBucketBoundaries = 10:20:40:80.
+        // Within the randomization window, sequences are then grouped by length bucket, which
+        // reduces padding in the packed minibatches at the cost of some randomization.
+        std::vector<size_t> lengthBucketBoundaries;
+        if (config.Exists(L"lengthBucketBoundaries"))
+        {
+            intargvector boundaries = config(L"lengthBucketBoundaries");
+            for (int i = 0; i < (int)boundaries.size(); ++i)
+            {
+                if (boundaries[i] <= 0)
+                    InvalidArgument("lengthBucketBoundaries must contain positive sequence lengths.");
+                lengthBucketBoundaries.push_back((size_t)boundaries[i]);
+            }
+        }
+
+        // Optional memory budget for the randomization window, in MB. When set, the window
+        // is derived from the chunk sizes and the budget instead of randomizationWindow,
+        // so configs do not need corpus-specific window values.
+        size_t randomizationMemoryBudgetInBytes = (size_t)config(L"randomizationMemoryBudgetInMB", (size_t)0) * 1024 * 1024;
+
+        m_sequenceEnumerator = std::make_shared<BlockRandomizer>(verbosity, randomizationWindow, deserializer, shouldPrefetch, multiThreadedDeserialization, maxErrors, prefetchDepth, lengthBucketBoundaries, randomizationMemoryBudgetInBytes);
     }
     else
     {
@@ -144,9 +168,14 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
         m_streams.push_back(stream);
     }
 
-    // Currently for prefetch we use two alternating buffers,
-    // same is the default.
-    size_t numAlternatingBuffers = 2;
+    // Number of alternating packing buffers. This must match the prefetch/transfer ring depth
+    // of the reader shim (same config key, same default): each in-flight read pins the host
+    // buffer its minibatch was packed into until the asynchronous device copy completes, so
+    // with fewer buffers than in-flight reads a read running ahead would repack host memory
+    // whose device copy has not finished yet.
+    size_t numAlternatingBuffers = config(L"numPrefetchBuffers", (size_t)2);
+    if (numAlternatingBuffers < 2)
+        InvalidArgument("numPrefetchBuffers must be at least 2.");
 
     // Check whether to use local timeline, by default we use it for better performance.
     bool localTimeline = config(L"localTimeline", true);
@@ -170,7 +199,8 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
     {
         m_packer = std::make_shared<TruncatedBPTTPacker>(
             m_sequenceEnumerator,
-            m_streams);
+            m_streams,
+            numAlternatingBuffers);
         break;
     }
     default:
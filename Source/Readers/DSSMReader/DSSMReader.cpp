@@ -13,9 +13,31 @@
 #include <vld.h> // leak detection
 #endif
 #include "fileutil.h" // for fexists()
+#include "CUDAPageLockedMemAllocator.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// Allocates a staging buffer for the CSC batch assembly; pinned memory for GPU devices so the
+// upload to the device does not have to re-stage the data, plain CPU memory otherwise.
+template <class ElemType>
+static std::shared_ptr<ElemType> AllocateIntermediateBuffer(int deviceId, size_t numElements)
+{
+    if (deviceId >= 0)
+    {
+        size_t totalSize = sizeof(ElemType) * numElements;
+        return std::shared_ptr<ElemType>((ElemType*) CUDAPageLockedMemAllocator::Malloc(totalSize, deviceId),
+                                         [deviceId](ElemType* p)
+                                         {
+                                             CUDAPageLockedMemAllocator::Free(p, deviceId);
+                                         });
+    }
+
+    return std::shared_ptr<ElemType>(new ElemType[numElements], [](ElemType* p)
+                                     {
+                                         delete[] p;
+                                     });
+}
+
 DWORD HIDWORD(size_t size)
 {
     return size >> 32;
@@ -451,6 +473,15 @@ bool DSSMReader<ElemType>::DataEnd() { return true; }
 template <class ElemType>
 DSSM_BinaryInput<ElemType>::DSSM_BinaryInput()
 {
+    offsets_orig = NULL;
+    offsets = NULL;
+    m_window = NULL;
+    m_windowBuffer = NULL;
+    m_windowBeg = m_windowEnd = 0;
+    m_dataRegionBase = m_dataSize = 0;
+    m_deviceId = -1;
+    m_batchBufferSize = 0;
+    m_batch[0].valid = m_batch[1].valid = false;
 }
 template <class ElemType>
 DSSM_BinaryInput<ElemType>::~DSSM_BinaryInput()
@@ -502,13 +533,13 @@ void DSSM_BinaryInput<ElemType>::Init(wstring fileName, size_t dim)
 
     int64_t header_size = numRows * sizeof(int64_t) + offsets_padding;
 
-    void* offsets_orig2 = MapViewOfFile(m_filemap,     // handle to map object
-                                       FILE_MAP_READ, // get correct permissions
-                                       HIDWORD(base_offset),
-                                       LODWORD(base_offset),
-                                       header_size);
+    offsets_orig = MapViewOfFile(m_filemap,     // handle to map object
+                                 FILE_MAP_READ, // get correct permissions
+                                 HIDWORD(base_offset),
+                                 LODWORD(base_offset),
+                                 header_size);
 
-    offsets_buffer = (char*) offsets_orig2 + offsets_padding;
+    offsets_buffer = (char*) offsets_orig + offsets_padding;
 
     if (offsets != NULL)
     {
@@ -517,141 +548,190 @@ void DSSM_BinaryInput<ElemType>::Init(wstring fileName, size_t dim)
     offsets = (int64_t*) malloc(sizeof(int64_t) * numRows);
     memcpy(offsets, offsets_buffer, numRows * sizeof(int64_t));
 
-    int64_t header_offset = base_offset + offsets_padding + numRows * sizeof(int64_t);
+    // The record data itself is no longer mapped as one whole-file view; Next_Batch slides a
+    // bounded window over it, so only the blocks being streamed occupy address space and RAM.
+    m_sysGran = sysGran;
+    m_dataRegionBase = base_offset + offsets_padding + numRows * sizeof(int64_t);
 
-    int64_t data_padding = header_offset % sysGran;
-    header_offset -= data_padding;
-
-    void* data_orig2 = MapViewOfFile(m_filemap,     // handle to map object
-                                    FILE_MAP_READ, // get correct permissions
-                                    HIDWORD(header_offset),
-                                    LODWORD(header_offset),
-                                    0);
-    data_buffer = (char*) data_orig2 + data_padding;
+    int64_t fileSize = 0;
+    GetFileSizeEx(m_hndl, (PLARGE_INTEGER) &fileSize);
+    m_dataSize = fileSize - m_dataRegionBase;
 }
+
+// EnsureDataWindow - make sure the mapped window covers [beg, end) of the record data region
+// (offsets relative to the start of the record data). The window is extended well past 'end'
+// so consecutive batches keep hitting the same mapping.
 template <class ElemType>
-bool DSSM_BinaryInput<ElemType>::SetupEpoch(size_t minibatchSize)
+void DSSM_BinaryInput<ElemType>::EnsureDataWindow(int64_t beg, int64_t end)
 {
-    if (values == NULL || mbSize < minibatchSize)
-    {
-        if (values != NULL)
-        {
-            free(values);
-            free(colIndices);
-            free(rowIndices);
-        }
+    static const int64_t DATA_WINDOW_SIZE = 256 * 1024 * 1024;
 
-        values = (ElemType*) malloc(sizeof(ElemType) * MAX_BUFFER * minibatchSize);
-        colIndices = (int32_t*) malloc(sizeof(int32_t) * (minibatchSize + 1));
-        rowIndices = (int32_t*) malloc(sizeof(int32_t) * MAX_BUFFER * minibatchSize);
-        // fprintf(stderr, "values  size: %d",sizeof(ElemType)*MAX_BUFFER*minibatchSize);
-        // fprintf(stderr, "colindi size: %d",sizeof(int32_t)*MAX_BUFFER*(1+minibatchSize));
-        // fprintf(stderr, "rowindi size: %d",sizeof(int32_t)*MAX_BUFFER*minibatchSize);
+    if (m_window != NULL && beg >= m_windowBeg && end <= m_windowEnd)
+        return;
+
+    if (m_window != NULL)
+    {
+        UnmapViewOfFile(m_window);
+        m_window = NULL;
     }
-    if (minibatchSize > mbSize)
+
+    int64_t mapBeg = m_dataRegionBase + beg;
+    int64_t mapPadding = mapBeg % m_sysGran;
+    mapBeg -= mapPadding;
+
+    int64_t windowEnd = beg + max(end - beg, DATA_WINDOW_SIZE);
+    if (windowEnd > m_dataSize)
+        windowEnd = m_dataSize;
+    int64_t mapEnd = m_dataRegionBase + windowEnd;
+
+    m_window = MapViewOfFile(m_filemap,     // handle to map object
+                             FILE_MAP_READ, // get correct permissions
+                             HIDWORD(mapBeg),
+                             LODWORD(mapBeg),
+                             (SIZE_T)(mapEnd - mapBeg));
+    if (m_window == NULL)
     {
-        mbSize = minibatchSize;
+        RuntimeError("DSSM_BinaryInput: unable to map data window, error %x", GetLastError());
     }
 
-    return true;
+    m_windowBuffer = (char*) m_window + mapPadding;
+    m_windowBeg = beg;
+    m_windowEnd = windowEnd;
 }
+
+// ParseBatch - assemble the CSC arrays for records [cur, cur + numToRead) into the given
+// staging buffers; runs on the prefetch task, off the training thread
 template <class ElemType>
-bool DSSM_BinaryInput<ElemType>::Next_Batch(Matrix<ElemType>& matrices, size_t cur, size_t numToRead, int* /*ordering*/)
+void DSSM_BinaryInput<ElemType>::ParseBatch(size_t cur, size_t numToRead, BatchBuffer& batch)
 {
-    /*
-    int devId = matrices.GetDeviceId();
-    matrices.TransferFromDeviceToDevice(devId, -1);
-    */
+    batch.valid = false;
+    batch.startRecord = cur;
 
-    int32_t cur_index = 0;
+    int64_t beg = offsets[cur];
+    int64_t end = (cur + numToRead < (size_t) numRows) ? offsets[cur + numToRead] : m_dataSize;
+    EnsureDataWindow(beg, end);
 
-    for (int c = 0; c < numToRead; c++, cur++)
+    ElemType* values = batch.values.get();
+    int32_t* rowIndices = batch.rowIndices.get();
+    int32_t* colIndices = batch.colIndices.get();
+
+    int32_t cur_index = 0;
+    for (int c = 0; c < numToRead; c++)
     {
-        // int64_t cur_offset = offsets[ordering[cur]];
-        int64_t cur_offset = offsets[cur];
-        // int64_t cur_offset = offsets[ordering[c]];
-        // int32_t nnz;
+        int64_t cur_offset = offsets[cur + c] - m_windowBeg;
         colIndices[c] = cur_index;
-        int32_t nnz = *(int32_t*) ((char*) data_buffer + cur_offset);
-        // memcpy(&nnz, (char*)data_buffer + cur_offset, sizeof(int32_t));
-        memcpy(values + cur_index, (char*) data_buffer + cur_offset + sizeof(int32_t), sizeof(ElemType) * nnz);
-        memcpy(rowIndices + cur_index, (char*) data_buffer + cur_offset + sizeof(int32_t) + sizeof(ElemType) * nnz, sizeof(int32_t) * nnz);
-        /**
-        fprintf(stderr, "%4d (%3d, %6d): ", c, nnz, cur_index + nnz);
-        for (int i = 0; i < nnz; i++)
-        {
-            fprintf(stderr, "%d:%.f ", rowIndices[cur_index+i], values[cur_index+i]);
-            // matrices.SetValue(rowIndices[cur_index + i], c, values[cur_index + i]);
-        }
-        fprintf(stderr, "\n");
-        **/
-
+        int32_t nnz = *(int32_t*) (m_windowBuffer + cur_offset);
+        memcpy(values + cur_index, m_windowBuffer + cur_offset + sizeof(int32_t), sizeof(ElemType) * nnz);
+        memcpy(rowIndices + cur_index, m_windowBuffer + cur_offset + sizeof(int32_t) + sizeof(ElemType) * nnz, sizeof(int32_t) * nnz);
         cur_index += nnz;
     }
     colIndices[numToRead] = cur_index;
-    /*
-    int col = 0;
-    for (int c = 0; c < cur_index; c++)
+
+    batch.numRecords = numToRead;
+    batch.nnz = cur_index;
+    batch.valid = true;
+}
+
+// WaitForPrefetch - wait for a scheduled background parse; errors it hit surface here
+template <class ElemType>
+void DSSM_BinaryInput<ElemType>::WaitForPrefetch()
+{
+    if (m_prefetchInflight.valid())
+        m_prefetchInflight.get();
+}
+template <class ElemType>
+bool DSSM_BinaryInput<ElemType>::SetupEpoch(size_t minibatchSize)
+{
+    // a batch prefetched for the previous epoch's position is of no use now; the staging
+    // buffers themselves are (re)allocated in Next_Batch, where the target device is known
+    WaitForPrefetch();
+    m_batch[0].valid = m_batch[1].valid = false;
+
+    if (minibatchSize > mbSize)
+    {
+        mbSize = minibatchSize;
+    }
+
+    return true;
+}
+template <class ElemType>
+bool DSSM_BinaryInput<ElemType>::Next_Batch(Matrix<ElemType>& matrices, size_t cur, size_t numToRead, int* /*ordering*/)
+{
+    // (re)allocate the staging buffers on first use, or when the minibatch size grew or the
+    // target device changed; pinned for GPU targets so the CSC upload goes straight from here
+    int deviceId = matrices.GetDeviceId();
+    if (m_batch[0].values == nullptr || m_batchBufferSize < mbSize || m_deviceId != deviceId)
     {
-        if (colIndices[col] == c)
+        WaitForPrefetch();
+        for (int b = 0; b < 2; b++)
         {
-            fprintf(stderr, "\n%4d: ", col);
-            col++;
+            m_batch[b].values = AllocateIntermediateBuffer<ElemType>(deviceId, MAX_BUFFER * mbSize);
+            m_batch[b].rowIndices = AllocateIntermediateBuffer<int32_t>(deviceId, MAX_BUFFER * mbSize);
+            m_batch[b].colIndices = AllocateIntermediateBuffer<int32_t>(deviceId, mbSize + 1);
+            m_batch[b].valid = false;
         }
-        fprintf(stderr, "%d:%.f ", rowIndices[c], values[c]);
+        m_batchBufferSize = mbSize;
+        m_deviceId = deviceId;
     }
-    */
-    /*
-    fprintf(stderr, "\nXXXX nnz: %d\n", cur_index);
-    fprintf(stderr, "XXXX max values read: %d vs %d\n", sizeof(ElemType)*cur_index, sizeof(ElemType)*MAX_BUFFER*numToRead);
-    fprintf(stderr, "XXXX max indices read: %d vs %d\n", sizeof(int32_t)*cur_index, sizeof(int32_t)*MAX_BUFFER*numToRead);
-    fprintf(stderr, "XXXX sizeof(int32_t) = %d, sizeof(int) = %d\n", sizeof(int32_t), sizeof(int));
-    */
-    /*
-        values = (ElemType*)malloc(sizeof(ElemType)*MAX_BUFFER*minibatchSize);
-        colIndices = (int32_t*)malloc(sizeof(int32_t)*MAX_BUFFER*(minibatchSize+1));
-        rowIndices = (int32_t*)malloc(sizeof(int32_t)*MAX_BUFFER*minibatchSize);
-        */
-
-    matrices.SetMatrixFromCSCFormat(colIndices, rowIndices, values, cur_index, m_dim, numToRead);
-    // matrices.Print("actual values");
-    // exit(1);
-    /*
-    matrices.SwitchToMatrixType(MatrixType::DENSE, MatrixFormat::matrixFormatDense);
-    matrices.Print("featuresQ");
-    exit(1);
-    matrices.TransferFromDeviceToDevice(-1,devId);
-    */
+
+    // pick up the prefetched batch; if none matches the requested range (first batch of an
+    // epoch, or the caller changed position), assemble it synchronously right here
+    WaitForPrefetch();
+    if (!m_batch[1].valid || m_batch[1].startRecord != cur || m_batch[1].numRecords != numToRead)
+        ParseBatch(cur, numToRead, m_batch[1]);
+    std::swap(m_batch[0], m_batch[1]);
+
+    // assemble the following batch in the background while this one uploads and trains
+    size_t next = cur + numToRead;
+    if (next < (size_t) numRows)
+    {
+        size_t numNext = min(mbSize, (size_t) numRows - next);
+        m_prefetchInflight = std::async(std::launch::async, [this, next, numNext]()
+                                        {
+                                            ParseBatch(next, numNext, m_batch[1]);
+                                        });
+    }
+
+    BatchBuffer& batch = m_batch[0];
+    matrices.SetMatrixFromCSCFormat(batch.colIndices.get(), batch.rowIndices.get(), batch.values.get(), batch.nnz, m_dim, numToRead);
+    batch.valid = false;
     return true;
 }
 
 template <class ElemType>
 void DSSM_BinaryInput<ElemType>::Dispose()
 {
-    if (offsets_orig != NULL)
+    // an outstanding background parse still reads from the window and the staging buffers
+    try
     {
-        UnmapViewOfFile(offsets_orig);
+        WaitForPrefetch();
     }
-    if (data_orig != NULL)
+    catch (...)
     {
-        UnmapViewOfFile(data_orig);
     }
 
-    if (offsets != NULL)
+    if (offsets_orig != NULL)
     {
-        free(offsets); // = (ElemType*)malloc(sizeof(float)* 230 * 1024);
+        UnmapViewOfFile(offsets_orig);
+        offsets_orig = NULL;
     }
-    if (values != NULL)
+    if (m_window != NULL)
     {
-        free(values); // = (ElemType*)malloc(sizeof(float)* 230 * 1024);
+        UnmapViewOfFile(m_window);
+        m_window = NULL;
     }
-    if (rowIndices != NULL)
+
+    if (offsets != NULL)
     {
-        free(rowIndices); // = (int*)malloc(sizeof(float)* 230 * 1024);
+        free(offsets); // = (ElemType*)malloc(sizeof(float)* 230 * 1024);
+        offsets = NULL;
     }
-    if (colIndices != NULL)
+    for (int b = 0; b < 2; b++)
     {
-        free(colIndices); // = (int*)malloc(sizeof(float)* 230 * 1024);
+        m_batch[b].values = nullptr;
+        m_batch[b].rowIndices = nullptr;
+        m_batch[b].colIndices = nullptr;
+        m_batch[b].valid = false;
     }
 }
 
@@ -12,6 +12,8 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
+#include <future>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -35,20 +37,46 @@ private:
 
     // void* header_orig; // Don't need this since the header is at the start of the file
     void* offsets_orig;
-    void* data_orig;
 
     void* header_buffer;
     void* offsets_buffer;
-    void* data_buffer;
 
     size_t m_dim;
     size_t mbSize;
     size_t MAX_BUFFER = 300;
 
-    ElemType* values;    // = (ElemType*)malloc(sizeof(float)* 230 * 1024);
-    int64_t* offsets;    // = (int*)malloc(sizeof(int)* 230 * 1024);
-    int32_t* colIndices; // = (int*)malloc(sizeof(int)* (batchsize + 1));
-    int32_t* rowIndices; // = (int*)malloc(sizeof(int)* MAX_BUFFER * batchsize);
+    int64_t* offsets; // = (int*)malloc(sizeof(int)* 230 * 1024);
+
+    // one minibatch's worth of CSC staging, allocated pinned (CUDAPageLockedMemAllocator)
+    // when the consuming matrix lives on a GPU so the device upload does not re-stage
+    struct BatchBuffer
+    {
+        std::shared_ptr<ElemType> values;
+        std::shared_ptr<int32_t> rowIndices;
+        std::shared_ptr<int32_t> colIndices;
+        size_t startRecord;
+        size_t numRecords;
+        int32_t nnz;
+        bool valid;
+    };
+    BatchBuffer m_batch[2]; // [0] front (being consumed), [1] staging (being filled ahead)
+    std::future<void> m_prefetchInflight;
+    int m_deviceId;           // device the staging buffers are allocated for
+    size_t m_batchBufferSize; // minibatch size the staging buffers are sized for
+
+    // sliding mapped window over the record data; replaces the old whole-file view, so only
+    // a bounded slice of the corpus occupies address space and page cache at a time
+    int64_t m_dataRegionBase; // absolute file offset where the record data begins
+    int64_t m_dataSize;       // size of the record data region
+    void* m_window;           // current MapViewOfFile view (allocation-granularity aligned)
+    char* m_windowBuffer;     // first data byte of the window, i.e. data-region offset m_windowBeg
+    int64_t m_windowBeg;      // data-region offset covered by the window: [m_windowBeg, m_windowEnd)
+    int64_t m_windowEnd;
+    DWORD m_sysGran;
+
+    void EnsureDataWindow(int64_t beg, int64_t end);
+    void ParseBatch(size_t cur, size_t numToRead, BatchBuffer& batch);
+    void WaitForPrefetch();
 
 public:
     int64_t numRows;
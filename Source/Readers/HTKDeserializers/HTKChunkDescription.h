@@ -7,10 +7,13 @@
 
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <memory>
+#include <mutex>
 #include "DataDeserializer.h"
 #include "../HTKMLFReader/htkfeatio.h"
 #include "UtteranceDescription.h"
 #include "ssematrix.h"
+#include "ConcStack.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -36,6 +39,15 @@ class HTKChunkDescription
     // Chunk id.
     ChunkIdType m_chunkId;
 
+    // Lazy-loading state (only set between RequireData(..., lazy = true) and ReleaseData).
+    // A once-flag per utterance makes the first-touch read safe when GetSequence is
+    // called from several prefetch threads; readers are pooled so consecutive utterances
+    // from the same archive keep the file open, as the eager path does.
+    mutable std::unique_ptr<std::once_flag[]> m_utteranceLoadFlags;
+    mutable std::shared_ptr<conc_stack<std::shared_ptr<msra::asr::htkfeatreader>>> m_readers;
+    mutable std::string m_featureKind;
+    mutable unsigned int m_samplePeriod = 0;
+
 public:
 
     HTKChunkDescription() : m_chunkId(CHUNKID_MAX) { };
@@ -110,6 +122,12 @@ public:
             LogicError("GetUtteranceFrames was called when data have not yet been paged in.");
         }
 
+        // With lazy loading the utterance is faulted in on first touch.
+        if (m_utteranceLoadFlags)
+        {
+            std::call_once(m_utteranceLoadFlags[index], [this, index]() { LoadUtterance(index); });
+        }
+
         const size_t ts = m_firstFrames[index];
         const size_t n = m_utterances[index].GetNumberOfFrames();
         return msra::dbn::matrixstripe(m_frames, ts, n);
@@ -118,7 +136,10 @@ public:
     // Pages-in the data for this chunk.
     // this function supports retrying since we read from the unreliable network, i.e. do not return in a broken state
     // We pass in the feature info variables to check that that data being read has expected properties.
-    void RequireData(const string& featureKind, size_t featureDimension, unsigned int samplePeriod, int verbosity = 0) const
+    // When lazyUtteranceLoading is set, only the frame storage is allocated here and each
+    // utterance is read by GetUtteranceFrames on first touch, so heavily decimated epochs
+    // pay I/O only for the utterances they actually consume.
+    void RequireData(const string& featureKind, size_t featureDimension, unsigned int samplePeriod, int verbosity = 0, bool lazyUtteranceLoading = false) const
     {
         if (GetNumberOfUtterances() == 0)
         {
@@ -132,12 +153,30 @@ public:
 
         try
         {
+            m_frames.resize(featureDimension, m_totalFrames);
+
+            if (lazyUtteranceLoading)
+            {
+                m_featureKind = featureKind;
+                m_samplePeriod = samplePeriod;
+                m_utteranceLoadFlags.reset(new std::once_flag[m_utterances.size()]);
+                m_readers = std::make_shared<conc_stack<std::shared_ptr<msra::asr::htkfeatreader>>>();
+
+                if (verbosity)
+                {
+                    fprintf(stderr, "HTKChunkDescription::RequireData: deferred load of physical chunk %u (%" PRIu64 " utterances, %" PRIu64 " frames)\n",
+                            m_chunkId,
+                            m_utterances.size(),
+                            m_totalFrames);
+                }
+                return;
+            }
+
             // feature reader (we reinstantiate it for each block, i.e. we reopen the file actually)
             // if this is the first feature read ever, we explicitly open the first file to get the information such as feature dimension
             msra::asr::htkfeatreader reader;
 
             // read all utterances; if they are in the same archive, htkfeatreader will be efficient in not closing the file
-            m_frames.resize(featureDimension, m_totalFrames);
             foreach_index(i, m_utterances)
             {
                 // read features for this file
@@ -157,6 +196,8 @@ public:
         catch (...)
         {
             // Releasing all data
+            m_utteranceLoadFlags.reset();
+            m_readers.reset();
             m_frames.resize(0, 0);
             throw;
         }
@@ -185,6 +226,8 @@ public:
         }
 
         // release frames
+        m_utteranceLoadFlags.reset();
+        m_readers.reset();
         m_frames.resize(0, 0);
     }
 
@@ -194,6 +237,20 @@ public:
         {
             return !m_frames.empty();
         }
+
+        // Reads a single utterance into its stripe of m_frames (lazy path only).
+        void LoadUtterance(size_t index) const
+        {
+            // this function supports retrying since we read from the unreliable network
+            msra::util::attempt(5, [this, index]()
+            {
+                auto reader = m_readers->pop_or_create([]() { return std::make_shared<msra::asr::htkfeatreader>(); });
+                msra::dbn::matrixstripe framesWrapper(m_frames, m_firstFrames[index], m_utterances[index].GetNumberOfFrames());
+                const std::string& featureKind = m_featureKind; // const to pick the checking read() overload
+                reader->read(m_utterances[index].GetPath(), featureKind, m_samplePeriod, framesWrapper);
+                m_readers->push(std::move(reader));
+            });
+        }
 };
 
 }}}
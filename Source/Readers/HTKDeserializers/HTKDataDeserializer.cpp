@@ -53,6 +53,8 @@ HTKDataDeserializer::HTKDataDeserializer(
         InvalidArgument("Cannot expand utterances of the primary stream %ls, please change your configuration.", inputName.c_str());
     }
 
+    m_lazyUtteranceLoading = cfg(L"lazyUtteranceLoading", false);
+
     ConfigParameters streamConfig = input(inputName);
 
     ConfigHelper config(streamConfig);
@@ -98,6 +100,8 @@ HTKDataDeserializer::HTKDataDeserializer(
         InvalidArgument("Cannot expand utterances of the primary stream %ls, please change your configuration.", featureName.c_str());
     }
 
+    m_lazyUtteranceLoading = feature(L"lazyUtteranceLoading", false);
+
     InitializeChunkDescriptions(config.GetSequencePaths());
     InitializeStreams(featureName);
     InitializeFeatureInformation();
@@ -337,7 +341,7 @@ public:
         // making several attempts
         msra::util::attempt(5, [&]()
         {
-            chunkDescription.RequireData(m_parent->m_featureKind, m_parent->m_ioFeatureDimension, m_parent->m_samplePeriod, m_parent->m_verbosity);
+            chunkDescription.RequireData(m_parent->m_featureKind, m_parent->m_ioFeatureDimension, m_parent->m_samplePeriod, m_parent->m_verbosity, m_parent->m_lazyUtteranceLoading);
         });
     }
 
@@ -88,6 +88,11 @@ private:
     // A flag that indicates whether the utterance should be extended to match the lenght of the utterance from the primary deserializer.
     // TODO: This should be moved to the packers when deserializers work in sequence mode only.
     bool m_expandToPrimary;
+
+    // A flag that indicates whether chunk data should be read per utterance on first access
+    // instead of eagerly on chunk load. Useful in frame mode with heavy decimation, where
+    // most utterances of a chunk are never touched.
+    bool m_lazyUtteranceLoading;
 };
 
 typedef std::shared_ptr<HTKDataDeserializer> HTKDataDeserializerPtr;
@@ -7,6 +7,7 @@
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 #include <limits>
+#include <sys/stat.h>
 #include "MLFDataDeserializer.h"
 #include "ConfigHelper.h"
 #include "SequenceData.h"
@@ -14,6 +15,7 @@
 #include "../HTKMLFReader/msra_mgram.h"
 #include "latticearchive.h"
 #include "StringUtil.h"
+#include "ExceptionCapture.h"
 
 
 #undef max // max is defined in minwindef.h
@@ -46,6 +48,263 @@ struct MLFUtterance : SequenceDescription
     size_t m_sequenceStart;
 };
 
+// Header of the binary label cache sidecar file. The sidecar stores the label runs of
+// all utterances of the MLF (before corpus filtering, so that the same cache serves
+// differently restricted jobs), so that runs after the first one read binary data
+// instead of re-parsing the text transcript. The header is followed by one
+// LabelCacheFile record per MLF path and then by the per-utterance records:
+// key length, key bytes, run count and the LabelCacheRun array.
+struct LabelCacheHeader
+{
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_unused;
+    uint64_t m_pathsHash; // hash over the MLF paths the cache was built from
+    uint64_t m_numFiles;
+    uint64_t m_numUtterances;
+};
+
+// Size and last modification time of an input MLF file the cache was built from.
+struct LabelCacheFile
+{
+    int64_t m_fileSize;
+    int64_t m_fileTime;
+};
+
+// One label run of an utterance; mirrors msra::asr::htkmlfentry.
+struct LabelCacheRun
+{
+    uint32_t m_firstFrame;
+    uint32_t m_numFrames;
+    uint32_t m_classId;
+};
+
+const static uint64_t LABEL_CACHE_MAGIC = 0x434C464C4D4B5448ULL; // "HTKMLFLC"
+const static uint32_t LABEL_CACHE_VERSION = 1;
+
+static bool GetFileSizeAndTime(const wstring& path, LabelCacheFile& info)
+{
+#ifdef _MSC_VER
+    struct _stat64 s;
+    if (_wstat64(path.c_str(), &s) != 0)
+        return false;
+#else
+    struct stat s;
+    if (stat(msra::strfun::utf8(path).c_str(), &s) != 0)
+        return false;
+#endif
+    info.m_fileSize = (int64_t)s.st_size;
+    info.m_fileTime = (int64_t)s.st_mtime;
+    return true;
+}
+
+static uint64_t HashPaths(const vector<wstring>& paths)
+{
+    std::hash<wstring> hasher;
+    uint64_t hash = paths.size();
+    for (const auto& p : paths)
+        hash = hash * 0x9E3779B97F4A7C15ULL + hasher(p);
+    return hash;
+}
+
+static FILE* OpenLabelCache(const wstring& path, const char* mode)
+{
+#ifdef _MSC_VER
+    return _wfopen(path.c_str(), wstring(mode, mode + strlen(mode)).c_str());
+#else
+    return fopen(msra::strfun::utf8(path).c_str(), mode);
+#endif
+}
+
+// Label runs of all utterances of the MLF set, keyed by the utf8 utterance key.
+typedef vector<pair<string, vector<LabelCacheRun>>> LabelCacheEntries;
+
+// Tries to load the label cache sidecar. Returns false (and leaves 'entries' empty)
+// if the cache does not exist, was built from a different set of MLF paths, or any
+// of the MLF files changed since it was written.
+static bool TryReadLabelCache(const wstring& cachePath, const vector<wstring>& mlfPaths, LabelCacheEntries& entries)
+{
+    FILE* f = OpenLabelCache(cachePath, "rb");
+    if (f == nullptr)
+        return false;
+
+    bool ok = false;
+    do
+    {
+        LabelCacheHeader header;
+        if (fread(&header, sizeof(header), 1, f) != 1 ||
+            header.m_magic != LABEL_CACHE_MAGIC ||
+            header.m_version != LABEL_CACHE_VERSION ||
+            header.m_pathsHash != HashPaths(mlfPaths) ||
+            header.m_numFiles != mlfPaths.size())
+            break;
+
+        vector<LabelCacheFile> files(mlfPaths.size());
+        if (fread(files.data(), sizeof(LabelCacheFile), files.size(), f) != files.size())
+            break;
+
+        bool stale = false;
+        for (size_t i = 0; i < mlfPaths.size(); i++)
+        {
+            LabelCacheFile current;
+            if (!GetFileSizeAndTime(mlfPaths[i], current) ||
+                current.m_fileSize != files[i].m_fileSize ||
+                current.m_fileTime != files[i].m_fileTime)
+            {
+                stale = true;
+                break;
+            }
+        }
+
+        if (stale)
+            break;
+
+        entries.resize(header.m_numUtterances);
+        size_t read = 0;
+        for (; read < entries.size(); read++)
+        {
+            uint32_t keyLength, numRuns;
+            if (fread(&keyLength, sizeof(keyLength), 1, f) != 1)
+                break;
+            entries[read].first.resize(keyLength);
+            if (keyLength != 0 && fread(&entries[read].first[0], 1, keyLength, f) != keyLength)
+                break;
+            if (fread(&numRuns, sizeof(numRuns), 1, f) != 1)
+                break;
+            entries[read].second.resize(numRuns);
+            if (numRuns != 0 && fread(entries[read].second.data(), sizeof(LabelCacheRun), numRuns, f) != numRuns)
+                break;
+        }
+        ok = (read == entries.size());
+    } while (false);
+
+    fclose(f);
+    if (!ok)
+        entries.clear();
+    return ok;
+}
+
+// Writes the label cache sidecar next to the MLF. Best effort - a failure only costs
+// a re-parse on the next start, so it is reported as a warning and never fatal.
+static void WriteLabelCache(const wstring& cachePath, const vector<wstring>& mlfPaths, const LabelCacheEntries& entries)
+{
+    vector<LabelCacheFile> files(mlfPaths.size());
+    for (size_t i = 0; i < mlfPaths.size(); i++)
+    {
+        if (!GetFileSizeAndTime(mlfPaths[i], files[i]))
+        {
+            fprintf(stderr, "WARNING: cannot stat MLF file '%ls', skipping label cache creation.\n", mlfPaths[i].c_str());
+            return;
+        }
+    }
+
+    // Write to a temporary and rename, so that a concurrent job never sees a partial cache.
+    wstring tempPath = cachePath + L".tmp";
+    FILE* f = OpenLabelCache(tempPath, "wb");
+    if (f == nullptr)
+    {
+        fprintf(stderr, "WARNING: cannot create label cache '%ls', the MLF will be re-parsed on the next start.\n", cachePath.c_str());
+        return;
+    }
+
+    LabelCacheHeader header;
+    header.m_magic = LABEL_CACHE_MAGIC;
+    header.m_version = LABEL_CACHE_VERSION;
+    header.m_unused = 0;
+    header.m_pathsHash = HashPaths(mlfPaths);
+    header.m_numFiles = mlfPaths.size();
+    header.m_numUtterances = entries.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+        fwrite(files.data(), sizeof(LabelCacheFile), files.size(), f) == files.size();
+
+    for (const auto& e : entries)
+    {
+        if (!ok)
+            break;
+        uint32_t keyLength = (uint32_t)e.first.size();
+        uint32_t numRuns = (uint32_t)e.second.size();
+        ok = fwrite(&keyLength, sizeof(keyLength), 1, f) == 1 &&
+            (keyLength == 0 || fwrite(e.first.data(), 1, keyLength, f) == keyLength) &&
+            fwrite(&numRuns, sizeof(numRuns), 1, f) == 1 &&
+            (numRuns == 0 || fwrite(e.second.data(), sizeof(LabelCacheRun), numRuns, f) == numRuns);
+    }
+
+    ok = (fclose(f) == 0) && ok;
+    if (!ok)
+    {
+        fprintf(stderr, "WARNING: failed to write label cache '%ls', the MLF will be re-parsed on the next start.\n", cachePath.c_str());
+        return;
+    }
+
+#ifdef _MSC_VER
+    _wrename(tempPath.c_str(), cachePath.c_str());
+#else
+    rename(msra::strfun::utf8(tempPath).c_str(), msra::strfun::utf8(cachePath).c_str());
+#endif
+}
+
+// Parses the text MLF files into label cache entries, each file on its own thread.
+// The per-file label sets are merged into a single map, so the result is iterated in
+// key order exactly as a single reader over all paths would produce it.
+static void ParseMlfFiles(const vector<wstring>& mlfPaths, const wstring& stateListPath, LabelCacheEntries& entries)
+{
+    // TODO: currently we do not use symbol and word tables.
+    const msra::lm::CSymbolSet* wordTable = nullptr;
+    unordered_map<const char*, int>* symbolTable = nullptr;
+
+    // TODO: Currently we still use the old IO module. This will be refactored later.
+    const double htkTimeToFrame = 100000.0; // default is 10ms
+    typedef msra::asr::htkmlfreader<msra::asr::htkmlfentry, msra::lattices::lattice::htkmlfwordsequence> MlfReader;
+
+    // Make sure 'msra::asr::htkmlfreader' type has a move constructor
+    static_assert(
+        is_move_constructible<
+        msra::asr::htkmlfreader<msra::asr::htkmlfentry,
+        msra::lattices::lattice::htkmlfwordsequence >> ::value,
+        "Type 'msra::asr::htkmlfreader' should be move constructible!");
+
+    vector<shared_ptr<MlfReader>> readers(mlfPaths.size());
+    auto parse = [&](int i)
+    {
+        readers[i] = make_shared<MlfReader>(vector<wstring>(1, mlfPaths[i]), set<wstring>(), stateListPath, wordTable, symbolTable, htkTimeToFrame);
+    };
+
+    if (mlfPaths.size() > 1)
+    {
+        ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < (int)mlfPaths.size(); ++i)
+            capture.SafeRun(parse, i);
+        capture.RethrowIfHappened();
+    }
+    else
+    {
+        parse(0);
+    }
+
+    auto& labels = *readers.front();
+    for (size_t i = 1; i < readers.size(); ++i)
+    {
+        for (auto& l : *readers[i])
+            labels.insert(std::move(l));
+        readers[i].reset();
+    }
+
+    entries.reserve(labels.size());
+    for (const auto& l : labels)
+    {
+        entries.push_back(make_pair(msra::strfun::utf8(l.first), vector<LabelCacheRun>(l.second.size())));
+        auto& runs = entries.back().second;
+        foreach_index(i, l.second)
+        {
+            runs[i].m_firstFrame = l.second[i].firstframe;
+            runs[i].m_numFrames = l.second[i].numframes;
+            runs[i].m_classId = l.second[i].classid;
+        }
+    }
+}
+
 MLFDataDeserializer::MLFDataDeserializer(CorpusDescriptorPtr corpus, const ConfigParameters& cfg, bool primary)
 {
     // TODO: This should be read in one place, potentially given by SGD.
@@ -111,30 +370,31 @@ void MLFDataDeserializer::InitializeChunkDescriptions(CorpusDescriptorPtr corpus
     // TODO: Similarly to the old reader, currently we assume all Mlfs will have same root name (key)
     // restrict MLF reader to these files--will make stuff much faster without having to use shortened input files
 
-    // TODO: currently we do not use symbol and word tables.
-    const msra::lm::CSymbolSet* wordTable = nullptr;
-    unordered_map<const char*, int>* symbolTable = nullptr;
     vector<wstring> mlfPaths = config.GetMlfPaths();
 
-    // TODO: Currently we still use the old IO module. This will be refactored later.
-    const double htkTimeToFrame = 100000.0; // default is 10ms
-    msra::asr::htkmlfreader<msra::asr::htkmlfentry, msra::lattices::lattice::htkmlfwordsequence> labels(mlfPaths, set<wstring>(), stateListPath, wordTable, symbolTable, htkTimeToFrame);
-
-    // Make sure 'msra::asr::htkmlfreader' type has a move constructor
-    static_assert(
-        is_move_constructible<
-        msra::asr::htkmlfreader<msra::asr::htkmlfentry,
-        msra::lattices::lattice::htkmlfwordsequence >> ::value,
-        "Type 'msra::asr::htkmlfreader' should be move constructible!");
+    // The binary label cache sits next to the first MLF file and eliminates re-parsing
+    // of the text transcripts on subsequent starts. It stores all utterances before
+    // corpus filtering, so the same cache serves differently restricted jobs.
+    LabelCacheEntries labelEntries;
+    wstring cachePath = mlfPaths.front() + L".lcache";
+    if (TryReadLabelCache(cachePath, mlfPaths, labelEntries))
+    {
+        fprintf(stderr, "MLFDataDeserializer: using binary label cache '%ls'\n", cachePath.c_str());
+    }
+    else
+    {
+        ParseMlfFiles(mlfPaths, stateListPath, labelEntries);
+        WriteLabelCache(cachePath, mlfPaths, labelEntries);
+    }
 
     MLFUtterance description;
     size_t numClasses = 0;
     size_t totalFrames = 0;
 
     // TODO resize m_keyToSequence with number of IDs from string registry
-    for (const auto& l : labels)
+    for (const auto& l : labelEntries)
     {
-        auto key = msra::strfun::utf8(l.first);
+        const auto& key = l.first;
         if (!corpus->IsIncluded(key))
             continue;
 
@@ -148,32 +408,32 @@ void MLFDataDeserializer::InitializeChunkDescriptions(CorpusDescriptorPtr corpus
         foreach_index(i, utterance)
         {
             const auto& timespan = utterance[i];
-            if ((i == 0 && timespan.firstframe != 0) ||
-                (i > 0 && utterance[i - 1].firstframe + utterance[i - 1].numframes != timespan.firstframe))
+            if ((i == 0 && timespan.m_firstFrame != 0) ||
+                (i > 0 && utterance[i - 1].m_firstFrame + utterance[i - 1].m_numFrames != timespan.m_firstFrame))
             {
-                RuntimeError("Labels are not in the consecutive order MLF in label set: %ls", l.first.c_str());
+                RuntimeError("Labels are not in the consecutive order MLF in label set: %s", key.c_str());
             }
 
-            if (timespan.classid >= dimension)
+            if (timespan.m_classId >= dimension)
             {
-                RuntimeError("Class id %d exceeds the model output dimension %d.", (int)timespan.classid, (int)dimension);
+                RuntimeError("Class id %d exceeds the model output dimension %d.", (int)timespan.m_classId, (int)dimension);
             }
 
-            if (timespan.classid != static_cast<msra::dbn::CLASSIDTYPE>(timespan.classid))
+            if (timespan.m_classId != static_cast<msra::dbn::CLASSIDTYPE>(timespan.m_classId))
             {
                 RuntimeError("CLASSIDTYPE has too few bits");
             }
 
-            if (SEQUENCELEN_MAX < timespan.firstframe + timespan.numframes)
+            if (SEQUENCELEN_MAX < timespan.m_firstFrame + timespan.m_numFrames)
             {
                 RuntimeError("Maximum number of sample per sequence exceeded.");
             }
 
-            numClasses = max(numClasses, (size_t)(1u + timespan.classid));
+            numClasses = max(numClasses, (size_t)(1u + timespan.m_classId));
 
-            for (size_t t = timespan.firstframe; t < timespan.firstframe + timespan.numframes; t++)
+            for (size_t t = timespan.m_firstFrame; t < timespan.m_firstFrame + timespan.m_numFrames; t++)
             {
-                m_classIds.push_back(timespan.classid);
+                m_classIds.push_back(timespan.m_classId);
                 numberOfFrames++;
             }
         }
@@ -16,6 +16,7 @@
 #include "biggrowablevectors.h"
 #include "ssematrix.h"
 #include "RandomOrdering.h"
+#include <future> // for background page-in of the next window segment
 
 namespace msra { namespace dbn {
 
@@ -90,6 +91,8 @@ class biggrowablevectorarray : public growablevectorbase<msra::dbn::matrix>
             }
             */
         f = fopenOrDie(pagepath, wantread ? L"rbS" : L"wbS");
+        if (wantread)
+            fprefetch = fopenOrDie(pagepath, L"rbS"); // second handle for the background page-in
         reading = wantread;
     }
     void flushlastblock() // during population phase, must be called once per block in sequence
@@ -116,22 +119,81 @@ class biggrowablevectorarray : public growablevectorbase<msra::dbn::matrix>
         fprintf(stderr, "recoverblock: releasing feature block %d [%d..%d)\n", (int) blockid, (int) t0, (int) (t0 + elementsperblock - 1));
         blocks[blockid].reset(); // free the memory
     }
+
+    // background page-in: while the consumer works on the current window, the next block
+    // is read from the page file into a spare buffer on a second file handle, so the
+    // synchronous read at the window transition becomes a buffer swap
+    std::future<void> prefetchinflight;                // in-flight background read, if valid()
+    size_t prefetchedblockid;                          // block that prefetchbuffer holds (SIZE_MAX: none)
+    std::unique_ptr<msra::dbn::matrix> prefetchbuffer; // the second buffer, reused across prefetches
+    auto_file_ptr fprefetch;                           // second page-file handle, so the background read does not disturb f's position
+    // telemetry, reported at teardown
+    size_t numpageinstalls;     // window misses that had to read from disk synchronously (=GPU stalls)
+    size_t numprefetchedblocks; // window misses satisfied by the prefetched buffer
+    double pageinstallseconds;  // seconds spent in synchronous block reads
+
+    void waitforprefetch() // (no-op if none is in flight)
+    {
+        if (prefetchinflight.valid())
+            prefetchinflight.get(); // rethrows background read errors
+    }
+    void schedulenextblockprefetch() // called at the end of require()
+    {
+        if (!paging() || !reading)
+            return;
+        size_t blockid;
+        if (inmemend % elementsperblock == 0 && inmemend < n)
+            blockid = inmemend / elementsperblock; // next block the rolling window will slide into
+        else if (inmemend >= n && inmembegin > 0)
+            blockid = 0; // end of data: the next sweep wraps around to the start
+        else
+            return;
+        waitforprefetch(); // (an unconsumed previous prefetch; must not touch the buffer while it is being filled)
+        if (blockid == prefetchedblockid || blocks[blockid])
+            return; // already have it
+        if (!prefetchbuffer)
+            prefetchbuffer.reset(newblock());
+        prefetchedblockid = SIZE_MAX; // (not valid until the read completes)
+        msra::dbn::matrix *buffer = prefetchbuffer.get();
+        FILE *fp = fprefetch;
+        prefetchinflight = std::async(std::launch::async, [this, blockid, buffer, fp]()
+        {
+            fsetpos(fp, blockid * buffer->sizeinpagefile());
+            buffer->frompagefile(fp);
+            prefetchedblockid = blockid;
+        });
+    }
+
     void recoverblock(size_t t0) // t0=block start time
     {
         assert(paging() && reading);
         size_t blockid = t0 / elementsperblock;
         assert(blockid * elementsperblock == t0);
         assert(!blocks[blockid]);
+        waitforprefetch();
+        if (prefetchedblockid == blockid) // the background read got it: just swap in the buffer
+        {
+            fprintf(stderr, "recoverblock: swapping in prefetched feature block %d [%d..%d)\n", (int) blockid, (int) t0, (int) (t0 + elementsperblock - 1));
+            blocks[blockid] = std::move(prefetchbuffer);
+            prefetchedblockid = SIZE_MAX;
+            numprefetchedblocks++;
+            return;
+        }
+        // window-miss stall: must read synchronously, with the consumer (and the GPU) waiting
+        auto_timer stalltimer;
         fprintf(stderr, "recoverblock: recovering feature block %d [%d..%d)\n", (int) blockid, (int) t0, (int) (t0 + elementsperblock - 1));
         blocks[blockid].reset(newblock());
         msra::dbn::matrix &block = *blocks[blockid];
         fsetpos(f, blockid * block.sizeinpagefile());
         block.frompagefile(f);
+        numpageinstalls++;
+        pageinstallseconds += stalltimer;
     }
 
 public:
     biggrowablevectorarray(const std::wstring &pagepath)
-        : growablevectorbase(65536), m(0), inmembegin(0), inmemend(0), pagepath(pagepath), reading(false)
+        : growablevectorbase(65536), m(0), inmembegin(0), inmemend(0), pagepath(pagepath), reading(false),
+          prefetchedblockid(SIZE_MAX), numpageinstalls(0), numprefetchedblocks(0), pageinstallseconds(0.0)
     {
         openpagefile(false);
         if (paging())
@@ -141,6 +203,15 @@ public:
     { // clean up the big temp file
         if (paging())
         {
+            try
+            {
+                waitforprefetch();
+            }
+            catch (...)
+            {
+            } // (an error in the background read no longer matters here)
+            reportpageinstats();
+            fprefetch = NULL; // this closes the second handle
             fclose(f);
             if (_wunlink(pagepath.c_str()) == 0)
                 fprintf(stderr, "biggrowablevectorarray: deleted disk backup store at '%ls'\n", pagepath.c_str());
@@ -149,6 +220,14 @@ public:
         }
     }
 
+    // telemetry: how often did a window transition stall on a synchronous read, and for how long
+    void reportpageinstats() const
+    {
+        if (numpageinstalls > 0 || numprefetchedblocks > 0)
+            fprintf(stderr, "biggrowablevectorarray: %d window-miss stalls (%.1f s total), %d block transitions hidden by prefetch\n",
+                    (int) numpageinstalls, pageinstallseconds, (int) numprefetchedblocks);
+    }
+
     size_t dim() const
     {
         return m;
@@ -222,6 +301,9 @@ public:
         // got it
         inmembegin = ts;
         inmemend = te;
+        // kick off the background read of the block the window will slide into next,
+        // so the next transition swaps in a buffer instead of stalling on the disk
+        schedulenextblockprefetch();
         return readfromdisk;
     }
     const msra::dbn::matrixstripe operator[](size_t t) const // get a feature vector
@@ -240,6 +322,9 @@ public:
     {
         if (paging())
         {
+            waitforprefetch();
+            reportpageinstats();
+            fprefetch = NULL; // this closes the second handle
             fclose(f);
             if (_wunlink(pagepath.c_str()) == 0)
             {
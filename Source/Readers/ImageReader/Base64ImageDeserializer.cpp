@@ -97,7 +97,7 @@ namespace Microsoft { namespace MSR { namespace CNTK {
             while (endToken > token &&  !IsBase64Char(*(endToken - 1)))
                 endToken--;
 
-            std::vector<char> decodedImage;
+            auto decodedImage = m_deserializer.m_decodeWorkspace.pop_or_create([]() { return std::vector<char>(); });
             cv::Mat image;
             if (!DecodeBase64(token, endToken, decodedImage))
             {
@@ -105,8 +105,12 @@ namespace Microsoft { namespace MSR { namespace CNTK {
             }
             else
             {
-                image = cv::imdecode(decodedImage, m_deserializer.m_grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+                // imdecode reads straight out of the decoded buffer and allocates its own
+                // destination image, so no extra copy of the compressed bytes is made.
+                image = cv::imdecode(cv::Mat(1, (int) decodedImage.size(), CV_8UC1, decodedImage.data()),
+                                     GetImreadModeFor(m_deserializer.m_grayscale, m_deserializer.m_decodeDownscaleFactor));
             }
+            m_deserializer.m_decodeWorkspace.push(std::move(decodedImage));
 
             m_deserializer.PopulateSequenceData(image, classId, sequenceId, result);
         }
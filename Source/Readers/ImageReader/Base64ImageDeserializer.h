@@ -9,6 +9,7 @@
 #include "Config.h"
 #include "CorpusDescriptor.h"
 #include "Indexer.h"
+#include "ConcStack.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -39,6 +40,9 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         std::unique_ptr<Indexer> m_indexer;
         std::shared_ptr<FILE> m_dataFile;
         std::wstring m_fileName;
+
+        // Reusable decode buffers; GetSequence can run on several prefetch threads at once.
+        conc_stack<std::vector<char>> m_decodeWorkspace;
     };
 
 }}}
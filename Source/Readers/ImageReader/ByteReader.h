@@ -10,6 +10,10 @@
 #include <zip.h>
 #include <unordered_map>
 #include <memory>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <cstdint>
 #include "ConcStack.h"
 #endif
 
@@ -22,7 +26,7 @@ public:
     virtual ~ByteReader() = default;
 
     virtual void Register(const std::map<std::string, size_t>& sequences) = 0;
-    virtual cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) = 0;
+    virtual cv::Mat Read(size_t seqId, const std::string& path, int imreadMode) = 0;
 
     DISABLE_COPY_AND_MOVE(ByteReader);
 };
@@ -34,7 +38,7 @@ public:
     {}
 
     void Register(const std::map<std::string, size_t>&) override {}
-    cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) override;
+    cv::Mat Read(size_t seqId, const std::string& path, int imreadMode) override;
 
     std::string m_expandDirectory;
 };
@@ -43,19 +47,47 @@ public:
 class ZipByteReader : public ByteReader
 {
 public:
-    ZipByteReader(const std::string& zipPath);
+    // entryCacheSize - byte budget for the LRU over raw entry payloads, zero disables it.
+    ZipByteReader(const std::string& zipPath, size_t entryCacheSize = 0);
 
     void Register(const std::map<std::string, size_t>& sequences) override;
-    cv::Mat Read(size_t seqId, const std::string& path, bool grayscale) override;
+    cv::Mat Read(size_t seqId, const std::string& path, int imreadMode) override;
 
 private:
     using ZipPtr = std::unique_ptr<zip_t, void(*)(zip_t*)>;
     ZipPtr OpenZip();
 
+    // Central-directory snapshot; lets stored (uncompressed) entries be read straight off
+    // a per-thread file descriptor without touching a zip handle.
+    struct EntryInfo
+    {
+        uint64_t m_localHeaderOffset;
+        uint64_t m_compressedSize;
+        uint16_t m_compressionMethod;
+        bool m_encrypted;
+    };
+    void SnapshotCentralDirectory(const std::map<std::string, size_t>& sequences);
+    bool TryDirectRead(const EntryInfo& info, std::vector<unsigned char>& contents);
+
+    // LRU over raw (still image-compressed) entry payloads.
+    std::shared_ptr<std::vector<unsigned char>> CacheLookup(size_t seqId);
+    void CacheInsert(size_t seqId, const std::shared_ptr<std::vector<unsigned char>>& data);
+
     std::string m_zipPath;
     conc_stack<ZipPtr> m_zips;
     std::unordered_map<size_t, std::pair<zip_uint64_t, zip_uint64_t>> m_seqIdToIndex;
     conc_stack<std::vector<unsigned char>> m_workspace;
+
+    std::unordered_map<size_t, EntryInfo> m_entryInfo;
+    using FilePtr = std::unique_ptr<FILE, int (*)(FILE*)>;
+    conc_stack<FilePtr> m_files;
+
+    using CacheList = std::list<std::pair<size_t, std::shared_ptr<std::vector<unsigned char>>>>;
+    std::mutex m_cacheLock;
+    CacheList m_cacheList; // most recently used in front
+    std::unordered_map<size_t, CacheList::iterator> m_cacheIndex;
+    size_t m_maxCacheBytes;
+    size_t m_cacheBytes;
 };
 #endif
 
@@ -35,7 +35,8 @@ public:
         const auto& imageSequence = m_description;
 
         auto image = std::make_shared<ImageSequenceData>();
-        image->m_image = std::move(m_deserializer.ReadImage(m_description.m_id, imageSequence.m_path, m_deserializer.m_grayscale));
+        image->m_image = std::move(m_deserializer.ReadImage(m_description.m_id, imageSequence.m_path,
+                                                            GetImreadModeFor(m_deserializer.m_grayscale, m_deserializer.m_decodeDownscaleFactor)));
         auto& cvImage = image->m_image;
         if (!cvImage.data)
             RuntimeError("Cannot open file '%s'", imageSequence.m_path.c_str());
@@ -63,6 +64,7 @@ private:
 // that allows composition of deserializers and transforms on inputs.
 ImageDataDeserializer::ImageDataDeserializer(CorpusDescriptorPtr corpus, const ConfigParameters& config) : ImageDeserializerBase(corpus, config)
 {
+    m_zipEntryCacheSize = (size_t)config(L"zipEntryCacheMB", 0) * 1024 * 1024;
     CreateSequenceDescriptions(corpus, config(L"file"), m_labelGenerator->LabelDimension(), m_multiViewCrop);
 }
 
@@ -74,6 +76,9 @@ ImageDataDeserializer::ImageDataDeserializer(const ConfigParameters& config)
     m_streams = configHelper.GetStreams();
     assert(m_streams.size() == 2);
     m_grayscale = configHelper.UseGrayscale();
+    m_decodeDownscaleFactor = config(L"decodeDownscaleFactor", 1);
+    GetImreadModeFor(m_grayscale, m_decodeDownscaleFactor); // validate the factor early
+    m_zipEntryCacheSize = (size_t)config(L"zipEntryCacheMB", 0) * 1024 * 1024;
     const auto& label = m_streams[configHelper.GetLabelStreamId()];
     const auto& feature = m_streams[configHelper.GetFeatureStreamId()];
 
@@ -253,7 +258,7 @@ void ImageDataDeserializer::RegisterByteReader(size_t seqId, const std::string&
     auto r = knownReaders.find(containerPath);
     if (r == knownReaders.end())
     {
-        reader = std::make_shared<ZipByteReader>(containerPath);
+        reader = std::make_shared<ZipByteReader>(containerPath, m_zipEntryCacheSize);
         knownReaders[containerPath] = reader;
         readerSequences[containerPath] = std::map<std::string, size_t>();
     }
@@ -272,22 +277,22 @@ void ImageDataDeserializer::RegisterByteReader(size_t seqId, const std::string&
 #endif
 }
 
-cv::Mat ImageDataDeserializer::ReadImage(size_t seqId, const std::string& path, bool grayscale)
+cv::Mat ImageDataDeserializer::ReadImage(size_t seqId, const std::string& path, int imreadMode)
 {
     assert(!path.empty());
 
     ImageDataDeserializer::SeqReaderMap::const_iterator r;
     if (m_readers.empty() || (r = m_readers.find(seqId)) == m_readers.end())
-        return m_defaultReader->Read(seqId, path, grayscale);
-    return (*r).second->Read(seqId, path, grayscale);
+        return m_defaultReader->Read(seqId, path, imreadMode);
+    return (*r).second->Read(seqId, path, imreadMode);
 }
 
-cv::Mat FileByteReader::Read(size_t, const std::string& seqPath, bool grayscale)
+cv::Mat FileByteReader::Read(size_t, const std::string& seqPath, int imreadMode)
 {
     assert(!seqPath.empty());
     auto path = Expand3Dots(seqPath, m_expandDirectory);
 
-    return cv::imread(path, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    return cv::imread(path, imreadMode);
 }
 
 bool ImageDataDeserializer::GetSequenceDescriptionByKey(const KeyType& key, SequenceDescription& result)
@@ -60,13 +60,16 @@ private:
     using PathReaderMap = std::unordered_map<std::string, std::shared_ptr<ByteReader>>;
     using ReaderSequenceMap = std::map<std::string, std::map<std::string, size_t>>;
     void RegisterByteReader(size_t seqId, const std::string& path, PathReaderMap& knownReaders, ReaderSequenceMap& readerSequences, const std::string& expandDirectory);
-    cv::Mat ReadImage(size_t seqId, const std::string& path, bool grayscale);
+    cv::Mat ReadImage(size_t seqId, const std::string& path, int imreadMode);
 
     // REVIEW alexeyk: can potentially use vector instead of map. Need to handle default reader and resizing though.
     using SeqReaderMap = std::unordered_map<size_t, std::shared_ptr<ByteReader>>;
     SeqReaderMap m_readers;
 
     std::unique_ptr<FileByteReader> m_defaultReader;
+
+    // Byte budget for the per-container cache of raw zip entry payloads, zero disables it.
+    size_t m_zipEntryCacheSize;
 };
 
 }}}
@@ -16,7 +16,7 @@
 namespace Microsoft { namespace MSR { namespace CNTK {
 
     ImageDeserializerBase::ImageDeserializerBase() : m_precision(ElementType::tfloat),
-        m_grayscale(false), m_verbosity(0), m_multiViewCrop(false)
+        m_grayscale(false), m_decodeDownscaleFactor(1), m_verbosity(0), m_multiViewCrop(false)
     {}
 
     ImageDeserializerBase::ImageDeserializerBase(CorpusDescriptorPtr corpus, const ConfigParameters& config) : m_corpus(corpus)
@@ -64,6 +64,9 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
         m_grayscale = config(L"grayscale", false);
 
+        m_decodeDownscaleFactor = config(L"decodeDownscaleFactor", 1);
+        GetImreadModeFor(m_grayscale, m_decodeDownscaleFactor); // validate the factor early
+
         // TODO: multiview should be done on the level of randomizer/transformers - it is responsiblity of the
         // TODO: randomizer to collect how many copies each transform needs and request same sequence several times.
         m_multiViewCrop = config(L"multiViewCrop", false);
@@ -38,6 +38,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         // Flag whether images shall be loaded in grayscale.
         bool m_grayscale;
 
+        // Decode images at 1/2, 1/4 or 1/8 of their stored resolution (1 = full resolution).
+        // Only makes sense when the transform chain scales images below the reduced size.
+        int m_decodeDownscaleFactor;
+
         // Verbosity.
         int m_verbosity;
 
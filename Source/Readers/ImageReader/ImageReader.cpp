@@ -60,14 +60,23 @@ ImageReader::ImageReader(const ConfigParameters& config)
 
     std::vector<Transformation> transformations;
     transformations.push_back(Transformation{ std::make_shared<CropTransformer>(featureStream), featureName });
-    transformations.push_back(Transformation{ std::make_shared<ScaleTransformer>(featureStream), featureName });
-    transformations.push_back(Transformation{ std::make_shared<ColorTransformer>(featureStream), featureName });
-    transformations.push_back(Transformation{ std::make_shared<IntensityTransformer>(featureStream), featureName });
-    transformations.push_back(Transformation{ std::make_shared<MeanTransformer>(featureStream), featureName });
-
-    if (configHelper.GetDataFormat() == CHW)
+    if (configHelper.GetDataFormat() == CHW && FusedScaleMeanTransposeTransformer::IsFusible(featureStream))
     {
-        transformations.push_back(Transformation{ std::make_shared<TransposeTransformer>(featureStream), featureName });
+        // Scaling, mean subtraction and HWC->CHW transpose collapse into a single pass.
+        // Crop stays separate - it only moves the cv::Mat region of interest and does not copy pixels.
+        transformations.push_back(Transformation{ std::make_shared<FusedScaleMeanTransposeTransformer>(featureStream), featureName });
+    }
+    else
+    {
+        transformations.push_back(Transformation{ std::make_shared<ScaleTransformer>(featureStream), featureName });
+        transformations.push_back(Transformation{ std::make_shared<ColorTransformer>(featureStream), featureName });
+        transformations.push_back(Transformation{ std::make_shared<IntensityTransformer>(featureStream), featureName });
+        transformations.push_back(Transformation{ std::make_shared<MeanTransformer>(featureStream), featureName });
+
+        if (configHelper.GetDataFormat() == CHW)
+        {
+            transformations.push_back(Transformation{ std::make_shared<TransposeTransformer>(featureStream), featureName });
+        }
     }
 
     // We should always have cast at the end. 
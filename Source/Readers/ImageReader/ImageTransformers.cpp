@@ -499,6 +499,193 @@ SequenceDataPtr TransposeTransformer::TypedTranspose<TElementTo>::Apply(ImageSeq
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+FusedScaleMeanTransposeTransformer::FusedScaleMeanTransposeTransformer(const ConfigParameters& config) : TransformBase(config),
+    m_floatTransform(this), m_doubleTransform(this)
+{
+    m_imgWidth    = config(L"width");
+    m_imgHeight   = config(L"height");
+    m_imgChannels = config(L"channels");
+
+    size_t cfeat = m_imgWidth * m_imgHeight * m_imgChannels;
+    if (cfeat == 0 || cfeat > SIZE_MAX / 2)
+        RuntimeError("Invalid image dimensions.");
+
+    std::wstring meanFile = config(L"meanFile", L"");
+    if (meanFile.empty())
+        m_meanImg.release();
+    else
+    {
+        cv::FileStorage fs;
+        fs.open(msra::strfun::utf8(meanFile).c_str(), cv::FileStorage::READ);
+        if (!fs.isOpened())
+            RuntimeError("Could not open file: %ls", meanFile.c_str());
+        fs["MeanImg"] >> m_meanImg;
+        int cchan;
+        fs["Channel"] >> cchan;
+        int crow;
+        fs["Row"] >> crow;
+        int ccol;
+        fs["Col"] >> ccol;
+        if (cchan * crow * ccol !=
+            m_meanImg.channels() * m_meanImg.rows * m_meanImg.cols)
+            RuntimeError("Invalid data in file: %ls", meanFile.c_str());
+        fs.release();
+        m_meanImg = m_meanImg.reshape(cchan, crow);
+
+        // The mean is subtracted after scaling, so its dimensions must match the target.
+        if (m_meanImg.cols != (int)m_imgWidth || m_meanImg.rows != (int)m_imgHeight ||
+            m_meanImg.channels() != (int)m_imgChannels)
+            RuntimeError("Mean image dimensions do not match the scale target in file: %ls", meanFile.c_str());
+
+        // Converting to the output precision once, the fused pass reads it directly.
+        m_meanImg.convertTo(m_meanImg, m_precision == ElementType::tfloat ? CV_32F : CV_64F);
+        if (!m_meanImg.isContinuous())
+            m_meanImg = m_meanImg.clone();
+    }
+}
+
+bool FusedScaleMeanTransposeTransformer::IsFusible(const ConfigParameters& config)
+{
+    // Only the plain 'fill' scale mode with bilinear interpolation is implemented by the fused pass.
+    string scaleMode = config(L"scaleMode", "fill");
+    if (scaleMode != "fill")
+        return false;
+
+    string interpolation = config(L"interpolations", "linear");
+    if (!AreEqualIgnoreCase(interpolation, "linear"))
+        return false;
+
+    // Color and intensity jittering happen between scaling and mean subtraction
+    // and cannot be folded into the pass.
+    if (config.ExistsCurrent(L"brightnessRadius") || config.ExistsCurrent(L"contrastRadius") ||
+        config.ExistsCurrent(L"saturationRadius") || config.ExistsCurrent(L"intensityStdDev") ||
+        config.ExistsCurrent(L"intensityFile"))
+        return false;
+
+    return true;
+}
+
+// The method describes how input stream is transformed to the output stream. Called once per applied stream.
+// The fused transformer scales all samples to the same size and outputs them as CHW in the requested precision.
+StreamDescription FusedScaleMeanTransposeTransformer::Transform(const StreamDescription& inputStream)
+{
+    TransformBase::Transform(inputStream);
+    m_outputStream.m_elementType = m_precision;
+    m_outputStream.m_sampleLayout = std::make_shared<TensorShape>(
+        ImageDimensions(m_imgWidth, m_imgHeight, m_imgChannels).AsTensorShape(CHW));
+    return m_outputStream;
+}
+
+// Transformation of the sequence.
+SequenceDataPtr FusedScaleMeanTransposeTransformer::Transform(SequenceDataPtr sequence)
+{
+    auto inputSequence = dynamic_cast<ImageSequenceData*>(sequence.get());
+    if (inputSequence == nullptr)
+        RuntimeError("Currently fused transform only works with images.");
+
+    ElementType elementType = m_inputStream.m_elementType != ElementType::tvariant ?
+        m_inputStream.m_elementType :
+        sequence->m_elementType;
+
+    switch (elementType)
+    {
+    case ElementType::tdouble:
+        if (m_precision == ElementType::tfloat)
+            return m_floatTransform.Apply<double>(inputSequence);
+        if (m_precision == ElementType::tdouble)
+            return m_doubleTransform.Apply<double>(inputSequence);
+    case ElementType::tfloat:
+        if (m_precision == ElementType::tdouble)
+            return m_doubleTransform.Apply<float>(inputSequence);
+        if (m_precision == ElementType::tfloat)
+            return m_floatTransform.Apply<float>(inputSequence);
+    case ElementType::tuchar:
+        if (m_precision == ElementType::tdouble)
+            return m_doubleTransform.Apply<unsigned char>(inputSequence);
+        if (m_precision == ElementType::tfloat)
+            return m_floatTransform.Apply<unsigned char>(inputSequence);
+    default:
+        RuntimeError("Unsupported type. Please apply a cast transform with 'double' or 'float' precision.");
+    }
+    return nullptr; // Make compiler happy
+}
+
+// A single pass over the output pixels: for each destination pixel the source position is
+// computed with the same center-aligned mapping cv::resize uses for bilinear interpolation,
+// the four neighbors are blended, the mean is subtracted and the value is written to its
+// transposed (CHW) position in the output buffer. Rows of the source are accessed through
+// cv::Mat::ptr, so cropped (non-continuous) views need no preceding clone. The inner loops
+// are simple strided arithmetic that the compiler can vectorize.
+template <class TElementTo>
+template <class TElementFrom>
+SequenceDataPtr FusedScaleMeanTransposeTransformer::TypedApply<TElementTo>::Apply(ImageSequenceData* inputSequence)
+{
+    assert(inputSequence->m_numberOfSamples == 1);
+
+    const cv::Mat& image = inputSequence->m_image;
+    size_t channels = image.channels();
+    if (channels != m_parent->m_imgChannels)
+        RuntimeError("Number of image channels (%d) does not match the configured 'channels' value (%d).",
+            (int)channels, (int)m_parent->m_imgChannels);
+
+    size_t width = m_parent->m_imgWidth;
+    size_t height = m_parent->m_imgHeight;
+    size_t planeSize = width * height;
+
+    auto result = std::make_shared<DenseSequenceWithBuffer<TElementTo>>(m_memBuffers, planeSize * channels);
+    TElementTo* dst = result->GetBuffer();
+    const TElementTo* mean = m_parent->m_meanImg.empty() ?
+        nullptr :
+        reinterpret_cast<const TElementTo*>(m_parent->m_meanImg.data);
+
+    double scaleX = (double)image.cols / width;
+    double scaleY = (double)image.rows / height;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        double sy = (y + 0.5) * scaleY - 0.5;
+        sy = std::max(sy, 0.0);
+        size_t y0 = std::min((size_t)sy, (size_t)(image.rows - 1));
+        size_t y1 = std::min(y0 + 1, (size_t)(image.rows - 1));
+        TElementTo wy = (TElementTo)(sy - y0);
+
+        const auto* row0 = image.ptr<TElementFrom>((int)y0);
+        const auto* row1 = image.ptr<TElementFrom>((int)y1);
+
+        for (size_t x = 0; x < width; ++x)
+        {
+            double sx = (x + 0.5) * scaleX - 0.5;
+            sx = std::max(sx, 0.0);
+            size_t x0 = std::min((size_t)sx, (size_t)(image.cols - 1));
+            size_t x1 = std::min(x0 + 1, (size_t)(image.cols - 1));
+            TElementTo wx = (TElementTo)(sx - x0);
+
+            const auto* p00 = row0 + x0 * channels;
+            const auto* p01 = row0 + x1 * channels;
+            const auto* p10 = row1 + x0 * channels;
+            const auto* p11 = row1 + x1 * channels;
+
+            size_t destIndex = y * width + x;
+            for (size_t c = 0; c < channels; ++c)
+            {
+                TElementTo top = p00[c] + (p01[c] - (TElementTo)p00[c]) * wx;
+                TElementTo bottom = p10[c] + (p11[c] - (TElementTo)p10[c]) * wx;
+                TElementTo value = top + (bottom - top) * wy;
+                if (mean != nullptr)
+                    value -= mean[destIndex * channels + c];
+                dst[c * planeSize + destIndex] = value;
+            }
+        }
+    }
+
+    result->m_sampleLayout = m_parent->m_outputStream.m_sampleLayout;
+    result->m_numberOfSamples = inputSequence->m_numberOfSamples;
+    result->m_elementType = m_parent->m_precision;
+    return result;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 IntensityTransformer::IntensityTransformer(const ConfigParameters &config) : ImageTransformerBase(config)
 {
     m_stdDev = config(L"intensityStdDev", ConfigParameters::Array(doubleargvector(vector<double>{0.0})));
@@ -182,6 +182,55 @@ private:
     TypedTranspose<double> m_doubleTransform;
 };
 
+// Fused scale + mean subtraction + HWC->CHW transpose.
+// Combines the work of ScaleTransformer (bilinear 'fill' scaling), MeanTransformer and
+// TransposeTransformer into a single pass over the output pixels, avoiding the
+// intermediate cv::Mat allocations and the extra memory sweeps of the separate stages.
+// The reader activates it automatically when the configured transform chain matches
+// this pattern (see IsFusible); all other configurations keep the separate transforms.
+class FusedScaleMeanTransposeTransformer : public TransformBase
+{
+public:
+    explicit FusedScaleMeanTransposeTransformer(const ConfigParameters& config);
+
+    // Checks whether the configuration only requires work this fused implementation
+    // supports: bilinear 'fill' scaling and no color/intensity jittering.
+    static bool IsFusible(const ConfigParameters& config);
+
+    // Transformation of the stream.
+    StreamDescription Transform(const StreamDescription& inputStream) override;
+
+    // Transformation of the sequence.
+    SequenceDataPtr Transform(SequenceDataPtr sequence) override;
+
+private:
+    // A helper class performing the fused pass using a set of typed memory buffers.
+    template <class TElementTo>
+    struct TypedApply
+    {
+        FusedScaleMeanTransposeTransformer* m_parent;
+
+        TypedApply(FusedScaleMeanTransposeTransformer* parent) : m_parent(parent) {}
+
+        template <class TElementFrom>
+        SequenceDataPtr Apply(ImageSequenceData* inputSequence);
+        conc_stack<std::vector<TElementTo>> m_memBuffers;
+    };
+
+    // Auxiliary buffer to handle output of float type.
+    TypedApply<float> m_floatTransform;
+
+    // Auxiliary buffer to handle output of double type.
+    TypedApply<double> m_doubleTransform;
+
+    size_t m_imgWidth;
+    size_t m_imgHeight;
+    size_t m_imgChannels;
+
+    // Mean image in HWC layout converted to the output precision, empty if no mean file is given.
+    cv::Mat m_meanImg;
+};
+
 // Intensity jittering based on PCA transform as described in original AlexNet paper
 // (http://papers.nips.cc/paper/4824-imagenet-classification-with-deep-convolutional-neural-networks.pdf)
 // Currently uses precomputed values from 
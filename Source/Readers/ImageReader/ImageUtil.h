@@ -30,6 +30,27 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         }
     }
 
+    // Maps the grayscale flag and the decode downscale factor onto an OpenCV imread mode.
+    // Reduced-resolution decode (factors 2/4/8) makes the JPEG codec skip most of the inverse
+    // DCT work, cutting decode CPU roughly proportionally; useful when the transform chain
+    // scales images far below their stored resolution anyway.
+    inline int GetImreadModeFor(bool grayscale, int decodeDownscaleFactor)
+    {
+        switch (decodeDownscaleFactor)
+        {
+        case 1:
+            return grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+        case 2:
+            return grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+        case 4:
+            return grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+        case 8:
+            return grayscale ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+        default:
+            InvalidArgument("decodeDownscaleFactor must be 1, 2, 4 or 8, got '%d'.", decodeDownscaleFactor);
+        }
+    }
+
     inline ElementType GetElementTypeFromOpenCVType(int openCvType)
     {
         ElementType result;
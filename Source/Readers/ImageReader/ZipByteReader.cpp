@@ -21,8 +21,29 @@ std::string GetZipError(int err)
     return errS;
 }
 
-ZipByteReader::ZipByteReader(const std::string& zipPath)
-    : m_zipPath(zipPath)
+// Little-endian field readers for the raw zip structures.
+static uint16_t ReadUint16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadUint32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t ReadUint64(const unsigned char* p)
+{
+    return (uint64_t)ReadUint32(p) | ((uint64_t)ReadUint32(p + 4) << 32);
+}
+
+static bool ReadAt(FILE* file, uint64_t offset, unsigned char* buffer, size_t size)
+{
+    return _fseeki64(file, offset, SEEK_SET) == 0 && fread(buffer, 1, size, file) == size;
+}
+
+ZipByteReader::ZipByteReader(const std::string& zipPath, size_t entryCacheSize)
+    : m_zipPath(zipPath), m_maxCacheBytes(entryCacheSize), m_cacheBytes(0)
 {
     assert(!m_zipPath.empty());
 }
@@ -85,10 +106,196 @@ void ZipByteReader::Register(const std::map<std::string, size_t>& sequences)
 
         RuntimeError("Cannot retrieve image data for some sequences. For more detail, please see the log file.");
     }
+
+    SnapshotCentralDirectory(sequences);
 }
 
-cv::Mat ZipByteReader::Read(size_t seqId, const std::string& path, bool grayscale)
+// SnapshotCentralDirectory - parse the archive's central directory once into a flat
+// offset/size index. Stored (uncompressed) entries can then be served by TryDirectRead
+// from per-thread descriptors; anything we cannot parse simply stays on the libzip path.
+void ZipByteReader::SnapshotCentralDirectory(const std::map<std::string, size_t>& sequences)
 {
+    FilePtr file(fopen(m_zipPath.c_str(), "rb"), fclose);
+    if (!file)
+        return;
+
+    if (_fseeki64(file.get(), 0, SEEK_END) != 0)
+        return;
+    uint64_t fileSize = (uint64_t)_ftelli64(file.get());
+
+    // Find the end-of-central-directory record in the last 64KB (max comment) + 22 bytes.
+    const uint64_t maxTail = 64 * 1024 + 22;
+    uint64_t tailSize = std::min(fileSize, maxTail);
+    std::vector<unsigned char> tail(tailSize);
+    if (tailSize < 22 || !ReadAt(file.get(), fileSize - tailSize, tail.data(), tailSize))
+        return;
+
+    int64_t eocdPos = -1;
+    for (int64_t c = tailSize - 22; c >= 0; c--)
+    {
+        if (ReadUint32(&tail[c]) == 0x06054b50)
+        {
+            eocdPos = c;
+            break;
+        }
+    }
+    if (eocdPos < 0)
+        return;
+
+    uint64_t numEntries = ReadUint16(&tail[eocdPos + 10]);
+    uint64_t cdSize = ReadUint32(&tail[eocdPos + 12]);
+    uint64_t cdOffset = ReadUint32(&tail[eocdPos + 16]);
+
+    // Large archives use the zip64 records instead; the locator sits right before the EOCD.
+    if (numEntries == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF)
+    {
+        uint64_t locatorOffset = fileSize - tailSize + eocdPos;
+        if (locatorOffset < 20)
+            return;
+        locatorOffset -= 20;
+        unsigned char locator[20];
+        if (!ReadAt(file.get(), locatorOffset, locator, sizeof(locator)) || ReadUint32(locator) != 0x07064b50)
+            return;
+        unsigned char eocd64[56];
+        if (!ReadAt(file.get(), ReadUint64(locator + 8), eocd64, sizeof(eocd64)) || ReadUint32(eocd64) != 0x06064b50)
+            return;
+        numEntries = ReadUint64(eocd64 + 32);
+        cdSize = ReadUint64(eocd64 + 40);
+        cdOffset = ReadUint64(eocd64 + 48);
+    }
+
+    std::vector<unsigned char> cd(cdSize);
+    if (!ReadAt(file.get(), cdOffset, cd.data(), cdSize))
+        return;
+
+    m_entryInfo.reserve(sequences.size());
+    uint64_t pos = 0;
+    for (uint64_t c = 0; c < numEntries && pos + 46 <= cdSize; c++)
+    {
+        if (ReadUint32(&cd[pos]) != 0x02014b50)
+            break;
+        uint16_t flags = ReadUint16(&cd[pos + 8]);
+        uint16_t method = ReadUint16(&cd[pos + 10]);
+        uint64_t compSize = ReadUint32(&cd[pos + 20]);
+        uint64_t uncompSize = ReadUint32(&cd[pos + 24]);
+        uint16_t nameLen = ReadUint16(&cd[pos + 28]);
+        uint16_t extraLen = ReadUint16(&cd[pos + 30]);
+        uint16_t commentLen = ReadUint16(&cd[pos + 32]);
+        uint64_t localHeaderOffset = ReadUint32(&cd[pos + 42]);
+        if (pos + 46 + nameLen + extraLen + commentLen > cdSize)
+            break;
+
+        // Oversized fields are moved into the zip64 extra block, in this fixed order.
+        if (compSize == 0xFFFFFFFF || uncompSize == 0xFFFFFFFF || localHeaderOffset == 0xFFFFFFFF)
+        {
+            uint64_t extraPos = pos + 46 + nameLen;
+            uint64_t extraEnd = extraPos + extraLen;
+            while (extraPos + 4 <= extraEnd)
+            {
+                uint16_t fieldId = ReadUint16(&cd[extraPos]);
+                uint16_t fieldSize = ReadUint16(&cd[extraPos + 2]);
+                if (fieldId == 0x0001 && extraPos + 4 + fieldSize <= extraEnd)
+                {
+                    uint64_t f = extraPos + 4;
+                    if (uncompSize == 0xFFFFFFFF)
+                    {
+                        uncompSize = ReadUint64(&cd[f]);
+                        f += 8;
+                    }
+                    if (compSize == 0xFFFFFFFF)
+                    {
+                        compSize = ReadUint64(&cd[f]);
+                        f += 8;
+                    }
+                    if (localHeaderOffset == 0xFFFFFFFF)
+                        localHeaderOffset = ReadUint64(&cd[f]);
+                    break;
+                }
+                extraPos += 4 + fieldSize;
+            }
+        }
+
+        std::string name((const char*)&cd[pos + 46], nameLen);
+        auto sequenceId = sequences.find(name);
+        if (sequenceId != sequences.end())
+            m_entryInfo[sequenceId->second] = EntryInfo{ localHeaderOffset, compSize, method, (flags & 1) != 0 };
+
+        pos += 46ull + nameLen + extraLen + commentLen;
+    }
+}
+
+// TryDirectRead - read a stored entry's payload off a pooled per-thread descriptor.
+bool ZipByteReader::TryDirectRead(const EntryInfo& info, std::vector<unsigned char>& contents)
+{
+    auto file = m_files.pop_or_create([this]() { return FilePtr(fopen(m_zipPath.c_str(), "rb"), fclose); });
+    if (!file)
+        return false;
+
+    // The local header repeats the name/extra fields with possibly different lengths,
+    // so the data offset has to come from it rather than from the central directory.
+    bool ok = false;
+    unsigned char header[30];
+    if (ReadAt(file.get(), info.m_localHeaderOffset, header, sizeof(header)) && ReadUint32(header) == 0x04034b50)
+    {
+        uint64_t dataOffset = info.m_localHeaderOffset + 30 + ReadUint16(header + 26) + ReadUint16(header + 28);
+        contents.resize(info.m_compressedSize);
+        ok = ReadAt(file.get(), dataOffset, contents.data(), contents.size());
+    }
+    m_files.push(std::move(file));
+    return ok;
+}
+
+std::shared_ptr<std::vector<unsigned char>> ZipByteReader::CacheLookup(size_t seqId)
+{
+    std::lock_guard<std::mutex> lock(m_cacheLock);
+    auto hit = m_cacheIndex.find(seqId);
+    if (hit == m_cacheIndex.end())
+        return nullptr;
+    m_cacheList.splice(m_cacheList.begin(), m_cacheList, hit->second);
+    return m_cacheList.front().second;
+}
+
+void ZipByteReader::CacheInsert(size_t seqId, const std::shared_ptr<std::vector<unsigned char>>& data)
+{
+    std::lock_guard<std::mutex> lock(m_cacheLock);
+    if (m_cacheIndex.find(seqId) != m_cacheIndex.end())
+        return;
+    m_cacheBytes += data->size();
+    m_cacheList.emplace_front(seqId, data);
+    m_cacheIndex[seqId] = m_cacheList.begin();
+    while (m_cacheBytes > m_maxCacheBytes && !m_cacheList.empty())
+    {
+        m_cacheBytes -= m_cacheList.back().second->size();
+        m_cacheIndex.erase(m_cacheList.back().first);
+        m_cacheList.pop_back();
+    }
+}
+
+cv::Mat ZipByteReader::Read(size_t seqId, const std::string& path, int imreadMode)
+{
+    if (m_maxCacheBytes > 0)
+    {
+        auto cached = CacheLookup(seqId);
+        if (cached != nullptr)
+            return cv::imdecode(cv::Mat(1, (int)cached->size(), CV_8UC1, cached->data()), imreadMode);
+    }
+
+    // Stored entries bypass the zip handles entirely: the payload is read straight off
+    // a pooled file descriptor at the offset recorded in the central-directory snapshot.
+    auto info = m_entryInfo.find(seqId);
+    if (info != m_entryInfo.end() && info->second.m_compressionMethod == 0 && !info->second.m_encrypted)
+    {
+        auto contents = std::make_shared<std::vector<unsigned char>>();
+        if (TryDirectRead(info->second, *contents))
+        {
+            if (m_maxCacheBytes > 0)
+                CacheInsert(seqId, contents);
+            cv::Mat img = cv::imdecode(cv::Mat(1, (int)contents->size(), CV_8UC1, contents->data()), imreadMode);
+            assert(nullptr != img.data);
+            return img;
+        }
+    }
+
     // Find index of the file in .zip file.
     auto r = m_seqIdToIndex.find(seqId);
     if (r == m_seqIdToIndex.end())
@@ -131,7 +338,11 @@ cv::Mat ZipByteReader::Read(size_t seqId, const std::string& path, bool grayscal
     });
     m_zips.push(std::move(zipFile));
 
-    cv::Mat img = cv::imdecode(contents, grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    // Cache the inflated payload so repeat visits skip both the zip handle and the inflate.
+    if (m_maxCacheBytes > 0)
+        CacheInsert(seqId, std::make_shared<std::vector<unsigned char>>(contents.data(), contents.data() + size));
+
+    cv::Mat img = cv::imdecode(contents, imreadMode);
     assert(nullptr != img.data);
     m_workspace.push(std::move(contents));
     return img;
@@ -906,11 +906,14 @@ bool HTKMLFReader<ElemType>::PopulateUtteranceInMinibatch(
                 m_featuresBufferAllocatedMultiIO[id] = dim * mbSize * m_numberOfuttsPerMinibatch;
             }
 
+            // interleave the frames on worker threads; each frame writes its own column slot
             if (sizeof(ElemType) == sizeof(float))
-            { 
+            {
                 // For float, we copy entire column.
-                for (size_t j = startFrame, k = 0; j < endFrame; j++, k++)
+#pragma omp parallel for
+                for (int k = 0; k < (int) (endFrame - startFrame); k++)
                 {
+                    size_t j = startFrame + k;
                     memcpy_s(&m_featuresBufferMultiIO[id][((k + mbOffset) * m_numberOfuttsPerMinibatch + uttIndex) * dim],
                              sizeof(ElemType) * dim,
                              &m_featuresBufferMultiUtt[uttIndex][j * dim + m_featuresStartIndexMultiUtt[id + uttIndex * numOfFea]],
@@ -918,13 +921,15 @@ bool HTKMLFReader<ElemType>::PopulateUtteranceInMinibatch(
                 }
             }
             else
-            { 
+            {
                 // For double, we have to copy element by element.
-                for (size_t j = startFrame, k = 0; j < endFrame; j++, k++)
+#pragma omp parallel for
+                for (int k = 0; k < (int) (endFrame - startFrame); k++)
                 {
+                    size_t j = startFrame + k;
                     for (int d = 0; d < dim; d++)
                     {
-                        m_featuresBufferMultiIO[id][((k + mbOffset) * m_numberOfuttsPerMinibatch + uttIndex) * dim + d] = 
+                        m_featuresBufferMultiIO[id][((k + mbOffset) * m_numberOfuttsPerMinibatch + uttIndex) * dim + d] =
                             m_featuresBufferMultiUtt[uttIndex][j * dim + d + m_featuresStartIndexMultiUtt[id + uttIndex * numOfFea]];
                     }
                 }
@@ -948,11 +953,13 @@ bool HTKMLFReader<ElemType>::PopulateUtteranceInMinibatch(
                 m_labelsBufferAllocatedMultiIO[id] = dim * mbSize * m_numberOfuttsPerMinibatch;
             }
 
-            for (size_t j = startFrame, k = 0; j < endFrame; j++, k++)
+#pragma omp parallel for
+            for (int k = 0; k < (int) (endFrame - startFrame); k++)
             {
+                size_t j = startFrame + k;
                 for (int d = 0; d < dim; d++)
                 {
-                    m_labelsBufferMultiIO[id][((k + mbOffset) * m_numberOfuttsPerMinibatch + uttIndex) * dim + d] = 
+                    m_labelsBufferMultiIO[id][((k + mbOffset) * m_numberOfuttsPerMinibatch + uttIndex) * dim + d] =
                         m_labelsBufferMultiUtt[uttIndex][j * dim + d + m_labelsStartIndexMultiUtt[id + uttIndex * numOfLabel]];
                 }
             }
@@ -1810,9 +1817,11 @@ bool HTKMLFReader<ElemType>::ReNewBufferForMultiIO(size_t i)
         }
         assert(actualmbsizeOri == m_mbiter->currentmbframes());
 
+        // spread the per-utterance copy over worker threads; every frame writes a disjoint slice
         if (sizeof(ElemType) == sizeof(float))
         {
-            for (int k = 0; k < actualmbsizeOri; k++) // column major, so iterate columns
+#pragma omp parallel for
+            for (int k = 0; k < (int) actualmbsizeOri; k++) // column major, so iterate columns
             {
                 // copy over the entire column at once, need to do this because SSEMatrix may have gaps at the end of the columns
                 memcpy_s(&m_featuresBufferMultiUtt[i][k * fdim + m_featuresStartIndexMultiUtt[id + i * numOfFea]], sizeof(ElemType) * fdim, &featOri(0, k), sizeof(ElemType) * fdim);
@@ -1820,7 +1829,8 @@ bool HTKMLFReader<ElemType>::ReNewBufferForMultiIO(size_t i)
         }
         else
         {
-            for (int k = 0; k < actualmbsizeOri; k++) // column major, so iterate columns in outside loop
+#pragma omp parallel for
+            for (int k = 0; k < (int) actualmbsizeOri; k++) // column major, so iterate columns in outside loop
             {
                 for (int d = 0; d < featOri.rows(); d++)
                 {
@@ -1841,7 +1851,8 @@ bool HTKMLFReader<ElemType>::ReNewBufferForMultiIO(size_t i)
         if (m_convertLabelsToTargetsMultiIO[id])
         {
             size_t labelDim = m_labelToTargetMapMultiIO[id].size();
-            for (int k = 0; k < actualmbsizeOri; k++)
+#pragma omp parallel for
+            for (int k = 0; k < (int) actualmbsizeOri; k++)
             {
                 assert(uids[k] < labelDim);
                 labelDim;
@@ -1856,7 +1867,8 @@ bool HTKMLFReader<ElemType>::ReNewBufferForMultiIO(size_t i)
         {
             // loop through the columns and set one value to 1
             // in the future we want to use a sparse matrix here
-            for (int k = 0; k < actualmbsizeOri; k++)
+#pragma omp parallel for
+            for (int k = 0; k < (int) actualmbsizeOri; k++)
             {
                 assert(uids[k] < dim);
                 // labels(uids[i], i) = (ElemType)1;
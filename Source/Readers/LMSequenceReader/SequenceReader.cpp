@@ -1110,17 +1110,28 @@ void SequenceReader<ElemType>::GetClassInfo()
     int curDevId = m_classInfoLocal->GetDeviceId();
     m_classInfoLocal->TransferFromDeviceToDevice(curDevId, CPUDEVICE, true, false, false);
 
+    // also build the flat partition arrays; they are filled once here and then shared
+    // read-only across epochs by the per-token loop of GetLabelOutput()
+    m_wordToClass.resize(nwords);
+    m_classLeft.assign(m_classSize, 0);
+    m_classRight.assign(m_classSize, 0);
+
     int clsidx;
     int prvcls = -1;
     for (size_t j = 0; j < nwords; j++)
     {
         clsidx = idx4class[(int) j];
+        m_wordToClass[j] = clsidx;
         if (prvcls != clsidx && clsidx > prvcls)
         {
             if (prvcls >= 0)
+            {
                 (*m_classInfoLocal)(1, prvcls) = (float) j;
+                m_classRight[prvcls] = (int) j;
+            }
             prvcls = clsidx;
             (*m_classInfoLocal)(0, prvcls) = (float) j;
+            m_classLeft[prvcls] = (int) j;
         }
         else if (prvcls > clsidx)
         {
@@ -1129,6 +1140,7 @@ void SequenceReader<ElemType>::GetClassInfo()
         }
     }
     (*m_classInfoLocal)(1, prvcls) = (float) nwords;
+    m_classRight[prvcls] = nwords;
 
     //    (*m_classInfoLocal).Print();
 
@@ -2129,21 +2141,25 @@ void BatchSequenceReader<ElemType>::GetLabelOutput(StreamMinibatchInputs& matric
         }
         else if (readerMode == ReaderMode::Class)
         {
-            int clsidx = idx4class[wrd];
+            // index the flat partition arrays built by GetClassInfo() rather than the
+            // idx4class map and m_classInfoLocal elements; this loop runs per token per minibatch
+            if (wrd < 0 || (size_t) wrd >= m_wordToClass.size())
+                LogicError("LMSequenceReader::GetLabelOutput word %d is outside of the vocabulary of %d words.\n", (int) wrd, (int) m_wordToClass.size());
+            int clsidx = m_wordToClass[wrd];
             if (m_classSize > 0)
             {
                 labels.SetValue(1, j, (ElemType) clsidx);
 
                 // save the [begining ending_indx) of the class
-                size_t lft = (size_t) (*m_classInfoLocal)(0, clsidx);
-                size_t rgt = (size_t) (*m_classInfoLocal)(1, clsidx);
+                size_t lft = (size_t) m_classLeft[clsidx];
+                size_t rgt = (size_t) m_classRight[clsidx];
                 if (wrd < lft || lft > rgt || wrd >= rgt)
                 {
                     LogicError("LMSequenceReader::GetLabelOutput word %d should be at least equal to or larger than its class's left index %d; right index %d of its class should be larger or equal to left index %d of its class; word index %d should be smaller than its class's right index %d.\n",
                                (int) wrd, (int) lft, (int) rgt, (int) lft, (int) wrd, (int) rgt);
                 }
-                labels.SetValue(2, j, (*m_classInfoLocal)(0, clsidx)); // begining index of the class
-                labels.SetValue(3, j, (*m_classInfoLocal)(1, clsidx)); // end index of the class
+                labels.SetValue(2, j, (ElemType) lft); // begining index of the class
+                labels.SetValue(3, j, (ElemType) rgt); // end index of the class
             }
         }
         else if (readerMode == ReaderMode::Softmax)
@@ -136,6 +136,13 @@ public:
     int m_classSize;
     map<int, vector<int>> class_words;
 
+    // flat, cache-friendly copies of the class partition, built once in GetClassInfo() and
+    // read-only afterwards; the per-token loop of GetLabelOutput() indexes these instead of
+    // walking the idx4class map and reading m_classInfoLocal element-wise every minibatch
+    vector<int> m_wordToClass;  // [wrd] -> class id
+    vector<int> m_classLeft;    // [cls] -> first word index of the class
+    vector<int> m_classRight;   // [cls] -> one past the last word index of the class
+
     int m_noiseSampleSize;
     noiseSampler<long> m_noiseSampler;
 
@@ -353,6 +360,9 @@ public:
     //using Base::m_featuresBufferRowIdx;
     using Base::m_sequence;
     using Base::idx4class;
+    using Base::m_wordToClass;
+    using Base::m_classLeft;
+    using Base::m_classRight;
     using Base::m_indexer;
     using Base::m_noiseSampleSize;
     using Base::m_noiseSampler;
@@ -53,6 +53,13 @@ long BatchLUSequenceParser<NumType, LabelType>::Parse(size_t recordsRequested, s
     m_inputs = input;
     m_labels = labels;
 
+    // freeze the label-to-id maps into open-addressing hashes; a no-op on all but the first call
+    mInputLabelHash.Freeze(inputlabel2id);
+    mOutputLabelHash.Freeze(outputlabel2id);
+    long unkInputId = -1, unkOutputId = -1;
+    bool hasUnkInput = mInputLabelHash.TryGet(mUnkStr, unkInputId);
+    bool hasUnkOutput = mOutputLabelHash.TryGet(mUnkStr, unkOutputId);
+
     long recordCount = 0;
     long orgRecordCount = (long) labels->size();
     long lineCount = 0;
@@ -60,26 +67,106 @@ long BatchLUSequenceParser<NumType, LabelType>::Parse(size_t recordsRequested, s
     bool bAtEOS = false; // whether the reader is at the end of sentence position
     SequencePosition sequencePositionLast(0, 0, 0);
 
-    wstring ch;
-    while (lineCount < recordsRequested && mFile.good())
-    {
-        getline(mFile, ch);
-        ch = trim(ch); // TODO: operates in-place, so no need to assign back
+    const size_t linesPerChunk = 10000; // lines tokenized and mapped per parallel batch
+    std::vector<wstring> chunk;
+    chunk.reserve(linesPerChunk);
 
-        if (mFile.eof())
+    while (lineCount < recordsRequested)
+    {
+        if (mPendingLines.empty())
         {
-            if (canMultiplePassData)
+            if (!mFile.good())
+            {
+                if (canMultiplePassData)
+                    ParseReset(); // restart from the corpus begining
+                else
+                    break;
+            }
+
+            // phase 1: pull a block of raw lines off the file (sequential, I/O-bound)
+            chunk.clear();
+            wstring ch;
+            while (chunk.size() < linesPerChunk && mFile.good())
             {
-                ParseReset(); // restart from the corpus begining
-                continue;
+                getline(mFile, ch);
+                if (mFile.eof())
+                    break;
+                chunk.push_back(std::move(ch));
+            }
+            if (chunk.empty())
+                continue; // end of file; handled above on the next iteration
+
+            // phase 2: tokenize and map tokens to ids in parallel; lines are independent here,
+            // and the frozen label hashes are read-only
+            std::vector<ParsedLine> parsed(chunk.size());
+            bool badInputToken = false, badOutputToken = false;
+            wstring badToken;
+#pragma omp parallel for schedule(dynamic, 64)
+            for (int i = 0; i < (int) chunk.size(); i++)
+            {
+                wstring& line = chunk[i];
+                ParsedLine& pl = parsed[i];
+                trim(line);
+                pl.blank = (line.length() == 0);
+                std::vector<wstring> vstr = SplitString(line, L" \n\r\t");
+                pl.skip = (vstr.size() < 2);
+                if (pl.skip)
+                    continue;
+                pl.inputIds.reserve(vstr.size() - 1);
+                for (size_t k = 0; k < vstr.size() - 1; k++)
+                {
+                    long id;
+                    if (!mInputLabelHash.TryGet(vstr[k], id))
+                    {
+                        if (!hasUnkInput)
+                        {
+#pragma omp critical(lusequenceparserbadtoken)
+                            if (!badInputToken && !badOutputToken)
+                            {
+                                badInputToken = true;
+                                badToken = vstr[k];
+                            }
+                            break;
+                        }
+                        id = unkInputId;
+                    }
+                    pl.inputIds.push_back(id);
+                }
+                if (!mOutputLabelHash.TryGet(vstr[vstr.size() - 1], pl.labelId))
+                {
+                    if (!hasUnkOutput)
+                    {
+#pragma omp critical(lusequenceparserbadtoken)
+                        if (!badInputToken && !badOutputToken)
+                        {
+                            badOutputToken = true;
+                            badToken = vstr[vstr.size() - 1];
+                        }
+                        continue;
+                    }
+                    pl.labelId = unkOutputId;
+                }
+                pl.endOfSequence = (vstr[vstr.size() - 1] == m_endSequenceOut ||
+                                    // below is for backward support
+                                    vstr[0] == m_endTag);
             }
-            else
-                break;
+            // errors cannot be thrown from inside the parallel region, so raise them here
+            if (badInputToken)
+                LogicError("cannot find item %ls and unk str %ls in input label", badToken.c_str(), mUnkStr.c_str());
+            if (badOutputToken)
+                LogicError("cannot find item %ls and unk str %ls in output label", badToken.c_str(), mUnkStr.c_str());
+
+            for (auto& pl : parsed)
+                mPendingLines.push_back(std::move(pl));
+            continue;
         }
 
-        std::vector<wstring> vstr;
-        bool bBlankLine = (ch.length() == 0);
-        if (bBlankLine && !bAtEOS && input->size() > 0 && labels->size() > 0)
+        // phase 3: assemble sequences in file order; this reproduces the sequential state machine,
+        // and lines parsed beyond the requested record count stay pending for the next call
+        ParsedLine pl = std::move(mPendingLines.front());
+        mPendingLines.pop_front();
+
+        if (pl.blank && !bAtEOS && input->size() > 0 && labels->size() > 0)
         {
             AddOneItem(labels, input, seqPos, lineCount, recordCount, orgRecordCount, sequencePositionLast);
             bAtEOS = true;
@@ -89,38 +176,13 @@ long BatchLUSequenceParser<NumType, LabelType>::Parse(size_t recordsRequested, s
         // got a token
         tokenCount++;
 
-        vstr = SplitString(ch, L" \n\r\t");
-        if (vstr.size() < 2)
+        if (pl.skip)
             continue;
 
         bAtEOS = false;
-        vector<long> vtmp;
-        for (size_t i = 0; i < vstr.size() - 1; i++)
-        {
-            if (inputlabel2id.find(vstr[i]) == inputlabel2id.end())
-            {
-                if (inputlabel2id.find(mUnkStr) == inputlabel2id.end())
-                {
-                    LogicError("cannot find item %ls and unk str %ls in input label", vstr[i].c_str(), mUnkStr.c_str());
-                }
-                vtmp.push_back(inputlabel2id.find(mUnkStr)->second);
-            }
-            else
-                vtmp.push_back(inputlabel2id.find(vstr[i])->second);
-        }
-        if (outputlabel2id.find(vstr[vstr.size() - 1]) == outputlabel2id.end())
-        {
-            if (outputlabel2id.find(mUnkStr) == outputlabel2id.end())
-                LogicError("cannot find item %ls and unk str %ls in output label", vstr[vstr.size() - 1].c_str(), mUnkStr.c_str());
-            labels->push_back(outputlabel2id.find(mUnkStr)->second);
-        }
-        else
-            labels->push_back(outputlabel2id.find(vstr[vstr.size() - 1])->second);
-        input->push_back(vtmp);
-        if ((vstr[vstr.size() - 1] == m_endSequenceOut ||
-             // below is for backward support
-             vstr[0] == m_endTag) &&
-            input->size() > 0 && labels->size() > 0)
+        labels->push_back(pl.labelId);
+        input->push_back(std::move(pl.inputIds));
+        if (pl.endOfSequence && input->size() > 0 && labels->size() > 0)
         {
             AddOneItem(labels, input, seqPos, lineCount, recordCount, orgRecordCount, sequencePositionLast);
             bAtEOS = true;
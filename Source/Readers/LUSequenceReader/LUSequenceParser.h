@@ -9,6 +9,8 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <functional>
 #include <assert.h>
 #include <fstream>
 #include <iostream>
@@ -131,6 +133,82 @@ struct SentenceInfo
     int sEnd;
 };
 
+// LabelIdHash - open-addressing hash over a frozen label-to-id map
+// The reader builds its label-to-id maps once (from the label mapping file) and never changes them
+// while parsing, but the per-token std::map lookup on the parse path is a tree walk with a string
+// compare per level. This freezes the map into a flat probed table (same scheme as ReaderLib's
+// TStringToIdMap, but carrying the reader's pre-assigned ids rather than assigning its own), which
+// is also safe to query from parallel threads since it is read-only once frozen.
+class LabelIdHash
+{
+public:
+    LabelIdHash()
+        : mSource(nullptr), mSourceSize(0), mMask(0)
+    {
+    }
+
+    // (re-)build the table from the map; a no-op if the same, unchanged map was frozen before
+    void Freeze(const map<wstring, long>& label2id)
+    {
+        if (mSource == &label2id && mSourceSize == label2id.size())
+            return;
+
+        size_t capacity = 16;
+        while (capacity * 3 < (label2id.size() + 1) * 4) // keep the load factor below 3/4
+            capacity *= 2;
+        mKeys.assign(capacity, wstring());
+        mIds.assign(capacity, 0);
+        mUsed.assign(capacity, false);
+        mMask = capacity - 1;
+        for (const auto& iter : label2id)
+        {
+            size_t index = std::hash<wstring>()(iter.first) & mMask;
+            while (mUsed[index]) // linear probing; table never fills up at this load factor
+                index = (index + 1) & mMask;
+            mUsed[index] = true;
+            mKeys[index] = iter.first;
+            mIds[index] = iter.second;
+        }
+        mSource = &label2id;
+        mSourceSize = label2id.size();
+    }
+
+    bool TryGet(const wstring& key, long& id) const
+    {
+        if (mUsed.empty())
+            return false;
+        for (size_t index = std::hash<wstring>()(key) & mMask;; index = (index + 1) & mMask)
+        {
+            if (!mUsed[index])
+                return false;
+            if (mKeys[index] == key)
+            {
+                id = mIds[index];
+                return true;
+            }
+        }
+    }
+
+private:
+    const map<wstring, long>* mSource; // map the table was frozen from, to detect staleness
+    size_t mSourceSize;
+    size_t mMask;
+    vector<wstring> mKeys;
+    vector<long> mIds;
+    vector<bool> mUsed;
+};
+
+// one input line after tokenization and label-to-id mapping, pending consumption by the
+// sequential sequence-assembly pass of Parse()
+struct ParsedLine
+{
+    bool blank;            // line was empty after trimming
+    bool skip;             // fewer than two tokens; counted but otherwise ignored
+    bool endOfSequence;    // line carried the end-of-sequence marker
+    long labelId;          // id of the output label (last token)
+    vector<long> inputIds; // ids of the input tokens
+};
+
 // language-understanding sequence parser
 template <typename NumType, typename LabelType = wstring>
 class BatchLUSequenceParser : public LUSequenceParser<NumType, LabelType>
@@ -195,6 +273,7 @@ public:
 
     void ParseReset()
     {
+        mPendingLines.clear(); // drop lines read ahead of the reset point
         mFile.close();
 #ifdef __unix__
         mFile.open(ws2s(mFileName), wifstream::in);
@@ -229,6 +308,11 @@ public:
     // seqPos - pointers to the other two arrays showing positions of each sequence
     // returns - number of records actually read, if the end of file is reached the return value will be < requested records
     long Parse(size_t recordsRequested, std::vector<long>* labels, std::vector<vector<long>>* input, std::vector<SequencePosition>* seqPos, const map<wstring, long>& inputlabel2id, const map<wstring, long>& outputlabel2id, bool mAllowMultPassData = false);
+
+protected:
+    LabelIdHash mInputLabelHash;  // frozen hash over inputlabel2id, rebuilt only if the map changes
+    LabelIdHash mOutputLabelHash; // frozen hash over outputlabel2id
+    std::deque<ParsedLine> mPendingLines; // lines parsed ahead of the requested record count
 };
 }
 }
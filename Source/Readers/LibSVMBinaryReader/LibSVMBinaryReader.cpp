@@ -208,7 +208,7 @@ void SparseBinaryMatrix<ElemType>::Fill(Matrix<ElemType>* matrix)
 
 template <class ElemType>
 SparseBinaryInput<ElemType>::SparseBinaryInput(std::wstring fileName)
-    : m_fileName(fileName), m_readOrder(nullptr), m_readOrderLength(0), m_randomize(false), m_tempValues(nullptr), m_tempValuesSize(0), m_offsets(nullptr), m_offsetsStart(0), m_startMB(0), m_endMB(0)
+    : m_fileName(fileName), m_readOrder(nullptr), m_readOrderLength(0), m_randomizeSeed(0), m_randomBlockSize(1), m_maxReadAheadMem(1024 * 1024 * 1024), m_tempValues(nullptr), m_tempValuesSize(0), m_offsets(nullptr), m_offsetsStart(0), m_startMB(0), m_endMB(0)
 {
     std::string name = msra::strfun::utf8(m_fileName);
     m_inFile.open(name, ifstream::binary | ifstream::in);
@@ -324,14 +324,7 @@ void SparseBinaryInput<ElemType>::Init(std::map<std::wstring, std::wstring> rena
 template <class ElemType>
 bool SparseBinaryInput<ElemType>::Randomize()
 {
-    return false;
-    /*
-                if (m_randomize > 0)
-                {
-                    return true;
-                }
-                return false;
-                */
+    return m_randomizeSeed != 0;
 }
 
 template <class ElemType>
@@ -374,22 +367,47 @@ void SparseBinaryInput<ElemType>::ReadOffsets(size_t startMB, size_t numMBs)
     m_endMB = startMB + numMBs;
 }
 
+// Shuffle - randomize the streaming order at two granularities: the order of fixed-size
+// blocks of consecutive microbatches is shuffled coarsely (so reads within a block stay
+// close together on disk and the read-ahead thread keeps mostly sequential access), and
+// microbatches are shuffled again within each block
 template <class ElemType>
 void SparseBinaryInput<ElemType>::Shuffle()
 {
-    if (Randomize())
+    if (!Randomize())
+        return;
+
+    size_t numBlocks = (m_readOrderLength + m_randomBlockSize - 1) / m_randomBlockSize;
+    std::vector<size_t> blockOrder(numBlocks);
+    for (size_t c = 0; c < numBlocks; c++)
+    {
+        blockOrder[c] = c;
+    }
+    shuffle(blockOrder.begin(), blockOrder.end(), m_randomEngine);
+
+    size_t pos = 0;
+    for (size_t b = 0; b < numBlocks; b++)
     {
-        shuffle(&(m_readOrder[0]), &(m_readOrder[m_readOrderLength - 1]), m_randomEngine);
-        // ToDo: move to different shuffle implementation to be platform independent
+        size_t blockStart = blockOrder[b] * m_randomBlockSize;
+        size_t blockEnd = min(blockStart + m_randomBlockSize, m_readOrderLength);
+        size_t fillStart = pos;
+        for (size_t c = blockStart; c < blockEnd; c++)
+        {
+            m_readOrder[pos++] = c;
+        }
+        shuffle(m_readOrder + fillStart, m_readOrder + pos, m_randomEngine);
     }
 }
 
 template <class ElemType>
-void SparseBinaryInput<ElemType>::StartDistributedMinibatchLoop(size_t mbSize, size_t subsetNum, size_t numSubsets)
+void SparseBinaryInput<ElemType>::StartDistributedMinibatchLoop(size_t mbSize, size_t subsetNum, size_t numSubsets, size_t epoch)
 {
 
     m_nextMB = 0;
 
+    // reseed per epoch so every sweep streams the subset in a fresh shuffled order
+    m_randomEngine.seed(m_randomizeSeed + epoch);
+
     m_mbSize = mbSize / numSubsets;
 
     m_subsetNum = subsetNum;
@@ -436,8 +454,7 @@ void SparseBinaryInput<ElemType>::StartDistributedMinibatchLoop(size_t mbSize, s
         }
         // fprintf(stderr, "max mb size: %ld\n", m_maxMBSize);
 
-        size_t maxMem = 1024 * 1024 * 1024; // 1GB
-        size_t maxPointers = maxMem / m_maxMBSize;
+        size_t maxPointers = max(m_maxReadAheadMem / m_maxMBSize, (size_t) 1);
         for (size_t c = 0; c < maxPointers; c++)
         {
             void* dataBuffer = malloc(m_maxMBSize);
@@ -515,7 +532,7 @@ void SparseBinaryInput<ElemType>::ReadMinibatches(size_t* read_order, size_t num
 #if DEBUG
         series.write_flag(_T("seeking."));
 #endif
-        m_inFile.seekg(m_dataStart + m_offsets[c], ios::beg);
+        m_inFile.seekg(m_dataStart + m_offsets[read_order[c]], ios::beg);
 #if DEBUG
         series.write_flag(_T("reading."));
 #endif
@@ -682,6 +699,14 @@ void LibSVMBinaryReader<ElemType>::InitFromConfig(const ConfigRecordType& reader
     m_dataInput = make_shared<SparseBinaryInput<ElemType>>(file);
     m_dataInput->Init(rename);
 
+    // streaming randomization: coarse shuffled order over blocks of consecutive microbatches
+    // plus a shuffle within each block; block size trades randomization quality for
+    // sequential disk access
+    m_dataInput->SetRandomizationInfo(m_randomize, (size_t) readerConfig(L"randomizationBlockSize", 256));
+
+    // memory bound on the asynchronous read-ahead ring, in MB
+    m_dataInput->SetMaxReadAheadMemory((size_t) readerConfig(L"readAheadMemoryMB", 1024) * 1024 * 1024);
+
     m_mbSize = (size_t) readerConfig(L"minibatch", 0);
     if (m_mbSize > 0)
     {
@@ -729,7 +754,7 @@ void LibSVMBinaryReader<ElemType>::StartDistributedMinibatchLoop(size_t mbSize,
     reader_series = new marker_series(L"Base Reader");
     cur_read = 0;
 #endif
-    m_dataInput->StartDistributedMinibatchLoop(mbSize, subsetNum, numSubsets);
+    m_dataInput->StartDistributedMinibatchLoop(mbSize, subsetNum, numSubsets, epoch);
 }
 
 template <class ElemType>
@@ -161,7 +161,22 @@ public:
     SparseBinaryInput(std::wstring fileName);
     ~SparseBinaryInput();
     void Init(std::map<std::wstring, std::wstring> rename);
-    void StartDistributedMinibatchLoop(size_t mbSize, size_t subsetNum, size_t numSubsets);
+    // SetRandomizationInfo - enable shuffled streaming
+    // randomizeSeed - seed for the random engine, zero disables shuffling
+    // blockSize - number of consecutive microbatches shuffled as one unit; reads within a
+    //             block stay close together on disk, so larger blocks mean more sequential I/O
+    void SetRandomizationInfo(unsigned long randomizeSeed, size_t blockSize)
+    {
+        m_randomizeSeed = randomizeSeed;
+        m_randomBlockSize = max(blockSize, (size_t) 1);
+    }
+    // SetMaxReadAheadMemory - bound on the read-ahead buffer ring; dataset size is then
+    // limited by disk, not host RAM
+    void SetMaxReadAheadMemory(size_t maxBytes)
+    {
+        m_maxReadAheadMem = maxBytes;
+    }
+    void StartDistributedMinibatchLoop(size_t mbSize, size_t subsetNum, size_t numSubsets, size_t epoch = 0);
     void ReadMinibatches(size_t* read_order, size_t numToRead);
     size_t ReadMinibatch(void* data_buffer, std::map<std::wstring, shared_ptr<BinaryMatrix<ElemType>>>& matrices);
     size_t FillMatrices(std::map<std::wstring, shared_ptr<BinaryMatrix<ElemType>>>& matrices);
@@ -211,7 +226,9 @@ private:
     size_t m_windowSize;
     size_t m_curWindowSize;
 
-    bool m_randomize;
+    unsigned long m_randomizeSeed; // zero disables shuffling
+    size_t m_randomBlockSize;      // microbatches per coarse shuffle block
+    size_t m_maxReadAheadMem;      // bytes of buffer ring for asynchronous read-ahead
     size_t* m_readOrder; // array to shuffle to reorder the dataset
     size_t m_readOrderLength;
     size_t m_maxMBSize;
@@ -9,10 +9,13 @@
 #include <inttypes.h>
 #include "BlockRandomizer.h"
 #include <algorithm>
+#include <chrono>
 #include <utility>
 
 #include "DataReader.h"
 #include "ExceptionCapture.h"
+#include "PerformanceProfiler.h"
+#include "ReaderTelemetry.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -22,7 +25,10 @@ BlockRandomizer::BlockRandomizer(
     IDataDeserializerPtr deserializer,
     bool shouldPrefetch,
     bool multithreadedGetNextSequence,
-    size_t maxNumberOfInvalidSequences)
+    size_t maxNumberOfInvalidSequences,
+    size_t prefetchDepth,
+    const std::vector<size_t>& lengthBucketBoundaries,
+    size_t randomizationMemoryBudgetInBytes)
     : m_verbosity(verbosity),
       m_deserializer(deserializer),
       m_sweep(SIZE_MAX),
@@ -30,9 +36,10 @@ BlockRandomizer::BlockRandomizer(
       m_globalSamplePosition(SIZE_MAX),
       m_epochStartPosition(0),
       m_sweepTotalNumberOfSamples(0),
-      m_chunkRandomizer(std::make_shared<ChunkRandomizer>(deserializer, randomizationRangeInSamples)),
+      m_chunkRandomizer(std::make_shared<ChunkRandomizer>(deserializer, randomizationRangeInSamples,
+          verbosity, randomizationMemoryBudgetInBytes, std::max<size_t>(prefetchDepth, 1))),
       m_multithreadedGetNextSequences(multithreadedGetNextSequence),
-      m_prefetchedChunk(CHUNKID_MAX),
+      m_prefetchDepth(std::max<size_t>(prefetchDepth, 1)),
       m_cleaner(maxNumberOfInvalidSequences)
 {
     assert(deserializer != nullptr);
@@ -40,7 +47,7 @@ BlockRandomizer::BlockRandomizer(
     m_launchType = shouldPrefetch ? launch::async : launch::deferred;
 
     m_streams = m_deserializer->GetStreamDescriptions();
-    m_sequenceRandomizer = std::make_shared<SequenceRandomizer>(verbosity, m_deserializer, m_chunkRandomizer);
+    m_sequenceRandomizer = std::make_shared<SequenceRandomizer>(verbosity, m_deserializer, m_chunkRandomizer, lengthBucketBoundaries);
 
     // Calculate total number of samples.
     m_sweepTotalNumberOfSamples = 0;
@@ -160,9 +167,8 @@ Sequences BlockRandomizer::GetNextSequences(size_t globalSampleCount, size_t loc
 
     m_cleaner.Clean(result);
 
-    // Now it is safe to start the new chunk prefetch.
-    ChunkIdType chunkToPrefetchNext = GetChunkToPrefetch(windowRange);
-    Prefetch(chunkToPrefetchNext);
+    // Now it is safe to start the new chunk prefetches.
+    Prefetch(windowRange);
 
     return result;
 }
@@ -271,10 +277,14 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
         }
 
         auto const& chunk = m_chunkRandomizer->GetRandomizedChunks()[i];
-        if (chunk.m_original->m_id == m_prefetchedChunk && m_prefetch.valid())
+        auto prefetched = std::find_if(m_prefetches.begin(), m_prefetches.end(),
+            [&chunk](const PrefetchedChunk& p) { return p.m_id == chunk.m_original->m_id; });
+        if (prefetched != m_prefetches.end())
         {
-            // Taking prefetched chunk.
-            m_chunks[chunk.m_original->m_id] = m_prefetch.get();
+            // Taking prefetched chunk. Getting a chunk from the middle of the queue implicitly
+            // waits for the fetches queued in front of it, as the tasks are chained.
+            m_chunks[chunk.m_original->m_id] = prefetched->m_future.get();
+            m_prefetches.erase(prefetched);
             if (m_verbosity >= Information)
                 fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in prefetched chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
                 chunk.m_chunkId,
@@ -283,13 +293,14 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
         }
         else
         {
-            // Make sure we have no outstanding prefetches.
-            if (m_prefetch.valid())
+            // Make sure we have no outstanding prefetches, the deserializer handles one
+            // GetChunk() at a time.
+            if (!m_prefetches.empty())
             {
-                m_prefetch.wait();
+                m_prefetches.back().m_future.wait();
             }
 
-            m_chunks[chunk.m_original->m_id] = m_deserializer->GetChunk(chunk.m_original->m_id);
+            m_chunks[chunk.m_original->m_id] = FetchChunk(chunk.m_original->m_id);
             if (m_verbosity >= Information)
                 fprintf(stderr, "BlockRandomizer::RetrieveDataChunks: paged in randomized chunk %u (original chunk: %u), now %" PRIu64 " chunks in memory\n",
                 chunk.m_chunkId,
@@ -305,47 +316,82 @@ void BlockRandomizer::LoadDataChunks(const ClosedOpenChunkInterval& windowRange)
                 m_chunkRandomizer->GetRandomizedChunks()[windowRange.m_end - 1].m_chunkId);
 }
 
-// Identifies chunk id that should be prefetched.
-ChunkIdType BlockRandomizer::GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange)
+// Identifies the chunk ids that should be prefetched next, in randomization order.
+std::vector<ChunkIdType> BlockRandomizer::GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange) const
 {
-    ChunkIdType toBePrefetched = CHUNKID_MAX;
+    std::vector<ChunkIdType> toBePrefetched;
     auto current = windowRange.m_end;
-    while (current < m_chunkRandomizer->GetRandomizedChunks().size())
+    while (current < m_chunkRandomizer->GetRandomizedChunks().size() &&
+           m_prefetches.size() + toBePrefetched.size() < m_prefetchDepth)
     {
         const auto& chunk = m_chunkRandomizer->GetRandomizedChunks()[current];
         if (chunk.m_chunkId % m_config.m_numberOfWorkers == m_config.m_workerRank &&
-            m_chunks.find(chunk.m_original->m_id) == m_chunks.end())
+            m_chunks.find(chunk.m_original->m_id) == m_chunks.end() &&
+            std::find_if(m_prefetches.begin(), m_prefetches.end(),
+                [&chunk](const PrefetchedChunk& p) { return p.m_id == chunk.m_original->m_id; }) == m_prefetches.end())
         {
-            toBePrefetched = chunk.m_original->m_id;
-            break;
+            toBePrefetched.push_back(chunk.m_original->m_id);
         }
         ++current;
     }
     return toBePrefetched;
 }
 
-// Performs io prefetch of the specified chunk if needed.
-void BlockRandomizer::Prefetch(ChunkIdType chunkId)
+ChunkPtr BlockRandomizer::FetchChunk(ChunkIdType chunkId)
 {
-    // Start new prefetch if necessary.
-    if (m_prefetchedChunk != chunkId && chunkId != CHUNKID_MAX)
+    auto profilerState = ProfilerTimeBegin();
+    auto start = std::chrono::steady_clock::now();
+    ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    ReaderPipelineTelemetry::Instance().RecordChunkFetch(elapsed.count());
+    ProfilerTimeEnd(profilerState, "Reader: chunk fetch");
+    return chunk;
+}
+
+// Tops up the prefetch queue with io prefetches of the upcoming chunks.
+void BlockRandomizer::Prefetch(const ClosedOpenChunkInterval& windowRange)
+{
+    for (ChunkIdType chunkId : GetChunksToPrefetch(windowRange))
     {
-        // Wait to make sure there is no outstanding prefetches.
-        if (m_prefetch.valid())
+        // Chain the new fetch task behind the current tail of the queue, so that the
+        // deserializer never runs more than one GetChunk() at a time.
+        std::shared_future<ChunkPtr> previous;
+        if (!m_prefetches.empty())
+            previous = m_prefetches.back().m_future;
+
+        PrefetchedChunk prefetch;
+        prefetch.m_id = chunkId;
+        prefetch.m_future = std::async(m_launchType, [this, chunkId, previous]()
         {
-            m_prefetch.wait();
-        }
-
-        m_prefetchedChunk = chunkId;
-        m_prefetch = std::async(m_launchType, [this, chunkId]() { return m_deserializer->GetChunk(chunkId); });
+            if (previous.valid())
+                previous.wait();
+            return FetchChunk(chunkId);
+        }).share();
+        m_prefetches.push_back(std::move(prefetch));
 
         if (m_verbosity >= Debug)
-            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u\n", chunkId);
+            fprintf(stderr, "BlockRandomizer::Prefetch: prefetching original chunk: %u (%" PRIu64 " in flight)\n",
+                    chunkId, (uint64_t)m_prefetches.size());
+    }
+}
+
+// Waits for and drops all outstanding prefetches, e.g. when the position on the timeline
+// changes and the queued chunks may no longer be the upcoming ones. std::async tasks cannot
+// be interrupted, so cancellation means waiting out the chain and dropping the results.
+void BlockRandomizer::CancelPrefetch()
+{
+    if (!m_prefetches.empty())
+    {
+        m_prefetches.back().m_future.wait();
+        m_prefetches.clear();
     }
 }
 
 void BlockRandomizer::SetCurrentSamplePosition(size_t currentSamplePosition)
 {
+    // the queued chunks were scheduled for the old position and may no longer be the upcoming ones
+    CancelPrefetch();
+
     PrepareNewSweepIfNeeded(currentSamplePosition);
 
     // Sets sequence cursor to the sequence that corresponds to the epoch start position.
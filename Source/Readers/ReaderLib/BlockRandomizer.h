@@ -6,6 +6,7 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 
 #include "SequenceEnumerator.h"
 #include "DataDeserializer.h"
@@ -27,7 +28,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 //         2) if a new chunk is entered, using SequenceRandomizer identify a window of chunks and requested their sequence descriptions from deserializer.
 //         3) randomize sequence descriptions inside the window
 //         4) return sequence descriptions not exceeding sampleCount/minibatch limit
-//         5) decimate sequence descriptions based on the worker rank
+//         5) decimate sequence descriptions based on the worker rank; decimation is chunk-granular
+//            (a sequence is local iff its randomized chunk id maps to this rank), so each worker
+//            only loads and deserializes its own ~1/N of the chunks, and because chunk ids are
+//            re-randomized every sweep, the chunk-to-worker assignment reshuffles across sweeps
 //         6) request chunks of data based on decimated sequences and return sequence data
 //
 // This class is responsible for decimation and loading the data chunks in to memory.
@@ -42,7 +46,10 @@ public:
         IDataDeserializerPtr deserializer,
         bool shouldPrefetch,
         bool multithreadedGetNextSequences = false,
-        size_t maxNumberOfInvalidSequences = 0); // per worker
+        size_t maxNumberOfInvalidSequences = 0, // per worker
+        size_t prefetchDepth = 1, // number of upcoming chunks fetched ahead of use
+        const std::vector<size_t>& lengthBucketBoundaries = std::vector<size_t>(), // optional sequence length buckets, see SequenceRandomizer
+        size_t randomizationMemoryBudgetInBytes = 0); // when non zero, the randomization window is derived from the budget, see ChunkRandomizer
 
     // Starts a new epoch.
     virtual void StartEpoch(const EpochConfiguration& config) override;
@@ -63,10 +70,7 @@ public:
 
     ~BlockRandomizer()
     {
-        if (m_prefetch.valid())
-        {
-            m_prefetch.wait();
-        }
+        CancelPrefetch();
     }
 
     void SetCurrentSamplePosition(size_t currentSamplePosition) override;
@@ -83,11 +87,19 @@ private:
     // Prepares a new sweep if needed.
     void PrepareNewSweepIfNeeded(size_t samplePosition);
 
-    // Performs io prefetch of the specified chunk if needed.
-    void Prefetch(ChunkIdType chunkId);
+    // Tops up the prefetch queue with upcoming chunks in the given range.
+    void Prefetch(const ClosedOpenChunkInterval& windowRange);
 
-    // Returns next candidate for the prefetch in the given range.
-    ChunkIdType GetChunkToPrefetch(const ClosedOpenChunkInterval& windowRange);
+    // Fetches a chunk from the deserializer, recording the fetch latency in the
+    // pipeline telemetry and as a profiler event. Called on the prefetch thread
+    // for prefetched chunks and on the main thread for demand misses.
+    ChunkPtr FetchChunk(ChunkIdType chunkId);
+
+    // Returns the next candidates for the prefetch in the given range, in randomization order.
+    std::vector<ChunkIdType> GetChunksToPrefetch(const ClosedOpenChunkInterval& windowRange) const;
+
+    // Waits for and drops all outstanding prefetches.
+    void CancelPrefetch();
 
     // Global sample position on the timeline.
     size_t m_globalSamplePosition;
@@ -136,12 +148,20 @@ private:
 
     int m_verbosity;
 
-    // Prefetch future.
-    std::future<ChunkPtr> m_prefetch;
+    // Queue of outstanding prefetches in randomization order. The fetch tasks are chained so
+    // that the deserializer never sees more than one GetChunk() call at a time, same as with
+    // the old one-deep prefetch; the queue lets that single i/o chain run several chunk
+    // transitions ahead of the consumer.
+    struct PrefetchedChunk
+    {
+        ChunkIdType m_id;
+        std::shared_future<ChunkPtr> m_future;
+    };
+    std::deque<PrefetchedChunk> m_prefetches;
+    // Number of chunks fetched ahead of use.
+    size_t m_prefetchDepth;
     // Whether to have async or deferred prefetch.
     launch m_launchType;
-    // Prefetched original chunk id.
-    ChunkIdType m_prefetchedChunk;
 
     // Current loaded chunks.
     ClosedOpenChunkInterval m_currentWindowRange;
@@ -7,7 +7,6 @@
 #include "Bundler.h"
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
-#include <set>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -16,8 +15,30 @@ struct Bundler::BundlerChunkDescription : public ChunkDescription
 {
     ChunkDescriptionPtr m_original;
 
-    // Sequences that are invalid in at least one deserializer.
-    std::set<size_t> m_invalid;
+    // Location of a sequence in a secondary deserializer, resolved by its key.
+    struct SequenceLocation
+    {
+        ChunkIdType m_chunkId;
+        size_t m_id;
+        uint32_t m_numberOfSamples;
+    };
+
+    // Bitmap of sequences that are invalid in at least one deserializer.
+    // Empty when all sequences of the chunk are valid.
+    std::vector<bool> m_invalid;
+
+    // Cached locations of the chunk sequences in the secondary deserializers, resolved
+    // once at first bundling so that subsequent epochs do bit tests and array reads
+    // instead of repeating the per-key hash lookups.
+    // Indexed by [sequenceIndex * (number of deserializers - 1) + deserializerIndex - 1].
+    std::vector<SequenceLocation> m_secondaryLocations;
+    bool m_resolved = false;
+
+    // Checks whether the sequence is invalid in at least one deserializer.
+    bool IsInvalid(size_t sequenceIndex) const
+    {
+        return !m_invalid.empty() && m_invalid[sequenceIndex];
+    }
 };
 
 Bundler::Bundler(
@@ -102,8 +123,13 @@ void Bundler::CreateChunkDescriptions()
         sequenceDescriptions.clear();
 
         // Iterating thru all sequences and identifying whether they are valid among all deserializers.
+        // The resolved locations are cached on the chunk description, so that subsequent epochs
+        // do not repeat the per-key hash lookups.
         m_driver->GetSequencesForChunk(chunks[chunkIndex]->m_id, sequenceDescriptions);
-        std::set<size_t> invalid;
+        std::vector<bool> invalid(sequenceDescriptions.size(), false);
+        bool anyInvalid = false;
+        std::vector<BundlerChunkDescription::SequenceLocation> locations(
+            (m_deserializers.size() - 1) * sequenceDescriptions.size());
         for (size_t sequenceIndex = 0; sequenceIndex < sequenceDescriptions.size(); ++sequenceIndex)
         {
             auto sequence = sequenceDescriptions[sequenceIndex];
@@ -114,10 +140,16 @@ void Bundler::CreateChunkDescriptions()
                 isValid = m_deserializers[deserializerIndex]->GetSequenceDescription(sequenceDescriptions[sequenceIndex], s);
                 if (!isValid)
                 {
-                    invalid.insert(sequenceIndex);
+                    invalid[sequenceIndex] = true;
+                    anyInvalid = true;
                     break;
                 }
 
+                auto& location = locations[sequenceIndex * (m_deserializers.size() - 1) + deserializerIndex - 1];
+                location.m_chunkId = s.m_chunkId;
+                location.m_id = s.m_id;
+                location.m_numberOfSamples = s.m_numberOfSamples;
+
                 sequenceSamples = std::max<size_t>(sequenceSamples, s.m_numberOfSamples);
             }
 
@@ -141,7 +173,10 @@ void Bundler::CreateChunkDescriptions()
             cd->m_id = (ChunkIdType) m_chunks.size();
             cd->m_original = chunks[chunkIndex];
             m_chunks.push_back(cd);
-            cd->m_invalid = std::move(invalid);
+            if (anyInvalid)
+                cd->m_invalid = std::move(invalid);
+            cd->m_secondaryLocations = std::move(locations);
+            cd->m_resolved = true;
         }
     }
 
@@ -169,7 +204,7 @@ void Bundler::GetSequencesForChunk(ChunkIdType chunkId, std::vector<SequenceDesc
         result.reserve(sequences.size());
         for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
         {
-            if (chunk->m_invalid.find(sequenceIndex) != chunk->m_invalid.end())
+            if (chunk->IsInvalid(sequenceIndex))
             {
                 continue;
             }
@@ -185,7 +220,7 @@ void Bundler::GetSequencesForChunk(ChunkIdType chunkId, std::vector<SequenceDesc
         SequenceDescription s;
         for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
         {
-            if (chunk->m_invalid.find(sequenceIndex) != chunk->m_invalid.end())
+            if (chunk->IsInvalid(sequenceIndex))
             {
                 continue;
             }
@@ -194,6 +229,13 @@ void Bundler::GetSequencesForChunk(ChunkIdType chunkId, std::vector<SequenceDesc
             uint32_t sequenceSamples = sequence.m_numberOfSamples;
             for (size_t deserializerIndex = 1; deserializerIndex < m_deserializers.size(); ++deserializerIndex)
             {
+                if (chunk->m_resolved)
+                {
+                    sequenceSamples = std::max(sequenceSamples,
+                        chunk->m_secondaryLocations[sequenceIndex * (m_deserializers.size() - 1) + deserializerIndex - 1].m_numberOfSamples);
+                    continue;
+                }
+
                 m_deserializers[deserializerIndex]->GetSequenceDescription(sequence, s);
                 sequenceSamples = std::max(sequenceSamples, s.m_numberOfSamples);
             }
@@ -241,7 +283,7 @@ public:
         m_innerChunks.resize(deserializers.size() * sequences.size());
         for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
         {
-            if (chunk->m_invalid.find(sequenceIndex) != chunk->m_invalid.end())
+            if (chunk->IsInvalid(sequenceIndex))
             {
                 continue;
             }
@@ -251,27 +293,52 @@ public:
             m_innerChunks[currentIndex] = drivingChunk;
         }
 
+        // Resolving the location of the sequences in the secondary deserializers.
+        // This is done by key once per corpus - the first bundling of the chunk caches
+        // the locations on the chunk description and later epochs reuse them.
+        if (!chunk->m_resolved)
+        {
+            SequenceDescription s;
+            chunk->m_secondaryLocations.resize((deserializers.size() - 1) * sequences.size());
+            for (size_t deserializerIndex = 1; deserializerIndex < deserializers.size(); ++deserializerIndex)
+            {
+                for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
+                {
+                    if (chunk->IsInvalid(sequenceIndex))
+                    {
+                        continue;
+                    }
+
+                    deserializers[deserializerIndex]->GetSequenceDescription(sequences[sequenceIndex], s);
+                    auto& location = chunk->m_secondaryLocations[sequenceIndex * (deserializers.size() - 1) + deserializerIndex - 1];
+                    location.m_chunkId = s.m_chunkId;
+                    location.m_id = s.m_id;
+                    location.m_numberOfSamples = s.m_numberOfSamples;
+                }
+            }
+            chunk->m_resolved = true;
+        }
+
         // Creating sequence mapping and requiring underlying chunks.
-        SequenceDescription s;
         for (size_t deserializerIndex = 1; deserializerIndex < deserializers.size(); ++deserializerIndex)
         {
             auto& chunkTable = m_parent->m_weakChunkTable[deserializerIndex];
             for (size_t sequenceIndex = 0; sequenceIndex < sequences.size(); ++sequenceIndex)
             {
-                if (chunk->m_invalid.find(sequenceIndex) != chunk->m_invalid.end())
+                if (chunk->IsInvalid(sequenceIndex))
                 {
                     continue;
                 }
 
                 size_t currentIndex = sequenceIndex * deserializers.size() + deserializerIndex;
-                deserializers[deserializerIndex]->GetSequenceDescription(sequences[sequenceIndex], s);
-                m_sequenceToSequence[currentIndex] = s.m_id;
+                const auto& location = chunk->m_secondaryLocations[sequenceIndex * (deserializers.size() - 1) + deserializerIndex - 1];
+                m_sequenceToSequence[currentIndex] = location.m_id;
 
-                ChunkPtr secondaryChunk = chunkTable[s.m_chunkId].lock();
+                ChunkPtr secondaryChunk = chunkTable[location.m_chunkId].lock();
                 if (!secondaryChunk)
                 {
-                    secondaryChunk = deserializers[deserializerIndex]->GetChunk(s.m_chunkId);
-                    chunkTable[s.m_chunkId] = secondaryChunk;
+                    secondaryChunk = deserializers[deserializerIndex]->GetChunk(location.m_chunkId);
+                    chunkTable[location.m_chunkId] = secondaryChunk;
                 }
 
                 m_innerChunks[currentIndex] = secondaryChunk;
@@ -6,6 +6,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "ChunkCache.h"
+#include "ReaderUtil.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -14,13 +15,63 @@ ChunkPtr ChunkCache::GetChunk(ChunkIdType chunkId)
     auto it = m_chunkMap.find(chunkId);
     if (it != m_chunkMap.end())
     {
-        return it->second;
+        // Move to the front of the LRU list.
+        m_lru.splice(m_lru.begin(), m_lru, it->second.m_lruPosition);
+        return it->second.m_chunk;
     }
- 
+
     ChunkPtr chunk = m_deserializer->GetChunk(chunkId);
-    m_chunkMap[chunkId] = chunk;
- 
+
+    CacheEntry entry;
+    entry.m_chunk = chunk;
+    entry.m_bytes = (m_cacheBudgetBytes != 0) ? EstimateChunkBytes(chunkId) : 0;
+    m_lru.push_front(chunkId);
+    entry.m_lruPosition = m_lru.begin();
+    m_chunkMap[chunkId] = entry;
+    m_cachedBytes += entry.m_bytes;
+
+    EvictIfNeeded();
+
     return chunk;
 }
 
+size_t ChunkCache::EstimateChunkBytes(ChunkIdType chunkId)
+{
+    if (m_chunkSampleCounts.empty())
+    {
+        for (const auto& chunkDescription : m_deserializer->GetChunkDescriptions())
+            m_chunkSampleCounts[chunkDescription->m_id] = chunkDescription->m_numberOfSamples;
+    }
+
+    if (m_bytesPerSample == 0)
+    {
+        for (const auto& stream : m_deserializer->GetStreamDescriptions())
+        {
+            // Sparse streams and streams without a fixed sample layout are estimated at
+            // their dense size, so the estimate is an upper bound.
+            size_t elementsPerSample = (stream->m_sampleLayout != nullptr) ? stream->m_sampleLayout->GetNumElements() : 1;
+            m_bytesPerSample += elementsPerSample * GetSizeByType(stream->m_elementType);
+        }
+    }
+
+    auto count = m_chunkSampleCounts.find(chunkId);
+    return (count != m_chunkSampleCounts.end()) ? count->second * m_bytesPerSample : 0;
+}
+
+void ChunkCache::EvictIfNeeded()
+{
+    if (m_cacheBudgetBytes == 0)
+        return;
+
+    // Never evict the most recently used chunk, even if it alone exceeds the budget.
+    while (m_cachedBytes > m_cacheBudgetBytes && m_lru.size() > 1)
+    {
+        ChunkIdType victim = m_lru.back();
+        auto it = m_chunkMap.find(victim);
+        m_cachedBytes -= it->second.m_bytes;
+        m_chunkMap.erase(it);
+        m_lru.pop_back();
+    }
+}
+
 } } }
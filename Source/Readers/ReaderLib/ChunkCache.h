@@ -6,21 +6,31 @@
 #pragma once
 
 #include <map>
+#include <list>
 #include "DataDeserializer.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-// A cache to store the complete dataset (all chunks) in memory. The caching can
-// be switched on/off by a boolean flag in the reader config section, independent 
-// of the randomization and chunking parameters. The caching should only be enabled 
-// when the whole dataset fits in memory.
+// A cache to store dataset chunks in memory. The caching can be switched on/off
+// by a boolean flag in the reader config section, independent of the randomization
+// and chunking parameters.
 // Implemented as a wrapping proxy around a deserializer that stores pointers to
-// all chunks it sees in an internal map.
+// the chunks it sees in an internal map.
+// By default (budget of 0) every chunk ever seen stays cached, which should only
+// be enabled when the whole dataset fits in memory. With a non-zero byte budget,
+// the least-recently-used chunks are dropped from the cache once its estimated
+// size exceeds the budget; chunks still referenced elsewhere (e.g. by the
+// randomizer) stay alive through their shared pointers and merely lose their
+// cache entry. Chunk payloads are opaque to the cache, so sizes are estimated
+// from the chunk's sample count and the streams' sample layouts (sparse streams
+// are estimated at their dense size, an upper bound).
 class ChunkCache : public IDataDeserializer
 {
 public:
 
-    ChunkCache(IDataDeserializerPtr deserializer) : m_deserializer(deserializer) { }
+    ChunkCache(IDataDeserializerPtr deserializer, size_t cacheBudgetBytes = 0)
+        : m_deserializer(deserializer), m_cacheBudgetBytes(cacheBudgetBytes), m_cachedBytes(0), m_bytesPerSample(0)
+    { }
 
     virtual std::vector<StreamDescriptionPtr> GetStreamDescriptions() const override
     {
@@ -46,8 +56,32 @@ public:
     virtual ChunkPtr GetChunk(ChunkIdType chunkId);
 
 private:
+    // Estimates the in-memory size of the chunk with the given id.
+    size_t EstimateChunkBytes(ChunkIdType chunkId);
+
+    // Drops least-recently-used chunks until the estimated cache size fits the budget.
+    void EvictIfNeeded();
+
+    struct CacheEntry
+    {
+        ChunkPtr m_chunk;
+        size_t m_bytes;                                 // estimated size, counted against the budget
+        std::list<ChunkIdType>::iterator m_lruPosition; // position in m_lru
+    };
+
     // A map of currently loaded chunks
-    std::map<size_t, ChunkPtr> m_chunkMap;
+    std::map<size_t, CacheEntry> m_chunkMap;
+    // Cached chunk ids, most recently used first.
+    std::list<ChunkIdType> m_lru;
+    // Cache budget in bytes; 0 means unlimited (keep everything).
+    const size_t m_cacheBudgetBytes;
+    // Current estimated cache size.
+    size_t m_cachedBytes;
+    // Estimated bytes per sample across all streams, computed lazily.
+    size_t m_bytesPerSample;
+    // Per-chunk sample counts, fetched lazily from the chunk descriptions.
+    std::map<ChunkIdType, size_t> m_chunkSampleCounts;
+
     IDataDeserializerPtr m_deserializer;
 
     DISABLE_COPY_AND_MOVE(ChunkCache);
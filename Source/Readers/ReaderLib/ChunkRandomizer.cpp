@@ -6,17 +6,77 @@
 
 #include "ChunkRandomizer.h"
 #include <random>
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
 #include "RandomOrdering.h"
+#include "ReaderUtil.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-    ChunkRandomizer::ChunkRandomizer(IDataDeserializerPtr deserializer, size_t randomizationRangeInSamples) :
-        m_deserializer(deserializer), m_randomizationRangeInSamples(randomizationRangeInSamples)
+    ChunkRandomizer::ChunkRandomizer(IDataDeserializerPtr deserializer, size_t randomizationRangeInSamples,
+        int verbosity, size_t memoryBudgetInBytes, size_t prefetchDepth) :
+        m_deserializer(deserializer),
+        m_randomizationRangeInSamples(randomizationRangeInSamples),
+        m_maxRandomizationRangeInSamples(randomizationRangeInSamples),
+        m_verbosity(verbosity),
+        m_memoryBudgetInBytes(memoryBudgetInBytes),
+        m_prefetchDepth(prefetchDepth)
     {
         m_originalChunks = m_deserializer->GetChunkDescriptions();
         assert(m_originalChunks.size() < CHUNKID_MAX);
     }
 
+    // Derives the randomization range from the chunk sizes and the memory budget.
+    // The estimated chunk byte sizes tell how many chunks fit into the budget after
+    // the prefetched chunks took their share; the range is the number of samples
+    // covered by those chunks, clamped to at least two average chunks (otherwise
+    // no cross-chunk randomization happens) and at most the configured range.
+    void ChunkRandomizer::AutoTuneRandomizationRange()
+    {
+        size_t totalSamples = 0;
+        for (const auto& chunk : m_originalChunks)
+        {
+            totalSamples += chunk->m_numberOfSamples;
+        }
+
+        if (totalSamples == 0)
+            return;
+
+        // Estimate the size of a sample in bytes across all streams. For sparse streams
+        // the effective size depends on the data, a single value with its index is
+        // assumed per sample as a conservative lower bound.
+        size_t bytesPerSample = 0;
+        for (const auto& stream : m_deserializer->GetStreamDescriptions())
+        {
+            size_t elementSize = GetSizeByType(stream->m_elementType);
+            if (stream->m_storageType == StorageType::dense)
+                bytesPerSample += stream->m_sampleLayout->GetNumElements() * elementSize;
+            else
+                bytesPerSample += elementSize + sizeof(IndexType);
+        }
+
+        if (bytesPerSample == 0)
+            return;
+
+        size_t averageChunkSamples = std::max<size_t>(totalSamples / m_originalChunks.size(), 1);
+        size_t averageChunkBytes = averageChunkSamples * bytesPerSample;
+
+        // The prefetched chunks live in memory next to the randomization window.
+        size_t prefetchBytes = m_prefetchDepth * averageChunkBytes;
+        size_t windowBudget = m_memoryBudgetInBytes > prefetchBytes ? m_memoryBudgetInBytes - prefetchBytes : 0;
+
+        size_t range = windowBudget / bytesPerSample;
+        range = std::max(range, 2 * averageChunkSamples);
+        range = std::min(range, std::min(totalSamples, m_maxRandomizationRangeInSamples));
+
+        if (m_verbosity && range != m_randomizationRangeInSamples)
+            fprintf(stderr, "ChunkRandomizer::AutoTuneRandomizationRange: using randomization window of %" PRIu64 " samples "
+                "(~%" PRIu64 " chunks of ~%" PRIu64 " bytes, budget %" PRIu64 " bytes, prefetch depth %" PRIu64 ")\n",
+                range, range / averageChunkSamples, averageChunkBytes, m_memoryBudgetInBytes, m_prefetchDepth);
+
+        m_randomizationRangeInSamples = range;
+    }
+
     // Gets randomized chunks.
     const std::vector<RandomizedChunk>& ChunkRandomizer::GetRandomizedChunks() const
     {
@@ -26,6 +86,11 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     // Randomizes chunks and calculates randomization windows.
     void ChunkRandomizer::Randomize(unsigned int seed)
     {
+        if (m_memoryBudgetInBytes != 0)
+        {
+            AutoTuneRandomizationRange();
+        }
+
         std::vector<ChunkIdType> randomizedChunkIndices;
         randomizedChunkIndices.reserve(m_originalChunks.size());
         for (ChunkIdType i = 0; i < m_originalChunks.size(); i++)
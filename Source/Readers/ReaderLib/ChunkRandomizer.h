@@ -71,7 +71,11 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     class ChunkRandomizer
     {
     public:
-        ChunkRandomizer(IDataDeserializerPtr deserializer, size_t randomizationRangeInSamples);
+        // When memoryBudgetInBytes is non zero, the randomization range is derived automatically
+        // from the estimated chunk byte sizes, the budget and the prefetch depth instead of the
+        // configured randomizationRangeInSamples (which then only serves as an upper bound).
+        ChunkRandomizer(IDataDeserializerPtr deserializer, size_t randomizationRangeInSamples,
+            int verbosity = 0, size_t memoryBudgetInBytes = 0, size_t prefetchDepth = 1);
 
         // Gets randomized chunks.
         const std::vector<RandomizedChunk>& GetRandomizedChunks() const;
@@ -80,6 +84,11 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         void Randomize(unsigned int seed);
 
     private:
+        // Derives the randomization range in samples from the memory budget.
+        // Called on each sweep randomization, i.e. the range follows the corpus
+        // without users hardcoding corpus-specific window values.
+        void AutoTuneRandomizationRange();
+
         IDataDeserializerPtr m_deserializer;
         // Randomized chunks.
         std::vector<RandomizedChunk> m_randomizedChunks;
@@ -89,6 +98,18 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         // Randomization range in samples.
         size_t m_randomizationRangeInSamples;
 
+        // Upper bound for the automatically tuned range (the configured range).
+        size_t m_maxRandomizationRangeInSamples;
+
+        int m_verbosity;
+
+        // Memory budget for the in-memory randomization window, 0 disables auto tuning.
+        size_t m_memoryBudgetInBytes;
+
+        // Number of chunks the randomizer fetches ahead of use; they consume
+        // a part of the memory budget without widening the window.
+        size_t m_prefetchDepth;
+
         std::mt19937_64 m_rng;
     };
 
@@ -25,4 +25,61 @@ MBLayoutPtr FramePacker::CreateMBLayout(const StreamBatch& batch)
     return pMBLayout;
 }
 
+MBLayoutPtr FramePacker::PackDenseStream(const StreamBatch& batch, size_t streamIndex)
+{
+    const auto& stream = m_inputStreamDescriptions[streamIndex];
+    if (stream->m_storageType != StorageType::dense)
+    {
+        // Sparse input requires sparse-to-dense expansion, take the generic path.
+        return SequencePacker::PackDenseStream(batch, streamIndex);
+    }
+
+    assert(m_outputStreamDescriptions[streamIndex]->m_storageType == StorageType::dense);
+    auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
+    size_t sampleSize = GetSampleSize(m_outputStreamDescriptions[streamIndex]);
+    auto pMBLayout = CreateMBLayout(batch);
+    size_t requiredSize = pMBLayout->GetNumCols() * sampleSize;
+    if (buffer.m_size < requiredSize)
+    {
+        buffer.Resize(requiredSize);
+    }
+
+    // In frame mode column i of the minibatch is exactly frame i of the batch
+    // (CreateMBLayout verified that all sequences are single frames), so instead of
+    // copying each frame with its own tiny memcpy, gather the source pointers and copy
+    // maximal contiguous source ranges. Frames coming from the same chunk are usually
+    // adjacent in memory, so whole stretches of the minibatch collapse into one memcpy.
+    m_frameSources.resize(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        m_frameSources[i] = reinterpret_cast<const char*>(batch[i]->GetDataBuffer());
+    }
+
+    char* bufferPtr = buffer.m_data.get();
+    const size_t blockSize = 1024;
+    int numBlocks = (int)((batch.size() + blockSize - 1) / blockSize);
+
+#pragma omp parallel for schedule(static)
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        size_t begin = block * blockSize;
+        size_t end = std::min(begin + blockSize, batch.size());
+        size_t runStart = begin;
+        while (runStart < end)
+        {
+            size_t runEnd = runStart + 1;
+            while (runEnd < end && m_frameSources[runEnd] == m_frameSources[runEnd - 1] + sampleSize)
+            {
+                ++runEnd;
+            }
+
+            assert(runEnd * sampleSize <= buffer.m_size);
+            memcpy(bufferPtr + runStart * sampleSize, m_frameSources[runStart], (runEnd - runStart) * sampleSize);
+            runStart = runEnd;
+        }
+    }
+
+    return pMBLayout;
+}
+
 }}}
@@ -23,6 +23,12 @@ public:
 
 protected:
     MBLayoutPtr CreateMBLayout(const StreamBatch& batch) override;
+
+    MBLayoutPtr PackDenseStream(const StreamBatch& batch, size_t streamIndex) override;
+
+private:
+    // Gathered source frame pointers, kept as a member to reuse the allocation between minibatches.
+    std::vector<const char*> m_frameSources;
 };
 
 typedef std::shared_ptr<FramePacker> FramePackerPtr;
@@ -6,7 +6,12 @@
 #define __STDC_FORMAT_MACROS
 #define _CRT_SECURE_NO_WARNINGS
 #include <inttypes.h>
+#include <algorithm>
+#include <thread>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include "Indexer.h"
+#include "fileutil.h"
 
 using std::string;
 
@@ -14,7 +19,38 @@ const static char ROW_DELIMITER = '\n';
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-Indexer::Indexer(FILE* file, bool isPrimary, bool skipSequenceIds, char streamPrefix, size_t chunkSize, size_t bufferSize) :
+// Header of the on-disk index cache. The cache is invalidated whenever the
+// size or the modification time of the input file changes.
+struct IndexCacheHeader
+{
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_hasSequenceIds;
+    int64_t m_fileSize;
+    int64_t m_fileTime;
+    uint64_t m_numRecords;
+};
+
+const static uint64_t INDEX_CACHE_MAGIC = 0x78644978465443ULL; // "CTFxIdx"
+const static uint32_t INDEX_CACHE_VERSION = 1;
+
+// Returns the modification time of an open file (0, if it cannot be retrieved).
+static int64_t GetFileTime(FILE* file)
+{
+#ifdef _MSC_VER
+    struct _stat64 s;
+    if (_fstat64(_fileno(file), &s) != 0)
+        return 0;
+#else
+    struct stat s;
+    if (fstat(fileno(file), &s) != 0)
+        return 0;
+#endif
+    return (int64_t)s.st_mtime;
+}
+
+Indexer::Indexer(FILE* file, bool isPrimary, bool skipSequenceIds, char streamPrefix, size_t chunkSize, size_t bufferSize,
+                 const std::wstring& fileName, size_t numIndexingThreads, bool cacheIndex) :
     m_streamPrefix(streamPrefix),
     m_bufferSize(bufferSize),
     m_file(file),
@@ -26,7 +62,11 @@ Indexer::Indexer(FILE* file, bool isPrimary, bool skipSequenceIds, char streamPr
     m_pos(nullptr),
     m_done(false),
     m_hasSequenceIds(!skipSequenceIds),
-    m_index(chunkSize, isPrimary)
+    m_index(chunkSize, isPrimary),
+    m_fileName(fileName),
+    m_numIndexingThreads(std::max<size_t>(numIndexingThreads, 1)),
+    m_cacheIndex(cacheIndex),
+    m_capturingForCache(false)
 {
     if (m_file == nullptr)
     {
@@ -101,7 +141,15 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
         return;
     }
 
-    m_index.Reserve(filesize(m_file));
+    int64_t fileSize = (int64_t)filesize(m_file);
+    m_index.Reserve(fileSize);
+
+    if (m_cacheIndex && !m_fileName.empty() && TryLoadCachedIndex(corpus, fileSize))
+    {
+        return;
+    }
+
+    m_capturingForCache = m_cacheIndex && !m_fileName.empty();
 
     RefillBuffer(); // read the first block of data
     if (m_done)
@@ -109,6 +157,7 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
         RuntimeError("Input file is empty");
     }
 
+    int64_t dataOffset = 0;
     if ((m_bufferEnd - m_bufferStart > 3) &&
         (m_bufferStart[0] == '\xEF' && m_bufferStart[1] == '\xBB' && m_bufferStart[2] == '\xBF'))
     {
@@ -116,53 +165,344 @@ void Indexer::Build(CorpusDescriptorPtr corpus)
         m_pos += 3;
         m_fileOffsetStart += 3;
         m_bufferStart += 3;
+        dataOffset = 3;
     }
 
     // check the first byte and decide what to do next
-    if (!m_hasSequenceIds || m_bufferStart[0] == m_streamPrefix)
+    bool fromLines = (!m_hasSequenceIds || m_bufferStart[0] == m_streamPrefix);
+
+    // Scan ranges in parallel when a file name and more than one indexing thread were
+    // provided and the file is big enough for the partitioning to pay off.
+    if (m_numIndexingThreads > 1 && !m_fileName.empty() &&
+        fileSize >= (int64_t)(m_numIndexingThreads * m_bufferSize))
+    {
+        BuildParallel(corpus, fromLines, dataOffset, fileSize);
+    }
+    else if (fromLines)
     {
         // skip sequence id parsing, treat lines as individual sequences
         BuildFromLines(corpus);
+    }
+    else
+    {
+        size_t id = 0;
+        int64_t offset = GetFileOffset();
+        // read the very first sequence id
+        if (!TryGetSequenceId(id))
+        {
+            RuntimeError("Expected a sequence id at the offset %" PRIi64 ", none was found.", offset);
+        }
+
+        SequenceDescriptor sd = {};
+        sd.m_fileOffsetBytes = offset;
+
+        size_t currentKey = id;
+        while (!m_done)
+        {
+            SkipLine(); // ignore whatever is left on this line.
+            offset = GetFileOffset(); // a new line starts at this offset;
+            sd.m_numberOfSamples++;
+
+            if (!m_done && TryGetSequenceId(id) && id != currentKey)
+            {
+                // found a new sequence, which starts at the [offset] bytes into the file
+                sd.m_byteSize = offset - sd.m_fileOffsetBytes;
+                AddSequenceIfIncluded(corpus, currentKey, sd);
+
+                sd = {};
+                sd.m_fileOffsetBytes = offset;
+                currentKey = id;
+            }
+        }
+
+        // calculate the byte size for the last sequence
+        sd.m_byteSize = m_fileOffsetEnd - sd.m_fileOffsetBytes;
+        AddSequenceIfIncluded(corpus, currentKey, sd);
+    }
+
+    if (m_capturingForCache)
+    {
+        SaveCachedIndex(fileSize);
+        m_capturingForCache = false;
+        m_rawRecords.clear();
+        m_rawRecords.shrink_to_fit();
+    }
+}
+
+void Indexer::BuildParallel(CorpusDescriptorPtr corpus, bool fromLines, int64_t dataOffset, int64_t fileSize)
+{
+    if (fromLines)
+        m_hasSequenceIds = false;
+
+    size_t numRanges = m_numIndexingThreads;
+    int64_t rangeSize = (fileSize - dataOffset + numRanges - 1) / numRanges;
+
+    std::vector<std::vector<LineRecord>> rangeRecords(numRanges);
+    std::vector<std::exception_ptr> exceptions(numRanges);
+    std::vector<std::thread> threads;
+    threads.reserve(numRanges);
+    for (size_t i = 0; i < numRanges; ++i)
+    {
+        int64_t rangeBegin = dataOffset + i * rangeSize;
+        int64_t rangeEnd = std::min<int64_t>(rangeBegin + rangeSize, fileSize);
+        threads.emplace_back([this, rangeBegin, rangeEnd, dataOffset, fileSize, &rangeRecords, &exceptions, i]()
+        {
+            try
+            {
+                ScanRange(rangeBegin, rangeEnd, dataOffset, fileSize, rangeRecords[i]);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& exception : exceptions)
+        if (exception != nullptr)
+            std::rethrow_exception(exception);
+
+    size_t totalLines = 0;
+    for (const auto& records : rangeRecords)
+        totalLines += records.size();
+
+    std::vector<LineRecord> records;
+    records.reserve(totalLines);
+    for (auto& range : rangeRecords)
+    {
+        records.insert(records.end(), range.begin(), range.end());
+        range.clear();
+        range.shrink_to_fit();
+    }
+
+    MergeLineRecords(corpus, fromLines, records, fileSize);
+
+    // The main-thread buffer was only used to check for a BOM and the stream prefix;
+    // the parallel scan consumed the file on its own handles.
+    m_done = true;
+    m_fileOffsetEnd = fileSize;
+}
+
+void Indexer::ScanRange(int64_t rangeBegin, int64_t rangeEnd, int64_t dataOffset, int64_t fileSize, std::vector<LineRecord>& records) const
+{
+    FILE* file = fopenOrDie(m_fileName, L"rbS");
+    std::unique_ptr<FILE, int (*)(FILE*)> fileGuard(file, fclose);
+    std::unique_ptr<char[]> buffer(new char[m_bufferSize]);
+
+    // A line starts either at the very beginning of the data (first range only) or right
+    // after a newline. Ranges other than the first start scanning one byte early, so that
+    // a newline at the range boundary is attributed correctly.
+    bool parsingId = (rangeBegin == dataOffset);
+    int64_t scanOffset = parsingId ? rangeBegin : rangeBegin - 1;
+    if (_fseeki64(file, scanOffset, SEEK_SET) != 0)
+        RuntimeError("Error seeking to the offset %" PRIi64 " in the input file (%ls).", scanOffset, m_fileName.c_str());
+
+    LineRecord line = { scanOffset, 0, false };
+    bool foundDigit = false;
+
+    while (true)
+    {
+        size_t bytesRead = fread(buffer.get(), 1, m_bufferSize, file);
+        if (ferror(file) != 0)
+            RuntimeError("Could not read from the input file (%ls).", m_fileName.c_str());
+        if (bytesRead == 0)
+            break;
+
+        const char* bufferStart = buffer.get();
+        const char* bufferEnd = bufferStart + bytesRead;
+        const char* pos = bufferStart;
+        while (pos != bufferEnd)
+        {
+            if (parsingId)
+            {
+                char c = *pos;
+                if (isdigit(c))
+                {
+                    foundDigit = true;
+                    line.m_id = line.m_id * 10 + (c - '0');
+                    ++pos;
+                    continue;
+                }
+                // Stop as soon as there's a non-digit character.
+                line.m_hasId = foundDigit;
+                records.push_back(line);
+                parsingId = false;
+            }
+
+            pos = (char*)memchr(pos, ROW_DELIMITER, bufferEnd - pos);
+            if (pos == nullptr)
+                break;
+
+            int64_t nextLineStart = scanOffset + (pos - bufferStart) + 1;
+            if (nextLineStart >= rangeEnd || nextLineStart >= fileSize)
+                return; // the next line belongs to the following range (or there is none)
+
+            line = { nextLineStart, 0, false };
+            foundDigit = false;
+            parsingId = true;
+            ++pos;
+        }
+
+        scanOffset += bytesRead;
+    }
+
+    // Reached EOF while still parsing the id: matching the sequential pass, the line
+    // is recorded without an id (the parser will have to deal with it).
+    if (parsingId)
+    {
+        line.m_hasId = false;
+        records.push_back(line);
+    }
+}
+
+void Indexer::MergeLineRecords(CorpusDescriptorPtr corpus, bool fromLines, const std::vector<LineRecord>& records, int64_t fileSize)
+{
+    if (records.empty())
+        return;
+
+    if (fromLines)
+    {
+        // each line is an individual sequence, its id is the line number
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            SequenceDescriptor sd = {};
+            sd.m_numberOfSamples = 1;
+            sd.m_fileOffsetBytes = records[i].m_offset;
+            int64_t next = (i + 1 < records.size()) ? records[i + 1].m_offset : fileSize;
+            sd.m_byteSize = next - sd.m_fileOffsetBytes;
+            AddSequenceIfIncluded(corpus, i, sd);
+        }
         return;
     }
 
-    size_t id = 0;
-    int64_t offset = GetFileOffset();
-    // read the very first sequence id
-    if (!TryGetSequenceId(id))
+    if (!records.front().m_hasId)
     {
-        RuntimeError("Expected a sequence id at the offset %" PRIi64 ", none was found.", offset);
+        RuntimeError("Expected a sequence id at the offset %" PRIi64 ", none was found.", records.front().m_offset);
     }
 
+    // group consecutive lines by their sequence id (lines without an id
+    // continue the current sequence, same as in the sequential pass)
     SequenceDescriptor sd = {};
-    sd.m_fileOffsetBytes = offset;
-
-    size_t currentKey = id;
-    while (!m_done)
+    sd.m_fileOffsetBytes = records.front().m_offset;
+    size_t currentKey = records.front().m_id;
+    for (size_t i = 0; i < records.size(); ++i)
     {
-        SkipLine(); // ignore whatever is left on this line.
-        offset = GetFileOffset(); // a new line starts at this offset;
         sd.m_numberOfSamples++;
 
-        if (!m_done && TryGetSequenceId(id) && id != currentKey)
+        bool last = (i + 1 == records.size());
+        if (!last && records[i + 1].m_hasId && records[i + 1].m_id != currentKey)
         {
-            // found a new sequence, which starts at the [offset] bytes into the file
-            sd.m_byteSize = offset - sd.m_fileOffsetBytes;
+            sd.m_byteSize = records[i + 1].m_offset - sd.m_fileOffsetBytes;
             AddSequenceIfIncluded(corpus, currentKey, sd);
 
             sd = {};
-            sd.m_fileOffsetBytes = offset;
-            currentKey = id;
+            sd.m_fileOffsetBytes = records[i + 1].m_offset;
+            currentKey = records[i + 1].m_id;
         }
     }
 
     // calculate the byte size for the last sequence
-    sd.m_byteSize = m_fileOffsetEnd - sd.m_fileOffsetBytes;
+    sd.m_byteSize = fileSize - sd.m_fileOffsetBytes;
     AddSequenceIfIncluded(corpus, currentKey, sd);
 }
 
+bool Indexer::TryLoadCachedIndex(CorpusDescriptorPtr corpus, int64_t fileSize)
+{
+    std::wstring cachePath = GetCacheFilePath();
+    if (!fexists(cachePath))
+        return false;
+
+    try
+    {
+        FILE* cache = fopenOrDie(cachePath, L"rbS");
+        std::unique_ptr<FILE, int (*)(FILE*)> cacheGuard(cache, fclose);
+
+        IndexCacheHeader header = {};
+        if (fread(&header, sizeof(header), 1, cache) != 1 ||
+            header.m_magic != INDEX_CACHE_MAGIC ||
+            header.m_version != INDEX_CACHE_VERSION ||
+            header.m_fileSize != fileSize ||
+            header.m_fileTime != GetFileTime(m_file))
+        {
+            return false; // stale or foreign cache, rebuild the index
+        }
+
+        // read all records upfront, so that a truncated cache cannot leave
+        // the index half-populated
+        std::vector<SequenceRecord> records(header.m_numRecords);
+        if (!records.empty() &&
+            fread(records.data(), sizeof(SequenceRecord), records.size(), cache) != records.size())
+        {
+            return false;
+        }
+
+        m_hasSequenceIds = (header.m_hasSequenceIds != 0);
+
+        // replay the records through the regular code path, re-applying
+        // the corpus filter and the chunking parameters
+        for (auto& record : records)
+        {
+            SequenceDescriptor sd = {};
+            sd.m_numberOfSamples = (uint32_t)record.m_numberOfSamples;
+            sd.m_fileOffsetBytes = record.m_fileOffsetBytes;
+            sd.m_byteSize = (size_t)record.m_byteSize;
+            AddSequenceIfIncluded(corpus, (size_t)record.m_key, sd);
+        }
+
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "WARNING: could not read the index cache file (%ls): %s. Rebuilding the index.\n",
+                cachePath.c_str(), e.what());
+        return false;
+    }
+}
+
+void Indexer::SaveCachedIndex(int64_t fileSize)
+{
+    std::wstring cachePath = GetCacheFilePath();
+    std::wstring tempPath = cachePath + L".tmp";
+    try
+    {
+        IndexCacheHeader header = {};
+        header.m_magic = INDEX_CACHE_MAGIC;
+        header.m_version = INDEX_CACHE_VERSION;
+        header.m_hasSequenceIds = m_hasSequenceIds ? 1 : 0;
+        header.m_fileSize = fileSize;
+        header.m_fileTime = GetFileTime(m_file);
+        header.m_numRecords = m_rawRecords.size();
+
+        FILE* cache = fopenOrDie(tempPath, L"wbS");
+        {
+            std::unique_ptr<FILE, int (*)(FILE*)> cacheGuard(cache, fclose);
+            fwriteOrDie(&header, sizeof(header), 1, cache);
+            if (!m_rawRecords.empty())
+                fwriteOrDie(m_rawRecords.data(), sizeof(SequenceRecord), m_rawRecords.size(), cache);
+        }
+
+        _wunlink(cachePath.c_str());
+        renameOrDie(tempPath, cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        // the cache is an optimization only, so a failure to write it must not fail the build
+        fprintf(stderr, "WARNING: could not write the index cache file (%ls): %s\n",
+                cachePath.c_str(), e.what());
+    }
+}
+
 void Indexer::AddSequenceIfIncluded(CorpusDescriptorPtr corpus, size_t sequenceId, SequenceDescriptor& sd)
 {
+    if (m_capturingForCache)
+    {
+        SequenceRecord record = { sequenceId, sd.m_numberOfSamples, sd.m_fileOffsetBytes, sd.m_byteSize };
+        m_rawRecords.push_back(record);
+    }
+
     auto key = std::to_string(sequenceId);
     if (corpus->IsIncluded(key))
     {
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <string>
 #include "DataDeserializer.h"
 #include "CorpusDescriptor.h"
 
@@ -115,14 +116,22 @@ struct Index
 };
 
 // A helper class that does a pass over the input file building up
-// an index consisting of sequence and chunk descriptors (which among 
+// an index consisting of sequence and chunk descriptors (which among
 // others specify size and file offset of the respective structure).
-// As opposed to the data deserializer, indexer performs almost no parsing 
+// As opposed to the data deserializer, indexer performs almost no parsing
 // and therefore is several magnitudes faster.
+// When a file name and a thread count > 1 are provided, the input is split
+// into byte ranges that are scanned for sequence boundaries in parallel
+// (each worker on its own file handle) and the per-range results are merged
+// in order. Optionally, the resulting index can be cached in a file next to
+// the input (keyed by the input's size and modification time), so that
+// subsequent runs skip the indexing pass completely.
 class Indexer
 {
 public:
-    Indexer(FILE* file, bool isPrimary, bool skipSequenceIds = false, char streamPrefix = '|', size_t chunkSize = 32 * 1024 * 1024, size_t bufferSize = 2 * 1024 * 1024);
+    Indexer(FILE* file, bool isPrimary, bool skipSequenceIds = false, char streamPrefix = '|',
+            size_t chunkSize = 32 * 1024 * 1024, size_t bufferSize = 2 * 1024 * 1024,
+            const std::wstring& fileName = L"", size_t numIndexingThreads = 1, bool cacheIndex = false);
 
     // Reads the input file, building and index of chunks and corresponding
     // sequences.
@@ -158,6 +167,53 @@ private:
 
     const char m_streamPrefix;
 
+    const std::wstring m_fileName;      // input file name; required for parallel indexing and index caching
+    const size_t m_numIndexingThreads;  // number of byte ranges scanned in parallel (1 = sequential)
+    const bool m_cacheIndex;            // if true, the index is persisted next to the input file
+
+    // Raw line metadata produced by the parallel range scan, one entry per line.
+    struct LineRecord
+    {
+        int64_t m_offset;   // file offset of the line start (in bytes)
+        size_t m_id;        // sequence id parsed from the beginning of the line
+        bool m_hasId;       // false, if the line does not start with a numerical sequence id
+    };
+
+    // Raw sequence metadata captured before corpus filtering; this is what gets
+    // persisted in the index cache, so that the corpus filter and the chunking
+    // parameters can be re-applied when the cache is loaded.
+    struct SequenceRecord
+    {
+        uint64_t m_key;
+        uint64_t m_numberOfSamples;
+        int64_t m_fileOffsetBytes;
+        uint64_t m_byteSize;
+    };
+
+    std::vector<SequenceRecord> m_rawRecords; // filled during the build when caching is enabled
+    bool m_capturingForCache;                 // true while building with caching enabled
+
+    // Scans the byte range [rangeBegin, rangeEnd) for line starts on a private file handle,
+    // appending one record per line that starts inside the range.
+    void ScanRange(int64_t rangeBegin, int64_t rangeEnd, int64_t dataOffset, int64_t fileSize, std::vector<LineRecord>& records) const;
+
+    // Builds the index by scanning byte ranges in parallel and merging the per-line
+    // records into sequence descriptors.
+    void BuildParallel(CorpusDescriptorPtr corpus, bool fromLines, int64_t dataOffset, int64_t fileSize);
+
+    // Turns an ordered collection of per-line records into sequence descriptors,
+    // replicating the grouping behavior of the sequential pass.
+    void MergeLineRecords(CorpusDescriptorPtr corpus, bool fromLines, const std::vector<LineRecord>& records, int64_t fileSize);
+
+    // Loads a previously cached index, if a valid one exists for the current input file.
+    bool TryLoadCachedIndex(CorpusDescriptorPtr corpus, int64_t fileSize);
+
+    // Persists the raw sequence records for the current input file (best effort).
+    void SaveCachedIndex(int64_t fileSize);
+
+    // Full path of the index cache file for the current input.
+    std::wstring GetCacheFilePath() const { return m_fileName + L".index.cache"; }
+
     // Same function as above but with check that the sequence is included in the corpus descriptor.
     void AddSequenceIfIncluded(CorpusDescriptorPtr corpus, size_t sequenceKey, SequenceDescriptor& sd);
 
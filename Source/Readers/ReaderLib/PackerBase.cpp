@@ -19,13 +19,25 @@ using namespace std;
 // Resizing the buffer with the current memory provider.
 void PackerBase::StreamBuffer::Resize(size_t newSize)
 {
-    m_size = newSize;
+    if (newSize <= m_capacity)
+    {
+        // The allocation is already big enough, no need to go to the memory provider.
+        m_size = newSize;
+        return;
+    }
+
+    // Grow at least by a factor of two, so that a sequence of minibatches of slowly
+    // increasing size does not trigger a reallocation (for pinned memory - an expensive,
+    // device-synchronizing one) on every single call.
+    size_t newCapacity = std::max(newSize, m_capacity * 2);
     auto provider = m_memoryProvider;
-    m_data.reset(reinterpret_cast<char*>(provider->Alloc(1, newSize)),
+    m_data.reset(reinterpret_cast<char*>(provider->Alloc(1, newCapacity)),
         [provider](char* p)
     {
         provider->Free(p);
     });
+    m_size = newSize;
+    m_capacity = newCapacity;
 }
 
 void PackerBase::SetConfiguration(const ReaderConfiguration& config, const std::vector<MemoryProviderPtr>& memoryProviders)
@@ -19,15 +19,20 @@ protected:
 
     struct StreamBuffer
     {
-        size_t m_size; // buffer size in bytes.
+        size_t m_size;     // buffer size in bytes.
+        size_t m_capacity; // allocated size in bytes (>= m_size).
         MemoryProviderPtr m_memoryProvider;
         std::shared_ptr<char> m_data; // contiguous array of data.
 
         StreamBuffer(MemoryProviderPtr m_memoryProvider) :
-            m_size(0), m_memoryProvider(m_memoryProvider), m_data(nullptr)
+            m_size(0), m_capacity(0), m_memoryProvider(m_memoryProvider), m_data(nullptr)
         {
         }
 
+        // Resizes the buffer, reallocating only when the new size exceeds the current
+        // capacity. Growing is done with slack, since for GPU-destined streams the
+        // memory provider hands out page-locked memory and each reallocation is an
+        // expensive, device-synchronizing operation.
         void Resize(size_t newSize);
     };
 
@@ -19,6 +19,7 @@
 #include "ReaderShim.h"
 #include "DataTransferer.h"
 #include "PerformanceProfiler.h"
+#include "ReaderTelemetry.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -26,7 +27,8 @@ template <class ElemType>
 ReaderShim<ElemType>::ReaderShim() :
     m_deviceId(CPUDEVICE),
     m_dataTransferers(2, DataTransfererPtr()),
-    m_currentDataTransferIndex(0),
+    m_prefetchBuffers(2),
+    m_numPrefetchBuffers(2),
     m_endOfEpoch(false),
     m_currentSamplePosition(0),
     m_reader(nullptr),
@@ -59,6 +61,20 @@ void ReaderShim<ElemType>::Init(const ConfigParameters& config)
     // otherwise deferring - synchronous execution during .get() call
     m_launchType = prefetch ? launch::async : launch::deferred;
 
+    // Number of reads that can be in flight ahead of the network. The reads are still issued
+    // one after another, but a deeper ring smooths out minibatches whose read or copy takes
+    // longer than the compute. The composite reader sizes its alternating packing buffers
+    // from the same config key so the two stay in step, see CompositeDataReader.
+    m_numPrefetchBuffers = config(L"numPrefetchBuffers", (size_t)2);
+    if (m_numPrefetchBuffers < 2)
+        InvalidArgument("numPrefetchBuffers must be at least 2.");
+
+    // Periodic one-line reader stall summary in the log, every this many minibatches (0 disables).
+    ReaderPipelineTelemetry::Instance().SetSummaryInterval(config(L"stallSummaryInterval", (size_t)1000));
+
+    m_dataTransferers.resize(m_numPrefetchBuffers);
+    m_prefetchBuffers.resize(m_numPrefetchBuffers);
+
     m_numParallelSequences = numberOfuttsPerMinibatchForAllEpochs[0];
 
     if (!m_reader)
@@ -99,71 +115,35 @@ void ReaderShim<ElemType>::StartDistributedMinibatchLoop(
 template <class ElemType>
 void ReaderShim<ElemType>::SetCurrentSamplePosition(size_t currentSamplePosition)
 {
-    // Make sure there are no outstanding reads.
-    if (m_prefetchTask.valid())
-        m_prefetchTask.wait();
-
-    // Let's check that there is no outstanding copies.
-    // Wait on all events if there are any pending copy operations in flight.
-    if (m_dataTransferers[m_currentDataTransferIndex])
-        m_dataTransferers[m_currentDataTransferIndex]->WaitForCopyCPUToGPU();
+    // Make sure there are no outstanding reads or copies.
+    WaitForOutstandingPrefetches();
 
     // Set current position.
     m_reader->SetCurrentSamplePosition(currentSamplePosition);
     m_currentSamplePosition = m_reader->GetCurrentSamplePosition();
 
     // Start prefetch.
-    auto localCurrentDataTransferIndex = m_currentDataTransferIndex;
-    // Starting the prefetch task. There is always a single async read in flight.
-    // When the network requests a new minibatch, we wait for the current async to finish, swap the buffers
-    // and kick off the new prefetch.
-    m_prefetchTask = std::async(m_launchType,
-        [this, localCurrentDataTransferIndex]()
-    {
-        return PrefetchMinibatch(localCurrentDataTransferIndex);
-    });
+    RestartPrefetch();
 }
 
 template <class ElemType>
 void ReaderShim<ElemType>::SetConfiguration(const ReaderConfiguration& config, const std::map<std::wstring, int>& inputDescriptions)
 {
-    // Make sure there are no outstanding reads.
-    if (m_prefetchTask.valid())
-        m_prefetchTask.wait();
-
-    // Let's check that there is no outstanding copies.
-    // Wait on all events if there are any pending copy operations in flight.
-    if (m_dataTransferers[m_currentDataTransferIndex])
-        m_dataTransferers[m_currentDataTransferIndex]->WaitForCopyCPUToGPU();
+    // Make sure there are no outstanding reads or copies.
+    WaitForOutstandingPrefetches();
 
     m_reader->SetConfiguration(config, inputDescriptions);
     m_reader->SetCurrentSamplePosition(m_currentSamplePosition);
 
     // Start prefetch.
-    auto localCurrentDataTransferIndex = m_currentDataTransferIndex;
-    // Starting the prefetch task. There is always a single async read in flight.
-    // When the network requests a new minibatch, we wait for the current async to finish, swap the buffers
-    // and kick off the new prefetch.
-    m_prefetchTask = std::async(m_launchType,
-        [this, localCurrentDataTransferIndex]()
-    {
-        return PrefetchMinibatch(localCurrentDataTransferIndex);
-    });
+    RestartPrefetch();
 }
 
 template <class ElemType>
 void ReaderShim<ElemType>::StartEpoch(const EpochConfiguration& config, const std::unordered_set<InputStreamDescription>& inputs)
 {
-    // For adaptive minibatch, make sure there are no outstanding reads.
-    if (m_prefetchTask.valid())
-    {
-        m_prefetchTask.wait();
-    }
-
-    // Let's check that there is no outstanding copies.
-    // Wait on all events if there are any pending copy operations in flight.
-    if (m_dataTransferers[m_currentDataTransferIndex])
-        m_dataTransferers[m_currentDataTransferIndex]->WaitForCopyCPUToGPU();
+    // For adaptive minibatch, make sure there are no outstanding reads or copies.
+    WaitForOutstandingPrefetches();
 
     // Now we can be sure, no prefetch thread is running and there are no outstanding memcopies.
     // Let's check that requested devices are ok and see whether we need to change our data transferers.
@@ -184,37 +164,80 @@ void ReaderShim<ElemType>::StartEpoch(const EpochConfiguration& config, const st
         // Device changed. Let's change the data transferers.
         m_deviceId = deviceId;
         m_dataTransferers.clear();
-        // We need two in order to support two operations in flight.
-        m_dataTransferers.push_back(m_deviceId == CPUDEVICE ? nullptr : CreatePrefetchDataTransferer(m_deviceId));
-        m_dataTransferers.push_back(m_deviceId == CPUDEVICE ? nullptr : CreatePrefetchDataTransferer(m_deviceId));
+        // We need one per prefetch buffer in order to support that many operations in flight.
+        for (size_t i = 0; i < m_numPrefetchBuffers; ++i)
+            m_dataTransferers.push_back(m_deviceId == CPUDEVICE ? nullptr : CreatePrefetchDataTransferer(m_deviceId));
     }
 
-    // Let's create the buffers for the prefetch thread.
+    // Let's create the buffers for the prefetch tasks, one set per in-flight read.
     std::map<std::wstring, int> inputDescriptions;
     for (const auto& i : inputs)
     {
         inputDescriptions[i.GetStreamName()] = i.GetDeviceId();
         // Creating buffers with the same properties the network expects.
-        m_prefetchBuffers[i.GetStreamName()] = StreamPrefetchBuffer
+        for (size_t index = 0; index < m_numPrefetchBuffers; ++index)
         {
-            std::make_shared<Matrix<ElemType>>(0, 0, i.GetDeviceId(), i.GetMatrixType(), i.GetMatrixFormat()),
-            std::make_shared<MBLayout>()
-        };
+            m_prefetchBuffers[index][i.GetStreamName()] = StreamPrefetchBuffer
+            {
+                std::make_shared<Matrix<ElemType>>(0, 0, i.GetDeviceId(), i.GetMatrixType(), i.GetMatrixFormat()),
+                std::make_shared<MBLayout>()
+            };
+        }
     }
 
     m_endOfEpoch = false;
     m_reader->StartEpoch(config, inputDescriptions);
     m_currentSamplePosition = m_reader->GetCurrentSamplePosition();
 
-    auto localCurrentDataTransferIndex = m_currentDataTransferIndex;
-    // Starting the prefetch task. There is always a single async read in flight.
-    // When the network requests a new minibatch, we wait for the current async to finish, swap the buffers
-    // and kick off the new prefetch.
-    m_prefetchTask = std::async(m_launchType,
-    [this, localCurrentDataTransferIndex]()
+    RestartPrefetch();
+}
+
+template <class ElemType>
+void ReaderShim<ElemType>::WaitForOutstandingPrefetches()
+{
+    // The tasks are chained, so waiting on the last one waits for all of them.
+    if (!m_prefetchTasks.empty())
+        m_prefetchTasks.back().m_result.wait();
+    m_prefetchTasks.clear();
+
+    // Let's check that there are no outstanding copies.
+    // Wait on all events if there are any pending copy operations in flight.
+    for (const auto& transferer : m_dataTransferers)
     {
-        return PrefetchMinibatch(localCurrentDataTransferIndex);
+        if (transferer)
+            transferer->WaitForCopyCPUToGPU();
+    }
+}
+
+template <class ElemType>
+void ReaderShim<ElemType>::LaunchPrefetch(size_t bufferIndex)
+{
+    assert(m_prefetchTasks.size() < m_numPrefetchBuffers);
+
+    // Chain the new task on the current tail of the queue. That keeps the reads sequential -
+    // the reader is stateful and must never be accessed by two tasks at the same time - while
+    // still letting up to m_numPrefetchBuffers reads run ahead of the network.
+    std::shared_future<PrefetchResult> previous;
+    if (!m_prefetchTasks.empty())
+        previous = m_prefetchTasks.back().m_result;
+
+    auto task = std::async(m_launchType,
+        [this, bufferIndex, previous]()
+    {
+        if (previous.valid())
+            previous.wait();
+        return PrefetchMinibatch(bufferIndex);
     });
+
+    m_prefetchTasks.push_back(PrefetchTask{ bufferIndex, task.share() });
+}
+
+template <class ElemType>
+void ReaderShim<ElemType>::RestartPrefetch()
+{
+    assert(m_prefetchTasks.empty());
+    for (size_t i = 0; i < m_numPrefetchBuffers; ++i)
+        LaunchPrefetch(i);
 }
 
 string EnumerateInputs(const unordered_map<wstring, size_t>& nameToStreamId)
@@ -264,14 +287,34 @@ bool ReaderShim<ElemType>::GetMinibatch(StreamMinibatchInputs& matrices)
         }
     }
 
-    // Make sure the prefetch has finished.
-    assert(m_prefetchTask.valid());
-    auto result = m_prefetchTask.get();
+    // Make sure the oldest prefetch has finished. The reads behind it can still be in flight.
+    assert(!m_prefetchTasks.empty());
+
+    // Count how many prefetches are already complete; an empty ring at this point means
+    // the network is about to stall on the reader.
+    size_t readyPrefetches = 0;
+    for (const auto& task : m_prefetchTasks)
+    {
+        if (task.m_result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            break;
+        ++readyPrefetches;
+    }
+
+    auto currentTask = m_prefetchTasks.front();
+    m_prefetchTasks.pop_front();
+    auto waitStart = std::chrono::steady_clock::now();
+    auto result = currentTask.m_result.get();
+    std::chrono::duration<double> waitElapsed = std::chrono::steady_clock::now() - waitStart;
+    auto& telemetry = ReaderPipelineTelemetry::Instance();
+    telemetry.RecordHandoff(readyPrefetches, waitElapsed.count());
+    telemetry.MaybeLogSummary();
+    auto bufferIndex = currentTask.m_bufferIndex;
 
     // Ok, prefetch is done.
 
-    // Let's update our sample position.
-    m_currentSamplePosition = m_reader->GetCurrentSamplePosition();
+    // Let's update our sample position. The reader can already be several minibatches ahead,
+    // so take the position recorded by the task that produced this minibatch.
+    m_currentSamplePosition = result.m_currentSamplePosition;
 
     m_endOfEpoch = result.m_isEndOfEpoch;
     if (m_endOfEpoch && !result.m_isDataAvailable)
@@ -280,21 +323,16 @@ bool ReaderShim<ElemType>::GetMinibatch(StreamMinibatchInputs& matrices)
         return false;
     }
 
-    // Remember current data transfer, async memcpy for it already started on the prefetch thread.
-    auto currentDataTransferIndex = m_currentDataTransferIndex;
-
-    // Let's update the current data transferer.
-    m_currentDataTransferIndex = (m_currentDataTransferIndex + 1) % 2;
-
-    // Record an event that prefetch can wait on to ensure that prior compute has finished.
-    if (m_dataTransferers[m_currentDataTransferIndex])
-        m_dataTransferers[m_currentDataTransferIndex]->RecordComputeStreamSyncPoint();
+    // Record an event that the next prefetch into this buffer can wait on to ensure
+    // that prior compute has finished.
+    if (m_dataTransferers[bufferIndex])
+        m_dataTransferers[bufferIndex]->RecordComputeStreamSyncPoint();
 
     // We have some data - let's swap the matrices.
     // We cannot simply change pointers because it seems they are remembered deeper in the network.
     for (auto i = matrices.begin(); i != matrices.end(); ++i)
     {
-        std::swap(i->second.GetMatrix<ElemType>(), *m_prefetchBuffers[i->first].m_matrix);
+        std::swap(i->second.GetMatrix<ElemType>(), *m_prefetchBuffers[bufferIndex][i->first].m_matrix);
 
         // Resetting layouts.
         i->second.pMBLayout->Init(1, 0);
@@ -306,7 +344,7 @@ bool ReaderShim<ElemType>::GetMinibatch(StreamMinibatchInputs& matrices)
     // Let's now check the layouts and throw if the same layout is being assigned twice.
     for (auto i = matrices.begin(); i != matrices.end(); ++i)
     {
-        auto streamLayout = m_prefetchBuffers[i->first].m_mbLayout;
+        auto streamLayout = m_prefetchBuffers[bufferIndex][i->first].m_mbLayout;
         auto& layout = i->second.pMBLayout;
         if (layout->GetNumCols() == 0) // just initialized, let's take the layout of the reader.
         {
@@ -327,60 +365,59 @@ bool ReaderShim<ElemType>::GetMinibatch(StreamMinibatchInputs& matrices)
     // So pick up the first one.
     m_numParallelSequences = matrices.begin()->second.pMBLayout->GetNumParallelSequences();
 
-    // It is time to issue the next prefetch.
+    // It is time to issue the next prefetch. The freed buffer goes to the back of the ring.
     if (!m_endOfEpoch)
-    {
-        // Starting the prefetch task. There is always a single async read in flight.
-        // When the network requests a new minibatch, we wait for the current async to finish, swap the buffers
-        // and kick off the new prefetch.
-        auto localCurrentDataTransferIndex = m_currentDataTransferIndex;
-        m_prefetchTask = std::async(m_launchType, [this, localCurrentDataTransferIndex]() { return PrefetchMinibatch(localCurrentDataTransferIndex); });
-    }
+        LaunchPrefetch(bufferIndex);
 
-    // Let's wait till the previous memcopy has finished.
-    if (m_dataTransferers[currentDataTransferIndex])
-        m_dataTransferers[currentDataTransferIndex]->WaitForCopyCPUToGPU();
+    // Let's wait till the memcopy of the delivered minibatch has finished.
+    if (m_dataTransferers[bufferIndex])
+        m_dataTransferers[bufferIndex]->WaitForCopyCPUToGPU();
 
     return result.m_isDataAvailable;
 }
 
 template <class ElemType>
-typename ReaderShim<ElemType>::PrefetchResult ReaderShim<ElemType>::PrefetchMinibatch(size_t currentDataTransferIndex)
+typename ReaderShim<ElemType>::PrefetchResult ReaderShim<ElemType>::PrefetchMinibatch(size_t bufferIndex)
 {
     PROFILE_SCOPE(profilerEvtPrefetchMinibatch);
 
+    auto& buffers = m_prefetchBuffers[bufferIndex];
+
     // Resetting layouts.
-    for (auto& mx : m_prefetchBuffers)
+    for (auto& mx : buffers)
         mx.second.m_mbLayout = std::make_shared<MBLayout>();
 
     Minibatch minibatch = m_reader->ReadMinibatch();
 
+    // Remember the reader position right after this read, so that the main thread can report
+    // the position of the minibatch it delivers, not of the read that ran furthest ahead.
+    size_t samplePosition = m_reader->GetCurrentSamplePosition();
+
     // If there is no data we can simply return.
     if (minibatch.m_data.empty())
-        return PrefetchResult{ minibatch.m_endOfEpoch, false };
+        return PrefetchResult{ minibatch.m_endOfEpoch, false, samplePosition };
 
     // Ok we have some data. Let's load it to GPU.
-    // But before we need to make sure that corresponding compute has already finished from the last iteration.
-
-    // We need to make sure that the compute for the current transfer is finished before we start prefetch.
-    if (m_dataTransferers[currentDataTransferIndex])
-        m_dataTransferers[currentDataTransferIndex]->WaitForSyncPointOnAssignStreamAsync();
+    // But before we need to make sure that the compute consuming the previous contents
+    // of this buffer slot has already finished.
+    if (m_dataTransferers[bufferIndex])
+        m_dataTransferers[bufferIndex]->WaitForSyncPointOnAssignStreamAsync();
 
-    for (auto& mx : m_prefetchBuffers)
+    for (auto& mx : buffers)
     {
         size_t streamId = m_nameToStreamId[mx.first];
         const auto& stream = minibatch.m_data[streamId];
         mx.second.m_mbLayout = stream->m_layout;
 
         size_t sampleSize = m_streams[streamId]->m_sampleLayout->GetNumElements();
-        FillMatrixFromStream(m_streams[streamId]->m_storageType, mx.second.m_matrix.get(), sampleSize, stream, m_dataTransferers[currentDataTransferIndex].get());
+        FillMatrixFromStream(m_streams[streamId]->m_storageType, mx.second.m_matrix.get(), sampleSize, stream, m_dataTransferers[bufferIndex].get());
     }
 
     // Let's record that we started the copy, so that the main thread can wait afterwards.
-    if (m_dataTransferers[currentDataTransferIndex])
-        m_dataTransferers[currentDataTransferIndex]->RecordCPUToGPUCopy();
+    if (m_dataTransferers[bufferIndex])
+        m_dataTransferers[bufferIndex]->RecordCPUToGPUCopy();
 
-    return PrefetchResult{ minibatch.m_endOfEpoch, true };
+    return PrefetchResult{ minibatch.m_endOfEpoch, true, samplePosition };
 }
 
 
@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <string>
 #include <future>
+#include <deque>
 #include "DataReader.h"
 #include "Reader.h"
 
@@ -47,10 +48,11 @@ public:
         // Make sure there are no outstanding reads.
         // Future destructor does not wait as of 2013 so probably it is not in VS2013:
         // More info can be found here http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2013/n3679.html.
-        if (m_prefetchTask.valid())
+        // The tasks are chained, so waiting on the last one covers all of them.
+        if (!m_prefetchTasks.empty())
         {
             // If there are some, give them time to finish.
-            m_prefetchTask.wait_for(std::chrono::seconds(5));
+            m_prefetchTasks.back().m_result.wait_for(std::chrono::seconds(5));
         }
 
         delete this;
@@ -105,11 +107,34 @@ private:
     {
         bool m_isEndOfEpoch;
         bool m_isDataAvailable;
+
+        // Sample position of the reader right after this read. The reader itself can run
+        // several minibatches ahead, so the main thread has to pick up the position that
+        // corresponds to the minibatch it actually delivers to the network.
+        size_t m_currentSamplePosition;
     };
 
-    PrefetchResult PrefetchMinibatch(size_t currentDataTransferIndex);
+    PrefetchResult PrefetchMinibatch(size_t bufferIndex);
+
+    // Starts a new prefetch task for the given buffer/transferer slot, chained on the current
+    // tail of the queue so that the reader is never accessed by two tasks at the same time.
+    void LaunchPrefetch(size_t bufferIndex);
+
+    // Fills the empty prefetch queue with tasks for all buffer slots.
+    void RestartPrefetch();
+
+    // Waits for all in-flight prefetch tasks and their async memcopies and drops them.
+    void WaitForOutstandingPrefetches();
+
+    // Queue of in-flight prefetch tasks, oldest first. Contains at most
+    // m_numPrefetchBuffers entries, each filling its own buffer/transferer slot.
+    struct PrefetchTask
+    {
+        size_t m_bufferIndex;
+        std::shared_future<PrefetchResult> m_result;
+    };
+    std::deque<PrefetchTask> m_prefetchTasks;
 
-    std::future<PrefetchResult> m_prefetchTask;
     ReaderPtr m_reader;
     ReaderFactory m_factory;
     bool m_endOfEpoch;
@@ -127,19 +152,21 @@ private:
         MBLayoutPtr m_mbLayout;
     };
 
-    // Intermediate buffer where the prefetch thread puts its data to.
-    // When the main thread enters GetMinibatch it swaps the matrices from this buffer,
-    // triggers the next prefetch and waits if memCpy is still in progress.
-    std::unordered_map<std::wstring, StreamPrefetchBuffer> m_prefetchBuffers;
+    // Ring of intermediate buffers where the prefetch tasks put their data to,
+    // one buffer set per in-flight read. When the main thread enters GetMinibatch
+    // it swaps the matrices of the oldest task's buffer, triggers a new prefetch
+    // into that buffer and waits if its memCpy is still in progress.
+    std::vector<std::unordered_map<std::wstring, StreamPrefetchBuffer>> m_prefetchBuffers;
 
-    // Alternating data transfer operations. In the current version these are only two - 
-    // currently waiting on the main thread and the one that can be started by the prefetch thread 
-    // in the meantime.
+    // Data transfer operations, one per prefetch buffer, so that each in-flight read
+    // has its own copy/sync events.
     std::vector<DataTransfererPtr> m_dataTransferers;
 
-    // Current data transfer. Flips 0 and 1.
-    // Can be changed only from the main thread with no ongoing prefetch.
-    size_t m_currentDataTransferIndex; 
+    // Number of prefetch buffers, i.e. how many reads can be in flight ahead of the network.
+    // Must match the number of alternating buffers the packer cycles through, otherwise a
+    // read running far ahead could repack host memory whose device copy has not finished yet;
+    // the composite reader sizes its packing buffers from the same 'numPrefetchBuffers' key.
+    size_t m_numPrefetchBuffers;
 
     // Device id.
     int m_deviceId;
@@ -0,0 +1,143 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+#include "ProgressTracing.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Aggregates stall telemetry across the stages of the reader pipeline:
+// chunk-fetch latency in the randomizer, pack time in the packer and
+// prefetch-buffer occupancy in the shim. All counters are relaxed atomics,
+// so recording from the prefetch and packing threads is wait-free; the shim
+// periodically folds them into a one-line summary in the training log. This
+// makes it possible to tell from the log alone whether a samples/sec drop
+// is caused by chunk I/O, packer CPU or the GetMinibatch() handoff.
+class ReaderPipelineTelemetry
+{
+public:
+    static ReaderPipelineTelemetry& Instance()
+    {
+        static ReaderPipelineTelemetry instance;
+        return instance;
+    }
+
+    // Number of chunk-fetch latency histogram buckets: < 1, 4, 16, 64, 256, 1024, 4096 ms and above.
+    static const size_t NumFetchBuckets = 8;
+
+    // Every how many recorded minibatches the summary line is printed; 0 disables it.
+    void SetSummaryInterval(size_t numMinibatches)
+    {
+        m_summaryInterval = numMinibatches;
+    }
+
+    // Called by the randomizer around each deserializer GetChunk(), including prefetches.
+    void RecordChunkFetch(double seconds)
+    {
+        m_fetchCount.fetch_add(1, std::memory_order_relaxed);
+        m_fetchMicroseconds.fetch_add(ToMicroseconds(seconds), std::memory_order_relaxed);
+        size_t bucket = 0;
+        for (double upper = 0.001; bucket < NumFetchBuckets - 1 && seconds >= upper; upper *= 4)
+            ++bucket;
+        m_fetchBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Called by the packer with the time spent packing one minibatch (excluding the
+    // time waiting for sequences from the randomizer).
+    void RecordPack(double seconds)
+    {
+        m_packCount.fetch_add(1, std::memory_order_relaxed);
+        m_packMicroseconds.fetch_add(ToMicroseconds(seconds), std::memory_order_relaxed);
+    }
+
+    // Called by the shim once per GetMinibatch() with the number of already completed
+    // prefetches at entry (0 means the network had to stall) and the time the main
+    // thread was blocked waiting for the delivered minibatch.
+    void RecordHandoff(size_t readyPrefetches, double waitSeconds)
+    {
+        m_handoffCount.fetch_add(1, std::memory_order_relaxed);
+        m_readyPrefetchSum.fetch_add(readyPrefetches, std::memory_order_relaxed);
+        m_handoffWaitMicroseconds.fetch_add(ToMicroseconds(waitSeconds), std::memory_order_relaxed);
+        if (readyPrefetches == 0)
+            m_stallCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Prints the stall summary every m_summaryInterval recorded minibatches.
+    // Called from the shim on the main thread; the counters keep accumulating
+    // from the worker threads while the summary is taken, which is fine - the
+    // summary does not have to be an exact snapshot.
+    void MaybeLogSummary()
+    {
+        if (m_summaryInterval == 0)
+            return;
+        uint64_t count = m_handoffCount.load(std::memory_order_relaxed);
+        if (count == 0 || count - m_lastSummaryCount < m_summaryInterval)
+            return;
+        m_lastSummaryCount = count;
+
+        uint64_t fetches = m_fetchCount.load(std::memory_order_relaxed);
+        uint64_t packs = m_packCount.load(std::memory_order_relaxed);
+        uint64_t stalls = m_stallCount.load(std::memory_order_relaxed);
+        double avgFetchMs = fetches == 0 ? 0 : m_fetchMicroseconds.load(std::memory_order_relaxed) / 1000.0 / fetches;
+        double avgPackMs = packs == 0 ? 0 : m_packMicroseconds.load(std::memory_order_relaxed) / 1000.0 / packs;
+        double avgWaitMs = m_handoffWaitMicroseconds.load(std::memory_order_relaxed) / 1000.0 / count;
+        double avgOccupancy = (double)m_readyPrefetchSum.load(std::memory_order_relaxed) / count;
+
+        char histogram[NumFetchBuckets * 16];
+        char* p = histogram;
+        for (size_t i = 0; i < NumFetchBuckets; ++i)
+            p += sprintf(p, "%s%llu", i == 0 ? "" : "/",
+                         (unsigned long long)m_fetchBuckets[i].load(std::memory_order_relaxed));
+
+        LOGPRINTF(stderr, "Reader stall summary: %llu minibatches; chunk fetches %llu, avg %.1f ms, "
+                  "latency histogram (1ms buckets x4) [%s]; pack avg %.2f ms; "
+                  "prefetch occupancy avg %.2f, handoff wait avg %.2f ms, stalled %llu times (%.1f%%)\n",
+                  (unsigned long long)count, (unsigned long long)fetches, avgFetchMs, histogram,
+                  avgPackMs, avgOccupancy, avgWaitMs,
+                  (unsigned long long)stalls, 100.0 * stalls / count);
+    }
+
+private:
+    ReaderPipelineTelemetry() : m_summaryInterval(1000), m_lastSummaryCount(0)
+    {
+        m_fetchCount = 0;
+        m_fetchMicroseconds = 0;
+        for (auto& bucket : m_fetchBuckets)
+            bucket = 0;
+        m_packCount = 0;
+        m_packMicroseconds = 0;
+        m_handoffCount = 0;
+        m_handoffWaitMicroseconds = 0;
+        m_readyPrefetchSum = 0;
+        m_stallCount = 0;
+    }
+
+    static uint64_t ToMicroseconds(double seconds)
+    {
+        return (uint64_t)(seconds * 1e6);
+    }
+
+    size_t m_summaryInterval;
+    uint64_t m_lastSummaryCount; // only touched from the logging thread
+
+    std::atomic<uint64_t> m_fetchCount;
+    std::atomic<uint64_t> m_fetchMicroseconds;
+    std::atomic<uint64_t> m_fetchBuckets[NumFetchBuckets];
+
+    std::atomic<uint64_t> m_packCount;
+    std::atomic<uint64_t> m_packMicroseconds;
+
+    std::atomic<uint64_t> m_handoffCount;
+    std::atomic<uint64_t> m_handoffWaitMicroseconds;
+    std::atomic<uint64_t> m_readyPrefetchSum;
+    std::atomic<uint64_t> m_stallCount;
+};
+
+}}}
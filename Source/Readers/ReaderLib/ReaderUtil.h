@@ -8,6 +8,11 @@
 #include "Reader.h"
 #include "SequenceEnumerator.h"
 
+#if defined(__SSSE3__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define USE_SSSE3_BASE64_DECODE
+#include <tmmintrin.h> // for the shuffle-based base64 fast path in DecodeBase64
+#endif
+
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 // Returns the size of the type.
@@ -63,12 +68,44 @@ inline bool DecodeBase64(const char* begin, const char* end, std::vector<char>&
         return false;
 
     result.resize((length * 3) / 4); // Upper bound on the max number of decoded symbols.
-    size_t currentDecodedIndex = 0;
+    char* out = result.data();
+
+#ifdef USE_SSSE3_BASE64_DECODE
+    // Decode 16 input characters into 12 output bytes per iteration with nibble-indexed
+    // shuffles (the scheme of Mula/Langdale). The loop requires 24 remaining input
+    // characters so the trailing 4 garbage bytes of the 16-byte store stay inside the
+    // result buffer; the scalar loop below finishes the tail, including '=' padding.
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    while (begin + 24 <= end)
+    {
+        __m128i src = _mm_loadu_si128((const __m128i*) begin);
+        __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(src, 4), _mm_set1_epi8(0x0f));
+        __m128i loNibbles = _mm_and_si128(src, _mm_set1_epi8(0x0f));
+        __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        // a character is valid base64 iff its low/high nibble classes do not intersect
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF)
+            break; // unexpected character (e.g. early '=' padding), finish with the scalar loop
+        __m128i eq2F = _mm_cmpeq_epi8(src, _mm_set1_epi8(0x2f));
+        __m128i shift = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+        __m128i values = _mm_add_epi8(src, shift);
+        // pack the 16 6-bit values into 12 bytes
+        __m128i mergedAbBc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i merged = _mm_madd_epi16(mergedAbBc, _mm_set1_epi32(0x00011000));
+        __m128i packed = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128((__m128i*) out, packed);
+        begin += 16;
+        out += 12;
+    }
+#endif
+
     while (begin < end)
     {
-        result[currentDecodedIndex++] = base64DecodeTable[*begin] << 2 | base64DecodeTable[*(begin + 1)] >> 4;
-        result[currentDecodedIndex++] = base64DecodeTable[*(begin + 1)] << 4 | base64DecodeTable[*(begin + 2)] >> 2;
-        result[currentDecodedIndex++] = base64DecodeTable[*(begin + 2)] << 6 | base64DecodeTable[*(begin + 3)];
+        *out++ = base64DecodeTable[*begin] << 2 | base64DecodeTable[*(begin + 1)] >> 4;
+        *out++ = base64DecodeTable[*(begin + 1)] << 4 | base64DecodeTable[*(begin + 2)] >> 2;
+        *out++ = base64DecodeTable[*(begin + 2)] << 6 | base64DecodeTable[*(begin + 3)];
         begin += 4;
     }
 
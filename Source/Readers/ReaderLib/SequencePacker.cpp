@@ -9,8 +9,12 @@
 #include <numeric>
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <chrono>
 #include "SequencePacker.h"
 #include "ReaderUtil.h"
+#include "ExceptionCapture.h"
+#include "PerformanceProfiler.h"
+#include "ReaderTelemetry.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -45,6 +49,10 @@ Minibatch SequencePacker::ReadMinibatch()
     if (batch.empty())
         return minibatch;
 
+    // Time the packing itself, excluding the wait on the randomizer above.
+    auto profilerState = ProfilerTimeBegin();
+    auto packStart = std::chrono::steady_clock::now();
+
     auto& currentBuffer = m_streamBuffers[m_currentBufferIndex];
 
     assert(m_outputStreamDescriptions.size() == batch.size());
@@ -71,6 +79,11 @@ Minibatch SequencePacker::ReadMinibatch()
     }
 
     m_currentBufferIndex = (m_currentBufferIndex + 1) % m_numberOfBuffers;
+
+    std::chrono::duration<double> packElapsed = std::chrono::steady_clock::now() - packStart;
+    ReaderPipelineTelemetry::Instance().RecordPack(packElapsed.count());
+    ProfilerTimeEnd(profilerState, "Reader: pack minibatch");
+
     return minibatch;
 }
 
@@ -147,15 +160,23 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
 
     const auto& sequenceInfos = pMBLayout->GetAllSequences();
 
+    if (stream->m_storageType != StorageType::dense && stream->m_storageType != StorageType::sparse_csc)
+    {
+        RuntimeError("Storage type %d is not supported.", (int)stream->m_storageType);
+    }
+
     // Iterate over sequences in the layout, copy samples from the
     // source sequences into the buffer (at appropriate offsets).
-    for (int i = 0; i < sequenceInfos.size(); ++i)
+    // Each sequence occupies its own set of columns in the layout, so the sequences
+    // write disjoint regions of the buffer and can be packed in parallel; this matters
+    // for sparse input, where the sparse-to-dense expansion is CPU-bound.
+    auto packSequence = [&](int i)
     {
         const auto& sequenceInfo = sequenceInfos[i];
         // skip gaps
         if (sequenceInfo.seqId == GAP_SEQUENCE_ID)
         {
-            continue;
+            return;
         }
 
         const auto& sequence = batch[sequenceInfo.seqId];
@@ -189,16 +210,18 @@ MBLayoutPtr SequencePacker::PackDenseStream(const StreamBatch& batch, size_t str
                 PackSparseSampleAsDense(destination, sparseSequence, sampleIndex, sampleOffset, sampleSize, elementSize);
                 // move the offset by nnz count of the sample.
                 sampleOffset += sparseSequence->m_nnzCounts[sampleIndex];
-                // verify that the offset is within the bounds (less or equal 
+                // verify that the offset is within the bounds (less or equal
                 // to the total nnz count of the sequence).
                 assert(sampleOffset <= sparseSequence->m_totalNnzCount);
             }
-            else
-            {
-                RuntimeError("Storage type %d is not supported.", (int)stream->m_storageType);
-            }
         }
-    }
+    };
+
+    ExceptionCapture capture;
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)sequenceInfos.size(); ++i)
+        capture.SafeRun(packSequence, i);
+    capture.RethrowIfHappened();
 
     return pMBLayout;
 }
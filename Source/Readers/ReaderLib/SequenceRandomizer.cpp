@@ -18,8 +18,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
     SequenceRandomizer::SequenceRandomizer(
         int verbosity,
         IDataDeserializerPtr deserializer,
-        ChunkRandomizerPtr chunkRandomizer)
+        ChunkRandomizerPtr chunkRandomizer,
+        const std::vector<size_t>& lengthBucketBoundaries)
         : m_verbosity(verbosity),
+        m_lengthBucketBoundaries(lengthBucketBoundaries),
         m_randomizedChunks(chunkRandomizer->GetRandomizedChunks()),
         m_chunkWindowBegin(0),
         m_randomizedWindowEnd(0),
@@ -40,6 +42,17 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         }
 
         m_bufferOriginalSequences.reserve(max);
+
+        std::sort(m_lengthBucketBoundaries.begin(), m_lengthBucketBoundaries.end());
+    }
+
+    // Gets the index of the length bucket the given sequence length falls into.
+    // Bucket i contains the lengths in (boundary[i-1], boundary[i]]; lengths above
+    // the last boundary fall into one final catch-all bucket.
+    size_t SequenceRandomizer::GetLengthBucket(uint32_t numberOfSamples) const
+    {
+        return std::lower_bound(m_lengthBucketBoundaries.begin(), m_lengthBucketBoundaries.end(), (size_t)numberOfSamples) -
+               m_lengthBucketBoundaries.begin();
     }
 
     // Resets the current sweep according to the randomization seed provided.
@@ -266,6 +279,22 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         // Let's recalculate number of samples in the randomized chunks for efficient indexing in seek.
         size_t sampleCount = 0;
         size_t randomizedChunk = m_randomizedWindowEnd - m_chunkWindowBegin;
+
+        // Optional length bucketing: the chunk at m_randomizedWindowEnd has just reached its
+        // final sequence set (the cursor is about to emit from it, so no later swap can touch
+        // it anymore). Stably group its sequences by length bucket, so that minibatches are
+        // cut from runs of similar-length sequences. The grouping is deterministic, which
+        // keeps Seek()/checkpoint replay consistent; the random order within a bucket and the
+        // random chunk membership are preserved.
+        if (!m_lengthBucketBoundaries.empty())
+        {
+            auto& sequences = m_sequenceWindow[randomizedChunk];
+            std::stable_sort(sequences.begin(), sequences.end(),
+                [this](const RandomizedSequenceDescription& a, const RandomizedSequenceDescription& b)
+                {
+                    return GetLengthBucket(a.m_numberOfSamples) < GetLengthBucket(b.m_numberOfSamples);
+                });
+        }
         for (size_t index = 0; index < m_sequenceWindow[randomizedChunk].size(); index++)
         {
             sampleCount += m_sequenceWindow[randomizedChunk][index].m_numberOfSamples;
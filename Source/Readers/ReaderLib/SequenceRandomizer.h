@@ -35,7 +35,8 @@ public:
     SequenceRandomizer(
         int verbosity,
         IDataDeserializerPtr deserializer,
-        ChunkRandomizerPtr chunkRandomizer);
+        ChunkRandomizerPtr chunkRandomizer,
+        const std::vector<size_t>& lengthBucketBoundaries = std::vector<size_t>());
 
     // Resets the current sweep according to the randomization seed provided.
     void Reset(size_t seed);
@@ -79,8 +80,19 @@ private:
     // Release chunks from the chunk window that are not needed anymore.
     void ReleaseChunks();
 
+    // Gets the index of the length bucket the given sequence length falls into.
+    size_t GetLengthBucket(uint32_t numberOfSamples) const;
+
     IDataDeserializerPtr m_deserializer;
 
+    // Optional sorted sequence length bucket boundaries (empty = no bucketing).
+    // When set, the sequences of each randomized chunk are stably grouped by
+    // length bucket right after the chunk has been randomized, so that batches
+    // are drawn from runs of similar-length sequences and need little padding.
+    // Which sequences land in the chunk stays fully randomized; only their
+    // order within the chunk is constrained.
+    std::vector<size_t> m_lengthBucketBoundaries;
+
     // Used only as a buffer to get sequence descriptions without memory reallocation.
     std::vector<SequenceDescription> m_bufferOriginalSequences;
 
@@ -8,13 +8,21 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <map>
+#include <atomic>
+#include <mutex>
+#include <functional>
 #include "Basics.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
 // This class represents a string registry pattern to share strings between different deserializers if needed.
 // It associates a unique key for a given string.
+// The registry is safe for concurrent use: lookups (TryGet/Contains/operator[]) are lock-free reads
+// of an open-addressing hash table, so deserializers can key-match their sequences from parallel
+// threads. Insertion is sharded - each shard has its own write lock and hash table, so concurrent
+// registration of new keys only contends when the keys hash to the same shard.
+// Registered strings are never moved or removed, so references handed out stay valid
+// for the lifetime of the registry.
 // Currently it is implemented in-memory, but can be unloaded to external disk if needed.
 // TODO: Move this class to Basics.h when it is required by more than one reader.
 template<class TString>
@@ -22,26 +30,32 @@ class TStringToIdMap
 {
 public:
     TStringToIdMap()
-    {}
+    {
+        for (size_t i = 0; i < NumShards; ++i)
+        {
+            m_shards[i].m_count = 0;
+            m_shards[i].m_table.store(m_shards[i].AddTable(InitialCapacity), std::memory_order_relaxed);
+        }
+    }
 
     // Adds string value to the registry.
     void AddValue(const TString& value)
     {
-        auto iter = m_values.insert(std::make_pair(value, m_indexedValues.size()));
-        m_indexedValues.push_back(&((iter.first)->first));
+        Insert(value);
     }
 
     // Tries to get a value by id.
     bool TryGet(const TString& value, size_t& id) const
     {
-        const auto& it = m_values.find(value);
-        if (it == m_values.end())
+        size_t hash = std::hash<TString>()(value);
+        const Entry* entry = Find(m_shards[hash & (NumShards - 1)], hash, value);
+        if (entry == nullptr)
         {
             return false;
         }
         else
         {
-            id = it->second;
+            id = entry->m_id;
             return true;
         }
     }
@@ -49,26 +63,22 @@ public:
     // Get integer id for the string value, adding if not exists.
     size_t operator[](const TString& value)
     {
-        const auto& it = m_values.find(value);
-        if (it == m_values.end())
-        {
-            AddValue(value);
-            return m_values[value];
-        }
-        return it->second;
+        return Insert(value);
     }
 
     // Get integer id for the string value.
     size_t operator[](const TString& value) const
     {
-        const auto& it = m_values.find(value);
-        assert(it != m_values.end());
-        return it->second;
+        size_t hash = std::hash<TString>()(value);
+        const Entry* entry = Find(m_shards[hash & (NumShards - 1)], hash, value);
+        assert(entry != nullptr);
+        return entry->m_id;
     }
 
     // Get string value by its integer id.
     const TString& operator[](size_t id) const
     {
+        std::lock_guard<std::mutex> lock(m_idLock);
         if (id >= m_indexedValues.size())
             RuntimeError("Unknown id requested");
         return *m_indexedValues[id];
@@ -77,14 +87,136 @@ public:
     // Checks whether the value exists.
     bool Contains(const TString& value) const
     {
-        return m_values.find(value) != m_values.end();
+        size_t hash = std::hash<TString>()(value);
+        return Find(m_shards[hash & (NumShards - 1)], hash, value) != nullptr;
     }
 
 private:
     // TODO: Move NonCopyable as a separate class to Basics.h
     DISABLE_COPY_AND_MOVE(TStringToIdMap);
 
-    std::map<TString, size_t> m_values;
+    static const size_t NumShards = 32;       // must be a power of two
+    static const size_t InitialCapacity = 256; // per-shard slots, must be a power of two
+
+    // A registered string together with its id. Entries are allocated once and never move.
+    struct Entry
+    {
+        TString m_value;
+        size_t m_id;
+    };
+
+    // Open-addressing table of a single shard. Slots hold pointers to entries and are only
+    // ever changed from empty to non-empty, so probing a consistent snapshot needs no lock.
+    struct Table
+    {
+        explicit Table(size_t capacity) :
+            m_mask(capacity - 1),
+            m_slots(new std::atomic<Entry*>[capacity])
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                m_slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        size_t m_mask;
+        std::unique_ptr<std::atomic<Entry*>[]> m_slots;
+    };
+
+    struct Shard
+    {
+        std::atomic<Table*> m_table;
+
+        // The members below are accessed by writers only, under m_writeLock.
+        std::mutex m_writeLock;
+        size_t m_count;
+        std::vector<std::unique_ptr<Entry>> m_entries;
+        std::vector<std::unique_ptr<Table>> m_tables; // current and retired tables;
+                                                      // retired ones stay alive for concurrent readers
+
+        Table* AddTable(size_t capacity)
+        {
+            m_tables.push_back(std::unique_ptr<Table>(new Table(capacity)));
+            return m_tables.back().get();
+        }
+    };
+
+    // Probes the shard table for the value. Lock-free: concurrent inserts are either
+    // fully visible (published with release semantics) or not visible at all.
+    static const Entry* Find(const Shard& shard, size_t hash, const TString& value)
+    {
+        const Table* table = shard.m_table.load(std::memory_order_acquire);
+        for (size_t index = (hash >> ShardBits) & table->m_mask;; index = (index + 1) & table->m_mask)
+        {
+            const Entry* entry = table->m_slots[index].load(std::memory_order_acquire);
+            if (entry == nullptr)
+                return nullptr;
+            if (entry->m_value == value)
+                return entry;
+        }
+    }
+
+    size_t Insert(const TString& value)
+    {
+        size_t hash = std::hash<TString>()(value);
+        Shard& shard = m_shards[hash & (NumShards - 1)];
+
+        // Fast path - the value is usually registered already.
+        const Entry* existing = Find(shard, hash, value);
+        if (existing != nullptr)
+            return existing->m_id;
+
+        std::lock_guard<std::mutex> lock(shard.m_writeLock);
+
+        // Another writer may have inserted the value before the lock was taken.
+        existing = Find(shard, hash, value);
+        if (existing != nullptr)
+            return existing->m_id;
+
+        shard.m_entries.push_back(std::unique_ptr<Entry>(new Entry()));
+        Entry* entry = shard.m_entries.back().get();
+        entry->m_value = value;
+        {
+            std::lock_guard<std::mutex> idLock(m_idLock);
+            entry->m_id = m_indexedValues.size();
+            m_indexedValues.push_back(&entry->m_value);
+        }
+
+        Table* table = shard.m_table.load(std::memory_order_relaxed);
+        if ((shard.m_count + 1) * 4 > (table->m_mask + 1) * 3) // keep the load factor below 3/4
+            table = Grow(shard);
+
+        PutIntoEmptySlot(*table, entry);
+        shard.m_count++;
+        return entry->m_id;
+    }
+
+    // Doubles the shard table and republishes it. The old table is retired, not freed,
+    // so readers that loaded it before the switch can finish probing safely.
+    static Table* Grow(Shard& shard)
+    {
+        Table* oldTable = shard.m_table.load(std::memory_order_relaxed);
+        Table* newTable = shard.AddTable((oldTable->m_mask + 1) * 2);
+        for (const auto& entry : shard.m_entries)
+            PutIntoEmptySlot(*newTable, entry.get());
+        shard.m_table.store(newTable, std::memory_order_release);
+        return newTable;
+    }
+
+    static void PutIntoEmptySlot(Table& table, Entry* entry)
+    {
+        size_t hash = std::hash<TString>()(entry->m_value);
+        size_t index = (hash >> ShardBits) & table.m_mask;
+        while (table.m_slots[index].load(std::memory_order_relaxed) != nullptr)
+            index = (index + 1) & table.m_mask;
+        table.m_slots[index].store(entry, std::memory_order_release);
+    }
+
+    static const size_t ShardBits = 5; // log2(NumShards); the low hash bits select the shard,
+                                       // so probing starts from the bits above them
+
+    Shard m_shards[NumShards];
+
+    // Id to string mapping, shared by all shards; ids are assigned densely in insertion order.
+    mutable std::mutex m_idLock;
     std::vector<const TString*> m_indexedValues;
 };
 
@@ -0,0 +1,327 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <limits>
+
+#include "SyntheticDataDeserializer.h"
+#include "BlockRandomizer.h"
+#include "NoRandomizer.h"
+#include "SequencePacker.h"
+#include "FramePacker.h"
+#include "StringUtil.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+using namespace std;
+
+// 64-bit finalizer of the splitmix64 generator. Used as a stateless hash so that every
+// per-sequence quantity is a pure function of its identifiers - this is what makes the
+// generated corpus deterministic regardless of chunk visiting order, number of workers
+// or randomization mode.
+static inline uint64_t Hash64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+template <class ElemType>
+SyntheticDataDeserializer<ElemType>::SyntheticDataDeserializer(const ConfigParameters& config)
+{
+    m_numChunks = config(L"numChunks", (size_t)128);
+    m_sequencesPerChunk = config(L"sequencesPerChunk", (size_t)512);
+    m_minSequenceLength = config(L"minSequenceLength", (size_t)1);
+    m_maxSequenceLength = config(L"maxSequenceLength", (size_t)1);
+    m_seed = config(L"randomSeed", (size_t)0);
+
+    if (m_numChunks == 0 || m_sequencesPerChunk == 0)
+        RuntimeError("SyntheticDataDeserializer: 'numChunks' and 'sequencesPerChunk' must be greater than zero.");
+
+    if (m_minSequenceLength == 0 || m_minSequenceLength > m_maxSequenceLength)
+        RuntimeError("SyntheticDataDeserializer: invalid sequence length range [%u, %u].",
+            m_minSequenceLength, m_maxSequenceLength);
+
+    if (!config.ExistsCurrent(L"input"))
+        RuntimeError("SyntheticDataDeserializer configuration does not contain \"input\" section.");
+
+    const ConfigParameters& input = config(L"input");
+    if (input.empty())
+        RuntimeError("SyntheticDataDeserializer configuration contains an empty \"input\" section.");
+
+    ElementType elementType = sizeof(ElemType) == sizeof(float) ? ElementType::tfloat : ElementType::tdouble;
+
+    StreamId id = 0;
+    for (const pair<string, ConfigParameters>& section : input)
+    {
+        ConfigParameters streamConfig = section.second;
+        wstring name = msra::strfun::utf16(section.first);
+
+        if (!streamConfig.ExistsCurrent(L"dim"))
+            RuntimeError("Input section for synthetic input '%ls' does not specify \"dim\".", name.c_str());
+
+        SyntheticStreamDescriptor descriptor;
+        descriptor.m_name = name;
+        descriptor.m_sampleDimension = streamConfig(L"dim");
+        descriptor.m_nnzPerSample = streamConfig(L"nnzPerSample", (size_t)1);
+
+        string format = streamConfig(L"format", "dense");
+        if (AreEqualIgnoreCase(format, "dense"))
+        {
+            descriptor.m_storageType = StorageType::dense;
+        }
+        else if (AreEqualIgnoreCase(format, "sparse"))
+        {
+            descriptor.m_storageType = StorageType::sparse_csc;
+            if (descriptor.m_sampleDimension > (size_t)numeric_limits<IndexType>::max())
+            {
+                RuntimeError("Sample dimension (%" PRIu64 ") for sparse synthetic input '%ls'"
+                    " exceeds the maximum allowed value (%" PRIu64 ").\n",
+                    descriptor.m_sampleDimension, name.c_str(), (size_t)numeric_limits<IndexType>::max());
+            }
+            if (descriptor.m_nnzPerSample == 0 || descriptor.m_nnzPerSample > descriptor.m_sampleDimension)
+                RuntimeError("Invalid 'nnzPerSample' for sparse synthetic input '%ls'.", name.c_str());
+        }
+        else
+        {
+            RuntimeError("'format' parameter must be set either to 'dense' or 'sparse'.");
+        }
+
+        auto stream = make_shared<StreamDescription>();
+        stream->m_id = id++;
+        stream->m_name = name;
+        stream->m_storageType = descriptor.m_storageType;
+        stream->m_elementType = elementType;
+        stream->m_sampleLayout = make_shared<TensorShape>(descriptor.m_sampleDimension);
+
+        m_streamDescriptors.push_back(descriptor);
+        m_streams.push_back(stream);
+    }
+
+    // Sequence lengths are deterministic, so the per-chunk sample counts can be fixed up front.
+    m_chunkSampleCounts.resize(m_numChunks);
+    for (size_t chunkId = 0; chunkId < m_numChunks; ++chunkId)
+    {
+        size_t numberOfSamples = 0;
+        for (size_t i = 0; i < m_sequencesPerChunk; ++i)
+            numberOfSamples += SequenceLength(chunkId * m_sequencesPerChunk + i);
+        m_chunkSampleCounts[chunkId] = numberOfSamples;
+    }
+}
+
+template <class ElemType>
+uint32_t SyntheticDataDeserializer<ElemType>::SequenceLength(size_t sequenceId) const
+{
+    if (m_minSequenceLength == m_maxSequenceLength)
+        return m_minSequenceLength;
+    uint64_t range = m_maxSequenceLength - m_minSequenceLength + 1;
+    return m_minSequenceLength + (uint32_t)(Hash64(m_seed ^ Hash64(sequenceId)) % range);
+}
+
+template <class ElemType>
+ChunkDescriptions SyntheticDataDeserializer<ElemType>::GetChunkDescriptions()
+{
+    ChunkDescriptions result;
+    result.reserve(m_numChunks);
+    for (ChunkIdType chunkId = 0; chunkId < (ChunkIdType)m_numChunks; ++chunkId)
+    {
+        auto description = make_shared<ChunkDescription>();
+        description->m_id = chunkId;
+        description->m_numberOfSequences = m_sequencesPerChunk;
+        description->m_numberOfSamples = m_chunkSampleCounts[chunkId];
+        result.push_back(description);
+    }
+    return result;
+}
+
+template <class ElemType>
+void SyntheticDataDeserializer<ElemType>::GetSequencesForChunk(ChunkIdType chunkId, vector<SequenceDescription>& descriptions)
+{
+    descriptions.reserve(m_sequencesPerChunk);
+    for (size_t i = 0; i < m_sequencesPerChunk; ++i)
+    {
+        size_t sequenceId = chunkId * m_sequencesPerChunk + i;
+        SequenceDescription description;
+        description.m_id = sequenceId;
+        description.m_numberOfSamples = SequenceLength(sequenceId);
+        description.m_chunkId = chunkId;
+        description.m_key.m_sequence = sequenceId;
+        description.m_key.m_sample = 0;
+        descriptions.push_back(description);
+    }
+}
+
+// A chunk of fabricated data. All sequence data for a stream lives in one contiguous
+// buffer allocated when the chunk is requested, the same ownership model the file-based
+// deserializers use: sequences point into chunk storage and the randomizer keeps the
+// chunk alive until all its sequences have been consumed.
+template <class ElemType>
+class SyntheticDataDeserializer<ElemType>::SyntheticChunk : public Chunk
+{
+    struct DenseStreamBuffer : DenseSequenceData
+    {
+        const void* GetDataBuffer() override
+        {
+            return m_data;
+        }
+
+        const ElemType* m_data; // points into the chunk-wide buffer
+    };
+
+    struct SparseStreamBuffer : SparseSequenceData
+    {
+        const void* GetDataBuffer() override
+        {
+            return m_data;
+        }
+
+        const ElemType* m_data; // points into the chunk-wide buffer
+    };
+
+public:
+    SyntheticChunk(const SyntheticDataDeserializer<ElemType>& parent, ChunkIdType chunkId)
+    {
+        const auto& streams = parent.m_streamDescriptors;
+        size_t numSequences = parent.m_sequencesPerChunk;
+        size_t numSamples = parent.m_chunkSampleCounts[chunkId];
+
+        m_denseBuffers.resize(streams.size());
+        m_indexBuffers.resize(streams.size());
+        for (size_t s = 0; s < streams.size(); ++s)
+        {
+            if (streams[s].m_storageType == StorageType::dense)
+                m_denseBuffers[s].resize(numSamples * streams[s].m_sampleDimension);
+            else
+            {
+                m_denseBuffers[s].resize(numSamples * streams[s].m_nnzPerSample);
+                m_indexBuffers[s].resize(numSamples * streams[s].m_nnzPerSample);
+            }
+        }
+
+        m_sequences.resize(numSequences);
+        vector<size_t> samplePosition(streams.size(), 0);
+        for (size_t i = 0; i < numSequences; ++i)
+        {
+            size_t sequenceId = chunkId * parent.m_sequencesPerChunk + i;
+            uint32_t numberOfSamples = parent.SequenceLength(sequenceId);
+
+            m_sequences[i].resize(streams.size());
+            for (size_t s = 0; s < streams.size(); ++s)
+            {
+                const auto& stream = streams[s];
+                uint64_t sequenceSeed = Hash64(parent.m_seed ^ Hash64(sequenceId * streams.size() + s));
+                if (stream.m_storageType == StorageType::dense)
+                {
+                    ElemType* data = m_denseBuffers[s].data() + samplePosition[s] * stream.m_sampleDimension;
+                    size_t count = numberOfSamples * stream.m_sampleDimension;
+                    for (size_t n = 0; n < count; ++n)
+                    {
+                        // Values uniform in [-1, 1), cheap to generate and well-conditioned for GEMMs.
+                        sequenceSeed = Hash64(sequenceSeed);
+                        data[n] = (ElemType)((int64_t)(sequenceSeed >> 11) % (1 << 20)) / (ElemType)(1 << 19) - 1;
+                    }
+
+                    auto sequence = make_shared<DenseStreamBuffer>();
+                    sequence->m_data = data;
+                    sequence->m_id = sequenceId;
+                    sequence->m_numberOfSamples = numberOfSamples;
+                    sequence->m_elementType = parent.m_streams[s]->m_elementType;
+                    sequence->m_sampleLayout = parent.m_streams[s]->m_sampleLayout;
+                    m_sequences[i][s] = sequence;
+                    samplePosition[s] += numberOfSamples;
+                }
+                else
+                {
+                    size_t nnz = stream.m_nnzPerSample;
+                    ElemType* data = m_denseBuffers[s].data() + samplePosition[s] * nnz;
+                    IndexType* indices = m_indexBuffers[s].data() + samplePosition[s] * nnz;
+
+                    auto sequence = make_shared<SparseStreamBuffer>();
+                    sequence->m_nnzCounts.resize(numberOfSamples, (IndexType)nnz);
+                    sequence->m_totalNnzCount = (IndexType)(numberOfSamples * nnz);
+                    for (size_t n = 0; n < numberOfSamples * nnz; ++n)
+                    {
+                        sequenceSeed = Hash64(sequenceSeed);
+                        indices[n] = (IndexType)(sequenceSeed % stream.m_sampleDimension);
+                        data[n] = 1; // one-hot style payload, e.g. class labels
+                    }
+
+                    sequence->m_data = data;
+                    sequence->m_indices = indices;
+                    sequence->m_id = sequenceId;
+                    sequence->m_numberOfSamples = numberOfSamples;
+                    sequence->m_elementType = parent.m_streams[s]->m_elementType;
+                    sequence->m_sampleLayout = parent.m_streams[s]->m_sampleLayout;
+                    m_sequences[i][s] = sequence;
+                    samplePosition[s] += numberOfSamples;
+                }
+            }
+        }
+    }
+
+    void GetSequence(size_t sequenceId, vector<SequenceDataPtr>& result) override
+    {
+        const auto& sequence = m_sequences[sequenceId % m_sequences.size()];
+        result.insert(result.end(), sequence.begin(), sequence.end());
+    }
+
+private:
+    // Chunk-wide value (and, for sparse streams, index) storage, one buffer per stream.
+    vector<vector<ElemType>> m_denseBuffers;
+    vector<vector<IndexType>> m_indexBuffers;
+    // Per-sequence views into the buffers above, indexed by position inside the chunk.
+    vector<vector<SequenceDataPtr>> m_sequences;
+};
+
+template <class ElemType>
+ChunkPtr SyntheticDataDeserializer<ElemType>::GetChunk(ChunkIdType chunkId)
+{
+    return make_shared<SyntheticChunk>(*this, chunkId);
+}
+
+template class SyntheticDataDeserializer<float>;
+template class SyntheticDataDeserializer<double>;
+
+SyntheticReader::SyntheticReader(const ConfigParameters& config)
+{
+    string precision = config.Find("precision", "float");
+    bool isFloat = AreEqualIgnoreCase(precision, "float");
+    if (!isFloat && !AreEqualIgnoreCase(precision, "double"))
+        RuntimeError("Not supported precision '%s'. Expected 'double' or 'float'.", precision.c_str());
+
+    bool frameMode;
+    if (isFloat)
+    {
+        auto deserializer = make_shared<SyntheticDataDeserializer<float>>(config);
+        frameMode = deserializer->IsInFrameMode();
+        m_deserializer = deserializer;
+    }
+    else
+    {
+        auto deserializer = make_shared<SyntheticDataDeserializer<double>>(config);
+        frameMode = deserializer->IsInFrameMode();
+        m_deserializer = deserializer;
+    }
+
+    size_t window = config(L"randomizationWindow", (size_t)0);
+    if (window > 0)
+    {
+        int verbosity = config(L"verbosity", 0);
+        m_sequenceEnumerator = make_shared<BlockRandomizer>(verbosity, window, m_deserializer, true);
+    }
+    else
+    {
+        m_sequenceEnumerator = make_shared<NoRandomizer>(m_deserializer);
+    }
+
+    if (frameMode)
+        m_packer = make_shared<FramePacker>(m_sequenceEnumerator, ReaderBase::GetStreamDescriptions());
+    else
+        m_packer = make_shared<SequencePacker>(m_sequenceEnumerator, ReaderBase::GetStreamDescriptions());
+}
+
+}}}
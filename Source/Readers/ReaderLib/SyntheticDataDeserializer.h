@@ -0,0 +1,82 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "DataDeserializerBase.h"
+#include "ReaderBase.h"
+#include "Config.h"
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Configuration of a single synthetically generated stream.
+struct SyntheticStreamDescriptor
+{
+    std::wstring m_name;     // Input name the stream is exposed under.
+    size_t m_sampleDimension;// Number of rows per sample.
+    StorageType m_storageType;
+    size_t m_nnzPerSample;   // For sparse streams: non-zero values per sample (1 == one-hot labels).
+};
+
+// Deserializer that fabricates deterministic data in memory, performing no I/O at all.
+// It is used by the "benchmark" action to measure the full reader -> packer -> network
+// pipeline without requiring an actual corpus on disk: the same configuration always
+// produces bit-identical sequences (lengths and values are pure functions of the random
+// seed and the global sequence id), so runs are comparable across machines and builds.
+//
+// Configuration (inside the reader section):
+//   numChunks          - number of chunks to expose (default 128)
+//   sequencesPerChunk  - sequences per chunk (default 512)
+//   minSequenceLength/
+//   maxSequenceLength  - sequence lengths are drawn uniformly from this range, per-sequence
+//                        deterministic (default 1/1, i.e. frame mode)
+//   randomSeed         - seed mixed into all per-sequence hashes (default 0)
+//   input              - stream sections as in CNTKTextFormatReader: each with "dim" and
+//                        "format" ("dense" or "sparse"), sparse streams may set "nnzPerSample"
+template <class ElemType>
+class SyntheticDataDeserializer : public DataDeserializerBase
+{
+public:
+    SyntheticDataDeserializer(const ConfigParameters& config);
+
+    ChunkDescriptions GetChunkDescriptions() override;
+    void GetSequencesForChunk(ChunkIdType chunkId, std::vector<SequenceDescription>& descriptions) override;
+    ChunkPtr GetChunk(ChunkIdType chunkId) override;
+
+    // True when all sequences are single samples, so the frame mode packer can be used.
+    bool IsInFrameMode() const
+    {
+        return m_minSequenceLength == 1 && m_maxSequenceLength == 1;
+    }
+
+private:
+    class SyntheticChunk;
+
+    // Length of the sequence with the given global id; a pure function of (m_seed, sequenceId).
+    uint32_t SequenceLength(size_t sequenceId) const;
+
+    size_t m_numChunks;
+    size_t m_sequencesPerChunk;
+    uint32_t m_minSequenceLength;
+    uint32_t m_maxSequenceLength;
+    uint64_t m_seed;
+
+    // Synthetic stream configuration, parallel to m_streams of the base class.
+    std::vector<SyntheticStreamDescriptor> m_streamDescriptors;
+
+    // Samples per chunk, precomputed in the constructor (lengths are deterministic).
+    std::vector<size_t> m_chunkSampleCounts;
+};
+
+// Reader that connects the synthetic deserializer to a randomizer and a packer,
+// mirroring what CNTKTextFormatReader does for on-disk data. The benchmark action
+// wraps it in a ReaderShim so minibatches flow through the exact production path.
+class SyntheticReader : public ReaderBase
+{
+public:
+    SyntheticReader(const ConfigParameters& parameters);
+};
+
+}}}
@@ -153,16 +153,24 @@ void TruncatedBPTTPacker::SetConfiguration(const ReaderConfiguration& config, co
             (m_numParallelSequences / m_config.m_numberOfWorkers) +
             (m_config.m_workerRank < (m_numParallelSequences % m_config.m_numberOfWorkers) ? 1 : 0);
 
-        m_sequenceBufferPerStream.clear();
+        // Slot buffers persist across sweeps and epochs as long as the slot count stays the
+        // same: sequences already read into the slots are carried over and the slot deques
+        // keep their storage, instead of being dropped and reallocated on every reconfiguration.
+        if (m_sequenceBufferPerStream.empty() ||
+            m_sequenceBufferPerStream.front()->m_slots.size() != m_numParallelSequences)
+        {
+            m_sequenceBufferPerStream.clear();
+            for (int i = 0; i < m_outputStreamDescriptions.size(); ++i)
+                m_sequenceBufferPerStream.push_back(make_shared<SequenceBuffer>(m_numParallelSequences));
+        }
 
-        // Preparing the buffers.
+        // Preparing the buffers. Resize() only reallocates when the new size exceeds capacity.
         for (int j = 0; j < m_streamBuffers.size(); ++j)
             for (int i = 0; i < m_outputStreamDescriptions.size(); ++i)
             {
                 const auto& stream = m_outputStreamDescriptions[i];
                 auto& buffer = m_streamBuffers[j][i];
                 buffer.Resize(m_numParallelSequences * m_config.m_truncationSize * GetSampleSize(stream));
-                m_sequenceBufferPerStream.push_back(make_shared<SequenceBuffer>(m_numParallelSequences));
             }
     }
 
@@ -306,7 +314,8 @@ void TruncatedBPTTPacker::PackSlot(size_t streamIndex, size_t slotIndex, size_t&
 
 void TruncatedBPTTPacker::ReadSequencesToSlot(size_t slotIndex)
 {
-    const auto& slot = m_sequenceBufferPerStream.front()->m_slots[slotIndex];
+    const auto& slots = m_sequenceBufferPerStream.front()->m_slots;
+    const auto& slot = slots[slotIndex];
     while (m_config.m_truncationSize >= slot.AvailableNumberOfSamples())
     {
         // We need a single sequence, potentially we can request (m_truncationSize - slot.AvailableNumberOfSamples())
@@ -314,7 +323,20 @@ void TruncatedBPTTPacker::ReadSequencesToSlot(size_t slotIndex)
         // Bptt always operates on a local timeline, so we do not limit the global minibatch count.
         auto s = m_sequenceEnumerator->GetNextSequences(SIZE_MAX, 1);
 
-        // Adding sequence to the slot for all streams.
+        // Rather than growing the requested slot directly, hand the incoming sequence to the
+        // slot that currently has the fewest remaining samples. This balances remaining frame
+        // counts across slots, so they drain at about the same time at the end of the sweep
+        // instead of short slots idling as gaps while one slot works off a long sequence.
+        // The requested slot still fills up: once it is the shortest one, it receives the
+        // sequences itself, so the loop terminates as before.
+        size_t targetSlotIndex = slotIndex;
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (slots[i].AvailableNumberOfSamples() < slots[targetSlotIndex].AvailableNumberOfSamples())
+                targetSlotIndex = i;
+        }
+
+        // Adding sequence to the target slot for all streams.
         for (size_t i = 0; i < s.m_data.size(); ++i)
         {
             assert(s.m_data[i].size() == 1);
@@ -325,7 +347,7 @@ void TruncatedBPTTPacker::ReadSequencesToSlot(size_t slotIndex)
                 RuntimeError("For BPTT sequences between different input stream should have the same length.");
             }
 
-            m_sequenceBufferPerStream[i]->m_slots[slotIndex].PushSequence(s.m_data[i].front());
+            m_sequenceBufferPerStream[i]->m_slots[targetSlotIndex].PushSequence(s.m_data[i].front());
         }
 
         if (s.m_endOfEpoch)
@@ -17,7 +17,9 @@
 #include <sys/stat.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <unistd.h>
 #endif
+#include <algorithm>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -33,6 +35,15 @@ DWORD LODWORD(size_t size)
 template <class ElemType>
 SparsePCReader<ElemType>::~SparsePCReader()
 {
+    // an outstanding background parse still reads from the mapping and the staging buffers
+    try
+    {
+        WaitForPrefetch();
+    }
+    catch (...)
+    {
+    }
+
 #ifdef SPARSE_PCREADER_USE_WINDOWS_API
     if (m_filemap != NULL)
     {
@@ -65,12 +76,24 @@ SparsePCReader<ElemType>::~SparsePCReader()
         {
             free(m_colIndices[i]);
         }
+
+        if (i < m_prefetched.values.size() && m_prefetched.values[i] != NULL)
+        {
+            free(m_prefetched.values[i]);
+            free(m_prefetched.rowIndices[i]);
+            free(m_prefetched.colIndices[i]);
+        }
     }
 
     if (m_labelsBuffer != NULL)
     {
         free(m_labelsBuffer);
     }
+
+    if (m_prefetched.labelsBuffer != NULL)
+    {
+        free(m_prefetched.labelsBuffer);
+    }
 }
 
 template <class ElemType>
@@ -97,6 +120,7 @@ void SparsePCReader<ElemType>::InitFromConfig(const ConfigRecordType& readerConf
     m_returnDense = readerConfig(L"returnDense", false);
     m_sparsenessFactor = readerConfig(L"sparsenessFactor", (size_t) 50); // We don't expect more than one in 50 input positions to have non-zero values
     m_verificationCode = (int32_t) readerConfig(L"verificationCode", (size_t) 0);
+    m_prefetchDepth = readerConfig(L"prefetchDepth", (size_t) 4); // minibatches of mapped-page readahead to advise
 
     std::vector<std::wstring> featureNames;
     std::vector<std::wstring> labelNames;
@@ -122,6 +146,9 @@ void SparsePCReader<ElemType>::InitFromConfig(const ConfigRecordType& readerConf
     m_values = std::vector<ElemType*>(m_featureCount);
     m_rowIndices = std::vector<int32_t*>(m_featureCount);
     m_colIndices = std::vector<int32_t*>(m_featureCount);
+    m_prefetched.values = std::vector<ElemType*>(m_featureCount);
+    m_prefetched.rowIndices = std::vector<int32_t*>(m_featureCount);
+    m_prefetched.colIndices = std::vector<int32_t*>(m_featureCount);
 
     for (int i = 0; i < m_featureCount; i++)
     {
@@ -177,6 +204,10 @@ void SparsePCReader<ElemType>::InitFromConfig(const ConfigRecordType& readerConf
 template <class ElemType>
 void SparsePCReader<ElemType>::StartMinibatchLoop(size_t mbSize, size_t /*epoch*/, size_t /*requestedEpochSamples*/)
 {
+    // a chunk parsed for the previous loop's position or minibatch size is of no use now
+    WaitForPrefetch();
+    m_prefetched.valid = false;
+
     if (m_values[0] == NULL || m_miniBatchSize != mbSize)
     {
         m_miniBatchSize = mbSize;
@@ -195,91 +226,196 @@ void SparsePCReader<ElemType>::StartMinibatchLoop(size_t mbSize, size_t /*epoch*
             m_rowIndices[i] = (int32_t*) malloc(sizeof(int32_t) * m_dims[i] * m_miniBatchSize / m_sparsenessFactor);
             m_colIndices[i] = (int32_t*) malloc(sizeof(int32_t) * (m_miniBatchSize + 1));
             m_labelsBuffer = (ElemType*) malloc(sizeof(ElemType) * m_miniBatchSize);
+
+            // the staging buffers mirror the front buffers exactly, so the two can be swapped
+            if (m_prefetched.values[i] != NULL)
+            {
+                free(m_prefetched.values[i]);
+                free(m_prefetched.colIndices[i]);
+                free(m_prefetched.rowIndices[i]);
+            }
+
+            m_prefetched.values[i] = (ElemType*) malloc(sizeof(ElemType) * m_dims[i] * m_miniBatchSize / m_sparsenessFactor);
+            m_prefetched.rowIndices[i] = (int32_t*) malloc(sizeof(int32_t) * m_dims[i] * m_miniBatchSize / m_sparsenessFactor);
+            m_prefetched.colIndices[i] = (int32_t*) malloc(sizeof(int32_t) * (m_miniBatchSize + 1));
         }
+
+        if (m_prefetched.labelsBuffer != NULL)
+            free(m_prefetched.labelsBuffer);
+        m_prefetched.labelsBuffer = (ElemType*) malloc(sizeof(ElemType) * m_miniBatchSize);
     }
 
     // reset the next read sample
     m_currOffset = 0;
+    m_currSampleIndex = 0;
+
+    // parse the first minibatch in the background right away, so the first TryGetMinibatch()
+    // of the sweep does not stall on the training thread either
+    ScheduleChunkPrefetch();
 }
 
-// GetMinibatch - Get the next minibatch (features and labels)
-// matrices - [in] a map with named matrix types (i.e. 'features', 'labels') mapped to the corresponding matrix,
-//             [out] each matrix resized if necessary containing data.
-// returns - true if there are more minibatches, false if no more minibatchs remain
+// ParseChunk - parse up to one minibatch's worth of sparse records from the mapping into the
+// given staging buffers, starting at 'startOffset'. This runs on the prefetch task, off the
+// training thread. While the first sweep is still indexing the stream, each record's file
+// offset is appended to m_sampleOffsets; once the index is complete, it is used here to advise
+// the OS to page in the mapped range covering the next m_prefetchDepth minibatches.
 template <class ElemType>
-bool SparsePCReader<ElemType>::TryGetMinibatch(StreamMinibatchInputs& matrices)
+void SparsePCReader<ElemType>::ParseChunk(int64_t startOffset, size_t startSample, PrefetchedChunk& chunk)
 {
-    // get out if they didn't call StartMinibatchLoop() first
-    if (m_miniBatchSize == 0)
-        return false;
-
-    // Return early (for debugging purposes)
-    if (m_maxReadData > 0 && m_currOffset >= m_maxReadData)
-        return false;
+    chunk.valid = false;
+    chunk.startOffset = startOffset;
+    chunk.startSample = startSample;
+    chunk.mbSize = m_miniBatchSize;
 
-    if (m_currOffset >= m_filePositionMax)
-        return false;
-
-    Matrix<ElemType>* labels = nullptr; // labels to return, or NULL if no labels in matrix set
-    if (matrices.HasInput(m_labelName))
+#ifndef SPARSE_PCREADER_USE_WINDOWS_API
+    if (m_indexComplete && startSample + 1 < m_sampleOffsets.size())
     {
-        labels = &matrices.GetInputMatrix<ElemType>(m_labelName);
-        if (labels->GetNumRows() != 1)
-            RuntimeError("SparsePCReader only supports single label value per column but the network expected %d.", (int) labels->GetNumRows());
+        size_t endSample = std::min(startSample + m_prefetchDepth * m_miniBatchSize, m_sampleOffsets.size() - 1);
+        int64_t pageSize = (int64_t) sysconf(_SC_PAGESIZE);
+        int64_t beg = m_sampleOffsets[startSample] & ~(pageSize - 1); // round down to a page boundary
+        posix_madvise((char*) m_dataBuffer + beg, (size_t) (m_sampleOffsets[endSample] - beg), POSIX_MADV_WILLNEED);
     }
+#endif
 
-    std::vector<int32_t> currIndex = std::vector<int32_t>(m_featureCount);
-    for (int i = 0; i < m_featureCount; i++)
-    {
-        currIndex[i] = 0;
-    }
+    int64_t offset = startOffset;
+    std::vector<int32_t> currIndex(m_featureCount, 0);
 
     size_t j = 0;
-
-    for (j = 0; j < m_miniBatchSize && m_currOffset < m_filePositionMax; j++)
+    for (j = 0; j < m_miniBatchSize && offset < m_filePositionMax; j++)
     {
+        if (startSample + j == m_sampleOffsets.size())
+            m_sampleOffsets.push_back(offset);
+
         for (int i = 0; i < m_featureCount; i++)
         {
-            m_colIndices[i][j] = currIndex[i];
+            chunk.colIndices[i][j] = currIndex[i];
 
-            int32_t nnz = *(int32_t*) ((char*) m_dataBuffer + m_currOffset);
-            m_currOffset += sizeof(int32_t);
+            int32_t nnz = *(int32_t*) ((char*) m_dataBuffer + offset);
+            offset += sizeof(int32_t);
 
             if (nnz > m_dims[i] / m_sparsenessFactor)
             {
                 RuntimeError("Input data is too dense - not enough memory allocated");
             }
 
-            memcpy(m_values[i] + currIndex[i], (char*) m_dataBuffer + m_currOffset, sizeof(ElemType) * nnz);
-            m_currOffset += (sizeof(ElemType) * nnz);
+            memcpy(chunk.values[i] + currIndex[i], (char*) m_dataBuffer + offset, sizeof(ElemType) * nnz);
+            offset += (sizeof(ElemType) * nnz);
 
-            memcpy(m_rowIndices[i] + currIndex[i], (char*) m_dataBuffer + m_currOffset, sizeof(int32_t) * nnz);
-            m_currOffset += (sizeof(int32_t) * nnz);
+            memcpy(chunk.rowIndices[i] + currIndex[i], (char*) m_dataBuffer + offset, sizeof(int32_t) * nnz);
+            offset += (sizeof(int32_t) * nnz);
 
             currIndex[i] += nnz;
         }
 
-        ElemType label = *(ElemType*) ((char*) m_dataBuffer + m_currOffset);
-        m_labelsBuffer[j] = label;
-        m_currOffset += sizeof(ElemType);
+        chunk.labelsBuffer[j] = *(ElemType*) ((char*) m_dataBuffer + offset);
+        offset += sizeof(ElemType);
 
         if (m_verificationCode != 0)
         {
-            int32_t verifCode = *(int32_t*) ((char*) m_dataBuffer + m_currOffset);
+            int32_t verifCode = *(int32_t*) ((char*) m_dataBuffer + offset);
 
             if (verifCode != m_verificationCode)
             {
                 RuntimeError("Verification code did not match (expected %d) - error in reading data", m_verificationCode);
-                return false;
             }
 
-            m_currOffset += sizeof(int32_t);
+            offset += sizeof(int32_t);
         }
     }
 
+    for (int i = 0; i < m_featureCount; i++)
+        chunk.colIndices[i][j] = currIndex[i];
+
+    chunk.nnzCounts.assign(currIndex.begin(), currIndex.end());
+    chunk.numSamples = j;
+    chunk.endOffset = offset;
+
+    if (offset >= m_filePositionMax && !m_indexComplete)
+    {
+        m_sampleOffsets.push_back(m_filePositionMax); // end sentinel: one past the last record
+        m_indexComplete = true;
+    }
+
+    chunk.valid = true;
+}
+
+// ScheduleChunkPrefetch - kick off the background parse of the next minibatch at the current
+// stream position; a no-op once the stream (or the maxReadData debugging cutoff) is exhausted
+template <class ElemType>
+void SparsePCReader<ElemType>::ScheduleChunkPrefetch()
+{
+    assert(!m_prefetchInflight.valid());
+    if (m_currOffset >= m_filePositionMax || (m_maxReadData > 0 && m_currOffset >= m_maxReadData))
+        return;
+
+    int64_t offset = m_currOffset;
+    size_t sample = m_currSampleIndex;
+    m_prefetchInflight = std::async(std::launch::async, [this, offset, sample]()
+                                    {
+                                        ParseChunk(offset, sample, m_prefetched);
+                                    });
+}
+
+// WaitForPrefetch - wait for a scheduled background parse; errors the parse hit in the data
+// (bad verification code, over-dense records) are rethrown here, on the training thread
+template <class ElemType>
+void SparsePCReader<ElemType>::WaitForPrefetch()
+{
+    if (m_prefetchInflight.valid())
+        m_prefetchInflight.get();
+}
+
+// GetMinibatch - Get the next minibatch (features and labels)
+// matrices - [in] a map with named matrix types (i.e. 'features', 'labels') mapped to the corresponding matrix,
+//             [out] each matrix resized if necessary containing data.
+// returns - true if there are more minibatches, false if no more minibatchs remain
+template <class ElemType>
+bool SparsePCReader<ElemType>::TryGetMinibatch(StreamMinibatchInputs& matrices)
+{
+    // get out if they didn't call StartMinibatchLoop() first
+    if (m_miniBatchSize == 0)
+        return false;
+
+    // Return early (for debugging purposes)
+    if (m_maxReadData > 0 && m_currOffset >= m_maxReadData)
+        return false;
+
+    if (m_currOffset >= m_filePositionMax)
+        return false;
+
+    Matrix<ElemType>* labels = nullptr; // labels to return, or NULL if no labels in matrix set
+    if (matrices.HasInput(m_labelName))
+    {
+        labels = &matrices.GetInputMatrix<ElemType>(m_labelName);
+        if (labels->GetNumRows() != 1)
+            RuntimeError("SparsePCReader only supports single label value per column but the network expected %d.", (int) labels->GetNumRows());
+    }
+
+    // pick up the prefetched chunk; if none matches the current stream position (first call
+    // ever, or the minibatch size changed under us), parse synchronously right here
+    WaitForPrefetch();
+    if (!m_prefetched.valid || m_prefetched.startOffset != m_currOffset || m_prefetched.mbSize != m_miniBatchSize)
+        ParseChunk(m_currOffset, m_currSampleIndex, m_prefetched);
+
+    // swap the staging buffers into the front buffers and advance the stream position
+    for (int i = 0; i < m_featureCount; i++)
+    {
+        std::swap(m_values[i], m_prefetched.values[i]);
+        std::swap(m_rowIndices[i], m_prefetched.rowIndices[i]);
+        std::swap(m_colIndices[i], m_prefetched.colIndices[i]);
+    }
+    std::swap(m_labelsBuffer, m_prefetched.labelsBuffer);
+    std::vector<int32_t> currIndex = m_prefetched.nnzCounts;
+    size_t j = m_prefetched.numSamples;
+    m_currOffset = m_prefetched.endOffset;
+    m_currSampleIndex += j;
+    m_prefetched.valid = false;
+
+    // parse the next minibatch in the background while the network trains on this one
+    ScheduleChunkPrefetch();
+
     for (int i = 0; i < m_featureCount; i++)
     {
-        m_colIndices[i][j] = currIndex[i];
         Matrix<ElemType>& features = matrices.GetInputMatrix<ElemType>(m_featureNames[i]);
 
         if (features.GetFormat() != MatrixFormat::matrixFormatSparseCSC)
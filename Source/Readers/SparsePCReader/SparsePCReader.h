@@ -12,6 +12,7 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <future>
 
 // Windows or Posix? Originally the reader was done only for Windows. Keep it this way for now when running on Windows.
 #ifdef __WINDOWS__
@@ -57,11 +58,48 @@ class SparsePCReader : public DataReaderBase
     std::map<LabelIdType, LabelType> m_mapIdToLabel;
     std::map<LabelType, LabelIdType> m_mapLabelToId;
 
+    // one minibatch's worth of CSC staging buffers, filled by a background parse task while
+    // the training thread consumes the previous minibatch from the front buffers above
+    struct PrefetchedChunk
+    {
+        std::vector<ElemType*> values;
+        std::vector<int32_t*> rowIndices;
+        std::vector<int32_t*> colIndices;
+        ElemType* labelsBuffer;
+        std::vector<int32_t> nnzCounts; // per-feature non-zero count of the chunk
+        size_t numSamples;
+        size_t mbSize;       // minibatch size the chunk was parsed with
+        int64_t startOffset; // file offset of the chunk's first record
+        int64_t endOffset;   // file offset one past the chunk's last record
+        size_t startSample;  // index within the sweep of the chunk's first sample
+        bool valid;
+    };
+    PrefetchedChunk m_prefetched;
+    std::future<void> m_prefetchInflight;
+
+    // record-offset index, built while the first sweep parses the stream; holds the file
+    // offset of every sample plus an end sentinel once complete. From the second sweep on
+    // it tells the parser how far ahead the next few minibatches reach in the mapping, so
+    // their pages can be advised in before the parse touches them.
+    std::vector<int64_t> m_sampleOffsets;
+    bool m_indexComplete;
+    size_t m_currSampleIndex;
+    size_t m_prefetchDepth; // minibatches of mapped-page readahead to advise
+
+    void ParseChunk(int64_t startOffset, size_t startSample, PrefetchedChunk& chunk);
+    void ScheduleChunkPrefetch();
+    void WaitForPrefetch();
+
 public:
     SparsePCReader()
         : m_pMBLayout(make_shared<MBLayout>())
     {
         m_pMBLayout->SetUniqueAxisName(L"SparsePCReader");
+        m_prefetched.labelsBuffer = NULL;
+        m_prefetched.valid = false;
+        m_indexComplete = false;
+        m_currSampleIndex = 0;
+        m_prefetchDepth = 4;
     };
     virtual ~SparsePCReader();
     virtual void Destroy();
@@ -53,7 +53,7 @@ class UCIFastReader : public DataReaderBase
     bool m_labelFirst;               // the label is the first element in a line
     bool m_partialMinibatch;         // a partial minibatch is allowed
     LabelKind m_labelType;           // labels are categories, create mapping table
-    RandomOrdering m_randomordering; // randomizing class
+    LazyRandomOrdering m_randomordering; // randomizing class; computes the permutation on the fly instead of materializing a table over the randomization window
 
     std::wstring m_labelsName;
     std::wstring m_featuresName;
@@ -10,6 +10,10 @@
 #include "UCIParser.h"
 #include <stdexcept>
 #include <stdint.h>
+#include <emmintrin.h> // for SSE2 delimiter/newline scanning in the projection skip path
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #if WIN32
 #define ftell64 _ftelli64
@@ -17,6 +21,66 @@
 #define ftell64 ftell
 #endif
 
+// FirstSetBit - index of the lowest set bit in a non-zero mask
+static inline size_t FirstSetBit(int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, (unsigned long) mask);
+    return (size_t) index;
+#else
+    return (size_t) __builtin_ctz((unsigned int) mask);
+#endif
+}
+
+// FindNextDelimiter - offset of the first delimiter (space, tab, CR, LF, or the custom
+// delimiter) in [p, p+len), or len if there is none; scans 16 bytes at a time
+static size_t FindNextDelimiter(const BYTE* p, size_t len, char customDelimiter)
+{
+    size_t offset = 0;
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i custom = _mm_set1_epi8(customDelimiter);
+    for (; offset + 16 <= len; offset += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (p + offset));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(bytes, cr), _mm_cmpeq_epi8(bytes, lf)));
+        if (customDelimiter != 0)
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(bytes, custom));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0)
+            return offset + FirstSetBit(mask);
+    }
+    for (; offset < len; offset++)
+    {
+        char ch = (char) p[offset];
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || (customDelimiter != 0 && ch == customDelimiter))
+            break;
+    }
+    return offset;
+}
+
+// FindNextNewline - offset of the first LF in [p, p+len), or len if there is none
+static size_t FindNextNewline(const BYTE* p, size_t len)
+{
+    size_t offset = 0;
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; offset + 16 <= len; offset += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i*) (p + offset));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, lf));
+        if (mask != 0)
+            return offset + FirstSetBit(mask);
+    }
+    for (; offset < len; offset++)
+        if (p[offset] == '\n')
+            break;
+    return offset;
+}
+
 // SetState for a particular value
 template <typename NumType, typename LabelType>
 void UCIParser<NumType, LabelType>::SetState(int value, ParseState current_state, ParseState next_state)
@@ -263,6 +327,8 @@ void UCIParser<NumType, LabelType>::Init(char customDelimiter, char customDecima
     PrepareStartPosition(0);
     m_fileBuffer = NULL;
     m_pFile = NULL;
+    m_customDelimiter = customDelimiter;
+    m_lastColumnNeeded = 0;
     m_stateTable = new DWORD[AllStateMax * 256];
     SetupStateTables(customDelimiter, customDecimalPoint);
 }
@@ -387,6 +453,13 @@ void UCIParser<NumType, LabelType>::ParseInit(LPCWSTR/*TODO: change to C++ type*
     m_bufferSize = bufferSize;
     m_bufferStart = startPosition;
 
+    // past this column the remainder of each row can be skipped wholesale
+    m_lastColumnNeeded = 0;
+    if (m_dimLabels > 0)
+        m_lastColumnNeeded = m_startLabels + m_dimLabels;
+    if (m_dimFeatures > 0)
+        m_lastColumnNeeded = std::max(m_lastColumnNeeded, m_startFeatures + m_dimFeatures);
+
     // if we have a file already open, cleanup
     if (m_pFile != NULL)
         UCIParser<NumType, LabelType>::~UCIParser();
@@ -467,10 +540,8 @@ size_t UCIParser<NumType, LabelType>::UpdateBuffer()
     size_t saveBytes = m_byteCounter - m_spaceDelimitedStart;
     assert(saveBytes < m_bufferSize);
     if (saveBytes)
-    {
         memcpy_s(m_fileBuffer, m_bufferSize, &m_fileBuffer[m_byteCounter - m_bufferStart - saveBytes], saveBytes);
-        m_bufferStart = m_byteCounter - saveBytes;
-    }
+    m_bufferStart = m_byteCounter - saveBytes; // also advance when there is nothing to look back at
 
     // read the next block
     size_t bytesToRead = min(m_bufferSize, m_fileSize - m_bufferStart) - saveBytes;
@@ -536,6 +607,45 @@ long UCIParser<NumType, LabelType>::Parse(size_t recordsRequested, std::vector<N
 
         char ch = m_fileBuffer[bufferIndex];
 
+        // projection pushdown: a token that starts in a column no consumer selected does not
+        // need numeric conversion; skip it at the delimiter level instead. Once past the last
+        // selected column, the rest of the line is skipped in a single newline scan.
+        if (m_parseMode == ParseNormal && m_numbers != NULL &&
+            (m_current_state == Whitespace || m_current_state == EndOfLine))
+        {
+            ParseState entryState = (ParseState) m_stateTable[(m_current_state << 8) + ch];
+            // at end-of-line the counter still holds the previous line's total; the token we
+            // are looking at is column zero of the next line
+            size_t column = (m_current_state == EndOfLine) ? 0 : (size_t) m_elementsConvertedThisLine;
+            if (entryState != Whitespace && entryState != EndOfLine && !NeedColumn(column))
+            {
+                if (m_current_state == EndOfLine) // we step over the start-of-line transition ourselves
+                    PrepareStartLine();
+                bool pastLastNeeded = column >= m_lastColumnNeeded;
+                m_spaceDelimitedStart = m_byteCounter; // no look-back into skipped bytes
+                for (;;)
+                {
+                    if (bufferIndex >= m_bufferSize)
+                    {
+                        UpdateBuffer();
+                        bufferIndex = m_byteCounter - m_bufferStart;
+                    }
+                    size_t avail = min((size_t)(m_fileSize - m_byteCounter), m_bufferSize - bufferIndex);
+                    size_t skipped = pastLastNeeded
+                                         ? FindNextNewline(&m_fileBuffer[bufferIndex], avail)
+                                         : FindNextDelimiter(&m_fileBuffer[bufferIndex], avail, m_customDelimiter);
+                    m_byteCounter += skipped;
+                    bufferIndex += skipped;
+                    m_spaceDelimitedStart = m_byteCounter;
+                    if (skipped < avail || m_byteCounter >= m_fileSize)
+                        break;
+                }
+                m_elementsConvertedThisLine++; // count the skipped token (not meaningful after a whole-line skip)
+                m_current_state = Whitespace;
+                continue; // reprocess the delimiter we stopped on through the state machine
+            }
+        }
+
         ParseState nextState = (ParseState) m_stateTable[(m_current_state << 8) + ch];
 
         if (nextState <= Exponent)
@@ -65,6 +65,18 @@ private:
     size_t m_startFeatures;
     size_t m_dimFeatures;
 
+    // projection pushdown: columns outside the selected label/feature ranges are skip-scanned
+    // at the delimiter level in Parse() instead of run through the numeric state machine
+    char m_customDelimiter;
+    size_t m_lastColumnNeeded; // one past the last column any consumer selected
+
+    // NeedColumn - does any consumer select the given (zero-based) column?
+    bool NeedColumn(size_t index) const
+    {
+        return (m_startLabels <= index && index < m_startLabels + m_dimLabels) ||
+               (m_startFeatures <= index && index < m_startFeatures + m_dimFeatures);
+    }
+
     // level of screen output
     int m_traceLevel;
 
@@ -594,6 +594,192 @@ private:
 
 #endif 
 
+// MpiAsgdHelper implements the ASGDHelper interface on plain MPI one-sided operations, for
+// builds without Multiverso. Every rank hosts one shard of the flattened parameter vector in an
+// MPI window; a worker pushes its update as an MPI_Accumulate of (current model - model at last
+// pull) into each shard and pulls the current model back with MPI_Get, all under passive-target
+// locks, so no rank ever has to enter a matching receive -- workers proceed at their own pace.
+// Staleness is bounded by the sync period (nSyncSamplesPerWorker): a worker's update is at most
+// one period behind by the time it lands on the shards.
+template<class ElemType = float>
+class MpiAsgdHelper : public ASGDHelper<ElemType>
+{
+public:
+    typedef shared_ptr<ComputationNode<ElemType>> ComputationNodePtr;
+
+    MpiAsgdHelper(const std::list<ComputationNodeBasePtr> & learnableNodes,
+        size_t nodeNumRanks,
+        bool useAsyncBuffer = true,
+        bool isSimulatedModelAveragingSGD = false,
+        AdjustLearningRateAtBeginning adjusttype = AdjustLearningRateAtBeginning::None,
+        double adjustcoef = 0.2,
+        size_t adjustnbmb = 600,
+        int traceLevel = 0,
+        int syncPerfStats = 0) :
+        m_parameterSyncCounter(0), m_totalClientNumber(nodeNumRanks), m_traceLevel(traceLevel),
+        m_syncPerfStats(syncPerfStats), m_totalModelSize(0), m_window(MPI_WIN_NULL), m_shardBuffer(nullptr)
+    {
+        UNUSED(isSimulatedModelAveragingSGD); UNUSED(adjusttype); UNUSED(adjustcoef); UNUSED(adjustnbmb);
+        if (useAsyncBuffer && traceLevel > 0)
+            fprintf(stderr, "MpiAsgdHelper: UsePipeline is not supported by the MPI parameter server; continuing synchronously.\n");
+
+        m_pMPI = MPIWrapper::GetInstance();
+        if (m_pMPI == nullptr)
+            RuntimeError("MpiAsgdHelper: DataParallelASGD requires MPI (run through mpiexec).");
+
+        // flatten the model: record each parameter's length and offset in the flat vector
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            size_t layerSize = node->Value().GetNumElements();
+            m_tableLength.push_back(layerSize);
+            m_tableOffsets.push_back(m_totalModelSize);
+            m_totalModelSize += layerSize;
+        }
+
+        // split the flat vector into one contiguous shard per rank
+        size_t shardStride = (m_totalModelSize + nodeNumRanks - 1) / nodeNumRanks;
+        for (size_t r = 0; r < nodeNumRanks; r++)
+        {
+            size_t begin = std::min(r * shardStride, m_totalModelSize);
+            size_t end = std::min(begin + shardStride, m_totalModelSize);
+            m_shardOffsets.push_back(begin);
+            m_shardSizes.push_back(end - begin);
+        }
+
+        size_t myShardSize = m_shardSizes[m_pMPI->CurrentNodeRank()];
+        MPI_Win_allocate((MPI_Aint)(myShardSize * sizeof(ElemType)), (int)sizeof(ElemType),
+                         MPI_INFO_NULL, m_pMPI->Communicator(), &m_shardBuffer, &m_window)
+            || MpiFail("MpiAsgdHelper: MPI_Win_allocate");
+
+        m_currentModel.resize(m_totalModelSize);
+        m_lastPulledModel.resize(m_totalModelSize);
+
+        if (m_traceLevel > 0)
+            fprintf(stderr, "MpiAsgdHelper: initialized, %d workers, model size %d, shard size %d\n",
+                    (int)nodeNumRanks, (int)m_totalModelSize, (int)myShardSize);
+    }
+
+    ~MpiAsgdHelper()
+    {
+        if (m_window != MPI_WIN_NULL)
+            MPI_Win_free(&m_window);
+    }
+
+    void InitModel(const std::list<ComputationNodeBasePtr> & learnableNodes) override
+    {
+        // rank 0's parameters win; everyone starts from, and measures deltas against, that model
+        CopyModelToFlatBuffer(learnableNodes, m_currentModel.data());
+        m_pMPI->Bcast(m_currentModel.data(), m_totalModelSize, m_pMPI->MainNodeRank());
+
+        size_t myRank = m_pMPI->CurrentNodeRank();
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, (int)myRank, 0, m_window)
+            || MpiFail("MpiAsgdHelper: MPI_Win_lock");
+        memcpy(m_shardBuffer, m_currentModel.data() + m_shardOffsets[myRank],
+               m_shardSizes[myRank] * sizeof(ElemType));
+        MPI_Win_unlock((int)myRank, m_window) || MpiFail("MpiAsgdHelper: MPI_Win_unlock");
+
+        m_lastPulledModel = m_currentModel;
+        CopyFlatBufferToModel(m_lastPulledModel.data(), learnableNodes);
+
+        // no rank may start pushing before every shard holds the initial model
+        WaitAll();
+        if (m_traceLevel > 0)
+            fprintf(stderr, "MpiAsgdHelper: initial model loaded.\n");
+        m_reportTimer.Start();
+    }
+
+    bool PushAndPullModel(const std::list<ComputationNodeBasePtr> & learnableNodes, size_t sampleSinceLastSynced) override
+    {
+        UNUSED(sampleSinceLastSynced);
+        m_parameterSyncCounter++;
+        m_reportTimer.Restart();
+
+        CopyModelToFlatBuffer(learnableNodes, m_currentModel.data());
+
+        // this worker's contribution since its last pull
+        for (size_t k = 0; k < m_totalModelSize; k++)
+            m_currentModel[k] -= m_lastPulledModel[k];
+
+        // push the delta into each shard and read the updated shard back; the flush orders the
+        // get after the accumulate within the same passive-target epoch
+        MPI_Datatype dtype = MPIWrapper::GetDataType((ElemType*)nullptr);
+        for (size_t r = 0; r < m_totalClientNumber; r++)
+        {
+            if (m_shardSizes[r] == 0)
+                continue;
+            MPI_Win_lock(MPI_LOCK_SHARED, (int)r, 0, m_window) || MpiFail("MpiAsgdHelper: MPI_Win_lock");
+            MPI_Accumulate(m_currentModel.data() + m_shardOffsets[r], (int)m_shardSizes[r], dtype,
+                           (int)r, 0, (int)m_shardSizes[r], dtype, MPI_SUM, m_window)
+                || MpiFail("MpiAsgdHelper: MPI_Accumulate");
+            MPI_Win_flush((int)r, m_window) || MpiFail("MpiAsgdHelper: MPI_Win_flush");
+            MPI_Get(m_lastPulledModel.data() + m_shardOffsets[r], (int)m_shardSizes[r], dtype,
+                    (int)r, 0, (int)m_shardSizes[r], dtype, m_window)
+                || MpiFail("MpiAsgdHelper: MPI_Get");
+            MPI_Win_unlock((int)r, m_window) || MpiFail("MpiAsgdHelper: MPI_Win_unlock");
+        }
+
+        CopyFlatBufferToModel(m_lastPulledModel.data(), learnableNodes);
+
+        m_reportTimer.Stop();
+        if (m_traceLevel > 2 && m_syncPerfStats > 0 && m_parameterSyncCounter % m_syncPerfStats == 0)
+            fprintf(stderr, "MpiAsgdHelper: sync %d took %.6gs\n",
+                    (int)m_parameterSyncCounter, m_reportTimer.ElapsedSeconds());
+        return true;
+    }
+
+    void WaitAll() override
+    {
+        m_pMPI->WaitAll();
+    }
+
+    void WaitAsyncBuffer() override { } // synchronous helper: nothing in flight between syncs
+
+private:
+    void CopyModelToFlatBuffer(const std::list<ComputationNodeBasePtr> & learnableNodes, ElemType* buffer)
+    {
+        int i = 0;
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, i++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            ElemType* px = buffer + m_tableOffsets[i];
+            size_t length = m_tableLength[i];
+            node->Value().CopyToArray(px, length); // (buffer is pre-sized, so no reallocation happens)
+        }
+    }
+
+    void CopyFlatBufferToModel(const ElemType* buffer, const std::list<ComputationNodeBasePtr> & learnableNodes)
+    {
+        int i = 0;
+        for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++, i++)
+        {
+            ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+            Matrix<ElemType> &mat = node->Value();
+            mat.SetValue(mat.GetNumRows(), mat.GetNumCols(), mat.GetDeviceId(),
+                         const_cast<ElemType*>(buffer + m_tableOffsets[i]));
+        }
+    }
+
+    MPIWrapperPtr m_pMPI;
+    size_t m_totalClientNumber;
+    int m_traceLevel;
+    int m_syncPerfStats;
+    Timer m_reportTimer;
+    size_t m_parameterSyncCounter;
+
+    vector<size_t> m_tableLength;
+    vector<size_t> m_tableOffsets;
+    size_t m_totalModelSize;
+    vector<size_t> m_shardOffsets; // first flat-vector element hosted by each rank
+    vector<size_t> m_shardSizes;   // number of elements hosted by each rank
+
+    MPI_Win m_window;              // exposes this rank's shard to all workers
+    ElemType* m_shardBuffer;       // window memory, owned by MPI_Win_allocate
+
+    std::vector<ElemType> m_currentModel;    // scratch: flattened local model, then the pushed delta
+    std::vector<ElemType> m_lastPulledModel; // model as of the last pull; baseline for the next delta
+};  // Class MpiAsgdHelper
+
 // A None implementation of ASGDHelper interface which does nothing
 // This is used when CNTK_ENABLE_ASGD = false
 template<class ElemType = float>
@@ -640,6 +826,11 @@ ASGDHelper<ElemType>* NewASGDHelper(
     return new MultiversoHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD, 
                                       adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats);
 #else
+    // without Multiverso, serve the parameters in-tree over MPI one-sided operations when MPI is
+    // up; the no-op helper remains for single-process runs
+    if (MPIWrapper::GetInstance() != nullptr)
+        return new MpiAsgdHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD,
+                                      adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats);
     return new NoneASGDHelper<ElemType>(learnableNodes, nodeNumRanks, useAsyncBuffer, isSimulatedModelAveragingSGD, 
                                       adjusttype, adjustCoef, adjustPerMinibatches, traceLevel, syncPerfStats); 
 #endif
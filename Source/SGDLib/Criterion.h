@@ -109,6 +109,24 @@ struct CriterionAccumulator
         else
             return EpochCriterion(m_aggregateCriterionValues->GetValue(0, i), m_aggregateSampleCounts[i]);
     }
+    // retrieve all accumulated results at once
+    // GetCriterion() above syncs the device once per element; this variant pulls the whole
+    // accumulator row in a single device-to-host transfer, which matters when several criteria
+    // are read out per aggregation or logging step.
+    std::vector<EpochCriterion> GetCriteria() const
+    {
+        std::vector<EpochCriterion> criteria(m_aggregateSampleCounts.size(), EpochCriterion(0, 0));
+        bool anySamples = false;
+        for (size_t i = 0; i < m_aggregateSampleCounts.size(); i++)
+            anySamples |= (m_aggregateSampleCounts[i] != 0);
+        if (!anySamples)
+            return criteria; // avoid unnecessary GPU access
+        std::unique_ptr<ElemType[]> values(m_aggregateCriterionValues->CopyToArray()); // single transfer; matrix is [1 x N]
+        for (size_t i = 0; i < criteria.size(); i++)
+            if (m_aggregateSampleCounts[i] != 0) // (if count is zero, the value is invalid and must not be looked at)
+                criteria[i] = EpochCriterion(values[i], m_aggregateSampleCounts[i]);
+        return criteria;
+    }
 
 private:
     // shared part of Add() and Assign()
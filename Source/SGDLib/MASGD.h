@@ -12,11 +12,15 @@
 #include "Matrix.h"
 #include "MPIWrapper.h"
 #include "TimerUtility.h"
+#include "ColumnQuantizer.h"
+#include "QuantizedMatrix.h"
 #include <vector>
 #include <string>
 #include <stdexcept>
-#include <chrono> 
+#include <chrono>
 #include <random>
+#include <map>
+#include <cstring>
 
 
 namespace Microsoft { namespace MSR { namespace CNTK {
@@ -202,6 +206,13 @@ namespace Microsoft { namespace MSR { namespace CNTK {
          
          virtual void SaveToCheckPoint(File& fstream){}
          virtual void LoadFromCheckPoint(File& fstream){}
+
+         // block size (in samples per worker) to use until the next sync; implementations may
+         // stretch it at runtime, e.g. when communication dominates the sync interval
+         virtual size_t RecommendedBlockSizePerWorker(size_t configuredBlockSizePerWorker) const
+         {
+             return configuredBlockSizePerWorker;
+         }
          
 
     protected:
@@ -332,10 +343,20 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         using Base::DownCast;
 
     public:
-        BasicModelAveragingSGD(const MPIWrapperPtr& pMPI, size_t reportFreq, DEVICEID_TYPE devID)
-            : Base(pMPI, reportFreq, devID)
+        BasicModelAveragingSGD(const MPIWrapperPtr& pMPI, size_t reportFreq, DEVICEID_TYPE devID, size_t deltaBits = 0, bool autoAdjustSyncPeriod = false)
+            : Base(pMPI, reportFreq, devID), m_deltaBits(deltaBits), m_autoAdjustSyncPeriod(autoAdjustSyncPeriod), m_syncPeriodMultiplier(1)
         {
             fprintf(stderr, "Parallel training (%d workers) using ModelAveraging\n",(int)m_pMPI->NumNodesInUse());
+            if (m_deltaBits > 0)
+                fprintf(stderr, "ModelAveraging: exchanging %d-bit quantized model deltas\n", (int)m_deltaBits);
+            if (m_autoAdjustSyncPeriod)
+                fprintf(stderr, "ModelAveraging: sync period will be auto-adjusted based on measured communication time\n");
+            m_intervalTimer.Start();
+        }
+
+        size_t RecommendedBlockSizePerWorker(size_t configuredBlockSizePerWorker) const override
+        {
+            return configuredBlockSizePerWorker * m_syncPeriodMultiplier;
         }
 
         void ModelAggregationProcessing(
@@ -383,25 +404,131 @@ namespace Microsoft { namespace MSR { namespace CNTK {
                 }
                 // 2.1 model averaging
                 auto pNode = DownCast(pBaseNode);
-                // 2.1.1. average model from individual models 
+                // 2.1.1. average model from individual models
                 Matrix<ElemType> mat(pNode->Value().DeepClone()); // pNode->Value returns lvalue, so a deep copy is invoked here
-                // 2.1.2. normalize the weight matrix 
-                Matrix<ElemType>::Scale(factor, mat);
-                // 2.1.3. send weight matrix over MPI nodes; 
+                size_t nx = mat.GetNumElements();
+
+                // quantized-delta exchange needs the last synced model on this node; the very
+                // first sync (and the first one after a restart) goes full precision to
+                // establish it
+                DeltaState& state = m_deltaState[pBaseNode->NodeName()];
+                if ((m_deltaBits == 0) || (state.lastSynced.size() != nx))
+                {
+                    // 2.1.2. normalize the weight matrix
+                    Matrix<ElemType>::Scale(factor, mat);
+                    // 2.1.3. send weight matrix over MPI nodes;
+                    unique_ptr<ElemType[]> px(mat.CopyToArray());
+                    // 2.1.4. inplace sum
+                    commTimer.Restart();
+                    m_pMPI->AllReduce(px.get(), nx);
+                    commTimer.Stop();
+                    secondsOnCommunication += (float)commTimer.ElapsedSeconds();
+                    // 2.1.5. set value
+                    pNode->Value().SetValue(mat.GetNumRows(), mat.GetNumCols(), mat.GetDeviceId(), px.get());
+
+                    if (m_deltaBits > 0)
+                    {
+                        state.lastSynced.assign(px.get(), px.get() + nx);
+                        state.residual.assign(nx, (ElemType) 0);
+                    }
+                    continue;
+                }
+
+                // Quantized-delta exchange: every worker left the last sync holding the
+                // identical model W, so the average sum_r factor_r * W_r equals
+                // W + sum_r factor_r * (W_r - W). Only the weighted deltas travel, quantized
+                // per column through ColumnQuantizer; the quantization error is carried in a
+                // residual and folded into the next sync (error feedback), so no update mass
+                // is lost, merely delayed.
+                size_t nRow = mat.GetNumRows();
+                size_t nCol = mat.GetNumCols();
                 unique_ptr<ElemType[]> px(mat.CopyToArray());
-                //ElemType* px = mat.CopyToArray();
-                size_t    nx = mat.GetNumElements();
-                // 2.1.4. inplace sum 
+                for (size_t i = 0; i < nx; i++)
+                    px[i] = (ElemType)(factor * (px[i] - state.lastSynced[i]));
+
+                const size_t ldNbits = ValueQuantizer<ElemType>::ld(m_deltaBits);
+                const size_t qColSize = QuantizedColumn<ElemType>::QuantizedColumnSize(m_deltaBits, nRow);
+                std::vector<char> sendBuf(qColSize * nCol);
+                for (size_t j = 0; j < nCol; j++)
+                {
+                    auto& qcol = *(QuantizedColumn<ElemType>*)(sendBuf.data() + (j * qColSize));
+                    // Explicit use of 'template' keyword is needed to compile with GCC
+                    ColumnQuantizer<ElemType>::template ComputeRangeStatColj<false>(px.get(), state.residual.data(), (long) nRow, j, m_deltaBits, qcol.lower, qcol.upper);
+                    ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
+                    q.template Quantize<false>(px.get(), state.residual.data(), (long) nRow, j, qcol.bits, state.residual.data());
+                }
+
+                // quantized code words cannot be summed in flight, so gather every worker's
+                // quantized deltas and unquantize-accumulate them locally
+                std::vector<char> recvBuf(sendBuf.size() * m_pMPI->NumNodesInUse());
                 commTimer.Restart();
-                m_pMPI->AllReduce(px.get(), nx);
+                MPI_Allgather(sendBuf.data(), (int)sendBuf.size(), MPI_CHAR, recvBuf.data(), (int)sendBuf.size(), MPI_CHAR, m_pMPI->Communicator()) || MpiFail("ModelAveraging: MPI_Allgather");
                 commTimer.Stop();
                 secondsOnCommunication += (float)commTimer.ElapsedSeconds();
-                // 2.1.5. set value 
-                pNode->Value().SetValue(mat.GetNumRows(), mat.GetNumCols(), mat.GetDeviceId(), px.get());
-                // 2.1.6. clean up 
-                //delete[]px;
+
+                // reconstruct: start from the last synced model and add every worker's delta
+                memcpy(px.get(), state.lastSynced.data(), nx * sizeof(ElemType));
+                for (size_t r = 0; r < m_pMPI->NumNodesInUse(); r++)
+                {
+                    const char* rankBuf = recvBuf.data() + (r * sendBuf.size());
+                    for (size_t j = 0; j < nCol; j++)
+                    {
+                        auto& qcol = *(QuantizedColumn<ElemType>*)(rankBuf + (j * qColSize));
+                        ColumnQuantizer<ElemType> q(ldNbits, qcol.lower, qcol.upper);
+                        q.Unquantize(px.get(), (long) nRow, j, qcol.bits, true /*add*/);
+                    }
+                }
+
+                pNode->Value().SetValue(nRow, nCol, mat.GetDeviceId(), px.get());
+                memcpy(state.lastSynced.data(), px.get(), nx * sizeof(ElemType));
+            }
+
+            //----------------------------------------
+            // 3. optionally adapt the sync period to the measured exchange time
+            //----------------------------------------
+            if (m_autoAdjustSyncPeriod)
+            {
+                m_intervalTimer.Stop();
+                double stats[2] = { (double)secondsOnCommunication, m_intervalTimer.ElapsedSeconds() };
+                // use the same measurement on every worker so their sync periods stay in lock-step
+                commTimer.Restart();
+                m_pMPI->AllReduce(stats, 2, MPI_MAX);
+                commTimer.Stop();
+                secondsOnCommunication += (float)commTimer.ElapsedSeconds();
+
+                if (stats[1] > 0)
+                {
+                    double commFraction = stats[0] / stats[1];
+                    if ((commFraction > 0.10) && (m_syncPeriodMultiplier < 8))
+                    {
+                        m_syncPeriodMultiplier *= 2;
+                        fprintf(stderr, "ModelAveraging: communication took %.1f%% of the last sync interval, stretching the sync period to %dx the configured block size\n",
+                                commFraction * 100.0, (int)m_syncPeriodMultiplier);
+                    }
+                    else if ((commFraction < 0.025) && (m_syncPeriodMultiplier > 1))
+                    {
+                        m_syncPeriodMultiplier /= 2;
+                        fprintf(stderr, "ModelAveraging: communication took %.1f%% of the last sync interval, relaxing the sync period to %dx the configured block size\n",
+                                commFraction * 100.0, (int)m_syncPeriodMultiplier);
+                    }
+                }
+                m_intervalTimer.Restart();
             }
         }
+
+    private:
+        // per-parameter state for the quantized-delta exchange
+        struct DeltaState
+        {
+            std::vector<ElemType> lastSynced; // the model all workers held after the last sync
+            std::vector<ElemType> residual;   // quantization error carried over to the next sync
+        };
+        std::map<std::wstring, DeltaState> m_deltaState;
+
+        size_t m_deltaBits;             // bit width of the quantized deltas (0 = full-precision exchange)
+        bool   m_autoAdjustSyncPeriod;  // stretch/relax the sync period based on measured comm time
+        size_t m_syncPeriodMultiplier;  // current stretch factor applied to the configured block size
+        Timer  m_intervalTimer;         // wall time between consecutive syncs
     };
 
 } } }
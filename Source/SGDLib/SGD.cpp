@@ -9,8 +9,10 @@
 #define _CRT_SECURE_NO_WARNINGS // "secure" CRT not available on all platforms  --add this at the top of all CPP files that give "function or variable may be unsafe" warnings
 
 #include "Basics.h"
+#include "Globals.h" // for per-node profiling flag
 #include "SGD.h"
 #include "NonlinearityNodes.h"          // for DropoutNode
+#include "PreComputeNodes.h"            // for MeanInvStdDevNodeBase
 #include "SpecialPurposeNodes.h"        // for SequenceWithSoftmaxNode
 #include "DataReaderHelpers.h"
 #include "MatrixQuantizerImpl.h"
@@ -31,6 +33,7 @@
 #include "ASGDHelper.h"
 
 #include "SimpleDistGradAggregator.h"
+#include "TopKDistGradAggregator.h"
 #include "V2SimpleDistGradAggregator.h"
 #include "ProgressTracing.h"
 #include "PerformanceProfiler.h"
@@ -181,6 +184,22 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         m_enableDistributedMBReading = true;
     }
 
+    // Optional MPI communication timeline: time every collective, periodically report the
+    // per-rank wait/transfer split, and name stragglers in the training log when the
+    // measured arrival skew exceeds the configured threshold.
+    if (m_mpi != nullptr && m_commTimingInterval > 0)
+    {
+        m_mpi->EnableCommTiming(m_commTimingInterval);
+        if (m_commSkewWarningThreshold > 0)
+        {
+            m_mpi->SetImbalanceHook(m_commSkewWarningThreshold, [](int slowestRank, double skewSeconds)
+            {
+                LOGPRINTF(stderr, "WARNING: MPI arrival skew of %.3f ms per collective exceeds the configured threshold; slowest rank: %d\n",
+                          1e3 * skewSeconds, slowestRank);
+            });
+        }
+    }
+
     // determine evaluationNodes from GetEvalCriterionNodes(), ensuring each criterion is only logged once
     std::vector<ComputationNodeBasePtr> evaluationNodes;
     {
@@ -215,6 +234,18 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
     auto preComputeNodesList = net->GetNodesRequiringPreComputation();
     additionalNodesToEvaluate.insert(additionalNodesToEvaluate.end(), preComputeNodesList.cbegin(), preComputeNodesList.cend());
 
+    // spread the network over the configured pipeline-stage devices
+    // This must happen before matrices are allocated, since pooled buffers are requested
+    // on whatever device each node has at allocation time.
+    if (m_pipelineDevices.size() >= 2)
+    {
+        if (m_mpi != nullptr)
+            InvalidArgument("pipelineDevices cannot be combined with parallel training.");
+        std::vector<DEVICEID_TYPE> stageDevices(m_pipelineDevices.begin(), m_pipelineDevices.end());
+        net->PartitionIntoPipelineStages(stageDevices);
+        net->CompileNetwork(); // partitioning edits the graph; recompile before allocating
+    }
+
     // allocate memory for forward and backward computation
     net->AllocateAllMatrices(evaluationNodes, additionalNodesToEvaluate, criterionNodes[0]); // TODO: use criterionNodes.front() throughout
 
@@ -283,7 +314,7 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         // V2 API fixes this.
         smoothedGradients.push_back(Matrix<ElemType>(node->Value().GetNumRows(),
                                                      node->Value().GetNumCols(),
-                                                     net->GetDeviceId()));
+                                                     node->Value().GetDeviceId())); // (node device, not net device: stages of a pipelined net live on different devices)
         smoothedCounts.push_back(0);
         if (node->IsParameterUpdateRequired())
         {
@@ -509,7 +540,15 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         // basis for a set number of epochs.  For epochs after that point, m_mbSize.size(), either
         // we just keep using
         // the last minibatch size, or we use tuning to try and find a better one.
-        if (m_autoAdjustMinibatch && i >= m_mbSize.size())
+        if (m_autoAdjustMinibatch && m_autoAdjustMinibatchByThroughput && i >= m_mbSize.size())
+        {
+            // continuous controller: no trial epochs, hill-climb on the previous epoch's measured samples/sec
+            chosenMinibatchSize = ThroughputAdaptiveMinibatchSizing(i, m_mbSize[i]);
+            if (m_traceLevel < 1 && chosenMinibatchSize != m_prevChosenMinibatchSize)
+                LOGPRINTF(stderr, "Minibatch size adapted to %d.\n", (int)chosenMinibatchSize);
+            m_prevChosenMinibatchSize = chosenMinibatchSize;
+        }
+        else if (m_autoAdjustMinibatch && i >= m_mbSize.size())
         {
             size_t numFramesToUseInSearch = m_numSamples4Search[i];
             if (m_epochSize != requestDataSize)
@@ -580,6 +619,11 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         timer.Stop();
         double epochTime = timer.ElapsedSeconds();
 
+        // record this epoch's measured throughput for the throughput-driven minibatch controller
+        m_lastEpochMBSize = chosenMinibatchSize;
+        m_lastEpochSamplesPerSecond = (epochTime > 0) ? ((double)epochCriterion.second / epochTime) : 0.0;
+        m_lastEpochLoss = epochCriterion.Average();
+
         if (m_useEvalCriterionControlLR && epochEvalErrors.size() > 0)
             lrControlCriterion = epochEvalErrors[0].Average();
         else
@@ -604,6 +648,57 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         }
 #endif
 
+        // ---- epoch-boundary pipelining ----
+        // The work between two epochs -- cross-validation, persisting the model, and restarting
+        // the training reader -- uses disjoint resources (GPU, disk, reader I/O), so overlap
+        // whatever the learning-rate controller below cannot invalidate anymore.
+        size_t epochsSinceLastLearnRateAdjust = i % m_learnRateAdjustInterval + 1;
+
+        // The controller can roll back the model or pick a different epoch to continue from only
+        // in epochs where the AdjustAfterEpoch decision is due. Everywhere else the model we save
+        // for this epoch is final already, so hand the write to the background checkpoint thread
+        // and let it overlap with the validation pass. The parameters are not updated again until
+        // the next epoch trains, and the persist section below waits for the write first.
+        bool lrAdjustmentDue = m_autoLearnRateSearchType == LearningRateSearchAlgorithm::AdjustAfterEpoch &&
+                               m_learningRatesParam.size() <= i &&
+                               epochsSinceLastLearnRateAdjust == m_learnRateAdjustInterval;
+        bool modelPersistedBeforeValidation = false;
+        if (m_asyncCheckpointing && !lrAdjustmentDue && !std::isnan(lrControlCriterion) &&
+            ((m_mpi == nullptr) || m_mpi->IsMainNode()))
+        {
+            WaitForPendingCheckpoint();
+            auto modelName = GetModelNameForEpoch(i);
+            if (m_traceLevel > 0)
+                LOGPRINTF(stderr, "SGD: Saving checkpoint model '%ls' on the background thread\n", modelName.c_str());
+            m_pendingCheckpointWrite = std::async(std::launch::async, [=]()
+            {
+                net->Save(modelName);
+            });
+            modelPersistedBeforeValidation = true;
+        }
+
+        // Restart the training reader for the next epoch right away, so that its chunk prefetch
+        // overlaps with validation and checkpointing as well. This is only safe when nothing
+        // between here and the next TrainOneEpoch() can change which epoch runs next or with
+        // which minibatch size, and only pays off for the new (prefetching) reader stack.
+        if (i + 1 < (int) m_maxEpochs && !trainSetDataReader->IsLegacyReader() &&
+            m_autoLearnRateSearchType == LearningRateSearchAlgorithm::None && !m_autoAdjustMinibatch)
+        {
+            bool nextUseDistributedMBReading = UsingParallelTrain(i + 1) &&
+                                               m_enableDistributedMBReading &&
+                                               trainSetDataReader->SupportsDistributedMBRead();
+            if (nextUseDistributedMBReading)
+            {
+                trainSetDataReader->StartDistributedMinibatchLoop(m_mbSize[i + 1], i + 1, m_mpi->CurrentNodeRank(),
+                    m_mpi->NumNodesInUse(), inputMatrices->GetStreamDescriptions(), m_epochSize);
+            }
+            else
+            {
+                trainSetDataReader->StartMinibatchLoop(m_mbSize[i + 1], i + 1, inputMatrices->GetStreamDescriptions(), m_epochSize);
+            }
+            m_prestartedReaderEpoch = i + 1;
+        }
+
         if (validationSetDataReader != trainSetDataReader && validationSetDataReader != nullptr)
         {
             // TODO(dataASGD) making evaluator becoming nondistributed one when using ASGD, since Multiverso has another background thread using MPI.
@@ -648,7 +743,6 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         }
 
         bool loadedPrevModel = false;
-        size_t epochsSinceLastLearnRateAdjust = i % m_learnRateAdjustInterval + 1;
         if (avgCriterion == numeric_limits<double>::infinity())
         {
             avgCriterion = lrControlCriterion;
@@ -750,6 +844,9 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         // Persist model and check-point info
         if ((m_mpi == nullptr) || m_mpi->IsMainNode())
         {
+            // a background checkpoint write may still reference files we are about to delete or replace
+            WaitForPendingCheckpoint();
+
             if (loadedPrevModel)
             {
                 // If previous best model is loaded, we will first remove epochs that lead to worse results
@@ -769,10 +866,13 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
             else
             {
                 SaveCheckPointInfo(i, totalTrainingSamplesSeen, learnRatePerSample, smoothedGradients, smoothedCounts, prevCriterion, chosenMinibatchSize);
-                auto modelName = GetModelNameForEpoch(i);
-                if (m_traceLevel > 0)
-                    LOGPRINTF(stderr, "SGD: Saving checkpoint model '%ls'\n", modelName.c_str());
-                net->Save(modelName);
+                if (!modelPersistedBeforeValidation) // (otherwise the wait above committed the model already)
+                {
+                    auto modelName = GetModelNameForEpoch(i);
+                    if (m_traceLevel > 0)
+                        LOGPRINTF(stderr, "SGD: Saving checkpoint model '%ls'\n", modelName.c_str());
+                    net->Save(modelName);
+                }
                 if (!m_keepCheckPointFiles)
                 {
                     // delete previous checkpoint file to save space
@@ -830,6 +930,14 @@ void SGD<ElemType>::TrainOrAdaptModel(int startEpoch, ComputationNetworkPtr net,
         }
     }
 
+    // write the per-node profile accumulated over training (nodeProfiling config flag)
+    if (Globals::ShouldEnableNodeProfiling() && (m_mpi == nullptr || m_mpi->IsMainNode()))
+    {
+        let profilePath = m_modelPath + L".profile";
+        LOGPRINTF(stderr, "SGD: Writing per-node profile to '%ls'\n", profilePath.c_str());
+        net->DumpProfile(profilePath);
+    }
+
     delete inputMatrices;
     if (m_parallelizationMethod == ParallelizationMethod::dataParallelASGD)
         m_pASGDHelper.reset();
@@ -898,6 +1006,29 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
     }
 
     std::vector<Matrix<ElemType>*> learnParamsGradients;
+    std::map<ComputationNodeBase*, size_t> learnParamsGradientIndex; // node -> index into learnParamsGradients
+
+    // Micro-batching: accumulate the gradients of accumulationSteps reader minibatches before
+    // each aggregation round and weight update (see accumulationSteps in the SGD config)
+    size_t accumulationSteps = m_gradientAccumulationSteps;
+    size_t accumulationStep = 0; // position within the current accumulation window
+    size_t accumulatedNumSamples = 0;
+    size_t accumulatedNumSamplesWithLabel = 0;
+    std::map<ComputationNodeBase*, std::unique_ptr<Matrix<ElemType>>> accumulatedGradients;
+
+    // When enabled, drive the aggregator from the network's gradient-ready callbacks so that
+    // communication overlaps with the remaining backward computation. Only the simple (dense,
+    // synchronous) aggregator supports this protocol.
+    std::shared_ptr<SimpleDistGradAggregator<ElemType>> overlappedAgg;
+    if (useGradientAggregation && m_overlapGradientAgg)
+    {
+        overlappedAgg = std::dynamic_pointer_cast<SimpleDistGradAggregator<ElemType>>(m_distGradAgg);
+        if (overlappedAgg && !overlappedAgg->SupportsOverlappedAggregation())
+            overlappedAgg = nullptr;
+        if (!overlappedAgg)
+            fprintf(stderr, "useOverlappedAggregation: the configured gradient aggregator does not support overlapping; using synchronous aggregation.\n");
+    }
+
     Profiler profiler(m_numMBsToCUDAProfile);
 
     // resetting this, so profiling is performed for one epoch only
@@ -906,7 +1037,13 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
     bool useDistributedMBReading = useParallelTrain &&
                                    m_enableDistributedMBReading &&
                                    trainSetDataReader->SupportsDistributedMBRead();
-    if (useDistributedMBReading)
+    if (m_prestartedReaderEpoch == (int) epochNumber)
+    {
+        // the previous epoch boundary already restarted the reader for this epoch, so that
+        // chunk prefetch could overlap with validation and checkpointing
+        m_prestartedReaderEpoch = -1;
+    }
+    else if (useDistributedMBReading)
     {
         trainSetDataReader->StartDistributedMinibatchLoop(tunedMBSize, epochNumber, m_mpi->CurrentNodeRank(),
             m_mpi->NumNodesInUse(), inputMatrices->GetStreamDescriptions(), epochSize);
@@ -1028,6 +1165,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         // get minibatch
         // TODO: is it guaranteed that the GPU is already completed at this point, is it safe to overwrite the buffers?
         size_t actualMBSize = 0;
+        bool overlappedAggregationBegun = false;
 
         auto profGetMinibatch = ProfilerTimeBegin();
         bool wasDataRead = DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*trainSetDataReader, net, criterionNodes[0],
@@ -1036,8 +1174,20 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         if (maxNumSamplesExceeded) // Dropping data.
             wasDataRead = false;
 
+        // Micro-batching: is this the last step of the current accumulation window? A pure
+        // function of the iteration count, so in parallel runs all ranks agree on which
+        // iterations run an aggregation round and weight update.
+        bool finalAccumulationStep = (accumulationSteps <= 1) || (accumulationStep == accumulationSteps - 1);
+
         if (!wasDataRead && (!useDistributedMBReading || noMoreSamplesToProcess)) // in case of distributed reading, we do a few more loops until all ranks have completed
-            break;                                                                // end of epoch
+        {
+            if (accumulationStep == 0)
+                break; // end of epoch
+
+            // a partially filled accumulation window remains: run this iteration with an empty
+            // minibatch to flush it into one final aggregation round and update
+            finalAccumulationStep = true;
+        }
 
         // Note: If !wasDataRead then the data that GetMinibatchIntoNetwork() was supposed to fill in are undefined.
         // Must not touch them.
@@ -1091,6 +1241,27 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
 
             // do forward and back propagation
 
+            // When overlapping aggregation with backprop, start the exchange protocol now and
+            // have the network signal each gradient as backprop finalizes it. Gradients
+            // accumulate across sub-minibatches and accumulation windows, so this stays off in
+            // those modes; it also stays off on the very first minibatch, before the gradient
+            // list exists.
+            if (overlappedAgg && !learnParamsGradients.empty() && (numSubminibatchesNeeded <= 1) && (accumulationSteps <= 1))
+            {
+                m_gradHeader->numEvalNode = evaluationNodes.size();
+                if (overlappedAgg->BeginAggregateGradientsOverlapped(learnParamsGradients, m_gradHeader.get(), isFirstMinibatch))
+                {
+                    overlappedAggregationBegun = true;
+                    auto aggregator = overlappedAgg;
+                    net->SetGradientReadyCallback([aggregator, &learnParamsGradientIndex](const ComputationNodeBasePtr& node)
+                    {
+                        auto iter = learnParamsGradientIndex.find(node.get());
+                        if (iter != learnParamsGradientIndex.end())
+                            aggregator->OnGradientReady(iter->second);
+                    });
+                }
+            }
+
             // We optionally break the minibatch into sub-minibatches.
             // This, when enabled, is used when a full minibatch does not fit into GPU RAM.
             size_t actualNumSubminibatches = numSubminibatchesNeeded <= 1 ? 1 : smbDispatcher.GetMinibatchIntoCache(*trainSetDataReader, *net, *inputMatrices, numSubminibatchesNeeded);
@@ -1127,6 +1298,41 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         } // if (actualMBSize > 0)
         // WARNING: If actualMBSize == 0, then criterion nodes have NOT been updated, and contain garbage (last MB's) values.
 
+        // Micro-batching: stash this minibatch's gradients away mid-window; on the window's last
+        // step, fold the stashed sum back in so that aggregation and the update below see the
+        // gradient of the whole window
+        if ((accumulationSteps > 1) && (learnRatePerSample > 0.01 * m_minLearnRate))
+        {
+            for (auto nodeIter = learnableNodes.begin(); nodeIter != learnableNodes.end(); nodeIter++)
+            {
+                ComputationNodePtr node = dynamic_pointer_cast<ComputationNode<ElemType>>(*nodeIter);
+                if (!node->IsParameterUpdateRequired())
+                    continue;
+
+                auto& accumulator = accumulatedGradients[node.get()];
+                if (!finalAccumulationStep)
+                {
+                    if (actualMBSize == 0)
+                        continue; // empty minibatch: no gradient was computed
+
+                    if (!accumulator)
+                    {
+                        accumulator.reset(new Matrix<ElemType>(node->Gradient().GetNumRows(), node->Gradient().GetNumCols(), node->Gradient().GetDeviceId()));
+                        accumulator->SetValue(0);
+                    }
+                    *accumulator += node->Gradient();
+                }
+                else if (accumulator)
+                {
+                    if (actualMBSize > 0)
+                        node->Gradient() += *accumulator; // the gradient holds this step's own contribution
+                    else
+                        node->Gradient().AssignValuesOf(*accumulator); // flushing without a backprop pass
+                    accumulator->SetValue(0);
+                }
+            }
+        }
+
         // In case of mini epochs (used for adaptive minibatch size and learning rate),
         // no more data should be processed by this worker.
         if (shouldCheckEarlyExit)
@@ -1150,6 +1356,9 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         size_t aggregateNumSamples = actualMBSize; // (0 for empty MB)
         size_t aggregateNumSamplesWithLabel = CriterionAccumulator<ElemType>::GetNumSamples(criterionNodes[0], numSamplesWithLabelOfNetwork); // (0 for empty MB)
 
+        accumulatedNumSamples += aggregateNumSamples;
+        accumulatedNumSamplesWithLabel += aggregateNumSamplesWithLabel;
+
         if (!useGradientAggregation)
         {
             // accumulate criterion values (objective, eval)
@@ -1158,6 +1367,14 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
             localEpochCriterion.Add(0, numSamplesWithLabelOfNetwork);
             for (size_t i = 0; i < evaluationNodes.size(); i++)
                 localEpochEvalErrors.Add(i, numSamplesWithLabelOfNetwork);
+
+            if (accumulationSteps > 1)
+            {
+                // mid-window steps perform no update; the window's last step normalizes the
+                // update by the sample count of the whole window
+                aggregateNumSamples = finalAccumulationStep ? accumulatedNumSamples : 0;
+                aggregateNumSamplesWithLabel = finalAccumulationStep ? accumulatedNumSamplesWithLabel : 0;
+            }
         }
         else
         {
@@ -1181,27 +1398,66 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                             currParamsGradient->Resize(currParamsValues->GetNumRows(), currParamsValues->GetNumCols());
                         }
 
+                        learnParamsGradientIndex[node.get()] = learnParamsGradients.size();
                         learnParamsGradients.push_back(currParamsGradient);
                     }
                 }
             }
 
-            // hoist the criterion into CPU space for all-reduce
-            localEpochCriterion.Assign(0, numSamplesWithLabelOfNetwork);
-            for (size_t i = 0; i < evaluationNodes.size(); i++)
-                localEpochEvalErrors.Assign(i, numSamplesWithLabelOfNetwork);
+            // hoist the criterion into CPU space for all-reduce; with micro-batching, keep
+            // summing locally until the window's last step runs the aggregation round
+            if ((accumulationSteps > 1) && (accumulationStep != 0))
+            {
+                localEpochCriterion.Add(0, numSamplesWithLabelOfNetwork);
+                for (size_t i = 0; i < evaluationNodes.size(); i++)
+                    localEpochEvalErrors.Add(i, numSamplesWithLabelOfNetwork);
+            }
+            else
+            {
+                localEpochCriterion.Assign(0, numSamplesWithLabelOfNetwork);
+                for (size_t i = 0; i < evaluationNodes.size(); i++)
+                    localEpochEvalErrors.Assign(i, numSamplesWithLabelOfNetwork);
+            }
 
+            if (!finalAccumulationStep)
+            {
+                // mid-window: no aggregation round and no update this iteration
+                aggregateNumSamples = 0;
+                aggregateNumSamplesWithLabel = 0;
+            }
+            else
+            {
             // copy all values to be aggregated into the header
-            m_gradHeader->numSamples = aggregateNumSamples;
-            m_gradHeader->criterion           = localEpochCriterion.GetCriterion(0).first;
-            m_gradHeader->numSamplesWithLabel = localEpochCriterion.GetCriterion(0).second; // same as aggregateNumSamplesWithLabel
-            assert(m_gradHeader->numSamplesWithLabel == aggregateNumSamplesWithLabel);
+            m_gradHeader->numSamples = (accumulationSteps > 1) ? accumulatedNumSamples : aggregateNumSamples;
+            EpochCriterion localCriterion = localEpochCriterion.GetCriterion(0);
+            m_gradHeader->criterion           = localCriterion.first;
+            m_gradHeader->numSamplesWithLabel = localCriterion.second; // same as aggregateNumSamplesWithLabel
+            assert((accumulationSteps > 1) || (m_gradHeader->numSamplesWithLabel == aggregateNumSamplesWithLabel));
+            // pull all eval criteria off the device in one transfer instead of one sync each
+            let localEvalErrors = localEpochEvalErrors.GetCriteria();
             for (size_t i = 0; i < evaluationNodes.size(); i++)
-                m_gradHeader->evalErrors[i] = localEpochEvalErrors.GetCriterion(i);
+                m_gradHeader->evalErrors[i] = localEvalErrors[i];
 
             // aggregate
             m_gradHeader->numEvalNode = evaluationNodes.size(); // TODO: rename numEvalNode (plural)
-            bool samplesProcessed = m_distGradAgg->AggregateGradients(learnParamsGradients, m_gradHeader.get(), isFirstMinibatch);
+            bool samplesProcessed;
+            if (overlappedAgg)
+            {
+                net->ClearGradientReadyCallback();
+
+                // Ranks that did not run backprop this minibatch (no data read, sub-minibatching,
+                // or the first minibatch) have not begun the protocol yet; begin it here so every
+                // rank posts the same collectives in the same order. Whether it engages depends
+                // only on configuration, so all ranks agree on the path taken.
+                bool engaged = overlappedAggregationBegun ||
+                               overlappedAgg->BeginAggregateGradientsOverlapped(learnParamsGradients, m_gradHeader.get(), isFirstMinibatch);
+                if (engaged)
+                    samplesProcessed = overlappedAgg->EndAggregateGradientsOverlapped(learnParamsGradients, m_gradHeader.get());
+                else
+                    samplesProcessed = m_distGradAgg->AggregateGradients(learnParamsGradients, m_gradHeader.get(), isFirstMinibatch);
+            }
+            else
+                samplesProcessed = m_distGradAgg->AggregateGradients(learnParamsGradients, m_gradHeader.get(), isFirstMinibatch);
             noMoreSamplesToProcess = !samplesProcessed;
 
             // read out the header--now everything is aggregated
@@ -1224,6 +1480,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 else
                     epochEvalErrors[i] += m_gradHeader->evalErrors[i];
             }
+            } // if (finalAccumulationStep)
         }
 
         ProfilerTimeEnd(profGradientAgg, profilerEvtMainGradient);
@@ -1284,6 +1541,8 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 if (synced)
                 {
                     nSamplesSinceLastModelSync = 0;
+                    // the helper may stretch the sync period when communication dominates
+                    blockSizePerWorker = m_pMASGDHelper->RecommendedBlockSizePerWorker(m_modelAggregationBlockSize / m_mpi->NumNodesInUse());
                 }
             }
             // prepare break condition
@@ -1328,8 +1587,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 // if no aggregation, we directly get the values from the minibatch accumulators
                 timer.Restart();
                 epochCriterion = localEpochCriterion.GetCriterion(0);
-                for (size_t i = 0; i < epochEvalErrors.size(); i++)
-                    epochEvalErrors[i] = localEpochEvalErrors.GetCriterion(i);
+                epochEvalErrors = localEpochEvalErrors.GetCriteria(); // single device sync for all eval criteria
                 timer.Stop();
 
                 // Add the last trailing compute
@@ -1397,7 +1655,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
                 ProgressTracing::TraceTrainLoss(trainLossSinceLastLogged);
 
             if (m_traceLevel > 0)
-                fflush(stderr);
+                AsyncLogWriter::RequestFlush(stderr); // the NFS round trip of this flush is what makes per-minibatch logging expensive
 
             if (epochCriterion.IsNan())
                 RuntimeError("The training criterion is not a number (NAN).");
@@ -1435,7 +1693,18 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         AttemptUtteranceDerivativeFeatures(net, trainSetDataReader, featureNodes, inputMatrices);
 
         profiler.NextSample();
-        isFirstMinibatch = false;
+
+        // Micro-batching: advance the accumulation window; 'isFirstMinibatch' feeds the
+        // aggregator's reset logic, so it only flips once an aggregation round has run
+        if (finalAccumulationStep)
+        {
+            accumulationStep = 0;
+            accumulatedNumSamples = 0;
+            accumulatedNumSamplesWithLabel = 0;
+            isFirstMinibatch = false;
+        }
+        else
+            accumulationStep++;
 
         ProfilerTimeEnd(profPost, profilerEvtMainPost);
         ProfilerTimeEnd(profMinibatch, profilerEvtMainMinibatch);
@@ -1460,8 +1729,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
     if (!useGradientAggregation)
     {
         epochCriterion = localEpochCriterion.GetCriterion(0);
-        for (size_t i = 0; i < epochEvalErrors.size(); i++)
-            epochEvalErrors[i] = localEpochEvalErrors.GetCriterion(i);
+        epochEvalErrors = localEpochEvalErrors.GetCriteria(); // single device sync for all eval criteria
     }
 
     // in case of model averaging, do one more final aggregation of criteria
@@ -1474,8 +1742,7 @@ size_t SGD<ElemType>::TrainOneEpoch(ComputationNetworkPtr net,
         // get criteria for this worker
         assert(!useGradientAggregation); // (otherwise the data would not be in localEpochCriterion)
         epochCriterion = localEpochCriterion.GetCriterion(0);
-        for (size_t i = 0; i < epochEvalErrors.size(); i++)
-            epochEvalErrors[i] = localEpochEvalErrors.GetCriterion(i);
+        epochEvalErrors = localEpochEvalErrors.GetCriteria();
 
         // all-reduce epochCriterion and epochEvalErrors over nodes
         m_mpi->AllReduce(&epochCriterion.first,  1);
@@ -1572,11 +1839,21 @@ bool SGD<ElemType>::PreCompute(ComputationNetworkPtr net,
     // compute
     ScopedNetworkOperationMode modeGuard(net, NetworkOperationMode::preComputing);
 
+    // When running data-parallel and the reader can partition the data, let every worker
+    // stream a disjoint shard of the corpus and merge the accumulated moments afterwards.
+    // This requires all precompute nodes to know how to merge their accumulators.
+    bool useDistributedPreCompute = (m_mpi != nullptr) && (m_mpi->NumNodesInUse() > 1) && trainSetDataReader->SupportsDistributedMBRead();
+    for (const auto& node : nodes)
+        useDistributedPreCompute &= (dynamic_pointer_cast<MeanInvStdDevNodeBase<ElemType>>(node) != nullptr);
+
     // trainSetDataReader->StartMinibatchLoop(m_mbSize[0],  0 , requestDataSize);
     // trainSetDataReader->StartMinibatchLoop(m_mbSize[0],  0 , m_epochSize); // only based on one epoch
     // To support large dataset, we usually partition whole dataset into several epoch's,
     // so we need to use all the data to do precomputing
-    if (m_useAllDataForPreComputedNode) // using all the data
+    if (useDistributedPreCompute) // every worker reads a disjoint shard
+        trainSetDataReader->StartDistributedMinibatchLoop(m_mbSize[0], 0, m_mpi->CurrentNodeRank(), m_mpi->NumNodesInUse(), inputMatrices->GetStreamDescriptions(),
+                                                          m_useAllDataForPreComputedNode ? requestDataSize : m_epochSize);
+    else if (m_useAllDataForPreComputedNode) // using all the data
         trainSetDataReader->StartMinibatchLoop(m_mbSize[0], 0, inputMatrices->GetStreamDescriptions());
     else // using only one epoch. Note: One epoch is often enough for feature mean/stddev, but not for estimating priors.
         trainSetDataReader->StartMinibatchLoop(m_mbSize[0], 0, inputMatrices->GetStreamDescriptions(), m_epochSize);
@@ -1589,8 +1866,11 @@ bool SGD<ElemType>::PreCompute(ComputationNetworkPtr net,
     const size_t numIterationsBeforePrintingProgress = 100;
     size_t numItersSinceLastPrintOfProgress = 0;
     size_t actualMBSizeDummy;
-    while (DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*trainSetDataReader, net, nullptr, false, false, *inputMatrices, actualMBSizeDummy, m_mpi))
+    while (DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*trainSetDataReader, net, nullptr, useDistributedPreCompute, false, *inputMatrices, actualMBSizeDummy, m_mpi))
     {
+        if (actualMBSizeDummy == 0) // with distributed reading, workers past their shard's end get empty minibatches
+            continue;
+
         // TODO: move these into GetMinibatchIntoNetwork()  --but those are passed around; necessary? Can't we get them from 'net'?
         ComputationNetwork::BumpEvalTimeStamp(featureNodes);
         ComputationNetwork::BumpEvalTimeStamp(labelNodes);
@@ -1600,6 +1880,14 @@ bool SGD<ElemType>::PreCompute(ComputationNetworkPtr net,
         numItersSinceLastPrintOfProgress = ProgressTracing::TraceFakeProgress(numIterationsBeforePrintingProgress, numItersSinceLastPrintOfProgress);
     }
 
+    // merge the shard statistics: all workers reduce the accumulators of all nodes in the same order
+    if (useDistributedPreCompute)
+    {
+        for (auto & node : nodes)
+            dynamic_pointer_cast<MeanInvStdDevNodeBase<ElemType>>(node)->MergeAccumulatorsAcrossWorkers(
+                [this](std::vector<double>& accumulators) { m_mpi->AllReduce(accumulators); });
+    }
+
     // finalize
     for (auto & node : nodes)
         dynamic_pointer_cast<IPreComputeNode>(node)->MarkComputed(true /*done accumulating*/);
@@ -1688,6 +1976,63 @@ double SGD<ElemType>::SearchForBestLearnRate(ComputationNetworkPtr net,
     }
 
     EpochCriterion epochCriterion(EpochCriterion::Infinity());
+
+    // When multiple MPI ranks are up but parallel training has not kicked in for this epoch
+    // (the common case, since LR search runs in the warm-up epochs), every rank would execute
+    // the identical sequence of trial mini-epochs below. Instead, the ranks divide the
+    // candidate rates among themselves -- rank r tries the (r+1)-th next rate of each round --
+    // and exchange the resulting criteria, so one parallel round replaces up to W sequential
+    // trials. Each trial reverts to the base model, so only the winning rate needs agreeing on,
+    // which every rank derives identically from the exchanged criteria.
+    size_t numSearchWorkers = ((m_mpi != nullptr) && !UsingParallelTrain(epochNumber)) ? m_mpi->NumNodesInUse() : 1;
+    if (numSearchWorkers > 1)
+    {
+        LOGPRINTF(stderr, " SearchForBestLearnRate Epoch[%d]: Searching with %d candidate rates per round across MPI ranks\n",
+                  (int)epochNumber + 1, (int)numSearchWorkers);
+        size_t myRank = m_mpi->CurrentNodeRank();
+        bool found = false;
+        while (!found)
+        {
+            // this rank's candidate within the current round
+            double candidateLearnRatePerSample = learnRatePerSample * pow(0.618, (double)(myRank + 1));
+            TrainOneMiniEpochAndReloadModel(net, refNet, refNode, epochNumber,
+                                            m_epochSize, trainSetDataReader,
+                                            candidateLearnRatePerSample, m_mbSize[epochNumber], featureNodes,
+                                            labelNodes, criterionNodes,
+                                            evaluationNodes, inputMatrices,
+                                            learnableNodes, smoothedGradients, smoothedCounts,
+                                            /*out*/ epochCriterion, /*out*/ epochEvalErrors,
+                                            "AdaptiveLearnRateSearch:",
+                                            numFramesToUseInSearch);
+
+            // gather all ranks' criteria (zero slots + element-wise sum = all-gather; NaNs survive)
+            vector<double> criteria(2 * numSearchWorkers, 0.0);
+            criteria[2 * myRank]     = epochCriterion.first;
+            criteria[2 * myRank + 1] = (double)epochCriterion.second;
+            m_mpi->AllReduce(criteria);
+
+            // every rank scans the round largest-rate-first with the acceptance rule of the
+            // sequential loop below, so all ranks agree on the same winner
+            for (size_t r = 0; r < numSearchWorkers; r++)
+            {
+                EpochCriterion candidateCriterion(criteria[2 * r], (size_t)criteria[2 * r + 1]);
+                double candidateRate = learnRatePerSample * pow(0.618, (double)(r + 1));
+                if (!candidateCriterion.IsNan() &&
+                    (candidateCriterion.Average() <= baseCriterion.Average() || candidateRate <= minLearnRate))
+                {
+                    learnRatePerSample = candidateRate;
+                    epochCriterion = candidateCriterion;
+                    found = true;
+                    break;
+                }
+            }
+
+            // no acceptable rate in this round: continue below the smallest rate just tried
+            if (!found)
+                learnRatePerSample *= pow(0.618, (double)numSearchWorkers);
+        }
+    }
+    else
     do
     {
         learnRatePerSample *= 0.618;
@@ -1882,6 +2227,66 @@ static size_t RoundToMultipleOf64(size_t val)
     return 64 * ((val + 32) / 64);
 }
 
+// ThroughputAdaptiveMinibatchSizing() -- continuous minibatch-size controller
+// Instead of running speculative trial epochs (SearchForBestMinibatchSize), this hill-climbs on
+// the samples/sec actually measured while training: the size is doubled after each epoch, and
+// the grown size is kept only if it delivered at least m_minibatchThroughputTuningMargin
+// relative throughput gain without regressing the training criterion by more than
+// m_minibatchSearchCriterionErrorMargin percent (the same guard the trial-epoch search applies).
+// After a failed probe the controller holds the baseline size for m_minibatchSizeTuningFrequency
+// epochs before probing again. Readers fix the minibatch size when an epoch's minibatch loop
+// starts, so adjustments take effect at epoch boundaries.
+template <class ElemType>
+size_t SGD<ElemType>::ThroughputAdaptiveMinibatchSizing(const int epochNumber, const size_t initialMinibatchSize)
+{
+    size_t chosenMinibatchSize = (m_prevChosenMinibatchSize != 0) ? m_prevChosenMinibatchSize : initialMinibatchSize;
+
+    // nothing measured yet (first epoch, or restart from checkpoint): establish a baseline first
+    if (m_lastEpochMBSize == 0 || m_lastEpochSamplesPerSecond <= 0)
+        return chosenMinibatchSize;
+
+    if (m_mbBaselineSize == 0 || m_lastEpochMBSize <= m_mbBaselineSize)
+    {
+        // running at (or below) the baseline size: the newest measurement becomes the baseline
+        m_mbBaselineSize = m_lastEpochMBSize;
+        m_mbBaselineSamplesPerSecond = m_lastEpochSamplesPerSecond;
+        m_mbBaselineLoss = m_lastEpochLoss;
+    }
+    else
+    {
+        // we probed a larger size last epoch: keep it only if it paid off
+        bool fasterEnough = m_lastEpochSamplesPerSecond > m_mbBaselineSamplesPerSecond * (1.0 + m_minibatchThroughputTuningMargin);
+        bool lossAcceptable = m_lastEpochLoss <= m_mbBaselineLoss * (1.0 + (m_minibatchSearchCriterionErrorMargin / 100.0));
+        if (fasterEnough && lossAcceptable)
+        {
+            LOGPRINTF(stderr, " ThroughputAdaptiveMinibatchSizing: keeping minibatchSize %d (%.0f vs. %.0f samples/sec)\n",
+                      (int)m_lastEpochMBSize, m_lastEpochSamplesPerSecond, m_mbBaselineSamplesPerSecond);
+            m_mbBaselineSize = m_lastEpochMBSize;
+            m_mbBaselineSamplesPerSecond = m_lastEpochSamplesPerSecond;
+            m_mbBaselineLoss = m_lastEpochLoss;
+        }
+        else
+        {
+            LOGPRINTF(stderr, " ThroughputAdaptiveMinibatchSizing: rolling back to minibatchSize %d (%s at %d)\n",
+                      (int)m_mbBaselineSize, fasterEnough ? "criterion regressed" : "no throughput gain", (int)m_lastEpochMBSize);
+            m_mbProbeHoldoff = m_minibatchSizeTuningFrequency;
+        }
+    }
+    chosenMinibatchSize = m_mbBaselineSize;
+
+    // probe a larger size next unless we are holding off after a failed probe
+    if (m_mbProbeHoldoff > 0)
+        m_mbProbeHoldoff--;
+    else
+    {
+        size_t probeSize = min(RoundToMultipleOf64(2 * chosenMinibatchSize), m_minibatchSizeTuningMax);
+        if (probeSize > chosenMinibatchSize)
+            chosenMinibatchSize = probeSize;
+    }
+
+    return chosenMinibatchSize;
+}
+
 // uses a small percentage of training data of minibatch to
 // speculatively train with various MB sizes; then picks the best
 template <class ElemType>
@@ -1919,6 +2324,74 @@ size_t SGD<ElemType>::SearchForBestMinibatchSize(ComputationNetworkPtr net,
 
     size_t lastGoodMinibatchSize = 0;
     EpochCriterion lastGoodEpochCriterion(0);
+
+    // Unlike the learning-rate search, the candidate list is known upfront here, so when
+    // multiple MPI ranks are up and parallel training has not kicked in for this epoch, the
+    // ranks speculatively train all candidates at once (rank r takes candidates r, r+W, ...)
+    // and exchange the criteria; the sequential early-stopping scan below then runs on the
+    // gathered results identically on every rank. Trials revert to the base model, so the only
+    // thing to agree on is the chosen size. In sequential mode every rank would run the
+    // identical trials anyway, so nothing is lost by dividing them up.
+    size_t numSearchWorkers = ((m_mpi != nullptr) && !UsingParallelTrain(epochNumber)) ? m_mpi->NumNodesInUse() : 1;
+    if (numSearchWorkers > 1)
+    {
+        vector<size_t> candidateSizes;
+        for (float trialMinibatchSizeFloat = (float) minMinibatchSize;
+             trialMinibatchSizeFloat <= maxMinibatchSize;
+             trialMinibatchSizeFloat *= minibatchSizeTuningFactor)
+        {
+            candidateSizes.push_back(RoundToMultipleOf64(trialMinibatchSizeFloat));
+        }
+
+        LOGPRINTF(stderr, " AdaptiveMinibatchSearch Epoch[%d]: Evaluating %d candidate minibatchSizes across %d MPI ranks\n",
+                  (int)epochNumber + 1, (int)candidateSizes.size(), (int)numSearchWorkers);
+
+        // train this rank's share of the candidates; without parallel training there are no
+        // collectives inside the trials, so ranks may run different numbers of them
+        size_t myRank = m_mpi->CurrentNodeRank();
+        vector<double> criteria(2 * candidateSizes.size(), 0.0);
+        for (size_t i = myRank; i < candidateSizes.size(); i += numSearchWorkers)
+        {
+            std::vector<EpochCriterion> epochEvalErrors(evaluationNodes.size(), EpochCriterion::Infinity());
+            EpochCriterion epochCriterion(EpochCriterion::Infinity());
+            TrainOneMiniEpochAndReloadModel(net, refNet, refNode, epochNumber,
+                                            m_epochSize, trainSetDataReader,
+                                            learnRatePerSample, candidateSizes[i], featureNodes,
+                                            labelNodes, criterionNodes,
+                                            evaluationNodes, inputMatrices,
+                                            learnableNodes, smoothedGradients, smoothedCounts,
+                                            /*out*/ epochCriterion, /*out*/ epochEvalErrors,
+                                            (i == 0) ? "BaseAdaptiveMinibatchSearch:" : "AdaptiveMinibatchSearch:",
+                                            numFramesToUseInSearch);
+            criteria[2 * i]     = epochCriterion.first;
+            criteria[2 * i + 1] = (double)epochCriterion.second;
+        }
+        m_mpi->AllReduce(criteria); // zero slots + element-wise sum = all-gather; NaNs survive
+
+        // the same scan the sequential loop performs, on the gathered criteria
+        baseCriterion = EpochCriterion(criteria[0], (size_t)criteria[1]);
+        lastGoodMinibatchSize = candidateSizes[0];
+        lastGoodEpochCriterion = baseCriterion;
+        for (size_t i = 1; i < candidateSizes.size(); i++)
+        {
+            EpochCriterion epochCriterion(criteria[2 * i], (size_t)criteria[2 * i + 1]);
+            if (!epochCriterion.IsNan() &&
+                epochCriterion.Average() > (baseCriterion.Average() * (1.0 + (m_minibatchSearchCriterionErrorMargin / 100.0))))
+            {
+                break;
+            }
+            lastGoodMinibatchSize = candidateSizes[i];
+            lastGoodEpochCriterion = epochCriterion;
+        }
+
+        if (m_traceLevel > 0)
+        {
+            LOGPRINTF(stderr, " AdaptiveMinibatchSearch Epoch[%d]: Search successful. New minibatchSize is %d. epochCriterion = %.8f vs baseCriterion = %.8f\n",
+                      (int)epochNumber + 1, (int)lastGoodMinibatchSize, lastGoodEpochCriterion.Average(), baseCriterion.Average());
+        }
+        return lastGoodMinibatchSize;
+    }
+
     for (float trialMinibatchSizeFloat = (float) minMinibatchSize;
          trialMinibatchSizeFloat <= maxMinibatchSize;
          trialMinibatchSizeFloat *= minibatchSizeTuningFactor)
@@ -2077,10 +2550,21 @@ void SGD<ElemType>::InitDistGradAgg(int numEvalNodes, int numGradientBits, int d
 {
     assert(GetParallelizationMethod() == ParallelizationMethod::dataParallelSGD);
 
-    if (numGradientBits != (8 * sizeof(ElemType)))
+    if (m_numGradientTopK > 0)
+    {
+        if (traceLevel > 0)
+            fprintf(stderr, "Initializing dataParallelSGD with top-%d per-column gradient exchange.\n", (int) m_numGradientTopK);
+        if (Globals::UseV2Aggregator())
+            InvalidArgument("topK gradient aggregation is not supported with the V2 aggregator.");
+        m_distGradAgg = std::make_shared<TopKDistGradAggregator<ElemType>>(m_mpi, m_numGradientTopK, deviceId, m_syncStatsTrace);
+    }
+    else if (numGradientBits != (8 * sizeof(ElemType)))
     {
         if (traceLevel > 0)
             fprintf(stderr, "Initializing dataParallelSGD for %d-bit quantization.\n", numGradientBits);
+
+        // let the quantizers reuse cached per-column ranges between exact recomputations
+        MatrixQuantizerImpl<ElemType>::SetRangeRecomputeStride(m_quantRangeRecomputeStride);
 #ifdef CNTK_PARALLEL_TRAINING_SUPPORT
         if (Globals::UseV2Aggregator())
         {
@@ -2100,7 +2584,7 @@ void SGD<ElemType>::InitDistGradAgg(int numEvalNodes, int numGradientBits, int d
         if (Globals::UseV2Aggregator()) // Currently used to check V2 against baselines.
             m_distGradAgg = std::make_shared<V2SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, m_syncStatsTrace, ::CNTK::MPICommunicator());
         else
-            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace);
+            m_distGradAgg = std::make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, m_bufferedAsyncGradientAggregation, deviceId, m_syncStatsTrace, m_asyncHeaderExchange, m_fusionBufferSizeMB);
     }
 
     m_gradHeader.reset(DistGradHeader::Create(numEvalNodes), [](DistGradHeader* ptr) { DistGradHeader::Destroy(ptr); });
@@ -2115,7 +2599,7 @@ void SGD<ElemType>::InitModelAggregationHandler(int traceLevel, DEVICEID_TYPE de
     }
     if (GetParallelizationMethod() == ParallelizationMethod::modelAveragingSGD)
     {
-        m_pMASGDHelper = make_shared<BasicModelAveragingSGD<ElemType>>(m_mpi, traceLevel, devID);
+        m_pMASGDHelper = make_shared<BasicModelAveragingSGD<ElemType>>(m_mpi, traceLevel, devID, m_maDeltaBits, m_maAutoAdjustSyncPeriod);
     }
     else if (GetParallelizationMethod() == ParallelizationMethod::blockMomentumSGD)
     {
@@ -2277,55 +2761,97 @@ void SGD<ElemType>::SaveCheckPointInfo(const size_t epoch, const size_t totalSam
     // the parallel training nodes from colliding to write the same file
     if ((m_mpi == nullptr) || m_mpi->IsMainNode())
     {
+        // only one background write may be in flight; this also keeps commits in epoch order
+        WaitForPendingCheckpoint();
+
         wstring checkPointFileName = GetCheckPointFileNameForEpoch(int(epoch));
         // Saving into temporary file and then renaming it to the checkPointFileName
         // This is a standard trick to avoid havign corrupted checkpoints files if process dies during writing
         wstring tempFileName = checkPointFileName + L".tmp";
 
+        // Background checkpointing: snapshot the smoothed gradients to CPU-side copies, then
+        // write and commit on a separate thread while training continues. The MASGD helper
+        // serializes live state that keeps changing, so its presence forces the synchronous path.
+        if (m_asyncCheckpointing && !m_pMASGDHelper)
         {
-            File fstream(tempFileName, FileOptions::fileOptionsBinary | FileOptions::fileOptionsWrite);
-            // Buffer writes in memory then flush to filesystem, which reduces number of small writes
-            fstream.Setvbuf();
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BVersion"); 
-            fstream << (size_t)CURRENT_CNTK_CHECKPOINT_VERSION; 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EVersion");
+            auto snapshot = std::make_shared<std::list<Matrix<ElemType>>>();
+            for (auto smoothedGradientIter = smoothedGradients.begin(); smoothedGradientIter != smoothedGradients.end(); smoothedGradientIter++)
+                snapshot->emplace_back(*smoothedGradientIter, CPUDEVICE);
+            std::vector<double> smoothedCountsCopy = smoothedCounts;
 
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCKP");
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BLearnRate");
-            fstream << totalSamplesSeen << learnRatePerSample << prevCriterion;
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ELearnRate");
+            m_pendingCheckpointWrite = std::async(std::launch::async, [=]()
+            {
+                WriteCheckPointInfo(tempFileName, checkPointFileName, totalSamplesSeen, learnRatePerSample,
+                                    *snapshot, smoothedCountsCopy, prevCriterion, minibatchSize);
+            });
+            return;
+        }
 
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BMinibatchSize");
-            fstream << minibatchSize;
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EMinibatchSize");
+        WriteCheckPointInfo(tempFileName, checkPointFileName, totalSamplesSeen, learnRatePerSample,
+                            smoothedGradients, smoothedCounts, prevCriterion, minibatchSize);
+    }
+}
 
-            fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BGradient");
+template <class ElemType>
+void SGD<ElemType>::WriteCheckPointInfo(const wstring& tempFileName, const wstring& checkPointFileName,
+                                        const size_t totalSamplesSeen,
+                                        const double learnRatePerSample,
+                                        const std::list<Matrix<ElemType>>& smoothedGradients,
+                                        const std::vector<double>& smoothedCounts,
+                                        const double prevCriterion,
+                                        const size_t minibatchSize)
+{
+    {
+        File fstream(tempFileName, FileOptions::fileOptionsBinary | FileOptions::fileOptionsWrite);
+        // Buffer writes in memory then flush to filesystem, which reduces number of small writes
+        fstream.Setvbuf();
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BVersion"); 
+        fstream << (size_t)CURRENT_CNTK_CHECKPOINT_VERSION; 
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EVersion");
 
-            for (auto smoothedGradientIter = smoothedGradients.begin(); smoothedGradientIter != smoothedGradients.end(); smoothedGradientIter++)
-            {
-                const Matrix<ElemType>& smoothedGradient = *smoothedGradientIter;
-                fstream << smoothedGradient;
-            }
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BCKP");
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BLearnRate");
+        fstream << totalSamplesSeen << learnRatePerSample << prevCriterion;
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ELearnRate");
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EGradient");
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BMinibatchSize");
+        fstream << minibatchSize;
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EMinibatchSize");
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"BCount");
+        fstream.PutMarker(FileMarker::fileMarkerBeginSection, L"BGradient");
 
-            for (auto sc : smoothedCounts)
-                fstream << sc;
+        for (auto smoothedGradientIter = smoothedGradients.begin(); smoothedGradientIter != smoothedGradients.end(); smoothedGradientIter++)
+        {
+            const Matrix<ElemType>& smoothedGradient = *smoothedGradientIter;
+            fstream << smoothedGradient;
+        }
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECount");
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"EGradient");
 
-            fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECKP");
-            if (m_pMASGDHelper)
-                m_pMASGDHelper->SaveToCheckPoint(fstream);
-            // Ensuring that data is written
-            fstream.Flush();
-        }
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"BCount");
 
-        _wunlink(checkPointFileName.c_str());
-        renameOrDie(tempFileName, checkPointFileName);
+        for (auto sc : smoothedCounts)
+            fstream << sc;
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECount");
+
+        fstream.PutMarker(FileMarker::fileMarkerEndSection, L"ECKP");
+        if (m_pMASGDHelper)
+            m_pMASGDHelper->SaveToCheckPoint(fstream);
+        // Ensuring that data is written
+        fstream.Flush();
     }
+
+    _wunlink(checkPointFileName.c_str());
+    renameOrDie(tempFileName, checkPointFileName);
+}
+
+// Blocks until an outstanding background checkpoint write (if any) has committed its file.
+template <class ElemType>
+void SGD<ElemType>::WaitForPendingCheckpoint()
+{
+    if (m_pendingCheckpointWrite.valid())
+        m_pendingCheckpointWrite.get();
 }
 
 template <class ElemType>
@@ -2337,6 +2863,9 @@ bool SGD<ElemType>::TryLoadCheckPointInfo(const size_t epochNumber,
                                           /*out*/ double& prevCriterion,
                                           /*out*/ size_t& minibatchSize)
 {
+    // make sure a background write of this (or an older) checkpoint has committed before we read
+    WaitForPendingCheckpoint();
+
     // gracefully handle if a checkpoint file is missing
     // This means a user wanted to continue training from an older model, but that model had no checkpoint info anymore.
     // This is valid, we just don't get the features that require previous models, such as LR or MBSize control.
@@ -2668,6 +3197,8 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
     m_minibatchSizeTuningFrequency = configAALR(L"minibatchSizeTuningFrequency", (size_t) 1);
     m_minibatchSizeTuningMax = configAALR(L"minibatchSizeTuningMax", (size_t) 1048576);
     m_minibatchSearchCriterionErrorMargin = configAALR(L"minibatchSearchCriterionErrorMargin", (size_t) 1);
+    m_autoAdjustMinibatchByThroughput = configAALR(L"autoAdjustMinibatchByThroughput", false);
+    m_minibatchThroughputTuningMargin = configAALR(L"minibatchThroughputTuningMargin", 0.02);
 
     m_numPrevLearnRates = configAALR(L"numPrevLearnRates", (size_t) 5);
     m_numBestSearchEpoch = configAALR(L"numBestSearchEpoch", (size_t) 1);
@@ -2682,6 +3213,11 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
     m_truncated = configSGD(L"truncated", false);
     m_maxSamplesInRAM = configSGD(L"maxSamplesInRAM", (size_t) SIZE_MAX);
     m_numSubminiBatches = configSGD(L"numSubminibatches", (size_t) 1);
+    m_gradientAccumulationSteps = configSGD(L"accumulationSteps", (size_t) 1);
+    if (m_gradientAccumulationSteps == 0)
+        m_gradientAccumulationSteps = 1;
+    if (m_gradientAccumulationSteps > 1 && m_numSubminiBatches > 1)
+        InvalidArgument("accumulationSteps cannot be combined with numSubminibatches; both accumulate gradients over several passes.");
 
     if (configAALR.Exists(L"numMiniBatch4LRSearch"))
     {
@@ -2881,14 +3417,27 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
     // BUGBUG: these are not passed to Init()
     m_doUnitTest = configSGD(L"unitTest", false);
 
+    // model-parallel pipeline stages (see ComputationNetwork::PartitionIntoPipelineStages())
+    m_pipelineDevices = configSGD(L"pipelineDevices", ConfigRecordType::Array(intargvector(vector<int>{})));
+
     // parallel training
     m_parallelizationMethod = ParallelizationMethod::none;
     m_numGradientBits = vector<int>{8 * (int)sizeofElemType}; // means no quantization
+    m_numGradientTopK = 0;                                    // means no sparsification
+    m_quantRangeRecomputeStride = 0;                          // means recompute ranges every call
+    m_asyncHeaderExchange = false;
+    m_fusionBufferSizeMB = 0;                                 // means one exchange per gradient matrix
+    m_overlapGradientAgg = false;
     m_zeroThresholdFor1Bit = true;
     m_bufferedAsyncGradientAggregation = false;
     m_enableDistributedMBReading = false;
     m_parallelizationStartEpochNum = 0;
-    m_modelAggregationBlockSize = 0; 
+    m_modelAggregationBlockSize = 0;
+    m_workerHealthCheckTimeout = 0.0;
+    m_commTimingInterval = 0;
+    m_commSkewWarningThreshold = 0.0;
+    m_maDeltaBits = 0;                                        // means full-precision model averaging
+    m_maAutoAdjustSyncPeriod = false;
 
     if (configSGD.Exists(L"ParallelTrain"))
     {
@@ -2911,19 +3460,37 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
             m_enableDistributedMBReadingNotSpecified = !configParallelTrain.Exists(L"distributedMBReading");
             m_enableDistributedMBReading = configParallelTrain(L"distributedMBReading", false);
             m_syncStatsTrace = configParallelTrain(L"syncPerfStats", (int)0);
+            m_workerHealthCheckTimeout = configParallelTrain(L"workerHealthCheckTimeout", 0.0);
+            m_commTimingInterval = configParallelTrain(L"commTimingInterval", (size_t)0);
+            m_commSkewWarningThreshold = configParallelTrain(L"commSkewWarningThreshold", 0.0);
+            if (m_commSkewWarningThreshold > 0 && m_commTimingInterval == 0)
+                m_commTimingInterval = 100; // skew can only be measured when collectives are timed
 
         if (configParallelTrain.Exists(L"DataParallelSGD"))
         {
             const ConfigRecordType& configDataParallelSGD(configParallelTrain(L"DataParallelSGD", ConfigRecordType::Record()));
             let defaultGradientBits = 8 * (int)sizeofElemType;
             m_numGradientBits = configDataParallelSGD(L"gradientBits", ConfigRecordType::Array(intargvector(vector<int>{defaultGradientBits})));
+            m_numGradientTopK = configDataParallelSGD(L"topK", (size_t) 0);
+            m_quantRangeRecomputeStride = configDataParallelSGD(L"rangeRecomputeStride", (size_t) 0);
             m_zeroThresholdFor1Bit = configDataParallelSGD(L"useZeroThresholdFor1BitQuantization", true);
             m_bufferedAsyncGradientAggregation = configDataParallelSGD(L"useBufferedAsyncGradientAggregation", false);
+            m_asyncHeaderExchange = configDataParallelSGD(L"useAsyncHeaderExchange", false);
+            if (m_asyncHeaderExchange && m_bufferedAsyncGradientAggregation)
+                InvalidArgument("useAsyncHeaderExchange is redundant with useBufferedAsyncGradientAggregation, which already overlaps the whole exchange; enable only one.");
+            m_fusionBufferSizeMB = configDataParallelSGD(L"fusionBufferSizeMB", (size_t) 0);
+            m_overlapGradientAgg = configDataParallelSGD(L"useOverlappedAggregation", false);
+            if (m_overlapGradientAgg && (m_bufferedAsyncGradientAggregation || m_asyncHeaderExchange))
+                InvalidArgument("useOverlappedAggregation cannot be combined with useBufferedAsyncGradientAggregation or useAsyncHeaderExchange.");
             for (size_t i = 0; i < m_numGradientBits.size(); i++)
             {
                 if (m_numGradientBits[i] < 1 || m_numGradientBits[i] > defaultGradientBits)
                     InvalidArgument("gradientBits values must be in the range [1, 32] when using precision=float and in range [1, 64] when using precision=double.");
+                if (m_numGradientTopK > 0 && m_numGradientBits[i] != defaultGradientBits)
+                    InvalidArgument("topK gradient aggregation cannot be combined with gradientBits quantization; choose one.");
             }
+            if (m_numGradientTopK > 0 && m_bufferedAsyncGradientAggregation)
+                InvalidArgument("useBufferedAsyncGradientAggregation is currently not supported with topK gradient aggregation.");
         }
         if (configParallelTrain.Exists(L"ModelAveragingSGD"))
         {
@@ -2938,8 +3505,12 @@ SGDParams::SGDParams(const ConfigRecordType& configSGD, size_t sizeofElemType)
                 m_modelAggregationBlockSize *= numMPIWorkers;
             }
             else
-                m_modelAggregationBlockSize = 40000 * numMPIWorkers;    // default value 
-#if 1           // legacy option 
+                m_modelAggregationBlockSize = 40000 * numMPIWorkers;    // default value
+            m_maDeltaBits = configMASGD(L"deltaBits", (size_t) 0);
+            if (m_maDeltaBits != 0 && (m_maDeltaBits > 8 * sizeofElemType || (m_maDeltaBits & (m_maDeltaBits - 1)) != 0))
+                InvalidArgument("deltaBits must be a power of 2 between 1 and the number of bits of the precision used.");
+            m_maAutoAdjustSyncPeriod = configMASGD(L"autoAdjustSyncPeriod", false);
+#if 1           // legacy option
             if (configMASGD.Exists(L"syncFrequencyInFrames"))
             {
                 if (configMASGD.Exists(L"blockSizePerWorker") || configMASGD.Exists(L"blockSize"))
@@ -17,6 +17,7 @@
 #include "Config.h"
 #include <chrono>
 #include <random>
+#include <future>
 #include "Profiler.h"
 #include "MASGD.h"
 #include "ASGDHelper.h"
@@ -187,6 +188,11 @@ protected:
     // if m_maxTempMemSizeInSamples = SIZE_MAX (which means users do not specify the option) and m_numSubminiBatches > 1
     // we divide one minibatch to m_numSubminiBatches subMinibatches
 
+    // micro-batching: accumulate the gradients of this many reader minibatches before each
+    // aggregation round and weight update, decoupling the hardware batch from the effective batch
+    // default is 1, which means every minibatch updates
+    size_t m_gradientAccumulationSteps;
+
     // the number of samples in each epoch (0 means, use all the samples in each epoch).
     size_t m_epochSize;
     size_t m_maxComputedEpochSize;
@@ -197,6 +203,10 @@ protected:
     bool m_gradientClippingWithTruncation;
     double m_clippingThresholdPerSample;
 
+    // devices to spread the network over as model-parallel pipeline stages
+    // (empty = whole network on the single configured device)
+    intargvector m_pipelineDevices;
+
     intargvector m_numSamples4Search;
     size_t m_numBestSearchEpoch;
 
@@ -223,6 +233,10 @@ protected:
     size_t m_minibatchSearchCriterionErrorMargin;
     size_t m_minibatchSizeTuningFrequency;
     size_t m_minibatchSizeTuningMax;
+    // pick the minibatch size by hill-climbing on measured samples/sec instead of trial-epoch search
+    bool m_autoAdjustMinibatchByThroughput;
+    // relative throughput gain a grown minibatch size must deliver to be kept
+    double m_minibatchThroughputTuningMargin;
 
     doubleargvector m_dropoutRates;
     doubleargvector m_batchNormalizationTimeConstant;
@@ -269,13 +283,39 @@ protected:
     // n > 1: Show stats after every n sync
     int m_syncStatsTrace;
 
+    // fail with a clear error if not all workers respond within this many seconds at epoch
+    // boundaries, instead of hanging in the barrier when a worker was lost (0 = disabled)
+    double m_workerHealthCheckTimeout;
+
+    // time every MPI collective and report the per-rank wait/transfer split and arrival
+    // skew every this many collectives (0 = disabled)
+    size_t m_commTimingInterval;
+    // additionally log a straggler warning whenever the measured average arrival skew
+    // per collective exceeds this many seconds (0 = disabled)
+    double m_commSkewWarningThreshold;
+
     // Data parallel SGD training parameters
     intargvector m_numGradientBits;
+    // exchange only this many largest-magnitude entries per gradient column (0 = dense exchange)
+    size_t m_numGradientTopK;
+    // recompute quantization ranges exactly only every this many calls (0 = every call)
+    size_t m_quantRangeRecomputeStride;
+    // exchange the DistGradHeader one step behind the gradients (criterion logged one MB late)
+    bool m_asyncHeaderExchange;
+    // coalesce gradients into fusion buffers of up to this many MB per exchange (0 = per-matrix)
+    size_t m_fusionBufferSizeMB;
+    // start aggregating each gradient as backprop finalizes it, overlapping communication with
+    // the remaining backward computation
+    bool m_overlapGradientAgg;
     bool m_bufferedAsyncGradientAggregation;
     bool m_zeroThresholdFor1Bit;
 
     // Parallel training related with MA / BM
     size_t m_modelAggregationBlockSize;
+    // exchange quantized model deltas instead of full-precision parameters in ModelAveragingSGD (0 = full precision)
+    size_t m_maDeltaBits;
+    // stretch/relax the ModelAveragingSGD sync period based on measured communication time
+    bool m_maAutoAdjustSyncPeriod;
     bool   m_resetSGDMomentum; 
     bool   m_useNesterovBlockMomentum;
     double m_blockLearningRate; 
@@ -333,6 +373,7 @@ public:
           // TODO: The next few do not belong into SGD any more than the network or reader we operate on. Either move network and reader in here, or move these out.
           m_modelPath((const wstring&) configSGD(L"modelPath")),
           m_keepCheckPointFiles(configSGD(L"keepCheckPointFiles", false)),
+          m_asyncCheckpointing(configSGD(L"asyncCheckpointing", false)),
           m_trainCriterionNodeName((const wstring&) configSGD(L"trainCriterionNodeName", L"")),
           m_evalCriterionNodeName ((const wstring&) configSGD(L"evalCriterionNodeName", L"")),
           m_traceNodeNamesReal    (configSGD(L"traceNodeNamesReal",     ConfigRecordType::Array(stringargvector()))),
@@ -340,6 +381,14 @@ public:
           m_traceNodeNamesSparse  (configSGD(L"traceNodeNamesSparse",   ConfigRecordType::Array(stringargvector()))),
           m_prevChosenMinibatchSize(0),
           m_lastFinishedEpochTrainLoss(0.0),
+          m_lastEpochMBSize(0),
+          m_lastEpochSamplesPerSecond(0.0),
+          m_lastEpochLoss(0.0),
+          m_mbBaselineSize(0),
+          m_mbBaselineSamplesPerSecond(0.0),
+          m_mbBaselineLoss(0.0),
+          m_mbProbeHoldoff(0),
+          m_prestartedReaderEpoch(-1),
           m_distGradAgg(nullptr),
           m_gradHeader(nullptr)
     {
@@ -441,6 +490,9 @@ protected:
                                    std::list<Matrix<ElemType>>& smoothedGradients, std::vector<double> smoothedCounts,
                                    const double learningRateAdjustmentFactor);
 
+    // picks the next epoch's minibatch size by hill-climbing on measured samples/sec (no trial epochs)
+    size_t ThroughputAdaptiveMinibatchSizing(const int epochNumber, const size_t initialMinibatchSize);
+
     // uses a small percentage of training data of minibatch to
     // speculatively train with various MB sizes; then picks the best
     size_t SearchForBestMinibatchSize(ComputationNetworkPtr net,
@@ -515,6 +567,19 @@ protected:
                             const double prevCriterion,
                             const size_t minibatchSize);
 
+    // shared by the synchronous and background checkpoint paths; writes to the temp file and
+    // commits it via rename
+    void WriteCheckPointInfo(const std::wstring& tempFileName, const std::wstring& checkPointFileName,
+                             const size_t totalSamplesSeen,
+                             const double learnRatePerSample,
+                             const std::list<Matrix<ElemType>>& smoothedGradients,
+                             const std::vector<double>& smoothedCounts,
+                             const double prevCriterion,
+                             const size_t minibatchSize);
+
+    // blocks until a background checkpoint write dispatched by SaveCheckPointInfo() has committed
+    void WaitForPendingCheckpoint();
+
     bool TryLoadCheckPointInfo(const size_t epochNumber,
                                /*out*/ size_t& totalSamplesSeen,
                                /*out*/ double& learnRatePerSample,
@@ -552,6 +617,10 @@ public:
 protected:
     std::wstring m_modelPath;
     bool m_keepCheckPointFiles;
+    // write checkpoint info on a background thread from a CPU-side snapshot, so training
+    // continues while the (potentially slow, e.g. NFS) write is in flight
+    bool m_asyncCheckpointing;
+    std::future<void> m_pendingCheckpointWrite; // in-flight background checkpoint write, if any
 
     std::wstring m_trainCriterionNodeName;
     std::wstring m_evalCriterionNodeName;
@@ -564,6 +633,20 @@ protected:
     size_t m_prevChosenMinibatchSize;
     double m_lastFinishedEpochTrainLoss;
 
+    // state of the throughput-driven minibatch controller (autoAdjustMinibatchByThroughput):
+    // the last epoch's measurement and the best-known (baseline) size it is compared against
+    size_t m_lastEpochMBSize;
+    double m_lastEpochSamplesPerSecond;
+    double m_lastEpochLoss;
+    size_t m_mbBaselineSize;
+    double m_mbBaselineSamplesPerSecond;
+    double m_mbBaselineLoss;
+    size_t m_mbProbeHoldoff; // epochs to wait before probing a larger size again
+
+    // epoch (if any) for which the previous epoch boundary already restarted the training
+    // reader, so that chunk prefetch overlaps with validation and checkpointing; -1 if none
+    int m_prestartedReaderEpoch;
+
     std::shared_ptr<IDistGradAggregator<ElemType>> m_distGradAgg;
     std::shared_ptr<struct DistGradHeader> m_gradHeader;
 
@@ -599,6 +682,9 @@ private:
     {
         if (m_mpi != nullptr && GetParallelizationMethod() != ParallelizationMethod::dataParallelASGD)
         {
+            if (m_workerHealthCheckTimeout > 0 && !m_mpi->AllRanksResponding(m_workerHealthCheckTimeout))
+                RuntimeError("SynchronizeWorkers: not all %d workers responded within %.0f seconds; a worker has likely been lost.",
+                             (int) m_mpi->NumNodesInUse(), m_workerHealthCheckTimeout);
             m_mpi->WaitAll();
         }
         if (m_mpi != nullptr && GetParallelizationMethod() == ParallelizationMethod::dataParallelASGD)
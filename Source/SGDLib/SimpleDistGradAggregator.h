@@ -22,8 +22,14 @@ class SimpleDistGradAggregator : public IDistGradAggregator<ElemType>
     UsingIDistGradAggregatorMembers;
 
 public:
-    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace)
-        : IDistGradAggregator<ElemType>(mpi), m_useAsyncAggregation(useAsyncAggregation), m_initialized(false), m_bufferedGradHeader(nullptr), m_syncStatsTrace(syncStatsTrace), m_iterationCount(0), m_nccl(deviceId, mpi)
+    SimpleDistGradAggregator(const MPIWrapperPtr& mpi, bool useAsyncAggregation, int deviceId, int syncStatsTrace, bool useAsyncHeaderExchange = false, size_t fusionBufferSizeMB = 0)
+        : IDistGradAggregator<ElemType>(mpi), m_useAsyncAggregation(useAsyncAggregation), m_initialized(false), m_bufferedGradHeader(nullptr), m_syncStatsTrace(syncStatsTrace), m_iterationCount(0), m_nccl(deviceId, mpi),
+          // buffered async aggregation already overlaps the whole exchange with the next step's
+          // compute, so the header pipeline only applies to the synchronous gradient path
+          m_useAsyncHeaderExchange(useAsyncHeaderExchange && !useAsyncAggregation),
+          m_headerExchangeInFlight(false), m_havePipelinedHeader(false), m_inflightLocalHeader(nullptr), m_pipelinedAggHeader(nullptr),
+          m_fusionBufferBytes(fusionBufferSizeMB << 20),
+          m_overlapActive(false), m_nextPostUnit(-1), m_overlapDeviceId(CPUDEVICE), m_overlapGpuDirect(false)
     {}
 
     ~SimpleDistGradAggregator()
@@ -33,6 +39,12 @@ public:
 
         if (m_bufferedGradHeader != nullptr)
             DistGradHeader::Destroy(m_bufferedGradHeader);
+
+        if (m_inflightLocalHeader != nullptr)
+            DistGradHeader::Destroy(m_inflightLocalHeader);
+
+        if (m_pipelinedAggHeader != nullptr)
+            DistGradHeader::Destroy(m_pipelinedAggHeader);
     }
 
     // Aggregate the gradient matrices across all nodes
@@ -116,6 +128,14 @@ public:
 
             return false;
         }
+        else if (m_useAsyncHeaderExchange)
+        {
+            AggregateGradientsImplAsyncHeader(gradients, headerCPU, showSyncPerfStats);
+            // While the pipeline is filling (the very first call), the returned header is
+            // all-zero; report progress anyway so the epoch loop does not mistake it for
+            // end-of-data (same convention as the first call of buffered async aggregation)
+            return resetState || (headerCPU->numSamples != 0);
+        }
         else
         {
             AggregateGradientsImpl(gradients, headerCPU, showSyncPerfStats);
@@ -123,6 +143,219 @@ public:
         }
     }
 
+    // True when this aggregator can run the overlapped Begin/OnGradientReady/End protocol below;
+    // the async variants already overlap the exchange by other means and would conflict with it
+    bool SupportsOverlappedAggregation() const
+    {
+        return !m_useAsyncAggregation && !m_useAsyncHeaderExchange;
+    }
+
+    // Begin an overlapped aggregation for the current minibatch: the caller then signals
+    // OnGradientReady() for each gradient as backprop finalizes it, which lets the allreduce of
+    // finished reduction units (fusion buckets or single gradients) proceed while the remaining
+    // backward computation is still running, and finally calls EndAggregateGradientsOverlapped()
+    // to drain the exchange and complete the header aggregation. Returns false when overlapping
+    // cannot engage (the NCCL path issues its own stream-ordered collectives); the caller then
+    // falls back to AggregateGradients(). The outcome only depends on configuration, so all
+    // ranks take the same path.
+    bool BeginAggregateGradientsOverlapped(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState)
+    {
+        if (!SupportsOverlappedAggregation())
+            LogicError("BeginAggregateGradientsOverlapped: overlapped aggregation cannot be combined with async aggregation variants!");
+        if (m_overlapActive)
+            LogicError("BeginAggregateGradientsOverlapped: a previous overlapped aggregation was never completed!");
+
+        ResetState(gradients, headerCPU->numEvalNode, resetState);
+
+        if (m_nccl.IsSupported())
+            return false;
+
+        // Block-sparse gradients are exchanged with blocking collectives that do not fit the
+        // unit-by-unit posting below; the format of a gradient is fixed at allocation and the
+        // same on all ranks, so all ranks fall back together
+        for (size_t i = 0; i < gradients.size(); ++i)
+        {
+            if (gradients[i]->GetMatrixType() != DENSE)
+                return false;
+        }
+
+        m_overlapGradients = gradients;
+        m_overlapReduction = GetReductionMatrices(gradients);
+        size_t numUnits = m_overlapReduction.size();
+        m_overlapDeviceId = gradients[0]->GetDeviceId();
+        m_overlapGpuDirect = (m_overlapDeviceId >= 0) && m_mpi->IsGpuAware();
+
+        // Map each gradient to its reduction unit; a unit becomes ready once all of its
+        // gradients have been signalled
+        m_unitOfGradient.resize(gradients.size());
+        m_unitRemaining.assign(numUnits, 1);
+        if (UseFusionBuckets())
+        {
+            for (size_t b = 0; b < m_fusionBuckets.size(); ++b)
+            {
+                m_unitRemaining[b] = m_fusionBuckets[b].numGradients;
+                for (size_t i = m_fusionBuckets[b].firstGradient; i < (m_fusionBuckets[b].firstGradient + m_fusionBuckets[b].numGradients); ++i)
+                    m_unitOfGradient[i] = b;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < gradients.size(); ++i)
+                m_unitOfGradient[i] = i;
+        }
+
+        m_unitReady.assign(numUnits, false);
+        m_overlapOps.resize(numUnits);
+
+        // MPI requires nonblocking collectives to be posted in the same order on every rank,
+        // but gradients become ready in data-dependent order. Backprop finalizes parameters
+        // roughly in reverse registration order (output layers first), so we post units
+        // strictly in descending index order, each as soon as it and all higher-indexed units
+        // are ready.
+        m_nextPostUnit = (int) numUnits - 1;
+
+        m_overlapActive = true;
+        return true;
+    }
+
+    // Signal that backprop has finalized the gradient with the given index (position in the
+    // gradients vector passed to BeginAggregateGradientsOverlapped())
+    void OnGradientReady(size_t gradientIndex)
+    {
+        if (!m_overlapActive)
+            return;
+
+        size_t unit = m_unitOfGradient[gradientIndex];
+        if ((m_unitRemaining[unit] > 0) && (--m_unitRemaining[unit] == 0))
+            m_unitReady[unit] = true;
+
+        TryPostReadyUnits();
+    }
+
+    // Complete an overlapped aggregation: post any units that were not signalled during
+    // backprop, run the header exchange, and drain the gradient allreduces. Returns true if any
+    // samples were processed across all nodes (same convention as AggregateGradients()).
+    bool EndAggregateGradientsOverlapped(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU)
+    {
+        if (!m_overlapActive)
+            LogicError("EndAggregateGradientsOverlapped: no overlapped aggregation is in progress!");
+
+        bool showSyncPerfStats = (m_syncStatsTrace > 0) && ((m_iterationCount % m_syncStatsTrace) == 0);
+        m_iterationCount++;
+
+        Timer aggregationTimer;
+        if (showSyncPerfStats)
+            aggregationTimer.Start();
+
+        size_t numGradMatrices = gradients.size();
+        size_t numUnits = m_overlapReduction.size();
+
+        // If the current node did not process any samples, the gradients should be zero'd.
+        // No backprop ran in that case, so no unit has been posted yet and the zeroed
+        // buffers are what the flush below hands to MPI.
+        if (headerCPU->numSamples == 0)
+        {
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                gradients[i]->SetValue(0);
+        }
+
+        // Flush: whatever the callbacks did not post (or all units, when no backprop ran this
+        // minibatch) is posted now, still in descending index order
+        for (size_t i = 0; i < numUnits; ++i)
+            m_unitReady[i] = true;
+        TryPostReadyUnits();
+
+        // The header exchange mirrors AggregateGradientsImpl(): receive on the main node,
+        // aggregate, broadcast the aggregate back
+        std::vector<MPI_Request> recvHeaderRequests(NumProc() - 1);
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int source = (j >= MyRank()) ? (j + 1) : j;
+                MPI_Irecv(m_recvHeaders[j], m_recvHeaders[j]->Size(), MPI_CHAR, source, numGradMatrices, m_mpi->Communicator(), &(recvHeaderRequests[j])) || MpiFail("MPI_Irecv");
+            }
+        }
+
+        MPI_Request sendHeaderRequest;
+        if (!m_mpi->IsMainNode())
+            MPI_Isend(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices, m_mpi->Communicator(), &sendHeaderRequest) || MpiFail("MPI_Isend");
+
+        if (m_mpi->IsMainNode())
+        {
+            size_t numNodesHeadersReceivedFrom = 0;
+            while (numNodesHeadersReceivedFrom < (NumProc() - 1))
+            {
+                int idx = MPI_UNDEFINED;
+                MPI_Waitany(recvHeaderRequests.size(), recvHeaderRequests.data(), &idx, MPI_STATUS_IGNORE) || MpiFail("MPI_Waitany");
+                if (idx == MPI_UNDEFINED)
+                    break;
+
+                numNodesHeadersReceivedFrom++;
+                headerCPU->Aggregate(m_recvHeaders[idx], true);
+            }
+
+            assert(numNodesHeadersReceivedFrom == (NumProc() - 1));
+        }
+
+        MPI_Request recvAggHeaderRequest;
+        if (!m_mpi->IsMainNode())
+            MPI_Irecv(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &recvAggHeaderRequest) || MpiFail("MPI_Irecv");
+
+        std::vector<MPI_Request> sendAggHeaderRequests(NumProc() - 1);
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int dest = (j >= MyRank()) ? (j + 1) : j;
+                MPI_Isend(headerCPU, headerCPU->Size(), MPI_CHAR, dest, numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &(sendAggHeaderRequests[j])) || MpiFail("MPI_Isend");
+            }
+        }
+
+        // Drain the gradient allreduces in the same descending order they were posted and
+        // initiate the transfer back to the GPU if needed. With the MPI progress thread
+        // enabled this returns as soon as the progress thread has seen each request complete;
+        // without it, WaitAsync degrades to a plain MPI_Wait.
+        for (size_t i = numUnits; i-- > 0;)
+        {
+            m_mpi->WaitAsync(&m_overlapOps[i]);
+            if ((m_overlapDeviceId >= 0) && !m_overlapGpuDirect)
+                m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].get(), m_overlapReduction[i]->GetNumElements(), m_overlapReduction[i]->Data());
+        }
+
+        // Wait to receive aggregate header
+        if (!m_mpi->IsMainNode())
+            MPI_Wait(&recvAggHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+
+        // Wait for all the transfers to finish
+        if ((m_overlapDeviceId >= 0) && !m_overlapGpuDirect)
+        {
+            for (size_t i = 0; i < numUnits; ++i)
+                m_gpuDataTransferers[i]->WaitForCopyCPUToGPUAsync();
+        }
+
+        // Scatter the aggregated fusion buffers back into the individual gradients
+        if (UseFusionBuckets())
+            UnpackFusionBuckets(gradients);
+
+        // Wait for completion of the async send requests
+        if (!m_mpi->IsMainNode())
+            MPI_Wait(&sendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+        else
+            MPI_Waitall(sendAggHeaderRequests.size(), sendAggHeaderRequests.data(), MPI_STATUSES_IGNORE) || MpiFail("MPI_Waitall");
+
+        m_overlapActive = false;
+
+        if (showSyncPerfStats)
+        {
+            aggregationTimer.Stop();
+            double gradientAggregationTime = aggregationTimer.ElapsedSeconds();
+            fprintf(stderr, "Actual gradient aggregation time: %.6g\n", gradientAggregationTime);
+        }
+
+        return (headerCPU->numSamples != 0);
+    }
+
 private:
     std::shared_ptr<ElemType> AllocateIntermediateBuffer(int deviceID, size_t numElements)
     {
@@ -136,6 +369,194 @@ private:
                                          });
     }
 
+    // A contiguous run of gradient matrices aggregated as one unit. Buckets with more than one
+    // gradient pack their members into 'buffer' before the exchange and scatter the aggregate
+    // back afterwards; single-gradient buckets are aggregated in place.
+    struct FusionBucket
+    {
+        size_t firstGradient = 0; // index into the gradients vector
+        size_t numGradients = 0;
+        size_t numElements = 0;
+        std::shared_ptr<Matrix<ElemType>> buffer; // 1 x numElements, on the aggregation device
+    };
+
+    bool UseFusionBuckets() const
+    {
+        return !m_fusionBuckets.empty();
+    }
+
+    // The matrices the exchange actually runs over: the fusion buffer for packed buckets, the
+    // gradient itself for single-gradient buckets, or simply the gradients vector when fusion
+    // is disabled. The bucket layout only depends on the gradient shapes, so this is also valid
+    // for the swapped-in buffered gradients of async aggregation.
+    std::vector<Matrix<ElemType>*> GetReductionMatrices(const std::vector<Matrix<ElemType>*>& gradients) const
+    {
+        if (!UseFusionBuckets())
+            return gradients;
+
+        std::vector<Matrix<ElemType>*> reductionMatrices;
+        for (auto& bucket : m_fusionBuckets)
+            reductionMatrices.push_back((bucket.numGradients > 1) ? bucket.buffer.get() : gradients[bucket.firstGradient]);
+
+        return reductionMatrices;
+    }
+
+    // Gather a packed bucket's gradients into its fusion buffer
+    void PackFusionBucket(const FusionBucket& bucket, const std::vector<Matrix<ElemType>*>& gradients)
+    {
+        size_t offset = 0;
+        for (size_t i = bucket.firstGradient; i < (bucket.firstGradient + bucket.numGradients); ++i)
+        {
+            size_t numElements = gradients[i]->GetNumElements();
+            bucket.buffer->ColumnSlice(offset, numElements).AssignValuesOf(gradients[i]->Reshaped(1, numElements));
+            offset += numElements;
+        }
+    }
+
+    // Gather each packed bucket's gradients into its fusion buffer
+    void PackFusionBuckets(const std::vector<Matrix<ElemType>*>& gradients)
+    {
+        for (auto& bucket : m_fusionBuckets)
+        {
+            if (bucket.numGradients >= 2)
+                PackFusionBucket(bucket, gradients);
+        }
+    }
+
+    // Scatter the aggregated fusion buffers back into the individual gradients
+    void UnpackFusionBuckets(const std::vector<Matrix<ElemType>*>& gradients)
+    {
+        for (auto& bucket : m_fusionBuckets)
+        {
+            if (bucket.numGradients < 2)
+                continue;
+
+            size_t offset = 0;
+            for (size_t i = bucket.firstGradient; i < (bucket.firstGradient + bucket.numGradients); ++i)
+            {
+                size_t numElements = gradients[i]->GetNumElements();
+                gradients[i]->AssignValuesOf(bucket.buffer->ColumnSlice(offset, numElements).Reshaped(gradients[i]->GetNumRows(), gradients[i]->GetNumCols()));
+                offset += numElements;
+            }
+        }
+    }
+
+    // Post the allreduce for every unit that is ready and next in the descending posting order
+    // (see BeginAggregateGradientsOverlapped() for why the order must be fixed)
+    void TryPostReadyUnits()
+    {
+        while ((m_nextPostUnit >= 0) && m_unitReady[m_nextPostUnit])
+        {
+            PostUnit((size_t) m_nextPostUnit);
+            m_nextPostUnit--;
+        }
+    }
+
+    void PostUnit(size_t unit)
+    {
+        if (UseFusionBuckets() && (m_fusionBuckets[unit].numGradients > 1))
+            PackFusionBucket(m_fusionBuckets[unit], m_overlapGradients);
+
+        Matrix<ElemType>* reductionMatrix = m_overlapReduction[unit];
+        ElemType* reductionBuffer = reductionMatrix->Data();
+        if (m_overlapDeviceId >= 0)
+        {
+            // The gradient kernels for this unit (and any fusion-bucket packing) may still be
+            // in flight on the main compute stream when this is called from mid-backprop
+            std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(m_overlapDeviceId));
+            if (m_overlapGpuDirect)
+            {
+                // CUDA-aware MPI reads the device buffer outside of any CUDA stream ordering
+                mainStreamSyncEvent->SynchronizeEvent();
+            }
+            else
+            {
+                mainStreamSyncEvent->SynchronizeDataTransferFetchStreamWithEvent<ElemType>();
+                m_gpuDataTransferers[unit]->CopyGPUToCPUAsync(reductionMatrix->Data(), reductionMatrix->GetNumElements(), m_intermediateCPUBuffers[unit].get());
+                m_gpuDataTransferers[unit]->WaitForCopyGPUToCPUAsync();
+                reductionBuffer = m_intermediateCPUBuffers[unit].get();
+            }
+        }
+
+        MPI_Iallreduce(MPI_IN_PLACE, reductionBuffer, reductionMatrix->GetNumElements(),
+                       MPIWrapper::GetDataType(reductionBuffer), MPI_SUM,
+                       m_mpi->Communicator(), &m_overlapOps[unit].request) || MpiFail("MPI_Iallreduce");
+        // without the progress thread, most MPI stacks would sit on this Iallreduce until the
+        // drain loop enters MPI_Wait; with it, the reduction advances while backprop continues
+        m_mpi->TrackAsync(&m_overlapOps[unit]);
+    }
+
+    // Aggregate a block-sparse-column gradient (e.g. of an embedding matrix fed with sparse
+    // input) across all nodes. Each rank contributes only the column blocks its minibatch
+    // touched: the block ids and values are allgathered, blocks of columns touched by more than
+    // one rank are summed locally, and the gradient is rebuilt from the merged blocks. The wire
+    // traffic is thus proportional to the union of touched blocks instead of the full dense
+    // size of the gradient.
+    void AggregateSparseBlockColGradient(Matrix<ElemType>& gradient)
+    {
+        size_t numRows = gradient.GetNumRows();
+        size_t numCols = gradient.GetNumCols();
+
+        std::vector<size_t> blockIds;
+        std::vector<ElemType> blockValues;
+        gradient.GetMatrixFromSBCFormat(blockIds, blockValues);
+
+        // Exchange the per-rank block counts
+        int numBlocks = (int) blockIds.size();
+        std::vector<int> blockCounts(NumProc());
+        MPI_Allgather(&numBlocks, 1, MPI_INT, blockCounts.data(), 1, MPI_INT, m_mpi->Communicator()) || MpiFail("MPI_Allgather");
+
+        int totalBlocks = 0;
+        std::vector<int> idDispls(NumProc());
+        std::vector<int> valueCounts(NumProc());
+        std::vector<int> valueDispls(NumProc());
+        for (size_t r = 0; r < NumProc(); ++r)
+        {
+            idDispls[r] = totalBlocks;
+            valueCounts[r] = blockCounts[r] * (int) numRows;
+            valueDispls[r] = totalBlocks * (int) numRows;
+            totalBlocks += blockCounts[r];
+        }
+
+        // Gather every rank's block ids and values
+        std::vector<long long> localIds(blockIds.begin(), blockIds.end());
+        std::vector<long long> allIds(totalBlocks);
+        MPI_Allgatherv(localIds.data(), numBlocks, MPI_LONG_LONG_INT,
+                       allIds.data(), blockCounts.data(), idDispls.data(), MPI_LONG_LONG_INT,
+                       m_mpi->Communicator()) || MpiFail("MPI_Allgatherv");
+
+        std::vector<ElemType> allValues((size_t) totalBlocks * numRows);
+        MPI_Allgatherv(blockValues.data(), numBlocks * (int) numRows, MPIWrapper::GetDataType(blockValues.data()),
+                       allValues.data(), valueCounts.data(), valueDispls.data(), MPIWrapper::GetDataType(allValues.data()),
+                       m_mpi->Communicator()) || MpiFail("MPI_Allgatherv");
+
+        // Sum the blocks of columns that more than one rank touched
+        std::unordered_map<size_t, size_t> blockOfColumn; // column index -> index into the merged blocks
+        std::vector<size_t> mergedIds;
+        std::vector<ElemType> mergedValues;
+        mergedIds.reserve(totalBlocks);
+        mergedValues.reserve((size_t) totalBlocks * numRows);
+        for (size_t j = 0; j < (size_t) totalBlocks; ++j)
+        {
+            size_t column = (size_t) allIds[j];
+            auto inserted = blockOfColumn.insert(std::make_pair(column, mergedIds.size()));
+            if (inserted.second)
+            {
+                mergedIds.push_back(column);
+                mergedValues.insert(mergedValues.end(), allValues.begin() + (j * numRows), allValues.begin() + ((j + 1) * numRows));
+            }
+            else
+            {
+                ElemType* mergedBlock = mergedValues.data() + (inserted.first->second * numRows);
+                const ElemType* gatheredBlock = allValues.data() + (j * numRows);
+                for (size_t k = 0; k < numRows; ++k)
+                    mergedBlock[k] += gatheredBlock[k];
+            }
+        }
+
+        gradient.SetMatrixFromSBCFormat(mergedIds.data(), mergedValues.data(), mergedIds.size(), numRows, numCols);
+    }
+
     void ResetState(const std::vector<Matrix<ElemType>*>& gradients, int numEvalNodes, bool resetState)
     {
         // When called the first time let's setup the intermediateCPU buffers for gradient aggregation if needed
@@ -144,31 +565,107 @@ private:
             m_initialized = true;
             int deviceId = gradients[0]->GetDeviceId();
 
-            if (!m_nccl.IsSupported() && deviceId != CPUDEVICE)
+            if (!m_nccl.IsSupported() && deviceId != CPUDEVICE && !m_mpi->IsGpuAware())
                 m_allocator.reset(new CUDAPageLockedMemAllocator(deviceId));
 
             for (size_t i = 0; i < gradients.size(); i++)
             {
-                // Make sure none of the gradient matrixes are sparse - we currently do not support aggregation of sparse gradient matrices
+                // Block-sparse-column gradients (e.g. of an embedding matrix fed with sparse input)
+                // are aggregated by exchanging only their touched blocks; this is only wired into
+                // the synchronous MPI path below, and no other sparse format is supported
                 if (gradients[i]->GetMatrixType() != DENSE)
-                    RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
-
-                if (!m_nccl.IsSupported() && deviceId != CPUDEVICE)
                 {
-                    m_gpuDataTransferers.push_back(std::make_unique<GPUDataTransferer>(deviceId, m_useAsyncAggregation));
-                    m_intermediateCPUBuffers.push_back(AllocateIntermediateBuffer(deviceId, gradients[i]->GetNumElements()));
+                    if (gradients[i]->GetFormat() != MatrixFormat::matrixFormatSparseBlockCol)
+                        RuntimeError("Gradient aggregation is only supported for dense and block-sparse-column gradient matrices!");
+                    if (m_useAsyncAggregation || m_useAsyncHeaderExchange || m_nccl.IsSupported())
+                        RuntimeError("Gradient aggregation for sparse gradient matrices is only supported with synchronous MPI aggregation!");
                 }
 
                 if (m_useAsyncAggregation)
                     m_bufferedGradients[gradients[i]].reset(new Matrix<ElemType>(gradients[i]->GetNumRows(), gradients[i]->GetNumCols(), deviceId));
             }
 
+            // Build the fusion plan once from the registration-order layout of the gradients
+            // vector: consecutive gradients are coalesced into fusion buffers of up to
+            // m_fusionBufferBytes, so that many small latency-bound exchanges become a few
+            // bandwidth-bound ones. A gradient that fills a bucket by itself stays unpacked
+            // and is aggregated in place, saving the pack/unpack copies.
+            if ((m_fusionBufferBytes > 0) && (gradients.size() > 1))
+            {
+                size_t i = 0;
+                while (i < gradients.size())
+                {
+                    FusionBucket bucket;
+                    bucket.firstGradient = i;
+                    while (i < gradients.size())
+                    {
+                        // A sparse gradient cannot be packed into the dense fusion buffer; it
+                        // gets a bucket of its own and is aggregated via its touched blocks
+                        if (gradients[i]->GetMatrixType() != DENSE)
+                        {
+                            if (bucket.numGradients == 0)
+                            {
+                                bucket.numGradients = 1;
+                                i++;
+                            }
+                            break;
+                        }
+
+                        size_t numElements = gradients[i]->GetNumElements();
+                        if ((bucket.numGradients > 0) && (((bucket.numElements + numElements) * sizeof(ElemType)) > m_fusionBufferBytes))
+                            break;
+
+                        bucket.numElements += numElements;
+                        bucket.numGradients++;
+                        i++;
+
+                        if ((bucket.numElements * sizeof(ElemType)) >= m_fusionBufferBytes)
+                            break;
+                    }
+
+                    if (bucket.numGradients > 1)
+                        bucket.buffer = std::make_shared<Matrix<ElemType>>(1, bucket.numElements, deviceId);
+
+                    m_fusionBuckets.push_back(bucket);
+                }
+            }
+
+            // One CPU staging buffer and transferer per reduction unit (fusion bucket or
+            // unpacked gradient); with CUDA-aware MPI the device buffers are handed to MPI
+            // directly and no staging is needed
+            if (!m_nccl.IsSupported() && deviceId != CPUDEVICE && !m_mpi->IsGpuAware())
+            {
+                std::vector<Matrix<ElemType>*> reductionMatrices = GetReductionMatrices(gradients);
+                for (size_t i = 0; i < reductionMatrices.size(); i++)
+                {
+                    // Sparse reduction units are staged through a compact host copy of their
+                    // touched blocks at aggregation time, not through a fixed-size pinned buffer
+                    if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    {
+                        m_gpuDataTransferers.push_back(nullptr);
+                        m_intermediateCPUBuffers.push_back(nullptr);
+                        continue;
+                    }
+
+                    m_gpuDataTransferers.push_back(std::make_unique<GPUDataTransferer>(deviceId, m_useAsyncAggregation));
+                    m_intermediateCPUBuffers.push_back(AllocateIntermediateBuffer(deviceId, reductionMatrices[i]->GetNumElements()));
+                }
+            }
+
             if (m_useAsyncAggregation)
             {
                 m_bufferedGradHeader = DistGradHeader::Create(numEvalNodes);
                 m_bufferedGradHeader->Clear();
             }
 
+            if (m_useAsyncHeaderExchange)
+            {
+                m_inflightLocalHeader = DistGradHeader::Create(numEvalNodes);
+                m_inflightLocalHeader->Clear();
+                m_pipelinedAggHeader = DistGradHeader::Create(numEvalNodes);
+                m_pipelinedAggHeader->Clear();
+            }
+
             if (m_mpi->IsMainNode())
             {
                 for (size_t i = 0; i < NumProc() - 1; ++i)
@@ -223,11 +720,34 @@ private:
             }
         }
 
+        // Coalesce the gradients into the fusion buffers; the exchange below then runs over one
+        // buffer per bucket instead of one message per gradient matrix
+        if (UseFusionBuckets())
+            PackFusionBuckets(gradients);
+        std::vector<Matrix<ElemType>*> reductionMatrices = GetReductionMatrices(gradients);
+        size_t numReductions = reductionMatrices.size();
+
+        // With CUDA-aware MPI the allreduce operates on the device buffers in place and the
+        // page-locked staging copies below are skipped
+        bool gpuDirectMpi = !m_nccl.IsSupported() && (deviceId >= 0) && m_mpi->IsGpuAware();
+        if (gpuDirectMpi)
+        {
+            // CUDA-aware MPI reads the device buffers outside of any CUDA stream ordering, so
+            // the gradient kernels (and any fusion-bucket packing) must have completed first
+            std::unique_ptr<MatrixComputeStreamEvent> gpuDirectSyncEvent(MatrixComputeStreamEvent::Create(deviceId));
+            gpuDirectSyncEvent->SynchronizeEvent();
+        }
+
         // Initiate transfer of the gradient matrices to the CPU if needed
-        if (!m_nccl.IsSupported() && deviceId >= 0)
+        if (!m_nccl.IsSupported() && deviceId >= 0 && !gpuDirectMpi)
         {
-            for (size_t i = 0; i < numGradMatrices; ++i)
-                m_gpuDataTransferers[i]->CopyGPUToCPUAsync(gradients[i]->Data(), gradients[i]->GetNumElements(), m_intermediateCPUBuffers[i].get());
+            for (size_t i = 0; i < numReductions; ++i)
+            {
+                if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    continue;
+
+                m_gpuDataTransferers[i]->CopyGPUToCPUAsync(reductionMatrices[i]->Data(), reductionMatrices[i]->GetNumElements(), m_intermediateCPUBuffers[i].get());
+            }
         }
 
         // Initiate receive of the header on the main node
@@ -248,26 +768,39 @@ private:
             MPI_Isend(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices, m_mpi->Communicator(), &sendHeaderRequest) || MpiFail("MPI_Isend");
 
         // Perform async allreduce on the gradient data
-        std::vector<MPI_Request> allReduceRequests(numGradMatrices);
+        std::vector<MPI_Request> allReduceRequests(numReductions);
         if (!m_nccl.IsSupported())
         {
-            for (size_t i = 0; i < numGradMatrices; ++i)
+            for (size_t i = 0; i < numReductions; ++i)
             {
-                ElemType* reductionBuffer = gradients[i]->Data();
-                if (deviceId >= 0)
+                if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    continue;
+
+                ElemType* reductionBuffer = reductionMatrices[i]->Data();
+                if ((deviceId >= 0) && !gpuDirectMpi)
                 {
                     m_gpuDataTransferers[i]->WaitForCopyGPUToCPUAsync();
                     reductionBuffer = m_intermediateCPUBuffers[i].get();
                 }
 
                 // On Windows this async MPI_Iallreduce call requires MS MPI v7 or higher to be installed
-                MPI_Iallreduce(MPI_IN_PLACE, reductionBuffer, gradients[i]->GetNumElements(),
+                MPI_Iallreduce(MPI_IN_PLACE, reductionBuffer, reductionMatrices[i]->GetNumElements(),
                                MPIWrapper::GetDataType(reductionBuffer), MPI_SUM,
                                m_mpi->Communicator(), &allReduceRequests[i]) || MpiFail("MPI_Iallreduce");
             }
+
+            // Aggregate the block-sparse gradients by exchanging only their touched blocks.
+            // This exchange is blocking, but runs while the dense allreduces above make progress;
+            // every rank has the same sparse units, so all ranks reach the collectives in the
+            // same order.
+            for (size_t i = 0; i < numReductions; ++i)
+            {
+                if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    AggregateSparseBlockColGradient(*reductionMatrices[i]);
+            }
         }
         else
-            m_nccl.AllReduce(gradients);
+            m_nccl.AllReduce(reductionMatrices);
 
         // On the main node wait for the headers to arrive and aggregate
         if (m_mpi->IsMainNode())
@@ -310,11 +843,14 @@ private:
         // Wait for the allreduce operations to finish and initiate transfer back to the GPU if needed
         if (!m_nccl.IsSupported())
         {
-            for (size_t i = 0; i < numGradMatrices; ++i)
+            for (size_t i = 0; i < numReductions; ++i)
             {
+                if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    continue;
+
                 MPI_Wait(&allReduceRequests[i], MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
-                if (deviceId >= 0)
-                    m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].get(), gradients[i]->GetNumElements(), gradients[i]->Data());
+                if ((deviceId >= 0) && !gpuDirectMpi)
+                    m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].get(), reductionMatrices[i]->GetNumElements(), reductionMatrices[i]->Data());
             }
         }
 
@@ -325,12 +861,21 @@ private:
         // Wait for all the transfers to finish
         if (m_nccl.IsSupported())
             m_nccl.Sync();
-        else if (deviceId >= 0)
+        else if ((deviceId >= 0) && !gpuDirectMpi)
         {
-            for (size_t i = 0; i < numGradMatrices; ++i)
+            for (size_t i = 0; i < numReductions; ++i)
+            {
+                if (reductionMatrices[i]->GetMatrixType() != DENSE)
+                    continue;
+
                 m_gpuDataTransferers[i]->WaitForCopyCPUToGPUAsync();
+            }
         }
 
+        // Scatter the aggregated fusion buffers back into the individual gradients
+        if (UseFusionBuckets())
+            UnpackFusionBuckets(gradients);
+
         // Wait for completion of the async send requests
         if (!m_mpi->IsMainNode())
             MPI_Wait(&sendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
@@ -345,6 +890,188 @@ private:
         }
     }
 
+    // Variant of AggregateGradientsImpl() that runs the header exchange one step behind the
+    // gradient exchange. The header is tiny but completing its round trip (send to the main
+    // node, aggregate, broadcast back) inside every call adds a sync point; here each call only
+    // *initiates* the exchange of its own header and hands the caller the aggregate of the
+    // previous call's headers, which had the whole intervening compute to arrive. The caller
+    // thus sees criterion/sample counts one minibatch late, which SGD tolerates for logging and
+    // normalization the same way buffered async aggregation does. Gradients are still exchanged
+    // synchronously and are exact.
+    void AggregateGradientsImplAsyncHeader(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool showSyncPerfStats)
+    {
+        Timer aggregationTimer;
+        int deviceId = gradients[0]->GetDeviceId();
+        if (showSyncPerfStats)
+        {
+            std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(deviceId));
+            mainStreamSyncEvent->SynchronizeEvent();
+            aggregationTimer.Start();
+        }
+
+        size_t numGradMatrices = gradients.size();
+
+        // If the current node did not process any samples, the gradients should be zero'd
+        if (headerCPU->numSamples == 0)
+        {
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                gradients[i]->SetValue(0);
+        }
+
+        // Coalesce the gradients into the fusion buffers; the exchange below then runs over one
+        // buffer per bucket instead of one message per gradient matrix
+        if (UseFusionBuckets())
+            PackFusionBuckets(gradients);
+        std::vector<Matrix<ElemType>*> reductionMatrices = GetReductionMatrices(gradients);
+        size_t numReductions = reductionMatrices.size();
+
+        // With CUDA-aware MPI the allreduce operates on the device buffers in place and the
+        // page-locked staging copies below are skipped
+        bool gpuDirectMpi = !m_nccl.IsSupported() && (deviceId >= 0) && m_mpi->IsGpuAware();
+        if (gpuDirectMpi)
+        {
+            // CUDA-aware MPI reads the device buffers outside of any CUDA stream ordering, so
+            // the gradient kernels (and any fusion-bucket packing) must have completed first
+            std::unique_ptr<MatrixComputeStreamEvent> gpuDirectSyncEvent(MatrixComputeStreamEvent::Create(deviceId));
+            gpuDirectSyncEvent->SynchronizeEvent();
+        }
+
+        // Initiate transfer of the gradient matrices to the CPU if needed
+        if (!m_nccl.IsSupported() && deviceId >= 0 && !gpuDirectMpi)
+        {
+            for (size_t i = 0; i < numReductions; ++i)
+                m_gpuDataTransferers[i]->CopyGPUToCPUAsync(reductionMatrices[i]->Data(), reductionMatrices[i]->GetNumElements(), m_intermediateCPUBuffers[i].get());
+        }
+
+        // Complete the header exchange initiated on the previous call; its messages had the whole
+        // intervening minibatch compute to arrive, so these waits do not stall in steady state
+        CompleteInflightHeaderExchange(numGradMatrices);
+
+        // Perform allreduce on the gradient data
+        std::vector<MPI_Request> allReduceRequests(numReductions);
+        if (!m_nccl.IsSupported())
+        {
+            for (size_t i = 0; i < numReductions; ++i)
+            {
+                ElemType* reductionBuffer = reductionMatrices[i]->Data();
+                if ((deviceId >= 0) && !gpuDirectMpi)
+                {
+                    m_gpuDataTransferers[i]->WaitForCopyGPUToCPUAsync();
+                    reductionBuffer = m_intermediateCPUBuffers[i].get();
+                }
+
+                MPI_Iallreduce(MPI_IN_PLACE, reductionBuffer, reductionMatrices[i]->GetNumElements(),
+                               MPIWrapper::GetDataType(reductionBuffer), MPI_SUM,
+                               m_mpi->Communicator(), &allReduceRequests[i]) || MpiFail("MPI_Iallreduce");
+            }
+
+            for (size_t i = 0; i < numReductions; ++i)
+            {
+                MPI_Wait(&allReduceRequests[i], MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+                if ((deviceId >= 0) && !gpuDirectMpi)
+                    m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].get(), reductionMatrices[i]->GetNumElements(), reductionMatrices[i]->Data());
+            }
+        }
+        else
+            m_nccl.AllReduce(reductionMatrices);
+
+        // Snapshot the local header, then replace the caller's copy with the one-step-delayed
+        // aggregate (an all-zero header on the very first call, while the pipeline fills)
+        m_inflightLocalHeader->Aggregate(headerCPU, false);
+        if (m_havePipelinedHeader)
+            headerCPU->Aggregate(m_pipelinedAggHeader, false);
+        else
+            headerCPU->Clear();
+
+        // Initiate the exchange of this call's header; it is completed on the next call
+        StartInflightHeaderExchange(numGradMatrices);
+
+        // Wait for all the transfers to finish
+        if (m_nccl.IsSupported())
+            m_nccl.Sync();
+        else if ((deviceId >= 0) && !gpuDirectMpi)
+        {
+            for (size_t i = 0; i < numReductions; ++i)
+                m_gpuDataTransferers[i]->WaitForCopyCPUToGPUAsync();
+        }
+
+        // Scatter the aggregated fusion buffers back into the individual gradients
+        if (UseFusionBuckets())
+            UnpackFusionBuckets(gradients);
+
+        if (showSyncPerfStats)
+        {
+            aggregationTimer.Stop();
+            double gradientAggregationTime = aggregationTimer.ElapsedSeconds();
+            fprintf(stderr, "Actual gradient aggregation time: %.6g\n", gradientAggregationTime);
+        }
+    }
+
+    void StartInflightHeaderExchange(size_t numGradMatrices)
+    {
+        if (m_mpi->IsMainNode())
+        {
+            m_inflightRecvHeaderRequests.resize(NumProc() - 1);
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int source = (j >= MyRank()) ? (j + 1) : j;
+                // We use a tag of 'numGradMatrices' for the pre-aggregation header
+                MPI_Irecv(m_recvHeaders[j], m_recvHeaders[j]->Size(), MPI_CHAR, source, numGradMatrices, m_mpi->Communicator(), &(m_inflightRecvHeaderRequests[j])) || MpiFail("MPI_Irecv");
+            }
+        }
+        else
+        {
+            MPI_Isend(m_inflightLocalHeader, m_inflightLocalHeader->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices, m_mpi->Communicator(), &m_inflightSendHeaderRequest) || MpiFail("MPI_Isend");
+            MPI_Irecv(m_pipelinedAggHeader, m_pipelinedAggHeader->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &m_inflightRecvAggHeaderRequest) || MpiFail("MPI_Irecv");
+        }
+
+        m_headerExchangeInFlight = true;
+    }
+
+    void CompleteInflightHeaderExchange(size_t numGradMatrices)
+    {
+        if (!m_headerExchangeInFlight)
+            return;
+
+        if (m_mpi->IsMainNode())
+        {
+            // Aggregate our own header from the previous call with everyone else's
+            m_pipelinedAggHeader->Aggregate(m_inflightLocalHeader, false);
+
+            size_t numNodesHeadersReceivedFrom = 0;
+            while (numNodesHeadersReceivedFrom < (NumProc() - 1))
+            {
+                int idx = MPI_UNDEFINED;
+                MPI_Waitany(m_inflightRecvHeaderRequests.size(), m_inflightRecvHeaderRequests.data(), &idx, MPI_STATUS_IGNORE) || MpiFail("MPI_Waitany");
+                if (idx == MPI_UNDEFINED)
+                    break;
+
+                numNodesHeadersReceivedFrom++;
+                m_pipelinedAggHeader->Aggregate(m_recvHeaders[idx], true);
+            }
+
+            assert(numNodesHeadersReceivedFrom == (NumProc() - 1));
+
+            // Send the aggregate back out; the receivers posted their Irecv when they initiated
+            // the exchange, so these sends complete without waiting on the other ranks' progress
+            std::vector<MPI_Request> sendAggHeaderRequests(NumProc() - 1);
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int dest = (j >= MyRank()) ? (j + 1) : j;
+                MPI_Isend(m_pipelinedAggHeader, m_pipelinedAggHeader->Size(), MPI_CHAR, dest, numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &(sendAggHeaderRequests[j])) || MpiFail("MPI_Isend");
+            }
+            MPI_Waitall(sendAggHeaderRequests.size(), sendAggHeaderRequests.data(), MPI_STATUSES_IGNORE) || MpiFail("MPI_Waitall");
+        }
+        else
+        {
+            MPI_Wait(&m_inflightRecvAggHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+            MPI_Wait(&m_inflightSendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+        }
+
+        m_headerExchangeInFlight = false;
+        m_havePipelinedHeader = true;
+    }
+
 private:
     std::unique_ptr<CUDAPageLockedMemAllocator> m_allocator;
     std::vector<std::shared_ptr<ElemType>> m_intermediateCPUBuffers;
@@ -370,6 +1097,34 @@ private:
 
     bool m_initialized;
 
+    // Exchange the tiny DistGradHeader one step behind the gradients (see
+    // AggregateGradientsImplAsyncHeader); the caller consumes one-step-delayed criterion values
+    bool m_useAsyncHeaderExchange;
+    bool m_headerExchangeInFlight;
+    bool m_havePipelinedHeader;
+    DistGradHeader* m_inflightLocalHeader; // snapshot of the local header currently in flight
+    DistGradHeader* m_pipelinedAggHeader;  // aggregate of the previous call's headers
+    std::vector<MPI_Request> m_inflightRecvHeaderRequests;
+    MPI_Request m_inflightSendHeaderRequest;
+    MPI_Request m_inflightRecvAggHeaderRequest;
+
+    // Cap on a fusion buffer's size in bytes; 0 disables bucketing (see ResetState() for how
+    // the plan is built)
+    size_t m_fusionBufferBytes;
+    std::vector<FusionBucket> m_fusionBuckets;
+
+    // State of the current overlapped aggregation (see BeginAggregateGradientsOverlapped())
+    bool m_overlapActive;
+    int m_nextPostUnit;     // next unit in the descending posting order; -1 once all are posted
+    int m_overlapDeviceId;
+    bool m_overlapGpuDirect;
+    std::vector<Matrix<ElemType>*> m_overlapGradients;
+    std::vector<Matrix<ElemType>*> m_overlapReduction;
+    std::vector<size_t> m_unitOfGradient; // gradient index -> reduction unit
+    std::vector<size_t> m_unitRemaining;  // per unit: gradients still awaiting their ready signal
+    std::vector<bool> m_unitReady;
+    std::vector<MPIWrapper::AsyncOperation> m_overlapOps; // per unit: the in-flight allreduce, tracked by the progress thread when enabled
+
     NcclComm m_nccl;
 };
 } } }
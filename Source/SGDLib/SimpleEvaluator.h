@@ -25,6 +25,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <future>
 
 using namespace std;
 
@@ -100,7 +101,6 @@ public:
 
         m_net->StartEvaluateMinibatchLoop(evalNodes);
 
-        std::vector<Matrix<ElemType>*> learnParamsGradients;
         DataReaderHelpers::SubminibatchDispatcher<ElemType> smbDispatcher;
         size_t numSubminibatchesNeeded = DataReaderHelpers::GetNumSubminibatchesNeeded<ElemType>(dataReader, m_maxSamplesInRAM, m_numSubminiBatches, mbSize);
 
@@ -114,22 +114,81 @@ public:
             evalNodes, m_net->GetDeviceId(),
             {evalNodesWhichAccumulateResult.begin(), evalNodesWhichAccumulateResult.end()});
 
+        // Evaluation runs no backward pass, so once a minibatch's forward pass has been kicked off,
+        // the reader is free to work on the next one. We exploit that with a two-deep fetch pipeline:
+        // while minibatch n is being evaluated, a background task already runs the reader to stage
+        // minibatch n+1 into CPU-side matrices; the main loop then only pays for the copy into the
+        // input nodes. Sub-minibatching re-fetches through its own cache, so it keeps the serial path.
+        bool usePipelinedFetch = (numSubminibatchesNeeded <= 1);
+        StreamMinibatchInputs stagedInputMatrices;
+        MBLayoutPtr stagedMBLayout;
+        std::future<bool> pendingFetch;
+        if (usePipelinedFetch)
+        {
+            stagedMBLayout = make_shared<MBLayout>();
+            stagedMBLayout->SetAxisName(m_net->GetMBLayoutPtrOfNetwork()->GetAxisName());
+            for (const auto& iter : inputMatrices)
+                stagedInputMatrices.AddInput(iter.first, make_shared<Matrix<ElemType>>(CPUDEVICE), stagedMBLayout, iter.second.sampleLayout);
+            pendingFetch = std::async(std::launch::async, [dataReader, &stagedInputMatrices]()
+            {
+                return dataReader->GetMinibatch(stagedInputMatrices);
+            });
+        }
+
         const size_t numIterationsBeforePrintingProgress = 100;
         size_t numItersSinceLastPrintOfProgress = 0;
         bool noMoreSamplesToProcess = false;
         for (;;)
         {
             size_t actualMBSize = 0;
-            bool wasDataRead = DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*dataReader, m_net, nullptr, useDistributedMBReading, useParallelTrain, inputMatrices, actualMBSize, m_mpi);
+            bool wasDataRead;
+            if (usePipelinedFetch)
+            {
+                wasDataRead = pendingFetch.get();
+                // in case of distributed reading, we do a few more loops until all ranks have completed
+                // end of epoch
+                if (!wasDataRead && (!useDistributedMBReading || noMoreSamplesToProcess))
+                    break;
+
+                if (wasDataRead)
+                {
+                    // move the staged minibatch into the input nodes (host-to-device copy if on GPU)
+                    for (const auto& iter : inputMatrices)
+                        inputMatrices.GetInputMatrix<ElemType>(iter.first).AssignValuesOf(stagedInputMatrices.GetInputMatrix<ElemType>(iter.first));
+                    m_net->GetMBLayoutPtrOfNetwork()->CopyFrom(stagedMBLayout);
+                }
+
+                // kick off the fetch of minibatch n+1; it overlaps with the forward pass below.
+                // DataEnd() must precede the next GetMinibatch() on the reader's timeline, so it is
+                // issued from the background task as well (replacing the call at the loop bottom).
+                pendingFetch = std::async(std::launch::async, [dataReader, &stagedInputMatrices]()
+                {
+                    dataReader->DataEnd();
+                    return dataReader->GetMinibatch(stagedInputMatrices);
+                });
+
+                if (wasDataRead)
+                {
+                    // remaining steps of GetMinibatchIntoNetwork(), now against the staged copy
+                    if (!useDistributedMBReading && useParallelTrain)
+                        DataReaderHelpers::DecimateMinibatchInPlace<ElemType>(inputMatrices, m_mpi->NumNodesInUse(), m_mpi->CurrentNodeRank(), m_net->GetMBLayoutPtrOfNetwork());
+                    DataReaderHelpers::NotifyChangedNodes<ElemType>(m_net, inputMatrices);
+                    actualMBSize = m_net->DetermineActualMBSizeFromFeatures();
+                }
+            }
+            else
+            {
+            wasDataRead = DataReaderHelpers::GetMinibatchIntoNetwork<ElemType>(*dataReader, m_net, nullptr, useDistributedMBReading, useParallelTrain, inputMatrices, actualMBSize, m_mpi);
             // in case of distributed reading, we do a few more loops until all ranks have completed
             // end of epoch
-            if (!wasDataRead && (!useDistributedMBReading || noMoreSamplesToProcess)) 
+            if (!wasDataRead && (!useDistributedMBReading || noMoreSamplesToProcess))
                 break;
 
             // Note: If !wasDataRead then the data that GetMinibatchIntoNetwork() was supposed to full in are undefined.
             // Must not touch them.
             if (!wasDataRead)
                 actualMBSize = 0; // (undefined if !wasDataRead)
+            }
 
             if (actualMBSize > 0)
             {
@@ -161,72 +220,37 @@ public:
             size_t aggregateNumSamplesWithLabel = numSamplesWithLabel;
             if (useParallelTrain)
             {
-                if (m_gradHeader == nullptr)
-                {
-                    m_gradHeader.reset(DistGradHeader::Create(evalNodes.size()), [](DistGradHeader* ptr) {
-                        DistGradHeader::Destroy(ptr);
-                    });
-
-                    if (Globals::UseV2Aggregator())
-                        m_distGradAgg = make_shared<V2SimpleDistGradAggregator<ElemType>>(m_mpi, false /*useAsyncAggregation*/, 0 /*syncStatsTrace*/, ::CNTK::MPICommunicator());
-                    else 
-                        m_distGradAgg = make_shared<SimpleDistGradAggregator<ElemType>>(m_mpi, false /*useAsyncAggregation*/, m_net->GetDeviceId(), 0 /*syncStatsTrace*/);
-                }
-
-                m_gradHeader->numEvalNode = evalNodes.size();
-                m_gradHeader->numSamples = actualMBSize;
-                m_gradHeader->numSamplesWithLabel = numSamplesWithLabel;
-                m_gradHeader->criterion = 0.0; // (not used here)
+                // Each rank evaluates its shard and accumulates criteria locally across the whole
+                // epoch; the shards are combined with a single all-reduce after the loop, instead of
+                // running a full aggregation round through the gradient aggregator per minibatch.
+                // (Accumulator nodes accumulate internally; CriterionAccumulator keeps their latest value.)
                 for (size_t i = 0; i < evalNodes.size(); i++)
-                    m_gradHeader->evalErrors[i] = localEpochEvalErrors.Assign(i, numSamplesWithLabel).GetCriterion(i);
-
-                // TODO: We are reusing the aggregation logic inside SimpleDistGradAggregator, which has a heavy dependency
-                // on the gradient matrix. At some point we should refactor the aggregator class to be able to only calculating
-                // eval results and then remove this hack.
-                if (learnParamsGradients.size() == 0)
-                {
-                    Matrix<ElemType>* matrix = new Matrix<ElemType>((DEVICEID_TYPE)m_net->GetDeviceId());
-                    learnParamsGradients.push_back(matrix);
-                }
-
-                // Using SimpleDistAggregator for eval results only. At some point we should rename the class to be just
-                // IDistAggregator and SimpleDistAggregator.
-                bool samplesProcessed = m_distGradAgg->AggregateGradients(learnParamsGradients, m_gradHeader.get(), /*resetState =*/ false);
-                noMoreSamplesToProcess = !samplesProcessed;
+                    localEpochEvalErrors.Add(i, numSamplesWithLabel);
 
-                aggregateNumSamplesWithLabel = m_gradHeader->numSamplesWithLabel;
-                for (size_t i = 0; i < evalResults.size(); i++)
-                {
-                    if (ContainsAccumulatedResult(evalNodes[i]))
-                    {
-                        // We don't accumulate error in epoch criterion as this node has already accumulated error for
-                        // all samples that passed through network in forward pass.
-                        if (samplesProcessed)
-                        {
-                            evalResults[i] = m_gradHeader->evalErrors[i];
-                        }
-                        // else: no samples processed, no aggregation happened -> we do not want to override current value
-                        // with 0.
-                    }
-                    else
-                        evalResults[i] += m_gradHeader->evalErrors[i];
-                }
+                // The only per-minibatch exchange left is a scalar all-reduce of the sample count,
+                // which distributed reading needs to detect when all ranks have run out of data
+                // (ranks may see different numbers of minibatches).
+                m_mpi->AllReduce(&aggregateNumSamplesWithLabel, 1);
+                noMoreSamplesToProcess = (aggregateNumSamplesWithLabel == 0);
             }
             else
             {
                 if (actualMBSize != 0)
                 {
                     for (int i = 0; i < evalNodes.size(); i++)
-                    {
                         localEpochEvalErrors.Assign(i, numSamplesWithLabel);
+                    // pull all eval criteria off the device in one transfer instead of one sync each
+                    auto evalErrors = localEpochEvalErrors.GetCriteria();
+                    for (int i = 0; i < evalNodes.size(); i++)
+                    {
                         if (ContainsAccumulatedResult(evalNodes[i]))
                         {
                             // We don't accumulate error in epoch criterion as this node has already accumulated error
                             // for all samples that passed through network in forward pass.
-                            evalResults[i] = localEpochEvalErrors.GetCriterion(i);
+                            evalResults[i] = evalErrors[i];
                         }
                         else
-                            evalResults[i] += localEpochEvalErrors.GetCriterion(i);
+                            evalResults[i] += evalErrors[i];
                     }
                 }
             }
@@ -240,6 +264,8 @@ public:
 
                 if (numMBsRun <= m_firstMBsToShowResult || (m_numMBsToShowResult && (numMBsRun % m_numMBsToShowResult == 0)))
                 {
+                    if (useParallelTrain) // rank-local running totals; ranks are combined once after the loop
+                        evalResults = localEpochEvalErrors.GetCriteria();
                     DisplayEvalStatistics(numMBsRunLastLogged + 1, numMBsRun, numSamplesLastLogged, evalNodes, evalResults, evalResultsLastLogged);
 
                     for (int i = 0; i < evalResults.size(); i++)
@@ -263,12 +289,31 @@ public:
 
             // call DataEnd to check if end of sentence is reached
             // datareader will do its necessary/specific process for sentence ending
-            dataReader->DataEnd();
+            // (in pipelined mode this already happened inside the background fetch task)
+            if (!usePipelinedFetch)
+                dataReader->DataEnd();
         }
 
-        // show last batch of results
-        if (m_traceLevel > 0 && numSamplesLastLogged > 0)
+        if (useParallelTrain)
+        {
+            // hoist the rank-local totals and combine them across ranks with a single all-reduce
+            // (entries for accumulator nodes are recomputed from the aggregated accumulators below)
+            evalResults = localEpochEvalErrors.GetCriteria();
+            vector<double> numer(evalResults.size());
+            vector<size_t> denom(evalResults.size());
+            for (size_t i = 0; i < evalResults.size(); i++)
+            {
+                numer[i] = evalResults[i].first;
+                denom[i] = evalResults[i].second;
+            }
+            m_mpi->AllReduce(numer);
+            m_mpi->AllReduce(denom);
+            for (size_t i = 0; i < evalResults.size(); i++)
+                evalResults[i] = EpochCriterion(numer[i], denom[i]);
+        }
+        else if (m_traceLevel > 0 && numSamplesLastLogged > 0)
         {
+            // show last batch of results
             DisplayEvalStatistics(numMBsRunLastLogged + 1, numMBsRun, numSamplesLastLogged, evalNodes, evalResults, evalResultsLastLogged);
         }
 
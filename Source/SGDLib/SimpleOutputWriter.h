@@ -127,7 +127,8 @@ public:
 
         node->WriteMinibatchWithFormatting(f, FrameRange(), SIZE_MAX, SIZE_MAX, formattingOptions.transpose, formattingOptions.isCategoryLabel, formattingOptions.isSparse, labelMapping,
             sequenceSeparator, sequencePrologue, sequenceEpilogue, elementSeparator, sampleSeparator,
-            valueFormatString, gradient);
+            valueFormatString, gradient, /*onlyShowAbsSumForDense=*/false,
+            m_formattingScratch.data, m_formattingScratch.size); // reuse one host buffer across nodes and minibatches
     }
 
     void InsertNode(std::vector<ComputationNodeBasePtr>& allNodes, ComputationNodeBasePtr parent, ComputationNodeBasePtr newNode)
@@ -289,7 +290,19 @@ public:
     }
 
 private:
+    // reusable host-side buffer for formatted output; grown on demand by CopyToArray() and
+    // freed together with the writer, so bulk output does not reallocate a full copy of the
+    // minibatch for every node and minibatch
+    struct FormattingScratch
+    {
+        FormattingScratch() : data(nullptr), size(0) {}
+        ~FormattingScratch() { delete[] data; }
+        ElemType* data;
+        size_t size;
+    };
+
     ComputationNetworkPtr m_net;
+    FormattingScratch m_formattingScratch;
     int m_verbosity;
     void operator=(const SimpleOutputWriter&); // (not assignable)
 };
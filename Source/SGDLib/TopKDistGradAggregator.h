@@ -0,0 +1,327 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#pragma once
+
+#include "IDistGradAggregator.h"
+#include "CUDAPageLockedMemAllocator.h"
+#include "GPUDataTransferer.h"
+#include "TimerUtility.h"
+#include "MatrixQuantizerImpl.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Aggregates gradients by exchanging only the K largest-magnitude entries per column of each
+// gradient matrix. Everything that is not shipped accumulates into a local residual which is
+// added back in on subsequent minibatches (error feedback, the same scheme the 1-bit quantizers
+// use), so no gradient mass is ever dropped, only delayed. Unlike quantized aggregation, which
+// still ships the full dense tensor at reduced precision, the exchanged volume here is
+// K * numCols * (index + value) per matrix, which pays off when most gradient entries are
+// near-zero (e.g. embedding layers where only the rows of the words in the minibatch are hot).
+//
+// The top-K selection runs on the CPU staging buffers of the existing GPU-to-CPU transfer path
+// (there is no GPU selection primitive in this code base); since all ranks contribute the same
+// number of entries, the exchange is a fixed-size MPI_Allgather of index and value arrays, and
+// every rank rebuilds the aggregate dense gradient locally.
+template <class ElemType>
+class TopKDistGradAggregator : public IDistGradAggregator<ElemType>
+{
+    UsingIDistGradAggregatorMembers;
+
+public:
+    TopKDistGradAggregator(const MPIWrapperPtr& mpi, size_t topK, int deviceId, int syncStatsTrace)
+        : IDistGradAggregator<ElemType>(mpi), m_topK(topK), m_deviceId(deviceId), m_syncStatsTrace(syncStatsTrace), m_iterationCount(0), m_initialized(false)
+    {
+        if (m_topK == 0)
+            InvalidArgument("TopKDistGradAggregator requires topK > 0.");
+    }
+
+    ~TopKDistGradAggregator()
+    {
+        for (size_t i = 0; i < m_recvHeaders.size(); ++i)
+            DistGradHeader::Destroy(m_recvHeaders[i]);
+    }
+
+    bool AggregateGradients(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool resetState) override
+    {
+        ResetState(gradients, headerCPU->numEvalNode, resetState);
+        bool showSyncPerfStats = (m_syncStatsTrace > 0) && ((m_iterationCount % m_syncStatsTrace) == 0);
+        m_iterationCount++;
+
+        AggregateGradientsImpl(gradients, headerCPU, showSyncPerfStats);
+        return (headerCPU->numSamples != 0);
+    }
+
+private:
+    std::shared_ptr<ElemType> AllocateIntermediateBuffer(int deviceId, size_t numElements)
+    {
+        assert(deviceId >= 0);
+
+        // Use pinned memory for GPU devices for better copy performance
+        size_t totalSize = sizeof(ElemType) * numElements;
+        return std::shared_ptr<ElemType>((ElemType*) m_allocator->Malloc(totalSize), [this](ElemType* p)
+                                         {
+                                             m_allocator->Free(p);
+                                         });
+    }
+
+    void ResetState(const std::vector<Matrix<ElemType>*>& gradients, int numEvalNodes, bool resetState)
+    {
+        if (!m_initialized)
+        {
+            m_initialized = true;
+
+            if (m_deviceId != CPUDEVICE)
+                m_allocator.reset(new CUDAPageLockedMemAllocator(m_deviceId));
+
+            m_residuals.resize(gradients.size());
+            for (size_t i = 0; i < gradients.size(); i++)
+            {
+                if (gradients[i]->GetMatrixType() != DENSE)
+                    RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
+
+                if (m_deviceId != CPUDEVICE)
+                {
+                    m_gpuDataTransferers.push_back(std::make_unique<GPUDataTransferer>(m_deviceId, false /*useConcurrentStreams*/));
+                    m_intermediateCPUBuffers.push_back(AllocateIntermediateBuffer(m_deviceId, gradients[i]->GetNumElements()));
+                }
+
+                // the error-feedback store: gradient mass not selected for exchange waits here
+                m_residuals[i].assign(gradients[i]->GetNumElements(), (ElemType) 0);
+            }
+
+            if (m_mpi->IsMainNode())
+            {
+                for (size_t i = 0; i < NumProc() - 1; ++i)
+                    m_recvHeaders.push_back(DistGradHeader::Create(numEvalNodes));
+            }
+        }
+        else if (resetState)
+        {
+            // Drop the residuals: carrying over gradient mass across epoch/learning-rate
+            // boundaries would apply it with the wrong scale
+            for (size_t i = 0; i < m_residuals.size(); i++)
+                std::fill(m_residuals[i].begin(), m_residuals[i].end(), (ElemType) 0);
+        }
+    }
+
+    // select the K largest-magnitude entries of one column of the residual, append (row, value)
+    // pairs to the send buffers, and zero the selected residual entries
+    void SelectTopKOfColumn(ElemType* residualCol, size_t numRows, size_t k, std::vector<int>& sendIndices, std::vector<ElemType>& sendValues)
+    {
+        m_rowScratch.resize(numRows);
+        for (size_t r = 0; r < numRows; r++)
+            m_rowScratch[r] = (int) r;
+
+        std::nth_element(m_rowScratch.begin(), m_rowScratch.begin() + (k - 1), m_rowScratch.end(),
+                         [residualCol](int a, int b)
+                         {
+                             return std::abs(residualCol[a]) > std::abs(residualCol[b]);
+                         });
+
+        for (size_t j = 0; j < k; j++)
+        {
+            int row = m_rowScratch[j];
+            sendIndices.push_back(row);
+            sendValues.push_back(residualCol[row]);
+            residualCol[row] = 0;
+        }
+    }
+
+    void AggregateGradientsImpl(const std::vector<Matrix<ElemType>*>& gradients, DistGradHeader* headerCPU, bool showSyncPerfStats)
+    {
+        Timer aggregationTimer;
+        if (showSyncPerfStats)
+        {
+            std::unique_ptr<MatrixComputeStreamEvent> mainStreamSyncEvent(MatrixComputeStreamEvent::Create(m_deviceId));
+            mainStreamSyncEvent->SynchronizeEvent();
+            aggregationTimer.Start();
+        }
+
+        size_t numGradMatrices = gradients.size();
+
+        if (headerCPU->numSamples == 0)
+        {
+            assert(headerCPU->criterion == 0.0);
+            assert(headerCPU->numSamplesWithLabel == 0);
+            for (int i = 0; i < headerCPU->numEvalNode; ++i)
+                assert(headerCPU->evalErrors[i].first == 0 && headerCPU->evalErrors[i].second == 0);
+
+            // If the current node did not process any samples, the gradients should be zero'd;
+            // note that the residual is deliberately kept, only new (zero) mass is added below
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                gradients[i]->SetValue(0);
+        }
+
+        // Initiate transfer of the gradient matrices to the CPU
+        if (m_deviceId >= 0)
+        {
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                m_gpuDataTransferers[i]->CopyGPUToCPUAsync(gradients[i]->Data(), gradients[i]->GetNumElements(), m_intermediateCPUBuffers[i].get());
+        }
+
+        // Initiate receive of the header on the main node
+        std::vector<MPI_Request> recvHeaderRequests(NumProc() - 1);
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int source = (j >= MyRank()) ? (j + 1) : j;
+                // We use a tag of 'numGradMatrices' for the pre-aggregation header
+                MPI_Irecv(m_recvHeaders[j], m_recvHeaders[j]->Size(), MPI_CHAR, source, numGradMatrices, m_mpi->Communicator(), &(recvHeaderRequests[j])) || MpiFail("MPI_Irecv");
+            }
+        }
+
+        // Send the headers from all nodes but the main node
+        MPI_Request sendHeaderRequest;
+        if (!m_mpi->IsMainNode())
+            MPI_Isend(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices, m_mpi->Communicator(), &sendHeaderRequest) || MpiFail("MPI_Isend");
+
+        // For each matrix: fold the new gradient into the residual, select the per-column top-K,
+        // exchange the (index, value) pairs, and rebuild the aggregate dense gradient
+        size_t numProc = NumProc();
+        for (size_t i = 0; i < numGradMatrices; ++i)
+        {
+            size_t numRows = gradients[i]->GetNumRows();
+            size_t numCols = gradients[i]->GetNumCols();
+            size_t k = std::min(m_topK, numRows);
+            size_t numPairs = k * numCols;
+
+            ElemType* gradientBuffer = gradients[i]->Data();
+            if (m_deviceId >= 0)
+            {
+                m_gpuDataTransferers[i]->WaitForCopyGPUToCPUAsync();
+                gradientBuffer = m_intermediateCPUBuffers[i].get();
+            }
+
+            // error feedback: the residual carries everything not exchanged so far
+            ElemType* residual = m_residuals[i].data();
+            size_t numElements = numRows * numCols;
+            for (size_t e = 0; e < numElements; e++)
+                residual[e] += gradientBuffer[e];
+
+            m_sendIndices.clear();
+            m_sendValues.clear();
+            for (size_t c = 0; c < numCols; c++)
+                SelectTopKOfColumn(residual + (c * numRows), numRows, k, m_sendIndices, m_sendValues);
+
+            // All ranks contribute the same number of entries, so a fixed-size allgather suffices
+            m_recvIndices.resize(numPairs * numProc);
+            m_recvValues.resize(numPairs * numProc);
+            MPI_Allgather(m_sendIndices.data(), (int) numPairs, MPI_INT,
+                          m_recvIndices.data(), (int) numPairs, MPI_INT,
+                          m_mpi->Communicator()) || MpiFail("MPI_Allgather");
+            MPI_Allgather(m_sendValues.data(), (int) numPairs, MPIWrapper::GetDataType(m_sendValues.data()),
+                          m_recvValues.data(), (int) numPairs, MPIWrapper::GetDataType(m_recvValues.data()),
+                          m_mpi->Communicator()) || MpiFail("MPI_Allgather");
+
+            // Rebuild the aggregate dense gradient from everyone's pairs
+            memset(gradientBuffer, 0, sizeof(ElemType) * numElements);
+            for (size_t p = 0; p < numProc; p++)
+            {
+                const int* indices = m_recvIndices.data() + (p * numPairs);
+                const ElemType* values = m_recvValues.data() + (p * numPairs);
+                for (size_t e = 0; e < numPairs; e++)
+                {
+                    size_t col = e / k;
+                    gradientBuffer[(col * numRows) + indices[e]] += values[e];
+                }
+            }
+
+            if (m_deviceId >= 0)
+                m_gpuDataTransferers[i]->CopyCPUToGPUAsync(m_intermediateCPUBuffers[i].get(), numElements, gradients[i]->Data());
+        }
+
+        // On the main node wait for the headers to arrive and aggregate
+        if (m_mpi->IsMainNode())
+        {
+            size_t numNodesHeadersReceivedFrom = 0;
+            while (numNodesHeadersReceivedFrom < (NumProc() - 1))
+            {
+                int idx = MPI_UNDEFINED;
+                MPI_Waitany(recvHeaderRequests.size(), recvHeaderRequests.data(), &idx, MPI_STATUS_IGNORE) || MpiFail("MPI_Waitany");
+                if (idx == MPI_UNDEFINED)
+                {
+                    break;
+                }
+
+                numNodesHeadersReceivedFrom++;
+
+                headerCPU->Aggregate(m_recvHeaders[idx], true);
+            }
+
+            assert(numNodesHeadersReceivedFrom == (NumProc() - 1));
+        }
+
+        // Initiate receive of the aggregate header
+        MPI_Request recvAggHeaderRequest;
+        if (!m_mpi->IsMainNode())
+            MPI_Irecv(headerCPU, headerCPU->Size(), MPI_CHAR, m_mpi->MainNodeRank(), numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &recvAggHeaderRequest) || MpiFail("MPI_Irecv");
+
+        // Intiate send of the aggregate header from main node
+        std::vector<MPI_Request> sendAggHeaderRequests(NumProc() - 1);
+        if (m_mpi->IsMainNode())
+        {
+            for (size_t j = 0; j < NumProc() - 1; ++j)
+            {
+                int dest = (j >= MyRank()) ? (j + 1) : j;
+                MPI_Isend(headerCPU, headerCPU->Size(), MPI_CHAR, dest, numGradMatrices + 1 + numGradMatrices, m_mpi->Communicator(), &(sendAggHeaderRequests[j])) || MpiFail("MPI_Isend");
+            }
+        }
+
+        // Wait to receive aggregate header
+        if (!m_mpi->IsMainNode())
+            MPI_Wait(&recvAggHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+
+        // Wait for the transfers back to the GPU to finish
+        if (m_deviceId >= 0)
+        {
+            for (size_t i = 0; i < numGradMatrices; ++i)
+                m_gpuDataTransferers[i]->WaitForCopyCPUToGPUAsync();
+        }
+
+        // Wait for completion of the async send requests
+        if (!m_mpi->IsMainNode())
+            MPI_Wait(&sendHeaderRequest, MPI_STATUSES_IGNORE) || MpiFail("MPI_Wait");
+        else
+            MPI_Waitall(sendAggHeaderRequests.size(), sendAggHeaderRequests.data(), MPI_STATUSES_IGNORE) || MpiFail("MPI_Waitall");
+
+        if (showSyncPerfStats)
+        {
+            aggregationTimer.Stop();
+            double gradientAggregationTime = aggregationTimer.ElapsedSeconds();
+            fprintf(stderr, "Actual gradient aggregation time: %.6g\n", gradientAggregationTime);
+        }
+    }
+
+private:
+    // number of entries exchanged per column of each gradient matrix
+    size_t m_topK;
+
+    int m_deviceId;
+
+    std::unique_ptr<CUDAPageLockedMemAllocator> m_allocator;
+    std::vector<std::shared_ptr<ElemType>> m_intermediateCPUBuffers;
+    std::vector<std::unique_ptr<GPUDataTransferer>> m_gpuDataTransferers;
+
+    std::vector<DistGradHeader*> m_recvHeaders;
+
+    // per-matrix error-feedback store (kept on the CPU alongside the staging buffers)
+    std::vector<std::vector<ElemType>> m_residuals;
+
+    // scratch buffers for the exchange, persisted across calls to avoid reallocation
+    std::vector<int> m_rowScratch;
+    std::vector<int> m_sendIndices, m_recvIndices;
+    std::vector<ElemType> m_sendValues, m_recvValues;
+
+    int m_syncStatsTrace;
+    size_t m_iterationCount;
+    bool m_initialized;
+};
+} } }
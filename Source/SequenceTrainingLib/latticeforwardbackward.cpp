@@ -872,7 +872,10 @@ void lattice::forwardbackwardalign(parallelstate &parallelstate,
         if (minlogpp > LOGZERO)
             fprintf(stderr, "forwardbackwardalign: pruning not supported (we won't need it!) :)\n");
         edgeacscores.resize(edges.size());
-        for (size_t j = 0; j < edges.size(); j++)
+        // edges are independent of each other (disjoint abcs[j]/edgeacscores[j]/alignment ranges),
+        // so we align them across all cores while the GPU processes the non-silence edges
+#pragma omp parallel for schedule(dynamic)
+        for (int j = 0; j < (int) edges.size(); j++)
         {
             const auto &aligntokens = getaligninfo(j); // get alignment tokens
             if (aligntokens.size() == 0)
@@ -952,6 +955,11 @@ void lattice::forwardbackwardalign(parallelstate &parallelstate,
             parallelstate.getedgeacscores(edgeacscoresgpu);
             parallelstate.copyalignments(thisedgealignmentsgpu);
         }
+        // per-edge state-level alignment/forward-backward is the dominant CPU cost of the
+        // non-CUDA path; edges only touch their own abcs[j]/edgeacscores[j]/alignment range,
+        // so we distribute them across all cores (sequentially under CPU_VERIFICATION, to
+        // keep its diagnostics output readable)
+#pragma omp parallel for schedule(dynamic) if (!cpuverification)
         foreach_index (j, edges)
         {
             const edgeinfowithscores &e = edges[j];
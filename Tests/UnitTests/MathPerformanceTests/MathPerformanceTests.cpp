@@ -9,10 +9,15 @@
 //#include "Windows.h"
 #include "Matrix.h"
 #include "CPUMatrix.h"
+#include "CPUSparseMatrix.h"
+#include "BlockMultiplier.h"
 #include "TensorView.h"
 #include "Sequences.h"
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <random>
+#include <string>
 #include <vector>
 #include <algorithm>
 
@@ -336,24 +341,245 @@ void MandSTest(int count, int devId)
     delete[] data3;
 }
 
-int wmain()
+// =======================================================================
+// benchmark suite -- times the hot Math entry points across shape sweeps
+// and emits machine-readable CSV, so kernel changes can be compared against
+// a stored baseline instead of being evaluated ad hoc
+// =======================================================================
+
+// CSV sink: one row per benchmark, "benchmark,shape,iterations,min_ms,avg_ms,gflops"
+class BenchmarkCsv
 {
-    // MandSTest<float>(100, 2);
+public:
+    BenchmarkCsv(const string& path)
+    {
+        m_file = (path.empty() || path == "-") ? stdout : fopen(path.c_str(), "w");
+        if (!m_file)
+        {
+            cerr << "Failed to open CSV output file '" << path << "'" << endl;
+            exit(1);
+        }
+        fprintf(m_file, "benchmark,shape,iterations,min_ms,avg_ms,gflops\n");
+    }
+    ~BenchmarkCsv()
+    {
+        if (m_file != stdout)
+            fclose(m_file);
+    }
+    void Emit(const char* benchmark, const string& shape, int iterations, double minMs, double avgMs, double gflops)
+    {
+        fprintf(m_file, "%s,%s,%d,%.4f,%.4f,%.3f\n", benchmark, shape.c_str(), iterations, minMs, avgMs, gflops);
+        fflush(m_file);
+    }
+
+private:
+    FILE* m_file;
+};
+
+// run 'body' repeatedly until enough time has accumulated for a stable reading,
+// and report the best (min) and average iteration, plus GFlop/s based on the best
+template <typename FN>
+static void RunTimed(BenchmarkCsv& csv, const char* benchmark, const string& shape, double flopsPerIter, const FN& body)
+{
+    body(); // warm up caches, lazy allocations, and (for GPU) deferred initialization
+
+    const int maxIterations = 50;
+    const double minTotalSeconds = 0.3;
+    double totalSeconds = 0, minSeconds = 1e30;
+    int iterations = 0;
+    while (iterations < maxIterations && (totalSeconds < minTotalSeconds || iterations < 3))
+    {
+        auto start = chrono::high_resolution_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        totalSeconds += seconds;
+        minSeconds = min(minSeconds, seconds);
+        iterations++;
+    }
+    double gflops = flopsPerIter > 0 ? flopsPerIter / minSeconds / 1e9 : 0;
+    csv.Emit(benchmark, shape, iterations, 1000.0 * minSeconds, 1000.0 * totalSeconds / iterations, gflops);
+}
+
+static string ShapeString(size_t m, size_t k, size_t n)
+{
+    return to_string(m) + "x" + to_string(k) + "x" + to_string(n);
+}
+
+// CPUMatrix::MultiplyAndWeightedAdd() across shape sweeps: square GEMMs plus the
+// skinny shapes typical of minibatch evaluation (large weights, few columns)
+template <class ElemType>
+static void BenchGemm(BenchmarkCsv& csv)
+{
+    const size_t shapes[][3] = // {m, k, n}
+    {
+        {64, 64, 64}, {256, 256, 256}, {1024, 1024, 1024}, {2048, 2048, 2048},
+        {2048, 2048, 1}, {2048, 2048, 32}, {2048, 2048, 256}, {1024, 4096, 1024},
+    };
+    for (const auto& shape : shapes)
+    {
+        size_t m = shape[0], k = shape[1], n = shape[2];
+        CPUMatrix<ElemType> A(m, k), B(k, n), C(m, n);
+        A.SetUniformRandomValue(-1, 1, 42);
+        B.SetUniformRandomValue(-1, 1, 43);
+        RunTimed(csv, "CPUMatrix::MultiplyAndWeightedAdd", ShapeString(m, k, n), 2.0 * m * k * n, [&]()
+        {
+            CPUMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, A, false, B, false, (ElemType) 0.5, C);
+        });
+    }
+}
+
+// Matrix GEMM on a compute device; the scalar readback after the loop body forces
+// device synchronization, so GPU timings cover the kernel rather than just its launch
+template <class ElemType>
+static void BenchDeviceGemm(BenchmarkCsv& csv, DEVICEID_TYPE deviceId)
+{
+    const size_t shapes[][3] = {{1024, 1024, 1024}, {2048, 2048, 2048}, {2048, 2048, 32}, {1024, 4096, 1024}};
+    for (const auto& shape : shapes)
+    {
+        size_t m = shape[0], k = shape[1], n = shape[2];
+        Matrix<ElemType> A(m, k, deviceId), B(k, n, deviceId), C(m, n, deviceId);
+        A.SetUniformRandomValue(-1, 1, 42);
+        B.SetUniformRandomValue(-1, 1, 43);
+        RunTimed(csv, "Matrix::MultiplyAndWeightedAdd", ShapeString(m, k, n), 2.0 * m * k * n, [&]()
+        {
+            Matrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, A, false, B, false, (ElemType) 0.5, C);
+            C.Get00Element(); // sync
+        });
+    }
+}
 
-    /*cout<<endl<<"********************Matrix SquareMultiplyAndWeightedAdd10TimesAvg TEST********************"<<endl;
-    SquareMultiplyAndAdd10TimesAvgTest<float>(4096,10);
+// TensorView::DoBinaryOpOf() broadcast patterns (via AssignSumOf) and the matching
+// reduction (bias gradient, via DoCopyOf), the workhorses of elementwise layers
+template <class ElemType>
+static void BenchTensorOps(BenchmarkCsv& csv, DEVICEID_TYPE deviceId)
+{
+    struct Pattern
+    {
+        const char* name;
+        TensorShape a, b;
+        bool reduce; // true: accumulate a into b (gradient); false: b broadcasts into a
+    };
+    const Pattern patterns[] =
+    {
+        {"elementwise",         TensorShape(512, 256),          TensorShape(512, 256),  false},
+        {"bias-broadcast",      TensorShape(2048, 1024),        TensorShape(2048, 1),   false},
+        {"conv-bias",           TensorShape(28, 28, 128, 32),   TensorShape(1, 1, 128), false},
+        {"bias-reduction",      TensorShape(2048, 1024),        TensorShape(2048, 1),   true},
+        {"conv-bias-reduction", TensorShape(28, 28, 128, 32),   TensorShape(1, 1, 128), true},
+    };
+    for (const auto& pattern : patterns)
+    {
+        auto a      = TensorTest<ElemType>::CreateTensor(pattern.a, 1, deviceId);
+        auto b      = TensorTest<ElemType>::CreateTensor(pattern.b, 2, deviceId);
+        auto result = TensorTest<ElemType>::CreateTensor(pattern.a, 3, deviceId, true);
+        cout << endl; // CreateTensor logs the shapes
+        double elements = (double) pattern.a.GetNumElements();
+        if (pattern.reduce)
+            RunTimed(csv, "TensorView::DoCopyOf(reduce)", pattern.name, elements, [&]()
+            {
+                b.DoCopyOf(1, a, 1);
+            });
+        else
+            RunTimed(csv, "TensorView::AssignSumOf", pattern.name, elements, [&]()
+            {
+                result.AssignSumOf(a, b);
+            });
+    }
+}
 
-    cout<<endl<<"********************Matrix AddMultiplyAndInplaceSigmoid TEST********************"<<endl;    
-    AddMultiplyAndInplaceSigmoidTest<float>(11,10,12);    
-    AddMultiplyAndInplaceSigmoidTest<float>(110,100,120);    
-    AddMultiplyAndInplaceSigmoidTest<float>(1100,1000,1200);    
-    AddMultiplyAndInplaceSigmoidTest<float>(11000,10000,1200);
+// CPUSparseMatrix CSC multiply: the forward (dense * sparse -> dense) and gradient
+// (dense * sparse^T -> block-col) paths used by sparse-input and embedding layers
+template <class ElemType>
+static void BenchSparseMultiply(BenchmarkCsv& csv)
+{
+    const size_t m = 2048, k = 2048, n = 256;
+    for (double density : {0.01, 0.05})
+    {
+        CPUMatrix<ElemType> A(m, k);
+        A.SetUniformRandomValue(-1, 1, 42);
+        CPUSparseMatrix<ElemType> S(matrixFormatSparseCSC, k, n, 0);
+        mt19937 rng(42);
+        uniform_real_distribution<float> valueDist(-1, 1), densityDist(0, 1);
+        for (size_t col = 0; col < n; col++)
+            for (size_t row = 0; row < k; row++)
+                if (densityDist(rng) < density)
+                    S.SetValue(row, col, (ElemType) valueDist(rng));
+        string shape = ShapeString(m, k, n) + " d=" + to_string(density);
+        double flops = 2.0 * m * k * n * density;
+
+        CPUMatrix<ElemType> C(m, n);
+        RunTimed(csv, "CPUSparseMatrix::MultiplyAndWeightedAdd", shape, flops, [&]()
+        {
+            CPUSparseMatrix<ElemType>::MultiplyAndWeightedAdd((ElemType) 1, A, false, S, false, (ElemType) 0, C);
+        });
 
-    cout<<endl<<"********************Matrix MultiplyAndWeightedAdd TEST********************"<<endl;    
-    MultiplyAndWeightedAddTest<float>(11,10,12);    
-    MultiplyAndWeightedAddTest<float>(110,100,120);    
-    MultiplyAndWeightedAddTest<float>(1100,1000,1200);    
-    MultiplyAndWeightedAddTest<float>(11000,10000,12000);*/
+        CPUMatrix<ElemType> G(m, n);
+        G.SetUniformRandomValue(-1, 1, 44);
+        CPUSparseMatrix<ElemType> CB(matrixFormatSparseBlockCol, m, k, 0);
+        RunTimed(csv, "CPUSparseMatrix::MultiplyAndAdd", shape, flops, [&]()
+        {
+            CPUSparseMatrix<ElemType>::MultiplyAndAdd((ElemType) 1, G, false, S, true, CB);
+        });
+    }
+}
+
+// BlockMultiplier (quantized int16 GEMM) across k widths that exercise each of its
+// HandleBlock kernels, plus the single-row case used for per-frame evaluation
+static void BenchBlockMultiplier(BenchmarkCsv& csv)
+{
+    typedef BlockMultiplier<BlockHandlerSSE> Multiplier;
+    const int shapes[][3] = {{64, 128, 64}, {64, 256, 64}, {64, 1024, 64}, {256, 2048, 256}, {1, 2048, 1}};
+    for (const auto& shape : shapes)
+    {
+        int m = shape[0], k = shape[1], n = shape[2];
+        Multiplier mult;
+        Multiplier::ScalarAT* A = mult.CreateMatrixA(m, k);
+        Multiplier::ScalarBT* B = mult.CreateMatrixB(k, n);
+        int32_t* C = mult.CreateMatrixC(m, n);
+        for (int i = 0; i < m * k; ++i)
+            A[i] = (Multiplier::ScalarAT)(rand() % 64);
+        for (int i = 0; i < k * n; ++i)
+            B[i] = (Multiplier::ScalarBT)(rand() % 64);
+        Multiplier::ScalarBT* preparedB = mult.PrepareB(B, k, n);
+        RunTimed(csv, "BlockMultiplier<SSE>::MultiplyMatrices", ShapeString(m, k, n), 2.0 * m * k * n, [&]()
+        {
+            mult.MultiplyMatrices(A, m, k, preparedB, n, C);
+        });
+        mult.FreeMatrix(A);
+        mult.FreeMatrix(B);
+        mult.FreeMatrix(C);
+        if (preparedB != B)
+            mult.FreeMatrix(preparedB);
+    }
+}
+
+// usage: MathPerformanceTests [csvPath [deviceId]]
+//   csvPath   file to write CSV rows to ('-' or omitted: stdout)
+//   deviceId  -1 for CPU only (default); a GPU id additionally times Matrix GEMM on that device
+int main(int argc, char* argv[])
+{
+    string csvPath = argc > 1 ? argv[1] : "-";
+    int deviceId = argc > 2 ? atoi(argv[2]) : CPUDEVICE;
+
+    BenchmarkCsv csv(csvPath);
+
+    BenchGemm<float>(csv);
+    BenchGemm<double>(csv);
+    BenchTensorOps<float>(csv, CPUDEVICE);
+    BenchSparseMultiply<float>(csv);
+    BenchBlockMultiplier(csv);
+    if (deviceId >= 0)
+    {
+        BenchDeviceGemm<float>(csv, (DEVICEID_TYPE) deviceId);
+        BenchTensorOps<float>(csv, (DEVICEID_TYPE) deviceId);
+    }
+
+    // legacy exploratory tests, kept for reference:
+    // MandSTest<float>(100, 2);
+    // SquareMultiplyAndAdd10TimesAvgTest<float>(4096, 10);
+    // AddMultiplyAndInplaceSigmoidTest<float>(1100, 1000, 1200);
+    // MultiplyAndWeightedAddTest<float>(1100, 1000, 1200);
+    // TensorTest<float>();
 
     return 0;
 }
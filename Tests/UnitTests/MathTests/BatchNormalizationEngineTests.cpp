@@ -91,7 +91,7 @@ BOOST_AUTO_TEST_CASE(BatchNormalizationForward)
     };
 
     int baseDeviceId = 0;
-    for (int deviceId : {0})
+    for (int deviceId : {CPUDEVICE, 0}) // CPUDEVICE exercises the CPU training path of the CNTK engine
     {
         for (const auto& cfg : GenerateBNTestConfigs())
         {
@@ -155,7 +155,8 @@ BOOST_AUTO_TEST_CASE(BatchNormalizationForward)
             std::stringstream tmsg;
             tmsg << "inOut tensor: " << (std::string)inOutT
                  << ", spatial = " << (spatial ? "true" : "false")
-                 << ", expAvg = " << expAvg << ")";
+                 << ", expAvg = " << expAvg
+                 << ", device = " << deviceId << ")";
             std::string msg = " are not equal, " + tmsg.str();
             std::string msgNan = " has NaNs, " + tmsg.str();
             std::string msgNotNan = " has buffer overflow/underflow, " + tmsg.str();
@@ -221,7 +222,7 @@ BOOST_AUTO_TEST_CASE(BatchNormalizationBackward)
     };
 
     int baseDeviceId = 0;
-    for (int deviceId : {0})
+    for (int deviceId : {CPUDEVICE, 0}) // CPUDEVICE exercises the CPU training path of the CNTK engine
     {
         for (const auto& cfg : GenerateBNTestConfigs())
         {
@@ -282,7 +283,8 @@ BOOST_AUTO_TEST_CASE(BatchNormalizationBackward)
 
             std::stringstream tmsg;
             tmsg << "inOut tensor: " << (std::string)inOutT
-                 << ", spatial = " << (spatial ? "true" : "false");
+                 << ", spatial = " << (spatial ? "true" : "false")
+                 << ", device = " << deviceId;
             std::string msg = " are not equal, " + tmsg.str();
             std::string msgNan = " has NaNs, " + tmsg.str();
             std::string msgNotNan = " has buffer overflow/underflow, " + tmsg.str();
@@ -898,6 +898,119 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixSeedingDouble, RandomSeedFixture)
     BOOST_CHECK(m1.IsEqualTo(m2));
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrixFSAdagrad, RandomSeedFixture)
+{
+    const size_t rows = 13;
+    const size_t cols = 9;
+    const size_t n = rows * cols;
+    const double learnRate = 0.1;
+    const double adaWeight = 0.99;
+    const double adaMul = 0.1;
+    const size_t numSteps = 5;
+
+    for (double momentum : {0.9, 0.0})
+    {
+        DMatrix values = DMatrix::RandomUniform(rows, cols, -1, 1, IncrementCounter());
+        std::vector<double> refVal(values.Data(), values.Data() + n);
+        std::vector<double> refAda(n, 0);
+        std::vector<double> refMom(n, 0);
+
+        DMatrix smoothed;
+        DMatrix grad;
+        for (size_t step = 0; step < numSteps; step++)
+        {
+            grad = DMatrix::RandomUniform(rows, cols, -1, 1, IncrementCounter());
+            grad(0, 0) = 0; // exercises the adaSqr == 0 guard on the first step
+
+            smoothed.FSAdagrad(grad, values, learnRate, momentum, adaWeight, adaMul);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                double g = grad.Data()[i];
+                refAda[i] = adaWeight * refAda[i] + (1 - adaWeight) * g * g;
+                double w = refAda[i] != 0 ? std::min(adaMul / sqrt(refAda[i]), 10.0) : 1.0;
+                if (momentum > 0)
+                {
+                    refMom[i] = momentum * refMom[i] + (1 - momentum) * (g * w);
+                    refVal[i] -= refMom[i] * learnRate;
+                }
+                else
+                    refVal[i] -= g * w * learnRate;
+            }
+        }
+
+        // the state matrix holds the two accumulators side by side
+        BOOST_REQUIRE_EQUAL(smoothed.GetNumRows(), rows);
+        BOOST_REQUIRE_EQUAL(smoothed.GetNumCols(), 2 * cols);
+        for (size_t i = 0; i < n; i++)
+        {
+            BOOST_CHECK_SMALL(values.Data()[i] - refVal[i], 1e-12);
+            BOOST_CHECK_SMALL(smoothed.Data()[i] - refAda[i], 1e-12);
+            if (momentum > 0)
+                BOOST_CHECK_SMALL(smoothed.Data()[n + i] - refMom[i], 1e-12);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRmsProp, RandomSeedFixture)
+{
+    const size_t rows = 7;
+    const size_t cols = 9;
+    const size_t n = rows * cols;
+    const double gamma = 0.95;
+    const double wgtInc = 1.2;
+    const double wgtDec = 0.75;
+    // chosen so that forty steps reach both clamps from the initial step size of 0.02
+    const double wgtMax = 0.5;
+    const double wgtMin = 0.005;
+    const double floor = 1e-6;
+    const size_t numSteps = 40;
+
+    std::vector<double> refAvars(n);
+    std::vector<double> refSigns(n, 0);
+    std::vector<double> refSteps(n, 0.02);
+
+    DMatrix smoothed;
+    DMatrix grad;
+    for (size_t step = 0; step < numSteps; step++)
+    {
+        grad = DMatrix::RandomUniform(rows, cols, -1, 1, IncrementCounter());
+        grad(0, 0) = 0.5;                        // constant sign, drives its step size into the wgtMax clamp
+        grad(1, 0) = (step % 2 == 0) ? 0.5 : -0.5; // alternating sign, drives its step size into the wgtMin clamp
+        grad(2, 0) = 0;                          // zero gradient keeps its sign history at zero
+        std::vector<double> refGrad(grad.Data(), grad.Data() + n);
+
+        if (step == 0)
+            for (size_t i = 0; i < n; i++)
+                refAvars[i] = refGrad[i] * refGrad[i];
+
+        double aveMultiplier = smoothed.RmsProp(grad, gamma, wgtInc, wgtMax, wgtDec, wgtMin, true);
+
+        double refAveMultiplier = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            refAvars[i] = gamma * refAvars[i] + (1 - gamma) * refGrad[i] * refGrad[i];
+            const int gradSign = (0 < refGrad[i]) - (refGrad[i] < 0);
+            refSteps[i] = (refSigns[i] * gradSign > 0)
+                              ? std::min(refSteps[i] * wgtInc, wgtMax)
+                              : std::max(refSteps[i] * wgtDec, wgtMin);
+            double a = refSteps[i] / sqrt(refAvars[i] + floor);
+            refGrad[i] *= a;
+            refSigns[i] = gradSign;
+            refAveMultiplier += a;
+        }
+        refAveMultiplier /= n;
+
+        BOOST_CHECK_SMALL(aveMultiplier - refAveMultiplier, 1e-9);
+        for (size_t i = 0; i < n; i++)
+            BOOST_CHECK_SMALL(grad.Data()[i] - refGrad[i], 1e-12);
+    }
+
+    // the clamps were actually reached
+    BOOST_CHECK_EQUAL(smoothed.Data()[2 * n], wgtMax);
+    BOOST_CHECK_EQUAL(smoothed.Data()[2 * n + 1], wgtMin);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
 } } }
@@ -233,6 +233,102 @@ BOOST_AUTO_TEST_CASE(ConvolutionForward)
     }
 }
 
+// Geometries the Winograd engine supports: 2D 3x3 kernel spanning all input channels,
+// stride 1, full sharing, CPU. Odd and even output sizes are both included so the 2x2
+// output tile edge handling is exercised, padded as well as unpadded.
+std::vector<ConvolveGeometryPtr> GenerateWinogradTestConfigs()
+{
+    std::vector<ConvolveGeometryPtr> res;
+    for (size_t inW : {3, 4, 7, 16})
+    {
+        for (size_t inH : {3, 5, 16})
+        {
+            for (size_t inC : {1, 3})
+            {
+                for (size_t mapCount : {1, 8})
+                {
+                    for (bool pad : {false, true})
+                    {
+                        res.push_back(std::make_shared<ConvolveGeometry>(TensorShape(inW, inH, inC),
+                            TensorShape(3, 3, inC), TensorShape(mapCount), TensorShape(1, 1, inC),
+                            ConvolveGeometry::BoolVec{true},
+                            ConvolveGeometry::BoolVec{pad, pad, false},
+                            TensorShape(0), TensorShape(0)));
+                    }
+                }
+            }
+        }
+    }
+    return res;
+}
+
+BOOST_AUTO_TEST_CASE(WinogradConvolutionForward)
+{
+    std::mt19937 rng(0);
+    boost::random::uniform_int_distribution<> batchSizeG(1, 8);
+    boost::random::normal_distribution<float> nd;
+
+    auto initMat = [&](SingleMatrix& buf, size_t r, size_t c, vec& data) -> SingleMatrix
+    {
+        data.resize(r * 3 * c);
+        std::fill(begin(data), end(data), std::numeric_limits<float>::quiet_NaN());
+        std::generate(begin(data) + r * c, begin(data) + 2 * r * c, [&] { return nd(rng); });
+        buf.SetValue(r, 3 * c, buf.GetDeviceId(), data.data());
+        // Get center slice.
+        return buf.ColumnSlice(c, c);
+    };
+
+    int deviceId = -1; // the Winograd engine is CPU-only; compare against the CPU reference engine
+    for (size_t maxTempMem : {0, 1, 3})
+    {
+        for (const auto& g : GenerateWinogradTestConfigs())
+        {
+            auto baseEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Reference);
+            auto testEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, maxTempMem, PoolKind::None, ConvolutionEngineKind::Winograd);
+
+            size_t n = batchSizeG(rng);
+            vec buf;
+            buf.resize(g->InputShape().GetNumElements() * n);
+            std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+            SingleMatrix in(g->InputShape().GetNumElements(), n, buf.data(), deviceId, matrixFlagNormal);
+            SingleMatrix inB(in.DeepClone());
+
+            size_t mapCount = g->GetMapCount(g->InputShape().GetRank() - 1);
+            buf.resize(g->KernelShape().GetNumElements() * mapCount);
+            std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+            SingleMatrix kernel(mapCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+            SingleMatrix kernelB(kernel.DeepClone());
+
+            size_t crowOut = g->OutputShape().GetNumElements();
+            SingleMatrix outBuf(deviceId);
+            SingleMatrix out = initMat(outBuf, crowOut, n, buf);
+            SingleMatrix outB(out.DeepClone());
+
+            SingleMatrix workspace(deviceId);
+            SingleMatrix workspaceB(deviceId);
+
+            testEng->Forward(in, kernel, out, workspace);
+            baseEng->Forward(inB, kernelB, outB, workspaceB);
+
+            std::stringstream tmsg;
+            tmsg << "Geometry: " << (std::string)(*g) << ", Batch: " << n << ", MaxTempMem: " << maxTempMem;
+            std::string msg = " are not equal, " + tmsg.str();
+            std::string msgNan = " has NaNs, " + tmsg.str();
+            std::string msgNotNan = " has buffer overflow/underflow, " + tmsg.str();
+
+            // The transform domain reassociates the additions, so allow a somewhat wider
+            // envelope than for the direct engines.
+            float relErr = Err<float>::Rel;
+            float absErr = Err<float>::Abs;
+            std::string emsg;
+
+            BOOST_REQUIRE_MESSAGE(!out.HasNan("out"), "out" << msgNan);
+            BOOST_REQUIRE_MESSAGE(CheckEqual(out, outB, emsg, relErr * 16, absErr * 16), "out" << msg << ". " << emsg);
+            BOOST_REQUIRE_MESSAGE(CountNans(outBuf) == crowOut * 2 * n, "out" << msgNotNan);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ConvolutionBackwardData)
 {
     std::mt19937 rng(0);
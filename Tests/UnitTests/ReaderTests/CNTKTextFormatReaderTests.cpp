@@ -688,6 +688,102 @@ BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_invalid_inputs)
     CheckFilesEquivalent(control, output);
 };
 
+// Exercises the eight-digit-at-a-time (SWAR) number parsing on digit runs that straddle
+// its width: 7/8/9/16-digit integers, leading zeros, long fractions and exponents, with
+// the same fast path also taken for sparse indices. Parsed values are checked directly
+// against the chunk.
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_digit_run_boundaries)
+{
+    vector<StreamDescriptor> streams(2);
+    streams[0].m_alias = "A";
+    streams[0].m_name = L"A";
+    streams[0].m_storageType = StorageType::dense;
+    streams[0].m_sampleDimension = 4;
+
+    streams[1].m_alias = "S";
+    streams[1].m_name = L"S";
+    streams[1].m_storageType = StorageType::sparse_csc;
+    streams[1].m_sampleDimension = 200000000;
+
+    const string filename = "digit_runs_generated.txt";
+    {
+        ofstream file(filename);
+        file << "|A 1234567 12345678 123456789 99999999 |S 12345678:0.5\n";
+        file << "|A 100000000 00012345678 0.12345678 0.123456789 |S 123456789:1.25\n";
+        file << "|A 12345678.87654321 -12345678 1.23456789e2 1234567812345678 |S 1234567:-2\n";
+    }
+
+    CNTKTextFormatReaderTestRunner<float> testRunner(filename, streams, 0);
+    testRunner.LoadChunk();
+
+    const float denseExpected[3][4] = {
+        { 1234567.0f, 12345678.0f, 123456789.0f, 99999999.0f },          // 7, 8, 9 digits
+        { 100000000.0f, 12345678.0f, 0.12345678f, 0.123456789f },        // leading zeros, 8/9-digit fractions
+        { 12345678.87654321f, -12345678.0f, 123.456789f, 1234567812345678.0f }, // 16-digit run
+    };
+    const IndexType sparseIndices[3] = { 12345678, 123456789, 1234567 };
+    const float sparseValues[3] = { 0.5f, 1.25f, -2.0f };
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        vector<SequenceDataPtr> sequence;
+        testRunner.m_chunk->GetSequence(i, sequence);
+        BOOST_REQUIRE_EQUAL(sequence.size(), 2u);
+
+        auto& dense = reinterpret_cast<DenseSequenceData&>(*sequence[0]);
+        BOOST_REQUIRE_EQUAL(dense.m_numberOfSamples, 1u);
+        const float* values = reinterpret_cast<const float*>(dense.GetDataBuffer());
+        for (size_t j = 0; j < 4; j++)
+            BOOST_CHECK_CLOSE(values[j], denseExpected[i][j], 1e-3);
+
+        auto& sparse = reinterpret_cast<SparseSequenceData&>(*sequence[1]);
+        BOOST_REQUIRE_EQUAL(sparse.m_totalNnzCount, 1);
+        BOOST_CHECK_EQUAL(sparse.m_indices[0], sparseIndices[i]);
+        BOOST_CHECK_CLOSE(reinterpret_cast<const float*>(sparse.GetDataBuffer())[0], sparseValues[i], 1e-3);
+    }
+
+    boost::filesystem::remove(filename);
+};
+
+// The refill buffer must not break a value that straddles its end: generate an input
+// large enough to cross several 2MB refills, with line lengths that slide the 8-digit
+// values and delimiters across every offset, and verify each parsed value.
+BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_buffer_boundary_refills)
+{
+    vector<StreamDescriptor> streams(1);
+    streams[0].m_alias = "A";
+    streams[0].m_name = L"A";
+    streams[0].m_storageType = StorageType::dense;
+    streams[0].m_sampleDimension = 1;
+
+    const size_t numSequences = 200000; // ~2.6MB of text
+    const string filename = "buffer_boundary_generated.txt";
+    {
+        ofstream file(filename);
+        for (size_t i = 0; i < numSequences; i++)
+        {
+            // vary the padding so the digit runs land on every buffer offset over time
+            file << "|A" << string(1 + i % 3, ' ') << (10000000 + i) << "\n";
+        }
+    }
+
+    CNTKTextFormatReaderTestRunner<float> testRunner(filename, streams, 0);
+    testRunner.LoadChunk();
+
+    for (size_t i = 0; i < numSequences; i++)
+    {
+        vector<SequenceDataPtr> sequence;
+        testRunner.m_chunk->GetSequence(i, sequence);
+        auto& dense = reinterpret_cast<DenseSequenceData&>(*sequence[0]);
+        const float value = reinterpret_cast<const float*>(dense.GetDataBuffer())[0];
+        // values up to 2^24 are exact in float; only report through boost on mismatch
+        if (value != (float)(10000000 + i))
+            BOOST_REQUIRE_EQUAL(value, (float)(10000000 + i));
+    }
+
+    boost::filesystem::remove(filename);
+};
+
 // 100 sequences with N samples for each of 3 inputs, where N is chosen at random
 // from [1, 100] for each sequence
 BOOST_AUTO_TEST_CASE(CNTKTextFormatReader_100x100x3)